@@ -0,0 +1,469 @@
+#include "CookerClass.h"
+#include "GltfReaderClass.h"
+#include "HashClass.h"
+#include "MeshCookerClass.h"
+#include "ObjReaderClass.h"
+#include "PngReaderClass.h"
+#include "TextureCookerClass.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+#pragma region Globals
+static const unsigned int SOURCE_UNKNOWN = 0;
+static const unsigned int SOURCE_OBJ = 1;
+static const unsigned int SOURCE_GLTF = 2;
+static const unsigned int SOURCE_PNG = 3;
+#pragma endregion
+
+/*
+	Everything the jobs of one Cook call share, every job only writes the slots of its own input
+*/
+struct CookContext
+{
+	CookerClass* cooker;
+	const CookerInput* inputs;
+	unsigned char** assets;
+	size_t* assetSizes;
+	bool* cooked;
+};
+
+static bool EndsWith(const char* _path, const char* _extension)
+{
+	size_t pathLength = strlen(_path);
+	size_t extensionLength = strlen(_extension);
+	if (pathLength < extensionLength)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < extensionLength; i++)
+	{
+		char character = _path[pathLength - extensionLength + i];
+		character = character >= 'A' && character <= 'Z' ? static_cast<char>(character - 'A' + 'a') : character;
+		if (character != _extension[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static unsigned int GetSourceType(const char* _path)
+{
+	if (EndsWith(_path, ".obj"))
+	{
+		return SOURCE_OBJ;
+	}
+	if (EndsWith(_path, ".gltf") || EndsWith(_path, ".glb"))
+	{
+		return SOURCE_GLTF;
+	}
+	if (EndsWith(_path, ".png"))
+	{
+		return SOURCE_PNG;
+	}
+
+	return SOURCE_UNKNOWN;
+}
+
+/*
+	The id of an input does not depend on the platform the package was cooked on
+*/
+static unsigned long long GetInputId(const char* _path)
+{
+	char name[MAX_COOKER_PATH];
+	size_t length = 0;
+	for (; _path[length] != 0 && length < sizeof(name) - 1; length++)
+	{
+		name[length] = _path[length] == '\\' ? '/' : _path[length];
+	}
+	name[length] = 0;
+
+	return AssetPackageClass::GetAssetId(name);
+}
+
+/*
+	Constructor
+*/
+CookerClass::CookerClass()
+{
+	m_jobSystem = nullptr;
+	m_cacheDirectory[0] = 0;
+	m_useCache = false;
+	m_cookedCount.store(0);
+	m_cachedCount.store(0);
+}
+
+/*
+	Destructor
+*/
+CookerClass::~CookerClass()
+{
+
+}
+
+/*
+	Without a cache directory (nullptr) every input is cooked on every run
+	The directory is created if it does not exist yet
+*/
+bool CookerClass::Initialize(const char* _cacheDirectory, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+	m_useCache = _cacheDirectory != nullptr;
+	m_cookedCount.store(0);
+	m_cachedCount.store(0);
+
+	if (!m_useCache)
+	{
+		return true;
+	}
+
+	if (strlen(_cacheDirectory) + 1 > sizeof(m_cacheDirectory))
+	{
+		return false;
+	}
+	strcpy(m_cacheDirectory, _cacheDirectory);
+
+#ifdef _WIN32
+	int created = _mkdir(m_cacheDirectory);
+#else
+	int created = mkdir(m_cacheDirectory, 0755);
+#endif
+
+	return created == 0 || errno == EEXIST;
+}
+
+void CookerClass::Shutdown()
+{
+	m_jobSystem = nullptr;
+	m_useCache = false;
+}
+
+/*
+	Cook every input on the jobsystem, then write the assets sorted by id into the package
+	The package is not written if any input fails or two inputs get the same id
+*/
+bool CookerClass::Cook(const CookerInput* _inputs, unsigned int _inputCount, const char* _packagePath)
+{
+	if (_inputCount > MAX_COOKER_INPUTS)
+	{
+		printf("at most %u inputs can be cooked into one package\n", MAX_COOKER_INPUTS);
+		return false;
+	}
+
+	unsigned int slotCount = _inputCount > 0 ? _inputCount : 1;
+	unsigned char** assets = new unsigned char*[slotCount];
+	size_t* assetSizes = new size_t[slotCount];
+	bool* cooked = new bool[slotCount];
+	AssetPackageInput* packageInputs = new AssetPackageInput[slotCount];
+
+	CookContext context;
+	context.cooker = this;
+	context.inputs = _inputs;
+	context.assets = assets;
+	context.assetSizes = assetSizes;
+	context.cooked = cooked;
+
+	for (unsigned int i = 0; i < _inputCount; i++)
+	{
+		assets[i] = nullptr;
+		cooked[i] = false;
+	}
+
+	//	One job per input, cooked on the calling thread if the jobs could not be queued
+	bool queued = false;
+	if (m_jobSystem)
+	{
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(CookJob, &context, _inputCount, 1, &counter);
+		if (queued)
+		{
+			m_jobSystem->WaitForCounter(&counter);
+		}
+	}
+
+	if (!queued)
+	{
+		CookJob(&context, 0, _inputCount, 0);
+	}
+
+	//	Reported in the order of the inputs, not in the order the jobs finished
+	bool succeeded = true;
+	for (unsigned int i = 0; i < _inputCount; i++)
+	{
+		if (!cooked[i])
+		{
+			printf("could not cook %s\n", _inputs[i].path);
+			succeeded = false;
+			continue;
+		}
+
+		packageInputs[i].id = GetInputId(_inputs[i].path);
+		packageInputs[i].data = assets[i];
+		packageInputs[i].size = assetSizes[i];
+	}
+
+	if (succeeded)
+	{
+		std::sort(packageInputs, packageInputs + _inputCount, [](const AssetPackageInput& _a, const AssetPackageInput& _b) { return _a.id < _b.id; });
+
+		for (unsigned int i = 1; i < _inputCount; i++)
+		{
+			if (packageInputs[i - 1].id == packageInputs[i].id)
+			{
+				printf("two inputs have the same asset id %016llx\n", packageInputs[i].id);
+				succeeded = false;
+			}
+		}
+	}
+
+	if (succeeded && !AssetPackageClass::Write(_packagePath, packageInputs, _inputCount))
+	{
+		printf("could not write the package %s\n", _packagePath);
+		succeeded = false;
+	}
+
+	for (unsigned int i = 0; i < _inputCount; i++)
+	{
+		delete[] assets[i];
+	}
+
+	delete[] packageInputs;
+	delete[] cooked;
+	delete[] assetSizes;
+	delete[] assets;
+
+	return succeeded;
+}
+
+unsigned int CookerClass::GetCookedCount() const
+{
+	return m_cookedCount.load();
+}
+
+unsigned int CookerClass::GetCachedCount() const
+{
+	return m_cachedCount.load();
+}
+
+/*
+	The whole file with a 0 behind the last byte, so text formats can be parsed in place
+*/
+unsigned char* CookerClass::ReadFile(const char* _path, size_t& _size)
+{
+	_size = 0;
+
+	FILE* file = fopen(_path, "rb");
+	if (!file)
+	{
+		return nullptr;
+	}
+
+	long size = -1;
+	if (fseek(file, 0, SEEK_END) == 0)
+	{
+		size = ftell(file);
+	}
+
+	if (size < 0 || fseek(file, 0, SEEK_SET) != 0)
+	{
+		fclose(file);
+		return nullptr;
+	}
+
+	unsigned char* data = new unsigned char[static_cast<size_t>(size) + 1];
+	size_t read = fread(data, 1, static_cast<size_t>(size), file);
+	fclose(file);
+
+	if (read != static_cast<size_t>(size))
+	{
+		delete[] data;
+		return nullptr;
+	}
+
+	data[size] = 0;
+	_size = static_cast<size_t>(size);
+
+	return data;
+}
+
+void CookerClass::CookJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	CookContext* context = static_cast<CookContext*>(_data);
+
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		context->cooked[i] = context->cooker->CookInput(context->inputs[i], context->assets[i], context->assetSizes[i]);
+	}
+}
+
+/*
+	Key everything the asset depends on, take it from the cache if it is there and still valid, otherwise cook and store it
+*/
+bool CookerClass::CookInput(const CookerInput& _input, unsigned char*& _asset, size_t& _assetSize)
+{
+	_asset = nullptr;
+	_assetSize = 0;
+
+	unsigned int sourceType = GetSourceType(_input.path);
+	if (sourceType == SOURCE_UNKNOWN)
+	{
+		return false;
+	}
+
+	size_t sourceSize;
+	unsigned char* source = ReadFile(_input.path, sourceSize);
+	if (!source)
+	{
+		return false;
+	}
+
+	unsigned long long key = HashClass::Hash(source, sourceSize);
+	key = HashClass::Combine(key, sourceType);
+	key = HashClass::Combine(key, sourceType == SOURCE_PNG ? (_input.srgb ? 1 : 0) : 0);
+	key = HashClass::Combine(key, COOKER_VERSION);
+	key = HashClass::Combine(key, sourceType == SOURCE_PNG ? TEXTURE_ASSET_VERSION : MESH_ASSET_VERSION);
+	if (sourceType == SOURCE_GLTF && !GltfReaderClass::HashDependencies(source, sourceSize, _input.path, key))
+	{
+		delete[] source;
+		return false;
+	}
+
+	if (m_useCache)
+	{
+		size_t cachedSize;
+		unsigned char* cached = LoadCached(key, cachedSize);
+		const AssetHeader* header = reinterpret_cast<const AssetHeader*>(cached);
+
+		//	A damaged or foreign file in the cache is simply cooked again
+		bool valid = cached && (sourceType == SOURCE_PNG ? TextureAssetClass::Get(header) != nullptr : MeshAssetClass::Get(header) != nullptr);
+		if (valid)
+		{
+			delete[] source;
+			_asset = cached;
+			_assetSize = cachedSize;
+			m_cachedCount++;
+			return true;
+		}
+
+		delete[] cached;
+	}
+
+	bool cooked = CookSource(_input, source, sourceSize, _asset, _assetSize);
+	delete[] source;
+
+	if (!cooked)
+	{
+		return false;
+	}
+
+	if (m_useCache)
+	{
+		StoreCached(key, _asset, _assetSize);
+	}
+	m_cookedCount++;
+
+	return true;
+}
+
+bool CookerClass::CookSource(const CookerInput& _input, const unsigned char* _source, size_t _sourceSize, unsigned char*& _asset, size_t& _assetSize)
+{
+	unsigned int sourceType = GetSourceType(_input.path);
+
+	if (sourceType == SOURCE_PNG)
+	{
+		unsigned int width;
+		unsigned int height;
+		unsigned char* pixels = PngReaderClass::Read(_source, _sourceSize, width, height);
+		if (!pixels)
+		{
+			return false;
+		}
+
+		bool cooked = TextureCookerClass::Cook(pixels, width, height, _input.srgb, _asset, _assetSize);
+		delete[] pixels;
+
+		return cooked;
+	}
+
+	SourceMesh mesh;
+	bool read = sourceType == SOURCE_OBJ ? ObjReaderClass::Read(reinterpret_cast<const char*>(_source), _sourceSize, mesh) :
+		GltfReaderClass::Read(_source, _sourceSize, _input.path, mesh);
+	if (!read)
+	{
+		return false;
+	}
+
+	bool cooked = MeshCookerClass::Cook(mesh, _asset, _assetSize);
+	MeshCookerClass::Release(mesh);
+
+	return cooked;
+}
+
+/*
+	The cached asset, nullptr if there is none or its size does not match its header
+*/
+unsigned char* CookerClass::LoadCached(unsigned long long _key, size_t& _size)
+{
+	char path[MAX_COOKER_PATH];
+	if (!GetCachePath(_key, path, sizeof(path)))
+	{
+		return nullptr;
+	}
+
+	unsigned char* data = ReadFile(path, _size);
+	if (data && (_size < sizeof(AssetHeader) || reinterpret_cast<const AssetHeader*>(data)->size != _size))
+	{
+		delete[] data;
+		return nullptr;
+	}
+
+	return data;
+}
+
+/*
+	Written to a temporary file first, so a cooker that is stopped halfway never leaves a broken asset under a valid key
+	Failing to store is not an error, the asset is only cooked again next time
+*/
+void CookerClass::StoreCached(unsigned long long _key, const unsigned char* _asset, size_t _size)
+{
+	char path[MAX_COOKER_PATH];
+	char temporaryPath[MAX_COOKER_PATH];
+	if (!GetCachePath(_key, path, sizeof(path)) || snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path) >= static_cast<int>(sizeof(temporaryPath)))
+	{
+		return;
+	}
+
+	FILE* file = fopen(temporaryPath, "wb");
+	if (!file)
+	{
+		return;
+	}
+
+	bool written = fwrite(_asset, 1, _size, file) == _size;
+	if (fclose(file) != 0 || !written)
+	{
+		remove(temporaryPath);
+		return;
+	}
+
+	//	rename does not replace existing files on every platform
+	remove(path);
+	if (rename(temporaryPath, path) != 0)
+	{
+		remove(temporaryPath);
+	}
+}
+
+bool CookerClass::GetCachePath(unsigned long long _key, char* _path, size_t _pathSize) const
+{
+	return snprintf(_path, _pathSize, "%s/%016llx.asset", m_cacheDirectory, _key) < static_cast<int>(_pathSize);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include <atomic>
+#include "AssetPackageClass.h"
+#include "JobSystemClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int COOKER_VERSION = 2;				// bump whenever a cooker changes its output, so cached assets are cooked again
+const unsigned int MAX_COOKER_INPUTS = 65536;			// one job per input, more than JOB_POOL_SIZE are queued while the first ones run
+const unsigned int MAX_COOKER_PATH = 512;
+#pragma endregion
+
+/*
+	One source file and how to cook it
+	The asset id is AssetPackageClass::GetAssetId of the path as given, with '\' replaced by '/'
+*/
+struct CookerInput
+{
+	const char* path;
+	bool srgb;				// textures: the colors are sRGB encoded
+};
+
+/*
+	Cooks source files into a package: OBJ and glTF meshes (MeshCookerClass), PNG textures (TextureCookerClass)
+	With a cache directory every cooked asset is stored under the hash of everything it depends on
+	(source bytes, external glTF buffers, settings, COOKER_VERSION), unchanged inputs are taken from there on the next run
+	The inputs are cooked in parallel on the jobsystem, one job per input
+	The package only depends on the inputs, so the same inputs always give the same file
+*/
+class CookerClass
+{
+public:
+	CookerClass();
+	~CookerClass();
+
+	bool Initialize(const char* _cacheDirectory, JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	bool Cook(const CookerInput* _inputs, unsigned int _inputCount, const char* _packagePath);
+
+	unsigned int GetCookedCount() const;
+	unsigned int GetCachedCount() const;
+
+	static unsigned char* ReadFile(const char* _path, size_t& _size);
+
+private:
+	static void CookJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+
+	bool CookInput(const CookerInput& _input, unsigned char*& _asset, size_t& _assetSize);
+	bool CookSource(const CookerInput& _input, const unsigned char* _source, size_t _sourceSize, unsigned char*& _asset, size_t& _assetSize);
+	unsigned char* LoadCached(unsigned long long _key, size_t& _size);
+	void StoreCached(unsigned long long _key, const unsigned char* _asset, size_t _size);
+	bool GetCachePath(unsigned long long _key, char* _path, size_t _pathSize) const;
+
+	JobSystemClass* m_jobSystem;
+	char m_cacheDirectory[MAX_COOKER_PATH];
+	bool m_useCache;
+	std::atomic<unsigned int> m_cookedCount;
+	std::atomic<unsigned int> m_cachedCount;
+};
\ No newline at end of file
@@ -0,0 +1,500 @@
+#include "GltfReaderClass.h"
+#include "CookerClass.h"
+#include "HashClass.h"
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int GLB_MAGIC = 0x46546C67;			// "glTF"
+static const unsigned int GLB_VERSION = 2;
+static const unsigned int GLB_CHUNK_JSON = 0x4E4F534A;		// "JSON"
+static const unsigned int GLB_CHUNK_BINARY = 0x004E4942;	// "BIN\0"
+static const unsigned int GLTF_MODE_TRIANGLES = 4;
+static const unsigned int GLTF_FLOAT = 5126;
+static const unsigned int GLTF_BYTE = 5120;
+static const unsigned int GLTF_UNSIGNED_BYTE = 5121;
+static const unsigned int GLTF_SHORT = 5122;
+static const unsigned int GLTF_UNSIGNED_SHORT = 5123;
+static const unsigned int GLTF_UNSIGNED_INT = 5125;
+static const unsigned int INVALID_ACCESSOR = 0xFFFFFFFF;
+#pragma endregion
+
+static unsigned int ReadUnsigned(const unsigned char* _data)
+{
+	return static_cast<unsigned int>(_data[0]) | (static_cast<unsigned int>(_data[1]) << 8) |
+		(static_cast<unsigned int>(_data[2]) << 16) | (static_cast<unsigned int>(_data[3]) << 24);
+}
+
+static int DecodeBase64Character(char _character)
+{
+	if (_character >= 'A' && _character <= 'Z') return _character - 'A';
+	if (_character >= 'a' && _character <= 'z') return _character - 'a' + 26;
+	if (_character >= '0' && _character <= '9') return _character - '0' + 52;
+	if (_character == '+') return 62;
+	if (_character == '/') return 63;
+	return -1;
+}
+
+/*
+	Decode the payload of a base64 data uri, stops at the padding
+*/
+static unsigned char* DecodeBase64(const char* _text, size_t _length, size_t& _size)
+{
+	unsigned char* data = new unsigned char[_length / 4 * 3 + 3];
+	unsigned int bits = 0;
+	int bitCount = 0;
+	_size = 0;
+
+	for (size_t i = 0; i < _length && _text[i] != '='; i++)
+	{
+		int value = DecodeBase64Character(_text[i]);
+		if (value < 0)
+		{
+			delete[] data;
+			return nullptr;
+		}
+
+		bits = (bits << 6) | static_cast<unsigned int>(value);
+		bitCount += 6;
+		if (bitCount >= 8)
+		{
+			bitCount -= 8;
+			data[_size++] = static_cast<unsigned char>(bits >> bitCount);
+		}
+	}
+
+	return data;
+}
+
+static int GetAttribute(const JsonClass& _json, const JsonValue* _primitive, const char* _name)
+{
+	const JsonValue* attribute = _json.Find(_json.Find(_primitive, "attributes"), _name);
+
+	return attribute && attribute->type == JSON_NUMBER ? static_cast<int>(attribute->number) : -1;
+}
+
+/*
+	Merge the triangle primitives: the first pass counts and checks every accessor, the second one reads them
+	Normals are only kept if every primitive has them, otherwise MeshCookerClass generates them for the whole mesh
+*/
+bool GltfReaderClass::Read(const unsigned char* _data, size_t _size, const char* _path, SourceMesh& _mesh)
+{
+	memset(&_mesh, 0, sizeof(_mesh));
+
+	JsonClass json;
+	const unsigned char* binary;
+	size_t binarySize;
+	if (!ParseDocument(_data, _size, json, binary, binarySize))
+	{
+		return false;
+	}
+
+	unsigned char* buffers[MAX_GLTF_BUFFERS];
+	size_t bufferSizes[MAX_GLTF_BUFFERS];
+	unsigned int bufferCount;
+	if (!LoadBuffers(json, _path, binary, binarySize, buffers, bufferSizes, bufferCount))
+	{
+		return false;
+	}
+
+	const JsonValue* meshes = json.Find(json.GetRoot(), "meshes");
+	unsigned int vertexCount = 0;
+	unsigned int indexCount = 0;
+	bool allNormals = true;
+	bool anyTexcoords = false;
+	bool valid = meshes && meshes->type == JSON_ARRAY;
+
+	for (int pass = 0; pass < 2 && valid; pass++)
+	{
+		unsigned int baseVertex = 0;
+		unsigned int baseIndex = 0;
+
+		for (const JsonValue* mesh = json.GetElement(meshes, 0); mesh && valid; mesh = json.GetNext(mesh))
+		{
+			const JsonValue* primitives = json.Find(mesh, "primitives");
+			for (const JsonValue* primitive = json.GetElement(primitives, 0); primitive && valid; primitive = json.GetNext(primitive))
+			{
+				int position = GetAttribute(json, primitive, "POSITION");
+				int normal = GetAttribute(json, primitive, "NORMAL");
+				int texcoord = GetAttribute(json, primitive, "TEXCOORD_0");
+				double indices = json.GetNumber(primitive, "indices", -1.0);
+
+				if (json.GetNumber(primitive, "mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES || position < 0)
+				{
+					continue;
+				}
+
+				bool fill = pass == 1;
+				unsigned int count = ReadAccessor(json, position, buffers, bufferSizes, bufferCount, 3, fill ? &_mesh.positions[static_cast<size_t>(baseVertex) * 3] : nullptr, nullptr);
+				if (count == INVALID_ACCESSOR)
+				{
+					valid = false;
+					break;
+				}
+
+				//	The other attributes have to have as many elements as the positions
+				if (normal >= 0 && (!fill || _mesh.normals))
+				{
+					unsigned int normalCount = ReadAccessor(json, normal, buffers, bufferSizes, bufferCount, 3, fill ? &_mesh.normals[static_cast<size_t>(baseVertex) * 3] : nullptr, nullptr);
+					valid = valid && normalCount == count;
+				}
+				allNormals = allNormals && normal >= 0;
+
+				if (texcoord >= 0)
+				{
+					unsigned int texcoordCount = ReadAccessor(json, texcoord, buffers, bufferSizes, bufferCount, 2, fill ? &_mesh.texcoords[static_cast<size_t>(baseVertex) * 2] : nullptr, nullptr);
+					valid = valid && texcoordCount == count;
+					anyTexcoords = true;
+				}
+				else if (fill && _mesh.texcoords)
+				{
+					memset(&_mesh.texcoords[static_cast<size_t>(baseVertex) * 2], 0, sizeof(float) * 2 * count);
+				}
+
+				unsigned int primitiveIndexCount = count;
+				if (indices >= 0.0)
+				{
+					primitiveIndexCount = ReadAccessor(json, static_cast<unsigned int>(indices), buffers, bufferSizes, bufferCount, 1, nullptr, fill ? &_mesh.indices[baseIndex] : nullptr);
+				}
+				else if (fill)
+				{
+					for (unsigned int i = 0; i < count; i++)
+					{
+						_mesh.indices[baseIndex + i] = i;
+					}
+				}
+
+				if (!valid || primitiveIndexCount == INVALID_ACCESSOR || primitiveIndexCount % 3 != 0)
+				{
+					valid = false;
+					break;
+				}
+
+				if (fill)
+				{
+					for (unsigned int i = 0; i < primitiveIndexCount; i++)
+					{
+						unsigned int& index = _mesh.indices[baseIndex + i];
+						valid = valid && index < count;
+						index += baseVertex;
+					}
+				}
+
+				baseVertex += count;
+				baseIndex += primitiveIndexCount;
+			}
+		}
+
+		if (pass == 0 && valid)
+		{
+			vertexCount = baseVertex;
+			indexCount = baseIndex;
+			valid = vertexCount > 0 && indexCount > 0;
+
+			if (valid)
+			{
+				_mesh.vertexCount = vertexCount;
+				_mesh.indexCount = indexCount;
+				_mesh.positions = new float[static_cast<size_t>(vertexCount) * 3];
+				_mesh.normals = allNormals ? new float[static_cast<size_t>(vertexCount) * 3] : nullptr;
+				_mesh.texcoords = anyTexcoords ? new float[static_cast<size_t>(vertexCount) * 2] : nullptr;
+				_mesh.indices = new unsigned int[indexCount];
+			}
+		}
+	}
+
+	for (unsigned int i = 0; i < bufferCount; i++)
+	{
+		delete[] buffers[i];
+	}
+
+	if (!valid)
+	{
+		MeshCookerClass::Release(_mesh);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Combine the hashes of the external buffer files into _hash, they are inputs of the mesh as much as the .gltf itself
+*/
+bool GltfReaderClass::HashDependencies(const unsigned char* _data, size_t _size, const char* _path, unsigned long long& _hash)
+{
+	JsonClass json;
+	const unsigned char* binary;
+	size_t binarySize;
+	if (!ParseDocument(_data, _size, json, binary, binarySize))
+	{
+		return false;
+	}
+
+	const JsonValue* buffers = json.Find(json.GetRoot(), "buffers");
+	for (const JsonValue* buffer = json.GetElement(buffers, 0); buffer; buffer = json.GetNext(buffer))
+	{
+		char externalPath[MAX_COOKER_PATH];
+		const JsonValue* uri = json.Find(buffer, "uri");
+		if (!uri || !GetExternalPath(uri, _path, externalPath, sizeof(externalPath)))
+		{
+			continue;
+		}
+
+		size_t fileSize;
+		unsigned char* file = CookerClass::ReadFile(externalPath, fileSize);
+		if (!file)
+		{
+			return false;
+		}
+
+		_hash = HashClass::Combine(_hash, HashClass::Hash(file, fileSize));
+		delete[] file;
+	}
+
+	return true;
+}
+
+/*
+	A .glb starts with its header and the JSON chunk, optionally followed by the binary chunk, anything else is JSON text
+*/
+bool GltfReaderClass::ParseDocument(const unsigned char* _data, size_t _size, JsonClass& _json, const unsigned char*& _binary, size_t& _binarySize)
+{
+	_binary = nullptr;
+	_binarySize = 0;
+
+	if (_size < 20 || ReadUnsigned(_data) != GLB_MAGIC)
+	{
+		return _json.Parse(reinterpret_cast<const char*>(_data), _size);
+	}
+
+	if (ReadUnsigned(_data + 4) != GLB_VERSION || ReadUnsigned(_data + 8) > _size)
+	{
+		return false;
+	}
+
+	size_t fileSize = ReadUnsigned(_data + 8);
+	size_t jsonSize = ReadUnsigned(_data + 12);
+	if (ReadUnsigned(_data + 16) != GLB_CHUNK_JSON || jsonSize > fileSize - 20)
+	{
+		return false;
+	}
+
+	size_t binaryChunk = 20 + ((jsonSize + 3) & ~static_cast<size_t>(3));
+	if (binaryChunk + 8 <= fileSize && ReadUnsigned(_data + binaryChunk + 4) == GLB_CHUNK_BINARY)
+	{
+		size_t chunkSize = ReadUnsigned(_data + binaryChunk);
+		if (chunkSize > fileSize - binaryChunk - 8)
+		{
+			return false;
+		}
+
+		_binary = _data + binaryChunk + 8;
+		_binarySize = chunkSize;
+	}
+
+	return _json.Parse(reinterpret_cast<const char*>(_data + 20), jsonSize);
+}
+
+/*
+	Path of a buffer file relative to the .gltf, false for data uris
+*/
+bool GltfReaderClass::GetExternalPath(const JsonValue* _uri, const char* _path, char* _externalPath, size_t _externalPathSize)
+{
+	if (_uri->type != JSON_STRING || (_uri->stringLength >= 5 && memcmp(_uri->string, "data:", 5) == 0))
+	{
+		return false;
+	}
+
+	size_t directoryLength = 0;
+	for (size_t i = 0; _path[i] != 0; i++)
+	{
+		if (_path[i] == '/' || _path[i] == '\\')
+		{
+			directoryLength = i + 1;
+		}
+	}
+
+	if (directoryLength + _uri->stringLength + 1 > _externalPathSize)
+	{
+		return false;
+	}
+
+	memcpy(_externalPath, _path, directoryLength);
+	memcpy(_externalPath + directoryLength, _uri->string, _uri->stringLength);
+	_externalPath[directoryLength + _uri->stringLength] = 0;
+
+	return true;
+}
+
+/*
+	Every buffer as its own copy: the binary chunk of a .glb, a base64 data uri or a file next to the .gltf
+*/
+bool GltfReaderClass::LoadBuffers(const JsonClass& _json, const char* _path, const unsigned char* _binary, size_t _binarySize,
+	unsigned char** _buffers, size_t* _bufferSizes, unsigned int& _bufferCount)
+{
+	_bufferCount = 0;
+
+	const JsonValue* buffers = _json.Find(_json.GetRoot(), "buffers");
+	for (const JsonValue* buffer = _json.GetElement(buffers, 0); buffer; buffer = _json.GetNext(buffer))
+	{
+		const JsonValue* uri = _json.Find(buffer, "uri");
+		unsigned char* data = nullptr;
+		size_t size = 0;
+		char externalPath[MAX_COOKER_PATH];
+
+		if (_bufferCount == MAX_GLTF_BUFFERS)
+		{
+			data = nullptr;
+		}
+		else if (!uri)
+		{
+			if (_binary)
+			{
+				data = new unsigned char[_binarySize > 0 ? _binarySize : 1];
+				memcpy(data, _binary, _binarySize);
+				size = _binarySize;
+			}
+		}
+		else if (GetExternalPath(uri, _path, externalPath, sizeof(externalPath)))
+		{
+			data = CookerClass::ReadFile(externalPath, size);
+		}
+		else if (uri->type == JSON_STRING)
+		{
+			const char* separator = static_cast<const char*>(memchr(uri->string, ',', uri->stringLength));
+			if (separator && separator - uri->string >= 7 && memcmp(separator - 7, ";base64", 7) == 0)
+			{
+				data = DecodeBase64(separator + 1, uri->stringLength - (separator + 1 - uri->string), size);
+			}
+		}
+
+		if (!data || size < static_cast<size_t>(_json.GetNumber(buffer, "byteLength", 0.0)))
+		{
+			delete[] data;
+			for (unsigned int i = 0; i < _bufferCount; i++)
+			{
+				delete[] _buffers[i];
+			}
+			_bufferCount = 0;
+			return false;
+		}
+
+		_buffers[_bufferCount] = data;
+		_bufferSizes[_bufferCount] = size;
+		_bufferCount++;
+	}
+
+	return true;
+}
+
+/*
+	Check an accessor against its buffer view and buffer and return its element count, INVALID_ACCESSOR if anything does not fit
+	With _floats the elements are converted to floats (normalized integers as the specification says),
+	with _integers they are read as indices, with neither only the checks are done
+*/
+unsigned int GltfReaderClass::ReadAccessor(const JsonClass& _json, unsigned int _accessor, unsigned char* const* _buffers, const size_t* _bufferSizes, unsigned int _bufferCount,
+	unsigned int _components, float* _floats, unsigned int* _integers)
+{
+	static const char* types[] = { "SCALAR", "VEC2", "VEC3" };
+
+	const JsonValue* accessor = _json.GetElement(_json.Find(_json.GetRoot(), "accessors"), _accessor);
+	if (!accessor || _components < 1 || _components > 3 || !JsonClass::Equals(_json.Find(accessor, "type"), types[_components - 1]) || _json.Find(accessor, "sparse"))
+	{
+		return INVALID_ACCESSOR;
+	}
+
+	double viewIndex = _json.GetNumber(accessor, "bufferView", -1.0);
+	const JsonValue* view = viewIndex >= 0.0 ? _json.GetElement(_json.Find(_json.GetRoot(), "bufferViews"), static_cast<unsigned int>(viewIndex)) : nullptr;
+	double bufferIndex = _json.GetNumber(view, "buffer", -1.0);
+	if (!view || bufferIndex < 0.0 || bufferIndex >= static_cast<double>(_bufferCount))
+	{
+		return INVALID_ACCESSOR;
+	}
+
+	unsigned int componentType = static_cast<unsigned int>(_json.GetNumber(accessor, "componentType", 0.0));
+	bool normalized = _json.Find(accessor, "normalized") && _json.Find(accessor, "normalized")->number != 0.0;
+	size_t componentSize;
+	switch (componentType)
+	{
+	case GLTF_BYTE:
+	case GLTF_UNSIGNED_BYTE:
+		componentSize = 1;
+		break;
+	case GLTF_SHORT:
+	case GLTF_UNSIGNED_SHORT:
+		componentSize = 2;
+		break;
+	case GLTF_UNSIGNED_INT:
+	case GLTF_FLOAT:
+		componentSize = 4;
+		break;
+	default:
+		return INVALID_ACCESSOR;
+	}
+
+	//	Indices are unsigned integers, everything else floats or normalized integers
+	bool isIndex = _components == 1;
+	if (isIndex ? (componentType != GLTF_UNSIGNED_BYTE && componentType != GLTF_UNSIGNED_SHORT && componentType != GLTF_UNSIGNED_INT)
+		: (componentType != GLTF_FLOAT && !normalized))
+	{
+		return INVALID_ACCESSOR;
+	}
+
+	double count = _json.GetNumber(accessor, "count", -1.0);
+	double viewOffset = _json.GetNumber(view, "byteOffset", 0.0);
+	double viewLength = _json.GetNumber(view, "byteLength", -1.0);
+	double accessorOffset = _json.GetNumber(accessor, "byteOffset", 0.0);
+	size_t elementSize = componentSize * _components;
+	double stride = _json.GetNumber(view, "byteStride", static_cast<double>(elementSize));
+
+	if (count < 1.0 || count > 0xFFFFFFF0 || viewOffset < 0.0 || viewLength < 0.0 || accessorOffset < 0.0 || stride < static_cast<double>(elementSize) ||
+		viewOffset + viewLength > static_cast<double>(_bufferSizes[static_cast<size_t>(bufferIndex)]) || accessorOffset + stride * (count - 1.0) + static_cast<double>(elementSize) > viewLength)
+	{
+		return INVALID_ACCESSOR;
+	}
+
+	unsigned int elementCount = static_cast<unsigned int>(count);
+	unsigned int buffer = static_cast<unsigned int>(bufferIndex);
+	const unsigned char* data = _buffers[buffer] + static_cast<size_t>(viewOffset) + static_cast<size_t>(accessorOffset);
+	size_t elementStride = static_cast<size_t>(stride);
+
+	for (unsigned int i = 0; i < elementCount && (_floats || _integers); i++)
+	{
+		const unsigned char* element = data + i * elementStride;
+		for (unsigned int component = 0; component < _components; component++)
+		{
+			const unsigned char* source = element + component * componentSize;
+			unsigned int bits = componentSize == 1 ? source[0] : (componentSize == 2 ? source[0] | (source[1] << 8) : ReadUnsigned(source));
+
+			if (_integers)
+			{
+				_integers[i] = bits;
+				continue;
+			}
+
+			float value;
+			switch (componentType)
+			{
+			case GLTF_FLOAT:
+				memcpy(&value, &bits, sizeof(value));
+				break;
+			case GLTF_UNSIGNED_BYTE:
+				value = static_cast<float>(bits) / 255.0f;
+				break;
+			case GLTF_UNSIGNED_SHORT:
+				value = static_cast<float>(bits) / 65535.0f;
+				break;
+			case GLTF_BYTE:
+				value = static_cast<float>(static_cast<signed char>(bits)) / 127.0f;
+				value = value < -1.0f ? -1.0f : value;
+				break;
+			default:
+				value = static_cast<float>(static_cast<short>(bits)) / 32767.0f;
+				value = value < -1.0f ? -1.0f : value;
+				break;
+			}
+			_floats[static_cast<size_t>(i) * _components + component] = value;
+		}
+	}
+
+	return elementCount;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "JsonClass.h"
+#include "MeshCookerClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_GLTF_BUFFERS = 16;
+#pragma endregion
+
+/*
+	glTF 2.0, both .gltf (buffers in files next to it or base64 data uris) and binary .glb
+	All triangle primitives of all meshes are merged into one mesh, node transforms are not applied
+	Only POSITION, NORMAL and TEXCOORD_0 are read, sparse accessors are not supported
+*/
+class GltfReaderClass
+{
+public:
+	static bool Read(const unsigned char* _data, size_t _size, const char* _path, SourceMesh& _mesh);
+	static bool HashDependencies(const unsigned char* _data, size_t _size, const char* _path, unsigned long long& _hash);
+
+private:
+	static bool ParseDocument(const unsigned char* _data, size_t _size, JsonClass& _json, const unsigned char*& _binary, size_t& _binarySize);
+	static bool GetExternalPath(const JsonValue* _uri, const char* _path, char* _externalPath, size_t _externalPathSize);
+	static bool LoadBuffers(const JsonClass& _json, const char* _path, const unsigned char* _binary, size_t _binarySize,
+		unsigned char** _buffers, size_t* _bufferSizes, unsigned int& _bufferCount);
+	static unsigned int ReadAccessor(const JsonClass& _json, unsigned int _accessor, unsigned char* const* _buffers, const size_t* _bufferSizes, unsigned int _bufferCount,
+		unsigned int _components, float* _floats, unsigned int* _integers);
+};
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "JsonClass.h"
+#include <cstdlib>
+#include <cstring>
+
+/*
+	Constructor
+*/
+JsonClass::JsonClass()
+{
+	m_values = nullptr;
+	m_valueCount = 0;
+	m_capacity = 0;
+	m_cursor = nullptr;
+	m_end = nullptr;
+}
+
+/*
+	Destructor
+*/
+JsonClass::~JsonClass()
+{
+	Release();
+}
+
+/*
+	Every value takes at least two characters including its separator, so half the text is enough space for all of them
+	Anything but whitespace behind the root value is an error
+*/
+bool JsonClass::Parse(const char* _text, size_t _size)
+{
+	Release();
+
+	m_capacity = static_cast<unsigned int>(_size / 2 + 2);
+	m_values = new JsonValue[m_capacity];
+	m_cursor = _text;
+	m_end = _text + _size;
+
+	if (ParseValue(0) == JSON_NO_VALUE)
+	{
+		Release();
+		return false;
+	}
+
+	SkipWhitespace();
+	if (m_cursor != m_end)
+	{
+		Release();
+		return false;
+	}
+
+	return true;
+}
+
+void JsonClass::Release()
+{
+	delete[] m_values;
+	m_values = nullptr;
+	m_valueCount = 0;
+	m_capacity = 0;
+}
+
+const JsonValue* JsonClass::GetRoot() const
+{
+	return m_valueCount > 0 ? &m_values[0] : nullptr;
+}
+
+/*
+	Member of an object, nullptr if _object is no object or has no such member
+*/
+const JsonValue* JsonClass::Find(const JsonValue* _object, const char* _key) const
+{
+	if (!_object || _object->type != JSON_OBJECT)
+	{
+		return nullptr;
+	}
+
+	size_t keyLength = strlen(_key);
+	for (unsigned int child = _object->firstChild; child != JSON_NO_VALUE; child = m_values[child].nextSibling)
+	{
+		if (m_values[child].keyLength == keyLength && memcmp(m_values[child].key, _key, keyLength) == 0)
+		{
+			return &m_values[child];
+		}
+	}
+
+	return nullptr;
+}
+
+const JsonValue* JsonClass::GetElement(const JsonValue* _array, unsigned int _index) const
+{
+	if (!_array || _array->type != JSON_ARRAY || _index >= _array->childCount)
+	{
+		return nullptr;
+	}
+
+	unsigned int child = _array->firstChild;
+	for (unsigned int i = 0; i < _index; i++)
+	{
+		child = m_values[child].nextSibling;
+	}
+
+	return &m_values[child];
+}
+
+const JsonValue* JsonClass::GetNext(const JsonValue* _value) const
+{
+	return _value->nextSibling != JSON_NO_VALUE ? &m_values[_value->nextSibling] : nullptr;
+}
+
+double JsonClass::GetNumber(const JsonValue* _object, const char* _key, double _default) const
+{
+	const JsonValue* value = Find(_object, _key);
+
+	return value && value->type == JSON_NUMBER ? value->number : _default;
+}
+
+bool JsonClass::Equals(const JsonValue* _value, const char* _string)
+{
+	if (!_value || _value->type != JSON_STRING)
+	{
+		return false;
+	}
+
+	size_t length = strlen(_string);
+
+	return _value->stringLength == length && memcmp(_value->string, _string, length) == 0;
+}
+
+/*
+	Recursive descent, returns the index of the new value or JSON_NO_VALUE on a syntax error
+*/
+unsigned int JsonClass::ParseValue(unsigned int _depth)
+{
+	SkipWhitespace();
+	if (m_cursor == m_end || _depth > JSON_MAX_DEPTH || m_valueCount == m_capacity)
+	{
+		return JSON_NO_VALUE;
+	}
+
+	unsigned int index = m_valueCount++;
+	JsonValue& value = m_values[index];
+	memset(&value, 0, sizeof(value));
+	value.firstChild = JSON_NO_VALUE;
+	value.nextSibling = JSON_NO_VALUE;
+
+	char first = *m_cursor;
+	if (first == '{' || first == '[')
+	{
+		bool object = first == '{';
+		char close = object ? '}' : ']';
+		value.type = object ? JSON_OBJECT : JSON_ARRAY;
+		m_cursor++;
+
+		SkipWhitespace();
+		if (m_cursor != m_end && *m_cursor == close)
+		{
+			m_cursor++;
+			return index;
+		}
+
+		unsigned int previous = JSON_NO_VALUE;
+		while (true)
+		{
+			const char* key = nullptr;
+			unsigned int keyLength = 0;
+			if (object)
+			{
+				SkipWhitespace();
+				if (!ParseString(key, keyLength))
+				{
+					return JSON_NO_VALUE;
+				}
+
+				SkipWhitespace();
+				if (m_cursor == m_end || *m_cursor != ':')
+				{
+					return JSON_NO_VALUE;
+				}
+				m_cursor++;
+			}
+
+			unsigned int child = ParseValue(_depth + 1);
+			if (child == JSON_NO_VALUE)
+			{
+				return JSON_NO_VALUE;
+			}
+
+			//	m_values does not move, the reference stays valid
+			m_values[child].key = key;
+			m_values[child].keyLength = keyLength;
+			if (previous == JSON_NO_VALUE)
+			{
+				value.firstChild = child;
+			}
+			else
+			{
+				m_values[previous].nextSibling = child;
+			}
+			previous = child;
+			value.childCount++;
+
+			SkipWhitespace();
+			if (m_cursor == m_end)
+			{
+				return JSON_NO_VALUE;
+			}
+			if (*m_cursor == ',')
+			{
+				m_cursor++;
+				continue;
+			}
+			if (*m_cursor != close)
+			{
+				return JSON_NO_VALUE;
+			}
+			m_cursor++;
+
+			return index;
+		}
+	}
+
+	if (first == '"')
+	{
+		value.type = JSON_STRING;
+		return ParseString(value.string, value.stringLength) ? index : JSON_NO_VALUE;
+	}
+
+	static const char* literals[] = { "true", "false", "null" };
+	for (int i = 0; i < 3; i++)
+	{
+		size_t length = strlen(literals[i]);
+		if (static_cast<size_t>(m_end - m_cursor) >= length && memcmp(m_cursor, literals[i], length) == 0)
+		{
+			value.type = i == 2 ? JSON_NULL : JSON_BOOLEAN;
+			value.number = i == 0 ? 1.0 : 0.0;
+			m_cursor += length;
+			return index;
+		}
+	}
+
+	//	Copied out, the text is not terminated
+	char number[64];
+	size_t length = 0;
+	while (m_cursor + length < m_end && length < sizeof(number) - 1 && strchr("+-0123456789.eE", m_cursor[length]) && m_cursor[length] != 0)
+	{
+		number[length] = m_cursor[length];
+		length++;
+	}
+	number[length] = 0;
+
+	char* end;
+	value.type = JSON_NUMBER;
+	value.number = strtod(number, &end);
+	if (length == 0 || end != number + length)
+	{
+		return JSON_NO_VALUE;
+	}
+	m_cursor += length;
+
+	return index;
+}
+
+/*
+	The string without its quotes, escapes are skipped over but left as they are
+*/
+bool JsonClass::ParseString(const char*& _string, unsigned int& _length)
+{
+	if (m_cursor == m_end || *m_cursor != '"')
+	{
+		return false;
+	}
+	m_cursor++;
+
+	const char* begin = m_cursor;
+	while (m_cursor != m_end && *m_cursor != '"')
+	{
+		if (*m_cursor == '\\')
+		{
+			m_cursor++;
+			if (m_cursor == m_end)
+			{
+				return false;
+			}
+		}
+		m_cursor++;
+	}
+
+	if (m_cursor == m_end)
+	{
+		return false;
+	}
+
+	_string = begin;
+	_length = static_cast<unsigned int>(m_cursor - begin);
+	m_cursor++;
+
+	return true;
+}
+
+void JsonClass::SkipWhitespace()
+{
+	while (m_cursor != m_end && (*m_cursor == ' ' || *m_cursor == '\t' || *m_cursor == '\n' || *m_cursor == '\r'))
+	{
+		m_cursor++;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+#pragma region global variables
+const unsigned int JSON_NULL = 0;
+const unsigned int JSON_BOOLEAN = 1;
+const unsigned int JSON_NUMBER = 2;
+const unsigned int JSON_STRING = 3;
+const unsigned int JSON_ARRAY = 4;
+const unsigned int JSON_OBJECT = 5;
+
+const unsigned int JSON_NO_VALUE = 0xFFFFFFFF;
+const unsigned int JSON_MAX_DEPTH = 64;
+#pragma endregion
+
+/*
+	One value of the document, children are linked through nextSibling
+	Strings point into the text and are not unescaped, which is fine for the keys and uris of glTF
+*/
+struct JsonValue
+{
+	unsigned int type;
+	unsigned int firstChild;
+	unsigned int nextSibling;
+	unsigned int childCount;
+	const char* key;				// member name inside an object
+	unsigned int keyLength;
+	const char* string;
+	unsigned int stringLength;
+	double number;					// also 0 or 1 for booleans
+};
+
+/*
+	Read-only JSON document, all values in one array allocated by Parse
+	The text has to stay alive as long as the document is used
+*/
+class JsonClass
+{
+public:
+	JsonClass();
+	~JsonClass();
+
+	bool Parse(const char* _text, size_t _size);
+	void Release();
+
+	const JsonValue* GetRoot() const;
+	const JsonValue* Find(const JsonValue* _object, const char* _key) const;
+	const JsonValue* GetElement(const JsonValue* _array, unsigned int _index) const;
+	const JsonValue* GetNext(const JsonValue* _value) const;
+	double GetNumber(const JsonValue* _object, const char* _key, double _default) const;
+	static bool Equals(const JsonValue* _value, const char* _string);
+
+private:
+	unsigned int ParseValue(unsigned int _depth);
+	bool ParseString(const char*& _string, unsigned int& _length);
+	void SkipWhitespace();
+
+	JsonValue* m_values;
+	unsigned int m_valueCount;
+	unsigned int m_capacity;
+	const char* m_cursor;
+	const char* m_end;
+};
\ No newline at end of file
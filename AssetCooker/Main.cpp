@@ -0,0 +1,129 @@
+#include "CookerClass.h"
+#include "SceneCookerClass.h"
+#include "JobSystemClass.h"
+#include "TimerClass.h"
+#include <cstdio>
+#include <cstring>
+
+/*
+	AssetCooker [-cache <directory>] [-srgb | -linear] <package> <inputs...>
+	AssetCooker -scene <scene.json> <scene>
+	-cache <directory> keeps every cooked asset there, unchanged inputs are not cooked again
+	-scene <scene.json> <scene> cooks a JSON scene into a binary scene file (SceneCookerClass), no package is needed then
+	-srgb / -linear set the color space of the PNG inputs behind them (sRGB by default)
+	Meshes: .obj, .gltf, .glb, textures: .png
+*/
+static void PrintUsage()
+{
+	printf("usage: AssetCooker [-cache <directory>] [-srgb | -linear] <package> <inputs...>\n");
+	printf("       AssetCooker -scene <scene.json> <scene>\n");
+}
+
+/*
+	Read the commandline arguments, cook the inputs on all hardware threads and write the package
+	Cook the scene first if one is given
+	Returns 0 if the package and the scene were written, 1 otherwise
+*/
+int main(int _argumentCount, char** _arguments)
+{
+	const char* cacheDirectory = nullptr;
+	const char* packagePath = nullptr;
+	const char* sceneInputPath = nullptr;
+	const char* scenePath = nullptr;
+	bool srgb = true;
+
+	CookerInput* inputs = new CookerInput[_argumentCount > 1 ? _argumentCount : 1];
+	unsigned int inputCount = 0;
+
+	for (int i = 1; i < _argumentCount; i++)
+	{
+		if (strcmp(_arguments[i], "-cache") == 0 && i + 1 < _argumentCount)
+		{
+			cacheDirectory = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-scene") == 0 && i + 2 < _argumentCount)
+		{
+			sceneInputPath = _arguments[i + 1];
+			scenePath = _arguments[i + 2];
+			i += 2;
+		}
+		else if (strcmp(_arguments[i], "-srgb") == 0)
+		{
+			srgb = true;
+		}
+		else if (strcmp(_arguments[i], "-linear") == 0)
+		{
+			srgb = false;
+		}
+		else if (!packagePath)
+		{
+			packagePath = _arguments[i];
+		}
+		else
+		{
+			inputs[inputCount].path = _arguments[i];
+			inputs[inputCount].srgb = srgb;
+			inputCount++;
+		}
+	}
+
+	if (!packagePath && !scenePath)
+	{
+		PrintUsage();
+		delete[] inputs;
+		return 1;
+	}
+
+	if (scenePath)
+	{
+		unsigned long long start = TimerClass::GetMicroseconds();
+		unsigned int objectCount = 0;
+		bool cookedScene = SceneCookerClass::Cook(sceneInputPath, scenePath, objectCount);
+		double milliseconds = static_cast<double>(TimerClass::GetMicroseconds() - start) / 1000.0;
+
+		if (!cookedScene)
+		{
+			printf("could not cook the scene %s\n", sceneInputPath);
+			delete[] inputs;
+			return 1;
+		}
+
+		printf("%s: %u objects, %.1f ms\n", scenePath, objectCount, milliseconds);
+
+		if (!packagePath)
+		{
+			delete[] inputs;
+			return 0;
+		}
+	}
+
+	JobSystemClass jobSystem;
+	if (!jobSystem.Initialize(0))
+	{
+		printf("could not start the jobsystem\n");
+		delete[] inputs;
+		return 1;
+	}
+
+	CookerClass cooker;
+	bool cooked = false;
+	if (!cooker.Initialize(cacheDirectory, &jobSystem))
+	{
+		printf("could not create the cache directory %s\n", cacheDirectory);
+	}
+	else
+	{
+		unsigned long long start = TimerClass::GetMicroseconds();
+		cooked = cooker.Cook(inputs, inputCount, packagePath);
+		double milliseconds = static_cast<double>(TimerClass::GetMicroseconds() - start) / 1000.0;
+
+		printf("%s: %u assets, %u cooked, %u from the cache, %.1f ms\n", packagePath, inputCount, cooker.GetCookedCount(), cooker.GetCachedCount(), milliseconds);
+	}
+
+	cooker.Shutdown();
+	jobSystem.Shutdown();
+	delete[] inputs;
+
+	return cooked ? 0 : 1;
+}
\ No newline at end of file
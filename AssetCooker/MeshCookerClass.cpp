@@ -0,0 +1,662 @@
+#include "MeshCookerClass.h"
+#include "MeshSimplifierClass.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int NO_VERTEX = 0xFFFFFFFF;
+static const unsigned int MAX_VALENCE_SCORE = 32;
+static const float LAST_TRIANGLE_SCORE = 0.75f;
+static const float CACHE_DECAY_POWER = 1.5f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+#pragma endregion
+
+/*
+	Scores of "Linear-Speed Vertex Cache Optimisation" (Tom Forsyth), as tables so every vertex is scored the same way
+*/
+struct VertexScoreTables
+{
+	float cache[VERTEX_CACHE_SIZE];
+	float valence[MAX_VALENCE_SCORE];
+
+	VertexScoreTables()
+	{
+		for (unsigned int i = 0; i < VERTEX_CACHE_SIZE; i++)
+		{
+			//	The vertices of the last triangle get a fixed score, so the next triangle does not simply reuse the same edge
+			cache[i] = i < 3 ? LAST_TRIANGLE_SCORE : powf(1.0f - static_cast<float>(i - 3) / static_cast<float>(VERTEX_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+		}
+
+		for (unsigned int i = 0; i < MAX_VALENCE_SCORE; i++)
+		{
+			//	Vertices with few triangles left are preferred, so no lonely triangles stay behind
+			valence[i] = i == 0 ? 0.0f : VALENCE_BOOST_SCALE * powf(static_cast<float>(i), -VALENCE_BOOST_POWER);
+		}
+	}
+
+	float Score(int _cachePosition, unsigned int _remaining) const
+	{
+		if (_remaining == 0)
+		{
+			return -1.0f;
+		}
+
+		float score = _cachePosition >= 0 ? cache[_cachePosition] : 0.0f;
+
+		return score + valence[_remaining < MAX_VALENCE_SCORE ? _remaining : MAX_VALENCE_SCORE - 1];
+	}
+};
+
+void MeshCookerClass::Release(SourceMesh& _mesh)
+{
+	delete[] _mesh.positions;
+	delete[] _mesh.normals;
+	delete[] _mesh.texcoords;
+	delete[] _mesh.indices;
+	memset(&_mesh, 0, sizeof(_mesh));
+}
+
+/*
+	Check the mesh, build the levels of detail, optimise their index order, drop unused vertices and reorder the rest by first use
+	Then quantize the vertices, build the meshlets of the full mesh and lay everything out behind the header
+*/
+bool MeshCookerClass::Cook(const SourceMesh& _mesh, unsigned char*& _asset, size_t& _assetSize)
+{
+	_asset = nullptr;
+	_assetSize = 0;
+
+	if (!_mesh.positions || _mesh.vertexCount == 0 || _mesh.indexCount == 0 || _mesh.indexCount % 3 != 0)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < _mesh.indexCount; i++)
+	{
+		if (_mesh.indices[i] >= _mesh.vertexCount)
+		{
+			return false;
+		}
+	}
+
+	unsigned int* lodIndices[MESH_MAX_LODS];
+	unsigned int lodIndexCounts[MESH_MAX_LODS];
+	float lodErrors[MESH_MAX_LODS];
+	unsigned int lodCount = BuildLods(_mesh, lodIndices, lodIndexCounts, lodErrors);
+
+	unsigned int* indices = lodIndices[0];
+	unsigned int* remap = new unsigned int[_mesh.vertexCount];
+	unsigned int* order = new unsigned int[_mesh.vertexCount];
+	float* generatedNormals = _mesh.normals ? nullptr : new float[static_cast<size_t>(_mesh.vertexCount) * 3];
+
+	if (generatedNormals)
+	{
+		GenerateNormals(_mesh, generatedNormals);
+	}
+	const float* normals = _mesh.normals ? _mesh.normals : generatedNormals;
+
+	//	Vertices in the order the optimised indices first use them
+	unsigned int vertexCount = 0;
+	memset(remap, 0xFF, sizeof(unsigned int) * _mesh.vertexCount);
+	for (unsigned int i = 0; i < _mesh.indexCount; i++)
+	{
+		unsigned int& target = remap[indices[i]];
+		if (target == NO_VERTEX)
+		{
+			order[vertexCount] = indices[i];
+			target = vertexCount++;
+		}
+		indices[i] = target;
+	}
+
+	//	The simplified levels may collapse onto a welded duplicate the full mesh does not use (e.g. a seam vertex at a pole), those follow behind
+	unsigned int totalIndexCount = _mesh.indexCount;
+	for (unsigned int level = 1; level < lodCount; level++)
+	{
+		for (unsigned int i = 0; i < lodIndexCounts[level]; i++)
+		{
+			unsigned int& target = remap[lodIndices[level][i]];
+			if (target == NO_VERTEX)
+			{
+				order[vertexCount] = lodIndices[level][i];
+				target = vertexCount++;
+			}
+			lodIndices[level][i] = target;
+		}
+		totalIndexCount += lodIndexCounts[level];
+	}
+
+	float* positions = new float[static_cast<size_t>(vertexCount) * 3];
+	float boundsMinimum[3] = { INFINITY, INFINITY, INFINITY };
+	float boundsMaximum[3] = { -INFINITY, -INFINITY, -INFINITY };
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float value = _mesh.positions[static_cast<size_t>(order[i]) * 3 + axis];
+			positions[static_cast<size_t>(i) * 3 + axis] = value;
+			boundsMinimum[axis] = value < boundsMinimum[axis] ? value : boundsMinimum[axis];
+			boundsMaximum[axis] = value > boundsMaximum[axis] ? value : boundsMaximum[axis];
+		}
+	}
+
+	//	A meshlet holds at least one triangle, so there are never more meshlets than triangles
+	unsigned int triangleCount = _mesh.indexCount / 3;
+	Meshlet* meshlets = new Meshlet[triangleCount];
+	unsigned int* meshletVertices = new unsigned int[_mesh.indexCount];
+	unsigned char* meshletTriangles = new unsigned char[_mesh.indexCount];
+	unsigned int meshletVertexCount = 0;
+	unsigned int meshletCount = BuildMeshlets(indices, _mesh.indexCount, vertexCount, meshlets, meshletVertices, meshletTriangles, meshletVertexCount);
+
+	//	The sphere has to contain the quantized positions as well
+	float quantizationError = 0.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float step = (boundsMaximum[axis] - boundsMinimum[axis]) / 65535.0f;
+		quantizationError += step * step;
+	}
+	quantizationError = sqrtf(quantizationError) * 0.5f;
+
+	for (unsigned int i = 0; i < meshletCount; i++)
+	{
+		ComputeMeshletBounds(meshlets[i], meshletVertices, positions);
+		meshlets[i].radius += quantizationError;
+	}
+
+	//	Lay out the arrays behind the header
+	unsigned int indexSize = vertexCount <= 0x10000 ? 2 : 4;
+	unsigned long long offset = sizeof(MeshAssetHeader);
+	unsigned long long offsets[5];
+	unsigned long long sizes[5] = {
+		static_cast<unsigned long long>(vertexCount) * sizeof(MeshVertex),
+		static_cast<unsigned long long>(totalIndexCount) * indexSize,
+		static_cast<unsigned long long>(meshletCount) * sizeof(Meshlet),
+		static_cast<unsigned long long>(meshletVertexCount) * sizeof(unsigned int),
+		static_cast<unsigned long long>(_mesh.indexCount) };
+
+	for (int i = 0; i < 5; i++)
+	{
+		offset = (offset + MESH_ASSET_ARRAY_ALIGNMENT - 1) & ~static_cast<unsigned long long>(MESH_ASSET_ARRAY_ALIGNMENT - 1);
+		offsets[i] = offset;
+		offset += sizes[i];
+	}
+
+	//	Zeroed, so padding and unused fields are the same on every run
+	unsigned char* asset = new unsigned char[static_cast<size_t>(offset)];
+	memset(asset, 0, static_cast<size_t>(offset));
+
+	MeshAssetHeader* header = reinterpret_cast<MeshAssetHeader*>(asset);
+	header->header.type = ASSET_TYPE_MESH;
+	header->header.version = MESH_ASSET_VERSION;
+	header->header.size = offset;
+	memcpy(header->boundsMinimum, boundsMinimum, sizeof(boundsMinimum));
+	memcpy(header->boundsMaximum, boundsMaximum, sizeof(boundsMaximum));
+	header->vertexCount = vertexCount;
+	header->indexCount = totalIndexCount;
+	header->indexSize = indexSize;
+	header->meshletCount = meshletCount;
+	header->meshletVertexCount = meshletVertexCount;
+	header->meshletTriangleCount = triangleCount;
+	header->lodCount = lodCount;
+	header->vertexOffset = offsets[0];
+	header->indexOffset = offsets[1];
+	header->meshletOffset = offsets[2];
+	header->meshletVertexOffset = offsets[3];
+	header->meshletTriangleOffset = offsets[4];
+
+	MeshVertex* vertices = reinterpret_cast<MeshVertex*>(asset + offsets[0]);
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		size_t source = order[i];
+		EncodeVertex(&_mesh.positions[source * 3], &normals[source * 3], _mesh.texcoords ? &_mesh.texcoords[source * 2] : nullptr, boundsMinimum, boundsMaximum, vertices[i]);
+	}
+
+	unsigned int firstIndex = 0;
+	for (unsigned int level = 0; level < lodCount; level++)
+	{
+		header->lods[level].firstIndex = firstIndex;
+		header->lods[level].indexCount = lodIndexCounts[level];
+		header->lods[level].error = lodErrors[level];
+
+		for (unsigned int i = 0; i < lodIndexCounts[level]; i++)
+		{
+			if (indexSize == 2)
+			{
+				reinterpret_cast<unsigned short*>(asset + offsets[1])[firstIndex + i] = static_cast<unsigned short>(lodIndices[level][i]);
+			}
+			else
+			{
+				reinterpret_cast<unsigned int*>(asset + offsets[1])[firstIndex + i] = lodIndices[level][i];
+			}
+		}
+		firstIndex += lodIndexCounts[level];
+	}
+
+	memcpy(asset + offsets[2], meshlets, static_cast<size_t>(sizes[2]));
+	memcpy(asset + offsets[3], meshletVertices, static_cast<size_t>(sizes[3]));
+	memcpy(asset + offsets[4], meshletTriangles, static_cast<size_t>(sizes[4]));
+
+	delete[] meshletTriangles;
+	delete[] meshletVertices;
+	delete[] meshlets;
+	delete[] positions;
+	delete[] generatedNormals;
+	delete[] order;
+	delete[] remap;
+	for (unsigned int level = 0; level < lodCount; level++)
+	{
+		delete[] lodIndices[level];
+	}
+
+	_asset = asset;
+	_assetSize = static_cast<size_t>(offset);
+
+	return true;
+}
+
+/*
+	Level 0 is the full mesh, every further level is simplified from it down to MESH_LOD_REDUCTION of the triangles of the level before
+	The chain ends at MESH_MAX_LODS levels, below MESH_LOD_MIN_TRIANGLES or once the simplifier gets stuck (MESH_LOD_MIN_REDUCTION)
+	Simplifying the full mesh every time keeps the errors exact, they are kept growing so a coarser level never claims to be closer
+	The indices of every level are optimised for the vertex cache, returns the number of levels
+*/
+unsigned int MeshCookerClass::BuildLods(const SourceMesh& _mesh, unsigned int** _lodIndices, unsigned int* _lodIndexCounts, float* _lodErrors)
+{
+	_lodIndices[0] = new unsigned int[_mesh.indexCount];
+	_lodIndexCounts[0] = _mesh.indexCount;
+	_lodErrors[0] = 0.0f;
+	memcpy(_lodIndices[0], _mesh.indices, sizeof(unsigned int) * _mesh.indexCount);
+
+	unsigned int lodCount = 1;
+	unsigned int* simplified = new unsigned int[_mesh.indexCount];
+	while (lodCount < MESH_MAX_LODS && _lodIndexCounts[lodCount - 1] / 3 >= MESH_LOD_MIN_TRIANGLES)
+	{
+		unsigned int previousCount = _lodIndexCounts[lodCount - 1];
+		unsigned int targetCount = static_cast<unsigned int>(static_cast<float>(previousCount / 3) * MESH_LOD_REDUCTION) * 3;
+
+		float error;
+		unsigned int count = MeshSimplifierClass::Simplify(_mesh.positions, _mesh.vertexCount, _mesh.indices, _mesh.indexCount, targetCount, FLT_MAX, simplified, error);
+		if (count == 0 || static_cast<float>(count) > static_cast<float>(previousCount) * MESH_LOD_MIN_REDUCTION)
+		{
+			break;
+		}
+
+		_lodIndices[lodCount] = new unsigned int[count];
+		_lodIndexCounts[lodCount] = count;
+		_lodErrors[lodCount] = error > _lodErrors[lodCount - 1] ? error : _lodErrors[lodCount - 1];
+		memcpy(_lodIndices[lodCount], simplified, sizeof(unsigned int) * count);
+		lodCount++;
+	}
+	delete[] simplified;
+
+	for (unsigned int level = 0; level < lodCount; level++)
+	{
+		OptimizeVertexCache(_lodIndices[level], _lodIndexCounts[level], _mesh.vertexCount);
+	}
+
+	return lodCount;
+}
+
+/*
+	Greedy triangle order after Forsyth: always emit the triangle whose vertices score highest,
+	vertices score high if they are in the simulated cache and have few triangles left
+	Only triangles of vertices that just changed are rescored, if none of them is left the next unused triangle in the list starts over
+*/
+void MeshCookerClass::OptimizeVertexCache(unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount)
+{
+	static const VertexScoreTables scores;
+
+	unsigned int triangleCount = _indexCount / 3;
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	unsigned int* remaining = new unsigned int[_vertexCount];
+	unsigned int* adjacencyOffsets = new unsigned int[_vertexCount + 1];
+	unsigned int* adjacency = new unsigned int[_indexCount];
+	int* cachePositions = new int[_vertexCount];
+	float* vertexScores = new float[_vertexCount];
+	float* triangleScores = new float[triangleCount];
+	unsigned char* emitted = new unsigned char[triangleCount];
+	unsigned int* output = new unsigned int[_indexCount];
+
+	//	Triangles of every vertex, the ones still to be emitted are kept at the front of each list
+	memset(remaining, 0, sizeof(unsigned int) * _vertexCount);
+	for (unsigned int i = 0; i < _indexCount; i++)
+	{
+		remaining[_indices[i]]++;
+	}
+
+	adjacencyOffsets[0] = 0;
+	for (unsigned int i = 0; i < _vertexCount; i++)
+	{
+		adjacencyOffsets[i + 1] = adjacencyOffsets[i] + remaining[i];
+		remaining[i] = 0;
+	}
+
+	for (unsigned int i = 0; i < _indexCount; i++)
+	{
+		unsigned int vertex = _indices[i];
+		adjacency[adjacencyOffsets[vertex] + remaining[vertex]++] = i / 3;
+	}
+
+	for (unsigned int i = 0; i < _vertexCount; i++)
+	{
+		cachePositions[i] = -1;
+		vertexScores[i] = scores.Score(-1, remaining[i]);
+	}
+
+	unsigned int bestTriangle = 0;
+	float bestScore = -1.0f;
+	for (unsigned int i = 0; i < triangleCount; i++)
+	{
+		const unsigned int* triangle = &_indices[i * 3];
+		triangleScores[i] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+		if (triangleScores[i] > bestScore)
+		{
+			bestScore = triangleScores[i];
+			bestTriangle = i;
+		}
+	}
+	memset(emitted, 0, triangleCount);
+
+	//	The cache may overflow by the 3 vertices of a triangle before the oldest ones are dropped
+	unsigned int cache[VERTEX_CACHE_SIZE + 3];
+	unsigned int newCache[VERTEX_CACHE_SIZE + 3];
+	unsigned int cacheCount = 0;
+	unsigned int scanCursor = 0;
+
+	for (unsigned int outputTriangle = 0; outputTriangle < triangleCount; outputTriangle++)
+	{
+		if (bestTriangle == NO_VERTEX)
+		{
+			while (emitted[scanCursor])
+			{
+				scanCursor++;
+			}
+			bestTriangle = scanCursor;
+		}
+
+		const unsigned int* triangle = &_indices[bestTriangle * 3];
+		emitted[bestTriangle] = 1;
+		memcpy(&output[outputTriangle * 3], triangle, sizeof(unsigned int) * 3);
+
+		//	Move the triangle behind the remaining ones of its vertices
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int vertex = triangle[corner];
+			unsigned int* list = &adjacency[adjacencyOffsets[vertex]];
+			for (unsigned int i = 0; i < remaining[vertex]; i++)
+			{
+				if (list[i] == bestTriangle)
+				{
+					list[i] = list[remaining[vertex] - 1];
+					list[remaining[vertex] - 1] = bestTriangle;
+					remaining[vertex]--;
+					break;
+				}
+			}
+		}
+
+		//	The triangle's vertices go to the front, everything else moves back
+		unsigned int newCacheCount = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			bool duplicate = false;
+			for (unsigned int i = 0; i < newCacheCount; i++)
+			{
+				duplicate = duplicate || newCache[i] == triangle[corner];
+			}
+			if (!duplicate)
+			{
+				newCache[newCacheCount++] = triangle[corner];
+			}
+		}
+		for (unsigned int i = 0; i < cacheCount; i++)
+		{
+			unsigned int vertex = cache[i];
+			if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+			{
+				newCache[newCacheCount++] = vertex;
+			}
+		}
+
+		for (unsigned int i = 0; i < newCacheCount; i++)
+		{
+			unsigned int vertex = newCache[i];
+			cachePositions[vertex] = i < VERTEX_CACHE_SIZE ? static_cast<int>(i) : -1;
+			vertexScores[vertex] = scores.Score(cachePositions[vertex], remaining[vertex]);
+		}
+
+		//	Rescore the triangles touched by the cache, including the vertices that just fell out of it
+		bestTriangle = NO_VERTEX;
+		bestScore = -1.0f;
+		for (unsigned int i = 0; i < newCacheCount; i++)
+		{
+			unsigned int vertex = newCache[i];
+			const unsigned int* list = &adjacency[adjacencyOffsets[vertex]];
+			for (unsigned int j = 0; j < remaining[vertex]; j++)
+			{
+				unsigned int candidate = list[j];
+				const unsigned int* candidateTriangle = &_indices[candidate * 3];
+				float score = vertexScores[candidateTriangle[0]] + vertexScores[candidateTriangle[1]] + vertexScores[candidateTriangle[2]];
+				triangleScores[candidate] = score;
+				if (score > bestScore || (score == bestScore && candidate < bestTriangle))
+				{
+					bestScore = score;
+					bestTriangle = candidate;
+				}
+			}
+		}
+
+		cacheCount = newCacheCount < VERTEX_CACHE_SIZE ? newCacheCount : VERTEX_CACHE_SIZE;
+		memcpy(cache, newCache, sizeof(unsigned int) * cacheCount);
+	}
+
+	memcpy(_indices, output, sizeof(unsigned int) * _indexCount);
+
+	delete[] output;
+	delete[] emitted;
+	delete[] triangleScores;
+	delete[] vertexScores;
+	delete[] cachePositions;
+	delete[] adjacency;
+	delete[] adjacencyOffsets;
+	delete[] remaining;
+}
+
+/*
+	Average cache miss ratio: transformed vertices per triangle with a FIFO cache of _cacheSize entries
+	0.5 is the best a regular grid can do, 3 means no reuse at all
+*/
+float MeshCookerClass::ComputeAcmr(const unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount, unsigned int _cacheSize)
+{
+	if (_indexCount < 3)
+	{
+		return 0.0f;
+	}
+
+	//	A vertex is in the cache while fewer than _cacheSize misses happened since it was loaded
+	unsigned int* loadedAt = new unsigned int[_vertexCount];
+	memset(loadedAt, 0, sizeof(unsigned int) * _vertexCount);
+	unsigned int misses = 0;
+
+	for (unsigned int i = 0; i < _indexCount; i++)
+	{
+		unsigned int vertex = _indices[i];
+		if (loadedAt[vertex] == 0 || misses - loadedAt[vertex] >= _cacheSize)
+		{
+			misses++;
+			loadedAt[vertex] = misses;
+		}
+	}
+
+	delete[] loadedAt;
+
+	return static_cast<float>(misses) / static_cast<float>(_indexCount / 3);
+}
+
+/*
+	Area weighted face normals summed per vertex
+*/
+void MeshCookerClass::GenerateNormals(const SourceMesh& _mesh, float* _normals)
+{
+	memset(_normals, 0, sizeof(float) * 3 * _mesh.vertexCount);
+
+	for (unsigned int i = 0; i < _mesh.indexCount; i += 3)
+	{
+		const float* a = &_mesh.positions[static_cast<size_t>(_mesh.indices[i]) * 3];
+		const float* b = &_mesh.positions[static_cast<size_t>(_mesh.indices[i + 1]) * 3];
+		const float* c = &_mesh.positions[static_cast<size_t>(_mesh.indices[i + 2]) * 3];
+
+		float ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+		float ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+		float normal[3] = { ab[1] * ac[2] - ab[2] * ac[1], ab[2] * ac[0] - ab[0] * ac[2], ab[0] * ac[1] - ab[1] * ac[0] };
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			float* target = &_normals[static_cast<size_t>(_mesh.indices[i + corner]) * 3];
+			target[0] += normal[0];
+			target[1] += normal[1];
+			target[2] += normal[2];
+		}
+	}
+}
+
+/*
+	Walk the triangles in their optimised order and start a new meshlet whenever the next triangle does not fit
+	The order keeps neighbouring triangles together, so the meshlets come out compact without a spatial search
+*/
+unsigned int MeshCookerClass::BuildMeshlets(const unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount,
+	Meshlet* _meshlets, unsigned int* _meshletVertices, unsigned char* _meshletTriangles, unsigned int& _meshletVertexCount)
+{
+	//	Local index of each vertex in the current meshlet
+	unsigned int* localIndices = new unsigned int[_vertexCount];
+	memset(localIndices, 0xFF, sizeof(unsigned int) * _vertexCount);
+
+	unsigned int meshletCount = 0;
+	_meshletVertexCount = 0;
+
+	Meshlet current;
+	memset(&current, 0, sizeof(current));
+
+	for (unsigned int i = 0; i < _indexCount; i += 3)
+	{
+		const unsigned int* triangle = &_indices[i];
+
+		unsigned int newVertices = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			bool repeated = (corner > 0 && triangle[corner] == triangle[0]) || (corner > 1 && triangle[corner] == triangle[1]);
+			newVertices += localIndices[triangle[corner]] == NO_VERTEX && !repeated ? 1 : 0;
+		}
+
+		if (current.vertexCount + newVertices > MESHLET_MAX_VERTICES || current.triangleCount == MESHLET_MAX_TRIANGLES)
+		{
+			for (unsigned int j = 0; j < current.vertexCount; j++)
+			{
+				localIndices[_meshletVertices[current.vertexOffset + j]] = NO_VERTEX;
+			}
+
+			_meshlets[meshletCount++] = current;
+			memset(&current, 0, sizeof(current));
+			current.vertexOffset = _meshletVertexCount;
+			current.triangleOffset = i / 3;
+		}
+
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned int& local = localIndices[triangle[corner]];
+			if (local == NO_VERTEX)
+			{
+				local = current.vertexCount++;
+				_meshletVertices[_meshletVertexCount++] = triangle[corner];
+			}
+			_meshletTriangles[i + corner] = static_cast<unsigned char>(local);
+		}
+		current.triangleCount++;
+	}
+
+	if (current.triangleCount > 0)
+	{
+		_meshlets[meshletCount++] = current;
+	}
+
+	delete[] localIndices;
+
+	return meshletCount;
+}
+
+/*
+	Sphere around the center of the meshlet's box, good enough for culling and cheap to get
+*/
+void MeshCookerClass::ComputeMeshletBounds(Meshlet& _meshlet, const unsigned int* _meshletVertices, const float* _positions)
+{
+	float minimum[3] = { INFINITY, INFINITY, INFINITY };
+	float maximum[3] = { -INFINITY, -INFINITY, -INFINITY };
+
+	for (unsigned int i = 0; i < _meshlet.vertexCount; i++)
+	{
+		const float* position = &_positions[static_cast<size_t>(_meshletVertices[_meshlet.vertexOffset + i]) * 3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			minimum[axis] = position[axis] < minimum[axis] ? position[axis] : minimum[axis];
+			maximum[axis] = position[axis] > maximum[axis] ? position[axis] : maximum[axis];
+		}
+	}
+
+	float radiusSquared = 0.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		_meshlet.center[axis] = (minimum[axis] + maximum[axis]) * 0.5f;
+	}
+
+	for (unsigned int i = 0; i < _meshlet.vertexCount; i++)
+	{
+		const float* position = &_positions[static_cast<size_t>(_meshletVertices[_meshlet.vertexOffset + i]) * 3];
+		float dx = position[0] - _meshlet.center[0];
+		float dy = position[1] - _meshlet.center[1];
+		float dz = position[2] - _meshlet.center[2];
+		float distanceSquared = dx * dx + dy * dy + dz * dz;
+		radiusSquared = distanceSquared > radiusSquared ? distanceSquared : radiusSquared;
+	}
+
+	_meshlet.radius = sqrtf(radiusSquared);
+}
+
+/*
+	Quantize one vertex into the MeshVertex layout, see MeshAssetClass for the decoding
+*/
+void MeshCookerClass::EncodeVertex(const float* _position, const float* _normal, const float* _texcoord, const float* _boundsMinimum, const float* _boundsMaximum, MeshVertex& _vertex)
+{
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = _boundsMaximum[axis] - _boundsMinimum[axis];
+		float fraction = extent > 0.0f ? (_position[axis] - _boundsMinimum[axis]) / extent : 0.0f;
+		fraction = fraction < 0.0f ? 0.0f : (fraction > 1.0f ? 1.0f : fraction);
+		_vertex.position[axis] = static_cast<unsigned short>(fraction * 65535.0f + 0.5f);
+	}
+	_vertex.position[3] = 0;
+
+	//	Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the diagonals
+	float length = fabsf(_normal[0]) + fabsf(_normal[1]) + fabsf(_normal[2]);
+	float x = length > 0.0f ? _normal[0] / length : 0.0f;
+	float y = length > 0.0f ? _normal[1] / length : 0.0f;
+	float z = length > 0.0f ? _normal[2] / length : 1.0f;
+
+	if (z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	_vertex.normal[0] = static_cast<short>(roundf(x * 32767.0f));
+	_vertex.normal[1] = static_cast<short>(roundf(y * 32767.0f));
+
+	_vertex.texcoord[0] = MeshAssetClass::FloatToHalf(_texcoord ? _texcoord[0] : 0.0f);
+	_vertex.texcoord[1] = MeshAssetClass::FloatToHalf(_texcoord ? _texcoord[1] : 0.0f);
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MeshAssetClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int VERTEX_CACHE_SIZE = 32;			// post-transform cache modelled by the optimisation
+const float MESH_LOD_REDUCTION = 0.5f;				// every level of detail aims for this fraction of the triangles of the level before
+const float MESH_LOD_MIN_REDUCTION = 0.8f;			// a level which keeps more than this fraction is not worth it and ends the chain
+const unsigned int MESH_LOD_MIN_TRIANGLES = 64;		// no further level below a level with fewer triangles
+#pragma endregion
+
+/*
+	A triangle list as the readers produce it, one attribute set per vertex
+	normals and texcoords are nullptr if the source has none
+	The arrays are owned by the mesh, Release deletes them
+*/
+struct SourceMesh
+{
+	float* positions;			// 3 per vertex
+	float* normals;				// 3 per vertex
+	float* texcoords;			// 2 per vertex, origin at the top left
+	unsigned int vertexCount;
+	unsigned int* indices;
+	unsigned int indexCount;
+};
+
+/*
+	Turns a SourceMesh into a mesh asset (MeshAssetHeader):
+	missing normals are generated, levels of detail are simplified from the full mesh (MeshSimplifierClass),
+	the triangles of every level are reordered for the post-transform vertex cache (Forsyth),
+	vertices are reordered by first use in the full mesh (then in the simplified levels), quantized to 16 bytes and grouped into meshlets
+	Everything is deterministic, the same mesh always gives the same bytes
+*/
+class MeshCookerClass
+{
+public:
+	static void Release(SourceMesh& _mesh);
+
+	static bool Cook(const SourceMesh& _mesh, unsigned char*& _asset, size_t& _assetSize);
+
+	static void OptimizeVertexCache(unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount);
+	static float ComputeAcmr(const unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount, unsigned int _cacheSize);
+
+private:
+	static void GenerateNormals(const SourceMesh& _mesh, float* _normals);
+	static unsigned int BuildLods(const SourceMesh& _mesh, unsigned int** _lodIndices, unsigned int* _lodIndexCounts, float* _lodErrors);
+	static unsigned int BuildMeshlets(const unsigned int* _indices, unsigned int _indexCount, unsigned int _vertexCount,
+		Meshlet* _meshlets, unsigned int* _meshletVertices, unsigned char* _meshletTriangles, unsigned int& _meshletVertexCount);
+	static void ComputeMeshletBounds(Meshlet& _meshlet, const unsigned int* _meshletVertices, const float* _positions);
+	static void EncodeVertex(const float* _position, const float* _normal, const float* _texcoord, const float* _boundsMinimum, const float* _boundsMaximum, MeshVertex& _vertex);
+};
\ No newline at end of file
@@ -0,0 +1,449 @@
+#include "MeshSimplifierClass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+/*
+	An edge of the welded mesh, key is the lower vertex in the upper 32 bits and the higher one in the lower 32 bits
+	corner: index of the first vertex of the edge in the triangle list
+*/
+struct SimplifierEdge
+{
+	unsigned long long key;
+	unsigned int corner;
+};
+
+/*
+	Moving from onto to costs error
+*/
+struct SimplifierCollapse
+{
+	float error;
+	unsigned int from;
+	unsigned int to;
+};
+
+static unsigned long long MakeEdgeKey(unsigned int _a, unsigned int _b)
+{
+	return _a < _b ? (static_cast<unsigned long long>(_a) << 32) | _b : (static_cast<unsigned long long>(_b) << 32) | _a;
+}
+
+/*
+	Weld the vertices, put the planes of the triangles and of the open edges into the quadrics of their vertices
+	Then collapse in passes until the target is reached, no collapse is left below _maxError or none can be taken
+	Every collapse removes about two triangles, a pass takes at most as many as are still needed
+	_result has to hold _indexCount indices, returns how many were written and the largest error of a collapse in _error
+*/
+unsigned int MeshSimplifierClass::Simplify(const float* _positions, unsigned int _vertexCount, const unsigned int* _indices, unsigned int _indexCount,
+	unsigned int _targetIndexCount, float _maxError, unsigned int* _result, float& _error)
+{
+	_error = 0.0f;
+
+	if (_indexCount <= _targetIndexCount || _vertexCount == 0)
+	{
+		memcpy(_result, _indices, sizeof(unsigned int) * _indexCount);
+		return _indexCount;
+	}
+
+	unsigned int* welded = new unsigned int[_vertexCount];
+	unsigned char* locked = new unsigned char[_vertexCount];
+	Quadric* quadrics = new Quadric[_vertexCount];
+	unsigned int* remap = new unsigned int[_vertexCount];
+	unsigned char* touched = new unsigned char[_vertexCount];
+	unsigned int* adjacencyOffsets = new unsigned int[_vertexCount + 1];
+	unsigned int* adjacency = new unsigned int[_indexCount];
+	unsigned int* triangles = new unsigned int[_indexCount];
+	SimplifierEdge* edges = new SimplifierEdge[_indexCount];
+	SimplifierCollapse* collapses = new SimplifierCollapse[_indexCount];
+
+	Weld(_positions, _vertexCount, welded, locked);
+	memset(quadrics, 0, sizeof(Quadric) * _vertexCount);
+
+	//	Triangles which are degenerate after welding are dropped right away
+	unsigned int indexCount = 0;
+	for (unsigned int i = 0; i + 2 < _indexCount; i += 3)
+	{
+		const unsigned int* triangle = &_indices[i];
+		unsigned int corners[3] = { welded[triangle[0]], welded[triangle[1]], welded[triangle[2]] };
+		if (corners[0] == corners[1] || corners[1] == corners[2] || corners[2] == corners[0])
+		{
+			continue;
+		}
+
+		double normal[3];
+		GetNormal(&_positions[static_cast<size_t>(corners[0]) * 3], &_positions[static_cast<size_t>(corners[1]) * 3], &_positions[static_cast<size_t>(corners[2]) * 3], normal);
+		double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (length > 0.0)
+		{
+			const float* position = &_positions[static_cast<size_t>(corners[0]) * 3];
+			double unit[3] = { normal[0] / length, normal[1] / length, normal[2] / length };
+			double distance = -(unit[0] * position[0] + unit[1] * position[1] + unit[2] * position[2]);
+
+			for (int corner = 0; corner < 3; corner++)
+			{
+				AddPlane(quadrics[corners[corner]], unit, distance, length * 0.5);
+			}
+		}
+
+		memcpy(&triangles[indexCount], triangle, sizeof(unsigned int) * 3);
+		indexCount += 3;
+	}
+
+	//	An edge only one triangle uses is open, a plane through it standing upright on the triangle keeps it from moving inwards
+	for (unsigned int i = 0; i < indexCount; i++)
+	{
+		unsigned int next = i - i % 3 + (i + 1) % 3;
+		edges[i].key = MakeEdgeKey(welded[triangles[i]], welded[triangles[next]]);
+		edges[i].corner = i;
+	}
+	std::sort(edges, edges + indexCount, [](const SimplifierEdge& _a, const SimplifierEdge& _b) { return _a.key < _b.key || (_a.key == _b.key && _a.corner < _b.corner); });
+
+	for (unsigned int i = 0; i < indexCount; )
+	{
+		unsigned int end = i + 1;
+		while (end < indexCount && edges[end].key == edges[i].key)
+		{
+			end++;
+		}
+
+		if (end - i == 1)
+		{
+			unsigned int corner = edges[i].corner;
+			unsigned int first = corner - corner % 3;
+			unsigned int from = welded[triangles[corner]];
+			unsigned int to = welded[triangles[first + (corner + 1) % 3]];
+			unsigned int opposite = welded[triangles[first + (corner + 2) % 3]];
+			const float* fromPosition = &_positions[static_cast<size_t>(from) * 3];
+			const float* toPosition = &_positions[static_cast<size_t>(to) * 3];
+
+			double faceNormal[3];
+			GetNormal(fromPosition, toPosition, &_positions[static_cast<size_t>(opposite) * 3], faceNormal);
+			double edge[3] = { toPosition[0] - fromPosition[0], toPosition[1] - fromPosition[1], toPosition[2] - fromPosition[2] };
+			double normal[3] = { edge[1] * faceNormal[2] - edge[2] * faceNormal[1], edge[2] * faceNormal[0] - edge[0] * faceNormal[2], edge[0] * faceNormal[1] - edge[1] * faceNormal[0] };
+			double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length > 0.0)
+			{
+				double unit[3] = { normal[0] / length, normal[1] / length, normal[2] / length };
+				double distance = -(unit[0] * fromPosition[0] + unit[1] * fromPosition[1] + unit[2] * fromPosition[2]);
+				double weight = (edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2]) * SIMPLIFY_BORDER_WEIGHT;
+
+				AddPlane(quadrics[from], unit, distance, weight);
+				AddPlane(quadrics[to], unit, distance, weight);
+			}
+		}
+
+		i = end;
+	}
+
+	for (unsigned int i = 0; i < _vertexCount; i++)
+	{
+		remap[i] = i;
+	}
+
+	while (indexCount > _targetIndexCount)
+	{
+		//	Triangles around every welded vertex
+		memset(adjacencyOffsets, 0, sizeof(unsigned int) * (_vertexCount + 1));
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			adjacencyOffsets[welded[triangles[i]] + 1]++;
+		}
+		for (unsigned int i = 0; i < _vertexCount; i++)
+		{
+			adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+		}
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			adjacency[adjacencyOffsets[welded[triangles[i]]]++] = i / 3;
+		}
+		for (unsigned int i = _vertexCount; i > 0; i--)
+		{
+			adjacencyOffsets[i] = adjacencyOffsets[i - 1];
+		}
+		adjacencyOffsets[0] = 0;
+
+		//	Every edge once, moving the end which costs less, seam vertices stay
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			unsigned int next = i - i % 3 + (i + 1) % 3;
+			edges[i].key = MakeEdgeKey(welded[triangles[i]], welded[triangles[next]]);
+			edges[i].corner = i;
+		}
+		std::sort(edges, edges + indexCount, [](const SimplifierEdge& _a, const SimplifierEdge& _b) { return _a.key < _b.key; });
+
+		unsigned int collapseCount = 0;
+		for (unsigned int i = 0; i < indexCount; i++)
+		{
+			if (i > 0 && edges[i].key == edges[i - 1].key)
+			{
+				continue;
+			}
+
+			unsigned int a = static_cast<unsigned int>(edges[i].key >> 32);
+			unsigned int b = static_cast<unsigned int>(edges[i].key & 0xFFFFFFFF);
+			if (locked[a] && locked[b])
+			{
+				continue;
+			}
+
+			double errorAB = locked[a] ? HUGE_VAL : GetError(quadrics[a], quadrics[b], &_positions[static_cast<size_t>(b) * 3]);
+			double errorBA = locked[b] ? HUGE_VAL : GetError(quadrics[a], quadrics[b], &_positions[static_cast<size_t>(a) * 3]);
+
+			SimplifierCollapse& collapse = collapses[collapseCount];
+			collapse.error = static_cast<float>(sqrt(errorAB <= errorBA ? errorAB : errorBA));
+			collapse.from = errorAB <= errorBA ? a : b;
+			collapse.to = errorAB <= errorBA ? b : a;
+			if (collapse.error <= _maxError)
+			{
+				collapseCount++;
+			}
+		}
+
+		std::sort(collapses, collapses + collapseCount, [](const SimplifierCollapse& _a, const SimplifierCollapse& _b)
+		{
+			return _a.error < _b.error || (_a.error == _b.error && (_a.from < _b.from || (_a.from == _b.from && _a.to < _b.to)));
+		});
+
+		//	A collapse changes the triangles around from, so nothing else in that neighbourhood moves during this pass
+		unsigned int wanted = (indexCount - _targetIndexCount) / 6 + 1;
+		unsigned int collapsed = 0;
+		memset(touched, 0, _vertexCount);
+		for (unsigned int i = 0; i < collapseCount && collapsed < wanted; i++)
+		{
+			const SimplifierCollapse& collapse = collapses[i];
+			if (touched[collapse.from] || touched[collapse.to])
+			{
+				continue;
+			}
+
+			const unsigned int* around = &adjacency[adjacencyOffsets[collapse.from]];
+			unsigned int aroundCount = adjacencyOffsets[collapse.from + 1] - adjacencyOffsets[collapse.from];
+			if (!KeepsOrientation(_positions, welded, triangles, around, aroundCount, collapse.from, collapse.to))
+			{
+				continue;
+			}
+
+			//	Unlocked vertices are the only vertex at their position, so the welded index is the vertex itself
+			remap[collapse.from] = collapse.to;
+			AddQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+
+			for (unsigned int j = 0; j < aroundCount; j++)
+			{
+				const unsigned int* triangle = &triangles[around[j] * 3];
+				touched[welded[triangle[0]]] = 1;
+				touched[welded[triangle[1]]] = 1;
+				touched[welded[triangle[2]]] = 1;
+			}
+			touched[collapse.to] = 1;
+
+			_error = collapse.error > _error ? collapse.error : _error;
+			collapsed++;
+		}
+
+		if (collapsed == 0)
+		{
+			break;
+		}
+
+		unsigned int keptCount = 0;
+		for (unsigned int i = 0; i < indexCount; i += 3)
+		{
+			unsigned int triangle[3] = { remap[triangles[i]], remap[triangles[i + 1]], remap[triangles[i + 2]] };
+			if (welded[triangle[0]] == welded[triangle[1]] || welded[triangle[1]] == welded[triangle[2]] || welded[triangle[2]] == welded[triangle[0]])
+			{
+				continue;
+			}
+
+			memcpy(&triangles[keptCount], triangle, sizeof(triangle));
+			keptCount += 3;
+		}
+		indexCount = keptCount;
+	}
+
+	memcpy(_result, triangles, sizeof(unsigned int) * indexCount);
+
+	delete[] collapses;
+	delete[] edges;
+	delete[] triangles;
+	delete[] adjacency;
+	delete[] adjacencyOffsets;
+	delete[] touched;
+	delete[] remap;
+	delete[] quadrics;
+	delete[] locked;
+	delete[] welded;
+
+	return indexCount;
+}
+
+/*
+	Sort the vertices by position, every run of equal positions becomes its lowest vertex
+	Runs of more than one vertex are attribute seams and get locked
+*/
+void MeshSimplifierClass::Weld(const float* _positions, unsigned int _vertexCount, unsigned int* _welded, unsigned char* _locked)
+{
+	unsigned int* order = new unsigned int[_vertexCount];
+	for (unsigned int i = 0; i < _vertexCount; i++)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order, order + _vertexCount, [_positions](unsigned int _a, unsigned int _b)
+	{
+		const float* a = &_positions[static_cast<size_t>(_a) * 3];
+		const float* b = &_positions[static_cast<size_t>(_b) * 3];
+		if (a[0] != b[0])
+		{
+			return a[0] < b[0];
+		}
+		if (a[1] != b[1])
+		{
+			return a[1] < b[1];
+		}
+		if (a[2] != b[2])
+		{
+			return a[2] < b[2];
+		}
+		return _a < _b;
+	});
+
+	for (unsigned int i = 0; i < _vertexCount; )
+	{
+		const float* position = &_positions[static_cast<size_t>(order[i]) * 3];
+		unsigned int end = i + 1;
+		while (end < _vertexCount && memcmp(position, &_positions[static_cast<size_t>(order[end]) * 3], sizeof(float) * 3) == 0)
+		{
+			end++;
+		}
+
+		for (unsigned int j = i; j < end; j++)
+		{
+			_welded[order[j]] = order[i];
+			_locked[order[j]] = end - i > 1 ? 1 : 0;
+		}
+
+		i = end;
+	}
+
+	delete[] order;
+}
+
+/*
+	Squared distance to the plane n.p + d = 0, weighted
+*/
+void MeshSimplifierClass::AddPlane(Quadric& _quadric, const double* _normal, double _distance, double _weight)
+{
+	_quadric.a00 += _weight * _normal[0] * _normal[0];
+	_quadric.a01 += _weight * _normal[0] * _normal[1];
+	_quadric.a02 += _weight * _normal[0] * _normal[2];
+	_quadric.a11 += _weight * _normal[1] * _normal[1];
+	_quadric.a12 += _weight * _normal[1] * _normal[2];
+	_quadric.a22 += _weight * _normal[2] * _normal[2];
+	_quadric.b0 += _weight * _normal[0] * _distance;
+	_quadric.b1 += _weight * _normal[1] * _distance;
+	_quadric.b2 += _weight * _normal[2] * _distance;
+	_quadric.c += _weight * _distance * _distance;
+	_quadric.weight += _weight;
+}
+
+void MeshSimplifierClass::AddQuadric(Quadric& _target, const Quadric& _quadric)
+{
+	_target.a00 += _quadric.a00;
+	_target.a01 += _quadric.a01;
+	_target.a02 += _quadric.a02;
+	_target.a11 += _quadric.a11;
+	_target.a12 += _quadric.a12;
+	_target.a22 += _quadric.a22;
+	_target.b0 += _quadric.b0;
+	_target.b1 += _quadric.b1;
+	_target.b2 += _quadric.b2;
+	_target.c += _quadric.c;
+	_target.weight += _quadric.weight;
+}
+
+/*
+	Mean squared distance of the position to the planes of both quadrics
+*/
+double MeshSimplifierClass::GetError(const Quadric& _a, const Quadric& _b, const float* _position)
+{
+	double weight = _a.weight + _b.weight;
+	if (weight <= 0.0)
+	{
+		return 0.0;
+	}
+
+	double x = _position[0];
+	double y = _position[1];
+	double z = _position[2];
+	double error = 0.0;
+	const Quadric* quadrics[2] = { &_a, &_b };
+
+	for (int i = 0; i < 2; i++)
+	{
+		const Quadric& q = *quadrics[i];
+		error += q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+			2.0 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+	}
+
+	//	Rounding may leave a tiny negative rest
+	return error > 0.0 ? error / weight : 0.0;
+}
+
+/*
+	Cross product of the edges, twice the area long
+*/
+void MeshSimplifierClass::GetNormal(const float* _a, const float* _b, const float* _c, double* _normal)
+{
+	double ab[3] = { static_cast<double>(_b[0]) - _a[0], static_cast<double>(_b[1]) - _a[1], static_cast<double>(_b[2]) - _a[2] };
+	double ac[3] = { static_cast<double>(_c[0]) - _a[0], static_cast<double>(_c[1]) - _a[1], static_cast<double>(_c[2]) - _a[2] };
+
+	_normal[0] = ab[1] * ac[2] - ab[2] * ac[1];
+	_normal[1] = ab[2] * ac[0] - ab[0] * ac[2];
+	_normal[2] = ab[0] * ac[1] - ab[1] * ac[0];
+}
+
+/*
+	Every triangle around from which stays has to keep facing about the same way once from sits on to
+	Triangles which also hold to disappear with the collapse
+*/
+bool MeshSimplifierClass::KeepsOrientation(const float* _positions, const unsigned int* _welded, const unsigned int* _triangles,
+	const unsigned int* _adjacency, unsigned int _adjacencyCount, unsigned int _from, unsigned int _to)
+{
+	for (unsigned int i = 0; i < _adjacencyCount; i++)
+	{
+		const unsigned int* triangle = &_triangles[_adjacency[i] * 3];
+		unsigned int corners[3] = { _welded[triangle[0]], _welded[triangle[1]], _welded[triangle[2]] };
+		if (corners[0] == _to || corners[1] == _to || corners[2] == _to)
+		{
+			continue;
+		}
+
+		const float* before[3];
+		const float* after[3];
+		for (int corner = 0; corner < 3; corner++)
+		{
+			before[corner] = &_positions[static_cast<size_t>(corners[corner]) * 3];
+			after[corner] = corners[corner] == _from ? &_positions[static_cast<size_t>(_to) * 3] : before[corner];
+		}
+
+		double normalBefore[3];
+		double normalAfter[3];
+		GetNormal(before[0], before[1], before[2], normalBefore);
+		GetNormal(after[0], after[1], after[2], normalAfter);
+
+		double lengthBefore = sqrt(normalBefore[0] * normalBefore[0] + normalBefore[1] * normalBefore[1] + normalBefore[2] * normalBefore[2]);
+		double lengthAfter = sqrt(normalAfter[0] * normalAfter[0] + normalAfter[1] * normalAfter[1] + normalAfter[2] * normalAfter[2]);
+		if (lengthBefore <= 0.0)
+		{
+			continue;
+		}
+
+		double dot = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] + normalBefore[2] * normalAfter[2];
+		if (dot <= SIMPLIFY_MIN_ORIENTATION * lengthBefore * lengthAfter || lengthAfter <= 0.0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+#pragma region global variables
+const double SIMPLIFY_BORDER_WEIGHT = 10.0;		// planes through the open edges of the mesh count this much more than the surface, so outlines stay in place
+const double SIMPLIFY_MIN_ORIENTATION = 0.25;	// a collapse may turn no triangle further than acos of this (about 75 degrees)
+#pragma endregion
+
+/*
+	Reduces triangle lists with edge collapses ordered by quadric error metrics (Garland and Heckbert)
+	Every vertex keeps the planes of its triangles as a quadric, the cost of moving a vertex onto a neighbour is the summed
+	squared distance to those planes, divided by their area, so the error is a distance in the units of the mesh
+	Vertices only move onto their neighbours, the result uses a subset of the input vertices and keeps their attributes
+
+	Vertices at the same position are welded, so attribute seams are no open edges, the seam vertices themselves never move
+	The collapses run in passes: all edges are sorted by cost, the cheapest collapses whose neighbourhoods do not touch are taken,
+	collapses which would flip a triangle are skipped
+	Everything is deterministic, the same mesh always gives the same triangles
+*/
+class MeshSimplifierClass
+{
+public:
+	static unsigned int Simplify(const float* _positions, unsigned int _vertexCount, const unsigned int* _indices, unsigned int _indexCount,
+		unsigned int _targetIndexCount, float _maxError, unsigned int* _result, float& _error);
+
+private:
+	//	p^T A p + 2 b^T p + c, weight is the area of the planes summed into it
+	struct Quadric
+	{
+		double a00, a01, a02, a11, a12, a22;
+		double b0, b1, b2;
+		double c;
+		double weight;
+	};
+
+	static void Weld(const float* _positions, unsigned int _vertexCount, unsigned int* _welded, unsigned char* _locked);
+	static void AddPlane(Quadric& _quadric, const double* _normal, double _distance, double _weight);
+	static void AddQuadric(Quadric& _target, const Quadric& _quadric);
+	static double GetError(const Quadric& _a, const Quadric& _b, const float* _position);
+	static void GetNormal(const float* _a, const float* _b, const float* _c, double* _normal);
+	static bool KeepsOrientation(const float* _positions, const unsigned int* _welded, const unsigned int* _triangles,
+		const unsigned int* _adjacency, unsigned int _adjacencyCount, unsigned int _from, unsigned int _to);
+};
\ No newline at end of file
@@ -0,0 +1,298 @@
+#include "ObjReaderClass.h"
+#include <cstdlib>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int NO_VERTEX = 0xFFFFFFFF;
+#pragma endregion
+
+static void SkipBlanks(const char*& _cursor)
+{
+	while (*_cursor == ' ' || *_cursor == '\t')
+	{
+		_cursor++;
+	}
+}
+
+static bool AtLineEnd(const char* _cursor)
+{
+	return *_cursor == 0 || *_cursor == '\n' || *_cursor == '\r' || *_cursor == '#';
+}
+
+static bool ParseFloats(const char*& _cursor, float* _values, int _count)
+{
+	for (int i = 0; i < _count; i++)
+	{
+		SkipBlanks(_cursor);
+		if (AtLineEnd(_cursor))
+		{
+			return false;
+		}
+
+		char* end;
+		_values[i] = strtof(_cursor, &end);
+		if (end == _cursor)
+		{
+			return false;
+		}
+		_cursor = end;
+	}
+
+	return true;
+}
+
+static unsigned int HashCorner(const int* _corner)
+{
+	unsigned int hash = static_cast<unsigned int>(_corner[0]) * 0x9E3779B1u;
+	hash ^= static_cast<unsigned int>(_corner[1]) * 0x85EBCA77u + (hash >> 15);
+	hash ^= static_cast<unsigned int>(_corner[2]) * 0xC2B2AE3Du + (hash >> 13);
+
+	return hash ^ (hash >> 16);
+}
+
+/*
+	Two passes over the text: the first counts, the second fills the arrays
+	Then the corners (position, texcoord, normal triples) are merged into vertices with an open addressing table
+*/
+bool ObjReaderClass::Read(const char* _text, size_t _size, SourceMesh& _mesh)
+{
+	memset(&_mesh, 0, sizeof(_mesh));
+
+	const char* end = _text + _size;
+	float* attributes[3] = {};
+	int* corners = nullptr;
+	unsigned int totals[3] = {};
+	unsigned int totalCorners = 0;
+	const int components[3] = { 3, 2, 3 };
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		unsigned int counts[3] = {};
+		unsigned int cornerCount = 0;
+		const char* cursor = _text;
+
+		while (cursor < end)
+		{
+			SkipBlanks(cursor);
+
+			int attribute = -1;
+			if (cursor[0] == 'v' && (cursor[1] == ' ' || cursor[1] == '\t'))
+			{
+				attribute = 0;
+				cursor += 1;
+			}
+			else if (cursor[0] == 'v' && cursor[1] == 't' && (cursor[2] == ' ' || cursor[2] == '\t'))
+			{
+				attribute = 1;
+				cursor += 2;
+			}
+			else if (cursor[0] == 'v' && cursor[1] == 'n' && (cursor[2] == ' ' || cursor[2] == '\t'))
+			{
+				attribute = 2;
+				cursor += 2;
+			}
+
+			if (attribute >= 0)
+			{
+				float values[3];
+				if (!ParseFloats(cursor, values, components[attribute]))
+				{
+					delete[] attributes[0];
+					delete[] attributes[1];
+					delete[] attributes[2];
+					delete[] corners;
+					return false;
+				}
+
+				if (pass == 1)
+				{
+					//	OBJ texcoords start at the bottom left
+					if (attribute == 1)
+					{
+						values[1] = 1.0f - values[1];
+					}
+					memcpy(&attributes[attribute][static_cast<size_t>(counts[attribute]) * components[attribute]], values, sizeof(float) * components[attribute]);
+				}
+				counts[attribute]++;
+			}
+			else if (cursor[0] == 'f' && (cursor[1] == ' ' || cursor[1] == '\t'))
+			{
+				cursor++;
+
+				//	Fan around the first corner
+				int first[3];
+				int previous[3];
+				int current[3];
+				unsigned int polygonCorners = 0;
+
+				SkipBlanks(cursor);
+				while (!AtLineEnd(cursor))
+				{
+					if (!ParseCorner(cursor, counts, current))
+					{
+						delete[] attributes[0];
+						delete[] attributes[1];
+						delete[] attributes[2];
+						delete[] corners;
+						return false;
+					}
+
+					if (polygonCorners == 0)
+					{
+						memcpy(first, current, sizeof(first));
+					}
+					else if (polygonCorners >= 2)
+					{
+						if (pass == 1)
+						{
+							int* triangle = &corners[static_cast<size_t>(cornerCount) * 3];
+							memcpy(triangle, first, sizeof(first));
+							memcpy(triangle + 3, previous, sizeof(previous));
+							memcpy(triangle + 6, current, sizeof(current));
+						}
+						cornerCount += 3;
+					}
+
+					memcpy(previous, current, sizeof(previous));
+					polygonCorners++;
+					SkipBlanks(cursor);
+				}
+			}
+
+			while (cursor < end && *cursor != '\n')
+			{
+				cursor++;
+			}
+			cursor++;
+		}
+
+		if (pass == 0)
+		{
+			if (counts[0] == 0 || cornerCount == 0)
+			{
+				return false;
+			}
+
+			memcpy(totals, counts, sizeof(totals));
+			totalCorners = cornerCount;
+			for (int i = 0; i < 3; i++)
+			{
+				attributes[i] = totals[i] > 0 ? new float[static_cast<size_t>(totals[i]) * components[i]] : nullptr;
+			}
+			corners = new int[static_cast<size_t>(totalCorners) * 3];
+		}
+	}
+
+	//	Merge equal corners, the table is at most half full
+	unsigned int tableSize = 1;
+	while (tableSize < totalCorners * 2)
+	{
+		tableSize <<= 1;
+	}
+
+	unsigned int* table = new unsigned int[tableSize];
+	unsigned int* vertexCorners = new unsigned int[totalCorners];
+	unsigned int* indices = new unsigned int[totalCorners];
+	unsigned int vertexCount = 0;
+	bool allNormals = totals[2] > 0;
+	memset(table, 0xFF, sizeof(unsigned int) * tableSize);
+
+	for (unsigned int i = 0; i < totalCorners; i++)
+	{
+		const int* corner = &corners[static_cast<size_t>(i) * 3];
+		allNormals = allNormals && corner[2] >= 0;
+
+		unsigned int slot = HashCorner(corner) & (tableSize - 1);
+		while (table[slot] != NO_VERTEX && memcmp(&corners[static_cast<size_t>(vertexCorners[table[slot]]) * 3], corner, sizeof(int) * 3) != 0)
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (table[slot] == NO_VERTEX)
+		{
+			table[slot] = vertexCount;
+			vertexCorners[vertexCount++] = i;
+		}
+		indices[i] = table[slot];
+	}
+
+	_mesh.vertexCount = vertexCount;
+	_mesh.indexCount = totalCorners;
+	_mesh.indices = indices;
+	_mesh.positions = new float[static_cast<size_t>(vertexCount) * 3];
+	_mesh.texcoords = totals[1] > 0 ? new float[static_cast<size_t>(vertexCount) * 2] : nullptr;
+	_mesh.normals = allNormals ? new float[static_cast<size_t>(vertexCount) * 3] : nullptr;
+
+	for (unsigned int i = 0; i < vertexCount; i++)
+	{
+		const int* corner = &corners[static_cast<size_t>(vertexCorners[i]) * 3];
+		memcpy(&_mesh.positions[static_cast<size_t>(i) * 3], &attributes[0][static_cast<size_t>(corner[0]) * 3], sizeof(float) * 3);
+
+		if (_mesh.texcoords)
+		{
+			float* texcoord = &_mesh.texcoords[static_cast<size_t>(i) * 2];
+			texcoord[0] = corner[1] >= 0 ? attributes[1][static_cast<size_t>(corner[1]) * 2] : 0.0f;
+			texcoord[1] = corner[1] >= 0 ? attributes[1][static_cast<size_t>(corner[1]) * 2 + 1] : 0.0f;
+		}
+
+		if (_mesh.normals)
+		{
+			memcpy(&_mesh.normals[static_cast<size_t>(i) * 3], &attributes[2][static_cast<size_t>(corner[2]) * 3], sizeof(float) * 3);
+		}
+	}
+
+	delete[] vertexCorners;
+	delete[] table;
+	delete[] corners;
+	delete[] attributes[0];
+	delete[] attributes[1];
+	delete[] attributes[2];
+
+	return true;
+}
+
+/*
+	One face corner: v, v/vt, v//vn or v/vt/vn, 1-based or negative (relative to the end so far)
+	Missing parts are -1, indices are checked against the attributes read up to this line
+*/
+bool ObjReaderClass::ParseCorner(const char*& _cursor, const unsigned int* _counts, int* _corner)
+{
+	_corner[0] = -1;
+	_corner[1] = -1;
+	_corner[2] = -1;
+
+	for (int part = 0; part < 3; part++)
+	{
+		if (part > 0)
+		{
+			if (*_cursor != '/')
+			{
+				break;
+			}
+			_cursor++;
+		}
+
+		//	Empty texcoord part in v//vn
+		if (*_cursor == '/' || (part > 0 && (*_cursor == ' ' || *_cursor == '\t' || AtLineEnd(_cursor))))
+		{
+			continue;
+		}
+
+		char* end;
+		long value = strtol(_cursor, &end, 10);
+		if (end == _cursor)
+		{
+			return false;
+		}
+		_cursor = end;
+
+		long index = value < 0 ? static_cast<long>(_counts[part]) + value : value - 1;
+		if (value == 0 || index < 0 || index >= static_cast<long>(_counts[part]))
+		{
+			return false;
+		}
+		_corner[part] = static_cast<int>(index);
+	}
+
+	return *_cursor == ' ' || *_cursor == '\t' || AtLineEnd(_cursor);
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MeshCookerClass.h"
+#pragma endregion
+
+/*
+	Wavefront OBJ: v, vt, vn and f lines, everything else (groups, materials, smoothing) is ignored
+	Polygons are split into fans, corners with the same v/vt/vn triple become one vertex
+	_text has to be terminated by a 0 behind _size
+*/
+class ObjReaderClass
+{
+public:
+	static bool Read(const char* _text, size_t _size, SourceMesh& _mesh);
+
+private:
+	static bool ParseCorner(const char*& _cursor, const unsigned int* _counts, int* _corner);
+};
\ No newline at end of file
@@ -0,0 +1,627 @@
+#include "PngReaderClass.h"
+#include <cstring>
+
+#pragma region Globals
+static const unsigned char PNG_SIGNATURE[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+static const unsigned int MAX_PNG_DIMENSION = 16384;
+static const int MAX_CODE_BITS = 15;
+static const int LITERAL_CODES = 288;
+static const int DISTANCE_CODES = 30;
+
+static const unsigned short LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const unsigned char LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const unsigned short DISTANCE_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static const unsigned char DISTANCE_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const unsigned char CODE_LENGTH_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+#pragma endregion
+
+/*
+	Canonical Huffman code: number of codes per length and the symbols ordered by code
+*/
+struct HuffmanTable
+{
+	short counts[MAX_CODE_BITS + 1];
+	short symbols[LITERAL_CODES];
+};
+
+struct InflateState
+{
+	const unsigned char* input;
+	size_t inputSize;
+	size_t inputPosition;
+	unsigned int bitBuffer;
+	int bitCount;
+	unsigned char* output;
+	size_t outputSize;
+	size_t outputPosition;
+	bool error;
+};
+
+static unsigned int ReadBits(InflateState& _state, int _count)
+{
+	while (_state.bitCount < _count)
+	{
+		if (_state.inputPosition == _state.inputSize)
+		{
+			_state.error = true;
+			return 0;
+		}
+		_state.bitBuffer |= static_cast<unsigned int>(_state.input[_state.inputPosition++]) << _state.bitCount;
+		_state.bitCount += 8;
+	}
+
+	unsigned int value = _state.bitBuffer & ((1u << _count) - 1);
+	_state.bitBuffer >>= _count;
+	_state.bitCount -= _count;
+
+	return value;
+}
+
+/*
+	False for over-subscribed codes, incomplete codes are allowed (deflate uses them for single distance codes)
+*/
+static bool BuildHuffmanTable(HuffmanTable& _table, const unsigned char* _lengths, int _count)
+{
+	memset(_table.counts, 0, sizeof(_table.counts));
+	for (int i = 0; i < _count; i++)
+	{
+		_table.counts[_lengths[i]]++;
+	}
+
+	int left = 1;
+	for (int length = 1; length <= MAX_CODE_BITS; length++)
+	{
+		left = (left << 1) - _table.counts[length];
+		if (left < 0)
+		{
+			return false;
+		}
+	}
+
+	short offsets[MAX_CODE_BITS + 1];
+	offsets[1] = 0;
+	for (int length = 1; length < MAX_CODE_BITS; length++)
+	{
+		offsets[length + 1] = static_cast<short>(offsets[length] + _table.counts[length]);
+	}
+
+	for (int i = 0; i < _count; i++)
+	{
+		if (_lengths[i] != 0)
+		{
+			_table.symbols[offsets[_lengths[i]]++] = static_cast<short>(i);
+		}
+	}
+
+	return true;
+}
+
+/*
+	One bit at a time, codes are compared against the first code of each length
+*/
+static int DecodeSymbol(InflateState& _state, const HuffmanTable& _table)
+{
+	int code = 0;
+	int first = 0;
+	int index = 0;
+
+	for (int length = 1; length <= MAX_CODE_BITS; length++)
+	{
+		code |= static_cast<int>(ReadBits(_state, 1));
+		int count = _table.counts[length];
+		if (code - count < first)
+		{
+			return _table.symbols[index + (code - first)];
+		}
+		index += count;
+		first = (first + count) << 1;
+		code <<= 1;
+	}
+
+	_state.error = true;
+	return -1;
+}
+
+/*
+	Codes of the fixed Huffman blocks, built once (thread-safe, the cooker decodes images on several threads)
+*/
+struct FixedHuffmanTables
+{
+	HuffmanTable literals;
+	HuffmanTable distances;
+
+	FixedHuffmanTables()
+	{
+		unsigned char lengths[LITERAL_CODES];
+		for (int i = 0; i < LITERAL_CODES; i++)
+		{
+			lengths[i] = static_cast<unsigned char>(i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8)));
+		}
+		BuildHuffmanTable(literals, lengths, LITERAL_CODES);
+
+		memset(lengths, 5, DISTANCE_CODES);
+		BuildHuffmanTable(distances, lengths, DISTANCE_CODES);
+	}
+};
+
+/*
+	Literals and length/distance pairs until the end of block symbol
+*/
+static bool InflateCodes(InflateState& _state, const HuffmanTable& _literals, const HuffmanTable& _distances)
+{
+	while (!_state.error)
+	{
+		int symbol = DecodeSymbol(_state, _literals);
+		if (symbol < 0)
+		{
+			return false;
+		}
+
+		if (symbol < 256)
+		{
+			if (_state.outputPosition == _state.outputSize)
+			{
+				return false;
+			}
+			_state.output[_state.outputPosition++] = static_cast<unsigned char>(symbol);
+			continue;
+		}
+
+		if (symbol == 256)
+		{
+			return true;
+		}
+
+		symbol -= 257;
+		if (symbol >= 29)
+		{
+			return false;
+		}
+		size_t length = LENGTH_BASE[symbol] + ReadBits(_state, LENGTH_EXTRA[symbol]);
+
+		int distanceSymbol = DecodeSymbol(_state, _distances);
+		if (distanceSymbol < 0 || distanceSymbol >= DISTANCE_CODES)
+		{
+			return false;
+		}
+		size_t distance = DISTANCE_BASE[distanceSymbol] + ReadBits(_state, DISTANCE_EXTRA[distanceSymbol]);
+
+		if (_state.error || distance > _state.outputPosition || length > _state.outputSize - _state.outputPosition)
+		{
+			return false;
+		}
+
+		//	Byte by byte, source and destination may overlap
+		unsigned char* destination = _state.output + _state.outputPosition;
+		const unsigned char* source = destination - distance;
+		for (size_t i = 0; i < length; i++)
+		{
+			destination[i] = source[i];
+		}
+		_state.outputPosition += length;
+	}
+
+	return false;
+}
+
+/*
+	Code lengths of a dynamic block, themselves Huffman coded with repeat codes 16 to 18
+*/
+static bool ReadDynamicTables(InflateState& _state, HuffmanTable& _literals, HuffmanTable& _distances)
+{
+	int literalCount = static_cast<int>(ReadBits(_state, 5)) + 257;
+	int distanceCount = static_cast<int>(ReadBits(_state, 5)) + 1;
+	int codeLengthCount = static_cast<int>(ReadBits(_state, 4)) + 4;
+	if (_state.error || literalCount > 286 || distanceCount > DISTANCE_CODES)
+	{
+		return false;
+	}
+
+	unsigned char lengths[LITERAL_CODES + DISTANCE_CODES];
+	memset(lengths, 0, sizeof(lengths));
+	for (int i = 0; i < codeLengthCount; i++)
+	{
+		lengths[CODE_LENGTH_ORDER[i]] = static_cast<unsigned char>(ReadBits(_state, 3));
+	}
+
+	HuffmanTable codeLengths;
+	if (!BuildHuffmanTable(codeLengths, lengths, 19))
+	{
+		return false;
+	}
+
+	int index = 0;
+	while (index < literalCount + distanceCount)
+	{
+		int symbol = DecodeSymbol(_state, codeLengths);
+		if (symbol < 0 || _state.error)
+		{
+			return false;
+		}
+
+		if (symbol < 16)
+		{
+			lengths[index++] = static_cast<unsigned char>(symbol);
+			continue;
+		}
+
+		unsigned char value = 0;
+		int repeat;
+		if (symbol == 16)
+		{
+			if (index == 0)
+			{
+				return false;
+			}
+			value = lengths[index - 1];
+			repeat = 3 + static_cast<int>(ReadBits(_state, 2));
+		}
+		else if (symbol == 17)
+		{
+			repeat = 3 + static_cast<int>(ReadBits(_state, 3));
+		}
+		else
+		{
+			repeat = 11 + static_cast<int>(ReadBits(_state, 7));
+		}
+
+		if (index + repeat > literalCount + distanceCount)
+		{
+			return false;
+		}
+		while (repeat-- > 0)
+		{
+			lengths[index++] = value;
+		}
+	}
+
+	//	Without an end of block code nothing could be decoded
+	if (lengths[256] == 0)
+	{
+		return false;
+	}
+
+	return BuildHuffmanTable(_literals, lengths, literalCount) && BuildHuffmanTable(_distances, lengths + literalCount, distanceCount);
+}
+
+/*
+	Decode a PNG: check the signature, collect IHDR, PLTE, tRNS and the IDAT data, inflate and unfilter the rows
+	Then expand every pixel to RGBA, returns nullptr for anything unsupported or broken
+*/
+unsigned char* PngReaderClass::Read(const unsigned char* _data, size_t _size, unsigned int& _width, unsigned int& _height)
+{
+	_width = 0;
+	_height = 0;
+
+	if (_size < sizeof(PNG_SIGNATURE) || memcmp(_data, PNG_SIGNATURE, sizeof(PNG_SIGNATURE)) != 0)
+	{
+		return nullptr;
+	}
+
+	unsigned int width = 0;
+	unsigned int height = 0;
+	unsigned int bitDepth = 0;
+	unsigned int colorType = 0;
+	unsigned char palette[256][4];
+	unsigned int paletteSize = 0;
+	unsigned int transparentKey[3] = {};
+	bool hasTransparentKey = false;
+	size_t compressedSize = 0;
+	bool headerRead = false;
+
+	memset(palette, 0xFF, sizeof(palette));
+
+	//	First walk: header, palette, transparency and the total size of the image data
+	for (size_t offset = sizeof(PNG_SIGNATURE); offset + 12 <= _size;)
+	{
+		const unsigned char* chunk = _data + offset;
+		size_t length = (static_cast<size_t>(chunk[0]) << 24) | (static_cast<size_t>(chunk[1]) << 16) | (static_cast<size_t>(chunk[2]) << 8) | chunk[3];
+		if (length > _size - offset - 12)
+		{
+			return nullptr;
+		}
+
+		const unsigned char* content = chunk + 8;
+		if (memcmp(chunk + 4, "IHDR", 4) == 0 && length >= 13)
+		{
+			width = (static_cast<unsigned int>(content[0]) << 24) | (content[1] << 16) | (content[2] << 8) | content[3];
+			height = (static_cast<unsigned int>(content[4]) << 24) | (content[5] << 16) | (content[6] << 8) | content[7];
+			bitDepth = content[8];
+			colorType = content[9];
+			if (content[10] != 0 || content[11] != 0 || content[12] != 0)
+			{
+				return nullptr;
+			}
+			headerRead = true;
+		}
+		else if (memcmp(chunk + 4, "PLTE", 4) == 0)
+		{
+			paletteSize = static_cast<unsigned int>(length / 3 < 256 ? length / 3 : 256);
+			for (unsigned int i = 0; i < paletteSize; i++)
+			{
+				palette[i][0] = content[i * 3];
+				palette[i][1] = content[i * 3 + 1];
+				palette[i][2] = content[i * 3 + 2];
+			}
+		}
+		else if (memcmp(chunk + 4, "tRNS", 4) == 0)
+		{
+			if (colorType == 3)
+			{
+				for (size_t i = 0; i < length && i < 256; i++)
+				{
+					palette[i][3] = content[i];
+				}
+			}
+			else if ((colorType == 0 && length >= 2) || (colorType == 2 && length >= 6))
+			{
+				for (unsigned int i = 0; i < (colorType == 0 ? 1u : 3u); i++)
+				{
+					transparentKey[i] = (static_cast<unsigned int>(content[i * 2]) << 8) | content[i * 2 + 1];
+				}
+				hasTransparentKey = true;
+			}
+		}
+		else if (memcmp(chunk + 4, "IDAT", 4) == 0)
+		{
+			compressedSize += length;
+		}
+		else if (memcmp(chunk + 4, "IEND", 4) == 0)
+		{
+			break;
+		}
+
+		offset += length + 12;
+	}
+
+	unsigned int channels;
+	switch (colorType)
+	{
+	case 0: channels = 1; break;
+	case 2: channels = 3; break;
+	case 3: channels = 1; break;
+	case 4: channels = 2; break;
+	case 6: channels = 4; break;
+	default: return nullptr;
+	}
+
+	bool validDepth = bitDepth == 8 || (bitDepth == 16 && colorType != 3) || ((bitDepth == 1 || bitDepth == 2 || bitDepth == 4) && (colorType == 0 || colorType == 3));
+	if (!headerRead || !validDepth || width == 0 || height == 0 || width > MAX_PNG_DIMENSION || height > MAX_PNG_DIMENSION ||
+		compressedSize < 2 || (colorType == 3 && paletteSize == 0))
+	{
+		return nullptr;
+	}
+
+	//	Second walk: concatenate the image data
+	unsigned char* compressed = new unsigned char[compressedSize];
+	size_t compressedPosition = 0;
+	for (size_t offset = sizeof(PNG_SIGNATURE); offset + 12 <= _size;)
+	{
+		const unsigned char* chunk = _data + offset;
+		size_t length = (static_cast<size_t>(chunk[0]) << 24) | (static_cast<size_t>(chunk[1]) << 16) | (static_cast<size_t>(chunk[2]) << 8) | chunk[3];
+		if (memcmp(chunk + 4, "IDAT", 4) == 0)
+		{
+			memcpy(compressed + compressedPosition, chunk + 8, length);
+			compressedPosition += length;
+		}
+		offset += length + 12;
+	}
+
+	//	Every row starts with its filter type
+	unsigned int bitsPerPixel = channels * bitDepth;
+	size_t rowSize = (static_cast<size_t>(width) * bitsPerPixel + 7) / 8;
+	size_t rawSize = (rowSize + 1) * height;
+	unsigned char* raw = new unsigned char[rawSize];
+
+	bool decoded = Inflate(compressed, compressedSize, raw, rawSize) && Unfilter(raw, height, rowSize, bitsPerPixel >= 8 ? bitsPerPixel / 8 : 1);
+	delete[] compressed;
+
+	if (!decoded)
+	{
+		delete[] raw;
+		return nullptr;
+	}
+
+	unsigned char* pixels = new unsigned char[static_cast<size_t>(width) * height * 4];
+	unsigned int maximum = (1u << (bitDepth < 8 ? bitDepth : 8)) - 1;
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned char* row = raw + y * (rowSize + 1) + 1;
+		for (unsigned int x = 0; x < width; x++)
+		{
+			//	Samples at full precision (for the transparency key) and as 8 bit
+			unsigned int samples[4];
+			unsigned char values[4];
+			for (unsigned int channel = 0; channel < channels; channel++)
+			{
+				size_t sample = static_cast<size_t>(x) * channels + channel;
+				if (bitDepth == 16)
+				{
+					samples[channel] = (static_cast<unsigned int>(row[sample * 2]) << 8) | row[sample * 2 + 1];
+					values[channel] = row[sample * 2];
+				}
+				else if (bitDepth == 8)
+				{
+					samples[channel] = row[sample];
+					values[channel] = row[sample];
+				}
+				else
+				{
+					size_t bit = sample * bitDepth;
+					samples[channel] = (row[bit / 8] >> (8 - bitDepth - bit % 8)) & maximum;
+					values[channel] = static_cast<unsigned char>(colorType == 3 ? samples[channel] : samples[channel] * 255 / maximum);
+				}
+			}
+
+			unsigned char* pixel = pixels + (static_cast<size_t>(y) * width + x) * 4;
+			switch (colorType)
+			{
+			case 0:
+				pixel[0] = pixel[1] = pixel[2] = values[0];
+				pixel[3] = hasTransparentKey && samples[0] == transparentKey[0] ? 0 : 255;
+				break;
+			case 2:
+				memcpy(pixel, values, 3);
+				pixel[3] = hasTransparentKey && samples[0] == transparentKey[0] && samples[1] == transparentKey[1] && samples[2] == transparentKey[2] ? 0 : 255;
+				break;
+			case 3:
+				memcpy(pixel, palette[values[0]], 4);
+				break;
+			case 4:
+				pixel[0] = pixel[1] = pixel[2] = values[0];
+				pixel[3] = values[1];
+				break;
+			default:
+				memcpy(pixel, values, 4);
+				break;
+			}
+		}
+	}
+
+	delete[] raw;
+
+	_width = width;
+	_height = height;
+
+	return pixels;
+}
+
+/*
+	zlib stream: header, deflate blocks (stored, fixed and dynamic Huffman), the Adler-32 checksum is not checked
+	The output has to come out at exactly _outputSize bytes
+*/
+bool PngReaderClass::Inflate(const unsigned char* _input, size_t _inputSize, unsigned char* _output, size_t _outputSize)
+{
+	if ((_input[0] & 0x0F) != 8 || ((_input[0] << 8) | _input[1]) % 31 != 0 || (_input[1] & 0x20) != 0)
+	{
+		return false;
+	}
+
+	InflateState state;
+	memset(&state, 0, sizeof(state));
+	state.input = _input;
+	state.inputSize = _inputSize;
+	state.inputPosition = 2;
+	state.output = _output;
+	state.outputSize = _outputSize;
+
+	static const FixedHuffmanTables fixed;
+
+	bool last = false;
+	while (!last)
+	{
+		last = ReadBits(state, 1) != 0;
+		unsigned int type = ReadBits(state, 2);
+		if (state.error)
+		{
+			return false;
+		}
+
+		if (type == 0)
+		{
+			//	Stored: byte aligned length, its complement and the raw bytes
+			state.bitBuffer = 0;
+			state.bitCount = 0;
+			if (state.inputSize - state.inputPosition < 4)
+			{
+				return false;
+			}
+
+			const unsigned char* header = state.input + state.inputPosition;
+			size_t length = header[0] | (header[1] << 8);
+			if ((length ^ (header[2] | (header[3] << 8))) != 0xFFFF)
+			{
+				return false;
+			}
+			state.inputPosition += 4;
+
+			if (length > state.inputSize - state.inputPosition || length > state.outputSize - state.outputPosition)
+			{
+				return false;
+			}
+			memcpy(state.output + state.outputPosition, state.input + state.inputPosition, length);
+			state.inputPosition += length;
+			state.outputPosition += length;
+		}
+		else if (type == 1)
+		{
+			if (!InflateCodes(state, fixed.literals, fixed.distances))
+			{
+				return false;
+			}
+		}
+		else if (type == 2)
+		{
+			HuffmanTable literals;
+			HuffmanTable distances;
+			if (!ReadDynamicTables(state, literals, distances) || !InflateCodes(state, literals, distances))
+			{
+				return false;
+			}
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	return state.outputPosition == state.outputSize;
+}
+
+/*
+	Undo the per row filters in place: none, sub, up, average, Paeth
+	Bytes left of the image and the row above the first one count as 0
+*/
+bool PngReaderClass::Unfilter(unsigned char* _rows, unsigned int _height, size_t _rowSize, unsigned int _pixelSize)
+{
+	const unsigned char* previous = nullptr;
+
+	for (unsigned int y = 0; y < _height; y++)
+	{
+		unsigned char* row = _rows + y * (_rowSize + 1);
+		unsigned char filter = row[0];
+		unsigned char* current = row + 1;
+
+		for (size_t i = 0; i < _rowSize; i++)
+		{
+			int left = i >= _pixelSize ? current[i - _pixelSize] : 0;
+			int up = previous ? previous[i] : 0;
+			int upLeft = previous && i >= _pixelSize ? previous[i - _pixelSize] : 0;
+
+			int prediction;
+			switch (filter)
+			{
+			case 0:
+				prediction = 0;
+				break;
+			case 1:
+				prediction = left;
+				break;
+			case 2:
+				prediction = up;
+				break;
+			case 3:
+				prediction = (left + up) / 2;
+				break;
+			case 4:
+			{
+				int estimate = left + up - upLeft;
+				int distanceLeft = estimate > left ? estimate - left : left - estimate;
+				int distanceUp = estimate > up ? estimate - up : up - estimate;
+				int distanceUpLeft = estimate > upLeft ? estimate - upLeft : upLeft - estimate;
+				prediction = distanceLeft <= distanceUp && distanceLeft <= distanceUpLeft ? left : (distanceUp <= distanceUpLeft ? up : upLeft);
+				break;
+			}
+			default:
+				return false;
+			}
+
+			current[i] = static_cast<unsigned char>(current[i] + prediction);
+		}
+
+		previous = current;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+/*
+	Reads PNG files into 8 bit RGBA without an external library, inflate included
+	Gray, gray with alpha, RGB, RGBA with 8 or 16 bits and palette or gray images with 1 to 8 bits, transparency chunks are applied
+	Interlaced images are not supported, 16 bit channels are cut to their high byte
+*/
+class PngReaderClass
+{
+public:
+	static unsigned char* Read(const unsigned char* _data, size_t _size, unsigned int& _width, unsigned int& _height);
+
+private:
+	static bool Inflate(const unsigned char* _input, size_t _inputSize, unsigned char* _output, size_t _outputSize);
+	static bool Unfilter(unsigned char* _rows, unsigned int _height, size_t _rowSize, unsigned int _pixelSize);
+};
\ No newline at end of file
@@ -0,0 +1,122 @@
+#include "SceneCookerClass.h"
+#include "CookerClass.h"
+#include "HashClass.h"
+
+/*
+	Parse the JSON file, read every object and write them into the scene file
+	Fails if an object misses a required member, nothing is written then
+*/
+bool SceneCookerClass::Cook(const char* _jsonPath, const char* _scenePath, unsigned int& _objectCount)
+{
+	_objectCount = 0;
+
+	size_t size = 0;
+	unsigned char* text = CookerClass::ReadFile(_jsonPath, size);
+	if (!text)
+	{
+		return false;
+	}
+
+	JsonClass json;
+	if (!json.Parse(reinterpret_cast<const char*>(text), size))
+	{
+		delete[] text;
+		return false;
+	}
+
+	const JsonValue* objects = json.Find(json.GetRoot(), "objects");
+	if (!objects || objects->type != JSON_ARRAY)
+	{
+		json.Release();
+		delete[] text;
+		return false;
+	}
+
+	SceneObject* sceneObjects = new SceneObject[objects->childCount > 0 ? objects->childCount : 1];
+	if (!sceneObjects)
+	{
+		json.Release();
+		delete[] text;
+		return false;
+	}
+
+	bool valid = true;
+	unsigned int objectCount = 0;
+	for (const JsonValue* object = json.GetElement(objects, 0); object && valid; object = json.GetNext(object))
+	{
+		valid = ReadObject(json, object, sceneObjects[objectCount]);
+		objectCount++;
+	}
+
+	bool written = valid && SceneFileClass::Write(_scenePath, sceneObjects, objectCount);
+
+	delete[] sceneObjects;
+	json.Release();
+	delete[] text;
+
+	if (written)
+	{
+		_objectCount = objectCount;
+	}
+
+	return written;
+}
+
+/*
+	One object of the objects array, a missing rotation is the identity and a missing scale is 1
+*/
+bool SceneCookerClass::ReadObject(const JsonClass& _json, const JsonValue* _object, SceneObject& _sceneObject)
+{
+	_sceneObject.rotation = MathClass::QuaternionIdentity();
+	_sceneObject.scale = { 1.0f, 1.0f, 1.0f };
+
+	const JsonValue* mesh = _json.Find(_object, "mesh");
+	double material = _json.GetNumber(_object, "material", 0.0);
+
+	if (!ReadFloats(_json, _object, "position", &_sceneObject.position.x, 3, false) ||
+		!ReadFloats(_json, _object, "rotation", &_sceneObject.rotation.x, 4, true) ||
+		!ReadFloats(_json, _object, "scale", &_sceneObject.scale.x, 3, true) ||
+		!ReadFloats(_json, _object, "boundsCenter", &_sceneObject.boundsCenter.x, 3, false) ||
+		!ReadFloats(_json, _object, "boundsExtent", &_sceneObject.boundsExtent.x, 3, false) ||
+		!mesh || mesh->type != JSON_STRING || material < 0.0 || material > 4294967295.0)
+	{
+		return false;
+	}
+
+	//	Same as AssetPackageClass::GetAssetId, the name is used as it is written in the file
+	_sceneObject.meshId = HashClass::Hash(mesh->string, mesh->stringLength);
+	_sceneObject.material = static_cast<unsigned int>(material);
+
+	return true;
+}
+
+/*
+	An array of exactly _count numbers, _values stays as it is if the member is optional and missing
+*/
+bool SceneCookerClass::ReadFloats(const JsonClass& _json, const JsonValue* _object, const char* _key, float* _values, unsigned int _count, bool _optional)
+{
+	const JsonValue* array = _json.Find(_object, _key);
+	if (!array)
+	{
+		return _optional;
+	}
+
+	if (array->type != JSON_ARRAY || array->childCount != _count)
+	{
+		return false;
+	}
+
+	unsigned int index = 0;
+	for (const JsonValue* value = _json.GetElement(array, 0); value; value = _json.GetNext(value))
+	{
+		if (value->type != JSON_NUMBER)
+		{
+			return false;
+		}
+
+		_values[index] = static_cast<float>(value->number);
+		index++;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#pragma region includes
+#include "JsonClass.h"
+#include "SceneFileClass.h"
+#pragma endregion
+
+/*
+	Turns a scene written as JSON into a binary scene file (SceneFileClass)
+	{ "objects": [ { "position": [x, y, z], "rotation": [x, y, z, w], "scale": [x, y, z], "boundsCenter": [x, y, z], "boundsExtent": [x, y, z], "mesh": "name", "material": 0 }, ... ] }
+	rotation and scale are optional, the bounds are in world space, the mesh is referenced by the name it was cooked from (AssetPackageClass::GetAssetId)
+*/
+class SceneCookerClass
+{
+public:
+	static bool Cook(const char* _jsonPath, const char* _scenePath, unsigned int& _objectCount);
+
+private:
+	static bool ReadObject(const JsonClass& _json, const JsonValue* _object, SceneObject& _sceneObject);
+	static bool ReadFloats(const JsonClass& _json, const JsonValue* _object, const char* _key, float* _values, unsigned int _count, bool _optional);
+};
\ No newline at end of file
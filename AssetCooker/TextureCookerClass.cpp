@@ -0,0 +1,524 @@
+#include "TextureCookerClass.h"
+#include <cmath>
+#include <cstring>
+
+#pragma region Globals
+static const int POWER_ITERATIONS = 8;
+#pragma endregion
+
+/*
+	sRGB transfer function both ways, as tables so every pixel is converted the same way
+*/
+struct SrgbTables
+{
+	float toLinear[256];
+
+	SrgbTables()
+	{
+		for (int i = 0; i < 256; i++)
+		{
+			float value = static_cast<float>(i) / 255.0f;
+			toLinear[i] = value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+		}
+	}
+
+	unsigned char ToSrgb(float _linear) const
+	{
+		//	The nearest sRGB value, found by bisection over the table, so both directions agree exactly
+		int low = 0;
+		int high = 255;
+		while (low < high)
+		{
+			int middle = (low + high + 1) / 2;
+			if (toLinear[middle] <= _linear)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle - 1;
+			}
+		}
+
+		if (low < 255 && toLinear[low + 1] - _linear < _linear - toLinear[low])
+		{
+			low++;
+		}
+
+		return static_cast<unsigned char>(low);
+	}
+};
+
+static const SrgbTables& GetSrgbTables()
+{
+	static const SrgbTables tables;
+
+	return tables;
+}
+
+static unsigned short PackColor565(const float* _color)
+{
+	int red = static_cast<int>(_color[0] * 31.0f / 255.0f + 0.5f);
+	int green = static_cast<int>(_color[1] * 63.0f / 255.0f + 0.5f);
+	int blue = static_cast<int>(_color[2] * 31.0f / 255.0f + 0.5f);
+	red = red < 0 ? 0 : (red > 31 ? 31 : red);
+	green = green < 0 ? 0 : (green > 63 ? 63 : green);
+	blue = blue < 0 ? 0 : (blue > 31 ? 31 : blue);
+
+	return static_cast<unsigned short>((red << 11) | (green << 5) | blue);
+}
+
+static void UnpackColor565(unsigned short _packed, int* _color)
+{
+	int red = (_packed >> 11) & 31;
+	int green = (_packed >> 5) & 63;
+	int blue = _packed & 31;
+	_color[0] = (red << 3) | (red >> 2);
+	_color[1] = (green << 2) | (green >> 4);
+	_color[2] = (blue << 3) | (blue >> 2);
+}
+
+static void WriteUnsigned16(unsigned char* _output, unsigned int _value)
+{
+	_output[0] = static_cast<unsigned char>(_value);
+	_output[1] = static_cast<unsigned char>(_value >> 8);
+}
+
+/*
+	Build the mip chain level by level, every level is encoded before the next one is filtered from it
+	The levels are placed like D3D12 footprints: rows padded to TEXTURE_ROW_PITCH_ALIGNMENT, levels aligned to TEXTURE_MIP_ALIGNMENT
+*/
+bool TextureCookerClass::Cook(const unsigned char* _pixels, unsigned int _width, unsigned int _height, bool _srgb, unsigned char*& _asset, size_t& _assetSize)
+{
+	_asset = nullptr;
+	_assetSize = 0;
+
+	if (!_pixels || _width == 0 || _height == 0)
+	{
+		return false;
+	}
+
+	bool hasAlpha = false;
+	for (size_t i = 0; i < static_cast<size_t>(_width) * _height && !hasAlpha; i++)
+	{
+		hasAlpha = _pixels[i * 4 + 3] != 255;
+	}
+
+	unsigned int format = hasAlpha ? (_srgb ? TEXTURE_FORMAT_BC3_UNORM_SRGB : TEXTURE_FORMAT_BC3_UNORM) : (_srgb ? TEXTURE_FORMAT_BC1_UNORM_SRGB : TEXTURE_FORMAT_BC1_UNORM);
+	unsigned int blockSize = TextureAssetClass::GetBlockSize(format);
+
+	unsigned int mipCount = 1;
+	while (mipCount < MAX_TEXTURE_MIPS && ((_width >> mipCount) > 0 || (_height >> mipCount) > 0))
+	{
+		mipCount++;
+	}
+
+	//	Lay out the levels
+	TextureMip mips[MAX_TEXTURE_MIPS];
+	memset(mips, 0, sizeof(mips));
+	unsigned long long dataSize = 0;
+	for (unsigned int i = 0; i < mipCount; i++)
+	{
+		TextureMip& mip = mips[i];
+		mip.width = _width >> i > 0 ? _width >> i : 1;
+		mip.height = _height >> i > 0 ? _height >> i : 1;
+		mip.rowPitch = (((mip.width + 3) / 4) * blockSize + TEXTURE_ROW_PITCH_ALIGNMENT - 1) & ~(TEXTURE_ROW_PITCH_ALIGNMENT - 1);
+		mip.rowCount = (mip.height + 3) / 4;
+		mip.offset = (dataSize + TEXTURE_MIP_ALIGNMENT - 1) & ~static_cast<unsigned long long>(TEXTURE_MIP_ALIGNMENT - 1);
+		dataSize = mip.offset + static_cast<unsigned long long>(mip.rowPitch) * mip.rowCount;
+	}
+
+	unsigned long long dataOffset = (sizeof(TextureAssetHeader) + ASSET_ALIGNMENT - 1) & ~static_cast<unsigned long long>(ASSET_ALIGNMENT - 1);
+	size_t assetSize = static_cast<size_t>(dataOffset + dataSize);
+
+	//	Zeroed, so the row and level padding is the same on every run
+	unsigned char* asset = new unsigned char[assetSize];
+	memset(asset, 0, assetSize);
+
+	TextureAssetHeader* header = reinterpret_cast<TextureAssetHeader*>(asset);
+	header->header.type = ASSET_TYPE_TEXTURE;
+	header->header.version = TEXTURE_ASSET_VERSION;
+	header->header.size = assetSize;
+	header->width = _width;
+	header->height = _height;
+	header->format = format;
+	header->mipCount = mipCount;
+	header->dataOffset = dataOffset;
+	header->dataSize = dataSize;
+	memcpy(header->mips, mips, sizeof(mips));
+
+	unsigned char* level = new unsigned char[static_cast<size_t>(_width) * _height * 4];
+	unsigned char* nextLevel = new unsigned char[static_cast<size_t>(mips[mipCount > 1 ? 1 : 0].width) * mips[mipCount > 1 ? 1 : 0].height * 4];
+	memcpy(level, _pixels, static_cast<size_t>(_width) * _height * 4);
+
+	for (unsigned int i = 0; i < mipCount; i++)
+	{
+		const TextureMip& mip = mips[i];
+		unsigned char* destination = asset + dataOffset + mip.offset;
+
+		for (unsigned int blockY = 0; blockY < mip.rowCount; blockY++)
+		{
+			for (unsigned int blockX = 0; blockX < (mip.width + 3) / 4; blockX++)
+			{
+				//	Blocks over the edge repeat the last row and column
+				unsigned char block[64];
+				for (unsigned int y = 0; y < 4; y++)
+				{
+					unsigned int sourceY = blockY * 4 + y < mip.height ? blockY * 4 + y : mip.height - 1;
+					for (unsigned int x = 0; x < 4; x++)
+					{
+						unsigned int sourceX = blockX * 4 + x < mip.width ? blockX * 4 + x : mip.width - 1;
+						memcpy(&block[(y * 4 + x) * 4], &level[(static_cast<size_t>(sourceY) * mip.width + sourceX) * 4], 4);
+					}
+				}
+
+				unsigned char* output = destination + static_cast<size_t>(blockY) * mip.rowPitch + static_cast<size_t>(blockX) * blockSize;
+				if (hasAlpha)
+				{
+					EncodeBc3Block(block, output);
+				}
+				else
+				{
+					EncodeBc1Block(block, output);
+				}
+			}
+		}
+
+		if (i + 1 < mipCount)
+		{
+			Downsample(level, mip.width, mip.height, _srgb, nextLevel);
+			unsigned char* swap = level;
+			level = nextLevel;
+			nextLevel = swap;
+		}
+	}
+
+	delete[] nextLevel;
+	delete[] level;
+
+	_asset = asset;
+	_assetSize = assetSize;
+
+	return true;
+}
+
+/*
+	Opaque block: colors only, always in 4 color mode
+*/
+void TextureCookerClass::EncodeBc1Block(const unsigned char* _block, unsigned char* _output)
+{
+	EncodeColors(_block, _output);
+}
+
+/*
+	Alpha block followed by a BC1 color block
+*/
+void TextureCookerClass::EncodeBc3Block(const unsigned char* _block, unsigned char* _output)
+{
+	EncodeAlpha(_block, _output);
+	EncodeColors(_block, _output + 8);
+}
+
+void TextureCookerClass::DecodeBc1Block(const unsigned char* _input, unsigned char* _block)
+{
+	unsigned int color0 = _input[0] | (_input[1] << 8);
+	unsigned int color1 = _input[2] | (_input[3] << 8);
+	unsigned int indices = _input[4] | (_input[5] << 8) | (_input[6] << 16) | (static_cast<unsigned int>(_input[7]) << 24);
+
+	int palette[4][4];
+	UnpackColor565(static_cast<unsigned short>(color0), palette[0]);
+	UnpackColor565(static_cast<unsigned short>(color1), palette[1]);
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+
+	for (int channel = 0; channel < 3; channel++)
+	{
+		if (color0 > color1)
+		{
+			palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+			palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+		}
+		else
+		{
+			palette[2][channel] = (palette[0][channel] + palette[1][channel]) / 2;
+			palette[3][channel] = 0;
+		}
+	}
+	palette[2][3] = 255;
+	palette[3][3] = color0 > color1 ? 255 : 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		const int* color = palette[(indices >> (i * 2)) & 3];
+		for (int channel = 0; channel < 4; channel++)
+		{
+			_block[i * 4 + channel] = static_cast<unsigned char>(color[channel]);
+		}
+	}
+}
+
+void TextureCookerClass::DecodeBc3Block(const unsigned char* _input, unsigned char* _block)
+{
+	DecodeBc1Block(_input + 8, _block);
+
+	int alpha[8];
+	alpha[0] = _input[0];
+	alpha[1] = _input[1];
+	for (int i = 1; i < 7; i++)
+	{
+		alpha[i + 1] = alpha[0] > alpha[1] ? ((7 - i) * alpha[0] + i * alpha[1]) / 7 : (i < 5 ? ((5 - i) * alpha[0] + i * alpha[1]) / 5 : (i == 5 ? 0 : 255));
+	}
+
+	unsigned long long indices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		indices |= static_cast<unsigned long long>(_input[2 + i]) << (i * 8);
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		_block[i * 4 + 3] = static_cast<unsigned char>(alpha[(indices >> (i * 3)) & 7]);
+	}
+}
+
+/*
+	Average of 2x2 texels, the last row or column is repeated for odd sizes
+	sRGB colors are averaged as linear values, alpha is always linear
+*/
+void TextureCookerClass::Downsample(const unsigned char* _source, unsigned int _width, unsigned int _height, bool _srgb, unsigned char* _destination)
+{
+	const SrgbTables& tables = GetSrgbTables();
+	unsigned int width = _width > 1 ? _width / 2 : 1;
+	unsigned int height = _height > 1 ? _height / 2 : 1;
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		unsigned int y0 = y * 2 < _height ? y * 2 : _height - 1;
+		unsigned int y1 = y * 2 + 1 < _height ? y * 2 + 1 : _height - 1;
+
+		for (unsigned int x = 0; x < width; x++)
+		{
+			unsigned int x0 = x * 2 < _width ? x * 2 : _width - 1;
+			unsigned int x1 = x * 2 + 1 < _width ? x * 2 + 1 : _width - 1;
+
+			const unsigned char* texels[4] = {
+				&_source[(static_cast<size_t>(y0) * _width + x0) * 4],
+				&_source[(static_cast<size_t>(y0) * _width + x1) * 4],
+				&_source[(static_cast<size_t>(y1) * _width + x0) * 4],
+				&_source[(static_cast<size_t>(y1) * _width + x1) * 4] };
+
+			unsigned char* destination = &_destination[(static_cast<size_t>(y) * width + x) * 4];
+			for (int channel = 0; channel < 4; channel++)
+			{
+				if (_srgb && channel < 3)
+				{
+					float sum = tables.toLinear[texels[0][channel]] + tables.toLinear[texels[1][channel]] + tables.toLinear[texels[2][channel]] + tables.toLinear[texels[3][channel]];
+					destination[channel] = tables.ToSrgb(sum * 0.25f);
+				}
+				else
+				{
+					destination[channel] = static_cast<unsigned char>((texels[0][channel] + texels[1][channel] + texels[2][channel] + texels[3][channel] + 2) / 4);
+				}
+			}
+		}
+	}
+}
+
+/*
+	Range fit along the principal axis: the covariance of the colors gives the axis (power iteration),
+	the texels farthest along it in both directions become the endpoints, every texel takes the nearest of the 4 palette colors
+*/
+void TextureCookerClass::EncodeColors(const unsigned char* _block, unsigned char* _output)
+{
+	float mean[3] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		for (int channel = 0; channel < 3; channel++)
+		{
+			mean[channel] += _block[i * 4 + channel];
+		}
+	}
+	for (int channel = 0; channel < 3; channel++)
+	{
+		mean[channel] /= 16.0f;
+	}
+
+	//	rr, rg, rb, gg, gb, bb
+	float covariance[6] = {};
+	for (int i = 0; i < 16; i++)
+	{
+		float r = _block[i * 4] - mean[0];
+		float g = _block[i * 4 + 1] - mean[1];
+		float b = _block[i * 4 + 2] - mean[2];
+		covariance[0] += r * r;
+		covariance[1] += r * g;
+		covariance[2] += r * b;
+		covariance[3] += g * g;
+		covariance[4] += g * b;
+		covariance[5] += b * b;
+	}
+
+	//	Start from the covariance column of the channel that varies most, it can not be orthogonal to the principal axis
+	float axis[3];
+	if (covariance[0] >= covariance[3] && covariance[0] >= covariance[5])
+	{
+		axis[0] = covariance[0];
+		axis[1] = covariance[1];
+		axis[2] = covariance[2];
+	}
+	else if (covariance[3] >= covariance[5])
+	{
+		axis[0] = covariance[1];
+		axis[1] = covariance[3];
+		axis[2] = covariance[4];
+	}
+	else
+	{
+		axis[0] = covariance[2];
+		axis[1] = covariance[4];
+		axis[2] = covariance[5];
+	}
+
+	for (int iteration = 0; iteration < POWER_ITERATIONS; iteration++)
+	{
+		float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+		float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+		float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+		float length = fabsf(x) > fabsf(y) ? (fabsf(x) > fabsf(z) ? fabsf(x) : fabsf(z)) : (fabsf(y) > fabsf(z) ? fabsf(y) : fabsf(z));
+		if (length == 0.0f)
+		{
+			break;
+		}
+		axis[0] = x / length;
+		axis[1] = y / length;
+		axis[2] = z / length;
+	}
+
+	int minimum = 0;
+	int maximum = 0;
+	float minimumProjection = INFINITY;
+	float maximumProjection = -INFINITY;
+	for (int i = 0; i < 16; i++)
+	{
+		float projection = _block[i * 4] * axis[0] + _block[i * 4 + 1] * axis[1] + _block[i * 4 + 2] * axis[2];
+		if (projection < minimumProjection)
+		{
+			minimumProjection = projection;
+			minimum = i;
+		}
+		if (projection > maximumProjection)
+		{
+			maximumProjection = projection;
+			maximum = i;
+		}
+	}
+
+	float endpoints[2][3];
+	for (int channel = 0; channel < 3; channel++)
+	{
+		endpoints[0][channel] = _block[maximum * 4 + channel];
+		endpoints[1][channel] = _block[minimum * 4 + channel];
+	}
+
+	unsigned short color0 = PackColor565(endpoints[0]);
+	unsigned short color1 = PackColor565(endpoints[1]);
+
+	//	4 color mode needs color0 > color1, a single color needs no indices
+	if (color0 < color1)
+	{
+		unsigned short swap = color0;
+		color0 = color1;
+		color1 = swap;
+	}
+
+	WriteUnsigned16(_output, color0);
+	WriteUnsigned16(_output + 2, color1);
+
+	unsigned int indices = 0;
+	if (color0 != color1)
+	{
+		int palette[4][3];
+		UnpackColor565(color0, palette[0]);
+		UnpackColor565(color1, palette[1]);
+		for (int channel = 0; channel < 3; channel++)
+		{
+			palette[2][channel] = (2 * palette[0][channel] + palette[1][channel]) / 3;
+			palette[3][channel] = (palette[0][channel] + 2 * palette[1][channel]) / 3;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			unsigned int best = 0;
+			int bestDistance = 0x7FFFFFFF;
+			for (unsigned int entry = 0; entry < 4; entry++)
+			{
+				int dr = _block[i * 4] - palette[entry][0];
+				int dg = _block[i * 4 + 1] - palette[entry][1];
+				int db = _block[i * 4 + 2] - palette[entry][2];
+				int distance = dr * dr + dg * dg + db * db;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = entry;
+				}
+			}
+			indices |= best << (i * 2);
+		}
+	}
+
+	WriteUnsigned16(_output + 4, indices & 0xFFFF);
+	WriteUnsigned16(_output + 6, indices >> 16);
+}
+
+/*
+	Alpha endpoints are the extremes of the block, always in 8 value mode (alpha0 > alpha1)
+*/
+void TextureCookerClass::EncodeAlpha(const unsigned char* _block, unsigned char* _output)
+{
+	int minimum = 255;
+	int maximum = 0;
+	for (int i = 0; i < 16; i++)
+	{
+		int alpha = _block[i * 4 + 3];
+		minimum = alpha < minimum ? alpha : minimum;
+		maximum = alpha > maximum ? alpha : maximum;
+	}
+
+	_output[0] = static_cast<unsigned char>(maximum);
+	_output[1] = static_cast<unsigned char>(minimum);
+
+	unsigned long long indices = 0;
+	if (maximum != minimum)
+	{
+		//	Palette index 0 and 1 are the endpoints, 2 to 7 lie between them
+		int palette[8];
+		palette[0] = maximum;
+		palette[1] = minimum;
+		for (int i = 1; i < 7; i++)
+		{
+			palette[i + 1] = ((7 - i) * maximum + i * minimum) / 7;
+		}
+
+		for (int i = 0; i < 16; i++)
+		{
+			int alpha = _block[i * 4 + 3];
+			unsigned long long best = 0;
+			int bestDistance = 256;
+			for (int entry = 0; entry < 8; entry++)
+			{
+				int distance = alpha > palette[entry] ? alpha - palette[entry] : palette[entry] - alpha;
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					best = static_cast<unsigned long long>(entry);
+				}
+			}
+			indices |= best << (i * 3);
+		}
+	}
+
+	for (int i = 0; i < 6; i++)
+	{
+		_output[2 + i] = static_cast<unsigned char>(indices >> (i * 8));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "TextureAssetClass.h"
+#pragma endregion
+
+/*
+	Turns an 8 bit RGBA image into a texture asset (TextureAssetHeader): full mip chain and BC compressed blocks
+	Opaque images become BC1, images with any alpha below 255 BC3
+	Mips are box filtered, sRGB images in linear space, the block encoder fits the endpoints along the principal axis of the block's colors
+	Everything is deterministic, the same image always gives the same bytes
+*/
+class TextureCookerClass
+{
+public:
+	static bool Cook(const unsigned char* _pixels, unsigned int _width, unsigned int _height, bool _srgb, unsigned char*& _asset, size_t& _assetSize);
+
+	static void EncodeBc1Block(const unsigned char* _block, unsigned char* _output);
+	static void EncodeBc3Block(const unsigned char* _block, unsigned char* _output);
+	static void DecodeBc1Block(const unsigned char* _input, unsigned char* _block);
+	static void DecodeBc3Block(const unsigned char* _input, unsigned char* _block);
+
+private:
+	static void Downsample(const unsigned char* _source, unsigned int _width, unsigned int _height, bool _srgb, unsigned char* _destination);
+	static void EncodeColors(const unsigned char* _block, unsigned char* _output);
+	static void EncodeAlpha(const unsigned char* _block, unsigned char* _output);
+};
\ No newline at end of file
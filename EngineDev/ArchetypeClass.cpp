@@ -0,0 +1,269 @@
+#include "ArchetypeClass.h"
+#include <cstring>
+
+/*
+	Constructor
+*/
+ArchetypeClass::ArchetypeClass()
+{
+	m_mask = 0;
+	m_componentCount = 0;
+	m_chunkCapacity = 0;
+	m_chunkPool = nullptr;
+	m_chunks = nullptr;
+	m_chunkCount = 0;
+	m_chunkListCapacity = 0;
+	m_entityCount = 0;
+}
+
+/*
+	Destructor
+*/
+ArchetypeClass::~ArchetypeClass()
+{
+
+}
+
+/*
+	Collect the components of the mask in the order of their ids
+	Fit as many rows into a chunk as possible: start with the capacity without the alignment of the arrays and lower it until the layout fits
+*/
+bool ArchetypeClass::Initialize(ComponentMask _mask, const ComponentType* _componentTypes, PoolAllocatorClass* _chunkPool)
+{
+	m_mask = _mask;
+	m_chunkPool = _chunkPool;
+	m_componentCount = 0;
+
+	size_t rowSize = sizeof(Entity);
+	for (unsigned int i = 0; i < MAX_COMPONENT_TYPES; i++)
+	{
+		m_componentOffsets[i] = INVALID_COMPONENT_OFFSET;
+		m_componentSizes[i] = 0;
+
+		if (_mask & (1ULL << i))
+		{
+			m_components[m_componentCount++] = i;
+			m_componentSizes[i] = _componentTypes[i].size;
+			rowSize += _componentTypes[i].size;
+		}
+	}
+
+	unsigned int capacity = static_cast<unsigned int>(ECS_CHUNK_SIZE / rowSize);
+	while (capacity > 0 && !ComputeLayout(capacity))
+	{
+		capacity--;
+	}
+
+	if (capacity == 0)
+	{
+		return false;
+	}
+
+	m_chunkCapacity = capacity;
+	m_chunks = nullptr;
+	m_chunkCount = 0;
+	m_chunkListCapacity = 0;
+	m_entityCount = 0;
+
+	return true;
+}
+
+/*
+	Give every chunk back to the pool
+*/
+void ArchetypeClass::Shutdown()
+{
+	for (unsigned int i = 0; i < m_chunkCount; i++)
+	{
+		m_chunkPool->Free(m_chunks[i]);
+	}
+
+	if (m_chunks)
+	{
+		delete[] m_chunks;
+		m_chunks = nullptr;
+	}
+
+	m_chunkCount = 0;
+	m_chunkListCapacity = 0;
+	m_entityCount = 0;
+	m_chunkPool = nullptr;
+}
+
+/*
+	Append a row for the entity, its components are not initialized
+	Take a new chunk from the pool if the last one is full, the list of chunks doubles when it runs out of room
+*/
+bool ArchetypeClass::AddRow(Entity _entity, unsigned int& _row)
+{
+	if (m_entityCount == m_chunkCount * m_chunkCapacity)
+	{
+		if (m_chunkCount == m_chunkListCapacity)
+		{
+			unsigned int chunkListCapacity = m_chunkListCapacity > 0 ? m_chunkListCapacity * 2 : 16;
+			unsigned char** chunks = new unsigned char*[chunkListCapacity];
+			if (!chunks)
+			{
+				return false;
+			}
+
+			if (m_chunks)
+			{
+				memcpy(chunks, m_chunks, sizeof(unsigned char*) * m_chunkCount);
+				delete[] m_chunks;
+			}
+
+			m_chunks = chunks;
+			m_chunkListCapacity = chunkListCapacity;
+		}
+
+		unsigned char* chunk = static_cast<unsigned char*>(m_chunkPool->Allocate());
+		if (!chunk)
+		{
+			return false;
+		}
+
+		m_chunks[m_chunkCount++] = chunk;
+	}
+
+	_row = m_entityCount++;
+
+	unsigned char* chunk = m_chunks[_row / m_chunkCapacity];
+	reinterpret_cast<Entity*>(chunk)[_row % m_chunkCapacity] = _entity;
+
+	return true;
+}
+
+/*
+	Move the last row into the removed one, so the rows stay dense
+	Give the last chunk back to the pool once it is empty
+	Returns the entity which now lives in _row, or the removed entity itself if it was the last row
+*/
+Entity ArchetypeClass::RemoveRow(unsigned int _row)
+{
+	unsigned int lastRow = m_entityCount - 1;
+
+	unsigned char* chunk = m_chunks[_row / m_chunkCapacity];
+	unsigned int index = _row % m_chunkCapacity;
+
+	Entity movedEntity = reinterpret_cast<Entity*>(chunk)[index];
+
+	if (_row != lastRow)
+	{
+		unsigned char* lastChunk = m_chunks[lastRow / m_chunkCapacity];
+		unsigned int lastIndex = lastRow % m_chunkCapacity;
+
+		movedEntity = reinterpret_cast<Entity*>(lastChunk)[lastIndex];
+		reinterpret_cast<Entity*>(chunk)[index] = movedEntity;
+
+		for (unsigned int i = 0; i < m_componentCount; i++)
+		{
+			unsigned int component = m_components[i];
+			size_t size = m_componentSizes[component];
+
+			memcpy(chunk + m_componentOffsets[component] + index * size, lastChunk + m_componentOffsets[component] + lastIndex * size, size);
+		}
+	}
+
+	m_entityCount--;
+
+	if (m_entityCount == (m_chunkCount - 1) * m_chunkCapacity)
+	{
+		m_chunkCount--;
+		m_chunkPool->Free(m_chunks[m_chunkCount]);
+	}
+
+	return movedEntity;
+}
+
+Entity ArchetypeClass::GetEntity(unsigned int _row) const
+{
+	return reinterpret_cast<const Entity*>(m_chunks[_row / m_chunkCapacity])[_row % m_chunkCapacity];
+}
+
+/*
+	Address of a component of a row, nullptr if the archetype does not have the component
+*/
+void* ArchetypeClass::GetComponent(unsigned int _component, unsigned int _row) const
+{
+	if (m_componentOffsets[_component] == INVALID_COMPONENT_OFFSET)
+	{
+		return nullptr;
+	}
+
+	return m_chunks[_row / m_chunkCapacity] + m_componentOffsets[_component] + (_row % m_chunkCapacity) * m_componentSizes[_component];
+}
+
+ComponentMask ArchetypeClass::GetMask() const
+{
+	return m_mask;
+}
+
+unsigned int ArchetypeClass::GetEntityCount() const
+{
+	return m_entityCount;
+}
+
+unsigned int ArchetypeClass::GetChunkCount() const
+{
+	return m_chunkCount;
+}
+
+unsigned int ArchetypeClass::GetChunkCapacity() const
+{
+	return m_chunkCapacity;
+}
+
+/*
+	Every chunk is full except the last one
+*/
+unsigned int ArchetypeClass::GetChunkEntityCount(unsigned int _chunk) const
+{
+	if (_chunk + 1 < m_chunkCount)
+	{
+		return m_chunkCapacity;
+	}
+
+	return m_entityCount - _chunk * m_chunkCapacity;
+}
+
+/*
+	The entities are the first array of the chunk
+*/
+unsigned char* ArchetypeClass::GetChunk(unsigned int _chunk) const
+{
+	return m_chunks[_chunk];
+}
+
+/*
+	Offset of the array of the component inside of every chunk, INVALID_COMPONENT_OFFSET if the archetype does not have it
+*/
+size_t ArchetypeClass::GetComponentOffset(unsigned int _component) const
+{
+	return m_componentOffsets[_component];
+}
+
+size_t ArchetypeClass::GetComponentSize(unsigned int _component) const
+{
+	return m_componentSizes[_component];
+}
+
+/*
+	Place the entity array and one array per component after another, every array starts on a cache line
+	Fails if the arrays for _capacity rows do not fit into a chunk
+*/
+bool ArchetypeClass::ComputeLayout(unsigned int _capacity)
+{
+	size_t offset = sizeof(Entity) * _capacity;
+
+	for (unsigned int i = 0; i < m_componentCount; i++)
+	{
+		unsigned int component = m_components[i];
+
+		offset = (offset + ECS_CHUNK_ALIGNMENT - 1) & ~(ECS_CHUNK_ALIGNMENT - 1);
+		m_componentOffsets[component] = offset;
+		offset += m_componentSizes[component] * _capacity;
+	}
+
+	return offset <= ECS_CHUNK_SIZE;
+}
\ No newline at end of file
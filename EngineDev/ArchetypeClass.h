@@ -0,0 +1,78 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "PoolAllocatorClass.h"
+#pragma endregion
+
+#pragma region global variables
+const size_t ECS_CHUNK_SIZE = 16 * 1024;
+const size_t ECS_CHUNK_ALIGNMENT = 64;				// chunks and every component array inside of them start on a cache line
+const unsigned int MAX_COMPONENT_TYPES = 64;		// one bit per component in a ComponentMask
+const size_t INVALID_COMPONENT_OFFSET = ~static_cast<size_t>(0);
+#pragma endregion
+
+/*
+	Bit i is set if component i is part of the set
+*/
+typedef unsigned long long ComponentMask;
+
+/*
+	Index of the entity in the low 32 bits, its generation in the high 32 bits
+*/
+typedef unsigned long long Entity;
+
+struct ComponentType
+{
+	const char* name;
+	size_t size;
+	size_t alignment;
+};
+
+/*
+	All entities with exactly the same set of components
+	The entities are stored in chunks of ECS_CHUNK_SIZE bytes, a chunk holds one array per component (structure of arrays) plus the entities
+	Rows are dense: every chunk is full except the last one, removing a row moves the last row into its place
+	So row r lives in chunk r / capacity at index r % capacity, and a chunk is one contiguous array per component to iterate over
+	Chunks come from a pool shared by all archetypes
+*/
+class ArchetypeClass
+{
+public:
+	ArchetypeClass();
+	~ArchetypeClass();
+
+	bool Initialize(ComponentMask _mask, const ComponentType* _componentTypes, PoolAllocatorClass* _chunkPool);
+	void Shutdown();
+
+	bool AddRow(Entity _entity, unsigned int& _row);
+	Entity RemoveRow(unsigned int _row);
+
+	Entity GetEntity(unsigned int _row) const;
+	void* GetComponent(unsigned int _component, unsigned int _row) const;
+
+	ComponentMask GetMask() const;
+	unsigned int GetEntityCount() const;
+	unsigned int GetChunkCount() const;
+	unsigned int GetChunkCapacity() const;
+	unsigned int GetChunkEntityCount(unsigned int _chunk) const;
+	unsigned char* GetChunk(unsigned int _chunk) const;
+	size_t GetComponentOffset(unsigned int _component) const;
+	size_t GetComponentSize(unsigned int _component) const;
+
+private:
+	ComponentMask m_mask;
+	unsigned int m_components[MAX_COMPONENT_TYPES];
+	unsigned int m_componentCount;
+	size_t m_componentOffsets[MAX_COMPONENT_TYPES];		// INVALID_COMPONENT_OFFSET for components which are not part of the archetype
+	size_t m_componentSizes[MAX_COMPONENT_TYPES];
+	unsigned int m_chunkCapacity;
+
+	PoolAllocatorClass* m_chunkPool;
+	unsigned char** m_chunks;
+	unsigned int m_chunkCount;
+	unsigned int m_chunkListCapacity;
+	unsigned int m_entityCount;
+
+	bool ComputeLayout(unsigned int _capacity);
+};
\ No newline at end of file
@@ -0,0 +1,433 @@
+#include "AssetLoaderClass.h"
+#include "HashClass.h"
+#include "ProfilerClass.h"
+#include <thread>
+
+#pragma region Globals
+//	A load which is cancelled while running stays in this state until it left its current block, then it becomes ASSET_STATE_CANCELLED
+static const unsigned int ASSET_STATE_CANCELLING = 5;
+#pragma endregion
+
+/*
+	Constructor
+*/
+AssetLoaderClass::AssetLoaderClass()
+{
+	m_jobSystem = nullptr;
+	m_packageCount = 0;
+	m_requests = nullptr;
+	m_firstFreeRequest = INVALID_ASSET_REQUEST;
+	for (unsigned int i = 0; i < ASSET_PRIORITY_COUNT; i++)
+	{
+		m_queueBegins[i] = 0;
+		m_queueCounts[i] = 0;
+	}
+	m_runningJobs = 0;
+	m_pendingRequests = 0;
+	m_loadedBytes = 0;
+}
+
+/*
+	Destructor
+*/
+AssetLoaderClass::~AssetLoaderClass()
+{
+
+}
+
+/*
+	Allocate every request once and chain them into the free list
+	_jobSystem may be nullptr, every request is loaded on the calling thread then
+*/
+bool AssetLoaderClass::Initialize(JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	m_requests = new AssetRequest[MAX_ASSET_REQUESTS];
+	if (!m_requests)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < MAX_ASSET_REQUESTS; i++)
+	{
+		m_requests[i].used = false;
+		m_requests[i].nextFree = i + 1 < MAX_ASSET_REQUESTS ? i + 1 : INVALID_ASSET_REQUEST;
+		m_requests[i].state.store(ASSET_STATE_CANCELLED);
+	}
+	m_firstFreeRequest = 0;
+
+	return true;
+}
+
+/*
+	Drop every queued request, wait for the loads which are running and close the packages
+	The assets of the packages are gone afterwards
+*/
+void AssetLoaderClass::Shutdown()
+{
+	if (m_requests)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		for (unsigned int priority = 0; priority < ASSET_PRIORITY_COUNT; priority++)
+		{
+			for (unsigned int i = 0; i < m_queueCounts[priority]; i++)
+			{
+				m_requests[m_queues[priority][(m_queueBegins[priority] + i) % MAX_ASSET_REQUESTS]].state.store(ASSET_STATE_CANCELLED);
+				m_pendingRequests.fetch_sub(1);
+			}
+
+			m_queueCounts[priority] = 0;
+		}
+	}
+
+	WaitForAll();
+
+	for (unsigned int i = 0; i < m_packageCount; i++)
+	{
+		m_packages[i].Close();
+	}
+	m_packageCount = 0;
+
+	delete[] m_requests;
+	m_requests = nullptr;
+	m_firstFreeRequest = INVALID_ASSET_REQUEST;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Map a package, its assets can be loaded from now on
+	Only maps the file and checks its entry table, no asset is read
+	Open every package before the first Load, an asset which is in several packages is loaded from the one opened first
+*/
+bool AssetLoaderClass::OpenPackage(const char* _path)
+{
+	PROFILE_SCOPE("AssetLoaderClass::OpenPackage");
+
+	if (m_packageCount == MAX_ASSET_PACKAGES)
+	{
+		return false;
+	}
+
+	if (!m_packages[m_packageCount].Open(_path))
+	{
+		return false;
+	}
+
+	m_packageCount++;
+
+	return true;
+}
+
+/*
+	Queue a load of the asset with the given priority (ASSET_PRIORITY_*), _callback may be nullptr
+	Start another background job if less than MAX_ASSET_LOAD_JOBS are running, the running jobs take the new request otherwise
+	Returns the request, INVALID_ASSET_REQUEST if no package contains the asset or every request is in use
+*/
+unsigned int AssetLoaderClass::Load(unsigned long long _assetId, unsigned int _priority, AssetCallback _callback, void* _userData)
+{
+	if (!m_requests || _priority >= ASSET_PRIORITY_COUNT)
+	{
+		return INVALID_ASSET_REQUEST;
+	}
+
+	const AssetPackageClass* package = nullptr;
+	const AssetPackageEntry* entry = nullptr;
+	for (unsigned int i = 0; i < m_packageCount && !entry; i++)
+	{
+		package = &m_packages[i];
+		entry = package->Find(_assetId);
+	}
+
+	if (!entry)
+	{
+		return INVALID_ASSET_REQUEST;
+	}
+
+	unsigned int request = INVALID_ASSET_REQUEST;
+	bool startJob = false;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		request = m_firstFreeRequest;
+		if (request == INVALID_ASSET_REQUEST)
+		{
+			return INVALID_ASSET_REQUEST;
+		}
+
+		AssetRequest& assetRequest = m_requests[request];
+		m_firstFreeRequest = assetRequest.nextFree;
+
+		assetRequest.package = package;
+		assetRequest.entry = entry;
+		assetRequest.callback = _callback;
+		assetRequest.userData = _userData;
+		assetRequest.priority = _priority;
+		assetRequest.used = true;
+		assetRequest.state.store(ASSET_STATE_QUEUED);
+
+		m_queues[_priority][(m_queueBegins[_priority] + m_queueCounts[_priority]) % MAX_ASSET_REQUESTS] = request;
+		m_queueCounts[_priority]++;
+		m_pendingRequests.fetch_add(1);
+
+		if (m_runningJobs < MAX_ASSET_LOAD_JOBS)
+		{
+			m_runningJobs++;
+			startJob = true;
+		}
+	}
+
+	if (startJob && (!m_jobSystem || !m_jobSystem->RunBackground(LoadJob, this, 0, 1, nullptr)))
+	{
+		LoadQueuedRequests();
+	}
+
+	return request;
+}
+
+/*
+	A queued request is taken out of its queue, a request which is loading stops after its current block
+	Either way its callback is not called
+	Returns false if the request already finished
+*/
+bool AssetLoaderClass::Cancel(unsigned int _request)
+{
+	if (!m_requests || _request >= MAX_ASSET_REQUESTS)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	AssetRequest& request = m_requests[_request];
+	if (!request.used)
+	{
+		return false;
+	}
+
+	unsigned int state = ASSET_STATE_LOADING;
+	if (request.state.compare_exchange_strong(state, ASSET_STATE_CANCELLING))
+	{
+		return true;
+	}
+
+	if (state != ASSET_STATE_QUEUED)
+	{
+		return false;
+	}
+
+	//	Queued requests are only taken out of the queues under the lock, so it is still in its queue
+	unsigned int priority = request.priority;
+	unsigned int count = m_queueCounts[priority];
+	for (unsigned int i = 0; i < count; i++)
+	{
+		unsigned int slot = (m_queueBegins[priority] + i) % MAX_ASSET_REQUESTS;
+		if (m_queues[priority][slot] != _request)
+		{
+			continue;
+		}
+
+		for (unsigned int j = i; j + 1 < count; j++)
+		{
+			m_queues[priority][(m_queueBegins[priority] + j) % MAX_ASSET_REQUESTS] = m_queues[priority][(m_queueBegins[priority] + j + 1) % MAX_ASSET_REQUESTS];
+		}
+		m_queueCounts[priority]--;
+		break;
+	}
+
+	request.state.store(ASSET_STATE_CANCELLED);
+	m_pendingRequests.fetch_sub(1);
+
+	return true;
+}
+
+/*
+	Give the request back once it is loaded, failed or cancelled, its index may be returned by Load again afterwards
+	Releasing does not unload anything, the asset stays in the mapped package
+	Fails while the request is queued or loading
+*/
+bool AssetLoaderClass::Release(unsigned int _request)
+{
+	if (!m_requests || _request >= MAX_ASSET_REQUESTS)
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	AssetRequest& request = m_requests[_request];
+	unsigned int state = request.state.load(std::memory_order_acquire);
+	if (!request.used || (state != ASSET_STATE_LOADED && state != ASSET_STATE_FAILED && state != ASSET_STATE_CANCELLED))
+	{
+		return false;
+	}
+
+	request.used = false;
+	request.nextFree = m_firstFreeRequest;
+	m_firstFreeRequest = _request;
+
+	return true;
+}
+
+/*
+	Block until every queued request finished, including the callbacks
+*/
+void AssetLoaderClass::WaitForAll()
+{
+	while (m_pendingRequests.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/*
+	ASSET_STATE_*, a load which is being cancelled already counts as cancelled
+*/
+unsigned int AssetLoaderClass::GetState(unsigned int _request) const
+{
+	if (!m_requests || _request >= MAX_ASSET_REQUESTS)
+	{
+		return ASSET_STATE_FAILED;
+	}
+
+	unsigned int state = m_requests[_request].state.load(std::memory_order_acquire);
+
+	return state == ASSET_STATE_CANCELLING ? ASSET_STATE_CANCELLED : state;
+}
+
+/*
+	The asset inside its package once the request is loaded, nullptr before
+*/
+const AssetHeader* AssetLoaderClass::GetAsset(unsigned int _request) const
+{
+	if (GetState(_request) != ASSET_STATE_LOADED)
+	{
+		return nullptr;
+	}
+
+	const AssetRequest& request = m_requests[_request];
+
+	return request.package->GetAsset(*request.entry);
+}
+
+/*
+	Requests which are queued or loading
+*/
+unsigned int AssetLoaderClass::GetPendingCount() const
+{
+	return m_pendingRequests.load();
+}
+
+/*
+	Size of every asset loaded so far
+*/
+unsigned long long AssetLoaderClass::GetLoadedBytes() const
+{
+	return m_loadedBytes.load();
+}
+
+/*
+	Background job, _data is the AssetLoaderClass
+*/
+void AssetLoaderClass::LoadJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	static_cast<AssetLoaderClass*>(_data)->LoadQueuedRequests();
+}
+
+/*
+	Load queued requests until the queues are empty
+	The job ends with the queues empty, so a request queued afterwards always starts a new job
+*/
+void AssetLoaderClass::LoadQueuedRequests()
+{
+	PROFILE_SCOPE("AssetLoaderClass::LoadQueuedRequests");
+
+	for (unsigned int request = PopRequest(); request != INVALID_ASSET_REQUEST; request = PopRequest())
+	{
+		LoadRequest(request);
+	}
+}
+
+/*
+	Take the oldest request of the highest priority and mark it as loading
+	If every queue is empty the calling job counts as finished (under the same lock Load checks the running jobs with)
+*/
+unsigned int AssetLoaderClass::PopRequest()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	for (unsigned int priority = 0; priority < ASSET_PRIORITY_COUNT; priority++)
+	{
+		if (m_queueCounts[priority] > 0)
+		{
+			unsigned int request = m_queues[priority][m_queueBegins[priority]];
+			m_queueBegins[priority] = (m_queueBegins[priority] + 1) % MAX_ASSET_REQUESTS;
+			m_queueCounts[priority]--;
+
+			m_requests[request].state.store(ASSET_STATE_LOADING, std::memory_order_release);
+
+			return request;
+		}
+	}
+
+	m_runningJobs--;
+
+	return INVALID_ASSET_REQUEST;
+}
+
+/*
+	Ask the operating system to read the whole asset ahead, then hash it block by block
+	Hashing touches every page, so the asset is in memory afterwards and the first use does not fault
+	Between two blocks look whether the load got cancelled
+	The state only becomes loaded (or failed) if Cancel did not get there first
+*/
+void AssetLoaderClass::LoadRequest(unsigned int _request)
+{
+	PROFILE_SCOPE("AssetLoaderClass::LoadRequest");
+
+	AssetRequest& request = m_requests[_request];
+	const AssetPackageEntry& entry = *request.entry;
+	const AssetHeader* asset = request.package->GetAsset(entry);
+	const unsigned char* data = reinterpret_cast<const unsigned char*>(asset);
+	size_t size = static_cast<size_t>(entry.size);
+	AssetCallback callback = request.callback;
+	void* userData = request.userData;
+
+	request.package->GetFile().Prefetch(static_cast<size_t>(entry.offset), size);
+
+	bool cancelled = false;
+	unsigned long long hash = 0;
+	for (size_t offset = 0; offset < size; offset += ASSET_HASH_BLOCK_SIZE)
+	{
+		if (request.state.load(std::memory_order_acquire) == ASSET_STATE_CANCELLING)
+		{
+			cancelled = true;
+			break;
+		}
+
+		size_t blockSize = size - offset < ASSET_HASH_BLOCK_SIZE ? size - offset : ASSET_HASH_BLOCK_SIZE;
+		hash = HashClass::Combine(hash, HashClass::Hash(data + offset, blockSize));
+	}
+
+	unsigned int state = hash == entry.hash && asset->size == entry.size ? ASSET_STATE_LOADED : ASSET_STATE_FAILED;
+	unsigned int expected = ASSET_STATE_LOADING;
+	if (cancelled || !request.state.compare_exchange_strong(expected, state))
+	{
+		request.state.store(ASSET_STATE_CANCELLED);
+		m_pendingRequests.fetch_sub(1);
+		return;
+	}
+
+	if (state == ASSET_STATE_LOADED)
+	{
+		m_loadedBytes.fetch_add(size);
+	}
+
+	if (callback)
+	{
+		callback(_request, state, state == ASSET_STATE_LOADED ? asset : nullptr, userData);
+	}
+
+	m_pendingRequests.fetch_sub(1);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include <mutex>
+#include "AssetPackageClass.h"
+#include "JobSystemClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_ASSET_PACKAGES = 8;
+const unsigned int MAX_ASSET_REQUESTS = 4096;			// requests which are not released yet
+const unsigned int MAX_ASSET_LOAD_JOBS = 2;				// background jobs loading at the same time
+const unsigned int INVALID_ASSET_REQUEST = 0xFFFFFFFF;
+
+//	Queued requests of a higher priority are always loaded first
+const unsigned int ASSET_PRIORITY_HIGH = 0;
+const unsigned int ASSET_PRIORITY_NORMAL = 1;
+const unsigned int ASSET_PRIORITY_LOW = 2;
+const unsigned int ASSET_PRIORITY_COUNT = 3;
+
+const unsigned int ASSET_STATE_QUEUED = 0;
+const unsigned int ASSET_STATE_LOADING = 1;
+const unsigned int ASSET_STATE_LOADED = 2;
+const unsigned int ASSET_STATE_FAILED = 3;			// the asset is damaged (hash mismatch)
+const unsigned int ASSET_STATE_CANCELLED = 4;
+#pragma endregion
+
+/*
+	Called on the background job which finished the request, with ASSET_STATE_LOADED or ASSET_STATE_FAILED
+	_asset is nullptr if the load failed, a cancelled request never calls back
+*/
+typedef void (*AssetCallback)(unsigned int _request, unsigned int _state, const AssetHeader* _asset, void* _userData);
+
+/*
+	Streams assets out of memory-mapped packages without ever blocking the calling thread
+	Load only queues a request, background jobs of the jobsystem take the queued requests by priority and load them:
+	the range of the asset is prefetched by the operating system, then hashed block by block, which pages it in and checks it
+	The loaded asset is used in place inside the mapping (zero-copy), it stays valid until the package is closed in Shutdown
+	A request can be cancelled until it is loaded, a request which is already loading stops after its current block
+	Load, Cancel, GetState and Release may be called from any thread, packages are opened before anything is loaded
+	Without workers (or if the background queue is full) the request is loaded right away on the calling thread
+*/
+class AssetLoaderClass
+{
+public:
+	AssetLoaderClass();
+	~AssetLoaderClass();
+
+	bool Initialize(JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	bool OpenPackage(const char* _path);
+
+	unsigned int Load(unsigned long long _assetId, unsigned int _priority, AssetCallback _callback, void* _userData);
+	bool Cancel(unsigned int _request);
+	bool Release(unsigned int _request);
+	void WaitForAll();
+
+	unsigned int GetState(unsigned int _request) const;
+	const AssetHeader* GetAsset(unsigned int _request) const;
+	unsigned int GetPendingCount() const;
+	unsigned long long GetLoadedBytes() const;
+
+private:
+	struct AssetRequest
+	{
+		const AssetPackageClass* package;
+		const AssetPackageEntry* entry;
+		AssetCallback callback;
+		void* userData;
+		unsigned int priority;
+		unsigned int nextFree;
+		bool used;
+		std::atomic<unsigned int> state;
+	};
+
+	JobSystemClass* m_jobSystem;
+
+	AssetPackageClass m_packages[MAX_ASSET_PACKAGES];
+	unsigned int m_packageCount;
+
+	AssetRequest* m_requests;
+	unsigned int m_firstFreeRequest;
+
+	//	One ring of request indices per priority, guarded by the mutex together with the free list and the job count
+	unsigned int m_queues[ASSET_PRIORITY_COUNT][MAX_ASSET_REQUESTS];
+	unsigned int m_queueBegins[ASSET_PRIORITY_COUNT];
+	unsigned int m_queueCounts[ASSET_PRIORITY_COUNT];
+	unsigned int m_runningJobs;
+	std::mutex m_mutex;
+
+	std::atomic<unsigned int> m_pendingRequests;
+	std::atomic<unsigned long long> m_loadedBytes;
+
+	static void LoadJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	void LoadQueuedRequests();
+	unsigned int PopRequest();
+	void LoadRequest(unsigned int _request);
+};
\ No newline at end of file
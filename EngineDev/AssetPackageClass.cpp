@@ -0,0 +1,265 @@
+#include "AssetPackageClass.h"
+#include "HashClass.h"
+#include <cstdio>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned char PADDING[ASSET_ALIGNMENT] = {};
+#pragma endregion
+
+/*
+	Constructor
+*/
+AssetPackageClass::AssetPackageClass()
+{
+	m_entries = nullptr;
+	m_entryCount = 0;
+}
+
+/*
+	Destructor
+*/
+AssetPackageClass::~AssetPackageClass()
+{
+
+}
+
+/*
+	Map the file and check the header: magic, format version, size
+	Check the entry table against its hash, every asset has to lie aligned inside the file and be big enough for its header
+	Nothing is read beyond the header and the table
+*/
+bool AssetPackageClass::Open(const char* _path)
+{
+	Close();
+
+	if (!m_file.Open(_path))
+	{
+		return false;
+	}
+
+	const unsigned char* data = static_cast<const unsigned char*>(m_file.GetData());
+	size_t fileSize = m_file.GetSize();
+
+	if (fileSize < sizeof(AssetPackageHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const AssetPackageHeader* header = reinterpret_cast<const AssetPackageHeader*>(data);
+	if (header->magic != ASSET_PACKAGE_MAGIC || header->formatVersion != ASSET_PACKAGE_FORMAT_VERSION || header->fileSize != fileSize)
+	{
+		Close();
+		return false;
+	}
+
+	size_t tableSize = static_cast<size_t>(header->entryCount) * sizeof(AssetPackageEntry);
+	if (header->entryCount > 0xFFFFFFFF || tableSize > fileSize - sizeof(AssetPackageHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const AssetPackageEntry* entries = reinterpret_cast<const AssetPackageEntry*>(data + sizeof(AssetPackageHeader));
+	if (HashClass::Hash(entries, tableSize) != header->entryHash)
+	{
+		Close();
+		return false;
+	}
+
+	for (unsigned long long i = 0; i < header->entryCount; i++)
+	{
+		const AssetPackageEntry& entry = entries[i];
+		if (entry.offset > fileSize || entry.size > fileSize - entry.offset || entry.size < sizeof(AssetHeader) ||
+			entry.offset % ASSET_ALIGNMENT != 0 || (i > 0 && entries[i - 1].id >= entry.id))
+		{
+			Close();
+			return false;
+		}
+	}
+
+	m_entries = entries;
+	m_entryCount = static_cast<unsigned int>(header->entryCount);
+
+	return true;
+}
+
+void AssetPackageClass::Close()
+{
+	m_file.Close();
+	m_entries = nullptr;
+	m_entryCount = 0;
+}
+
+bool AssetPackageClass::IsOpen() const
+{
+	return m_file.IsOpen();
+}
+
+/*
+	Binary search for the id, nullptr if the package does not contain it
+*/
+const AssetPackageEntry* AssetPackageClass::Find(unsigned long long _id) const
+{
+	unsigned int begin = 0;
+	unsigned int end = m_entryCount;
+
+	while (begin < end)
+	{
+		unsigned int middle = begin + (end - begin) / 2;
+
+		if (m_entries[middle].id < _id)
+		{
+			begin = middle + 1;
+		}
+		else
+		{
+			end = middle;
+		}
+	}
+
+	if (begin == m_entryCount || m_entries[begin].id != _id)
+	{
+		return nullptr;
+	}
+
+	return &m_entries[begin];
+}
+
+unsigned int AssetPackageClass::GetEntryCount() const
+{
+	return m_entryCount;
+}
+
+const AssetPackageEntry& AssetPackageClass::GetEntry(unsigned int _entry) const
+{
+	return m_entries[_entry];
+}
+
+/*
+	The asset inside the mapped file, its pages are only read from disk when it is touched
+*/
+const AssetHeader* AssetPackageClass::GetAsset(const AssetPackageEntry& _entry) const
+{
+	return reinterpret_cast<const AssetHeader*>(static_cast<const unsigned char*>(m_file.GetData()) + _entry.offset);
+}
+
+const MappedFileClass& AssetPackageClass::GetFile() const
+{
+	return m_file;
+}
+
+/*
+	Assets are identified by the hash of their name, e.g. the path they were cooked from
+*/
+unsigned long long AssetPackageClass::GetAssetId(const char* _name)
+{
+	return HashClass::Hash(_name, strlen(_name));
+}
+
+/*
+	Combined hashes of the ASSET_HASH_BLOCK_SIZE blocks of the asset
+	AssetLoaderClass hashes the same blocks one after another and can stop between them
+*/
+unsigned long long AssetPackageClass::HashAsset(const void* _data, size_t _size)
+{
+	const unsigned char* data = static_cast<const unsigned char*>(_data);
+	unsigned long long hash = 0;
+
+	for (size_t offset = 0; offset < _size; offset += ASSET_HASH_BLOCK_SIZE)
+	{
+		size_t blockSize = _size - offset < ASSET_HASH_BLOCK_SIZE ? _size - offset : ASSET_HASH_BLOCK_SIZE;
+		hash = HashClass::Combine(hash, HashClass::Hash(data + offset, blockSize));
+	}
+
+	return hash;
+}
+
+/*
+	Write the assets (sorted by id, no id twice) into a temporary file next to _path, then replace _path with it
+	Every asset has to start with an AssetHeader whose size matches, the type and version of the entries are taken from it
+*/
+bool AssetPackageClass::Write(const char* _path, const AssetPackageInput* _assets, unsigned int _assetCount)
+{
+	for (unsigned int i = 0; i < _assetCount; i++)
+	{
+		if (_assets[i].size < sizeof(AssetHeader) || static_cast<const AssetHeader*>(_assets[i].data)->size != _assets[i].size ||
+			(i > 0 && _assets[i - 1].id >= _assets[i].id))
+		{
+			return false;
+		}
+	}
+
+	char temporaryPath[512];
+	if (snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", _path) >= static_cast<int>(sizeof(temporaryPath)))
+	{
+		return false;
+	}
+
+	FILE* file = fopen(temporaryPath, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	AssetPackageEntry* entries = new AssetPackageEntry[_assetCount > 0 ? _assetCount : 1];
+	if (!entries)
+	{
+		fclose(file);
+		return false;
+	}
+
+	//	Lay out the assets behind the table
+	unsigned long long offset = sizeof(AssetPackageHeader) + static_cast<unsigned long long>(_assetCount) * sizeof(AssetPackageEntry);
+	for (unsigned int i = 0; i < _assetCount; i++)
+	{
+		offset = (offset + ASSET_ALIGNMENT - 1) & ~static_cast<unsigned long long>(ASSET_ALIGNMENT - 1);
+
+		const AssetHeader* asset = static_cast<const AssetHeader*>(_assets[i].data);
+		entries[i].id = _assets[i].id;
+		entries[i].offset = offset;
+		entries[i].size = _assets[i].size;
+		entries[i].hash = HashAsset(_assets[i].data, _assets[i].size);
+		entries[i].type = asset->type;
+		entries[i].version = asset->version;
+
+		offset += _assets[i].size;
+	}
+
+	AssetPackageHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ASSET_PACKAGE_MAGIC;
+	header.formatVersion = ASSET_PACKAGE_FORMAT_VERSION;
+	header.entryCount = _assetCount;
+	header.fileSize = offset;
+	header.entryHash = HashClass::Hash(entries, static_cast<size_t>(_assetCount) * sizeof(AssetPackageEntry));
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && (_assetCount == 0 || fwrite(entries, sizeof(AssetPackageEntry), _assetCount, file) == _assetCount);
+
+	unsigned long long position = sizeof(AssetPackageHeader) + static_cast<unsigned long long>(_assetCount) * sizeof(AssetPackageEntry);
+	for (unsigned int i = 0; written && i < _assetCount; i++)
+	{
+		size_t padding = static_cast<size_t>(entries[i].offset - position);
+		written = (padding == 0 || fwrite(PADDING, 1, padding, file) == padding) && fwrite(_assets[i].data, 1, _assets[i].size, file) == _assets[i].size;
+		position = entries[i].offset + entries[i].size;
+	}
+
+	delete[] entries;
+
+	if (fclose(file) != 0 || !written)
+	{
+		remove(temporaryPath);
+		return false;
+	}
+
+	//	rename does not replace existing files on every platform
+	remove(_path);
+	if (rename(temporaryPath, _path) != 0)
+	{
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MappedFileClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int ASSET_PACKAGE_MAGIC = 0x50415345;		// "ESAP"
+const unsigned int ASSET_PACKAGE_FORMAT_VERSION = 1;		// bump whenever the file layout or AssetHeader changes
+const size_t ASSET_ALIGNMENT = 64;							// every asset starts on a cache line, so its header and arrays can be used in place
+const size_t ASSET_HASH_BLOCK_SIZE = 256 * 1024;			// assets are hashed in blocks, so a load can stop between two blocks
+
+const unsigned int ASSET_TYPE_RAW = 0;
+#pragma endregion
+
+struct AssetPackageHeader
+{
+	unsigned int magic;
+	unsigned int formatVersion;
+	unsigned long long entryCount;
+	unsigned long long fileSize;
+	unsigned long long entryHash;			// hash over the entry table
+};
+
+struct AssetPackageEntry
+{
+	unsigned long long id;			// AssetPackageClass::GetAssetId of the name
+	unsigned long long offset;		// from the start of the file, aligned to ASSET_ALIGNMENT
+	unsigned long long size;
+	unsigned long long hash;		// AssetPackageClass::HashAsset of the data
+	unsigned int type;
+	unsigned int version;
+};
+
+/*
+	Every asset starts with this header and is used right where it lies in the mapped package, nothing is copied or fixed up
+	Arrays inside the asset are found by their offset from the start of the header (GetAssetArray), never by pointers
+	The types of an asset only contain fixed size integers and floats, stored little endian
+*/
+struct AssetHeader
+{
+	unsigned int type;
+	unsigned int version;
+	unsigned long long size;		// of the whole asset, header included
+};
+
+/*
+	An asset to be written, data starts with its AssetHeader
+*/
+struct AssetPackageInput
+{
+	unsigned long long id;
+	const void* data;
+	size_t size;
+};
+
+/*
+	The array of type _Type at _offset bytes from the start of the asset
+*/
+template<typename _Type>
+const _Type* GetAssetArray(const AssetHeader* _asset, unsigned long long _offset)
+{
+	return reinterpret_cast<const _Type*>(reinterpret_cast<const unsigned char*>(_asset) + _offset);
+}
+
+/*
+	Many assets in one versioned file: header, entry table sorted by id, aligned assets
+	The file is memory-mapped, finding an asset is a binary search and the asset is used in place
+	Open only checks the header and the entry table, the assets themselves are paged in and checked when they are loaded (AssetLoaderClass)
+	A file of another format or with a broken entry table is rejected as a whole
+*/
+class AssetPackageClass
+{
+public:
+	AssetPackageClass();
+	~AssetPackageClass();
+
+	bool Open(const char* _path);
+	void Close();
+
+	bool IsOpen() const;
+	const AssetPackageEntry* Find(unsigned long long _id) const;
+	unsigned int GetEntryCount() const;
+	const AssetPackageEntry& GetEntry(unsigned int _entry) const;
+	const AssetHeader* GetAsset(const AssetPackageEntry& _entry) const;
+	const MappedFileClass& GetFile() const;
+
+	static unsigned long long GetAssetId(const char* _name);
+	static unsigned long long HashAsset(const void* _data, size_t _size);
+	static bool Write(const char* _path, const AssetPackageInput* _assets, unsigned int _assetCount);
+
+private:
+	MappedFileClass m_file;
+	const AssetPackageEntry* m_entries;
+	unsigned int m_entryCount;
+};
\ No newline at end of file
@@ -0,0 +1,982 @@
+#include "BvhClass.h"
+#include "ProfilerClass.h"
+#include "SimdClass.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdlib>
+
+#pragma region Globals
+static const size_t BVH_ARRAY_ALIGNMENT = 64;
+static const float BVH_MIN_DIRECTION = 1e-30f;		// smaller ray direction components are replaced, so the slab test never computes 0 * infinity
+#pragma endregion
+
+/*
+	Half the surface area of a box, the SAH only compares areas
+*/
+static float GetHalfArea(const Aabb& _box)
+{
+	Vector3 size = MathClass::Subtract(_box.maximum, _box.minimum);
+
+	return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+static Aabb GetEmptyBox()
+{
+	Aabb box = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+
+	return box;
+}
+
+static void GrowBox(Aabb& _box, const Vector3& _minimum, const Vector3& _maximum)
+{
+	_box.minimum.x = _minimum.x < _box.minimum.x ? _minimum.x : _box.minimum.x;
+	_box.minimum.y = _minimum.y < _box.minimum.y ? _minimum.y : _box.minimum.y;
+	_box.minimum.z = _minimum.z < _box.minimum.z ? _minimum.z : _box.minimum.z;
+	_box.maximum.x = _maximum.x > _box.maximum.x ? _maximum.x : _box.maximum.x;
+	_box.maximum.y = _maximum.y > _box.maximum.y ? _maximum.y : _box.maximum.y;
+	_box.maximum.z = _maximum.z > _box.maximum.z ? _maximum.z : _box.maximum.z;
+}
+
+static float GetComponent(const Vector3& _vector, int _axis)
+{
+	return _axis == 0 ? _vector.x : (_axis == 1 ? _vector.y : _vector.z);
+}
+
+/*
+	Bin of a center along one axis, the scale is slightly less than bins / size, so the largest center still falls into the last bin
+*/
+static unsigned int GetBin(float _center, float _minimum, float _scale)
+{
+	unsigned int bin = static_cast<unsigned int>((_center - _minimum) * _scale);
+
+	return bin < BVH_BINS ? bin : BVH_BINS - 1;
+}
+
+/*
+	Bit i is set if slot i of the node holds a child
+*/
+static int GetChildMask(const BvhNode& _node)
+{
+	return (_node.children[0] != INVALID_BVH_NODE ? 1 : 0) | (_node.children[1] != INVALID_BVH_NODE ? 2 : 0) |
+		(_node.children[2] != INVALID_BVH_NODE ? 4 : 0) | (_node.children[3] != INVALID_BVH_NODE ? 8 : 0);
+}
+
+/*
+	Constructor
+*/
+BvhClass::BvhClass()
+{
+	m_jobSystem = nullptr;
+	m_memory = nullptr;
+	m_maxPrimitives = 0;
+	m_maxNodes = 0;
+	m_minimumX = nullptr;
+	m_minimumY = nullptr;
+	m_minimumZ = nullptr;
+	m_maximumX = nullptr;
+	m_maximumY = nullptr;
+	m_maximumZ = nullptr;
+	m_primitives = nullptr;
+	m_slots = nullptr;
+	m_primitiveCount = 0;
+	m_nodes = nullptr;
+	m_nodeRanges = nullptr;
+	m_nodeCount = 0;
+	m_topNodes = nullptr;
+	m_topNodeCount = 0;
+	m_refitRoots = nullptr;
+	m_refitRootCount = 0;
+	m_buildPrimitives = nullptr;
+	m_buildNodes = nullptr;
+	m_buildNodeCount.store(0);
+	m_buildCounter.store(0);
+}
+
+/*
+	Destructor
+*/
+BvhClass::~BvhClass()
+{
+
+}
+
+/*
+	Allocate every array once in one block, each array starts on a cache line
+	The binary tree has at most 2n - 1 nodes, every node of BVH_WIDTH children replaces at least one of its inner nodes
+*/
+bool BvhClass::Initialize(unsigned int _maxPrimitives, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	if (_maxPrimitives == 0 || _maxPrimitives >= BVH_LEAF)
+	{
+		return false;
+	}
+
+	m_maxPrimitives = _maxPrimitives;
+	m_maxNodes = _maxPrimitives;
+
+	size_t sizes[] = {
+		m_maxPrimitives * sizeof(float), m_maxPrimitives * sizeof(float), m_maxPrimitives * sizeof(float),
+		m_maxPrimitives * sizeof(float), m_maxPrimitives * sizeof(float), m_maxPrimitives * sizeof(float),
+		m_maxPrimitives * sizeof(unsigned int), m_maxPrimitives * sizeof(unsigned int),
+		m_maxNodes * sizeof(BvhNode), m_maxNodes * sizeof(NodeRange), m_maxNodes * sizeof(unsigned int), m_maxNodes * sizeof(unsigned int),
+		m_maxPrimitives * sizeof(BuildPrimitive), (2 * static_cast<size_t>(m_maxPrimitives) - 1) * sizeof(BuildNode) };
+	const unsigned int arrayCount = sizeof(sizes) / sizeof(sizes[0]);
+
+	size_t totalSize = 0;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		totalSize += (sizes[i] + BVH_ARRAY_ALIGNMENT - 1) & ~(BVH_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_memory = static_cast<unsigned char*>(malloc(totalSize + BVH_ARRAY_ALIGNMENT));
+	if (!m_memory)
+	{
+		return false;
+	}
+
+	void* arrays[arrayCount];
+	size_t offset = (BVH_ARRAY_ALIGNMENT - reinterpret_cast<size_t>(m_memory) % BVH_ARRAY_ALIGNMENT) % BVH_ARRAY_ALIGNMENT;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		arrays[i] = m_memory + offset;
+		offset += (sizes[i] + BVH_ARRAY_ALIGNMENT - 1) & ~(BVH_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_minimumX = static_cast<float*>(arrays[0]);
+	m_minimumY = static_cast<float*>(arrays[1]);
+	m_minimumZ = static_cast<float*>(arrays[2]);
+	m_maximumX = static_cast<float*>(arrays[3]);
+	m_maximumY = static_cast<float*>(arrays[4]);
+	m_maximumZ = static_cast<float*>(arrays[5]);
+	m_primitives = static_cast<unsigned int*>(arrays[6]);
+	m_slots = static_cast<unsigned int*>(arrays[7]);
+	m_nodes = static_cast<BvhNode*>(arrays[8]);
+	m_nodeRanges = static_cast<NodeRange*>(arrays[9]);
+	m_topNodes = static_cast<unsigned int*>(arrays[10]);
+	m_refitRoots = static_cast<unsigned int*>(arrays[11]);
+	m_buildPrimitives = static_cast<BuildPrimitive*>(arrays[12]);
+	m_buildNodes = static_cast<BuildNode*>(arrays[13]);
+
+	m_primitiveCount = 0;
+	m_nodeCount = 0;
+	m_topNodeCount = 0;
+	m_refitRootCount = 0;
+
+	return true;
+}
+
+void BvhClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_primitiveCount = 0;
+	m_nodeCount = 0;
+	m_topNodeCount = 0;
+	m_refitRootCount = 0;
+	m_maxPrimitives = 0;
+	m_maxNodes = 0;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Build the binary tree from the root down, the big subtrees on jobs, and wait until every job is done
+	Collapse it into the nodes of BVH_WIDTH children, then copy the boxes of the primitives in leaf order
+	Replaces the tree of the last Build, the boxes are not needed afterwards
+*/
+bool BvhClass::Build(const BoundingBoxArrays& _boxes, unsigned int _count)
+{
+	PROFILE_SCOPE("BvhClass::Build");
+
+	if (_count > m_maxPrimitives)
+	{
+		return false;
+	}
+
+	m_primitiveCount = _count;
+	m_nodeCount = 0;
+	m_topNodeCount = 0;
+	m_refitRootCount = 0;
+
+	if (_count == 0)
+	{
+		return true;
+	}
+
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		BuildPrimitive& buildPrimitive = m_buildPrimitives[i];
+		Vector3 extent = { _boxes.extentX[i], _boxes.extentY[i], _boxes.extentZ[i] };
+
+		buildPrimitive.center = { _boxes.centerX[i], _boxes.centerY[i], _boxes.centerZ[i] };
+		buildPrimitive.box.minimum = MathClass::Subtract(buildPrimitive.center, extent);
+		buildPrimitive.box.maximum = MathClass::Add(buildPrimitive.center, extent);
+		buildPrimitive.primitive = i;
+	}
+
+	m_buildNodeCount.store(1);
+	m_buildCounter.store(0);
+
+	BuildNode& root = m_buildNodes[0];
+	root.first = 0;
+	root.count = _count;
+	root.depth = 0;
+
+	BuildRange(0);
+	if (m_jobSystem)
+	{
+		m_jobSystem->WaitForCounter(&m_buildCounter);
+	}
+
+	Collapse(0);
+
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		const BuildPrimitive& buildPrimitive = m_buildPrimitives[i];
+		m_minimumX[i] = buildPrimitive.box.minimum.x;
+		m_minimumY[i] = buildPrimitive.box.minimum.y;
+		m_minimumZ[i] = buildPrimitive.box.minimum.z;
+		m_maximumX[i] = buildPrimitive.box.maximum.x;
+		m_maximumY[i] = buildPrimitive.box.maximum.y;
+		m_maximumZ[i] = buildPrimitive.box.maximum.z;
+		m_primitives[i] = buildPrimitive.primitive;
+		m_slots[buildPrimitive.primitive] = i;
+	}
+
+	return true;
+}
+
+/*
+	Build the subtree of a node whose range of primitives is set
+	Compute the bounds of the boxes and of their centers, leaves stop here
+	Split the range, the second half goes to a job of its own if it is big enough and the jobsystem takes it
+*/
+void BvhClass::BuildRange(unsigned int _node)
+{
+	BuildNode& node = m_buildNodes[_node];
+
+	node.bounds = GetEmptyBox();
+	Aabb centerBounds = GetEmptyBox();
+	for (unsigned int i = node.first; i < node.first + node.count; i++)
+	{
+		const BuildPrimitive& buildPrimitive = m_buildPrimitives[i];
+		GrowBox(node.bounds, buildPrimitive.box.minimum, buildPrimitive.box.maximum);
+		GrowBox(centerBounds, buildPrimitive.center, buildPrimitive.center);
+	}
+
+	if (node.count <= BVH_MAX_LEAF_SIZE)
+	{
+		node.left = INVALID_BVH_NODE;
+		return;
+	}
+
+	unsigned int middle = SplitRange(node, centerBounds);
+
+	unsigned int left = m_buildNodeCount.fetch_add(2);
+	BuildNode& leftNode = m_buildNodes[left];
+	leftNode.first = node.first;
+	leftNode.count = middle - node.first;
+	leftNode.depth = node.depth + 1;
+
+	BuildNode& rightNode = m_buildNodes[left + 1];
+	rightNode.first = middle;
+	rightNode.count = node.first + node.count - middle;
+	rightNode.depth = node.depth + 1;
+
+	node.left = left;
+
+	bool queued = rightNode.count >= BVH_JOB_PRIMITIVES && m_jobSystem && m_jobSystem->Run(BuildJob, this, left + 1, left + 2, &m_buildCounter);
+	if (!queued)
+	{
+		BuildRange(left + 1);
+	}
+
+	BuildRange(left);
+}
+
+/*
+	Reorder the range of the node into two halves and return where the second one starts
+	Sort the centers into BVH_BINS bins per axis, sweep over the bins from both sides and take the border with the lowest SAH cost
+	Deeper than BVH_SAH_DEPTH, or if every center is in the same place, split at the median of the longest axis instead
+*/
+unsigned int BvhClass::SplitRange(const BuildNode& _node, const Aabb& _centerBounds)
+{
+	float centerMinimum[3] = { _centerBounds.minimum.x, _centerBounds.minimum.y, _centerBounds.minimum.z };
+	float centerSize[3] = { _centerBounds.maximum.x - _centerBounds.minimum.x, _centerBounds.maximum.y - _centerBounds.minimum.y, _centerBounds.maximum.z - _centerBounds.minimum.z };
+
+	BuildPrimitive* begin = m_buildPrimitives + _node.first;
+	BuildPrimitive* end = begin + _node.count;
+
+	int longestAxis = centerSize[0] >= centerSize[1] ? (centerSize[0] >= centerSize[2] ? 0 : 2) : (centerSize[1] >= centerSize[2] ? 1 : 2);
+	if (centerSize[longestAxis] <= 0.0f)
+	{
+		return _node.first + _node.count / 2;
+	}
+
+	int bestAxis = -1;
+	unsigned int bestBin = 0;
+	float bestCost = FLT_MAX;
+	float binScales[3] = { 0.0f, 0.0f, 0.0f };
+
+	if (_node.depth < BVH_SAH_DEPTH)
+	{
+		unsigned int binCounts[3][BVH_BINS] = {};
+		Aabb binBounds[3][BVH_BINS];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			binScales[axis] = centerSize[axis] > 0.0f ? static_cast<float>(BVH_BINS) * (1.0f - 1e-5f) / centerSize[axis] : 0.0f;
+			for (unsigned int bin = 0; bin < BVH_BINS; bin++)
+			{
+				binBounds[axis][bin] = GetEmptyBox();
+			}
+		}
+
+		for (BuildPrimitive* primitive = begin; primitive != end; primitive++)
+		{
+			for (int axis = 0; axis < 3; axis++)
+			{
+				unsigned int bin = GetBin(GetComponent(primitive->center, axis), centerMinimum[axis], binScales[axis]);
+
+				binCounts[axis][bin]++;
+				GrowBox(binBounds[axis][bin], primitive->box.minimum, primitive->box.maximum);
+			}
+		}
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			if (centerSize[axis] <= 0.0f)
+			{
+				continue;
+			}
+
+			//	Cost of everything right of a border, border i lies between bin i - 1 and bin i
+			float rightCosts[BVH_BINS];
+			Aabb rightBounds = GetEmptyBox();
+			unsigned int rightCount = 0;
+			for (unsigned int bin = BVH_BINS - 1; bin > 0; bin--)
+			{
+				GrowBox(rightBounds, binBounds[axis][bin].minimum, binBounds[axis][bin].maximum);
+				rightCount += binCounts[axis][bin];
+				rightCosts[bin] = rightCount > 0 ? GetHalfArea(rightBounds) * static_cast<float>(rightCount) : 0.0f;
+			}
+
+			Aabb leftBounds = GetEmptyBox();
+			unsigned int leftCount = 0;
+			for (unsigned int bin = 1; bin < BVH_BINS; bin++)
+			{
+				GrowBox(leftBounds, binBounds[axis][bin - 1].minimum, binBounds[axis][bin - 1].maximum);
+				leftCount += binCounts[axis][bin - 1];
+				if (leftCount == 0 || leftCount == _node.count)
+				{
+					continue;
+				}
+
+				float cost = GetHalfArea(leftBounds) * static_cast<float>(leftCount) + rightCosts[bin];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestAxis = axis;
+					bestBin = bin;
+				}
+			}
+		}
+	}
+
+	if (bestAxis < 0)
+	{
+		BuildPrimitive* middle = begin + _node.count / 2;
+		std::nth_element(begin, middle, end, [longestAxis](const BuildPrimitive& _a, const BuildPrimitive& _b)
+		{
+			return GetComponent(_a.center, longestAxis) < GetComponent(_b.center, longestAxis);
+		});
+
+		return _node.first + _node.count / 2;
+	}
+
+	float axisMinimum = centerMinimum[bestAxis];
+	float axisScale = binScales[bestAxis];
+	BuildPrimitive* middle = std::partition(begin, end, [bestAxis, axisMinimum, axisScale, bestBin](const BuildPrimitive& _primitive)
+	{
+		return GetBin(GetComponent(_primitive.center, bestAxis), axisMinimum, axisScale) < bestBin;
+	});
+
+	return _node.first + static_cast<unsigned int>(middle - begin);
+}
+
+void BvhClass::BuildJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	static_cast<BvhClass*>(_data)->BuildRange(_begin);
+}
+
+/*
+	Turn the binary subtree into nodes of BVH_WIDTH children, depth first, and return the index of its root
+	Start with the two children of the binary node, open the inner child with the largest surface until the node is full
+	Nodes covering more than BVH_JOB_PRIMITIVES are refit on the calling thread, their smaller inner children become the roots of refit jobs
+*/
+unsigned int BvhClass::Collapse(unsigned int _buildNode)
+{
+	const BuildNode& buildNode = m_buildNodes[_buildNode];
+	unsigned int nodeIndex = m_nodeCount;
+	m_nodeCount++;
+
+	bool topNode = buildNode.count > BVH_JOB_PRIMITIVES;
+	if (topNode)
+	{
+		m_topNodes[m_topNodeCount] = nodeIndex;
+		m_topNodeCount++;
+	}
+
+	unsigned int slots[BVH_WIDTH];
+	unsigned int slotCount = 0;
+	if (buildNode.left == INVALID_BVH_NODE)
+	{
+		slots[slotCount++] = _buildNode;
+	}
+	else
+	{
+		slots[slotCount++] = buildNode.left;
+		slots[slotCount++] = buildNode.left + 1;
+	}
+
+	while (slotCount < BVH_WIDTH)
+	{
+		int largestSlot = -1;
+		float largestArea = -1.0f;
+		for (unsigned int i = 0; i < slotCount; i++)
+		{
+			const BuildNode& child = m_buildNodes[slots[i]];
+			if (child.left != INVALID_BVH_NODE && GetHalfArea(child.bounds) > largestArea)
+			{
+				largestArea = GetHalfArea(child.bounds);
+				largestSlot = static_cast<int>(i);
+			}
+		}
+
+		if (largestSlot < 0)
+		{
+			break;
+		}
+
+		unsigned int opened = slots[largestSlot];
+		slots[largestSlot] = m_buildNodes[opened].left;
+		slots[slotCount++] = m_buildNodes[opened].left + 1;
+	}
+
+	for (unsigned int i = 0; i < BVH_WIDTH; i++)
+	{
+		if (i >= slotCount)
+		{
+			BvhNode& node = m_nodes[nodeIndex];
+			node.minimumX[i] = FLT_MAX;
+			node.minimumY[i] = FLT_MAX;
+			node.minimumZ[i] = FLT_MAX;
+			node.maximumX[i] = -FLT_MAX;
+			node.maximumY[i] = -FLT_MAX;
+			node.maximumZ[i] = -FLT_MAX;
+			node.children[i] = INVALID_BVH_NODE;
+			node.counts[i] = 0;
+			continue;
+		}
+
+		const BuildNode& child = m_buildNodes[slots[i]];
+		unsigned int childIndex = BVH_LEAF | child.first;
+		unsigned int count = child.count;
+		if (child.left != INVALID_BVH_NODE)
+		{
+			if (topNode && child.count <= BVH_JOB_PRIMITIVES)
+			{
+				m_refitRoots[m_refitRootCount] = m_nodeCount;
+				m_refitRootCount++;
+			}
+
+			childIndex = Collapse(slots[i]);
+			count = 0;
+		}
+
+		//	The node is written after the recursion, the children are stored behind it
+		BvhNode& node = m_nodes[nodeIndex];
+		node.minimumX[i] = child.bounds.minimum.x;
+		node.minimumY[i] = child.bounds.minimum.y;
+		node.minimumZ[i] = child.bounds.minimum.z;
+		node.maximumX[i] = child.bounds.maximum.x;
+		node.maximumY[i] = child.bounds.maximum.y;
+		node.maximumZ[i] = child.bounds.maximum.z;
+		node.children[i] = childIndex;
+		node.counts[i] = count;
+	}
+
+	NodeRange& range = m_nodeRanges[nodeIndex];
+	range.firstPrimitive = buildNode.first;
+	range.primitiveCount = buildNode.count;
+	range.endNode = m_nodeCount;
+
+	return nodeIndex;
+}
+
+/*
+	Move the box of a primitive, the index is the one it had in Build
+	The nodes keep their old bounds until Refit
+*/
+void BvhClass::UpdatePrimitive(unsigned int _primitive, const Vector3& _center, const Vector3& _extent)
+{
+	if (_primitive >= m_primitiveCount)
+	{
+		return;
+	}
+
+	unsigned int slot = m_slots[_primitive];
+	m_minimumX[slot] = _center.x - _extent.x;
+	m_minimumY[slot] = _center.y - _extent.y;
+	m_minimumZ[slot] = _center.z - _extent.z;
+	m_maximumX[slot] = _center.x + _extent.x;
+	m_maximumY[slot] = _center.y + _extent.y;
+	m_maximumZ[slot] = _center.z + _extent.z;
+}
+
+/*
+	Recompute the bounds of every node from the boxes of the primitives
+	The children of a node are stored behind it, so a subtree is refit back to front
+	Refit the small subtrees on jobs, then the nodes above them back to front on this thread
+*/
+void BvhClass::Refit()
+{
+	PROFILE_SCOPE("BvhClass::Refit");
+
+	if (m_nodeCount == 0)
+	{
+		return;
+	}
+
+	if (m_topNodeCount == 0)
+	{
+		RefitSubtree(0);
+		return;
+	}
+
+	bool queued = false;
+	if (m_jobSystem)
+	{
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(RefitJob, this, m_refitRootCount, 1, &counter);
+		m_jobSystem->WaitForCounter(&counter);
+	}
+
+	if (!queued)
+	{
+		for (unsigned int i = 0; i < m_refitRootCount; i++)
+		{
+			RefitSubtree(m_refitRoots[i]);
+		}
+	}
+
+	for (unsigned int i = m_topNodeCount; i > 0; i--)
+	{
+		RefitNode(m_topNodes[i - 1]);
+	}
+}
+
+/*
+	Bounds of the children of one node, a leaf from its primitives, an inner child from the four boxes of its node
+*/
+void BvhClass::RefitNode(unsigned int _node)
+{
+	BvhNode& node = m_nodes[_node];
+
+	for (unsigned int i = 0; i < BVH_WIDTH; i++)
+	{
+		if (node.children[i] == INVALID_BVH_NODE)
+		{
+			continue;
+		}
+
+		Aabb bounds = GetEmptyBox();
+		if (node.children[i] & BVH_LEAF)
+		{
+			unsigned int first = node.children[i] & ~BVH_LEAF;
+			for (unsigned int j = first; j < first + node.counts[i]; j++)
+			{
+				GrowBox(bounds, { m_minimumX[j], m_minimumY[j], m_minimumZ[j] }, { m_maximumX[j], m_maximumY[j], m_maximumZ[j] });
+			}
+		}
+		else
+		{
+			const BvhNode& child = m_nodes[node.children[i]];
+			for (unsigned int j = 0; j < BVH_WIDTH; j++)
+			{
+				GrowBox(bounds, { child.minimumX[j], child.minimumY[j], child.minimumZ[j] }, { child.maximumX[j], child.maximumY[j], child.maximumZ[j] });
+			}
+		}
+
+		node.minimumX[i] = bounds.minimum.x;
+		node.minimumY[i] = bounds.minimum.y;
+		node.minimumZ[i] = bounds.minimum.z;
+		node.maximumX[i] = bounds.maximum.x;
+		node.maximumY[i] = bounds.maximum.y;
+		node.maximumZ[i] = bounds.maximum.z;
+	}
+}
+
+void BvhClass::RefitSubtree(unsigned int _root)
+{
+	for (unsigned int node = m_nodeRanges[_root].endNode; node > _root; node--)
+	{
+		RefitNode(node - 1);
+	}
+}
+
+void BvhClass::RefitJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	BvhClass* bvh = static_cast<BvhClass*>(_data);
+
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		bvh->RefitSubtree(bvh->m_refitRoots[i]);
+	}
+}
+
+/*
+	Nearest primitive box the ray hits within _maxDistance, the direction does not have to be normalized (distances are in its length)
+	Slab test of the four children at once, the children which are hit are visited nearest first
+	Leaves are tested right away, so the nearest hit so far cuts off the children which are further away
+*/
+bool BvhClass::Raycast(const Vector3& _origin, const Vector3& _direction, float _maxDistance, BvhRayHit& _hit) const
+{
+	if (m_nodeCount == 0)
+	{
+		return false;
+	}
+
+	float direction[3] = { _direction.x, _direction.y, _direction.z };
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (fabsf(direction[axis]) < BVH_MIN_DIRECTION)
+		{
+			direction[axis] = direction[axis] < 0.0f ? -BVH_MIN_DIRECTION : BVH_MIN_DIRECTION;
+		}
+	}
+
+	Vector3 inverse = { 1.0f / direction[0], 1.0f / direction[1], 1.0f / direction[2] };
+	SimdFloat4 originX = SimdClass::Splat(_origin.x);
+	SimdFloat4 originY = SimdClass::Splat(_origin.y);
+	SimdFloat4 originZ = SimdClass::Splat(_origin.z);
+	SimdFloat4 inverseX = SimdClass::Splat(inverse.x);
+	SimdFloat4 inverseY = SimdClass::Splat(inverse.y);
+	SimdFloat4 inverseZ = SimdClass::Splat(inverse.z);
+	SimdFloat4 zero = SimdClass::Splat(0.0f);
+
+	float nearest = _maxDistance;
+	unsigned int nearestPrimitive = INVALID_BVH_NODE;
+
+	unsigned int stack[BVH_STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BvhNode& node = m_nodes[stack[--stackSize]];
+
+		SimdFloat4 nearX = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.minimumX), originX), inverseX);
+		SimdFloat4 farX = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.maximumX), originX), inverseX);
+		SimdFloat4 nearY = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.minimumY), originY), inverseY);
+		SimdFloat4 farY = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.maximumY), originY), inverseY);
+		SimdFloat4 nearZ = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.minimumZ), originZ), inverseZ);
+		SimdFloat4 farZ = SimdClass::Multiply(SimdClass::Subtract(SimdClass::Load(node.maximumZ), originZ), inverseZ);
+
+		SimdFloat4 entry = SimdClass::Max(SimdClass::Max(SimdClass::Min(nearX, farX), SimdClass::Min(nearY, farY)), SimdClass::Max(SimdClass::Min(nearZ, farZ), zero));
+		SimdFloat4 exit = SimdClass::Min(SimdClass::Min(SimdClass::Max(nearX, farX), SimdClass::Max(nearY, farY)), SimdClass::Min(SimdClass::Max(nearZ, farZ), SimdClass::Splat(nearest)));
+		int hits = ~SimdClass::NegativeMask(SimdClass::Subtract(exit, entry)) & GetChildMask(node);
+		if (hits == 0)
+		{
+			continue;
+		}
+
+		alignas(16) float entries[BVH_WIDTH];
+		SimdClass::Store(entries, entry);
+
+		//	Children which are hit, nearest first
+		unsigned int order[BVH_WIDTH];
+		unsigned int orderCount = 0;
+		for (unsigned int i = 0; i < BVH_WIDTH; i++)
+		{
+			if (hits & (1 << i))
+			{
+				unsigned int position = orderCount;
+				while (position > 0 && entries[order[position - 1]] > entries[i])
+				{
+					order[position] = order[position - 1];
+					position--;
+				}
+				order[position] = i;
+				orderCount++;
+			}
+		}
+
+		for (unsigned int i = 0; i < orderCount; i++)
+		{
+			unsigned int child = node.children[order[i]];
+			if (!(child & BVH_LEAF))
+			{
+				continue;
+			}
+
+			unsigned int first = child & ~BVH_LEAF;
+			for (unsigned int j = first; j < first + node.counts[order[i]]; j++)
+			{
+				float nearPrimitiveX = (m_minimumX[j] - _origin.x) * inverse.x;
+				float farPrimitiveX = (m_maximumX[j] - _origin.x) * inverse.x;
+				float nearPrimitiveY = (m_minimumY[j] - _origin.y) * inverse.y;
+				float farPrimitiveY = (m_maximumY[j] - _origin.y) * inverse.y;
+				float nearPrimitiveZ = (m_minimumZ[j] - _origin.z) * inverse.z;
+				float farPrimitiveZ = (m_maximumZ[j] - _origin.z) * inverse.z;
+
+				float primitiveEntry = std::max(std::max(std::min(nearPrimitiveX, farPrimitiveX), std::min(nearPrimitiveY, farPrimitiveY)), std::max(std::min(nearPrimitiveZ, farPrimitiveZ), 0.0f));
+				float primitiveExit = std::min(std::min(std::max(nearPrimitiveX, farPrimitiveX), std::max(nearPrimitiveY, farPrimitiveY)), std::max(nearPrimitiveZ, farPrimitiveZ));
+				if (primitiveEntry <= primitiveExit && primitiveEntry < nearest)
+				{
+					nearest = primitiveEntry;
+					nearestPrimitive = m_primitives[j];
+				}
+			}
+		}
+
+		//	Push the inner children furthest first, so the nearest one is visited next
+		for (unsigned int i = orderCount; i > 0; i--)
+		{
+			unsigned int child = node.children[order[i - 1]];
+			if (!(child & BVH_LEAF) && entries[order[i - 1]] <= nearest && stackSize < BVH_STACK_SIZE)
+			{
+				stack[stackSize++] = child;
+			}
+		}
+	}
+
+	if (nearestPrimitive == INVALID_BVH_NODE)
+	{
+		return false;
+	}
+
+	_hit.primitive = nearestPrimitive;
+	_hit.distance = nearest;
+
+	return true;
+}
+
+/*
+	Primitives whose box is inside of or intersects the frustum, in leaf order
+	Every plane picks the corner of the four child boxes furthest along its normal (outside if that one is behind it)
+	and the nearest corner (the child is completely inside if that one is in front of every plane)
+	Writes at most _maxPrimitives indices (the ones of Build) and returns how many there are in total
+*/
+unsigned int BvhClass::QueryFrustum(const Frustum& _frustum, unsigned int* _primitives, unsigned int _maxPrimitives) const
+{
+	unsigned int count = 0;
+	if (m_nodeCount == 0)
+	{
+		return 0;
+	}
+
+	unsigned int stack[BVH_STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BvhNode& node = m_nodes[stack[--stackSize]];
+
+		SimdFloat4 minimum[3] = { SimdClass::Load(node.minimumX), SimdClass::Load(node.minimumY), SimdClass::Load(node.minimumZ) };
+		SimdFloat4 maximum[3] = { SimdClass::Load(node.maximumX), SimdClass::Load(node.maximumY), SimdClass::Load(node.maximumZ) };
+
+		int outside = 0;
+		int intersecting = 0;
+		for (int i = 0; i < 6; i++)
+		{
+			const Vector4& plane = _frustum.planes[i];
+			float normal[3] = { plane.x, plane.y, plane.z };
+
+			SimdFloat4 farDistance = SimdClass::Splat(plane.w);
+			SimdFloat4 nearDistance = farDistance;
+			for (int axis = 0; axis < 3; axis++)
+			{
+				SimdFloat4 axisNormal = SimdClass::Splat(normal[axis]);
+				farDistance = SimdClass::MultiplyAdd(axisNormal, normal[axis] >= 0.0f ? maximum[axis] : minimum[axis], farDistance);
+				nearDistance = SimdClass::MultiplyAdd(axisNormal, normal[axis] >= 0.0f ? minimum[axis] : maximum[axis], nearDistance);
+			}
+
+			outside |= SimdClass::NegativeMask(farDistance);
+			intersecting |= SimdClass::NegativeMask(nearDistance);
+		}
+
+		int visible = ~outside & GetChildMask(node);
+		for (unsigned int i = 0; i < BVH_WIDTH; i++)
+		{
+			if (!(visible & (1 << i)))
+			{
+				continue;
+			}
+
+			unsigned int child = node.children[i];
+			bool leaf = (child & BVH_LEAF) != 0;
+			if (!(intersecting & (1 << i)))
+			{
+				if (leaf)
+				{
+					AddRange(child & ~BVH_LEAF, node.counts[i], _primitives, _maxPrimitives, count);
+				}
+				else
+				{
+					AddRange(m_nodeRanges[child].firstPrimitive, m_nodeRanges[child].primitiveCount, _primitives, _maxPrimitives, count);
+				}
+			}
+			else if (leaf)
+			{
+				unsigned int first = child & ~BVH_LEAF;
+				for (unsigned int j = first; j < first + node.counts[i]; j++)
+				{
+					Aabb box = { { m_minimumX[j], m_minimumY[j], m_minimumZ[j] }, { m_maximumX[j], m_maximumY[j], m_maximumZ[j] } };
+					if (MathClass::Intersects(_frustum, box))
+					{
+						AddRange(j, 1, _primitives, _maxPrimitives, count);
+					}
+				}
+			}
+			else if (stackSize < BVH_STACK_SIZE)
+			{
+				stack[stackSize++] = child;
+			}
+		}
+	}
+
+	return count;
+}
+
+/*
+	Primitives whose box overlaps _box (touching counts), in leaf order
+	Writes at most _maxPrimitives indices (the ones of Build) and returns how many there are in total
+*/
+unsigned int BvhClass::QueryBox(const Aabb& _box, unsigned int* _primitives, unsigned int _maxPrimitives) const
+{
+	unsigned int count = 0;
+	if (m_nodeCount == 0)
+	{
+		return 0;
+	}
+
+	SimdFloat4 queryMinimum[3] = { SimdClass::Splat(_box.minimum.x), SimdClass::Splat(_box.minimum.y), SimdClass::Splat(_box.minimum.z) };
+	SimdFloat4 queryMaximum[3] = { SimdClass::Splat(_box.maximum.x), SimdClass::Splat(_box.maximum.y), SimdClass::Splat(_box.maximum.z) };
+
+	unsigned int stack[BVH_STACK_SIZE];
+	unsigned int stackSize = 0;
+	stack[stackSize++] = 0;
+
+	while (stackSize > 0)
+	{
+		const BvhNode& node = m_nodes[stack[--stackSize]];
+
+		SimdFloat4 minimum[3] = { SimdClass::Load(node.minimumX), SimdClass::Load(node.minimumY), SimdClass::Load(node.minimumZ) };
+		SimdFloat4 maximum[3] = { SimdClass::Load(node.maximumX), SimdClass::Load(node.maximumY), SimdClass::Load(node.maximumZ) };
+
+		int outside = 0;
+		int partial = 0;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			outside |= SimdClass::NegativeMask(SimdClass::Subtract(queryMaximum[axis], minimum[axis])) | SimdClass::NegativeMask(SimdClass::Subtract(maximum[axis], queryMinimum[axis]));
+			partial |= SimdClass::NegativeMask(SimdClass::Subtract(minimum[axis], queryMinimum[axis])) | SimdClass::NegativeMask(SimdClass::Subtract(queryMaximum[axis], maximum[axis]));
+		}
+
+		int overlapping = ~outside & GetChildMask(node);
+		for (unsigned int i = 0; i < BVH_WIDTH; i++)
+		{
+			if (!(overlapping & (1 << i)))
+			{
+				continue;
+			}
+
+			unsigned int child = node.children[i];
+			bool leaf = (child & BVH_LEAF) != 0;
+			if (!(partial & (1 << i)))
+			{
+				if (leaf)
+				{
+					AddRange(child & ~BVH_LEAF, node.counts[i], _primitives, _maxPrimitives, count);
+				}
+				else
+				{
+					AddRange(m_nodeRanges[child].firstPrimitive, m_nodeRanges[child].primitiveCount, _primitives, _maxPrimitives, count);
+				}
+			}
+			else if (leaf)
+			{
+				unsigned int first = child & ~BVH_LEAF;
+				for (unsigned int j = first; j < first + node.counts[i]; j++)
+				{
+					if (m_minimumX[j] <= _box.maximum.x && m_maximumX[j] >= _box.minimum.x &&
+						m_minimumY[j] <= _box.maximum.y && m_maximumY[j] >= _box.minimum.y &&
+						m_minimumZ[j] <= _box.maximum.z && m_maximumZ[j] >= _box.minimum.z)
+					{
+						AddRange(j, 1, _primitives, _maxPrimitives, count);
+					}
+				}
+			}
+			else if (stackSize < BVH_STACK_SIZE)
+			{
+				stack[stackSize++] = child;
+			}
+		}
+	}
+
+	return count;
+}
+
+/*
+	Append the primitives of a range of leaf slots to the results, count them even if the results are full
+*/
+void BvhClass::AddRange(unsigned int _firstPrimitive, unsigned int _primitiveCount, unsigned int* _primitives, unsigned int _maxPrimitives, unsigned int& _count) const
+{
+	unsigned int written = 0;
+	for (unsigned int i = _firstPrimitive; i < _firstPrimitive + _primitiveCount && _count + written < _maxPrimitives; i++)
+	{
+		_primitives[_count + written] = m_primitives[i];
+		written++;
+	}
+
+	_count += _primitiveCount;
+}
+
+unsigned int BvhClass::GetPrimitiveCount() const
+{
+	return m_primitiveCount;
+}
+
+unsigned int BvhClass::GetNodeCount() const
+{
+	return m_nodeCount;
+}
+
+/*
+	Bounds of all primitives as of the last Build or Refit
+*/
+Aabb BvhClass::GetBounds() const
+{
+	Aabb bounds = GetEmptyBox();
+	if (m_nodeCount == 0)
+	{
+		return bounds;
+	}
+
+	const BvhNode& root = m_nodes[0];
+	for (unsigned int i = 0; i < BVH_WIDTH; i++)
+	{
+		if (root.children[i] != INVALID_BVH_NODE)
+		{
+			GrowBox(bounds, { root.minimumX[i], root.minimumY[i], root.minimumZ[i] }, { root.maximumX[i], root.maximumY[i], root.maximumZ[i] });
+		}
+	}
+
+	return bounds;
+}
\ No newline at end of file
@@ -0,0 +1,150 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include "CullingClass.h"
+#include "JobSystemClass.h"
+#include "MathClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int BVH_WIDTH = 4;						// children per node, one SimdFloat4 lane each
+const unsigned int BVH_BINS = 16;						// SAH candidates per axis are the borders between these bins
+const unsigned int BVH_MAX_LEAF_SIZE = 4;				// primitives of a leaf
+const unsigned int BVH_SAH_DEPTH = 64;					// deeper ranges are split at the median, so the tree never gets deeper than BVH_MAX_DEPTH
+const unsigned int BVH_MAX_DEPTH = BVH_SAH_DEPTH + 32;
+const unsigned int BVH_STACK_SIZE = BVH_MAX_DEPTH * (BVH_WIDTH - 1) + 1;	// nodes a traversal may have pending
+const unsigned int BVH_JOB_PRIMITIVES = 4096;			// ranges of at least this many primitives are built or refit on their own job
+const unsigned int INVALID_BVH_NODE = 0xFFFFFFFF;
+const unsigned int BVH_LEAF = 0x80000000;				// set in BvhNode::children for a leaf, the other bits are its first primitive
+#pragma endregion
+
+/*
+	Bounds of four children (SoA, one lane per child), two cache lines
+	children: index of the child node, BVH_LEAF | first primitive for a leaf, INVALID_BVH_NODE for an empty slot
+	counts: primitives of a leaf, 0 otherwise, empty slots have inverted bounds and never pass a test
+*/
+struct alignas(64) BvhNode
+{
+	float minimumX[BVH_WIDTH];
+	float minimumY[BVH_WIDTH];
+	float minimumZ[BVH_WIDTH];
+	float maximumX[BVH_WIDTH];
+	float maximumY[BVH_WIDTH];
+	float maximumZ[BVH_WIDTH];
+	unsigned int children[BVH_WIDTH];
+	unsigned int counts[BVH_WIDTH];
+};
+
+struct BvhRayHit
+{
+	unsigned int primitive;
+	float distance;
+};
+
+/*
+	Bounding volume hierarchy over axis aligned boxes (e.g. the bounds of the scene objects), for culling, picking and ray queries
+
+	Build: binary tree with binned SAH (BVH_BINS bins per axis on the box centers), the ranges are partitioned in place
+	   ranges of BVH_JOB_PRIMITIVES or more are handed to the jobsystem, so the subtrees build in parallel
+	   then the binary tree is collapsed into nodes of BVH_WIDTH children, the nodes are stored depth first,
+	   so every subtree is one range of nodes behind its root and one range of primitives
+	Refit: moving primitives only change their boxes (UpdatePrimitive), Refit recomputes the bounds bottom-up without changing the tree
+	   the subtrees below BVH_JOB_PRIMITIVES run on the jobsystem, the nodes above them on the calling thread
+	   the tree gets worse the further the primitives moved since Build, build again e.g. when objects are added or removed
+	Queries: one node tests its four children at once, ray (nearest hit), frustum and box
+	   children which are completely inside of a frustum or box are taken with all their primitives without testing them
+	   the queries only read, so many of them may run in parallel, but not at the same time as Build, Refit or UpdatePrimitive
+
+	Everything is allocated in Initialize
+*/
+class BvhClass
+{
+public:
+	BvhClass();
+	~BvhClass();
+
+	bool Initialize(unsigned int _maxPrimitives, JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	bool Build(const BoundingBoxArrays& _boxes, unsigned int _count);
+	void UpdatePrimitive(unsigned int _primitive, const Vector3& _center, const Vector3& _extent);
+	void Refit();
+
+	bool Raycast(const Vector3& _origin, const Vector3& _direction, float _maxDistance, BvhRayHit& _hit) const;
+	unsigned int QueryFrustum(const Frustum& _frustum, unsigned int* _primitives, unsigned int _maxPrimitives) const;
+	unsigned int QueryBox(const Aabb& _box, unsigned int* _primitives, unsigned int _maxPrimitives) const;
+
+	unsigned int GetPrimitiveCount() const;
+	unsigned int GetNodeCount() const;
+	Aabb GetBounds() const;
+
+private:
+	//	Node of the binary tree while building, an inner node has its children at left and left + 1
+	struct BuildNode
+	{
+		Aabb bounds;
+		unsigned int first;
+		unsigned int count;
+		unsigned int left;		// INVALID_BVH_NODE for a leaf
+		unsigned int depth;
+	};
+
+	//	Box of a primitive while building, the ranges of the nodes are partitioned in place, so binning reads them in order
+	struct BuildPrimitive
+	{
+		Aabb box;
+		Vector3 center;
+		unsigned int primitive;
+	};
+
+	//	Primitives and nodes of the subtree below a node
+	struct NodeRange
+	{
+		unsigned int firstPrimitive;
+		unsigned int primitiveCount;
+		unsigned int endNode;	// one behind the last node of the subtree
+	};
+
+	JobSystemClass* m_jobSystem;
+	unsigned char* m_memory;
+	unsigned int m_maxPrimitives;
+	unsigned int m_maxNodes;
+
+	//	Primitive boxes in leaf order
+	float* m_minimumX;
+	float* m_minimumY;
+	float* m_minimumZ;
+	float* m_maximumX;
+	float* m_maximumY;
+	float* m_maximumZ;
+	unsigned int* m_primitives;		// index the primitive had in Build
+	unsigned int* m_slots;			// where every primitive ended up in the arrays above
+	unsigned int m_primitiveCount;
+
+	BvhNode* m_nodes;
+	NodeRange* m_nodeRanges;
+	unsigned int m_nodeCount;
+
+	//	Nodes above the subtrees which are refit on jobs (depth first order), and the roots of those subtrees
+	unsigned int* m_topNodes;
+	unsigned int m_topNodeCount;
+	unsigned int* m_refitRoots;
+	unsigned int m_refitRootCount;
+
+	//	Build only
+	BuildPrimitive* m_buildPrimitives;
+	BuildNode* m_buildNodes;
+	std::atomic<unsigned int> m_buildNodeCount;
+	JobCounter m_buildCounter;
+
+	void BuildRange(unsigned int _node);
+	unsigned int SplitRange(const BuildNode& _node, const Aabb& _centerBounds);
+	unsigned int Collapse(unsigned int _buildNode);
+	void RefitNode(unsigned int _node);
+	void RefitSubtree(unsigned int _root);
+	void AddRange(unsigned int _firstPrimitive, unsigned int _primitiveCount, unsigned int* _primitives, unsigned int _maxPrimitives, unsigned int& _count) const;
+
+	static void BuildJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	static void RefitJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+};
\ No newline at end of file
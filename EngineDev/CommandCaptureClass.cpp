@@ -0,0 +1,964 @@
+#include "CommandCaptureClass.h"
+#include "MappedFileClass.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+#pragma region Globals
+//	Opcodes of the stream
+static const unsigned char CAPTURE_COMMAND_BARRIERS = 1;
+static const unsigned char CAPTURE_COMMAND_SET_RENDER_TARGET = 2;
+static const unsigned char CAPTURE_COMMAND_CLEAR_RENDER_TARGET = 3;
+static const unsigned char CAPTURE_COMMAND_SET_PIPELINE = 4;
+static const unsigned char CAPTURE_COMMAND_SET_MATERIAL = 5;
+static const unsigned char CAPTURE_COMMAND_SET_MESH = 6;
+static const unsigned char CAPTURE_COMMAND_DRAW = 7;
+static const unsigned char CAPTURE_COMMAND_WRITE_TIMESTAMP = 8;
+static const unsigned char CAPTURE_COMMAND_RESOLVE_TIMESTAMPS = 9;
+
+static const size_t CAPTURE_MAX_COMMAND_SIZE = 64;		// bytes of the largest command besides barriers (SetMesh)
+static const size_t CAPTURE_MAX_BARRIER_SIZE = 31;		// flags, two handles and two states
+static const unsigned char CAPTURE_BARRIER_ALIASING = 1;
+#pragma endregion
+
+/*
+	Constructor
+*/
+CommandCaptureClass::CommandCaptureClass()
+{
+	m_frames = nullptr;
+	m_memory = nullptr;
+	m_frameCount = 0;
+	m_streamCount = 0;
+	m_streamSize = 0;
+	m_firstFrame = 0;
+	m_validFrames = 0;
+	m_recordingSlot = 0;
+	m_recording = false;
+	m_frameNumber = 0;
+}
+
+/*
+	Destructor
+*/
+CommandCaptureClass::~CommandCaptureClass()
+{
+
+}
+
+/*
+	Allocate the ring of _frameCount frames with _streamCount streams of _streamSize bytes each
+	The memory is not touched here, pages of streams which are never filled are never committed
+*/
+bool CommandCaptureClass::Initialize(unsigned int _frameCount, unsigned int _streamCount, size_t _streamSize)
+{
+	if (_frameCount == 0 || _streamCount == 0 || _streamCount > COMMAND_CAPTURE_MAX_STREAMS || _streamSize == 0)
+	{
+		return false;
+	}
+
+	m_frames = new CaptureFrame[_frameCount];
+	if (!m_frames)
+	{
+		return false;
+	}
+
+	m_memory = new unsigned char[static_cast<size_t>(_frameCount) * _streamCount * _streamSize];
+	if (!m_memory)
+	{
+		return false;
+	}
+
+	m_frameCount = _frameCount;
+	m_streamCount = _streamCount;
+	m_streamSize = _streamSize;
+	m_firstFrame = 0;
+	m_validFrames = 0;
+	m_recording = false;
+	m_frameNumber = 0;
+
+	return true;
+}
+
+void CommandCaptureClass::Shutdown()
+{
+	for (unsigned int i = 0; i < COMMAND_CAPTURE_MAX_STREAMS; i++)
+	{
+		m_recorders[i] = StreamRecorder();
+	}
+
+	if (m_memory)
+	{
+		delete[] m_memory;
+		m_memory = nullptr;
+	}
+
+	if (m_frames)
+	{
+		delete[] m_frames;
+		m_frames = nullptr;
+	}
+
+	m_frameCount = 0;
+	m_streamCount = 0;
+	m_validFrames = 0;
+	m_recording = false;
+}
+
+/*
+	Take the slot after the newest frame, if the ring is full this drops the oldest frame
+	Point every recorder at its stream in the slot
+*/
+void CommandCaptureClass::BeginFrame()
+{
+	if (!m_memory)
+	{
+		return;
+	}
+
+	if (m_validFrames == m_frameCount)
+	{
+		m_firstFrame = (m_firstFrame + 1) % m_frameCount;
+		m_validFrames--;
+	}
+
+	m_recordingSlot = (m_firstFrame + m_validFrames) % m_frameCount;
+	m_recording = true;
+
+	unsigned char* slotMemory = m_memory + static_cast<size_t>(m_recordingSlot) * m_streamCount * m_streamSize;
+	for (unsigned int i = 0; i < m_streamCount; i++)
+	{
+		StreamRecorder& recorder = m_recorders[i];
+		recorder.m_begin = slotMemory + i * m_streamSize;
+		recorder.m_position = recorder.m_begin;
+		recorder.m_end = recorder.m_begin + m_streamSize;
+		recorder.m_overflowed = false;
+	}
+}
+
+/*
+	Store how much every recorder wrote and make the frame the newest one
+	The recorders only pass the commands on until the next BeginFrame
+*/
+void CommandCaptureClass::EndFrame()
+{
+	if (!m_recording)
+	{
+		return;
+	}
+
+	CaptureFrame& frame = m_frames[m_recordingSlot];
+	frame.frameNumber = m_frameNumber;
+	frame.complete = true;
+
+	for (unsigned int i = 0; i < COMMAND_CAPTURE_MAX_STREAMS; i++)
+	{
+		StreamRecorder& recorder = m_recorders[i];
+		frame.streamSizes[i] = i < m_streamCount ? static_cast<size_t>(recorder.m_position - recorder.m_begin) : 0;
+		frame.complete = frame.complete && !recorder.m_overflowed;
+
+		recorder.m_begin = nullptr;
+		recorder.m_position = nullptr;
+		recorder.m_end = nullptr;
+	}
+
+	m_validFrames++;
+	m_frameNumber++;
+	m_recording = false;
+}
+
+/*
+	The recorder which captures into _stream and passes the commands on to _target (may be nullptr)
+	Without a ring, or for a stream out of range, the commands are not captured and _target is returned
+	Every stream may only be used by one thread at a time
+*/
+CommandRecorderClass* CommandCaptureClass::GetRecorder(unsigned int _stream, CommandRecorderClass* _target)
+{
+	if (!m_memory || _stream >= m_streamCount)
+	{
+		return _target;
+	}
+
+	m_recorders[_stream].m_target = _target;
+
+	return &m_recorders[_stream];
+}
+
+/*
+	Frames in the ring, frame 0 is the oldest
+*/
+unsigned int CommandCaptureClass::GetFrameCount() const
+{
+	return m_validFrames;
+}
+
+/*
+	Counts the frames since Initialize (or of the run which saved the capture)
+*/
+unsigned long long CommandCaptureClass::GetFrameNumber(unsigned int _frame) const
+{
+	return m_frames[GetSlot(_frame)].frameNumber;
+}
+
+/*
+	Bytes of all streams of the frame
+*/
+size_t CommandCaptureClass::GetFrameSize(unsigned int _frame) const
+{
+	const CaptureFrame& frame = m_frames[GetSlot(_frame)];
+
+	size_t size = 0;
+	for (unsigned int i = 0; i < m_streamCount; i++)
+	{
+		size += frame.streamSizes[i];
+	}
+
+	return size;
+}
+
+/*
+	False if a stream of the frame ran full, the frame then misses its last commands
+*/
+bool CommandCaptureClass::IsFrameComplete(unsigned int _frame) const
+{
+	return m_frames[GetSlot(_frame)].complete;
+}
+
+/*
+	Record the commands of the frame into _recorder, stream after stream
+	Handles are replaced by their numbers, _commandCount is the amount of commands replayed
+	Fails for a frame which is not in the ring or a broken stream, the commands before the broken one are replayed
+*/
+bool CommandCaptureClass::Replay(unsigned int _frame, CommandRecorderClass* _recorder, unsigned int& _commandCount) const
+{
+	_commandCount = 0;
+
+	if (_frame >= m_validFrames || !_recorder)
+	{
+		return false;
+	}
+
+	FrameReader reader;
+	BeginRead(reader, _frame);
+
+	CapturedCommand command;
+	while (ReadCommand(reader, command))
+	{
+		ExecuteCommand(command, _recorder);
+		_commandCount++;
+	}
+
+	return !reader.failed;
+}
+
+/*
+	Compare two frames command by command, with the handles numbered the same way in both
+	Returns true if they match, else _difference is the first command which differs (or is missing in one of the frames)
+*/
+bool CommandCaptureClass::CompareFrames(const CommandCaptureClass& _first, unsigned int _firstFrame, const CommandCaptureClass& _second, unsigned int _secondFrame, unsigned int& _difference)
+{
+	_difference = 0;
+
+	if (_firstFrame >= _first.m_validFrames || _secondFrame >= _second.m_validFrames)
+	{
+		return false;
+	}
+
+	FrameReader firstReader;
+	FrameReader secondReader;
+	_first.BeginRead(firstReader, _firstFrame);
+	_second.BeginRead(secondReader, _secondFrame);
+
+	CapturedCommand firstCommand;
+	CapturedCommand secondCommand;
+	while (true)
+	{
+		bool readFirst = ReadCommand(firstReader, firstCommand);
+		bool readSecond = ReadCommand(secondReader, secondCommand);
+
+		if (!readFirst || !readSecond)
+		{
+			return !readFirst && !readSecond && !firstReader.failed && !secondReader.failed;
+		}
+
+		if (!CommandsEqual(firstCommand, secondCommand))
+		{
+			return false;
+		}
+
+		_difference++;
+	}
+}
+
+/*
+	Write the frames of the ring, oldest first, e.g. after a frame took too long
+*/
+bool CommandCaptureClass::Save(const char* _path) const
+{
+	FILE* file = fopen(_path, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	CommandCaptureFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = COMMAND_CAPTURE_MAGIC;
+	header.formatVersion = COMMAND_CAPTURE_FORMAT_VERSION;
+	header.frameCount = m_validFrames;
+	header.streamCount = m_streamCount;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+
+	for (unsigned int i = 0; written && i < m_validFrames; i++)
+	{
+		unsigned int slot = GetSlot(i);
+		const CaptureFrame& frame = m_frames[slot];
+
+		CommandCaptureFileFrame fileFrame;
+		memset(&fileFrame, 0, sizeof(fileFrame));
+		fileFrame.frameNumber = frame.frameNumber;
+		fileFrame.complete = frame.complete ? 1 : 0;
+		for (unsigned int j = 0; j < m_streamCount; j++)
+		{
+			fileFrame.streamSizes[j] = frame.streamSizes[j];
+		}
+
+		written = fwrite(&fileFrame, sizeof(fileFrame), 1, file) == 1;
+		for (unsigned int j = 0; written && j < m_streamCount; j++)
+		{
+			written = frame.streamSizes[j] == 0 || fwrite(GetStream(slot, j), 1, frame.streamSizes[j], file) == frame.streamSizes[j];
+		}
+	}
+
+	if (fclose(file) != 0 || !written)
+	{
+		remove(_path);
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Replace the ring by the frames of a saved capture, the ring gets exactly as many frames and as large streams as the file needs
+	A file of another format or with sizes beyond its end is not loaded and leaves the capture empty
+*/
+bool CommandCaptureClass::Load(const char* _path)
+{
+	Shutdown();
+
+	MappedFileClass file;
+	if (!file.Open(_path))
+	{
+		return false;
+	}
+
+	const unsigned char* data = static_cast<const unsigned char*>(file.GetData());
+	size_t fileSize = file.GetSize();
+	if (fileSize < sizeof(CommandCaptureFileHeader))
+	{
+		return false;
+	}
+
+	CommandCaptureFileHeader header;
+	memcpy(&header, data, sizeof(header));
+	if (header.magic != COMMAND_CAPTURE_MAGIC || header.formatVersion != COMMAND_CAPTURE_FORMAT_VERSION || header.frameCount == 0 || header.streamCount == 0 || header.streamCount > COMMAND_CAPTURE_MAX_STREAMS)
+	{
+		return false;
+	}
+
+	//	Check every frame lies inside of the file and find the largest stream
+	size_t largestStream = 1;
+	size_t offset = sizeof(CommandCaptureFileHeader);
+	for (unsigned int i = 0; i < header.frameCount; i++)
+	{
+		if (fileSize - offset < sizeof(CommandCaptureFileFrame))
+		{
+			return false;
+		}
+
+		CommandCaptureFileFrame fileFrame;
+		memcpy(&fileFrame, data + offset, sizeof(fileFrame));
+		offset += sizeof(CommandCaptureFileFrame);
+
+		for (unsigned int j = 0; j < header.streamCount; j++)
+		{
+			if (fileFrame.streamSizes[j] > fileSize - offset)
+			{
+				return false;
+			}
+
+			size_t streamSize = static_cast<size_t>(fileFrame.streamSizes[j]);
+			largestStream = streamSize > largestStream ? streamSize : largestStream;
+			offset += streamSize;
+		}
+	}
+
+	if (!Initialize(header.frameCount, header.streamCount, largestStream))
+	{
+		Shutdown();
+		return false;
+	}
+
+	offset = sizeof(CommandCaptureFileHeader);
+	for (unsigned int i = 0; i < header.frameCount; i++)
+	{
+		CommandCaptureFileFrame fileFrame;
+		memcpy(&fileFrame, data + offset, sizeof(fileFrame));
+		offset += sizeof(CommandCaptureFileFrame);
+
+		CaptureFrame& frame = m_frames[i];
+		frame.frameNumber = fileFrame.frameNumber;
+		frame.complete = fileFrame.complete != 0;
+
+		for (unsigned int j = 0; j < COMMAND_CAPTURE_MAX_STREAMS; j++)
+		{
+			frame.streamSizes[j] = j < m_streamCount ? static_cast<size_t>(fileFrame.streamSizes[j]) : 0;
+			if (frame.streamSizes[j] > 0)
+			{
+				memcpy(m_memory + (static_cast<size_t>(i) * m_streamCount + j) * m_streamSize, data + offset, frame.streamSizes[j]);
+				offset += frame.streamSizes[j];
+			}
+		}
+	}
+
+	m_validFrames = header.frameCount;
+	m_frameNumber = m_frames[header.frameCount - 1].frameNumber + 1;
+
+	return true;
+}
+
+unsigned int CommandCaptureClass::GetSlot(unsigned int _frame) const
+{
+	return (m_firstFrame + _frame) % m_frameCount;
+}
+
+const unsigned char* CommandCaptureClass::GetStream(unsigned int _slot, unsigned int _stream) const
+{
+	return m_memory + (static_cast<size_t>(_slot) * m_streamCount + _stream) * m_streamSize;
+}
+
+/*
+	Start reading the first stream of the frame with no handles known yet
+*/
+void CommandCaptureClass::BeginRead(FrameReader& _reader, unsigned int _frame) const
+{
+	_reader.capture = this;
+	_reader.slot = GetSlot(_frame);
+	_reader.stream = 0;
+	_reader.position = GetStream(_reader.slot, 0);
+	_reader.end = _reader.position + m_frames[_reader.slot].streamSizes[0];
+	_reader.failed = false;
+	_reader.handleCount = 0;
+}
+
+/*
+	Read the next command, moving on to the next stream at the end of one
+	Returns false at the end of the frame, or with failed set if the stream is broken
+*/
+bool CommandCaptureClass::ReadCommand(FrameReader& _reader, CapturedCommand& _command)
+{
+	const CommandCaptureClass* capture = _reader.capture;
+
+	while (_reader.position == _reader.end)
+	{
+		_reader.stream++;
+		if (_reader.stream >= capture->m_streamCount)
+		{
+			return false;
+		}
+
+		_reader.position = capture->GetStream(_reader.slot, _reader.stream);
+		_reader.end = _reader.position + capture->m_frames[_reader.slot].streamSizes[_reader.stream];
+	}
+
+	_command.type = *_reader.position++;
+
+	bool read = false;
+	switch (_command.type)
+	{
+	case CAPTURE_COMMAND_BARRIERS:
+		read = ReadUnsigned(_reader, _command.barrierCount) && _command.barrierCount <= COMMAND_CAPTURE_BARRIER_BATCH_SIZE;
+		for (unsigned int i = 0; read && i < _command.barrierCount; i++)
+		{
+			ResourceBarrier& barrier = _command.barriers[i];
+			read = _reader.position != _reader.end;
+			if (read)
+			{
+				barrier.aliasing = (*_reader.position++ & CAPTURE_BARRIER_ALIASING) != 0;
+				read = ReadHandle(_reader, barrier.resource);
+			}
+
+			if (read && barrier.aliasing)
+			{
+				barrier.stateBefore = RESOURCE_STATE_COMMON;
+				barrier.stateAfter = RESOURCE_STATE_COMMON;
+				read = ReadHandle(_reader, barrier.aliasedResource);
+			}
+			else if (read)
+			{
+				barrier.aliasedResource = nullptr;
+				read = ReadUnsigned(_reader, barrier.stateBefore) && ReadUnsigned(_reader, barrier.stateAfter);
+			}
+		}
+		break;
+	case CAPTURE_COMMAND_SET_RENDER_TARGET:
+		_command.renderTarget.descriptor = 0;
+		read = ReadHandle(_reader, _command.renderTarget.resource) && ReadUnsigned(_reader, _command.width) && ReadUnsigned(_reader, _command.height);
+		break;
+	case CAPTURE_COMMAND_CLEAR_RENDER_TARGET:
+		_command.renderTarget.descriptor = 0;
+		read = ReadHandle(_reader, _command.renderTarget.resource);
+		for (unsigned int i = 0; read && i < 4; i++)
+		{
+			read = ReadFloat(_reader, _command.color[i]);
+		}
+		break;
+	case CAPTURE_COMMAND_SET_PIPELINE:
+		read = ReadHandle(_reader, _command.pipeline);
+		break;
+	case CAPTURE_COMMAND_SET_MATERIAL:
+		read = ReadUnsigned(_reader, _command.material);
+		break;
+	case CAPTURE_COMMAND_SET_MESH:
+	{
+		DrawMesh& mesh = _command.mesh;
+		unsigned int indices32Bit = 0;
+		unsigned int baseVertex = 0;
+		read = ReadVarint(_reader, mesh.vertexBufferAddress) && ReadUnsigned(_reader, mesh.vertexBufferSize) && ReadUnsigned(_reader, mesh.vertexStride) &&
+			ReadVarint(_reader, mesh.indexBufferAddress) && ReadUnsigned(_reader, mesh.indexBufferSize) && ReadUnsigned(_reader, indices32Bit) &&
+			ReadUnsigned(_reader, mesh.indexCount) && ReadUnsigned(_reader, mesh.firstIndex) && ReadUnsigned(_reader, baseVertex);
+		mesh.indices32Bit = indices32Bit != 0;
+		mesh.baseVertex = static_cast<int>(baseVertex >> 1) ^ -static_cast<int>(baseVertex & 1);
+		break;
+	}
+	case CAPTURE_COMMAND_DRAW:
+	{
+		unsigned int baseVertex = 0;
+		read = ReadUnsigned(_reader, _command.indexCount) && ReadUnsigned(_reader, _command.instanceCount) && ReadUnsigned(_reader, _command.firstIndex) &&
+			ReadUnsigned(_reader, baseVertex) && ReadUnsigned(_reader, _command.firstInstance);
+		_command.baseVertex = static_cast<int>(baseVertex >> 1) ^ -static_cast<int>(baseVertex & 1);
+		break;
+	}
+	case CAPTURE_COMMAND_WRITE_TIMESTAMP:
+		read = ReadUnsigned(_reader, _command.queryIndex);
+		break;
+	case CAPTURE_COMMAND_RESOLVE_TIMESTAMPS:
+		read = ReadUnsigned(_reader, _command.queryIndex) && ReadUnsigned(_reader, _command.queryCount);
+		break;
+	default:
+		break;
+	}
+
+	_reader.failed = !read;
+
+	return read;
+}
+
+/*
+	7 bits per byte, lowest first, the highest bit is set on every byte but the last
+*/
+bool CommandCaptureClass::ReadVarint(FrameReader& _reader, unsigned long long& _value)
+{
+	_value = 0;
+
+	for (unsigned int shift = 0; shift < 64; shift += 7)
+	{
+		if (_reader.position == _reader.end)
+		{
+			return false;
+		}
+
+		unsigned char byte = *_reader.position++;
+		_value |= static_cast<unsigned long long>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool CommandCaptureClass::ReadUnsigned(FrameReader& _reader, unsigned int& _value)
+{
+	unsigned long long value;
+	if (!ReadVarint(_reader, value) || value > 0xFFFFFFFF)
+	{
+		return false;
+	}
+
+	_value = static_cast<unsigned int>(value);
+
+	return true;
+}
+
+/*
+	Replace the handle by its number in the frame, the first handle of the frame is 1
+*/
+bool CommandCaptureClass::ReadHandle(FrameReader& _reader, void*& _handle)
+{
+	unsigned long long value;
+	if (!ReadVarint(_reader, value))
+	{
+		return false;
+	}
+
+	if (value == 0)
+	{
+		_handle = nullptr;
+		return true;
+	}
+
+	unsigned int index = 0;
+	while (index < _reader.handleCount && _reader.handles[index] != value)
+	{
+		index++;
+	}
+
+	if (index == _reader.handleCount)
+	{
+		if (_reader.handleCount == COMMAND_CAPTURE_MAX_HANDLES)
+		{
+			return false;
+		}
+
+		_reader.handles[_reader.handleCount] = value;
+		_reader.handleCount++;
+	}
+
+	_handle = reinterpret_cast<void*>(static_cast<uintptr_t>(index + 1));
+
+	return true;
+}
+
+bool CommandCaptureClass::ReadFloat(FrameReader& _reader, float& _value)
+{
+	if (_reader.end - _reader.position < static_cast<ptrdiff_t>(sizeof(float)))
+	{
+		return false;
+	}
+
+	memcpy(&_value, _reader.position, sizeof(float));
+	_reader.position += sizeof(float);
+
+	return true;
+}
+
+void CommandCaptureClass::ExecuteCommand(const CapturedCommand& _command, CommandRecorderClass* _recorder)
+{
+	switch (_command.type)
+	{
+	case CAPTURE_COMMAND_BARRIERS:
+		_recorder->ResourceBarriers(_command.barriers, _command.barrierCount);
+		break;
+	case CAPTURE_COMMAND_SET_RENDER_TARGET:
+		_recorder->SetRenderTarget(_command.renderTarget, _command.width, _command.height);
+		break;
+	case CAPTURE_COMMAND_CLEAR_RENDER_TARGET:
+		_recorder->ClearRenderTarget(_command.renderTarget, _command.color);
+		break;
+	case CAPTURE_COMMAND_SET_PIPELINE:
+		_recorder->SetPipeline(_command.pipeline);
+		break;
+	case CAPTURE_COMMAND_SET_MATERIAL:
+		_recorder->SetMaterial(_command.material);
+		break;
+	case CAPTURE_COMMAND_SET_MESH:
+		_recorder->SetMesh(_command.mesh);
+		break;
+	case CAPTURE_COMMAND_DRAW:
+		_recorder->DrawIndexedInstanced(_command.indexCount, _command.instanceCount, _command.firstIndex, _command.baseVertex, _command.firstInstance);
+		break;
+	case CAPTURE_COMMAND_WRITE_TIMESTAMP:
+		_recorder->WriteTimestamp(_command.queryIndex);
+		break;
+	case CAPTURE_COMMAND_RESOLVE_TIMESTAMPS:
+		_recorder->ResolveTimestamps(_command.queryIndex, _command.queryCount);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+	Only compares the members the type of the commands uses, colors bit by bit
+*/
+bool CommandCaptureClass::CommandsEqual(const CapturedCommand& _first, const CapturedCommand& _second)
+{
+	if (_first.type != _second.type)
+	{
+		return false;
+	}
+
+	switch (_first.type)
+	{
+	case CAPTURE_COMMAND_BARRIERS:
+		if (_first.barrierCount != _second.barrierCount)
+		{
+			return false;
+		}
+		for (unsigned int i = 0; i < _first.barrierCount; i++)
+		{
+			const ResourceBarrier& first = _first.barriers[i];
+			const ResourceBarrier& second = _second.barriers[i];
+			if (first.resource != second.resource || first.aliasedResource != second.aliasedResource || first.stateBefore != second.stateBefore ||
+				first.stateAfter != second.stateAfter || first.aliasing != second.aliasing)
+			{
+				return false;
+			}
+		}
+		return true;
+	case CAPTURE_COMMAND_SET_RENDER_TARGET:
+		return _first.renderTarget.resource == _second.renderTarget.resource && _first.width == _second.width && _first.height == _second.height;
+	case CAPTURE_COMMAND_CLEAR_RENDER_TARGET:
+		return _first.renderTarget.resource == _second.renderTarget.resource && memcmp(_first.color, _second.color, sizeof(_first.color)) == 0;
+	case CAPTURE_COMMAND_SET_PIPELINE:
+		return _first.pipeline == _second.pipeline;
+	case CAPTURE_COMMAND_SET_MATERIAL:
+		return _first.material == _second.material;
+	case CAPTURE_COMMAND_SET_MESH:
+		return _first.mesh.vertexBufferAddress == _second.mesh.vertexBufferAddress && _first.mesh.vertexBufferSize == _second.mesh.vertexBufferSize &&
+			_first.mesh.vertexStride == _second.mesh.vertexStride && _first.mesh.indexBufferAddress == _second.mesh.indexBufferAddress &&
+			_first.mesh.indexBufferSize == _second.mesh.indexBufferSize && _first.mesh.indices32Bit == _second.mesh.indices32Bit &&
+			_first.mesh.indexCount == _second.mesh.indexCount && _first.mesh.firstIndex == _second.mesh.firstIndex && _first.mesh.baseVertex == _second.mesh.baseVertex;
+	case CAPTURE_COMMAND_DRAW:
+		return _first.indexCount == _second.indexCount && _first.instanceCount == _second.instanceCount && _first.firstIndex == _second.firstIndex &&
+			_first.baseVertex == _second.baseVertex && _first.firstInstance == _second.firstInstance;
+	case CAPTURE_COMMAND_WRITE_TIMESTAMP:
+		return _first.queryIndex == _second.queryIndex;
+	case CAPTURE_COMMAND_RESOLVE_TIMESTAMPS:
+		return _first.queryIndex == _second.queryIndex && _first.queryCount == _second.queryCount;
+	default:
+		return false;
+	}
+}
+
+/*
+	Constructor
+*/
+CommandCaptureClass::StreamRecorder::StreamRecorder()
+{
+	m_target = nullptr;
+	m_begin = nullptr;
+	m_position = nullptr;
+	m_end = nullptr;
+	m_overflowed = false;
+}
+
+/*
+	Split the barriers into commands of up to COMMAND_CAPTURE_BARRIER_BATCH_SIZE barriers
+*/
+void CommandCaptureClass::StreamRecorder::ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount)
+{
+	for (unsigned int first = 0; first < _barrierCount; first += COMMAND_CAPTURE_BARRIER_BATCH_SIZE)
+	{
+		unsigned int count = _barrierCount - first < COMMAND_CAPTURE_BARRIER_BATCH_SIZE ? _barrierCount - first : COMMAND_CAPTURE_BARRIER_BATCH_SIZE;
+		if (!Reserve(2 + count * CAPTURE_MAX_BARRIER_SIZE))
+		{
+			break;
+		}
+
+		*m_position++ = CAPTURE_COMMAND_BARRIERS;
+		WriteVarint(count);
+
+		for (unsigned int i = first; i < first + count; i++)
+		{
+			const ResourceBarrier& barrier = _barriers[i];
+			*m_position++ = barrier.aliasing ? CAPTURE_BARRIER_ALIASING : 0;
+			WriteHandle(barrier.resource);
+
+			if (barrier.aliasing)
+			{
+				WriteHandle(barrier.aliasedResource);
+			}
+			else
+			{
+				WriteVarint(barrier.stateBefore);
+				WriteVarint(barrier.stateAfter);
+			}
+		}
+	}
+
+	if (m_target)
+	{
+		m_target->ResourceBarriers(_barriers, _barrierCount);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_SET_RENDER_TARGET;
+		WriteHandle(_renderTarget.resource);
+		WriteVarint(_width);
+		WriteVarint(_height);
+	}
+
+	if (m_target)
+	{
+		m_target->SetRenderTarget(_renderTarget, _width, _height);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_CLEAR_RENDER_TARGET;
+		WriteHandle(_renderTarget.resource);
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			WriteFloat(_color[i]);
+		}
+	}
+
+	if (m_target)
+	{
+		m_target->ClearRenderTarget(_renderTarget, _color);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::SetPipeline(void* _pipeline)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_SET_PIPELINE;
+		WriteHandle(_pipeline);
+	}
+
+	if (m_target)
+	{
+		m_target->SetPipeline(_pipeline);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::SetMaterial(unsigned int _material)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_SET_MATERIAL;
+		WriteVarint(_material);
+	}
+
+	if (m_target)
+	{
+		m_target->SetMaterial(_material);
+	}
+}
+
+/*
+	The base vertex is zigzag encoded, so small negative values stay small
+*/
+void CommandCaptureClass::StreamRecorder::SetMesh(const DrawMesh& _mesh)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_SET_MESH;
+		WriteVarint(_mesh.vertexBufferAddress);
+		WriteVarint(_mesh.vertexBufferSize);
+		WriteVarint(_mesh.vertexStride);
+		WriteVarint(_mesh.indexBufferAddress);
+		WriteVarint(_mesh.indexBufferSize);
+		WriteVarint(_mesh.indices32Bit ? 1 : 0);
+		WriteVarint(_mesh.indexCount);
+		WriteVarint(_mesh.firstIndex);
+		WriteVarint((static_cast<unsigned int>(_mesh.baseVertex) << 1) ^ static_cast<unsigned int>(_mesh.baseVertex >> 31));
+	}
+
+	if (m_target)
+	{
+		m_target->SetMesh(_mesh);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_DRAW;
+		WriteVarint(_indexCount);
+		WriteVarint(_instanceCount);
+		WriteVarint(_firstIndex);
+		WriteVarint((static_cast<unsigned int>(_baseVertex) << 1) ^ static_cast<unsigned int>(_baseVertex >> 31));
+		WriteVarint(_firstInstance);
+	}
+
+	if (m_target)
+	{
+		m_target->DrawIndexedInstanced(_indexCount, _instanceCount, _firstIndex, _baseVertex, _firstInstance);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::WriteTimestamp(unsigned int _queryIndex)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_WRITE_TIMESTAMP;
+		WriteVarint(_queryIndex);
+	}
+
+	if (m_target)
+	{
+		m_target->WriteTimestamp(_queryIndex);
+	}
+}
+
+void CommandCaptureClass::StreamRecorder::ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount)
+{
+	if (Reserve(CAPTURE_MAX_COMMAND_SIZE))
+	{
+		*m_position++ = CAPTURE_COMMAND_RESOLVE_TIMESTAMPS;
+		WriteVarint(_firstQuery);
+		WriteVarint(_queryCount);
+	}
+
+	if (m_target)
+	{
+		m_target->ResolveTimestamps(_firstQuery, _queryCount);
+	}
+}
+
+/*
+	Once a command did not fit the stream stays cut off, so it never misses a command in the middle
+*/
+bool CommandCaptureClass::StreamRecorder::Reserve(size_t _size)
+{
+	if (!m_position || m_overflowed)
+	{
+		return false;
+	}
+
+	if (static_cast<size_t>(m_end - m_position) < _size)
+	{
+		m_overflowed = true;
+		return false;
+	}
+
+	return true;
+}
+
+void CommandCaptureClass::StreamRecorder::WriteVarint(unsigned long long _value)
+{
+	while (_value >= 0x80)
+	{
+		*m_position++ = static_cast<unsigned char>(_value | 0x80);
+		_value >>= 7;
+	}
+
+	*m_position++ = static_cast<unsigned char>(_value);
+}
+
+void CommandCaptureClass::StreamRecorder::WriteHandle(const void* _handle)
+{
+	WriteVarint(static_cast<unsigned long long>(reinterpret_cast<uintptr_t>(_handle)));
+}
+
+void CommandCaptureClass::StreamRecorder::WriteFloat(float _value)
+{
+	memcpy(m_position, &_value, sizeof(float));
+	m_position += sizeof(float);
+}
\ No newline at end of file
@@ -0,0 +1,172 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "CommandRecorderClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int COMMAND_CAPTURE_FRAMES = 8;					// frames the renderers keep, the oldest one is overwritten
+const unsigned int COMMAND_CAPTURE_MAX_STREAMS = 8;				// recorders per frame, e.g. one per commandlist
+const size_t COMMAND_CAPTURE_STREAM_SIZE = 256 * 1024;			// bytes per stream and frame, a stream which runs full is cut off
+const unsigned int COMMAND_CAPTURE_MAX_HANDLES = 256;			// resources and pipelines a frame may use, reading a frame with more fails
+const unsigned int COMMAND_CAPTURE_BARRIER_BATCH_SIZE = 16;		// barriers per command in the stream, longer ResourceBarriers calls are split
+const unsigned int COMMAND_CAPTURE_MAGIC = 0x50414345;			// "ECAP"
+const unsigned int COMMAND_CAPTURE_FORMAT_VERSION = 1;			// bump whenever the file layout or the encoding of a command changes
+#pragma endregion
+
+struct CommandCaptureFileHeader
+{
+	unsigned int magic;
+	unsigned int formatVersion;
+	unsigned int frameCount;
+	unsigned int streamCount;
+};
+
+//	Follows the header once per frame, oldest frame first, the streams of the frame follow it back to back
+struct CommandCaptureFileFrame
+{
+	unsigned long long frameNumber;
+	unsigned long long streamSizes[COMMAND_CAPTURE_MAX_STREAMS];
+	unsigned int complete;
+	unsigned int padding;
+};
+
+/*
+	Keeps the commands of the last frames as a compact binary stream, to replay them on another recorder (e.g. of the null backend) or to compare two runs
+	GetRecorder puts a capturing recorder in front of the recorder of the backend, every command is written to the stream and then passed on
+	Every frame has a stream per recorder (up to COMMAND_CAPTURE_MAX_STREAMS), so passes can be recorded on different threads
+	The frames are a ring, BeginFrame overwrites the oldest one, nothing is allocated after Initialize
+	A command is an opcode followed by variable length integers, e.g. a draw takes 6 - 10 bytes
+	Handles (resources, pipelines) are written as they are and only numbered when a frame is read, in the order they first appear in the frame
+	So capturing stays cheap, two runs can still be compared and a replay hands out the numbers as handles (0 stays nullptr)
+	The view of a render target is not captured, replays only work on recorders which do not need the real handles
+	A stream which runs full is cut off at the last command which still fit, its frame is marked incomplete
+	All values are stored little endian
+*/
+class CommandCaptureClass
+{
+public:
+	CommandCaptureClass();
+	~CommandCaptureClass();
+
+	bool Initialize(unsigned int _frameCount, unsigned int _streamCount, size_t _streamSize);
+	void Shutdown();
+
+	void BeginFrame();
+	void EndFrame();
+	CommandRecorderClass* GetRecorder(unsigned int _stream, CommandRecorderClass* _target);
+
+	unsigned int GetFrameCount() const;
+	unsigned long long GetFrameNumber(unsigned int _frame) const;
+	size_t GetFrameSize(unsigned int _frame) const;
+	bool IsFrameComplete(unsigned int _frame) const;
+
+	bool Replay(unsigned int _frame, CommandRecorderClass* _recorder, unsigned int& _commandCount) const;
+	static bool CompareFrames(const CommandCaptureClass& _first, unsigned int _firstFrame, const CommandCaptureClass& _second, unsigned int _secondFrame, unsigned int& _difference);
+
+	bool Save(const char* _path) const;
+	bool Load(const char* _path);
+
+private:
+	/*
+		Writes the commands of one recorder into its stream of the current frame and passes them on to the target
+		Without a stream (outside of BeginFrame - EndFrame) the commands are only passed on
+	*/
+	class StreamRecorder : public CommandRecorderClass
+	{
+	public:
+		StreamRecorder();
+
+		void ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount) override;
+
+		void SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height) override;
+		void ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color) override;
+
+		void SetPipeline(void* _pipeline) override;
+		void SetMaterial(unsigned int _material) override;
+		void SetMesh(const DrawMesh& _mesh) override;
+		void DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance) override;
+
+		void WriteTimestamp(unsigned int _queryIndex) override;
+		void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount) override;
+
+		CommandRecorderClass* m_target;
+		unsigned char* m_begin;
+		unsigned char* m_position;
+		unsigned char* m_end;
+		bool m_overflowed;
+
+	private:
+		bool Reserve(size_t _size);
+		void WriteVarint(unsigned long long _value);
+		void WriteHandle(const void* _handle);
+		void WriteFloat(float _value);
+	};
+
+	struct CaptureFrame
+	{
+		unsigned long long frameNumber;
+		size_t streamSizes[COMMAND_CAPTURE_MAX_STREAMS];
+		bool complete;
+	};
+
+	//	A command read back from a stream, only the members of its type are set
+	struct CapturedCommand
+	{
+		unsigned int type;
+		ResourceBarrier barriers[COMMAND_CAPTURE_BARRIER_BATCH_SIZE];
+		unsigned int barrierCount;
+		RenderTargetView renderTarget;
+		unsigned int width;
+		unsigned int height;
+		float color[4];
+		void* pipeline;
+		unsigned int material;
+		DrawMesh mesh;
+		unsigned int indexCount;
+		unsigned int instanceCount;
+		unsigned int firstIndex;
+		int baseVertex;
+		unsigned int firstInstance;
+		unsigned int queryIndex;
+		unsigned int queryCount;
+	};
+
+	//	Reads the streams of a frame one after another and numbers the handles
+	struct FrameReader
+	{
+		const CommandCaptureClass* capture;
+		unsigned int slot;
+		unsigned int stream;
+		const unsigned char* position;
+		const unsigned char* end;
+		bool failed;
+		unsigned long long handles[COMMAND_CAPTURE_MAX_HANDLES];
+		unsigned int handleCount;
+	};
+
+	CaptureFrame* m_frames;
+	unsigned char* m_memory;
+	unsigned int m_frameCount;
+	unsigned int m_streamCount;
+	size_t m_streamSize;
+	unsigned int m_firstFrame;			// slot of the oldest frame
+	unsigned int m_validFrames;
+	unsigned int m_recordingSlot;
+	bool m_recording;
+	unsigned long long m_frameNumber;
+	StreamRecorder m_recorders[COMMAND_CAPTURE_MAX_STREAMS];
+
+	unsigned int GetSlot(unsigned int _frame) const;
+	const unsigned char* GetStream(unsigned int _slot, unsigned int _stream) const;
+
+	void BeginRead(FrameReader& _reader, unsigned int _frame) const;
+	static bool ReadCommand(FrameReader& _reader, CapturedCommand& _command);
+	static bool ReadVarint(FrameReader& _reader, unsigned long long& _value);
+	static bool ReadUnsigned(FrameReader& _reader, unsigned int& _value);
+	static bool ReadHandle(FrameReader& _reader, void*& _handle);
+	static bool ReadFloat(FrameReader& _reader, float& _value);
+	static void ExecuteCommand(const CapturedCommand& _command, CommandRecorderClass* _recorder);
+	static bool CommandsEqual(const CapturedCommand& _first, const CapturedCommand& _second);
+};
\ No newline at end of file
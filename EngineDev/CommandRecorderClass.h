@@ -0,0 +1,83 @@
+#pragma once
+
+#pragma region global variables
+//	States a GPU resource can be in, read states may be combined, write states are exclusive
+const unsigned int RESOURCE_STATE_COMMON = 0;
+const unsigned int RESOURCE_STATE_RENDER_TARGET = 1 << 0;
+const unsigned int RESOURCE_STATE_DEPTH_WRITE = 1 << 1;
+const unsigned int RESOURCE_STATE_UNORDERED_ACCESS = 1 << 2;
+const unsigned int RESOURCE_STATE_COPY_DEST = 1 << 3;
+const unsigned int RESOURCE_STATE_SHADER_RESOURCE = 1 << 4;
+const unsigned int RESOURCE_STATE_DEPTH_READ = 1 << 5;
+const unsigned int RESOURCE_STATE_COPY_SOURCE = 1 << 6;
+const unsigned int RESOURCE_STATE_PRESENT = 1 << 7;		// can not be combined with another state
+const unsigned int RESOURCE_STATE_WRITE_MASK = RESOURCE_STATE_RENDER_TARGET | RESOURCE_STATE_DEPTH_WRITE | RESOURCE_STATE_UNORDERED_ACCESS | RESOURCE_STATE_COPY_DEST;
+#pragma endregion
+
+/*
+	Transition of a resource from one state to another
+	An aliasing barrier instead hands the memory of aliasedResource over to resource, both live in the same memory
+	The resources are handles of the backend, e.g. an ID3D12Resource
+*/
+struct ResourceBarrier
+{
+	void* resource;
+	void* aliasedResource;		// aliasing barriers only, nullptr if the previous resource is not known
+	unsigned int stateBefore;
+	unsigned int stateAfter;
+	bool aliasing;
+};
+
+/*
+	Vertex and index buffer of a mesh and the range of indices drawing it
+	The buffers are given by their GPU virtual address, so the description does not depend on the backend
+*/
+struct DrawMesh
+{
+	unsigned long long vertexBufferAddress;
+	unsigned int vertexBufferSize;
+	unsigned int vertexStride;
+	unsigned long long indexBufferAddress;
+	unsigned int indexBufferSize;
+	bool indices32Bit;
+	unsigned int indexCount;
+	unsigned int firstIndex;
+	int baseVertex;
+};
+
+/*
+	A render target and the view it is bound with
+	The resource is the handle of the backend (e.g. an ID3D12Resource), the view a descriptor of the backend (e.g. a D3D12_CPU_DESCRIPTOR_HANDLE)
+*/
+struct RenderTargetView
+{
+	void* resource;
+	unsigned long long descriptor;
+};
+
+/*
+	Base class for recording commands into a commandlist of a graphics backend
+	Code which only needs to mark points in the commandlist (e.g. the GPU timer) records through this interface, so it runs without a GPU as well
+	D3DCommandRecorderClass records into an ID3D12GraphicsCommandList, SimulatedCommandRecorderClass executes the commands right away
+	CommandCaptureClass sits in front of another recorder and keeps the commands of the last frames as a binary stream
+*/
+class CommandRecorderClass
+{
+public:
+	virtual ~CommandRecorderClass() {}
+
+	virtual void ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount) = 0;
+
+	//	Binding a render target also sets the viewport and scissor rectangle to the whole target
+	virtual void SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height) = 0;
+	virtual void ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color) = 0;
+
+	//	Draw state, only set when it changes (see DrawBatcherClass)
+	virtual void SetPipeline(void* _pipeline) = 0;
+	virtual void SetMaterial(unsigned int _material) = 0;
+	virtual void SetMesh(const DrawMesh& _mesh) = 0;
+	virtual void DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance) = 0;
+
+	virtual void WriteTimestamp(unsigned int _queryIndex) = 0;
+	virtual void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,544 @@
+#include "CullingClass.h"
+#include "ProfilerClass.h"
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+
+#pragma region Globals
+static const float CULLING_PADDING_EXTENT = -1e30f;		// a box with negative extents is behind every plane
+static const size_t CULLING_ARRAY_ALIGNMENT = 32;
+static const unsigned char CELL_OUTSIDE = 0;
+static const unsigned char CELL_INSIDE = 1;
+static const unsigned char CELL_INTERSECTING = 2;
+#pragma endregion
+
+/*
+	Constructor
+*/
+CullingClass::CullingClass()
+{
+	m_jobSystem = nullptr;
+	m_memory = nullptr;
+	m_maxObjects = 0;
+	m_maxCells = 0;
+	m_capacity = 0;
+	m_centerX = nullptr;
+	m_centerY = nullptr;
+	m_centerZ = nullptr;
+	m_extentX = nullptr;
+	m_extentY = nullptr;
+	m_extentZ = nullptr;
+	m_objects = nullptr;
+	m_slots = nullptr;
+	m_cellBegins = nullptr;
+	m_cellBounds = nullptr;
+	m_cellVisibleCounts = nullptr;
+	m_cellStates = nullptr;
+	m_visible = nullptr;
+	m_objectCount = 0;
+	m_cellCount = 0;
+	m_visibleCount = 0;
+	m_insideCellCount = 0;
+	m_intersectingCellCount = 0;
+}
+
+/*
+	Destructor
+*/
+CullingClass::~CullingClass()
+{
+
+}
+
+/*
+	Allocate every array once in one block, each array starts on a 32 byte boundary
+	Every cell adds at most CULLING_SIMD_WIDTH - 1 padding boxes, the grid never has more than one cell per 16 objects
+*/
+bool CullingClass::Initialize(unsigned int _maxObjects, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	if (_maxObjects == 0)
+	{
+		return false;
+	}
+
+	m_maxObjects = _maxObjects;
+	m_maxCells = _maxObjects / 16 + 1;
+	if (m_maxCells > CULLING_MAX_GRID_SIZE * CULLING_MAX_GRID_SIZE * CULLING_MAX_GRID_SIZE)
+	{
+		m_maxCells = CULLING_MAX_GRID_SIZE * CULLING_MAX_GRID_SIZE * CULLING_MAX_GRID_SIZE;
+	}
+	m_capacity = m_maxObjects + m_maxCells * (CULLING_SIMD_WIDTH - 1);
+
+	size_t sizes[] = {
+		m_capacity * sizeof(float), m_capacity * sizeof(float), m_capacity * sizeof(float),
+		m_capacity * sizeof(float), m_capacity * sizeof(float), m_capacity * sizeof(float),
+		m_capacity * sizeof(unsigned int), m_maxObjects * sizeof(unsigned int),
+		(m_maxCells + 1) * sizeof(unsigned int), m_maxCells * sizeof(Aabb), m_maxCells * sizeof(unsigned int), m_maxCells,
+		m_capacity * sizeof(unsigned int) };
+	const unsigned int arrayCount = sizeof(sizes) / sizeof(sizes[0]);
+
+	size_t totalSize = 0;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		totalSize += (sizes[i] + CULLING_ARRAY_ALIGNMENT - 1) & ~(CULLING_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_memory = static_cast<unsigned char*>(malloc(totalSize + CULLING_ARRAY_ALIGNMENT));
+	if (!m_memory)
+	{
+		return false;
+	}
+
+	void* arrays[arrayCount];
+	size_t offset = (CULLING_ARRAY_ALIGNMENT - reinterpret_cast<size_t>(m_memory) % CULLING_ARRAY_ALIGNMENT) % CULLING_ARRAY_ALIGNMENT;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		arrays[i] = m_memory + offset;
+		offset += (sizes[i] + CULLING_ARRAY_ALIGNMENT - 1) & ~(CULLING_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_centerX = static_cast<float*>(arrays[0]);
+	m_centerY = static_cast<float*>(arrays[1]);
+	m_centerZ = static_cast<float*>(arrays[2]);
+	m_extentX = static_cast<float*>(arrays[3]);
+	m_extentY = static_cast<float*>(arrays[4]);
+	m_extentZ = static_cast<float*>(arrays[5]);
+	m_objects = static_cast<unsigned int*>(arrays[6]);
+	m_slots = static_cast<unsigned int*>(arrays[7]);
+	m_cellBegins = static_cast<unsigned int*>(arrays[8]);
+	m_cellBounds = static_cast<Aabb*>(arrays[9]);
+	m_cellVisibleCounts = static_cast<unsigned int*>(arrays[10]);
+	m_cellStates = static_cast<unsigned char*>(arrays[11]);
+	m_visible = static_cast<unsigned int*>(arrays[12]);
+
+	m_objectCount = 0;
+	m_cellCount = 0;
+	m_visibleCount = 0;
+
+	return true;
+}
+
+void CullingClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_objectCount = 0;
+	m_cellCount = 0;
+	m_visibleCount = 0;
+	m_maxObjects = 0;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Sort the objects into a grid over the bounds of their centers
+	The cells are roughly cubes, there are about _count / CULLING_OBJECTS_PER_CELL of them (flat scenes get flat grids)
+	Counting sort: count the objects per cell, pad every count to the SIMD width, turn the counts into offsets, copy the boxes
+	Call it again when objects are added or removed, moving objects only need UpdateObject
+*/
+bool CullingClass::Build(const BoundingBoxArrays& _boxes, unsigned int _count)
+{
+	PROFILE_SCOPE("CullingClass::Build");
+
+	if (_count > m_maxObjects)
+	{
+		return false;
+	}
+
+	m_objectCount = _count;
+	m_visibleCount = 0;
+
+	Vector3 minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+	Vector3 maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		minimum.x = fminf(minimum.x, _boxes.centerX[i]);
+		minimum.y = fminf(minimum.y, _boxes.centerY[i]);
+		minimum.z = fminf(minimum.z, _boxes.centerZ[i]);
+		maximum.x = fmaxf(maximum.x, _boxes.centerX[i]);
+		maximum.y = fmaxf(maximum.y, _boxes.centerY[i]);
+		maximum.z = fmaxf(maximum.z, _boxes.centerZ[i]);
+	}
+
+	//	Axes without extent still get a tiny size, so the volume is never 0
+	float size[3] = { maximum.x - minimum.x, maximum.y - minimum.y, maximum.z - minimum.z };
+	float largestSize = fmaxf(fmaxf(size[0], size[1]), fmaxf(size[2], 1e-3f));
+	for (int axis = 0; axis < 3; axis++)
+	{
+		size[axis] = fmaxf(size[axis], largestSize * 1e-3f);
+	}
+
+	unsigned int targetCells = _count / CULLING_OBJECTS_PER_CELL;
+	if (targetCells < 1)
+	{
+		targetCells = 1;
+	}
+
+	float cellSize = cbrtf(size[0] * size[1] * size[2] / static_cast<float>(targetCells));
+	unsigned int dimensions[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float cells = floorf(size[axis] / cellSize + 0.5f);
+		dimensions[axis] = cells < 1.0f ? 1 : (cells > static_cast<float>(CULLING_MAX_GRID_SIZE) ? CULLING_MAX_GRID_SIZE : static_cast<unsigned int>(cells));
+	}
+
+	//	Rounding may overshoot the cell budget, take cells away from the axis with the most
+	while (dimensions[0] * dimensions[1] * dimensions[2] > m_maxCells)
+	{
+		int largestAxis = dimensions[0] >= dimensions[1] ? (dimensions[0] >= dimensions[2] ? 0 : 2) : (dimensions[1] >= dimensions[2] ? 1 : 2);
+		dimensions[largestAxis]--;
+	}
+
+	m_cellCount = dimensions[0] * dimensions[1] * dimensions[2];
+
+	float cellScale[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		cellScale[axis] = static_cast<float>(dimensions[axis]) / size[axis];
+	}
+
+	//	Cell of every object, kept in m_slots until the slots are known
+	memset(m_cellBegins, 0, (m_cellCount + 1) * sizeof(unsigned int));
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		float position[3] = { _boxes.centerX[i] - minimum.x, _boxes.centerY[i] - minimum.y, _boxes.centerZ[i] - minimum.z };
+		unsigned int cell[3];
+		for (int axis = 0; axis < 3; axis++)
+		{
+			int index = static_cast<int>(position[axis] * cellScale[axis]);
+			cell[axis] = index < 0 ? 0 : (index >= static_cast<int>(dimensions[axis]) ? dimensions[axis] - 1 : static_cast<unsigned int>(index));
+		}
+
+		unsigned int cellIndex = (cell[2] * dimensions[1] + cell[1]) * dimensions[0] + cell[0];
+		m_slots[i] = cellIndex;
+		m_cellBegins[cellIndex + 1]++;
+	}
+
+	//	Padded counts to offsets, pad the end of every cell with boxes which are never visible
+	for (unsigned int i = 0; i < m_cellCount; i++)
+	{
+		unsigned int count = m_cellBegins[i + 1];
+		unsigned int paddedCount = (count + CULLING_SIMD_WIDTH - 1) & ~(CULLING_SIMD_WIDTH - 1);
+		m_cellBegins[i + 1] = m_cellBegins[i] + paddedCount;
+
+		for (unsigned int j = m_cellBegins[i] + count; j < m_cellBegins[i + 1]; j++)
+		{
+			m_centerX[j] = 0.0f;
+			m_centerY[j] = 0.0f;
+			m_centerZ[j] = 0.0f;
+			m_extentX[j] = CULLING_PADDING_EXTENT;
+			m_extentY[j] = CULLING_PADDING_EXTENT;
+			m_extentZ[j] = CULLING_PADDING_EXTENT;
+			m_objects[j] = INVALID_CULLING_OBJECT;
+		}
+
+		//	Reused as the fill count of the cell
+		m_cellVisibleCounts[i] = 0;
+		m_cellBounds[i].minimum = { FLT_MAX, FLT_MAX, FLT_MAX };
+		m_cellBounds[i].maximum = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	}
+
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		unsigned int cell = m_slots[i];
+		unsigned int slot = m_cellBegins[cell] + m_cellVisibleCounts[cell]++;
+
+		m_centerX[slot] = _boxes.centerX[i];
+		m_centerY[slot] = _boxes.centerY[i];
+		m_centerZ[slot] = _boxes.centerZ[i];
+		m_extentX[slot] = _boxes.extentX[i];
+		m_extentY[slot] = _boxes.extentY[i];
+		m_extentZ[slot] = _boxes.extentZ[i];
+		m_objects[slot] = i;
+		m_slots[i] = slot;
+
+		Aabb box = {
+			{ _boxes.centerX[i] - _boxes.extentX[i], _boxes.centerY[i] - _boxes.extentY[i], _boxes.centerZ[i] - _boxes.extentZ[i] },
+			{ _boxes.centerX[i] + _boxes.extentX[i], _boxes.centerY[i] + _boxes.extentY[i], _boxes.centerZ[i] + _boxes.extentZ[i] } };
+		m_cellBounds[cell] = MathClass::Merge(m_cellBounds[cell], box);
+	}
+
+	return true;
+}
+
+/*
+	Move or resize an object without rebuilding the grid
+	The object stays in its cell, the bounds of the cell grow to hold it (they never shrink until the next Build)
+	Objects which move far make their cell big and less likely to be rejected early, rebuild from time to time
+*/
+void CullingClass::UpdateObject(unsigned int _object, const Vector3& _center, const Vector3& _extent)
+{
+	if (_object >= m_objectCount)
+	{
+		return;
+	}
+
+	unsigned int slot = m_slots[_object];
+	m_centerX[slot] = _center.x;
+	m_centerY[slot] = _center.y;
+	m_centerZ[slot] = _center.z;
+	m_extentX[slot] = _extent.x;
+	m_extentY[slot] = _extent.y;
+	m_extentZ[slot] = _extent.z;
+
+	//	Binary search for the cell owning the slot
+	unsigned int first = 0;
+	unsigned int last = m_cellCount;
+	while (last - first > 1)
+	{
+		unsigned int middle = (first + last) / 2;
+		if (m_cellBegins[middle] <= slot)
+		{
+			first = middle;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+
+	Aabb box = { MathClass::Subtract(_center, _extent), MathClass::Add(_center, _extent) };
+	m_cellBounds[first] = MathClass::Merge(m_cellBounds[first], box);
+}
+
+/*
+	Test every cell against the frustum on the jobsystem, then move the visible parts of the cells together
+	Big grids get bigger batches, so the cells never flood the queue of the calling thread
+	Returns the amount of visible objects
+*/
+unsigned int CullingClass::Cull(const Frustum& _frustum)
+{
+	PROFILE_SCOPE("CullingClass::Cull");
+
+	m_frustum = _frustum;
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		m_absoluteFrustum.planes[i] = { fabsf(plane.x), fabsf(plane.y), fabsf(plane.z), 0.0f };
+	}
+
+	bool queued = false;
+	if (m_jobSystem && m_cellCount > CULLING_CELLS_PER_JOB)
+	{
+		unsigned int jobCount = m_jobSystem->GetThreadCount() * 4;
+		unsigned int batchSize = (m_cellCount + jobCount - 1) / jobCount;
+		if (batchSize < CULLING_CELLS_PER_JOB)
+		{
+			batchSize = CULLING_CELLS_PER_JOB;
+		}
+
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(CullJob, this, m_cellCount, batchSize, &counter);
+		if (queued)
+		{
+			m_jobSystem->WaitForCounter(&counter);
+		}
+	}
+
+	if (!queued)
+	{
+		CullCells(0, m_cellCount);
+	}
+
+	m_visibleCount = 0;
+	m_insideCellCount = 0;
+	m_intersectingCellCount = 0;
+	for (unsigned int i = 0; i < m_cellCount; i++)
+	{
+		m_insideCellCount += m_cellStates[i] == CELL_INSIDE ? 1 : 0;
+		m_intersectingCellCount += m_cellStates[i] == CELL_INTERSECTING ? 1 : 0;
+
+		unsigned int count = m_cellVisibleCounts[i];
+		if (count > 0)
+		{
+			if (m_cellBegins[i] != m_visibleCount)
+			{
+				memmove(m_visible + m_visibleCount, m_visible + m_cellBegins[i], count * sizeof(unsigned int));
+			}
+			m_visibleCount += count;
+		}
+	}
+
+	return m_visibleCount;
+}
+
+const unsigned int* CullingClass::GetVisibleObjects() const
+{
+	return m_visible;
+}
+
+unsigned int CullingClass::GetVisibleCount() const
+{
+	return m_visibleCount;
+}
+
+unsigned int CullingClass::GetObjectCount() const
+{
+	return m_objectCount;
+}
+
+unsigned int CullingClass::GetCellCount() const
+{
+	return m_cellCount;
+}
+
+/*
+	Cells of the last Cull which were completely inside, their objects were not tested
+*/
+unsigned int CullingClass::GetInsideCellCount() const
+{
+	return m_insideCellCount;
+}
+
+/*
+	Cells of the last Cull on the border of the frustum, their objects were tested one by one
+*/
+unsigned int CullingClass::GetIntersectingCellCount() const
+{
+	return m_intersectingCellCount;
+}
+
+void CullingClass::CullJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	static_cast<CullingClass*>(_data)->CullCells(_begin, _end);
+}
+
+/*
+	Classify the bounds of every cell: outside if they are behind one plane, inside if they are in front of all planes
+	Every cell writes its visible objects to the start of its own range in the visible list
+*/
+void CullingClass::CullCells(unsigned int _begin, unsigned int _end)
+{
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		unsigned int begin = m_cellBegins[i];
+		unsigned int end = m_cellBegins[i + 1];
+		if (begin == end)
+		{
+			m_cellStates[i] = CELL_OUTSIDE;
+			m_cellVisibleCounts[i] = 0;
+			continue;
+		}
+
+		const Aabb& bounds = m_cellBounds[i];
+		Vector3 center = MathClass::Scale(MathClass::Add(bounds.minimum, bounds.maximum), 0.5f);
+		Vector3 extent = MathClass::Scale(MathClass::Subtract(bounds.maximum, bounds.minimum), 0.5f);
+
+		unsigned char state = CELL_INSIDE;
+		for (int j = 0; j < 6; j++)
+		{
+			const Vector4& plane = m_frustum.planes[j];
+			const Vector4& absolutePlane = m_absoluteFrustum.planes[j];
+			float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+			float radius = absolutePlane.x * extent.x + absolutePlane.y * extent.y + absolutePlane.z * extent.z;
+
+			if (distance + radius < 0.0f)
+			{
+				state = CELL_OUTSIDE;
+				break;
+			}
+
+			if (distance - radius < 0.0f)
+			{
+				state = CELL_INTERSECTING;
+			}
+		}
+
+		m_cellStates[i] = state;
+
+		unsigned int* visible = m_visible + begin;
+		unsigned int count = 0;
+		if (state == CELL_INSIDE)
+		{
+			for (unsigned int j = begin; j < end; j++)
+			{
+				visible[count] = m_objects[j];
+				count += m_objects[j] != INVALID_CULLING_OBJECT ? 1 : 0;
+			}
+		}
+		else if (state == CELL_INTERSECTING)
+		{
+			count = CullObjects(begin, end, visible);
+		}
+
+		m_cellVisibleCounts[i] = count;
+	}
+}
+
+/*
+	Test the boxes of [_begin, _end) (a multiple of CULLING_SIMD_WIDTH) against all planes
+	The smallest distance + projected extent over all planes is negative exactly if the box is behind one of them
+	The visible objects are written without branches: always write, only advance if visible
+*/
+unsigned int CullingClass::CullObjects(unsigned int _begin, unsigned int _end, unsigned int* _visible) const
+{
+	const Vector4* planes = m_frustum.planes;
+	const Vector4* absolutePlanes = m_absoluteFrustum.planes;
+	unsigned int count = 0;
+
+	for (unsigned int i = _begin; i < _end; i += CULLING_SIMD_WIDTH)
+	{
+		int outside;
+
+#if defined(ENGINE_SIMD_AVX2)
+		__m256 centerX = _mm256_load_ps(m_centerX + i);
+		__m256 centerY = _mm256_load_ps(m_centerY + i);
+		__m256 centerZ = _mm256_load_ps(m_centerZ + i);
+		__m256 extentX = _mm256_load_ps(m_extentX + i);
+		__m256 extentY = _mm256_load_ps(m_extentY + i);
+		__m256 extentZ = _mm256_load_ps(m_extentZ + i);
+
+		__m256 smallest = _mm256_set1_ps(FLT_MAX);
+		for (int j = 0; j < 6; j++)
+		{
+			__m256 distance = _mm256_fmadd_ps(centerX, _mm256_broadcast_ss(&planes[j].x), _mm256_broadcast_ss(&planes[j].w));
+			distance = _mm256_fmadd_ps(centerY, _mm256_broadcast_ss(&planes[j].y), distance);
+			distance = _mm256_fmadd_ps(centerZ, _mm256_broadcast_ss(&planes[j].z), distance);
+			distance = _mm256_fmadd_ps(extentX, _mm256_broadcast_ss(&absolutePlanes[j].x), distance);
+			distance = _mm256_fmadd_ps(extentY, _mm256_broadcast_ss(&absolutePlanes[j].y), distance);
+			distance = _mm256_fmadd_ps(extentZ, _mm256_broadcast_ss(&absolutePlanes[j].z), distance);
+			smallest = _mm256_min_ps(smallest, distance);
+		}
+
+		outside = _mm256_movemask_ps(_mm256_cmp_ps(smallest, _mm256_setzero_ps(), _CMP_LT_OQ));
+#else
+		outside = 0;
+		for (unsigned int k = 0; k < CULLING_SIMD_WIDTH; k += 4)
+		{
+			SimdFloat4 centerX = SimdClass::Load(m_centerX + i + k);
+			SimdFloat4 centerY = SimdClass::Load(m_centerY + i + k);
+			SimdFloat4 centerZ = SimdClass::Load(m_centerZ + i + k);
+			SimdFloat4 extentX = SimdClass::Load(m_extentX + i + k);
+			SimdFloat4 extentY = SimdClass::Load(m_extentY + i + k);
+			SimdFloat4 extentZ = SimdClass::Load(m_extentZ + i + k);
+
+			SimdFloat4 smallest = SimdClass::Splat(FLT_MAX);
+			for (int j = 0; j < 6; j++)
+			{
+				SimdFloat4 distance = SimdClass::MultiplyAdd(centerX, SimdClass::Splat(planes[j].x), SimdClass::Splat(planes[j].w));
+				distance = SimdClass::MultiplyAdd(centerY, SimdClass::Splat(planes[j].y), distance);
+				distance = SimdClass::MultiplyAdd(centerZ, SimdClass::Splat(planes[j].z), distance);
+				distance = SimdClass::MultiplyAdd(extentX, SimdClass::Splat(absolutePlanes[j].x), distance);
+				distance = SimdClass::MultiplyAdd(extentY, SimdClass::Splat(absolutePlanes[j].y), distance);
+				distance = SimdClass::MultiplyAdd(extentZ, SimdClass::Splat(absolutePlanes[j].z), distance);
+				smallest = SimdClass::Min(smallest, distance);
+			}
+
+			outside |= SimdClass::NegativeMask(smallest) << k;
+		}
+#endif
+
+		for (unsigned int k = 0; k < CULLING_SIMD_WIDTH; k++)
+		{
+			_visible[count] = m_objects[i + k];
+			count += (outside >> k) & 1 ? 0 : 1;
+		}
+	}
+
+	return count;
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#pragma once
+
+#pragma region includes
+#include "JobSystemClass.h"
+#include "MathClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int CULLING_OBJECTS_PER_CELL = 64;		// the grid is sized so an average cell holds this many objects
+const unsigned int CULLING_MAX_GRID_SIZE = 64;			// cells per axis
+const unsigned int CULLING_SIMD_WIDTH = 8;				// the objects of every cell are padded to a multiple of this
+const unsigned int CULLING_CELLS_PER_JOB = 16;
+const unsigned int INVALID_CULLING_OBJECT = 0xFFFFFFFF;
+#pragma endregion
+
+/*
+	Axis aligned bounding boxes of many objects as center and half extents, one array per component (SoA)
+*/
+struct BoundingBoxArrays
+{
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+	const float* extentX;
+	const float* extentY;
+	const float* extentZ;
+};
+
+/*
+	Visibility stage ahead of command recording, tests the bounding boxes of all objects against the camera frustum
+
+	Build sorts the objects into a uniform grid over their centers and keeps the boxes per cell in SoA arrays, padded with boxes which are never visible
+	Every cell knows the bounds of its objects (not of its grid cell, the boxes may reach into other cells)
+	Cull tests the cells first: cells outside are skipped, cells completely inside are accepted without looking at the boxes,
+	only the objects of cells on the border of the frustum are tested, 8 boxes per step (AVX2, or twice 4 on SSE / NEON)
+	The cells are spread over the jobsystem, every cell writes into its own part of the visible list, then the parts are moved together
+
+	The visible list holds the indices the objects had in Build, in grid order
+	Build allocates nothing once initialized, Cull never allocates
+*/
+class CullingClass
+{
+public:
+	CullingClass();
+	~CullingClass();
+
+	bool Initialize(unsigned int _maxObjects, JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	bool Build(const BoundingBoxArrays& _boxes, unsigned int _count);
+	void UpdateObject(unsigned int _object, const Vector3& _center, const Vector3& _extent);
+	unsigned int Cull(const Frustum& _frustum);
+
+	const unsigned int* GetVisibleObjects() const;
+	unsigned int GetVisibleCount() const;
+	unsigned int GetObjectCount() const;
+	unsigned int GetCellCount() const;
+	unsigned int GetInsideCellCount() const;
+	unsigned int GetIntersectingCellCount() const;
+
+private:
+	JobSystemClass* m_jobSystem;
+	unsigned char* m_memory;
+	unsigned int m_maxObjects;
+	unsigned int m_maxCells;
+	unsigned int m_capacity;
+
+	//	Boxes and object indices in grid order, padded per cell
+	float* m_centerX;
+	float* m_centerY;
+	float* m_centerZ;
+	float* m_extentX;
+	float* m_extentY;
+	float* m_extentZ;
+	unsigned int* m_objects;
+	unsigned int* m_slots;			// where every object ended up in the arrays above
+
+	unsigned int* m_cellBegins;		// m_cellCount + 1 entries, the padded range of cell i is [m_cellBegins[i], m_cellBegins[i + 1])
+	Aabb* m_cellBounds;
+	unsigned int* m_cellVisibleCounts;
+	unsigned char* m_cellStates;
+
+	unsigned int* m_visible;
+	unsigned int m_objectCount;
+	unsigned int m_cellCount;
+	unsigned int m_visibleCount;
+	unsigned int m_insideCellCount;
+	unsigned int m_intersectingCellCount;
+
+	Frustum m_frustum;
+	Frustum m_absoluteFrustum;		// absolute values of the plane normals, for the projected box extents
+
+	static void CullJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	void CullCells(unsigned int _begin, unsigned int _end);
+	unsigned int CullObjects(unsigned int _begin, unsigned int _end, unsigned int* _visible) const;
+};
\ No newline at end of file
@@ -1,6 +1,13 @@
+#ifdef _WIN32
+
 #include "D3DClass.h"
+#include "ProfilerClass.h"
 #include <minwinbase.h>
 
+#pragma region Globals
+static const float D3D_CLEAR_COLOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+#pragma endregion
+
 /*
 	Initialize all the variables
 */
@@ -9,17 +16,34 @@ D3DClass::D3DClass()
 	m_device = nullptr;
 	m_commandQueue = nullptr;
 	m_swapChain = nullptr;
-	m_renderTargetViewHeap = nullptr;
-	m_backBufferRenderTarget[0] = nullptr;
-	m_backBufferRenderTarget[1] = nullptr;
-	m_commandAllocator = nullptr;
-	m_commandList = nullptr;
+	m_frameLatencyWaitableObject = nullptr;
+	m_presentCountOffset = 0;
+	m_performanceFrequency = 1;
+	for (unsigned int i = 0; i < MAX_SWAP_CHAIN_BUFFERS; i++)
+	{
+		m_backBufferRenderTargetView[i] = INVALID_DESCRIPTOR;
+		m_backBufferRenderTarget[i] = nullptr;
+	}
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		for (unsigned int j = 0; j < RENDER_PASS_COUNT; j++)
+		{
+			m_commandAllocator[i][j] = nullptr;
+		}
+	}
+	for (unsigned int i = 0; i < RENDER_PASS_COUNT; i++)
+	{
+		m_commandList[i] = nullptr;
+		m_passRecorded[i] = false;
+	}
 	m_pipelineState = nullptr;
-	m_fence = nullptr;
-	m_fenceEvent = nullptr;
-	m_vSyncEnabled = false;
+	m_rootSignature = nullptr;
+	m_jobSystem = nullptr;
+	m_drawBatcher = nullptr;
+	m_meshBufferCount = 0;
+	m_screenHeight = 0;
+	m_screenWidth = 0;
 	m_bufferIndex = 0;
-	m_fenceValue = 0;
 	m_videoCardMemory = 0;
 }
 
@@ -36,19 +60,32 @@ D3DClass::~D3DClass()
 	Get the primary graphics card
 	Get the refreshrate of the monitor
 	Get the graphics card name and its memory
-	Initialize the Swapchain which will handle the writing and clearing the two back buffers
+	Resolve the present settings against the tearing support of the platform
+	Initialize the Swapchain which will handle the writing and clearing of the back buffers, with its frame latency waitable object
 	Setup the render target view so we can render to the screen
 	Get the current buffer to draw to
-	Create the commandallocator so we can allocate enough memory for the commands
-	Create commandlist to send the commands to the commandqueue which is attached to the graphics card
-	Create a fence and an event for GPU synchronization
+	Create one commandallocator per frame in flight and render pass so we can allocate enough memory for the commands
+	Create one commandlist per render pass to send the commands to the commandqueue which is attached to the graphics card
+	Create a fence for GPU synchronization and the ring which keeps track of the frames in flight
+	Create the timestamp queries and a recorder per commandlist for the GPU timer
 */
-bool D3DClass::Initialize(int _screenHeight, int _screenWidth, HWND _windowHandle, bool _vSync, bool _fullscreen)
+bool D3DClass::Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem)
 {
-	m_vSyncEnabled = _vSync;
+	PROFILE_SCOPE("D3DClass::Initialize");
+
+	m_screenHeight = _screenHeight;
+	m_screenWidth = _screenWidth;
+	m_jobSystem = _jobSystem;
 	HRESULT result = 0;
 
-	if(!CreateDevice(result, _windowHandle))
+	if (!m_scratchAllocator.Initialize(D3D_SCRATCH_MEMORY_SIZE))
+	{
+		return false;
+	}
+
+	HWND windowHandle = static_cast<HWND>(_windowHandle);
+
+	if(!CreateDevice(result, windowHandle))
 	{
 		return false;
 	}
@@ -71,22 +108,45 @@ bool D3DClass::Initialize(int _screenHeight, int _screenWidth, HWND _windowHandl
 	result = factory->EnumAdapters(0, &adapter);
 	if (FAILED(result))
 	{
+		factory->Release();
 		return false;
 	}
 
-	unsigned int denominator = 0;
-	unsigned int numerator = 0;
-	if (!GetRefreshRateOfMonitor(result, numerator, denominator, adapter, _screenHeight, _screenWidth))
+	//	Variable refresh and presents which do not wait for the refresh need tearing support
+	//	Exclusive fullscreen does not take the tearing flag, presents which do not wait tear there anyway
+	if (!m_presentPolicy.Initialize(_presentSettings, !_fullscreen && IsTearingSupported(factory)))
 	{
+		adapter->Release();
+		factory->Release();
 		return false;
 	}
 
-	if (!GetNameAndVideoCardMemory(result, adapter))
+	//	The swapchain reports when a present was shown in QPC ticks, the input is timed with the same clock
+	LARGE_INTEGER performanceFrequency;
+	QueryPerformanceFrequency(&performanceFrequency);
+	m_performanceFrequency = performanceFrequency.QuadPart;
+
+	//	The adapter is only needed for the refresh rate and the name, the factory only for the swapchain
+	//	Both are released right after, whether their step failed or not
+	unsigned int denominator = 0;
+	unsigned int numerator = 0;
+	bool adapterQueried = GetRefreshRateOfMonitor(result, numerator, denominator, adapter, _screenHeight, _screenWidth, m_scratchAllocator) && GetNameAndVideoCardMemory(result, adapter);
+
+	adapter->Release();
+	adapter = nullptr;
+
+	if (!adapterQueried)
 	{
+		factory->Release();
 		return false;
 	}
 
-	if (!InitializeSwapChain(result, numerator, denominator, factory, _windowHandle, _screenHeight, _screenWidth, _fullscreen))
+	bool swapChainCreated = InitializeSwapChain(result, numerator, denominator, factory, windowHandle, _screenHeight, _screenWidth, _fullscreen);
+
+	factory->Release();
+	factory = nullptr;
+
+	if (!swapChainCreated)
 	{
 		return false;
 	}
@@ -99,205 +159,543 @@ bool D3DClass::Initialize(int _screenHeight, int _screenWidth, HWND _windowHandl
 	//	Get the current buffer to be drawing to
 	m_bufferIndex = m_swapChain->GetCurrentBackBufferIndex();
 
-	//	Create the commandallocator, allocating memory for the lsit of commands that we send to the GPU each frame
-	result = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, _uuidof(ID3D12CommandAllocator), (void**)&m_commandAllocator);
-	if (FAILED(result))
+	//	Create the commandallocators, allocating memory for the list of commands that we send to the GPU each frame
+	//	Every frame in flight needs its own allocator, an allocator can only be reset after the GPU is done with its commands
+	//	Every render pass needs its own allocator as well, an allocator must not be used by two threads at the same time
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		for (unsigned int j = 0; j < RENDER_PASS_COUNT; j++)
+		{
+			result = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, _uuidof(ID3D12CommandAllocator), (void**)&m_commandAllocator[i][j]);
+			if (FAILED(result))
+			{
+				return false;
+			}
+		}
+	}
+
+	//	Create the commandlists which send the commands to the commandqueue to be rendered by the GPU
+	//	Every render pass is recorded into its own commandlist, so the passes can be recorded parallel on the jobsystem
+	for (unsigned int i = 0; i < RENDER_PASS_COUNT; i++)
+	{
+		result = m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator[0][i], nullptr, _uuidof(ID3D12GraphicsCommandList), (void**)&m_commandList[i]);
+		if (FAILED(result))
+		{
+			return false;
+		}
+
+		//	Close the commandlist because it is created in a recording state
+		result = m_commandList[i]->Close();
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	//	Creating a fence, which will notify us when the GPU is ready with the rendering of the commandlist
+	//	We are able to synchronize GPU and CPU with the fence
+	if (!m_fence.Initialize(m_device, m_commandQueue))
 	{
 		return false;
 	}
 
-	//	Create the commandlist which sends the commands to the commandqueue to be rendered by the GPU
-	//	This belongs somewhere else later one, we will be using multiple commandlists which are working parallel and multi threaded
-	result = m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, m_commandAllocator, nullptr, _uuidof(ID3D12GraphicsCommandList), (void**)&m_commandList);
-	if (FAILED(result))
+	//	The CPU may record up to _framesInFlight frames ahead of the GPU before it has to wait
+	if (!m_frameRing.Initialize(&m_fence, _framesInFlight))
 	{
 		return false;
 	}
 
-	//	Close the commandlist because it is created in a recording state
-	result = m_commandList->Close();
-	if (FAILED(result))
+	//	Every frame in flight gets its own range of queries, so the results can be read after the GPU is done without stalling
+	if (!m_timestampQueries.Initialize(m_device, m_commandQueue, GPU_TIMER_QUERY_COUNT))
 	{
 		return false;
 	}
 
-	//	Creating a fence, which will notify us when the GPU is ready with the rendering of the commandlist
-	//	We are able to synchronize GPU and CPU with the fence
-	//	Create a fence for GPU synchronization
-	result = m_device->CreateFence(0, D3D12_FENCE_FLAG_NONE, _uuidof(ID3D12Fence), (void**)&m_fence);
-	if (FAILED(result))
+	for (unsigned int i = 0; i < RENDER_PASS_COUNT; i++)
+	{
+		if (!m_commandRecorder[i].Initialize(m_commandList[i], &m_timestampQueries))
+		{
+			return false;
+		}
+	}
+
+	if (!m_gpuTimer.Initialize(&m_timestampQueries))
 	{
 		return false;
 	}
 
-	//	Create an event object for the fence which will give us feedback on finished rendering
-	m_fenceEvent = CreateEventEx(nullptr, nullptr, FALSE, EVENT_ALL_ACCESS);
-	if (m_fenceEvent == nullptr)
+	//	Every pass captures into its own stream, so the passes can still be recorded in parallel
+	if (!m_commandCapture.Initialize(COMMAND_CAPTURE_FRAMES, RENDER_PASS_COUNT, COMMAND_CAPTURE_STREAM_SIZE))
 	{
 		return false;
 	}
 
-	//	Start the fence at position 1
-	m_fenceValue = 1;
+	//	Resource data is copied on its own copy queue, the uploads of a frame are submitted as one batch
+	if (!m_uploadManager.Initialize(m_device, UPLOAD_RING_SIZE))
+	{
+		return false;
+	}
+
+	//	Pipelines are created on background jobs, the blobs of the last run are loaded from disk so a warm start does not compile
+	if (!CreateRootSignature(result))
+	{
+		return false;
+	}
+
+	if (!m_pipelineCompiler.Initialize(m_device, m_rootSignature))
+	{
+		return false;
+	}
+
+	if (!m_pipelineCache.Initialize(&m_pipelineCompiler, m_jobSystem, PIPELINE_CACHE_PATH))
+	{
+		return false;
+	}
 
 	return true;
 }
 
+/*
+	Wait until the resources of this frame in flight are free again, this is the only place the CPU waits for the GPU
+	The GPU timer reads the timings of the frame which used this frame in flight before
+	Build and compile the render graph of this frame
+	Record every compiled pass into its own commandlist, fanned out over the jobsystem
+	The main thread helps recording while it waits for the passes
+	The commands of the frame are captured on their way into the commandlists
+	Submit the uploads of this frame and let the graphics queue wait on the GPU until the copies are done
+	Execute all commandlists with a single call in the order of the passes, present and signal the fence for this frame
+	Read which present the display showed last, for the input latency of the present policy
+	Get the back buffer the swapchain wants us to draw to next
+*/
 bool D3DClass::Render()
 {
-	HRESULT result = m_commandAllocator->Reset();
-	if (FAILED(result))
+	PROFILE_SCOPE("D3DClass::Render");
+
+	if (!m_frameRing.BeginFrame())
+	{
+		return false;
+	}
+
+	m_gpuTimer.BeginFrame(m_frameRing.GetFrameIndex());
+
+	if (!BuildRenderGraph())
 	{
 		return false;
 	}
 
-	result = m_commandList->Reset(m_commandAllocator, m_pipelineState);
+	unsigned int passCount = m_renderGraph.GetCompiledPassCount();
+
+	m_commandCapture.BeginFrame();
+
+	//	Without a jobsystem (or called from a thread it does not know) record the passes one after another
+	JobCounter passCounter(0);
+	if (m_jobSystem && m_jobSystem->ParallelFor(RecordPassJob, this, passCount, 1, &passCounter))
+	{
+		m_jobSystem->WaitForCounter(&passCounter);
+	}
+	else
+	{
+		RecordPassJob(this, 0, passCount, 0);
+	}
+
+	m_commandCapture.EndFrame();
+
+	ID3D12CommandList* pCommandLists[RENDER_PASS_COUNT];
+	for (unsigned int i = 0; i < passCount; i++)
+	{
+		if (!m_passRecorded[i])
+		{
+			return false;
+		}
+
+		pCommandLists[i] = m_commandList[i];
+	}
+
+	if (!m_uploadManager.Flush())
+	{
+		return false;
+	}
+
+	if (!m_uploadManager.WaitOnQueue(m_commandQueue))
+	{
+		return false;
+	}
+
+	m_commandQueue->ExecuteCommandLists(passCount, pCommandLists);
+
+	//	Vsync waits for the next refresh, the other modes present right away, tearing needs its flag on every present
+	unsigned long long presentId = m_presentPolicy.Present();
+	HRESULT result = m_swapChain->Present(m_presentPolicy.GetSyncInterval(), m_presentPolicy.AllowTearing() ? DXGI_PRESENT_ALLOW_TEARING : 0);
 	if (FAILED(result))
 	{
 		return false;
 	}
 
-	D3D12_RESOURCE_BARRIER barrier;
+	unsigned int presentCount = 0;
+	if (SUCCEEDED(m_swapChain->GetLastPresentCount(&presentCount)))
+	{
+		m_presentCountOffset = static_cast<long long>(presentCount) - static_cast<long long>(presentId);
+	}
 
-	barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
-	barrier.Transition.pResource = m_backBufferRenderTarget[m_bufferIndex];
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
-	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	ReadPresentStatistics();
 
-	m_commandList->ResourceBarrier(1, &barrier);
+	//	The transient descriptors of this frame are free again once the GPU passed the fence value of the frame
+	for (unsigned int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++)
+	{
+		m_descriptorHeaps[i].EndFrame(m_frameRing.GetFrameFenceValue());
+	}
 
-	D3D12_CPU_DESCRIPTOR_HANDLE renderTargetViewHandle = m_renderTargetViewHeap->GetCPUDescriptorHandleForHeapStart();
-	unsigned int renderTargetViewDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-	if (m_bufferIndex == 1)
+	if (!m_frameRing.EndFrame())
 	{
-		renderTargetViewHandle.ptr += renderTargetViewDescriptorSize;
+		return false;
 	}
 
-	m_commandList->OMSetRenderTargets(1, &renderTargetViewHandle, FALSE, nullptr);
+	m_bufferIndex = m_swapChain->GetCurrentBackBufferIndex();
 
-	float color[4];
-	color[0] = 0.5;
-	color[1] = 0.5;
-	color[2] = 0.5;
-	color[3] = 1.0;
+	return true;
+}
 
-	m_commandList->ClearRenderTargetView(renderTargetViewHandle, color, 0, nullptr);
+/*
+	Wait until the swapchain has room for the next present, so the input of the next frame is sampled as late as possible
+	Without the wait the CPU runs ahead until Present blocks, every queued present adds up to a refresh of input latency
+	Only waits on the waitable object, so it may run on another thread than Render
+*/
+bool D3DClass::WaitForFrameLatency()
+{
+	PROFILE_SCOPE("D3DClass::WaitForFrameLatency");
 
-	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
-	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-	m_commandList->ResourceBarrier(1, &barrier);
+	if (m_frameLatencyWaitableObject)
+	{
+		WaitForSingleObjectEx(m_frameLatencyWaitableObject, FRAME_LATENCY_WAIT_TIMEOUT, TRUE);
+	}
 
-	result = m_commandList->Close();
-	if (FAILED(result))
+	return true;
+}
+
+/*
+	The input time of the next present, TimerClass runs on the performance counter on windows, the same clock as the frame statistics
+*/
+void D3DClass::BeginFrame(unsigned long long _inputTime)
+{
+	m_presentPolicy.BeginFrame(_inputTime);
+}
+
+/*
+	The batches of this draw batcher are recorded every frame, nullptr records no draws
+*/
+void D3DClass::SetDrawBatcher(const DrawBatcherClass* _drawBatcher)
+{
+	m_drawBatcher = _drawBatcher;
+}
+
+/*
+	Created on a background job by the pipeline cache, draws with the handle are skipped until it is ready
+*/
+unsigned int D3DClass::RequestPipeline(const PipelineDesc& _desc)
+{
+	return m_pipelineCache.Request(_desc);
+}
+
+/*
+	Copy the vertices and the indices of the mesh into buffers of their own on the copy queue
+	The frame which draws the mesh first waits on the copy queue (Render), so the buffers are filled by then
+	Call it while loading, the buffers live until Shutdown
+*/
+bool D3DClass::CreateMesh(const MeshAssetHeader& _mesh, DrawMesh& _drawMesh)
+{
+	if (m_meshBufferCount + 2 > MAX_MESH_BUFFERS || _mesh.vertexCount == 0 || _mesh.indexCount == 0)
 	{
 		return false;
 	}
 
-	ID3D12CommandList* pCommandLists[1];
-	pCommandLists[0] = m_commandList;
-	
-	m_commandQueue->ExecuteCommandLists(1, pCommandLists);
+	ID3D12Resource* vertexBuffer = CreateMeshBuffer(GetAssetArray<MeshVertex>(&_mesh.header, _mesh.vertexOffset), static_cast<size_t>(_mesh.vertexCount) * sizeof(MeshVertex));
+	if (!vertexBuffer)
+	{
+		return false;
+	}
+	m_meshBuffers[m_meshBufferCount++] = vertexBuffer;
 
-	if (m_vSyncEnabled)
+	ID3D12Resource* indexBuffer = CreateMeshBuffer(GetAssetArray<unsigned char>(&_mesh.header, _mesh.indexOffset), static_cast<size_t>(_mesh.indexCount) * _mesh.indexSize);
+	if (!indexBuffer)
 	{
-		result = m_swapChain->Present(1, 0);
-		if (FAILED(result))
-		{
-			return false;
-		}
+		return false;
 	}
-	else
+	m_meshBuffers[m_meshBufferCount++] = indexBuffer;
+
+	FillDrawMesh(_mesh, vertexBuffer->GetGPUVirtualAddress(), indexBuffer->GetGPUVirtualAddress(), _drawMesh);
+
+	return true;
+}
+
+const CommandCaptureClass* D3DClass::GetCommandCapture() const
+{
+	return &m_commandCapture;
+}
+
+const PresentPolicyClass* D3DClass::GetPresentPolicy() const
+{
+	return &m_presentPolicy;
+}
+
+/*
+	Timings of the render passes on the GPU, a few frames old
+*/
+const GpuTimerClass& D3DClass::GetGpuTimer() const
+{
+	return m_gpuTimer;
+}
+
+/*
+	Uploads data to GPU resources, the copies are submitted with the next frame
+*/
+D3DUploadManagerClass& D3DClass::GetUploadManager()
+{
+	return m_uploadManager;
+}
+
+/*
+	Creates the pipelines of the passes, a pipeline which is not ready yet is nullptr
+*/
+PipelineCacheClass& D3DClass::GetPipelineCache()
+{
+	return m_pipelineCache;
+}
+
+/*
+	Describe the passes of this frame
+	The back buffer comes from the swapchain in the present state and has to go back to it
+	The clear pass renders to the back buffer, the present pass hands it back to the swapchain and is never culled
+	The geometry pass draws the batches of the draw batcher on top of the cleared back buffer, it is left out if there is nothing to draw
+	Every compiled pass needs its own commandlist, fail if there are more passes than commandlists
+*/
+bool D3DClass::BuildRenderGraph()
+{
+	m_renderGraph.Reset();
+
+	unsigned int backBuffer = m_renderGraph.ImportResource("BackBuffer", m_backBufferRenderTarget[m_bufferIndex], RESOURCE_STATE_PRESENT, RESOURCE_STATE_PRESENT);
+
+	unsigned int clearPass = m_renderGraph.AddPass("ClearPass", ClearPass, this);
+	if (!m_renderGraph.Write(clearPass, backBuffer, RESOURCE_STATE_RENDER_TARGET))
 	{
-		result = m_swapChain->Present(0, 0);
-		if (FAILED(result))
+		return false;
+	}
+
+	if (m_drawBatcher && m_drawBatcher->GetBatchCount() > 0)
+	{
+		unsigned int geometryPass = m_renderGraph.AddPass("GeometryPass", GeometryPass, this);
+		if (!m_renderGraph.Write(geometryPass, backBuffer, RESOURCE_STATE_RENDER_TARGET))
 		{
 			return false;
 		}
 	}
 
-	unsigned long long fenceToWaitFor = m_fenceValue;
+	unsigned int presentPass = m_renderGraph.AddPass("PresentPass", nullptr, nullptr, true);
+	if (!m_renderGraph.Read(presentPass, backBuffer, RESOURCE_STATE_PRESENT))
+	{
+		return false;
+	}
 
-	result = m_commandQueue->Signal(m_fence, fenceToWaitFor);
-	if (FAILED(result))
+	if (!m_renderGraph.Compile())
 	{
 		return false;
 	}
 
-	m_fenceValue++;
+	return m_renderGraph.GetCompiledPassCount() <= RENDER_PASS_COUNT;
+}
 
-	if (m_fence->GetCompletedValue() < fenceToWaitFor)
+/*
+	Job which records the compiled passes [_begin, _end), _data is the D3DClass
+*/
+void D3DClass::RecordPassJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	D3DClass* direct3D = static_cast<D3DClass*>(_data);
+
+	for (unsigned int i = _begin; i < _end; i++)
 	{
-		result = m_fence->SetEventOnCompletion(fenceToWaitFor, m_fenceEvent);
-		if (FAILED(result))
-		{
-			return false;
-		}
+		direct3D->m_passRecorded[i] = direct3D->RecordPass(i);
+	}
+}
 
-		WaitForSingleObject(m_fenceEvent, INFINITE);
+/*
+	Reset the allocator of this frame in flight and pass and reset the commandlist of the pass with it
+	The commandlist starts without any state, every pass gets the root signature
+	Record the barriers and commands of the pass between the timestamps of its GPU timer zone and close the commandlist
+	The last pass resolves the timestamps of the frame, it is executed after the commandlists of every other pass
+	Only touches the allocator and commandlist of this pass, so passes can be recorded on different threads
+*/
+bool D3DClass::RecordPass(unsigned int _passIndex)
+{
+	PROFILE_SCOPE("D3DClass::RecordPass");
+
+	ID3D12CommandAllocator* commandAllocator = m_commandAllocator[m_frameRing.GetFrameIndex()][_passIndex];
+	ID3D12GraphicsCommandList* commandList = m_commandList[_passIndex];
+
+	HRESULT result = commandAllocator->Reset();
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = commandList->Reset(commandAllocator, m_pipelineState);
+	if (FAILED(result))
+	{
+		return false;
 	}
 
-	m_bufferIndex == 0 ? m_bufferIndex = 1 : m_bufferIndex = 0;
+	commandList->SetGraphicsRootSignature(m_rootSignature);
+
+	CommandRecorderClass* commandRecorder = m_commandCapture.GetRecorder(_passIndex, &m_commandRecorder[_passIndex]);
+	m_gpuTimer.BeginZone(commandRecorder, _passIndex, m_renderGraph.GetCompiledPassName(_passIndex));
+
+	m_renderGraph.ExecutePass(_passIndex, commandRecorder);
+
+	m_gpuTimer.EndZone(commandRecorder, _passIndex);
+
+	if (_passIndex == m_renderGraph.GetCompiledPassCount() - 1)
+	{
+		m_gpuTimer.Resolve(commandRecorder, m_renderGraph.GetCompiledPassCount());
+	}
+
+	result = commandList->Close();
+	if (FAILED(result))
+	{
+		return false;
+	}
 
 	return true;
 }
 
+/*
+	The back buffer the swapchain wants us to draw to and its render target view
+*/
+RenderTargetView D3DClass::GetBackBufferView() const
+{
+	const D3DDescriptorHeapClass& renderTargetViewHeap = m_descriptorHeaps[D3D12_DESCRIPTOR_HEAP_TYPE_RTV];
+
+	RenderTargetView view;
+	view.resource = m_backBufferRenderTarget[m_bufferIndex];
+	view.descriptor = renderTargetViewHeap.GetCpuHandle(m_backBufferRenderTargetView[m_bufferIndex]).ptr;
+
+	return view;
+}
+
+/*
+	Clear the back buffer, the render graph already transitioned it to a render target
+	_data is the D3DClass
+*/
+void D3DClass::ClearPass(CommandRecorderClass* _recorder, void* _data)
+{
+	D3DClass* direct3D = static_cast<D3DClass*>(_data);
+	RenderTargetView backBuffer = direct3D->GetBackBufferView();
+
+	_recorder->SetRenderTarget(backBuffer, static_cast<unsigned int>(direct3D->m_screenWidth), static_cast<unsigned int>(direct3D->m_screenHeight));
+	_recorder->ClearRenderTarget(backBuffer, D3D_CLEAR_COLOR);
+}
+
+/*
+	Draw the batches of the draw batcher into the back buffer
+	_data is the D3DClass
+*/
+void D3DClass::GeometryPass(CommandRecorderClass* _recorder, void* _data)
+{
+	D3DClass* direct3D = static_cast<D3DClass*>(_data);
+
+	_recorder->SetRenderTarget(direct3D->GetBackBufferView(), static_cast<unsigned int>(direct3D->m_screenWidth), static_cast<unsigned int>(direct3D->m_screenHeight));
+
+	direct3D->m_drawBatcher->Record(_recorder, direct3D->m_pipelineCache);
+}
+
 /*
 	Release all the memory and clean up the pointer from the private member variables
+	Wait until the GPU finished all frames in flight, else we would release resources which are still in use
 	Force the swapchain to change to windowed mode, else there will be thrown multiple exceptions
 */
 void D3DClass::Shutdown()
 {
-	if (m_swapChain)
+	m_frameRing.WaitForIdle();
+	m_frameRing.Shutdown();
+
+	m_uploadManager.Shutdown();
+
+	for (unsigned int i = 0; i < m_meshBufferCount; i++)
 	{
-		m_swapChain->SetFullscreenState(false, nullptr);
+		m_meshBuffers[i]->Release();
+		m_meshBuffers[i] = nullptr;
 	}
-	int error = CloseHandle(m_fenceEvent);
-	if (error == 0)
-	{
+	m_meshBufferCount = 0;
 
+	m_pipelineCache.Shutdown();
+	m_pipelineCompiler.Shutdown();
+
+	m_commandCapture.Shutdown();
+	m_gpuTimer.Shutdown();
+	for (unsigned int i = 0; i < RENDER_PASS_COUNT; i++)
+	{
+		m_commandRecorder[i].Shutdown();
 	}
-	if (m_fence)
+	m_timestampQueries.Shutdown();
+
+	m_scratchAllocator.Shutdown();
+
+	if (m_swapChain)
 	{
-		m_fence->Release();
-		m_fence = nullptr;
+		m_swapChain->SetFullscreenState(false, nullptr);
 	}
+
+	m_fence.Shutdown();
+
 	if (m_pipelineState)
 	{
 		m_pipelineState->Release();
 		m_pipelineState = nullptr;
 	}
-	if (m_commandList)
+	if (m_rootSignature)
 	{
-		m_commandList->Release();
-		m_commandList = nullptr;
+		m_rootSignature->Release();
+		m_rootSignature = nullptr;
 	}
-	if (m_commandAllocator)
+	for (unsigned int i = 0; i < RENDER_PASS_COUNT; i++)
 	{
-		m_commandAllocator->Release();
-		m_commandAllocator = nullptr;
+		if (m_commandList[i])
+		{
+			m_commandList[i]->Release();
+			m_commandList[i] = nullptr;
+		}
 	}
-	if (m_backBufferRenderTarget[0])
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
-		m_backBufferRenderTarget[0]->Release();
-		m_backBufferRenderTarget[0] = nullptr;
+		for (unsigned int j = 0; j < RENDER_PASS_COUNT; j++)
+		{
+			if (m_commandAllocator[i][j])
+			{
+				m_commandAllocator[i][j]->Release();
+				m_commandAllocator[i][j] = nullptr;
+			}
+		}
 	}
-	if (m_backBufferRenderTarget[1])
+	for (unsigned int i = 0; i < MAX_SWAP_CHAIN_BUFFERS; i++)
 	{
-		m_backBufferRenderTarget[1]->Release();
-		m_backBufferRenderTarget[1] = nullptr;
+		if (m_backBufferRenderTarget[i])
+		{
+			m_backBufferRenderTarget[i]->Release();
+			m_backBufferRenderTarget[i] = nullptr;
+		}
 	}
-	if (m_renderTargetViewHeap)
+	for (unsigned int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++)
 	{
-		m_renderTargetViewHeap->Release();
-		m_renderTargetViewHeap = nullptr;
+		m_descriptorHeaps[i].Shutdown();
+	}
+	if (m_frameLatencyWaitableObject)
+	{
+		CloseHandle(m_frameLatencyWaitableObject);
+		m_frameLatencyWaitableObject = nullptr;
 	}
 	if (m_swapChain)
 	{
 		m_swapChain->Release();
 		m_swapChain = nullptr;
 	}
+	m_presentPolicy.Shutdown();
 	if (m_commandQueue)
 	{
 		m_commandQueue->Release();
@@ -325,7 +723,7 @@ bool D3DClass::CreateDevice(HRESULT _result, HWND _windowHandle)
 	_result = D3D12CreateDevice(nullptr, featureLevel, _uuidof(ID3D12Device), (void**)&m_device);
 	if (FAILED(_result))
 	{
-		MessageBox(_windowHandle, L"Could not create a DirectX 12.1 device. Video card does not support DirectX 12.1.", L"DirectX Device Failure", MB_OK);
+		MessageBox(_windowHandle, L"Could not create a DirectX 12.1 device. Video card does not support DirectX 12.1, rendering on the CPU instead.", L"DirectX Device Failure", MB_OK);
 		return false;
 	}
 
@@ -362,8 +760,9 @@ bool D3DClass::CreateCommandQueue(HRESULT _result)
 	Query for enumerator and denominator and pass them to DirectX during the setup, so they will be calculated properly
 	If we don't do this and just set the values, they might not exist on the computer, DirectX will throw errors and perform a buffer copy instead of a flip
 	This will decrease our performance
+	The list of display modes is only needed temporarily, so it lives in the scratch allocator instead of the heap
 */
-bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator, unsigned int& _denominator, IDXGIAdapter* _adapter, int _screenHeight, int _screenWidth)
+bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator, unsigned int& _denominator, IDXGIAdapter* _adapter, int _screenHeight, int _screenWidth, LinearAllocatorClass& _scratchAllocator)
 {
 	//	get the primary adapter output(monitor)
 	IDXGIOutput* adapterOutput;
@@ -378,13 +777,15 @@ bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator
 	_result = adapterOutput->GetDisplayModeList(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_ENUM_MODES_INTERLACED, &numModes, nullptr);
 	if (FAILED(_result))
 	{
+		adapterOutput->Release();
 		return false;
 	}
 
 	//	create a list to hold all possible display modes for this monitor/video card combination
-	DXGI_MODE_DESC* displayModeList = new DXGI_MODE_DESC[numModes];
+	DXGI_MODE_DESC* displayModeList = _scratchAllocator.AllocateArray<DXGI_MODE_DESC>(numModes);
 	if (!displayModeList)
 	{
+		adapterOutput->Release();
 		return false;
 	}
 
@@ -392,6 +793,8 @@ bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator
 	_result = adapterOutput->GetDisplayModeList(DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_ENUM_MODES_INTERLACED, &numModes, displayModeList);
 	if (FAILED(_result))
 	{
+		_scratchAllocator.Reset();
+		adapterOutput->Release();
 		return false;
 	}
 
@@ -410,7 +813,7 @@ bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator
 	}
 
 	//	release displayModeList and adapterOutput 
-	delete[] displayModeList;
+	_scratchAllocator.Reset();
 	displayModeList = nullptr;
 
 	adapterOutput->Release();
@@ -423,7 +826,7 @@ bool D3DClass::GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator
 	First get the description of the graphics card
 	Store the dedicated graphics card memory in megabytes
 	Convert the name of the video card to a character array and store it in m_videoCardDescription
-	Finally release the adapter
+	The adapter stays owned by Initialize
 */
 bool D3DClass::GetNameAndVideoCardMemory(HRESULT _result, IDXGIAdapter* _adapter)
 {
@@ -443,37 +846,35 @@ bool D3DClass::GetNameAndVideoCardMemory(HRESULT _result, IDXGIAdapter* _adapter
 		return false;
 	}
 
-	_adapter->Release();
-	_adapter = nullptr;
-
 	return true;
 }
 
 /*
-Initialize SwapChain = Swapchain means creating two buffers,
-One is beeing written in the background and one is showing the written data to the monitor,
-After finished writing swap them and do the same
+Initialize SwapChain = Swapchain means creating the back buffers (2 - 4),
+One is showing the written data to the monitor while the others are written in the background or wait to be shown,
+After finished writing present them one after another
 
 Create a new swapchain description, empty its memory and fill it out
-Then create a new swapchain with this description, the factory and the commandqueue which is paired with the graphics card
+Then create a new swapchain for the window with this description, the factory and the commandqueue which is paired with the graphics card
 Get the version 3 interface of the swapchain so we can access newer methods
 Reference it to our member variable swapchain
-Free the factory and the local swapchain because we do not need them anymore
+Limit the presents which may wait to be shown to the frame latency of the policy and get the object which is signaled when there is room for another one
+Free the local swapchain because we do not need it anymore, the factory stays owned by Initialize
 */
 bool D3DClass::InitializeSwapChain(HRESULT _result, unsigned int _numerator, unsigned int _denominator, IDXGIFactory4* _factory, HWND _windowHandle, int _screenHeight, int _screenWidth, bool _fullscreen)
 {
-	DXGI_SWAP_CHAIN_DESC swapChainDesc;
+	DXGI_SWAP_CHAIN_DESC1 swapChainDesc;
 	ZeroMemory(&swapChainDesc, sizeof(swapChainDesc));
 
-	//	Use double buffering
-	swapChainDesc.BufferCount = 2;
+	//	Use as many back buffers as the present settings ask for, a third buffer lets the GPU render while one buffer waits to be shown
+	swapChainDesc.BufferCount = m_presentPolicy.GetBufferCount();
 
 	//	Set the height and width of the back buffer in the SwapChain
-	swapChainDesc.BufferDesc.Height = _screenHeight;
-	swapChainDesc.BufferDesc.Width = _screenWidth;
+	swapChainDesc.Height = _screenHeight;
+	swapChainDesc.Width = _screenWidth;
 
 	//	Set a 32-bit surface for the back buffers
-	swapChainDesc.BufferDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	swapChainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 
 	//	Set usage of the back buffers to be render target outputs
 	swapChainDesc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
@@ -481,122 +882,255 @@ bool D3DClass::InitializeSwapChain(HRESULT _result, unsigned int _numerator, uns
 	//	Set the swap effect to discard the previous buffer content after swapping
 	swapChainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 
-	//	Set the handle for the window to render to
-	swapChainDesc.OutputWindow = _windowHandle;
+	//	Turn multisampling off
+	swapChainDesc.SampleDesc.Count = 1;
+	swapChainDesc.SampleDesc.Quality = 0;
 
-	//	Set to fullscreen or windowed mode
-	if (_fullscreen)
-	{
-		swapChainDesc.Windowed = false;
-	}
-	else
+	//	Stretch the back buffers to the window
+	swapChainDesc.Scaling = DXGI_SCALING_STRETCH;
+	swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+
+	//	The waitable object lets the frame wait for the display before it samples the input instead of blocking in Present
+	//	Presents which do not wait for the refresh have to be allowed to tear when the swapchain is created
+	swapChainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+	if (m_presentPolicy.AllowTearing())
 	{
-		swapChainDesc.Windowed = true;
+		swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
 	}
 
+	DXGI_SWAP_CHAIN_FULLSCREEN_DESC fullscreenDesc;
+	ZeroMemory(&fullscreenDesc, sizeof(fullscreenDesc));
+
+	//	Set to fullscreen or windowed mode
+	fullscreenDesc.Windowed = _fullscreen ? FALSE : TRUE;
+
 	//	Set the refresh rate
 	//	How often the back buffer draws to the screen
-	//	If vsync is enabled lock it to the systemsettings (default: 60hz)
-	//	This will render 60 times a second
-	//	If vsync is not enabled do not lock it to the systemsettings and draw as much as we can (can cause visual effects)
-	if (m_vSyncEnabled)
+	//	With vsync lock it to the refresh rate of the monitor (default: 60hz)
+	//	Otherwise do not lock it and draw as much as we can (can cause visual effects)
+	if (m_presentPolicy.GetMode() == PRESENT_MODE_VSYNC)
 	{
-		swapChainDesc.BufferDesc.RefreshRate.Numerator = _numerator;
-		swapChainDesc.BufferDesc.RefreshRate.Denominator = _denominator;
+		fullscreenDesc.RefreshRate.Numerator = _numerator;
+		fullscreenDesc.RefreshRate.Denominator = _denominator;
 	}
 	else
 	{
-		swapChainDesc.BufferDesc.RefreshRate.Numerator = 0;
-		swapChainDesc.BufferDesc.RefreshRate.Denominator = 1;
+		fullscreenDesc.RefreshRate.Numerator = 0;
+		fullscreenDesc.RefreshRate.Denominator = 1;
 	}
 
-	//	Turn multisampling off
-	swapChainDesc.SampleDesc.Count = 1;
-	swapChainDesc.SampleDesc.Quality = 0;
-
 	//	Set the scan line ordering and scaling to unspecified
-	swapChainDesc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	swapChainDesc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	fullscreenDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+	fullscreenDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
 
-	//	We do not want to set the advanced flags
-	swapChainDesc.Flags = 0;
-
-	IDXGISwapChain* swapChain;
-	_result = _factory->CreateSwapChain(m_commandQueue, &swapChainDesc, &swapChain);
+	IDXGISwapChain1* swapChain;
+	_result = _factory->CreateSwapChainForHwnd(m_commandQueue, _windowHandle, &swapChainDesc, &fullscreenDesc, nullptr, &swapChain);
 	if (FAILED(_result))
 	{
 		return false;
 	}
 
+	//	Alt+Enter would switch to exclusive fullscreen, which does not take the tearing flag
+	if (m_presentPolicy.AllowTearing())
+	{
+		_factory->MakeWindowAssociation(_windowHandle, DXGI_MWA_NO_ALT_ENTER);
+	}
+
 	_result = swapChain->QueryInterface(_uuidof(IDXGISwapChain3), (void**)&m_swapChain);
+	swapChain->Release();
+	swapChain = nullptr;
 	if (FAILED(_result))
 	{
 		return false;
 	}
 
-	swapChain = nullptr;
+	_result = m_swapChain->SetMaximumFrameLatency(m_presentPolicy.GetFrameLatency());
+	if (FAILED(_result))
+	{
+		return false;
+	}
 
-	_factory->Release();
-	_factory = nullptr;
+	m_frameLatencyWaitableObject = m_swapChain->GetFrameLatencyWaitableObject();
+	if (!m_frameLatencyWaitableObject)
+	{
+		return false;
+	}
 
 	return true;
 }
 
 /*
 RenderTargetViews allow GPU to use the backbuffers as resources to render to
-First create a descriptor heap description which holds the two backbuffers in memory
-Get a handle to the descriptor heap memory and create a view by using the pointer to that memory
+Every view is a descriptor in a descriptor heap, the descriptor heaps of all types are created here
 
 Common theme for all resource binding in DirectX12
 
-Create the heap description, clear its memory and fill it out
-Create the render target view heap for the back buffers
-Get a handle to the starting memory location in the render target view heap to identify where the render target views will be located
-Get the size of the memory location for the render target view descriptors
-Get a pointer to the first back buffer from the swap chain
-Create a render target view for the first back buffer
-Increment the view handle to the next descriptor location in the heap
-Get a pointer to the second back buffer from the swap chain
-Create a render target view fot he second back buffer
+Create a descriptor heap for every type with the sizes of DESCRIPTOR_HEAP_PERSISTENT_SIZES and DESCRIPTOR_HEAP_TRANSIENT_SIZES
+Allocate a render target view for every back buffer from the render target view heap
+Get a pointer to every back buffer from the swap chain and create its render target view
 */
 bool D3DClass::SetupRenderTargetView(HRESULT _result)
 {
-	D3D12_DESCRIPTOR_HEAP_DESC renderTargetViewHeapDesc;
-	ZeroMemory(&renderTargetViewHeapDesc, sizeof(renderTargetViewHeapDesc));
-
-	//	Set the number of descriptors to two for our two back buffers
-	renderTargetViewHeapDesc.NumDescriptors = 2;
+	for (unsigned int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; i++)
+	{
+		if (!m_descriptorHeaps[i].Initialize(m_device, static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(i), DESCRIPTOR_HEAP_PERSISTENT_SIZES[i], DESCRIPTOR_HEAP_TRANSIENT_SIZES[i], &m_fence))
+		{
+			return false;
+		}
+	}
 
-	//	Set the type to render target view
-	renderTargetViewHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
-	renderTargetViewHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	D3DDescriptorHeapClass& renderTargetViewHeap = m_descriptorHeaps[D3D12_DESCRIPTOR_HEAP_TYPE_RTV];
 
-	_result = m_device->CreateDescriptorHeap(&renderTargetViewHeapDesc, _uuidof(ID3D12DescriptorHeap), (void**)&m_renderTargetViewHeap);
-	if (FAILED(_result))
+	for (unsigned int i = 0; i < m_presentPolicy.GetBufferCount(); i++)
 	{
-		return false;
+		_result = m_swapChain->GetBuffer(i, _uuidof(ID3D12Resource), (void**)&m_backBufferRenderTarget[i]);
+		if (FAILED(_result))
+		{
+			return false;
+		}
+
+		m_backBufferRenderTargetView[i] = renderTargetViewHeap.Allocate();
+		if (m_backBufferRenderTargetView[i] == INVALID_DESCRIPTOR)
+		{
+			return false;
+		}
+
+		m_device->CreateRenderTargetView(m_backBufferRenderTarget[i], nullptr, renderTargetViewHeap.GetCpuHandle(m_backBufferRenderTargetView[i]));
 	}
 
-	D3D12_CPU_DESCRIPTOR_HANDLE renderTargetViewHandle = m_renderTargetViewHeap->GetCPUDescriptorHandleForHeapStart();
-	unsigned int renderTargetViewDescriptorSize = m_device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+	return true;
+}
 
-	_result = m_swapChain->GetBuffer(0, _uuidof(ID3D12Resource), (void**)&m_backBufferRenderTarget[0]);
-	if (FAILED(_result))
+/*
+Tearing (DXGI_FEATURE_PRESENT_ALLOW_TEARING) needs DXGI 1.5 and a driver and windows version which support it
+Variable refresh displays need it as well, the display only waits for a frame if the present itself does not
+*/
+bool D3DClass::IsTearingSupported(IDXGIFactory4* _factory)
+{
+	IDXGIFactory5* factory5;
+	HRESULT result = _factory->QueryInterface(_uuidof(IDXGIFactory5), (void**)&factory5);
+	if (FAILED(result))
 	{
 		return false;
 	}
 
-	m_device->CreateRenderTargetView(m_backBufferRenderTarget[0], nullptr, renderTargetViewHandle);
+	BOOL allowTearing = FALSE;
+	result = factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING, &allowTearing, sizeof(allowTearing));
+	factory5->Release();
 
-	renderTargetViewHandle.ptr += renderTargetViewDescriptorSize;
+	return SUCCEEDED(result) && allowTearing;
+}
 
-	_result = m_swapChain->GetBuffer(1, _uuidof(ID3D12Resource), (void**)&m_backBufferRenderTarget[1]);
+/*
+The root signature describes what the shaders of a pipeline can access
+Every pipeline needs one, so far there is a single one with vertex input and the draw constants (material and first instance) in b0
+*/
+bool D3DClass::CreateRootSignature(HRESULT _result)
+{
+	D3D12_ROOT_PARAMETER drawConstants;
+	ZeroMemory(&drawConstants, sizeof(drawConstants));
+	drawConstants.ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+	drawConstants.Constants.ShaderRegister = 0;
+	drawConstants.Constants.RegisterSpace = 0;
+	drawConstants.Constants.Num32BitValues = D3D_DRAW_CONSTANT_COUNT;
+	drawConstants.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
+
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	ZeroMemory(&rootSignatureDesc, sizeof(rootSignatureDesc));
+	rootSignatureDesc.NumParameters = 1;
+	rootSignatureDesc.pParameters = &drawConstants;
+	rootSignatureDesc.NumStaticSamplers = 0;
+	rootSignatureDesc.pStaticSamplers = nullptr;
+	rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
+
+	ID3DBlob* signature = nullptr;
+	_result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1, &signature, nullptr);
 	if (FAILED(_result))
 	{
 		return false;
 	}
 
-	m_device->CreateRenderTargetView(m_backBufferRenderTarget[1], nullptr, renderTargetViewHandle);
+	_result = m_device->CreateRootSignature(0, signature->GetBufferPointer(), signature->GetBufferSize(), _uuidof(ID3D12RootSignature), (void**)&m_rootSignature);
+	signature->Release();
+	if (FAILED(_result))
+	{
+		return false;
+	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+/*
+	The swapchain reports the last present which reached the screen and the QPC time of the refresh it was shown at
+	Presents before it which were never reported are left out of the latency statistics of the policy
+	Fails while nothing was shown yet (e.g. the window is occluded), there is nothing to read then
+*/
+void D3DClass::ReadPresentStatistics()
+{
+	DXGI_FRAME_STATISTICS statistics;
+	if (FAILED(m_swapChain->GetFrameStatistics(&statistics)) || statistics.PresentCount == 0)
+	{
+		return;
+	}
+
+	//	Reported presents from before the first present of the policy have no id
+	long long presentId = static_cast<long long>(statistics.PresentCount) - m_presentCountOffset;
+	if (presentId < 0)
+	{
+		return;
+	}
+
+	m_presentPolicy.FrameShown(static_cast<unsigned long long>(presentId), QpcToMicroseconds(statistics.SyncQPCTime.QuadPart));
+}
+
+/*
+	Ticks of the performance counter to microseconds, whole seconds first so the multiplication does not overflow
+*/
+unsigned long long D3DClass::QpcToMicroseconds(long long _qpc) const
+{
+	unsigned long long ticks = static_cast<unsigned long long>(_qpc);
+	unsigned long long frequency = static_cast<unsigned long long>(m_performanceFrequency);
+
+	return ticks / frequency * 1000000 + ticks % frequency * 1000000 / frequency;
+}
+
+/*
+	Buffer in the default heap, in the common state so the copy queue can fill it, the direct queue promotes it on its first read
+*/
+ID3D12Resource* D3DClass::CreateMeshBuffer(const void* _data, size_t _size)
+{
+	D3D12_HEAP_PROPERTIES heapProperties;
+	ZeroMemory(&heapProperties, sizeof(heapProperties));
+	heapProperties.Type = D3D12_HEAP_TYPE_DEFAULT;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+
+	D3D12_RESOURCE_DESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Width = _size;
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	ID3D12Resource* buffer = nullptr;
+	HRESULT result = m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_COMMON, nullptr, _uuidof(ID3D12Resource), (void**)&buffer);
+	if (FAILED(result))
+	{
+		return nullptr;
+	}
+
+	if (!m_uploadManager.UploadBuffer(buffer, 0, _data, _size))
+	{
+		buffer->Release();
+		return nullptr;
+	}
+
+	return buffer;
+}
+
+#endif
\ No newline at end of file
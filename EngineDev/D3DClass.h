@@ -1,5 +1,7 @@
 #pragma once
 
+#ifdef _WIN32
+
 #pragma region Direct X 12 linking
 #pragma comment(lib, "d3d12.lib")			// contains all Direct3D functions for setting up and drawing in Direct X 12
 #pragma comment(lib, "dxgi.lib")			// contains tools to interface with hardware
@@ -8,44 +10,123 @@
 
 #pragma region includes
 #include <d3d12.h>
-#include <dxgi1_4.h>
+#include <dxgi1_5.h>
+#include "RendererClass.h"
+#include "D3DFenceClass.h"
+#include "FrameRingClass.h"
+#include "JobSystemClass.h"
+#include "LinearAllocatorClass.h"
+#include "D3DTimestampQueriesClass.h"
+#include "D3DCommandRecorderClass.h"
+#include "GpuTimerClass.h"
+#include "RenderGraphClass.h"
+#include "D3DDescriptorHeapClass.h"
+#include "D3DUploadManagerClass.h"
+#include "D3DPipelineCompilerClass.h"
+#include "PipelineCacheClass.h"
+#include "CommandCaptureClass.h"
+#include "PresentPolicyClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int RENDER_PASS_COUNT = 3;	// commandlists, every compiled pass of the render graph is recorded into its own, in parallel on the jobsystem
+//	Descriptors of every heap type (CBV_SRV_UAV, sampler, RTV, DSV), transient descriptors are only needed in shader visible heaps
+const unsigned int DESCRIPTOR_HEAP_PERSISTENT_SIZES[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] = { 4096, 256, 64, 16 };
+const unsigned int DESCRIPTOR_HEAP_TRANSIENT_SIZES[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] = { 4096, 256, 0, 0 };
+const size_t D3D_SCRATCH_MEMORY_SIZE = 64 * 1024;	// temporary memory for queries during the initialization
+const unsigned long FRAME_LATENCY_WAIT_TIMEOUT = 1000;	// milliseconds, a display which stops presenting (e.g. minimized window) does not hang the frame loop
+const unsigned int MAX_MESH_BUFFERS = MAX_DRAW_MESHES * 2;	// vertex and index buffers of the meshes of CreateMesh
 #pragma endregion
 
-class D3DClass
+class D3DClass : public RendererClass
 {
 public:
 	D3DClass();
 	~D3DClass();
 
-	bool Initialize(int _screenHeight, int _screenWidth, HWND _windowHandle, bool _vSync, bool _fullscreen);
-	void Shutdown();
+	bool Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem) override;
+	void Shutdown() override;
 
-	bool Render();
+	bool Render() override;
+	bool WaitForFrameLatency() override;
+	void BeginFrame(unsigned long long _inputTime) override;
+	void SetDrawBatcher(const DrawBatcherClass* _drawBatcher) override;
+	unsigned int RequestPipeline(const PipelineDesc& _desc) override;
+	bool CreateMesh(const MeshAssetHeader& _mesh, DrawMesh& _drawMesh) override;
+	const CommandCaptureClass* GetCommandCapture() const override;
+	const PresentPolicyClass* GetPresentPolicy() const override;
+
+	const GpuTimerClass& GetGpuTimer() const;
+	D3DUploadManagerClass& GetUploadManager();
+	PipelineCacheClass& GetPipelineCache();
 
 private:
-	bool m_vSyncEnabled;
+	int m_screenHeight;
+	int m_screenWidth;
 	char m_videoCardDescription[128];
 	unsigned int m_bufferIndex;
-	unsigned long long m_fenceValue;
 	unsigned int m_videoCardMemory;
 
-	HANDLE m_fenceEvent;
-
 	ID3D12Device* m_device;
 	ID3D12CommandQueue* m_commandQueue;
-	ID3D12DescriptorHeap* m_renderTargetViewHeap;
-	ID3D12Resource* m_backBufferRenderTarget[2];
-	ID3D12CommandAllocator* m_commandAllocator;
-	ID3D12GraphicsCommandList* m_commandList;
+	D3DDescriptorHeapClass m_descriptorHeaps[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES];
+	ID3D12Resource* m_backBufferRenderTarget[MAX_SWAP_CHAIN_BUFFERS];
+	unsigned int m_backBufferRenderTargetView[MAX_SWAP_CHAIN_BUFFERS];	// descriptors in the render target view heap
+	ID3D12CommandAllocator* m_commandAllocator[MAX_FRAMES_IN_FLIGHT][RENDER_PASS_COUNT];
+	ID3D12GraphicsCommandList* m_commandList[RENDER_PASS_COUNT];
 	ID3D12PipelineState* m_pipelineState;
-	ID3D12Fence* m_fence;
+	ID3D12RootSignature* m_rootSignature;
+
+	JobSystemClass* m_jobSystem;
+	bool m_passRecorded[RENDER_PASS_COUNT];
+
+	LinearAllocatorClass m_scratchAllocator;
+
+	D3DFenceClass m_fence;
+	FrameRingClass m_frameRing;
+
+	D3DUploadManagerClass m_uploadManager;
+
+	D3DTimestampQueriesClass m_timestampQueries;
+	D3DCommandRecorderClass m_commandRecorder[RENDER_PASS_COUNT];
+	GpuTimerClass m_gpuTimer;
+
+	RenderGraphClass m_renderGraph;
+
+	D3DPipelineCompilerClass m_pipelineCompiler;
+	PipelineCacheClass m_pipelineCache;
+
+	const DrawBatcherClass* m_drawBatcher;
+
+	ID3D12Resource* m_meshBuffers[MAX_MESH_BUFFERS];
+	unsigned int m_meshBufferCount;
+
+	CommandCaptureClass m_commandCapture;
 
 	IDXGISwapChain3* m_swapChain;
+	HANDLE m_frameLatencyWaitableObject;	// signaled whenever the swapchain has room for another present
+	PresentPolicyClass m_presentPolicy;
+	long long m_presentCountOffset;	// present count of the swapchain minus the present id of the policy, negative if the swapchain counted fewer presents
+	long long m_performanceFrequency;
 
 	bool CreateDevice(HRESULT _result, HWND _windowHandle);
 	bool CreateCommandQueue(HRESULT _result);
-	static bool GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator, unsigned int& _denominator, IDXGIAdapter* _adapter, int _screenHeight, int _screenWidth);
+	static bool GetRefreshRateOfMonitor(HRESULT _result, unsigned int& _numerator, unsigned int& _denominator, IDXGIAdapter* _adapter, int _screenHeight, int _screenWidth, LinearAllocatorClass& _scratchAllocator);
 	bool GetNameAndVideoCardMemory(HRESULT _result, IDXGIAdapter* _adapter);
+	static bool IsTearingSupported(IDXGIFactory4* _factory);
 	bool InitializeSwapChain(HRESULT _result, unsigned int _numerator, unsigned int _denominator, IDXGIFactory4* _factory, HWND _windowHandle, int _screenHeight, int _screenWidth, bool _fullscreen);
 	bool SetupRenderTargetView(HRESULT _result);
-};
\ No newline at end of file
+	bool CreateRootSignature(HRESULT _result);
+	ID3D12Resource* CreateMeshBuffer(const void* _data, size_t _size);
+	void ReadPresentStatistics();
+	unsigned long long QpcToMicroseconds(long long _qpc) const;
+
+	bool BuildRenderGraph();
+	static void RecordPassJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	bool RecordPass(unsigned int _passIndex);
+	RenderTargetView GetBackBufferView() const;
+	static void ClearPass(CommandRecorderClass* _recorder, void* _data);
+	static void GeometryPass(CommandRecorderClass* _recorder, void* _data);
+};
+
+#endif
\ No newline at end of file
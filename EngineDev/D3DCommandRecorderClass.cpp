@@ -0,0 +1,229 @@
+#ifdef _WIN32
+
+#include "D3DCommandRecorderClass.h"
+
+/*
+	Constructor
+*/
+D3DCommandRecorderClass::D3DCommandRecorderClass()
+{
+	m_commandList = nullptr;
+	m_timestampQueries = nullptr;
+}
+
+/*
+	Destructor
+*/
+D3DCommandRecorderClass::~D3DCommandRecorderClass()
+{
+
+}
+
+bool D3DCommandRecorderClass::Initialize(ID3D12GraphicsCommandList* _commandList, D3DTimestampQueriesClass* _timestampQueries)
+{
+	if (!_commandList || !_timestampQueries)
+	{
+		return false;
+	}
+
+	m_commandList = _commandList;
+	m_timestampQueries = _timestampQueries;
+
+	return true;
+}
+
+void D3DCommandRecorderClass::Shutdown()
+{
+	m_commandList = nullptr;
+	m_timestampQueries = nullptr;
+}
+
+ID3D12GraphicsCommandList* D3DCommandRecorderClass::GetCommandList() const
+{
+	return m_commandList;
+}
+
+/*
+	Translate the barriers into DirectX 12 barriers and record them with as few ResourceBarrier calls as possible
+	Barriers of resources the backend did not create yet (no handle) are skipped
+*/
+void D3DCommandRecorderClass::ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount)
+{
+	D3D12_RESOURCE_BARRIER barriers[D3D_BARRIER_BATCH_SIZE];
+	unsigned int barrierCount = 0;
+
+	for (unsigned int i = 0; i < _barrierCount; i++)
+	{
+		const ResourceBarrier& barrier = _barriers[i];
+		if (!barrier.resource)
+		{
+			continue;
+		}
+
+		D3D12_RESOURCE_BARRIER& d3dBarrier = barriers[barrierCount];
+		d3dBarrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+
+		if (barrier.aliasing)
+		{
+			d3dBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+			d3dBarrier.Aliasing.pResourceBefore = static_cast<ID3D12Resource*>(barrier.aliasedResource);
+			d3dBarrier.Aliasing.pResourceAfter = static_cast<ID3D12Resource*>(barrier.resource);
+		}
+		else
+		{
+			d3dBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+			d3dBarrier.Transition.pResource = static_cast<ID3D12Resource*>(barrier.resource);
+			d3dBarrier.Transition.StateBefore = GetResourceState(barrier.stateBefore);
+			d3dBarrier.Transition.StateAfter = GetResourceState(barrier.stateAfter);
+			d3dBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+		}
+
+		barrierCount++;
+		if (barrierCount == D3D_BARRIER_BATCH_SIZE)
+		{
+			m_commandList->ResourceBarrier(barrierCount, barriers);
+			barrierCount = 0;
+		}
+	}
+
+	if (barrierCount > 0)
+	{
+		m_commandList->ResourceBarrier(barrierCount, barriers);
+	}
+}
+
+/*
+	The descriptor of the view is a D3D12_CPU_DESCRIPTOR_HANDLE of a render target view heap
+*/
+void D3DCommandRecorderClass::SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height)
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE renderTargetViewHandle;
+	renderTargetViewHandle.ptr = static_cast<SIZE_T>(_renderTarget.descriptor);
+	m_commandList->OMSetRenderTargets(1, &renderTargetViewHandle, FALSE, nullptr);
+
+	D3D12_VIEWPORT viewport;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+	viewport.Width = static_cast<float>(_width);
+	viewport.Height = static_cast<float>(_height);
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	m_commandList->RSSetViewports(1, &viewport);
+
+	D3D12_RECT scissorRect;
+	scissorRect.left = 0;
+	scissorRect.top = 0;
+	scissorRect.right = static_cast<LONG>(_width);
+	scissorRect.bottom = static_cast<LONG>(_height);
+	m_commandList->RSSetScissorRects(1, &scissorRect);
+}
+
+void D3DCommandRecorderClass::ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color)
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE renderTargetViewHandle;
+	renderTargetViewHandle.ptr = static_cast<SIZE_T>(_renderTarget.descriptor);
+	m_commandList->ClearRenderTargetView(renderTargetViewHandle, _color, 0, nullptr);
+}
+
+/*
+	_pipeline is an ID3D12PipelineState from the pipeline cache
+*/
+void D3DCommandRecorderClass::SetPipeline(void* _pipeline)
+{
+	m_commandList->SetPipelineState(static_cast<ID3D12PipelineState*>(_pipeline));
+}
+
+/*
+	The shaders look the material up by its index in the draw constants
+*/
+void D3DCommandRecorderClass::SetMaterial(unsigned int _material)
+{
+	m_commandList->SetGraphicsRoot32BitConstant(D3D_DRAW_CONSTANTS_PARAMETER, _material, D3D_DRAW_CONSTANT_MATERIAL);
+}
+
+void D3DCommandRecorderClass::SetMesh(const DrawMesh& _mesh)
+{
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
+	vertexBufferView.BufferLocation = _mesh.vertexBufferAddress;
+	vertexBufferView.SizeInBytes = _mesh.vertexBufferSize;
+	vertexBufferView.StrideInBytes = _mesh.vertexStride;
+
+	D3D12_INDEX_BUFFER_VIEW indexBufferView;
+	indexBufferView.BufferLocation = _mesh.indexBufferAddress;
+	indexBufferView.SizeInBytes = _mesh.indexBufferSize;
+	indexBufferView.Format = _mesh.indices32Bit ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+
+	m_commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	m_commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+	m_commandList->IASetIndexBuffer(&indexBufferView);
+}
+
+/*
+	The first instance also goes into the draw constants, the shaders add it to SV_InstanceID to find their instance data
+*/
+void D3DCommandRecorderClass::DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance)
+{
+	m_commandList->SetGraphicsRoot32BitConstant(D3D_DRAW_CONSTANTS_PARAMETER, _firstInstance, D3D_DRAW_CONSTANT_FIRST_INSTANCE);
+	m_commandList->DrawIndexedInstanced(_indexCount, _instanceCount, _firstIndex, _baseVertex, _firstInstance);
+}
+
+/*
+	Timestamp queries have no begin, ending the query writes the timestamp
+*/
+void D3DCommandRecorderClass::WriteTimestamp(unsigned int _queryIndex)
+{
+	m_commandList->EndQuery(m_timestampQueries->GetQueryHeap(), D3D12_QUERY_TYPE_TIMESTAMP, _queryIndex);
+}
+
+/*
+	Copy the queries into the readback buffer at the same offset they have in the query heap
+*/
+void D3DCommandRecorderClass::ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount)
+{
+	m_commandList->ResolveQueryData(m_timestampQueries->GetQueryHeap(), D3D12_QUERY_TYPE_TIMESTAMP, _firstQuery, _queryCount, m_timestampQueries->GetReadbackBuffer(), _firstQuery * sizeof(unsigned long long));
+}
+
+/*
+	Combine the DirectX 12 states of all bits of the engine state, present and common are both 0 in DirectX 12
+*/
+D3D12_RESOURCE_STATES D3DCommandRecorderClass::GetResourceState(unsigned int _state)
+{
+	unsigned int states = D3D12_RESOURCE_STATE_COMMON;
+
+	if (_state & RESOURCE_STATE_RENDER_TARGET)
+	{
+		states |= D3D12_RESOURCE_STATE_RENDER_TARGET;
+	}
+	if (_state & RESOURCE_STATE_DEPTH_WRITE)
+	{
+		states |= D3D12_RESOURCE_STATE_DEPTH_WRITE;
+	}
+	if (_state & RESOURCE_STATE_UNORDERED_ACCESS)
+	{
+		states |= D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+	}
+	if (_state & RESOURCE_STATE_COPY_DEST)
+	{
+		states |= D3D12_RESOURCE_STATE_COPY_DEST;
+	}
+	if (_state & RESOURCE_STATE_SHADER_RESOURCE)
+	{
+		states |= D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+	}
+	if (_state & RESOURCE_STATE_DEPTH_READ)
+	{
+		states |= D3D12_RESOURCE_STATE_DEPTH_READ;
+	}
+	if (_state & RESOURCE_STATE_COPY_SOURCE)
+	{
+		states |= D3D12_RESOURCE_STATE_COPY_SOURCE;
+	}
+	if (_state & RESOURCE_STATE_PRESENT)
+	{
+		states |= D3D12_RESOURCE_STATE_PRESENT;
+	}
+
+	return static_cast<D3D12_RESOURCE_STATES>(states);
+}
+
+#endif
\ No newline at end of file
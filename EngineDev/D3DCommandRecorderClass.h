@@ -0,0 +1,55 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include "CommandRecorderClass.h"
+#include "D3DTimestampQueriesClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int D3D_BARRIER_BATCH_SIZE = 16;	// barriers handed to ResourceBarrier at once
+//	Root constants of every draw (register b0): the material and the first instance, SV_InstanceID does not include the start instance
+const unsigned int D3D_DRAW_CONSTANTS_PARAMETER = 0;
+const unsigned int D3D_DRAW_CONSTANT_MATERIAL = 0;
+const unsigned int D3D_DRAW_CONSTANT_FIRST_INSTANCE = 1;
+const unsigned int D3D_DRAW_CONSTANT_COUNT = 2;
+#pragma endregion
+
+/*
+	Records into a DirectX 12 commandlist
+	The commandlist and the queries are not owned by the recorder
+*/
+class D3DCommandRecorderClass : public CommandRecorderClass
+{
+public:
+	D3DCommandRecorderClass();
+	~D3DCommandRecorderClass();
+
+	bool Initialize(ID3D12GraphicsCommandList* _commandList, D3DTimestampQueriesClass* _timestampQueries);
+	void Shutdown();
+
+	ID3D12GraphicsCommandList* GetCommandList() const;
+
+	void ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount) override;
+
+	void SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height) override;
+	void ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color) override;
+
+	void SetPipeline(void* _pipeline) override;
+	void SetMaterial(unsigned int _material) override;
+	void SetMesh(const DrawMesh& _mesh) override;
+	void DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance) override;
+
+	void WriteTimestamp(unsigned int _queryIndex) override;
+	void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount) override;
+
+private:
+	static D3D12_RESOURCE_STATES GetResourceState(unsigned int _state);
+
+	ID3D12GraphicsCommandList* m_commandList;
+	D3DTimestampQueriesClass* m_timestampQueries;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifdef _WIN32
+
+#include "D3DDescriptorHeapClass.h"
+
+/*
+	Constructor
+*/
+D3DDescriptorHeapClass::D3DDescriptorHeapClass()
+{
+	m_heap = nullptr;
+	m_cpuStart.ptr = 0;
+	m_gpuStart.ptr = 0;
+	m_incrementSize = 0;
+	m_shaderVisible = false;
+}
+
+/*
+	Destructor
+*/
+D3DDescriptorHeapClass::~D3DDescriptorHeapClass()
+{
+
+}
+
+/*
+	Create the heap with room for the persistent and the transient descriptors
+	Make it shader visible if the type allows it
+	Remember where the heap starts and how far apart its descriptors are
+*/
+bool D3DDescriptorHeapClass::Initialize(ID3D12Device* _device, D3D12_DESCRIPTOR_HEAP_TYPE _type, unsigned int _persistentCount, unsigned int _transientCount, FenceClass* _fence)
+{
+	m_shaderVisible = _type == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV || _type == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER;
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
+	ZeroMemory(&heapDesc, sizeof(heapDesc));
+	heapDesc.NumDescriptors = _persistentCount + _transientCount;
+	heapDesc.Type = _type;
+	heapDesc.Flags = m_shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+	heapDesc.NodeMask = 0;
+
+	HRESULT result = _device->CreateDescriptorHeap(&heapDesc, _uuidof(ID3D12DescriptorHeap), (void**)&m_heap);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	m_cpuStart = m_heap->GetCPUDescriptorHandleForHeapStart();
+	if (m_shaderVisible)
+	{
+		m_gpuStart = m_heap->GetGPUDescriptorHandleForHeapStart();
+	}
+
+	m_incrementSize = _device->GetDescriptorHandleIncrementSize(_type);
+
+	if (!m_allocator.Initialize(_persistentCount, _transientCount, _fence))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void D3DDescriptorHeapClass::Shutdown()
+{
+	m_allocator.Shutdown();
+
+	if (m_heap)
+	{
+		m_heap->Release();
+		m_heap = nullptr;
+	}
+}
+
+unsigned int D3DDescriptorHeapClass::Allocate(unsigned int _count)
+{
+	return m_allocator.Allocate(_count);
+}
+
+void D3DDescriptorHeapClass::Free(unsigned int _index, unsigned int _count)
+{
+	m_allocator.Free(_index, _count);
+}
+
+unsigned int D3DDescriptorHeapClass::AllocateTransient(unsigned int _count)
+{
+	return m_allocator.AllocateTransient(_count);
+}
+
+void D3DDescriptorHeapClass::EndFrame(unsigned long long _fenceValue)
+{
+	m_allocator.EndFrame(_fenceValue);
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE D3DDescriptorHeapClass::GetCpuHandle(unsigned int _index) const
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE handle;
+	handle.ptr = m_cpuStart.ptr + static_cast<SIZE_T>(_index) * m_incrementSize;
+
+	return handle;
+}
+
+/*
+	Only valid for shader visible heaps
+*/
+D3D12_GPU_DESCRIPTOR_HANDLE D3DDescriptorHeapClass::GetGpuHandle(unsigned int _index) const
+{
+	D3D12_GPU_DESCRIPTOR_HANDLE handle;
+	handle.ptr = m_gpuStart.ptr + static_cast<UINT64>(_index) * m_incrementSize;
+
+	return handle;
+}
+
+ID3D12DescriptorHeap* D3DDescriptorHeapClass::GetHeap() const
+{
+	return m_heap;
+}
+
+unsigned int D3DDescriptorHeapClass::GetIncrementSize() const
+{
+	return m_incrementSize;
+}
+
+const DescriptorAllocatorClass& D3DDescriptorHeapClass::GetAllocator() const
+{
+	return m_allocator;
+}
+
+#endif
\ No newline at end of file
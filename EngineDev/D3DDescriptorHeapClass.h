@@ -0,0 +1,46 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include "DescriptorAllocatorClass.h"
+#pragma endregion
+
+/*
+	DirectX 12 descriptor heap of one type with a DescriptorAllocatorClass for its descriptors
+	The increment size of the type is queried once, handles are computed from the index without asking the device again
+	Only CBV_SRV_UAV and sampler heaps can be shader visible, they get a GPU handle as well
+*/
+class D3DDescriptorHeapClass
+{
+public:
+	D3DDescriptorHeapClass();
+	~D3DDescriptorHeapClass();
+
+	bool Initialize(ID3D12Device* _device, D3D12_DESCRIPTOR_HEAP_TYPE _type, unsigned int _persistentCount, unsigned int _transientCount, FenceClass* _fence);
+	void Shutdown();
+
+	unsigned int Allocate(unsigned int _count = 1);
+	void Free(unsigned int _index, unsigned int _count = 1);
+	unsigned int AllocateTransient(unsigned int _count);
+	void EndFrame(unsigned long long _fenceValue);
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(unsigned int _index) const;
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(unsigned int _index) const;
+
+	ID3D12DescriptorHeap* GetHeap() const;
+	unsigned int GetIncrementSize() const;
+	const DescriptorAllocatorClass& GetAllocator() const;
+
+private:
+	ID3D12DescriptorHeap* m_heap;
+	D3D12_CPU_DESCRIPTOR_HANDLE m_cpuStart;
+	D3D12_GPU_DESCRIPTOR_HANDLE m_gpuStart;
+	unsigned int m_incrementSize;
+	bool m_shaderVisible;
+
+	DescriptorAllocatorClass m_allocator;
+};
+
+#endif
\ No newline at end of file
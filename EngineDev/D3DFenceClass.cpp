@@ -0,0 +1,118 @@
+#ifdef _WIN32
+
+#include "D3DFenceClass.h"
+
+/*
+	Constructor
+*/
+D3DFenceClass::D3DFenceClass()
+{
+	m_commandQueue = nullptr;
+	m_fence = nullptr;
+	m_fenceEvent = nullptr;
+}
+
+/*
+	Destructor
+*/
+D3DFenceClass::~D3DFenceClass()
+{
+
+}
+
+/*
+	Creating a fence, which will notify us when the GPU is ready with the rendering of the commandlist
+	We are able to synchronize GPU and CPU with the fence
+	Create an event object for the fence which will give us feedback on finished rendering
+	The commandqueue is not owned by this class, it only signals the fence
+*/
+bool D3DFenceClass::Initialize(ID3D12Device* _device, ID3D12CommandQueue* _commandQueue)
+{
+	m_commandQueue = _commandQueue;
+
+	HRESULT result = _device->CreateFence(0, D3D12_FENCE_FLAG_NONE, _uuidof(ID3D12Fence), (void**)&m_fence);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	m_fenceEvent = CreateEventEx(nullptr, nullptr, FALSE, EVENT_ALL_ACCESS);
+	if (m_fenceEvent == nullptr)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void D3DFenceClass::Shutdown()
+{
+	if (m_fenceEvent)
+	{
+		CloseHandle(m_fenceEvent);
+		m_fenceEvent = nullptr;
+	}
+	if (m_fence)
+	{
+		m_fence->Release();
+		m_fence = nullptr;
+	}
+
+	m_commandQueue = nullptr;
+}
+
+/*
+	Let the commandqueue set the fence to the value as soon as the GPU worked through everything submitted before
+*/
+bool D3DFenceClass::Signal(unsigned long long _value)
+{
+	HRESULT result = m_commandQueue->Signal(m_fence, _value);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+unsigned long long D3DFenceClass::GetCompletedValue()
+{
+	return m_fence->GetCompletedValue();
+}
+
+/*
+	If the GPU did not reach the value yet, let the fence trigger our event and block until it does
+*/
+bool D3DFenceClass::WaitForValue(unsigned long long _value)
+{
+	if (m_fence->GetCompletedValue() >= _value)
+	{
+		return true;
+	}
+
+	HRESULT result = m_fence->SetEventOnCompletion(_value, m_fenceEvent);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	WaitForSingleObject(m_fenceEvent, INFINITE);
+
+	return true;
+}
+
+/*
+	Let another commandqueue wait on the GPU until the fence reached the value, the CPU does not block
+*/
+bool D3DFenceClass::WaitOnQueue(ID3D12CommandQueue* _commandQueue, unsigned long long _value)
+{
+	HRESULT result = _commandQueue->Wait(m_fence, _value);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include "FenceClass.h"
+#pragma endregion
+
+/*
+	Fence of a DirectX 12 commandqueue
+	Signal is queued on the commandqueue, waiting blocks on an event until the GPU reached the value
+*/
+class D3DFenceClass : public FenceClass
+{
+public:
+	D3DFenceClass();
+	~D3DFenceClass();
+
+	bool Initialize(ID3D12Device* _device, ID3D12CommandQueue* _commandQueue);
+	void Shutdown();
+
+	bool Signal(unsigned long long _value) override;
+	unsigned long long GetCompletedValue() override;
+	bool WaitForValue(unsigned long long _value) override;
+
+	bool WaitOnQueue(ID3D12CommandQueue* _commandQueue, unsigned long long _value);
+
+private:
+	ID3D12CommandQueue* m_commandQueue;
+	ID3D12Fence* m_fence;
+	HANDLE m_fenceEvent;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,353 @@
+#ifdef _WIN32
+
+#include "D3DPipelineCompilerClass.h"
+#include "HashClass.h"
+#include "MappedFileClass.h"
+#include "ProfilerClass.h"
+#include <dxgi1_4.h>
+
+/*
+	Constructor
+*/
+D3DPipelineCompilerClass::D3DPipelineCompilerClass()
+{
+	m_device = nullptr;
+	m_rootSignature = nullptr;
+	m_cacheVersion = 0;
+}
+
+/*
+	Destructor
+*/
+D3DPipelineCompilerClass::~D3DPipelineCompilerClass()
+{
+
+}
+
+/*
+	The device and the root signature are not owned by the compiler
+*/
+bool D3DPipelineCompilerClass::Initialize(ID3D12Device* _device, ID3D12RootSignature* _rootSignature)
+{
+	m_device = _device;
+	m_rootSignature = _rootSignature;
+
+	if (!ComputeCacheVersion())
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void D3DPipelineCompilerClass::Shutdown()
+{
+	m_device = nullptr;
+	m_rootSignature = nullptr;
+}
+
+unsigned long long D3DPipelineCompilerClass::GetCacheVersion()
+{
+	return m_cacheVersion;
+}
+
+/*
+	Hash the contents of both shader files, a missing file hashes to 0 and fails later when it is compiled
+	Files included by the shaders are not part of the hash
+*/
+unsigned long long D3DPipelineCompilerClass::GetSourceHash(const PipelineDesc& _desc)
+{
+	unsigned long long hash = 0;
+	const char* paths[2] = { _desc.vertexShader, _desc.pixelShader };
+
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		MappedFileClass file;
+		if (paths[i][0] != '\0' && file.Open(paths[i]))
+		{
+			hash = HashClass::Combine(hash, HashClass::Hash(file.GetData(), file.GetSize()));
+			file.Close();
+		}
+		else
+		{
+			hash = HashClass::Combine(hash, 0);
+		}
+	}
+
+	return hash;
+}
+
+/*
+	Try the blob of an earlier run first: shader bytecode and cached PSO come straight from it
+	Otherwise compile the vertex shader and the pixel shader (optional, e.g. for depth only pipelines), create the PSO
+	and pack the bytecode and the cached PSO of the driver into a new blob
+*/
+void* D3DPipelineCompilerClass::CreatePipeline(const PipelineDesc& _desc, const void* _cachedBlob, size_t _cachedBlobSize, unsigned char*& _blob, size_t& _blobSize)
+{
+	PROFILE_SCOPE("D3DPipelineCompilerClass::CreatePipeline");
+
+	_blob = nullptr;
+	_blobSize = 0;
+
+	if (_cachedBlob && _cachedBlobSize >= sizeof(PipelineBlobHeader))
+	{
+		const PipelineBlobHeader* header = static_cast<const PipelineBlobHeader*>(_cachedBlob);
+		const unsigned char* data = static_cast<const unsigned char*>(_cachedBlob) + sizeof(PipelineBlobHeader);
+
+		if (sizeof(PipelineBlobHeader) + static_cast<size_t>(header->vertexShaderSize) + header->pixelShaderSize + header->pipelineSize == _cachedBlobSize)
+		{
+			D3D12_SHADER_BYTECODE vertexShader = { data, header->vertexShaderSize };
+			D3D12_SHADER_BYTECODE pixelShader = { header->pixelShaderSize > 0 ? data + header->vertexShaderSize : nullptr, header->pixelShaderSize };
+			D3D12_CACHED_PIPELINE_STATE cachedPipeline = { data + header->vertexShaderSize + header->pixelShaderSize, header->pipelineSize };
+
+			ID3D12PipelineState* pipelineState = CreatePipelineState(_desc, vertexShader, pixelShader, cachedPipeline);
+			if (pipelineState)
+			{
+				return pipelineState;
+			}
+		}
+	}
+
+	ID3DBlob* vertexShaderBlob = CompileShader(_desc.vertexShader, _desc.vertexEntryPoint, "vs_5_1");
+	if (!vertexShaderBlob)
+	{
+		return nullptr;
+	}
+
+	ID3DBlob* pixelShaderBlob = nullptr;
+	if (_desc.pixelShader[0] != '\0')
+	{
+		pixelShaderBlob = CompileShader(_desc.pixelShader, _desc.pixelEntryPoint, "ps_5_1");
+		if (!pixelShaderBlob)
+		{
+			vertexShaderBlob->Release();
+			return nullptr;
+		}
+	}
+
+	D3D12_SHADER_BYTECODE vertexShader = { vertexShaderBlob->GetBufferPointer(), vertexShaderBlob->GetBufferSize() };
+	D3D12_SHADER_BYTECODE pixelShader = { nullptr, 0 };
+	if (pixelShaderBlob)
+	{
+		pixelShader.pShaderBytecode = pixelShaderBlob->GetBufferPointer();
+		pixelShader.BytecodeLength = pixelShaderBlob->GetBufferSize();
+	}
+	D3D12_CACHED_PIPELINE_STATE noCachedPipeline = { nullptr, 0 };
+
+	ID3D12PipelineState* pipelineState = CreatePipelineState(_desc, vertexShader, pixelShader, noCachedPipeline);
+
+	ID3DBlob* cachedPipelineBlob = nullptr;
+	if (pipelineState && SUCCEEDED(pipelineState->GetCachedBlob(&cachedPipelineBlob)))
+	{
+		PipelineBlobHeader header;
+		header.vertexShaderSize = static_cast<unsigned int>(vertexShader.BytecodeLength);
+		header.pixelShaderSize = static_cast<unsigned int>(pixelShader.BytecodeLength);
+		header.pipelineSize = static_cast<unsigned int>(cachedPipelineBlob->GetBufferSize());
+		header.reserved = 0;
+
+		_blobSize = sizeof(PipelineBlobHeader) + header.vertexShaderSize + header.pixelShaderSize + header.pipelineSize;
+		_blob = new unsigned char[_blobSize];
+		if (_blob)
+		{
+			unsigned char* data = _blob;
+			memcpy(data, &header, sizeof(PipelineBlobHeader));
+			data += sizeof(PipelineBlobHeader);
+			memcpy(data, vertexShader.pShaderBytecode, header.vertexShaderSize);
+			data += header.vertexShaderSize;
+			if (header.pixelShaderSize > 0)
+			{
+				memcpy(data, pixelShader.pShaderBytecode, header.pixelShaderSize);
+				data += header.pixelShaderSize;
+			}
+			memcpy(data, cachedPipelineBlob->GetBufferPointer(), header.pipelineSize);
+		}
+		else
+		{
+			_blobSize = 0;
+		}
+
+		cachedPipelineBlob->Release();
+	}
+
+	if (pixelShaderBlob)
+	{
+		pixelShaderBlob->Release();
+	}
+	vertexShaderBlob->Release();
+
+	return pipelineState;
+}
+
+void D3DPipelineCompilerClass::ReleasePipeline(void* _pipeline)
+{
+	static_cast<ID3D12PipelineState*>(_pipeline)->Release();
+}
+
+/*
+	Translate the portable description into a graphics pipeline state description and create the PSO
+*/
+ID3D12PipelineState* D3DPipelineCompilerClass::CreatePipelineState(const PipelineDesc& _desc, D3D12_SHADER_BYTECODE _vertexShader, D3D12_SHADER_BYTECODE _pixelShader, D3D12_CACHED_PIPELINE_STATE _cachedPipeline)
+{
+	D3D12_INPUT_ELEMENT_DESC inputElements[MAX_PIPELINE_VERTEX_ELEMENTS];
+	for (unsigned int i = 0; i < _desc.vertexElementCount && i < MAX_PIPELINE_VERTEX_ELEMENTS; i++)
+	{
+		inputElements[i].SemanticName = _desc.vertexElements[i].semantic;
+		inputElements[i].SemanticIndex = _desc.vertexElements[i].semanticIndex;
+		inputElements[i].Format = static_cast<DXGI_FORMAT>(_desc.vertexElements[i].format);
+		inputElements[i].InputSlot = _desc.vertexElements[i].inputSlot;
+		inputElements[i].AlignedByteOffset = _desc.vertexElements[i].offset;
+		inputElements[i].InputSlotClass = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA;
+		inputElements[i].InstanceDataStepRate = 0;
+	}
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineStateDesc;
+	ZeroMemory(&pipelineStateDesc, sizeof(pipelineStateDesc));
+	pipelineStateDesc.pRootSignature = m_rootSignature;
+	pipelineStateDesc.VS = _vertexShader;
+	pipelineStateDesc.PS = _pixelShader;
+	pipelineStateDesc.InputLayout.pInputElementDescs = inputElements;
+	pipelineStateDesc.InputLayout.NumElements = _desc.vertexElementCount < MAX_PIPELINE_VERTEX_ELEMENTS ? _desc.vertexElementCount : MAX_PIPELINE_VERTEX_ELEMENTS;
+	pipelineStateDesc.SampleMask = 0xFFFFFFFF;
+	pipelineStateDesc.SampleDesc.Count = _desc.sampleCount;
+	pipelineStateDesc.CachedPSO = _cachedPipeline;
+
+	switch (_desc.topology)
+	{
+	case PIPELINE_TOPOLOGY_LINE:
+		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_LINE;
+		break;
+	case PIPELINE_TOPOLOGY_POINT:
+		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_POINT;
+		break;
+	default:
+		pipelineStateDesc.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+		break;
+	}
+
+	pipelineStateDesc.NumRenderTargets = _desc.renderTargetCount < MAX_PIPELINE_RENDER_TARGETS ? _desc.renderTargetCount : MAX_PIPELINE_RENDER_TARGETS;
+	for (unsigned int i = 0; i < pipelineStateDesc.NumRenderTargets; i++)
+	{
+		pipelineStateDesc.RTVFormats[i] = static_cast<DXGI_FORMAT>(_desc.renderTargetFormats[i]);
+	}
+	pipelineStateDesc.DSVFormat = static_cast<DXGI_FORMAT>(_desc.depthFormat);
+
+	//	Rasterizer
+	pipelineStateDesc.RasterizerState.FillMode = _desc.fillMode == PIPELINE_FILL_WIREFRAME ? D3D12_FILL_MODE_WIREFRAME : D3D12_FILL_MODE_SOLID;
+	pipelineStateDesc.RasterizerState.CullMode = _desc.cullMode == PIPELINE_CULL_NONE ? D3D12_CULL_MODE_NONE : (_desc.cullMode == PIPELINE_CULL_FRONT ? D3D12_CULL_MODE_FRONT : D3D12_CULL_MODE_BACK);
+	pipelineStateDesc.RasterizerState.FrontCounterClockwise = FALSE;
+	pipelineStateDesc.RasterizerState.DepthBias = D3D12_DEFAULT_DEPTH_BIAS;
+	pipelineStateDesc.RasterizerState.DepthBiasClamp = D3D12_DEFAULT_DEPTH_BIAS_CLAMP;
+	pipelineStateDesc.RasterizerState.SlopeScaledDepthBias = D3D12_DEFAULT_SLOPE_SCALED_DEPTH_BIAS;
+	pipelineStateDesc.RasterizerState.DepthClipEnable = TRUE;
+
+	//	Blending, the same for every render target
+	for (unsigned int i = 0; i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; i++)
+	{
+		D3D12_RENDER_TARGET_BLEND_DESC& blendDesc = pipelineStateDesc.BlendState.RenderTarget[i];
+		blendDesc.BlendEnable = _desc.blendMode != PIPELINE_BLEND_OPAQUE;
+		blendDesc.SrcBlend = _desc.blendMode == PIPELINE_BLEND_ALPHA ? D3D12_BLEND_SRC_ALPHA : D3D12_BLEND_ONE;
+		blendDesc.DestBlend = _desc.blendMode == PIPELINE_BLEND_ALPHA ? D3D12_BLEND_INV_SRC_ALPHA : (_desc.blendMode == PIPELINE_BLEND_ADDITIVE ? D3D12_BLEND_ONE : D3D12_BLEND_ZERO);
+		blendDesc.BlendOp = D3D12_BLEND_OP_ADD;
+		blendDesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+		blendDesc.DestBlendAlpha = D3D12_BLEND_ZERO;
+		blendDesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+		blendDesc.LogicOp = D3D12_LOGIC_OP_NOOP;
+		blendDesc.RenderTargetWriteMask = D3D12_COLOR_WRITE_ENABLE_ALL;
+	}
+
+	//	Depth
+	pipelineStateDesc.DepthStencilState.DepthEnable = _desc.depthMode != PIPELINE_DEPTH_NONE;
+	pipelineStateDesc.DepthStencilState.DepthWriteMask = _desc.depthMode == PIPELINE_DEPTH_READ_WRITE ? D3D12_DEPTH_WRITE_MASK_ALL : D3D12_DEPTH_WRITE_MASK_ZERO;
+	pipelineStateDesc.DepthStencilState.DepthFunc = _desc.depthMode == PIPELINE_DEPTH_READ ? D3D12_COMPARISON_FUNC_LESS_EQUAL : D3D12_COMPARISON_FUNC_LESS;
+	pipelineStateDesc.DepthStencilState.StencilEnable = FALSE;
+
+	ID3D12PipelineState* pipelineState = nullptr;
+	HRESULT result = m_device->CreateGraphicsPipelineState(&pipelineStateDesc, _uuidof(ID3D12PipelineState), (void**)&pipelineState);
+	if (FAILED(result))
+	{
+		return nullptr;
+	}
+
+	return pipelineState;
+}
+
+/*
+	Compile one shader from its file, the compiler wants the path as a wide string
+	Debug builds keep the debug information and skip optimizations
+*/
+ID3DBlob* D3DPipelineCompilerClass::CompileShader(const char* _path, const char* _entryPoint, const char* _target)
+{
+	wchar_t widePath[MAX_SHADER_PATH];
+	if (MultiByteToWideChar(CP_UTF8, 0, _path, -1, widePath, MAX_SHADER_PATH) == 0)
+	{
+		return nullptr;
+	}
+
+#ifdef _DEBUG
+	UINT flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	UINT flags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+
+	ID3DBlob* shader = nullptr;
+	ID3DBlob* errors = nullptr;
+	HRESULT result = D3DCompileFromFile(widePath, nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, _entryPoint, _target, flags, 0, &shader, &errors);
+
+	if (errors)
+	{
+		OutputDebugStringA(static_cast<const char*>(errors->GetBufferPointer()));
+		errors->Release();
+	}
+
+	if (FAILED(result))
+	{
+		return nullptr;
+	}
+
+	return shader;
+}
+
+/*
+	Identify the GPU, its driver and the shader compiler, a change of any of them invalidates the disk cache
+	The driver version is only reported through CheckInterfaceSupport of the adapter
+*/
+bool D3DPipelineCompilerClass::ComputeCacheVersion()
+{
+	IDXGIFactory4* factory;
+	HRESULT result = CreateDXGIFactory1(_uuidof(IDXGIFactory4), (void**)&factory);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	IDXGIAdapter* adapter;
+	result = factory->EnumAdapterByLuid(m_device->GetAdapterLuid(), _uuidof(IDXGIAdapter), (void**)&adapter);
+	factory->Release();
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	DXGI_ADAPTER_DESC adapterDesc;
+	result = adapter->GetDesc(&adapterDesc);
+	if (FAILED(result))
+	{
+		adapter->Release();
+		return false;
+	}
+
+	LARGE_INTEGER driverVersion;
+	driverVersion.QuadPart = 0;
+	adapter->CheckInterfaceSupport(_uuidof(IDXGIDevice), &driverVersion);
+	adapter->Release();
+
+	m_cacheVersion = HashClass::Combine(adapterDesc.VendorId, adapterDesc.DeviceId);
+	m_cacheVersion = HashClass::Combine(m_cacheVersion, adapterDesc.SubSysId);
+	m_cacheVersion = HashClass::Combine(m_cacheVersion, adapterDesc.Revision);
+	m_cacheVersion = HashClass::Combine(m_cacheVersion, static_cast<unsigned long long>(driverVersion.QuadPart));
+	m_cacheVersion = HashClass::Combine(m_cacheVersion, D3D_COMPILER_VERSION);
+
+	return true;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include <d3dcompiler.h>
+#include "PipelineCompilerClass.h"
+#pragma endregion
+
+/*
+	Compiles the HLSL of a PipelineDesc with the D3DCompiler and creates the ID3D12PipelineState
+	The blob keeps the shader bytecode together with the cached PSO of the driver, so a warm start neither compiles HLSL nor lets the driver compile
+	The driver rejects cached PSOs of another driver or GPU, then the pipeline is compiled like there was no blob
+	All pipelines use the root signature given to Initialize
+*/
+class D3DPipelineCompilerClass : public PipelineCompilerClass
+{
+public:
+	D3DPipelineCompilerClass();
+	~D3DPipelineCompilerClass();
+
+	bool Initialize(ID3D12Device* _device, ID3D12RootSignature* _rootSignature);
+	void Shutdown();
+
+	unsigned long long GetCacheVersion() override;
+	unsigned long long GetSourceHash(const PipelineDesc& _desc) override;
+	void* CreatePipeline(const PipelineDesc& _desc, const void* _cachedBlob, size_t _cachedBlobSize, unsigned char*& _blob, size_t& _blobSize) override;
+	void ReleasePipeline(void* _pipeline) override;
+
+private:
+	struct PipelineBlobHeader
+	{
+		unsigned int vertexShaderSize;
+		unsigned int pixelShaderSize;
+		unsigned int pipelineSize;
+		unsigned int reserved;
+	};
+
+	ID3D12Device* m_device;
+	ID3D12RootSignature* m_rootSignature;
+	unsigned long long m_cacheVersion;
+
+	ID3D12PipelineState* CreatePipelineState(const PipelineDesc& _desc, D3D12_SHADER_BYTECODE _vertexShader, D3D12_SHADER_BYTECODE _pixelShader, D3D12_CACHED_PIPELINE_STATE _cachedPipeline);
+	ID3DBlob* CompileShader(const char* _path, const char* _entryPoint, const char* _target);
+	bool ComputeCacheVersion();
+};
+
+#endif
\ No newline at end of file
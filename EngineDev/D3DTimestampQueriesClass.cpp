@@ -0,0 +1,181 @@
+#ifdef _WIN32
+
+#include "D3DTimestampQueriesClass.h"
+#include "TimerClass.h"
+
+/*
+	Constructor
+*/
+D3DTimestampQueriesClass::D3DTimestampQueriesClass()
+{
+	m_commandQueue = nullptr;
+	m_queryHeap = nullptr;
+	m_readbackBuffer = nullptr;
+	m_queryCount = 0;
+	m_frequency = 0;
+}
+
+/*
+	Destructor
+*/
+D3DTimestampQueriesClass::~D3DTimestampQueriesClass()
+{
+
+}
+
+/*
+	Create the query heap for the timestamps
+	Create a buffer in the readback heap with 8 bytes per query, the GPU copies the resolved queries into it
+	Get how many ticks per second the timestamps of the commandqueue have
+	The commandqueue is not owned by this class
+*/
+bool D3DTimestampQueriesClass::Initialize(ID3D12Device* _device, ID3D12CommandQueue* _commandQueue, unsigned int _queryCount)
+{
+	m_commandQueue = _commandQueue;
+
+	D3D12_QUERY_HEAP_DESC queryHeapDesc;
+	ZeroMemory(&queryHeapDesc, sizeof(queryHeapDesc));
+	queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	queryHeapDesc.Count = _queryCount;
+	queryHeapDesc.NodeMask = 0;
+
+	HRESULT result = _device->CreateQueryHeap(&queryHeapDesc, _uuidof(ID3D12QueryHeap), (void**)&m_queryHeap);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	D3D12_HEAP_PROPERTIES heapProperties;
+	ZeroMemory(&heapProperties, sizeof(heapProperties));
+	heapProperties.Type = D3D12_HEAP_TYPE_READBACK;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+
+	D3D12_RESOURCE_DESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Width = static_cast<unsigned long long>(_queryCount) * sizeof(unsigned long long);
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	result = _device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_COPY_DEST, nullptr, _uuidof(ID3D12Resource), (void**)&m_readbackBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	UINT64 frequency = 0;
+	result = m_commandQueue->GetTimestampFrequency(&frequency);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	m_frequency = frequency;
+	m_queryCount = _queryCount;
+
+	return true;
+}
+
+void D3DTimestampQueriesClass::Shutdown()
+{
+	if (m_readbackBuffer)
+	{
+		m_readbackBuffer->Release();
+		m_readbackBuffer = nullptr;
+	}
+	if (m_queryHeap)
+	{
+		m_queryHeap->Release();
+		m_queryHeap = nullptr;
+	}
+
+	m_commandQueue = nullptr;
+	m_queryCount = 0;
+}
+
+ID3D12QueryHeap* D3DTimestampQueriesClass::GetQueryHeap() const
+{
+	return m_queryHeap;
+}
+
+ID3D12Resource* D3DTimestampQueriesClass::GetReadbackBuffer() const
+{
+	return m_readbackBuffer;
+}
+
+unsigned int D3DTimestampQueriesClass::GetQueryCount() const
+{
+	return m_queryCount;
+}
+
+unsigned long long D3DTimestampQueriesClass::GetFrequency() const
+{
+	return m_frequency;
+}
+
+/*
+	Map only the range of the queries we read, copy them and unmap without having written anything
+	The GPU has to be done with the commandlist which resolved them, the GPU timer makes sure of that
+*/
+bool D3DTimestampQueriesClass::ReadTimestamps(unsigned int _firstQuery, unsigned int _queryCount, unsigned long long* _timestamps)
+{
+	if (_firstQuery + _queryCount > m_queryCount)
+	{
+		return false;
+	}
+
+	D3D12_RANGE readRange;
+	readRange.Begin = _firstQuery * sizeof(unsigned long long);
+	readRange.End = (_firstQuery + _queryCount) * sizeof(unsigned long long);
+
+	void* data = nullptr;
+	HRESULT result = m_readbackBuffer->Map(0, &readRange, &data);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	memcpy(_timestamps, static_cast<unsigned char*>(data) + readRange.Begin, _queryCount * sizeof(unsigned long long));
+
+	D3D12_RANGE writtenRange;
+	writtenRange.Begin = 0;
+	writtenRange.End = 0;
+	m_readbackBuffer->Unmap(0, &writtenRange);
+
+	return true;
+}
+
+/*
+	Let the commandqueue sample the GPU clock and the performance counter of the CPU at the same time
+	Move the sample of the performance counter to the clock of TimerClass by the time which passed since the sample
+*/
+bool D3DTimestampQueriesClass::Calibrate(unsigned long long& _gpuTimestamp, unsigned long long& _cpuMicroseconds)
+{
+	UINT64 gpuTimestamp = 0;
+	UINT64 cpuTimestamp = 0;
+	HRESULT result = m_commandQueue->GetClockCalibration(&gpuTimestamp, &cpuTimestamp);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	LARGE_INTEGER counter;
+	LARGE_INTEGER counterFrequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&counterFrequency);
+
+	unsigned long long microsecondsSinceSample = static_cast<unsigned long long>(counter.QuadPart - cpuTimestamp) * 1000000 / static_cast<unsigned long long>(counterFrequency.QuadPart);
+
+	_gpuTimestamp = gpuTimestamp;
+	_cpuMicroseconds = TimerClass::GetMicroseconds() - microsecondsSinceSample;
+
+	return true;
+}
+
+#endif
\ No newline at end of file
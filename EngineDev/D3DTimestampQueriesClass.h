@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include "TimestampQueriesClass.h"
+#pragma endregion
+
+/*
+	Timestamp queries of a DirectX 12 commandqueue
+	The queries live in a query heap, ResolveQueryData copies them into a readback buffer which the CPU can map
+*/
+class D3DTimestampQueriesClass : public TimestampQueriesClass
+{
+public:
+	D3DTimestampQueriesClass();
+	~D3DTimestampQueriesClass();
+
+	bool Initialize(ID3D12Device* _device, ID3D12CommandQueue* _commandQueue, unsigned int _queryCount);
+	void Shutdown();
+
+	ID3D12QueryHeap* GetQueryHeap() const;
+	ID3D12Resource* GetReadbackBuffer() const;
+
+	unsigned int GetQueryCount() const override;
+	unsigned long long GetFrequency() const override;
+
+	bool ReadTimestamps(unsigned int _firstQuery, unsigned int _queryCount, unsigned long long* _timestamps) override;
+	bool Calibrate(unsigned long long& _gpuTimestamp, unsigned long long& _cpuMicroseconds) override;
+
+private:
+	ID3D12CommandQueue* m_commandQueue;
+	ID3D12QueryHeap* m_queryHeap;
+	ID3D12Resource* m_readbackBuffer;
+	unsigned int m_queryCount;
+	unsigned long long m_frequency;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,409 @@
+#ifdef _WIN32
+
+#include "D3DUploadManagerClass.h"
+#include "ProfilerClass.h"
+#include <cstring>
+
+/*
+	Constructor
+*/
+D3DUploadManagerClass::D3DUploadManagerClass()
+{
+	m_device = nullptr;
+	m_copyQueue = nullptr;
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_commandAllocator[i] = nullptr;
+	}
+	m_commandList = nullptr;
+	m_uploadBuffer = nullptr;
+	m_batchOpen = false;
+	m_submittedFenceValue = 0;
+	m_uploadedBytes = 0;
+}
+
+/*
+	Destructor
+*/
+D3DUploadManagerClass::~D3DUploadManagerClass()
+{
+
+}
+
+/*
+	Create the copy queue, a commandallocator per batch in flight and the commandlist of the batches
+	Create the upload buffer and map it once, an upload heap may stay mapped for its whole life
+	Create the fence of the copy queue, the batch ring and the upload ring on top of it
+*/
+bool D3DUploadManagerClass::Initialize(ID3D12Device* _device, size_t _ringSize)
+{
+	m_device = _device;
+
+	D3D12_COMMAND_QUEUE_DESC commandQueueDesc;
+	ZeroMemory(&commandQueueDesc, sizeof(commandQueueDesc));
+	commandQueueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	commandQueueDesc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+	commandQueueDesc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+	commandQueueDesc.NodeMask = 0;
+
+	HRESULT result = m_device->CreateCommandQueue(&commandQueueDesc, _uuidof(ID3D12CommandQueue), (void**)&m_copyQueue);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		result = m_device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, _uuidof(ID3D12CommandAllocator), (void**)&m_commandAllocator[i]);
+		if (FAILED(result))
+		{
+			return false;
+		}
+	}
+
+	result = m_device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, m_commandAllocator[0], nullptr, _uuidof(ID3D12GraphicsCommandList), (void**)&m_commandList);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//	Close the commandlist because it is created in a recording state
+	result = m_commandList->Close();
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	D3D12_HEAP_PROPERTIES heapProperties;
+	ZeroMemory(&heapProperties, sizeof(heapProperties));
+	heapProperties.Type = D3D12_HEAP_TYPE_UPLOAD;
+	heapProperties.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+	heapProperties.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+
+	D3D12_RESOURCE_DESC bufferDesc;
+	ZeroMemory(&bufferDesc, sizeof(bufferDesc));
+	bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+	bufferDesc.Width = _ringSize;
+	bufferDesc.Height = 1;
+	bufferDesc.DepthOrArraySize = 1;
+	bufferDesc.MipLevels = 1;
+	bufferDesc.Format = DXGI_FORMAT_UNKNOWN;
+	bufferDesc.SampleDesc.Count = 1;
+	bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+	bufferDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+
+	result = m_device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &bufferDesc, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, _uuidof(ID3D12Resource), (void**)&m_uploadBuffer);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	//	The CPU never reads from the upload buffer
+	D3D12_RANGE readRange;
+	readRange.Begin = 0;
+	readRange.End = 0;
+
+	void* uploadMemory = nullptr;
+	result = m_uploadBuffer->Map(0, &readRange, &uploadMemory);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	if (!m_fence.Initialize(m_device, m_copyQueue))
+	{
+		return false;
+	}
+
+	if (!m_batchRing.Initialize(&m_fence, MAX_FRAMES_IN_FLIGHT))
+	{
+		return false;
+	}
+
+	if (!m_uploadRing.Initialize(uploadMemory, _ringSize, &m_fence))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Wait until the copy queue is done, release everything
+*/
+void D3DUploadManagerClass::Shutdown()
+{
+	WaitForIdle();
+
+	m_uploadRing.Shutdown();
+	m_batchRing.Shutdown();
+	m_fence.Shutdown();
+
+	if (m_uploadBuffer)
+	{
+		m_uploadBuffer->Unmap(0, nullptr);
+		m_uploadBuffer->Release();
+		m_uploadBuffer = nullptr;
+	}
+	if (m_commandList)
+	{
+		m_commandList->Release();
+		m_commandList = nullptr;
+	}
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		if (m_commandAllocator[i])
+		{
+			m_commandAllocator[i]->Release();
+			m_commandAllocator[i] = nullptr;
+		}
+	}
+	if (m_copyQueue)
+	{
+		m_copyQueue->Release();
+		m_copyQueue = nullptr;
+	}
+
+	m_device = nullptr;
+}
+
+/*
+	Copy _size bytes into the buffer at _destinationOffset
+	Big uploads are split into chunks of UPLOAD_CHUNK_SIZE
+	The destination has to be in the common state, the copy queue can only promote resources from it
+*/
+bool D3DUploadManagerClass::UploadBuffer(ID3D12Resource* _destination, unsigned long long _destinationOffset, const void* _data, size_t _size)
+{
+	PROFILE_SCOPE("D3DUploadManagerClass::UploadBuffer");
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	const unsigned char* data = static_cast<const unsigned char*>(_data);
+
+	while (_size > 0)
+	{
+		size_t chunkSize = _size < UPLOAD_CHUNK_SIZE ? _size : UPLOAD_CHUNK_SIZE;
+
+		size_t offset = 0;
+		void* cpuAddress = nullptr;
+		if (!AllocateStaging(chunkSize, 16, offset, cpuAddress))
+		{
+			return false;
+		}
+
+		memcpy(cpuAddress, data, chunkSize);
+		m_commandList->CopyBufferRegion(_destination, _destinationOffset, m_uploadBuffer, offset, chunkSize);
+
+		data += chunkSize;
+		_destinationOffset += chunkSize;
+		_size -= chunkSize;
+		m_uploadedBytes += chunkSize;
+	}
+
+	return true;
+}
+
+/*
+	Copy one subresource of a texture, the rows of _data are _rowPitch bytes apart
+	Ask the device for the layout the copy needs (rows aligned to D3D12_TEXTURE_DATA_PITCH_ALIGNMENT) and copy row by row into it
+*/
+bool D3DUploadManagerClass::UploadTexture(ID3D12Resource* _destination, unsigned int _subresource, const void* _data, size_t _rowPitch)
+{
+	PROFILE_SCOPE("D3DUploadManagerClass::UploadTexture");
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	D3D12_RESOURCE_DESC textureDesc = _destination->GetDesc();
+
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT layout;
+	UINT rowCount = 0;
+	UINT64 rowSize = 0;
+	UINT64 totalSize = 0;
+	m_device->GetCopyableFootprints(&textureDesc, _subresource, 1, 0, &layout, &rowCount, &rowSize, &totalSize);
+
+	size_t offset = 0;
+	void* cpuAddress = nullptr;
+	if (!AllocateStaging(static_cast<size_t>(totalSize), D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT, offset, cpuAddress))
+	{
+		return false;
+	}
+
+	const unsigned char* source = static_cast<const unsigned char*>(_data);
+	unsigned char* destination = static_cast<unsigned char*>(cpuAddress);
+	unsigned int totalRowCount = rowCount * layout.Footprint.Depth;
+
+	for (unsigned int i = 0; i < totalRowCount; i++)
+	{
+		memcpy(destination + i * layout.Footprint.RowPitch, source + i * _rowPitch, static_cast<size_t>(rowSize));
+	}
+
+	layout.Offset = offset;
+
+	D3D12_TEXTURE_COPY_LOCATION destinationLocation;
+	destinationLocation.pResource = _destination;
+	destinationLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	destinationLocation.SubresourceIndex = _subresource;
+
+	D3D12_TEXTURE_COPY_LOCATION sourceLocation;
+	sourceLocation.pResource = m_uploadBuffer;
+	sourceLocation.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	sourceLocation.PlacedFootprint = layout;
+
+	m_commandList->CopyTextureRegion(&destinationLocation, 0, 0, 0, &sourceLocation, nullptr);
+
+	m_uploadedBytes += static_cast<size_t>(rowSize) * totalRowCount;
+
+	return true;
+}
+
+/*
+	Submit the copies recorded since the last flush, called once per frame before the graphics queue needs the data
+*/
+bool D3DUploadManagerClass::Flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return SubmitBatch();
+}
+
+/*
+	Let the commandqueue wait on the GPU until the copy queue finished every submitted batch
+*/
+bool D3DUploadManagerClass::WaitOnQueue(ID3D12CommandQueue* _commandQueue)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_submittedFenceValue == 0)
+	{
+		return true;
+	}
+
+	return m_fence.WaitOnQueue(_commandQueue, m_submittedFenceValue);
+}
+
+/*
+	Submit what is recorded and block until the copy queue finished everything
+*/
+bool D3DUploadManagerClass::WaitForIdle()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (!m_copyQueue)
+	{
+		return true;
+	}
+
+	if (!SubmitBatch())
+	{
+		return false;
+	}
+
+	return m_batchRing.WaitForIdle();
+}
+
+/*
+	Bytes copied into the upload buffer so far
+*/
+unsigned long long D3DUploadManagerClass::GetUploadedBytes() const
+{
+	return m_uploadedBytes;
+}
+
+const UploadRingClass& D3DUploadManagerClass::GetUploadRing() const
+{
+	return m_uploadRing;
+}
+
+/*
+	Start recording a batch if none is open
+	Wait until the copy queue finished the last batch which used the commandallocator of this batch
+*/
+bool D3DUploadManagerClass::OpenBatch()
+{
+	if (m_batchOpen)
+	{
+		return true;
+	}
+
+	if (!m_batchRing.BeginFrame())
+	{
+		return false;
+	}
+
+	ID3D12CommandAllocator* commandAllocator = m_commandAllocator[m_batchRing.GetFrameIndex()];
+
+	HRESULT result = commandAllocator->Reset();
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	result = m_commandList->Reset(commandAllocator, nullptr);
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	m_batchOpen = true;
+
+	return true;
+}
+
+/*
+	Close and execute the open batch, the upload ring reuses its memory after the copy queue signaled the fence of the batch
+*/
+bool D3DUploadManagerClass::SubmitBatch()
+{
+	if (!m_batchOpen)
+	{
+		return true;
+	}
+
+	m_batchOpen = false;
+
+	HRESULT result = m_commandList->Close();
+	if (FAILED(result))
+	{
+		return false;
+	}
+
+	ID3D12CommandList* pCommandLists[1];
+	pCommandLists[0] = m_commandList;
+	m_copyQueue->ExecuteCommandLists(1, pCommandLists);
+
+	unsigned long long fenceValue = m_batchRing.GetFrameFenceValue();
+	m_uploadRing.Submit(fenceValue);
+
+	if (!m_batchRing.EndFrame())
+	{
+		return false;
+	}
+
+	m_submittedFenceValue = fenceValue;
+
+	return true;
+}
+
+/*
+	Take staging memory from the ring and make sure a batch is open to record the copy into
+	If the copies of the open batch fill the ring, submit the batch so its memory can be reclaimed and try again
+*/
+bool D3DUploadManagerClass::AllocateStaging(size_t _size, size_t _alignment, size_t& _offset, void*& _cpuAddress)
+{
+	if (!m_uploadRing.Allocate(_size, _alignment, _offset, _cpuAddress))
+	{
+		if (!SubmitBatch())
+		{
+			return false;
+		}
+
+		if (!m_uploadRing.Allocate(_size, _alignment, _offset, _cpuAddress))
+		{
+			return false;
+		}
+	}
+
+	return OpenBatch();
+}
+
+#endif
\ No newline at end of file
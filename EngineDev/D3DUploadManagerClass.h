@@ -0,0 +1,66 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region includes
+#include <d3d12.h>
+#include <mutex>
+#include "D3DFenceClass.h"
+#include "FrameRingClass.h"
+#include "UploadRingClass.h"
+#pragma endregion
+
+#pragma region global variables
+const size_t UPLOAD_RING_SIZE = 64 * 1024 * 1024;
+const size_t UPLOAD_CHUNK_SIZE = 4 * 1024 * 1024;	// big buffers are copied in chunks, so a single upload never needs the whole ring
+#pragma endregion
+
+/*
+	Gets buffer and texture data onto the GPU without blocking the frame
+	The data is copied into one persistently mapped upload buffer, sub-allocated by an upload ring
+	The copies are recorded into a batch on a dedicated copy queue, Flush submits the batch
+	The graphics queue waits for the copy queue on the GPU (WaitOnQueue), the CPU only waits if the ring is full
+	The copy queue has its own fence, the ring reuses the memory of every batch the copy queue finished
+	Uploads may come from any thread
+*/
+class D3DUploadManagerClass
+{
+public:
+	D3DUploadManagerClass();
+	~D3DUploadManagerClass();
+
+	bool Initialize(ID3D12Device* _device, size_t _ringSize);
+	void Shutdown();
+
+	bool UploadBuffer(ID3D12Resource* _destination, unsigned long long _destinationOffset, const void* _data, size_t _size);
+	bool UploadTexture(ID3D12Resource* _destination, unsigned int _subresource, const void* _data, size_t _rowPitch);
+
+	bool Flush();
+	bool WaitOnQueue(ID3D12CommandQueue* _commandQueue);
+	bool WaitForIdle();
+
+	unsigned long long GetUploadedBytes() const;
+	const UploadRingClass& GetUploadRing() const;
+
+private:
+	ID3D12Device* m_device;
+	ID3D12CommandQueue* m_copyQueue;
+	ID3D12CommandAllocator* m_commandAllocator[MAX_FRAMES_IN_FLIGHT];
+	ID3D12GraphicsCommandList* m_commandList;
+	ID3D12Resource* m_uploadBuffer;
+
+	D3DFenceClass m_fence;
+	FrameRingClass m_batchRing;		// the batches in flight, every batch has its own commandallocator
+	UploadRingClass m_uploadRing;
+
+	std::mutex m_mutex;
+	bool m_batchOpen;
+	unsigned long long m_submittedFenceValue;
+	unsigned long long m_uploadedBytes;
+
+	bool OpenBatch();
+	bool SubmitBatch();
+	bool AllocateStaging(size_t _size, size_t _alignment, size_t& _offset, void*& _cpuAddress);
+};
+
+#endif
\ No newline at end of file
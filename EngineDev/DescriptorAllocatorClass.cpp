@@ -0,0 +1,331 @@
+#include "DescriptorAllocatorClass.h"
+
+/*
+	Constructor
+*/
+DescriptorAllocatorClass::DescriptorAllocatorClass()
+{
+	m_freeRanges = nullptr;
+	m_freeRangeCount = 0;
+	m_maxFreeRanges = 0;
+	m_persistentCount = 0;
+	m_freeCount = 0;
+	m_fence = nullptr;
+	m_transientCount = 0;
+	m_transientHead = 0;
+	m_transientTail = 0;
+	m_firstTransientFrame = 0;
+	m_transientFrameCount = 0;
+	m_transientWaitCount = 0;
+}
+
+/*
+	Destructor
+*/
+DescriptorAllocatorClass::~DescriptorAllocatorClass()
+{
+
+}
+
+/*
+	All persistent descriptors start as a single free range
+	Free ranges never touch each other, so there are at most half as many ranges as descriptors, allocate room for all of them once
+	The fence is only needed for transient descriptors and is not owned by the allocator
+*/
+bool DescriptorAllocatorClass::Initialize(unsigned int _persistentCount, unsigned int _transientCount, FenceClass* _fence)
+{
+	if (_transientCount > 0 && !_fence)
+	{
+		return false;
+	}
+
+	m_maxFreeRanges = _persistentCount / 2 + 1;
+	m_freeRanges = new FreeRange[m_maxFreeRanges];
+	if (!m_freeRanges)
+	{
+		return false;
+	}
+
+	m_persistentCount = _persistentCount;
+	m_freeCount = _persistentCount;
+	m_freeRangeCount = 0;
+	if (_persistentCount > 0)
+	{
+		m_freeRanges[0].index = 0;
+		m_freeRanges[0].count = _persistentCount;
+		m_freeRangeCount = 1;
+	}
+
+	m_fence = _fence;
+	m_transientCount = _transientCount;
+	m_transientHead = 0;
+	m_transientTail = 0;
+	m_firstTransientFrame = 0;
+	m_transientFrameCount = 0;
+	m_transientWaitCount = 0;
+
+	return true;
+}
+
+void DescriptorAllocatorClass::Shutdown()
+{
+	if (m_freeRanges)
+	{
+		delete[] m_freeRanges;
+		m_freeRanges = nullptr;
+	}
+
+	m_freeRangeCount = 0;
+	m_fence = nullptr;
+}
+
+/*
+	Take _count contiguous persistent descriptors from the first free range which is big enough
+	Returns INVALID_DESCRIPTOR if no range is big enough
+*/
+unsigned int DescriptorAllocatorClass::Allocate(unsigned int _count)
+{
+	if (_count == 0)
+	{
+		return INVALID_DESCRIPTOR;
+	}
+
+	for (unsigned int i = 0; i < m_freeRangeCount; i++)
+	{
+		FreeRange& range = m_freeRanges[i];
+		if (range.count < _count)
+		{
+			continue;
+		}
+
+		unsigned int index = range.index;
+		range.index += _count;
+		range.count -= _count;
+
+		if (range.count == 0)
+		{
+			for (unsigned int j = i + 1; j < m_freeRangeCount; j++)
+			{
+				m_freeRanges[j - 1] = m_freeRanges[j];
+			}
+			m_freeRangeCount--;
+		}
+
+		m_freeCount -= _count;
+
+		return index;
+	}
+
+	return INVALID_DESCRIPTOR;
+}
+
+/*
+	Give back descriptors of Allocate
+	Find the position in the sorted ranges with a binary search and merge the range with the free ranges right before and after it
+*/
+void DescriptorAllocatorClass::Free(unsigned int _index, unsigned int _count)
+{
+	if (_index == INVALID_DESCRIPTOR || _count == 0 || _index + _count > m_persistentCount)
+	{
+		return;
+	}
+
+	unsigned int first = 0;
+	unsigned int last = m_freeRangeCount;
+	while (first < last)
+	{
+		unsigned int middle = (first + last) / 2;
+		if (m_freeRanges[middle].index < _index)
+		{
+			first = middle + 1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+
+	bool mergesWithPrevious = first > 0 && m_freeRanges[first - 1].index + m_freeRanges[first - 1].count == _index;
+	bool mergesWithNext = first < m_freeRangeCount && _index + _count == m_freeRanges[first].index;
+
+	if (mergesWithPrevious && mergesWithNext)
+	{
+		m_freeRanges[first - 1].count += _count + m_freeRanges[first].count;
+		for (unsigned int i = first + 1; i < m_freeRangeCount; i++)
+		{
+			m_freeRanges[i - 1] = m_freeRanges[i];
+		}
+		m_freeRangeCount--;
+	}
+	else if (mergesWithPrevious)
+	{
+		m_freeRanges[first - 1].count += _count;
+	}
+	else if (mergesWithNext)
+	{
+		m_freeRanges[first].index = _index;
+		m_freeRanges[first].count += _count;
+	}
+	else
+	{
+		if (m_freeRangeCount == m_maxFreeRanges)
+		{
+			return;
+		}
+
+		for (unsigned int i = m_freeRangeCount; i > first; i--)
+		{
+			m_freeRanges[i] = m_freeRanges[i - 1];
+		}
+
+		m_freeRanges[first].index = _index;
+		m_freeRanges[first].count = _count;
+		m_freeRangeCount++;
+	}
+
+	m_freeCount += _count;
+}
+
+/*
+	Take _count contiguous descriptors from the ring, they may only be used by the current frame
+	If they do not fit in front of the end of the ring, skip the rest of the ring and start at its beginning
+	Reclaim the frames the GPU finished, if that is not enough wait for the oldest frame
+	Returns INVALID_DESCRIPTOR if the request is bigger than the ring or the current frame alone fills it
+*/
+unsigned int DescriptorAllocatorClass::AllocateTransient(unsigned int _count)
+{
+	if (_count == 0 || _count > m_transientCount)
+	{
+		return INVALID_DESCRIPTOR;
+	}
+
+	RetireTransientFrames();
+
+	while (true)
+	{
+		unsigned int position = static_cast<unsigned int>(m_transientHead % m_transientCount);
+		unsigned int padding = position + _count > m_transientCount ? m_transientCount - position : 0;
+
+		if (m_transientHead + padding + _count - m_transientTail <= m_transientCount)
+		{
+			m_transientHead += padding;
+			unsigned int index = m_persistentCount + static_cast<unsigned int>(m_transientHead % m_transientCount);
+			m_transientHead += _count;
+
+			return index;
+		}
+
+		if (m_transientFrameCount == 0)
+		{
+			return INVALID_DESCRIPTOR;
+		}
+
+		m_transientWaitCount++;
+		if (!m_fence->WaitForValue(m_transientFrames[m_firstTransientFrame].fenceValue))
+		{
+			return INVALID_DESCRIPTOR;
+		}
+
+		RetireTransientFrames();
+	}
+}
+
+/*
+	Called once per frame before the fence is signaled with _fenceValue
+	The transient descriptors of the frame are reclaimed once the fence reached the value
+	If too many frames are pending, wait for the oldest one
+*/
+void DescriptorAllocatorClass::EndFrame(unsigned long long _fenceValue)
+{
+	if (m_transientCount == 0)
+	{
+		return;
+	}
+
+	RetireTransientFrames();
+
+	if (m_transientFrameCount == DESCRIPTOR_RING_FRAMES)
+	{
+		m_transientWaitCount++;
+		m_fence->WaitForValue(m_transientFrames[m_firstTransientFrame].fenceValue);
+		RetireTransientFrames();
+	}
+
+	TransientFrame& frame = m_transientFrames[(m_firstTransientFrame + m_transientFrameCount) % DESCRIPTOR_RING_FRAMES];
+	frame.fenceValue = _fenceValue;
+	frame.end = m_transientHead;
+	m_transientFrameCount++;
+}
+
+/*
+	Persistent descriptors which are not allocated
+*/
+unsigned int DescriptorAllocatorClass::GetFreeCount() const
+{
+	return m_freeCount;
+}
+
+/*
+	Most persistent descriptors a single Allocate can get, compare to GetFreeCount to see the fragmentation
+*/
+unsigned int DescriptorAllocatorClass::GetLargestFreeRange() const
+{
+	unsigned int largestRange = 0;
+
+	for (unsigned int i = 0; i < m_freeRangeCount; i++)
+	{
+		if (m_freeRanges[i].count > largestRange)
+		{
+			largestRange = m_freeRanges[i].count;
+		}
+	}
+
+	return largestRange;
+}
+
+unsigned int DescriptorAllocatorClass::GetFreeRangeCount() const
+{
+	return m_freeRangeCount;
+}
+
+/*
+	Transient descriptors which are not reclaimed yet
+*/
+unsigned int DescriptorAllocatorClass::GetTransientUsed() const
+{
+	return static_cast<unsigned int>(m_transientHead - m_transientTail);
+}
+
+/*
+	How often the ring was full and had to wait for the GPU
+*/
+unsigned long long DescriptorAllocatorClass::GetTransientWaitCount() const
+{
+	return m_transientWaitCount;
+}
+
+/*
+	Free the transient descriptors of every frame the GPU finished, oldest first
+*/
+void DescriptorAllocatorClass::RetireTransientFrames()
+{
+	if (m_transientFrameCount == 0)
+	{
+		return;
+	}
+
+	unsigned long long completedValue = m_fence->GetCompletedValue();
+
+	while (m_transientFrameCount > 0)
+	{
+		const TransientFrame& frame = m_transientFrames[m_firstTransientFrame];
+		if (frame.fenceValue > completedValue)
+		{
+			break;
+		}
+
+		m_transientTail = frame.end;
+		m_firstTransientFrame = (m_firstTransientFrame + 1) % DESCRIPTOR_RING_FRAMES;
+		m_transientFrameCount--;
+	}
+}
\ No newline at end of file
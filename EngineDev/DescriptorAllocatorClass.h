@@ -0,0 +1,69 @@
+#pragma once
+
+#pragma region includes
+#include "FenceClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int INVALID_DESCRIPTOR = 0xFFFFFFFF;
+const unsigned int DESCRIPTOR_RING_FRAMES = 8;		// frames whose transient descriptors may be pending on the GPU
+#pragma endregion
+
+/*
+	Hands out descriptor indices of one descriptor heap, knows nothing about the graphics API
+	The heap is split into two parts:
+	Persistent descriptors [0, persistentCount) live until they are freed, the free ranges are kept sorted and merged with their neighbours
+	Transient descriptors [persistentCount, persistentCount + transientCount) come from a ring and live for a single frame
+	The transient descriptors of a frame are reclaimed as soon as the fence passed the value the frame signaled
+*/
+class DescriptorAllocatorClass
+{
+public:
+	DescriptorAllocatorClass();
+	~DescriptorAllocatorClass();
+
+	bool Initialize(unsigned int _persistentCount, unsigned int _transientCount, FenceClass* _fence);
+	void Shutdown();
+
+	unsigned int Allocate(unsigned int _count = 1);
+	void Free(unsigned int _index, unsigned int _count = 1);
+
+	unsigned int AllocateTransient(unsigned int _count);
+	void EndFrame(unsigned long long _fenceValue);
+
+	unsigned int GetFreeCount() const;
+	unsigned int GetLargestFreeRange() const;
+	unsigned int GetFreeRangeCount() const;
+	unsigned int GetTransientUsed() const;
+	unsigned long long GetTransientWaitCount() const;
+
+private:
+	struct FreeRange
+	{
+		unsigned int index;
+		unsigned int count;
+	};
+
+	struct TransientFrame
+	{
+		unsigned long long fenceValue;
+		unsigned long long end;		// ring position after the last descriptor of the frame
+	};
+
+	FreeRange* m_freeRanges;
+	unsigned int m_freeRangeCount;
+	unsigned int m_maxFreeRanges;
+	unsigned int m_persistentCount;
+	unsigned int m_freeCount;
+
+	FenceClass* m_fence;
+	unsigned int m_transientCount;
+	unsigned long long m_transientHead;		// positions only grow, the index in the ring is position % transientCount
+	unsigned long long m_transientTail;
+	TransientFrame m_transientFrames[DESCRIPTOR_RING_FRAMES];
+	unsigned int m_firstTransientFrame;
+	unsigned int m_transientFrameCount;
+	unsigned long long m_transientWaitCount;
+
+	void RetireTransientFrames();
+};
\ No newline at end of file
@@ -0,0 +1,615 @@
+#include "DrawBatcherClass.h"
+#include "ProfilerClass.h"
+#include <cstdlib>
+#include <cstring>
+
+#pragma region Globals
+static const size_t DRAW_ARRAY_ALIGNMENT = 64;
+static const unsigned int DRAW_KEY_PASS_SHIFT = 60;
+static const unsigned long long DRAW_KEY_DEPTH_MASK = 0xFFFF;
+static const unsigned int DRAW_KEY_TRANSLUCENT_DEPTH_SHIFT = 44;
+static const unsigned int INVALID_DRAW_MATERIAL = 0xFFFFFFFF;
+#pragma endregion
+
+/*
+	Constructor
+*/
+DrawBatcherClass::DrawBatcherClass()
+{
+	m_jobSystem = nullptr;
+	m_memory = nullptr;
+	m_maxPackets = 0;
+	m_meshCount = 0;
+	m_packets = nullptr;
+	m_sortBuffer = nullptr;
+	m_submittedPackets = 0;
+	m_packetCount = 0;
+	m_batches = nullptr;
+	m_instances = nullptr;
+	m_batchCount = 0;
+	m_stateChangeCount = 0;
+	m_sortedDigitCount = 0;
+	m_sortSource = nullptr;
+	m_sortDestination = nullptr;
+	m_sortShift = 0;
+	m_sortJobSize = 0;
+}
+
+/*
+	Destructor
+*/
+DrawBatcherClass::~DrawBatcherClass()
+{
+
+}
+
+/*
+	Start without meshes and with room for _maxPackets packets
+*/
+bool DrawBatcherClass::Initialize(unsigned int _maxPackets, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	if (_maxPackets == 0)
+	{
+		return false;
+	}
+
+	m_meshCount = 0;
+
+	return Reserve(_maxPackets);
+}
+
+void DrawBatcherClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_packets = nullptr;
+	m_sortBuffer = nullptr;
+	m_batches = nullptr;
+	m_instances = nullptr;
+	m_maxPackets = 0;
+	m_meshCount = 0;
+	m_jobSystem = nullptr;
+	Reset();
+}
+
+/*
+	Make room for at least _maxPackets packets, the meshes stay as they are
+	Allocate the packets, the second buffer of the radix sort, the batches and the instances in one block
+	Every array starts on a cache line, so the sort jobs never share one at the start of their part
+	Call it while loading, not while packets are submitted, the packets of the frame are dropped
+*/
+bool DrawBatcherClass::Reserve(unsigned int _maxPackets)
+{
+	if (m_memory && _maxPackets <= m_maxPackets)
+	{
+		return true;
+	}
+
+	size_t sizes[] = { _maxPackets * sizeof(DrawPacket), _maxPackets * sizeof(DrawPacket), _maxPackets * sizeof(DrawBatch), _maxPackets * sizeof(unsigned int) };
+	const unsigned int arrayCount = sizeof(sizes) / sizeof(sizes[0]);
+
+	size_t totalSize = 0;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		totalSize += (sizes[i] + DRAW_ARRAY_ALIGNMENT - 1) & ~(DRAW_ARRAY_ALIGNMENT - 1);
+	}
+
+	unsigned char* memory = static_cast<unsigned char*>(malloc(totalSize + DRAW_ARRAY_ALIGNMENT));
+	if (!memory)
+	{
+		return false;
+	}
+
+	if (m_memory)
+	{
+		free(m_memory);
+	}
+	m_memory = memory;
+	m_maxPackets = _maxPackets;
+
+	void* arrays[arrayCount];
+	size_t offset = (DRAW_ARRAY_ALIGNMENT - reinterpret_cast<size_t>(m_memory) % DRAW_ARRAY_ALIGNMENT) % DRAW_ARRAY_ALIGNMENT;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		arrays[i] = m_memory + offset;
+		offset += (sizes[i] + DRAW_ARRAY_ALIGNMENT - 1) & ~(DRAW_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_packets = static_cast<DrawPacket*>(arrays[0]);
+	m_sortBuffer = static_cast<DrawPacket*>(arrays[1]);
+	m_batches = static_cast<DrawBatch*>(arrays[2]);
+	m_instances = static_cast<unsigned int*>(arrays[3]);
+
+	Reset();
+
+	return true;
+}
+
+/*
+	Remember the buffers and index range of a mesh, the returned index is what Submit takes as _mesh
+	Returns INVALID_DRAW_MESH if the table is full
+	Add the meshes while loading, not while other threads submit packets
+*/
+unsigned int DrawBatcherClass::AddMesh(const DrawMesh& _mesh)
+{
+	if (m_meshCount == MAX_DRAW_MESHES)
+	{
+		return INVALID_DRAW_MESH;
+	}
+
+	m_meshes[m_meshCount] = _mesh;
+
+	return m_meshCount++;
+}
+
+/*
+	Add a draw of one instance to this frame, can be called from any thread
+	_pipeline is a handle of the pipeline cache, _depth the distance to the camera along the view direction
+	Fails if a handle does not fit into its part of the key or if the frame already holds _maxPackets packets
+*/
+bool DrawBatcherClass::Submit(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, float _depth, unsigned int _instance)
+{
+	if (_pass >= MAX_DRAW_PASSES || _pipeline >= MAX_DRAW_PIPELINES || _material >= MAX_DRAW_MATERIALS || _mesh >= m_meshCount)
+	{
+		return false;
+	}
+
+	unsigned int index = m_submittedPackets.fetch_add(1, std::memory_order_relaxed);
+	if (index >= m_maxPackets)
+	{
+		return false;
+	}
+
+	DrawPacket& packet = m_packets[index];
+	packet.key = MakeSortKey(_pass, _pipeline, _material, _mesh, _depth);
+	packet.instance = _instance;
+
+	return true;
+}
+
+/*
+	Add packets whose sort keys were packed already (e.g. by RenderSnapshotClass), can be called from any thread
+	The room for all of them is taken at once, packets of meshes the table does not hold are left out
+	Fails if a packet was left out or the frame runs out of room
+*/
+bool DrawBatcherClass::SubmitPackets(const DrawPacket* _packets, unsigned int _count)
+{
+	unsigned int validCount = 0;
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		DrawBatch batch;
+		DecodeSortKey(_packets[i].key, batch);
+		validCount += batch.mesh < m_meshCount ? 1 : 0;
+	}
+
+	unsigned int index = m_submittedPackets.fetch_add(validCount, std::memory_order_relaxed);
+	if (index >= m_maxPackets)
+	{
+		return _count == 0;
+	}
+
+	bool fits = validCount <= m_maxPackets - index;
+	unsigned int end = fits ? index + validCount : m_maxPackets;
+	for (unsigned int i = 0; i < _count && index < end; i++)
+	{
+		DrawBatch batch;
+		DecodeSortKey(_packets[i].key, batch);
+		if (batch.mesh < m_meshCount)
+		{
+			m_packets[index] = _packets[i];
+			index++;
+		}
+	}
+
+	return fits && validCount == _count;
+}
+
+/*
+	Sort this frame's packets and merge them into batches
+	Call it once every packet of the frame is submitted
+*/
+void DrawBatcherClass::Prepare()
+{
+	PROFILE_SCOPE("DrawBatcherClass::Prepare");
+
+	m_packetCount = m_submittedPackets.load(std::memory_order_acquire);
+	if (m_packetCount > m_maxPackets)
+	{
+		m_packetCount = m_maxPackets;
+	}
+
+	Sort();
+	BuildBatches();
+}
+
+/*
+	Record the batches in order, a state is only set if it differs from the one of the previous draw
+	Batches whose pipeline is still compiling are skipped this frame
+*/
+void DrawBatcherClass::Record(CommandRecorderClass* _recorder, const PipelineCacheClass& _pipelineCache) const
+{
+	PROFILE_SCOPE("DrawBatcherClass::Record");
+
+	void* currentPipeline = nullptr;
+	unsigned int currentMaterial = INVALID_DRAW_MATERIAL;
+	unsigned int currentMesh = INVALID_DRAW_MESH;
+
+	for (unsigned int i = 0; i < m_batchCount; i++)
+	{
+		const DrawBatch& batch = m_batches[i];
+
+		void* pipeline = _pipelineCache.GetPipeline(batch.pipeline);
+		if (!pipeline)
+		{
+			continue;
+		}
+
+		if (pipeline != currentPipeline)
+		{
+			_recorder->SetPipeline(pipeline);
+			currentPipeline = pipeline;
+		}
+
+		if (batch.material != currentMaterial)
+		{
+			_recorder->SetMaterial(batch.material);
+			currentMaterial = batch.material;
+		}
+
+		const DrawMesh& mesh = m_meshes[batch.mesh];
+		if (batch.mesh != currentMesh)
+		{
+			_recorder->SetMesh(mesh);
+			currentMesh = batch.mesh;
+		}
+
+		_recorder->DrawIndexedInstanced(mesh.indexCount, batch.instanceCount, mesh.firstIndex, mesh.baseVertex, batch.firstInstance);
+	}
+}
+
+/*
+	Forget the packets and batches, the meshes stay
+*/
+void DrawBatcherClass::Reset()
+{
+	m_submittedPackets.store(0, std::memory_order_release);
+	m_packetCount = 0;
+	m_batchCount = 0;
+	m_stateChangeCount = 0;
+	m_sortedDigitCount = 0;
+}
+
+/*
+	Pack the state of a draw into 64 bits, ordering the keys orders the draws
+	Positive floats keep their order when their bits are compared as integers, the upper 16 bits are the quantized depth
+*/
+unsigned long long DrawBatcherClass::MakeSortKey(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, float _depth)
+{
+	float depth = _depth > 0.0f ? _depth : 0.0f;
+	unsigned int depthBits;
+	memcpy(&depthBits, &depth, sizeof(depthBits));
+	unsigned long long quantizedDepth = depthBits >> 16;
+
+	unsigned long long key = static_cast<unsigned long long>(_pass & 0xF) << DRAW_KEY_PASS_SHIFT;
+
+	if (_pass == DRAW_PASS_TRANSLUCENT)
+	{
+		key |= (DRAW_KEY_DEPTH_MASK - quantizedDepth) << DRAW_KEY_TRANSLUCENT_DEPTH_SHIFT;
+		key |= static_cast<unsigned long long>(_pipeline & 0xFFF) << 32;
+		key |= static_cast<unsigned long long>(_material & 0xFFFF) << 16;
+		key |= static_cast<unsigned long long>(_mesh & 0xFFFF);
+	}
+	else
+	{
+		key |= static_cast<unsigned long long>(_pipeline & 0xFFF) << 48;
+		key |= static_cast<unsigned long long>(_material & 0xFFFF) << 32;
+		key |= static_cast<unsigned long long>(_mesh & 0xFFFF) << 16;
+		key |= quantizedDepth;
+	}
+
+	return key;
+}
+
+/*
+	The packets sorted by key once Prepare ran
+*/
+const DrawPacket* DrawBatcherClass::GetPackets() const
+{
+	return m_packets;
+}
+
+unsigned int DrawBatcherClass::GetPacketCount() const
+{
+	return m_packetCount;
+}
+
+const DrawBatch* DrawBatcherClass::GetBatches() const
+{
+	return m_batches;
+}
+
+unsigned int DrawBatcherClass::GetBatchCount() const
+{
+	return m_batchCount;
+}
+
+/*
+	The instance of every packet in sorted order, the renderer uploads it for the shaders
+*/
+const unsigned int* DrawBatcherClass::GetInstances() const
+{
+	return m_instances;
+}
+
+/*
+	Pipeline, material and mesh changes between the batches of this frame, if every pipeline is ready
+*/
+unsigned int DrawBatcherClass::GetStateChangeCount() const
+{
+	return m_stateChangeCount;
+}
+
+/*
+	Radix passes the last sort needed, at most 8
+*/
+unsigned int DrawBatcherClass::GetSortedDigitCount() const
+{
+	return m_sortedDigitCount;
+}
+
+/*
+	Packets which did not fit into this frame
+*/
+unsigned int DrawBatcherClass::GetDroppedPacketCount() const
+{
+	unsigned int submittedPackets = m_submittedPackets.load(std::memory_order_relaxed);
+
+	return submittedPackets > m_maxPackets ? submittedPackets - m_maxPackets : 0;
+}
+
+/*
+	LSD radix sort, stable, so every pass keeps the order of the digits sorted before
+	The packets are split into equal parts, one job per part: count the digit of every packet of the part,
+	then every part gets its own range inside every bucket (bucket by bucket, part by part) and scatters its packets there
+	First find the bits which differ between the keys at all, digits without such bits are skipped
+	The sorted packets end up in m_packets, the buffers are swapped instead of copied
+*/
+void DrawBatcherClass::Sort()
+{
+	PROFILE_SCOPE("DrawBatcherClass::Sort");
+
+	m_sortedDigitCount = 0;
+	if (m_packetCount < 2)
+	{
+		return;
+	}
+
+	unsigned int jobCount = 1;
+	if (m_jobSystem && m_packetCount > DRAW_SORT_PACKETS_PER_JOB)
+	{
+		jobCount = (m_packetCount + DRAW_SORT_PACKETS_PER_JOB - 1) / DRAW_SORT_PACKETS_PER_JOB;
+
+		unsigned int maxJobCount = m_jobSystem->GetThreadCount() * 4;
+		if (maxJobCount > DRAW_SORT_MAX_JOBS)
+		{
+			maxJobCount = DRAW_SORT_MAX_JOBS;
+		}
+
+		if (jobCount > maxJobCount)
+		{
+			jobCount = maxJobCount;
+		}
+	}
+
+	m_sortJobSize = (m_packetCount + jobCount - 1) / jobCount;
+	jobCount = (m_packetCount + m_sortJobSize - 1) / m_sortJobSize;
+
+	m_sortSource = m_packets;
+	RunSortJobs(KeyRangeJob, jobCount);
+
+	unsigned long long keyAnd = ~0ULL;
+	unsigned long long keyOr = 0;
+	for (unsigned int i = 0; i < jobCount; i++)
+	{
+		keyAnd &= m_keyAnd[i];
+		keyOr |= m_keyOr[i];
+	}
+	unsigned long long differentBits = keyAnd ^ keyOr;
+
+	for (unsigned int shift = 0; shift < 64; shift += DRAW_SORT_RADIX_BITS)
+	{
+		if (((differentBits >> shift) & (DRAW_SORT_BUCKETS - 1)) == 0)
+		{
+			continue;
+		}
+
+		m_sortShift = shift;
+		m_sortSource = m_packets;
+		m_sortDestination = m_sortBuffer;
+
+		RunSortJobs(HistogramJob, jobCount);
+
+		unsigned int offset = 0;
+		for (unsigned int bucket = 0; bucket < DRAW_SORT_BUCKETS; bucket++)
+		{
+			for (unsigned int job = 0; job < jobCount; job++)
+			{
+				unsigned int count = m_histograms[job][bucket];
+				m_histograms[job][bucket] = offset;
+				offset += count;
+			}
+		}
+
+		RunSortJobs(ScatterJob, jobCount);
+
+		DrawPacket* sorted = m_sortBuffer;
+		m_sortBuffer = m_packets;
+		m_packets = sorted;
+		m_sortedDigitCount++;
+	}
+}
+
+/*
+	Run _function for every part of the packets, on the jobsystem if there is more than one part
+	Without a jobsystem (or called from a thread it does not know) the parts run one after another
+*/
+void DrawBatcherClass::RunSortJobs(JobFunction _function, unsigned int _jobCount)
+{
+	if (m_jobSystem && _jobCount > 1)
+	{
+		JobCounter counter(0);
+		if (m_jobSystem->ParallelFor(_function, this, _jobCount, 1, &counter))
+		{
+			m_jobSystem->WaitForCounter(&counter);
+			return;
+		}
+	}
+
+	_function(this, 0, _jobCount, 0);
+}
+
+/*
+	AND and OR of the keys of the parts [_begin, _end), _data is the DrawBatcherClass
+*/
+void DrawBatcherClass::KeyRangeJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	DrawBatcherClass* drawBatcher = static_cast<DrawBatcherClass*>(_data);
+
+	for (unsigned int job = _begin; job < _end; job++)
+	{
+		unsigned int begin = job * drawBatcher->m_sortJobSize;
+		unsigned int end = begin + drawBatcher->m_sortJobSize < drawBatcher->m_packetCount ? begin + drawBatcher->m_sortJobSize : drawBatcher->m_packetCount;
+
+		unsigned long long keyAnd = ~0ULL;
+		unsigned long long keyOr = 0;
+		for (unsigned int i = begin; i < end; i++)
+		{
+			keyAnd &= drawBatcher->m_sortSource[i].key;
+			keyOr |= drawBatcher->m_sortSource[i].key;
+		}
+
+		drawBatcher->m_keyAnd[job] = keyAnd;
+		drawBatcher->m_keyOr[job] = keyOr;
+	}
+}
+
+/*
+	Count the current digit of the keys of the parts [_begin, _end)
+*/
+void DrawBatcherClass::HistogramJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	DrawBatcherClass* drawBatcher = static_cast<DrawBatcherClass*>(_data);
+	const unsigned int shift = drawBatcher->m_sortShift;
+
+	for (unsigned int job = _begin; job < _end; job++)
+	{
+		unsigned int begin = job * drawBatcher->m_sortJobSize;
+		unsigned int end = begin + drawBatcher->m_sortJobSize < drawBatcher->m_packetCount ? begin + drawBatcher->m_sortJobSize : drawBatcher->m_packetCount;
+
+		unsigned int* histogram = drawBatcher->m_histograms[job];
+		memset(histogram, 0, DRAW_SORT_BUCKETS * sizeof(unsigned int));
+
+		for (unsigned int i = begin; i < end; i++)
+		{
+			histogram[(drawBatcher->m_sortSource[i].key >> shift) & (DRAW_SORT_BUCKETS - 1)]++;
+		}
+	}
+}
+
+/*
+	Move the packets of the parts [_begin, _end) to their place in the other buffer, the histograms hold the offsets by now
+*/
+void DrawBatcherClass::ScatterJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	DrawBatcherClass* drawBatcher = static_cast<DrawBatcherClass*>(_data);
+	const unsigned int shift = drawBatcher->m_sortShift;
+	const DrawPacket* source = drawBatcher->m_sortSource;
+	DrawPacket* destination = drawBatcher->m_sortDestination;
+
+	for (unsigned int job = _begin; job < _end; job++)
+	{
+		unsigned int begin = job * drawBatcher->m_sortJobSize;
+		unsigned int end = begin + drawBatcher->m_sortJobSize < drawBatcher->m_packetCount ? begin + drawBatcher->m_sortJobSize : drawBatcher->m_packetCount;
+
+		unsigned int* offsets = drawBatcher->m_histograms[job];
+		for (unsigned int i = begin; i < end; i++)
+		{
+			destination[offsets[(source[i].key >> shift) & (DRAW_SORT_BUCKETS - 1)]++] = source[i];
+		}
+	}
+}
+
+/*
+	Merge neighbouring packets whose keys only differ in the depth into one batch
+	Count the state changes between the batches the same way Record sets the states
+*/
+void DrawBatcherClass::BuildBatches()
+{
+	PROFILE_SCOPE("DrawBatcherClass::BuildBatches");
+
+	m_batchCount = 0;
+	m_stateChangeCount = 0;
+
+	unsigned long long currentState = 0;
+	for (unsigned int i = 0; i < m_packetCount; i++)
+	{
+		const DrawPacket& packet = m_packets[i];
+		m_instances[i] = packet.instance;
+
+		unsigned int pass = static_cast<unsigned int>(packet.key >> DRAW_KEY_PASS_SHIFT);
+		unsigned long long depthMask = pass == DRAW_PASS_TRANSLUCENT ? DRAW_KEY_DEPTH_MASK << DRAW_KEY_TRANSLUCENT_DEPTH_SHIFT : DRAW_KEY_DEPTH_MASK;
+		unsigned long long state = packet.key & ~depthMask;
+
+		if (m_batchCount == 0 || state != currentState)
+		{
+			DrawBatch& batch = m_batches[m_batchCount];
+			DecodeSortKey(packet.key, batch);
+			batch.firstInstance = i;
+			batch.instanceCount = 0;
+
+			if (m_batchCount == 0)
+			{
+				m_stateChangeCount += 3;
+			}
+			else
+			{
+				const DrawBatch& previous = m_batches[m_batchCount - 1];
+				m_stateChangeCount += batch.pipeline != previous.pipeline ? 1 : 0;
+				m_stateChangeCount += batch.material != previous.material ? 1 : 0;
+				m_stateChangeCount += batch.mesh != previous.mesh ? 1 : 0;
+			}
+
+			currentState = state;
+			m_batchCount++;
+		}
+
+		m_batches[m_batchCount - 1].instanceCount++;
+	}
+}
+
+/*
+	Unpack the state of a key made by MakeSortKey
+*/
+void DrawBatcherClass::DecodeSortKey(unsigned long long _key, DrawBatch& _batch)
+{
+	_batch.pass = static_cast<unsigned int>(_key >> DRAW_KEY_PASS_SHIFT);
+
+	if (_batch.pass == DRAW_PASS_TRANSLUCENT)
+	{
+		_batch.pipeline = static_cast<unsigned int>(_key >> 32) & 0xFFF;
+		_batch.material = static_cast<unsigned int>(_key >> 16) & 0xFFFF;
+		_batch.mesh = static_cast<unsigned int>(_key) & 0xFFFF;
+	}
+	else
+	{
+		_batch.pipeline = static_cast<unsigned int>(_key >> 48) & 0xFFF;
+		_batch.material = static_cast<unsigned int>(_key >> 32) & 0xFFFF;
+		_batch.mesh = static_cast<unsigned int>(_key >> 16) & 0xFFFF;
+	}
+}
\ No newline at end of file
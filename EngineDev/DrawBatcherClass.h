@@ -0,0 +1,126 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include "CommandRecorderClass.h"
+#include "PipelineCacheClass.h"
+#include "JobSystemClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_DRAW_PASSES = 16;			// 4 bits of the sort key
+const unsigned int DRAW_PASS_OPAQUE = 0;
+const unsigned int DRAW_PASS_TRANSLUCENT = 1;		// sorted back to front instead of by state
+const unsigned int MAX_DRAW_PIPELINES = 4096;		// 12 bits, pipeline handles of the pipeline cache
+const unsigned int MAX_DRAW_MATERIALS = 65536;		// 16 bits
+const unsigned int MAX_DRAW_MESHES = 4096;			// 16 bits in the key, the meshes are kept in a table of this size
+const unsigned int INVALID_DRAW_MESH = 0xFFFFFFFF;
+const unsigned int DRAW_SORT_RADIX_BITS = 8;
+const unsigned int DRAW_SORT_BUCKETS = 1 << DRAW_SORT_RADIX_BITS;
+const unsigned int DRAW_SORT_MAX_JOBS = 64;			// the packets are sorted in at most this many parts
+const unsigned int DRAW_SORT_PACKETS_PER_JOB = 4096;
+#pragma endregion
+
+/*
+	A draw of one instance of a mesh, the whole state is packed into the sort key
+	instance is handed to the shaders, e.g. the index of the transform of the object
+*/
+struct DrawPacket
+{
+	unsigned long long key;
+	unsigned int instance;
+};
+
+/*
+	Draws which share pipeline, material and mesh and follow each other after sorting
+	Their instances are [firstInstance, firstInstance + instanceCount) of GetInstances
+*/
+struct DrawBatch
+{
+	unsigned int pass;
+	unsigned int pipeline;
+	unsigned int material;
+	unsigned int mesh;
+	unsigned int firstInstance;
+	unsigned int instanceCount;
+};
+
+/*
+	Submission layer between the code which knows what to draw and the backend which records it
+	Submit is called from any thread (lock-free), every packet gets a 64 bit sort key:
+	pass (4) | pipeline (12) | material (16) | mesh (16) | depth (16), front to back within a state
+	translucent passes put the depth right behind the pass, back to front: pass (4) | inverted depth (16) | pipeline (12) | material (16) | mesh (16)
+
+	Prepare sorts the packets by key with a parallel LSD radix sort (8 bits per pass) on the jobsystem,
+	digits which are the same in every key are skipped, so only the bits which actually differ cost a pass
+	Then neighbouring packets with the same pass, pipeline, material and mesh become one instanced draw
+	Record walks the batches and only sets the pipeline, material and mesh when they change, draws of pipelines which are not ready yet are skipped
+
+	Submit packets until the renderer recorded the frame, Reset starts the next one
+	Allocates everything in Initialize (or Reserve while loading), a frame never allocates
+*/
+class DrawBatcherClass
+{
+public:
+	DrawBatcherClass();
+	~DrawBatcherClass();
+
+	bool Initialize(unsigned int _maxPackets, JobSystemClass* _jobSystem);
+	void Shutdown();
+	bool Reserve(unsigned int _maxPackets);
+
+	unsigned int AddMesh(const DrawMesh& _mesh);
+
+	bool Submit(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, float _depth, unsigned int _instance);
+	bool SubmitPackets(const DrawPacket* _packets, unsigned int _count);
+	void Prepare();
+	void Record(CommandRecorderClass* _recorder, const PipelineCacheClass& _pipelineCache) const;
+	void Reset();
+
+	static unsigned long long MakeSortKey(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, float _depth);
+
+	const DrawPacket* GetPackets() const;
+	unsigned int GetPacketCount() const;
+	const DrawBatch* GetBatches() const;
+	unsigned int GetBatchCount() const;
+	const unsigned int* GetInstances() const;
+	unsigned int GetStateChangeCount() const;
+	unsigned int GetSortedDigitCount() const;
+	unsigned int GetDroppedPacketCount() const;
+
+private:
+	JobSystemClass* m_jobSystem;
+	unsigned char* m_memory;
+	unsigned int m_maxPackets;
+
+	DrawMesh m_meshes[MAX_DRAW_MESHES];
+	unsigned int m_meshCount;
+
+	DrawPacket* m_packets;
+	DrawPacket* m_sortBuffer;
+	std::atomic<unsigned int> m_submittedPackets;
+	unsigned int m_packetCount;
+
+	DrawBatch* m_batches;
+	unsigned int* m_instances;
+	unsigned int m_batchCount;
+	unsigned int m_stateChangeCount;
+	unsigned int m_sortedDigitCount;
+
+	//	State of the radix pass running on the jobsystem
+	const DrawPacket* m_sortSource;
+	DrawPacket* m_sortDestination;
+	unsigned int m_sortShift;
+	unsigned int m_sortJobSize;
+	unsigned int m_histograms[DRAW_SORT_MAX_JOBS][DRAW_SORT_BUCKETS];
+	unsigned long long m_keyAnd[DRAW_SORT_MAX_JOBS];
+	unsigned long long m_keyOr[DRAW_SORT_MAX_JOBS];
+
+	void Sort();
+	void RunSortJobs(JobFunction _function, unsigned int _jobCount);
+	static void KeyRangeJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	static void HistogramJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	static void ScatterJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	void BuildBatches();
+	static void DecodeSortKey(unsigned long long _key, DrawBatch& _batch);
+};
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+
+/*
+	Base class for a GPU timeline fence
+	The queue signals increasing values when it reached a point of the submitted work, the CPU can query and wait for them
+	D3DFenceClass wraps an ID3D12Fence, SimulatedFenceClass emulates a GPU with a fixed amount of work per submission
+*/
+class FenceClass
+{
+public:
+	virtual ~FenceClass() {}
+
+	virtual bool Signal(unsigned long long _value) = 0;
+	virtual unsigned long long GetCompletedValue() = 0;
+	virtual bool WaitForValue(unsigned long long _value) = 0;
+};
\ No newline at end of file
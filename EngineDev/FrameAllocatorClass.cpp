@@ -0,0 +1,99 @@
+#include "FrameAllocatorClass.h"
+
+/*
+	Constructor
+*/
+FrameAllocatorClass::FrameAllocatorClass()
+{
+	m_framesInFlight = 0;
+	m_frameIndex = 0;
+}
+
+/*
+	Destructor
+*/
+FrameAllocatorClass::~FrameAllocatorClass()
+{
+
+}
+
+/*
+	Create one linear allocator per frame in flight (1..MAX_FRAMES_IN_FLIGHT)
+*/
+bool FrameAllocatorClass::Initialize(size_t _sizePerFrame, unsigned int _framesInFlight)
+{
+	m_framesInFlight = _framesInFlight;
+	if (m_framesInFlight < 1)
+	{
+		m_framesInFlight = 1;
+	}
+	if (m_framesInFlight > MAX_FRAMES_IN_FLIGHT)
+	{
+		m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+	}
+
+	for (unsigned int i = 0; i < m_framesInFlight; i++)
+	{
+		if (!m_frames[i].Initialize(_sizePerFrame))
+		{
+			return false;
+		}
+	}
+
+	m_frameIndex = 0;
+
+	return true;
+}
+
+void FrameAllocatorClass::Shutdown()
+{
+	for (unsigned int i = 0; i < m_framesInFlight; i++)
+	{
+		m_frames[i].Shutdown();
+	}
+
+	m_framesInFlight = 0;
+}
+
+/*
+	Allocate from the allocator of the current frame, nullptr if the frame used up its memory
+*/
+void* FrameAllocatorClass::Allocate(size_t _size, size_t _alignment)
+{
+	return m_frames[m_frameIndex].Allocate(_size, _alignment);
+}
+
+/*
+	Move on to the allocator of the next frame and release everything the frame allocated the last time it used it
+*/
+void FrameAllocatorClass::EndFrame()
+{
+	m_frameIndex = (m_frameIndex + 1) % m_framesInFlight;
+	m_frames[m_frameIndex].Reset();
+}
+
+/*
+	Bytes the current frame allocated so far
+*/
+size_t FrameAllocatorClass::GetUsed() const
+{
+	return m_frames[m_frameIndex].GetUsed();
+}
+
+/*
+	Most bytes any frame allocated
+*/
+size_t FrameAllocatorClass::GetPeak() const
+{
+	size_t peak = 0;
+
+	for (unsigned int i = 0; i < m_framesInFlight; i++)
+	{
+		if (m_frames[i].GetPeak() > peak)
+		{
+			peak = m_frames[i].GetPeak();
+		}
+	}
+
+	return peak;
+}
\ No newline at end of file
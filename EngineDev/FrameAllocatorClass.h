@@ -0,0 +1,42 @@
+#pragma once
+
+#pragma region includes
+#include "LinearAllocatorClass.h"
+#include "FrameRingClass.h"
+#pragma endregion
+
+#pragma region global variables
+const size_t FRAME_MEMORY_SIZE = 4 * 1024 * 1024;	// bytes every frame may allocate from the frameallocator
+#pragma endregion
+
+/*
+	Memory for data which only lives for one frame (transient data)
+	Every frame in flight owns its own linear allocator, so the data of a frame stays valid while the next frames are recorded
+	EndFrame is called at the end of SystemClass::Frame and hands out the allocator of the oldest frame again
+*/
+class FrameAllocatorClass
+{
+public:
+	FrameAllocatorClass();
+	~FrameAllocatorClass();
+
+	bool Initialize(size_t _sizePerFrame, unsigned int _framesInFlight);
+	void Shutdown();
+
+	void* Allocate(size_t _size, size_t _alignment = 16);
+	void EndFrame();
+
+	template<typename T>
+	T* AllocateArray(size_t _count)
+	{
+		return m_frames[m_frameIndex].AllocateArray<T>(_count);
+	}
+
+	size_t GetUsed() const;
+	size_t GetPeak() const;
+
+private:
+	LinearAllocatorClass m_frames[MAX_FRAMES_IN_FLIGHT];
+	unsigned int m_framesInFlight;
+	unsigned int m_frameIndex;
+};
\ No newline at end of file
@@ -0,0 +1,154 @@
+#include "FrameRingClass.h"
+
+/*
+	Constructor
+*/
+FrameRingClass::FrameRingClass()
+{
+	m_fence = nullptr;
+	m_framesInFlight = 0;
+	m_frameIndex = 0;
+	m_nextFenceValue = 1;
+	m_waitCount = 0;
+
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_frameFenceValues[i] = 0;
+	}
+}
+
+/*
+	Destructor
+*/
+FrameRingClass::~FrameRingClass()
+{
+
+}
+
+/*
+	Remember the fence the queue signals and clamp the amount of frames in flight to 1..MAX_FRAMES_IN_FLIGHT
+	A fence value of 0 means the frame was never submitted, so there is nothing to wait for
+	Start the fence at position 1
+*/
+bool FrameRingClass::Initialize(FenceClass* _fence, unsigned int _framesInFlight)
+{
+	if (!_fence)
+	{
+		return false;
+	}
+
+	m_fence = _fence;
+
+	m_framesInFlight = _framesInFlight;
+	if (m_framesInFlight < 1)
+	{
+		m_framesInFlight = 1;
+	}
+	if (m_framesInFlight > MAX_FRAMES_IN_FLIGHT)
+	{
+		m_framesInFlight = MAX_FRAMES_IN_FLIGHT;
+	}
+
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_frameFenceValues[i] = 0;
+	}
+
+	m_frameIndex = 0;
+	m_nextFenceValue = 1;
+	m_waitCount = 0;
+
+	return true;
+}
+
+/*
+	The fence is owned by the backend, just forget about it
+*/
+void FrameRingClass::Shutdown()
+{
+	m_fence = nullptr;
+}
+
+/*
+	Called before recording a frame
+	If the GPU did not finish the frame which used the current resources the last time, wait for it
+*/
+bool FrameRingClass::BeginFrame()
+{
+	unsigned long long fenceToWaitFor = m_frameFenceValues[m_frameIndex];
+
+	if (fenceToWaitFor != 0 && m_fence->GetCompletedValue() < fenceToWaitFor)
+	{
+		m_waitCount++;
+
+		return m_fence->WaitForValue(fenceToWaitFor);
+	}
+
+	return true;
+}
+
+/*
+	Called after the work of the frame got submitted
+	Signal the fence and remember the value for the resources of this frame, then move on to the next frame
+*/
+bool FrameRingClass::EndFrame()
+{
+	if (!m_fence->Signal(m_nextFenceValue))
+	{
+		return false;
+	}
+
+	m_frameFenceValues[m_frameIndex] = m_nextFenceValue;
+	m_nextFenceValue++;
+
+	m_frameIndex = (m_frameIndex + 1) % m_framesInFlight;
+
+	return true;
+}
+
+/*
+	Wait until the GPU finished every submitted frame, e.g. before releasing resources on shutdown
+*/
+bool FrameRingClass::WaitForIdle()
+{
+	if (!m_fence || m_nextFenceValue == 1)
+	{
+		return true;
+	}
+
+	return m_fence->WaitForValue(m_nextFenceValue - 1);
+}
+
+unsigned int FrameRingClass::GetFrameIndex() const
+{
+	return m_frameIndex;
+}
+
+/*
+	Value EndFrame signals for the current frame, resources of this frame are free again once the fence reached it
+*/
+unsigned long long FrameRingClass::GetFrameFenceValue() const
+{
+	return m_nextFenceValue;
+}
+
+unsigned int FrameRingClass::GetFramesInFlight() const
+{
+	return m_framesInFlight;
+}
+
+/*
+	How many submitted frames the GPU did not finish yet, at most the amount of frames in flight
+*/
+unsigned long long FrameRingClass::GetFramesAhead() const
+{
+	return (m_nextFenceValue - 1) - m_fence->GetCompletedValue();
+}
+
+/*
+	How often the CPU had to wait for the GPU in BeginFrame
+*/
+unsigned long long FrameRingClass::GetWaitCount() const
+{
+	return m_waitCount;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#pragma region includes
+#include "FenceClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_FRAMES_IN_FLIGHT = 3;
+#pragma endregion
+
+/*
+	Keeps track of the frames the CPU has submitted but the GPU did not finish yet
+	Every frame in flight owns its own resources (e.g. a commandallocator) which are selected by GetFrameIndex
+	The CPU only waits in BeginFrame, when it is about to reuse the resources of a frame the GPU still works on
+*/
+class FrameRingClass
+{
+public:
+	FrameRingClass();
+	~FrameRingClass();
+
+	bool Initialize(FenceClass* _fence, unsigned int _framesInFlight);
+	void Shutdown();
+
+	bool BeginFrame();
+	bool EndFrame();
+	bool WaitForIdle();
+
+	unsigned int GetFrameIndex() const;
+	unsigned long long GetFrameFenceValue() const;
+	unsigned int GetFramesInFlight() const;
+	unsigned long long GetFramesAhead() const;
+	unsigned long long GetWaitCount() const;
+
+private:
+	FenceClass* m_fence;
+	unsigned int m_framesInFlight;
+	unsigned int m_frameIndex;
+	unsigned long long m_frameFenceValues[MAX_FRAMES_IN_FLIGHT];
+	unsigned long long m_nextFenceValue;
+	unsigned long long m_waitCount;
+};
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "FrameStatisticsClass.h"
+#include <cmath>
+
+/*
+	Constructor
+*/
+FrameStatisticsClass::FrameStatisticsClass()
+{
+	Reset();
+}
+
+/*
+	Destructor
+*/
+FrameStatisticsClass::~FrameStatisticsClass()
+{
+
+}
+
+/*
+	Forget all frames
+*/
+void FrameStatisticsClass::Reset()
+{
+	for (unsigned int i = 0; i < FRAME_STATISTICS_WINDOW; i++)
+	{
+		m_frameTimes[i] = 0.0;
+	}
+
+	for (unsigned int i = 0; i < FRAME_STATISTICS_BUCKETS; i++)
+	{
+		m_buckets[i] = 0;
+	}
+
+	m_nextFrame = 0;
+	m_frameCount = 0;
+	m_sum = 0.0;
+}
+
+/*
+	If the window is full, remove the oldest frame from the histogram and the sum
+	Store the new frame in its place and add it to the histogram
+*/
+void FrameStatisticsClass::AddFrameTime(double _milliseconds)
+{
+	if (m_frameCount == FRAME_STATISTICS_WINDOW)
+	{
+		double oldestFrame = m_frameTimes[m_nextFrame];
+		m_buckets[GetBucket(oldestFrame)]--;
+		m_sum -= oldestFrame;
+	}
+	else
+	{
+		m_frameCount++;
+	}
+
+	m_frameTimes[m_nextFrame] = _milliseconds;
+	m_buckets[GetBucket(_milliseconds)]++;
+	m_sum += _milliseconds;
+
+	m_nextFrame = (m_nextFrame + 1) % FRAME_STATISTICS_WINDOW;
+}
+
+unsigned int FrameStatisticsClass::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+/*
+	Average frame time of the window in milliseconds
+*/
+double FrameStatisticsClass::GetAverage() const
+{
+	if (m_frameCount == 0)
+	{
+		return 0.0;
+	}
+
+	return m_sum / static_cast<double>(m_frameCount);
+}
+
+/*
+	Frame time in milliseconds which _percentile (0..1) of the frames in the window did not exceed, e.g. 0.99 for p99
+	Walk through the histogram until we passed enough frames and return the center of that bucket
+*/
+double FrameStatisticsClass::GetPercentile(double _percentile) const
+{
+	if (m_frameCount == 0)
+	{
+		return 0.0;
+	}
+
+	unsigned int targetCount = static_cast<unsigned int>(std::ceil(_percentile * static_cast<double>(m_frameCount)));
+	if (targetCount < 1)
+	{
+		targetCount = 1;
+	}
+
+	unsigned int count = 0;
+	unsigned int bucket = 0;
+	for (; bucket < FRAME_STATISTICS_BUCKETS - 1; bucket++)
+	{
+		count += m_buckets[bucket];
+		if (count >= targetCount)
+		{
+			break;
+		}
+	}
+
+	return FRAME_STATISTICS_MIN_TIME * std::exp2((static_cast<double>(bucket) + 0.5) / FRAME_STATISTICS_SUBBUCKETS);
+}
+
+/*
+	Logarithmic bucket of a frame time, clamped to the range of the histogram
+*/
+unsigned int FrameStatisticsClass::GetBucket(double _milliseconds)
+{
+	if (_milliseconds <= FRAME_STATISTICS_MIN_TIME)
+	{
+		return 0;
+	}
+
+	double bucket = std::log2(_milliseconds / FRAME_STATISTICS_MIN_TIME) * FRAME_STATISTICS_SUBBUCKETS;
+	if (bucket >= static_cast<double>(FRAME_STATISTICS_BUCKETS - 1))
+	{
+		return FRAME_STATISTICS_BUCKETS - 1;
+	}
+
+	return static_cast<unsigned int>(bucket);
+}
\ No newline at end of file
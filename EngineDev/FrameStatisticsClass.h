@@ -0,0 +1,36 @@
+#pragma once
+
+#pragma region global variables
+const unsigned int FRAME_STATISTICS_WINDOW = 1024;			// the statistics cover the last frames only
+const unsigned int FRAME_STATISTICS_SUBBUCKETS = 16;		// buckets per power of two, ~4% resolution
+const unsigned int FRAME_STATISTICS_BUCKETS = FRAME_STATISTICS_SUBBUCKETS * 24;
+const double FRAME_STATISTICS_MIN_TIME = 0.0001;			// milliseconds, the histogram covers 0.1 us up to ~1.7 s
+#pragma endregion
+
+/*
+	Rolling statistics over the frame times of the last FRAME_STATISTICS_WINDOW frames
+	The frame times are sorted into a logarithmic histogram, so adding a frame and querying a percentile never sorts
+	The oldest frame leaves the histogram again as soon as the window is full
+*/
+class FrameStatisticsClass
+{
+public:
+	FrameStatisticsClass();
+	~FrameStatisticsClass();
+
+	void Reset();
+	void AddFrameTime(double _milliseconds);
+
+	unsigned int GetFrameCount() const;
+	double GetAverage() const;
+	double GetPercentile(double _percentile) const;
+
+private:
+	double m_frameTimes[FRAME_STATISTICS_WINDOW];
+	unsigned int m_buckets[FRAME_STATISTICS_BUCKETS];
+	unsigned int m_nextFrame;
+	unsigned int m_frameCount;
+	double m_sum;
+
+	static unsigned int GetBucket(double _milliseconds);
+};
\ No newline at end of file
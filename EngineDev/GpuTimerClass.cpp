@@ -0,0 +1,219 @@
+#include "GpuTimerClass.h"
+#include "ProfilerClass.h"
+
+/*
+	Constructor
+*/
+GpuTimerClass::GpuTimerClass()
+{
+	m_queries = nullptr;
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_frames[i].frameNumber = 0;
+		m_frames[i].zoneCount = 0;
+	}
+	m_frameIndex = 0;
+	m_frameNumber = 0;
+	m_zoneCount = 0;
+	m_resolvedFrame = 0;
+	m_profilerTrack = 0;
+}
+
+/*
+	Destructor
+*/
+GpuTimerClass::~GpuTimerClass()
+{
+
+}
+
+/*
+	The queries are not owned by the timer, they need room for GPU_TIMER_QUERY_COUNT timestamps
+	Create the GPU track in the profiler
+*/
+bool GpuTimerClass::Initialize(TimestampQueriesClass* _queries)
+{
+	if (!_queries || _queries->GetQueryCount() < GPU_TIMER_QUERY_COUNT || _queries->GetFrequency() == 0)
+	{
+		return false;
+	}
+
+	m_queries = _queries;
+	m_frameIndex = 0;
+	m_frameNumber = 0;
+	m_zoneCount = 0;
+	m_resolvedFrame = 0;
+
+	for (unsigned int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+	{
+		m_frames[i].frameNumber = 0;
+		m_frames[i].zoneCount = 0;
+	}
+
+#ifdef ENGINE_PROFILING
+	m_profilerTrack = ProfilerClass::CreateTrack("GPU");
+#endif
+
+	return true;
+}
+
+void GpuTimerClass::Shutdown()
+{
+	m_queries = nullptr;
+}
+
+/*
+	Called after the frame ring waited for the frame in flight, so the GPU is done with the last frame which used it
+	Read the results of that frame and hand the queries to the new frame
+*/
+void GpuTimerClass::BeginFrame(unsigned int _frameIndex)
+{
+	if (m_frames[_frameIndex].zoneCount > 0)
+	{
+		ReadFrame(_frameIndex);
+	}
+
+	m_frameNumber++;
+	m_frameIndex = _frameIndex;
+	m_frames[_frameIndex].frameNumber = m_frameNumber;
+	m_frames[_frameIndex].zoneCount = 0;
+}
+
+/*
+	Record the timestamp at the begin of a zone
+	Every zone has a fixed index, so zones can be recorded into different commandlists on different threads
+	_name has to stay valid until the results are read, use string literals
+*/
+void GpuTimerClass::BeginZone(CommandRecorderClass* _recorder, unsigned int _zone, const char* _name)
+{
+	if (_zone >= MAX_GPU_TIMER_ZONES)
+	{
+		return;
+	}
+
+	m_frames[m_frameIndex].zoneNames[_zone] = _name;
+	_recorder->WriteTimestamp(GetQueryIndex(m_frameIndex, _zone));
+}
+
+void GpuTimerClass::EndZone(CommandRecorderClass* _recorder, unsigned int _zone)
+{
+	if (_zone >= MAX_GPU_TIMER_ZONES)
+	{
+		return;
+	}
+
+	_recorder->WriteTimestamp(GetQueryIndex(m_frameIndex, _zone) + 1);
+}
+
+/*
+	Resolve the zones [0, _zoneCount) of this frame
+	Has to be recorded after every zone, e.g. at the end of the last commandlist of the frame
+*/
+void GpuTimerClass::Resolve(CommandRecorderClass* _recorder, unsigned int _zoneCount)
+{
+	if (_zoneCount > MAX_GPU_TIMER_ZONES)
+	{
+		_zoneCount = MAX_GPU_TIMER_ZONES;
+	}
+
+	_recorder->ResolveTimestamps(GetQueryIndex(m_frameIndex, 0), _zoneCount * 2);
+	m_frames[m_frameIndex].zoneCount = _zoneCount;
+}
+
+/*
+	Amount of zones of the last frame which was read
+*/
+unsigned int GpuTimerClass::GetZoneCount() const
+{
+	return m_zoneCount;
+}
+
+const char* GpuTimerClass::GetZoneName(unsigned int _zone) const
+{
+	return m_zoneNames[_zone];
+}
+
+/*
+	Milliseconds the GPU took for the zone in the last frame which was read
+*/
+double GpuTimerClass::GetZoneTime(unsigned int _zone) const
+{
+	return m_zoneTimes[_zone];
+}
+
+/*
+	Number of the frame the zone times belong to, 0 until the first frame was read
+*/
+unsigned long long GpuTimerClass::GetResolvedFrame() const
+{
+	return m_resolvedFrame;
+}
+
+/*
+	Number of the frame which is recorded right now, starts at 1
+*/
+unsigned long long GpuTimerClass::GetFrameNumber() const
+{
+	return m_frameNumber;
+}
+
+/*
+	Copy the resolved timestamps of the frame in flight and turn every begin/end pair into milliseconds
+	If the GPU clock got reset in between (e.g. power management), end is before begin and the zone reports 0
+	Calibrate the GPU clock against the CPU clock to place the zones on the profiler timeline
+*/
+void GpuTimerClass::ReadFrame(unsigned int _frameIndex)
+{
+	FrameQueries& frame = m_frames[_frameIndex];
+
+	if (!m_queries->ReadTimestamps(GetQueryIndex(_frameIndex, 0), frame.zoneCount * 2, m_timestamps))
+	{
+		return;
+	}
+
+	double millisecondsPerTick = 1000.0 / static_cast<double>(m_queries->GetFrequency());
+
+	for (unsigned int i = 0; i < frame.zoneCount; i++)
+	{
+		unsigned long long begin = m_timestamps[i * 2];
+		unsigned long long end = m_timestamps[i * 2 + 1];
+
+		m_zoneNames[i] = frame.zoneNames[i];
+		m_zoneTimes[i] = end > begin ? static_cast<double>(end - begin) * millisecondsPerTick : 0.0;
+	}
+
+	m_zoneCount = frame.zoneCount;
+	m_resolvedFrame = frame.frameNumber;
+
+#ifdef ENGINE_PROFILING
+	unsigned long long gpuTimestamp = 0;
+	unsigned long long cpuMicroseconds = 0;
+	if (!m_queries->Calibrate(gpuTimestamp, cpuMicroseconds))
+	{
+		return;
+	}
+
+	//	Ticks of the profiler are nanoseconds of the same clock as the microseconds of the calibration
+	double nanosecondsPerTick = millisecondsPerTick * 1000000.0;
+	long long calibrationTicks = static_cast<long long>(cpuMicroseconds * 1000);
+
+	for (unsigned int i = 0; i < frame.zoneCount; i++)
+	{
+		long long begin = calibrationTicks + static_cast<long long>(static_cast<double>(static_cast<long long>(m_timestamps[i * 2] - gpuTimestamp)) * nanosecondsPerTick);
+		long long end = calibrationTicks + static_cast<long long>(static_cast<double>(static_cast<long long>(m_timestamps[i * 2 + 1] - gpuTimestamp)) * nanosecondsPerTick);
+
+		if (begin > 0 && end >= begin)
+		{
+			ProfilerClass::AddZone(m_profilerTrack, m_zoneNames[i], static_cast<unsigned long long>(begin), static_cast<unsigned long long>(end), 0);
+		}
+	}
+#endif
+}
+
+/*
+	Query of the begin of the zone, the end follows right after it
+*/
+unsigned int GpuTimerClass::GetQueryIndex(unsigned int _frameIndex, unsigned int _zone)
+{
+	return (_frameIndex * MAX_GPU_TIMER_ZONES + _zone) * 2;
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#pragma region includes
+#include "CommandRecorderClass.h"
+#include "TimestampQueriesClass.h"
+#include "FrameRingClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_GPU_TIMER_ZONES = 32;	// zones per frame, every zone takes a begin and an end query
+const unsigned int GPU_TIMER_QUERY_COUNT = MAX_FRAMES_IN_FLIGHT * MAX_GPU_TIMER_ZONES * 2;
+#pragma endregion
+
+/*
+	Measures how long zones of a frame (e.g. the render passes) take on the GPU
+	Every frame in flight owns its own range of queries, the commandlists write a timestamp at the begin and the end of every zone
+	The last commandlist of the frame resolves the range, it is read when the frame ring hands out the same frame in flight again
+	So the results arrive a few frames late, but the CPU never waits for them
+	With the profiler enabled the zones are added to the "GPU" track of the profiler timeline
+*/
+class GpuTimerClass
+{
+public:
+	GpuTimerClass();
+	~GpuTimerClass();
+
+	bool Initialize(TimestampQueriesClass* _queries);
+	void Shutdown();
+
+	void BeginFrame(unsigned int _frameIndex);
+	void BeginZone(CommandRecorderClass* _recorder, unsigned int _zone, const char* _name);
+	void EndZone(CommandRecorderClass* _recorder, unsigned int _zone);
+	void Resolve(CommandRecorderClass* _recorder, unsigned int _zoneCount);
+
+	unsigned int GetZoneCount() const;
+	const char* GetZoneName(unsigned int _zone) const;
+	double GetZoneTime(unsigned int _zone) const;
+	unsigned long long GetResolvedFrame() const;
+	unsigned long long GetFrameNumber() const;
+
+private:
+	struct FrameQueries
+	{
+		unsigned long long frameNumber;
+		unsigned int zoneCount;		// 0 until the frame recorded its resolve
+		const char* zoneNames[MAX_GPU_TIMER_ZONES];
+	};
+
+	TimestampQueriesClass* m_queries;
+	FrameQueries m_frames[MAX_FRAMES_IN_FLIGHT];
+	unsigned int m_frameIndex;
+	unsigned long long m_frameNumber;
+
+	unsigned long long m_timestamps[MAX_GPU_TIMER_ZONES * 2];
+	const char* m_zoneNames[MAX_GPU_TIMER_ZONES];
+	double m_zoneTimes[MAX_GPU_TIMER_ZONES];	// milliseconds
+	unsigned int m_zoneCount;
+	unsigned long long m_resolvedFrame;
+	unsigned int m_profilerTrack;
+
+	void ReadFrame(unsigned int _frameIndex);
+	static unsigned int GetQueryIndex(unsigned int _frameIndex, unsigned int _zone);
+};
\ No newline at end of file
@@ -1,11 +1,86 @@
 #include "GraphicsClass.h"
+#include "ProfilerClass.h"
+#include "NullRendererClass.h"
+#include "SoftwareRendererClass.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#ifdef _WIN32
+#include "D3DClass.h"
+#endif
+
+#pragma region Globals
+static const char* const MESH_SHADER_PATH = "Shaders/Mesh.hlsl";
+static const unsigned int FORMAT_R16G16B16A16_UNORM = 11;		// DXGI_FORMAT values, the portable code does not include DXGI
+static const unsigned int FORMAT_R8G8B8A8_UNORM = 28;
+static const unsigned int FORMAT_R16G16_FLOAT = 34;
+static const unsigned int FORMAT_R16G16_SNORM = 37;
+#pragma endregion
+
+/*
+	Pipeline of the cooked meshes: MeshVertex as vertex input, opaque into the back buffer
+*/
+static PipelineDesc GetMeshPipelineDesc()
+{
+	PipelineDesc desc;
+	strncpy(desc.vertexShader, MESH_SHADER_PATH, MAX_SHADER_PATH - 1);
+	strncpy(desc.vertexEntryPoint, "VertexMain", MAX_SHADER_ENTRY_POINT - 1);
+	strncpy(desc.pixelShader, MESH_SHADER_PATH, MAX_SHADER_PATH - 1);
+	strncpy(desc.pixelEntryPoint, "PixelMain", MAX_SHADER_ENTRY_POINT - 1);
+
+	const char* semantics[3] = { "POSITION", "NORMAL", "TEXCOORD" };
+	const unsigned int formats[3] = { FORMAT_R16G16B16A16_UNORM, FORMAT_R16G16_SNORM, FORMAT_R16G16_FLOAT };
+	const unsigned int offsets[3] = { offsetof(MeshVertex, position), offsetof(MeshVertex, normal), offsetof(MeshVertex, texcoord) };
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		strncpy(desc.vertexElements[i].semantic, semantics[i], MAX_VERTEX_SEMANTIC - 1);
+		desc.vertexElements[i].format = formats[i];
+		desc.vertexElements[i].offset = offsets[i];
+	}
+	desc.vertexElementCount = 3;
+	desc.topology = PIPELINE_TOPOLOGY_TRIANGLE;
+
+	desc.renderTargetFormats[0] = FORMAT_R8G8B8A8_UNORM;
+	desc.renderTargetCount = 1;
+
+	desc.fillMode = PIPELINE_FILL_SOLID;
+	desc.cullMode = PIPELINE_CULL_BACK;
+	desc.blendMode = PIPELINE_BLEND_OPAQUE;
+	desc.depthMode = PIPELINE_DEPTH_NONE;
+
+	return desc;
+}
 
 /*
 	Constructor
 */
 GraphicsClass::GraphicsClass()
 {
-
+	m_renderer = nullptr;
+	m_jobSystem = nullptr;
+	m_viewMatrix = MathClass::Identity();
+	m_projectionMatrix = MathClass::Identity();
+	m_culling = nullptr;
+	m_bvh = nullptr;
+	m_lod = nullptr;
+	m_lodProjectionScale = 0.0f;
+	m_drawBatcher = nullptr;
+	m_scene = nullptr;
+	m_meshPipeline = INVALID_PIPELINE;
+	m_maxSceneObjects = 0;
+	m_sceneObjectCapacity = 0;
+	m_sceneMeshCount = 0;
+	m_objectMeshes = nullptr;
+	m_objectMaterials = nullptr;
+	m_sceneCulling = SCENE_CULLING;
+	m_bvhVisibleObjects = nullptr;
+	m_visibleObjects = nullptr;
+	m_visibleCount = 0;
+	m_camera = { 0.0f, 0.0f, 0.0f };
+	m_cameraForward = { 0.0f, 0.0f, 1.0f };
+	m_sceneDrawCount.store(0);
+	m_sceneTriangleCount.store(0);
 }
 
 /*
@@ -18,9 +93,141 @@ GraphicsClass::~GraphicsClass()
 
 /*
 	Here we will be initializing and starting the renderfunction
+	_software renders on the CPU, with the window if there is one
+	Without a window (headless) or on a platform without DirectX 12 we render with the null backend
+	Otherwise create DirectX 12 as our backend, if the device can not be created fall back to the software backend
+	The present settings go to the backend, which resolves them against what it supports
+	The projection matrix maps SCREEN_NEAR - SCREEN_DEPTH to the depth range 0 - 1
+	The camera starts 10 units in front of the origin looking at it
+	The level of detail selection measures errors in pixels of this projection and screen height
+	The pipeline of the meshes is requested right away, it is created on a background job while the scene loads
+	Everything which works on the objects of the scene starts with room for INITIAL_SCENE_OBJECTS, LoadScene grows it to the objects of the scene
+	_maxSceneObjects is only the limit of a scene, nothing is allocated for it up front
 */
-bool GraphicsClass::Initialize(int _screenHeight, int _screenWidth, HWND _windowHandle)
+bool GraphicsClass::Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, bool _headless, bool _software, const PresentSettings& _presentSettings, unsigned int _maxSceneObjects, JobSystemClass* _jobSystem)
 {
+	PROFILE_SCOPE("GraphicsClass::Initialize");
+
+	m_jobSystem = _jobSystem;
+
+	if (_software)
+	{
+		m_renderer = new SoftwareRendererClass();
+	}
+#ifdef _WIN32
+	else if (_headless || !_windowHandle)
+	{
+		m_renderer = new NullRendererClass();
+	}
+	else
+	{
+		m_renderer = new D3DClass();
+	}
+#else
+	else
+	{
+		m_renderer = new NullRendererClass();
+	}
+#endif
+	if (!m_renderer)
+	{
+		return false;
+	}
+
+	bool initializedRenderer = m_renderer->Initialize(_screenHeight, _screenWidth, _windowHandle, _presentSettings, FULL_SCREEN, FRAMES_IN_FLIGHT, _jobSystem);
+#ifdef _WIN32
+	if (!initializedRenderer && !_software && !_headless && _windowHandle)
+	{
+		m_renderer->Shutdown();
+		delete m_renderer;
+
+		m_renderer = new SoftwareRendererClass();
+		if (!m_renderer)
+		{
+			return false;
+		}
+
+		initializedRenderer = m_renderer->Initialize(_screenHeight, _screenWidth, _windowHandle, _presentSettings, FULL_SCREEN, FRAMES_IN_FLIGHT, _jobSystem);
+	}
+#endif
+	if (!initializedRenderer)
+	{
+		return false;
+	}
+
+	m_culling = new CullingClass();
+	if (!m_culling)
+	{
+		return false;
+	}
+
+	unsigned int initialObjects = std::min(INITIAL_SCENE_OBJECTS, _maxSceneObjects);
+	bool initializedCulling = m_culling->Initialize(initialObjects, _jobSystem);
+	if (!initializedCulling)
+	{
+		return false;
+	}
+
+	m_bvh = new BvhClass();
+	if (!m_bvh)
+	{
+		return false;
+	}
+
+	bool initializedBvh = m_bvh->Initialize(initialObjects, _jobSystem);
+	if (!initializedBvh)
+	{
+		return false;
+	}
+
+	m_lod = new LodClass();
+	if (!m_lod)
+	{
+		return false;
+	}
+
+	bool initializedLod = m_lod->Initialize(initialObjects, _jobSystem);
+	if (!initializedLod)
+	{
+		return false;
+	}
+
+	m_drawBatcher = new DrawBatcherClass();
+	if (!m_drawBatcher)
+	{
+		return false;
+	}
+
+	bool initializedDrawBatcher = m_drawBatcher->Initialize(initialObjects + MAX_DRAW_PACKETS, _jobSystem);
+	if (!initializedDrawBatcher)
+	{
+		return false;
+	}
+
+	m_renderer->SetDrawBatcher(m_drawBatcher);
+	m_meshPipeline = m_renderer->RequestPipeline(GetMeshPipelineDesc());
+
+	m_scene = new SceneFileClass();
+	if (!m_scene)
+	{
+		return false;
+	}
+
+	m_objectMeshes = new unsigned int[initialObjects];
+	m_objectMaterials = new unsigned int[initialObjects];
+	m_bvhVisibleObjects = new unsigned int[initialObjects];
+	if (!m_objectMeshes || !m_objectMaterials || !m_bvhVisibleObjects)
+	{
+		return false;
+	}
+	m_maxSceneObjects = _maxSceneObjects;
+	m_sceneObjectCapacity = initialObjects;
+	m_sceneMeshCount = 0;
+
+	m_viewMatrix = MathClass::LookAt({ 0.0f, 0.0f, -10.0f }, { 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f });
+	m_projectionMatrix = MathClass::Perspective(FIELD_OF_VIEW, static_cast<float>(_screenWidth) / static_cast<float>(_screenHeight), SCREEN_NEAR, SCREEN_DEPTH);
+	m_lodProjectionScale = LodClass::GetProjectionScale(m_projectionMatrix, static_cast<unsigned int>(_screenHeight));
+
 	return true;
 }
 
@@ -29,15 +236,643 @@ bool GraphicsClass::Initialize(int _screenHeight, int _screenWidth, HWND _window
 */
 void GraphicsClass::Shutdown()
 {
+	if (m_renderer)
+	{
+		m_renderer->SetDrawBatcher(nullptr);
+	}
+
+	if (m_bvhVisibleObjects)
+	{
+		delete[] m_bvhVisibleObjects;
+		m_bvhVisibleObjects = nullptr;
+	}
+	m_visibleObjects = nullptr;
+	m_visibleCount = 0;
+
+	if (m_objectMaterials)
+	{
+		delete[] m_objectMaterials;
+		m_objectMaterials = nullptr;
+	}
+
+	if (m_objectMeshes)
+	{
+		delete[] m_objectMeshes;
+		m_objectMeshes = nullptr;
+	}
+	m_maxSceneObjects = 0;
+	m_sceneObjectCapacity = 0;
+	m_sceneMeshCount = 0;
+
+	if (m_scene)
+	{
+		m_scene->Close();
+		delete m_scene;
+		m_scene = nullptr;
+	}
+
+	if (m_drawBatcher)
+	{
+		m_drawBatcher->Shutdown();
+		delete m_drawBatcher;
+		m_drawBatcher = nullptr;
+	}
+
+	if (m_lod)
+	{
+		m_lod->Shutdown();
+		delete m_lod;
+		m_lod = nullptr;
+		m_lodProjectionScale = 0.0f;
+	}
+
+	if (m_bvh)
+	{
+		m_bvh->Shutdown();
+		delete m_bvh;
+		m_bvh = nullptr;
+	}
+
+	if (m_culling)
+	{
+		m_culling->Shutdown();
+		delete m_culling;
+		m_culling = nullptr;
+	}
+
+	if (m_renderer)
+	{
+		m_renderer->Shutdown();
+		delete m_renderer;
+		m_renderer = nullptr;
+	}
+
+	m_jobSystem = nullptr;
+}
+
+/*
+	Wait until the backend can present the next frame without blocking, the frame samples its input right after this
+	Called on the simulation thread, also while the render thread renders
+*/
+bool GraphicsClass::WaitForFrameLatency()
+{
+	PROFILE_SCOPE("GraphicsClass::WaitForFrameLatency");
+
+	return m_renderer->WaitForFrameLatency();
+}
+
+/*
+	Render the frame the snapshot describes, on the render thread if there is one
+*/
+bool GraphicsClass::Frame(const RenderSnapshotClass& _snapshot)
+{
+	PROFILE_SCOPE("GraphicsClass::Frame");
+
+	bool result = Render(_snapshot);
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Write the last presented frame to an image file, fails if the backend has no CPU readable framebuffer
+*/
+bool GraphicsClass::SaveScreenshot(const char* _path)
+{
+	return m_renderer ? m_renderer->SaveScreenshot(_path) : false;
+}
+
+/*
+	Write the commands of the last frames to a file, fails if the backend does not record commands
+*/
+bool GraphicsClass::SaveCommandCapture(const char* _path)
+{
+	const CommandCaptureClass* commandCapture = m_renderer ? m_renderer->GetCommandCapture() : nullptr;
 
+	return commandCapture ? commandCapture->Save(_path) : false;
 }
 
-bool GraphicsClass::Frame()
+/*
+	Map a scene file, grow the scene stages to its objects and fill the culling stage, the bvh and the level of detail selection with their bounds
+	The objects only have their full level until their meshes are given to the level of detail selection (GetLod, LodClass::SetMesh)
+	Only the bounds section is touched, the other sections are paged in once they are asked for (GetScene)
+	The objects are not drawn until their meshes are added (AddMesh)
+	Call it before the first frame, a scene with more objects than Initialize was given is rejected
+*/
+bool GraphicsClass::LoadScene(const char* _path)
 {
+	PROFILE_SCOPE("GraphicsClass::LoadScene");
+
+	if (!m_scene->Open(_path))
+	{
+		return false;
+	}
+
+	const SceneBoundsSection* bounds = m_scene->GetBounds();
+	if (!bounds || m_scene->GetObjectCount() > m_maxSceneObjects || !ReserveSceneObjects(m_scene->GetObjectCount()))
+	{
+		m_scene->Close();
+		return false;
+	}
+
+	BoundingBoxArrays boxes;
+	boxes.centerX = bounds->centerX.Get();
+	boxes.centerY = bounds->centerY.Get();
+	boxes.centerZ = bounds->centerZ.Get();
+	boxes.extentX = bounds->extentX.Get();
+	boxes.extentY = bounds->extentY.Get();
+	boxes.extentZ = bounds->extentZ.Get();
+
+	if (!m_culling->Build(boxes, m_scene->GetObjectCount()) || !m_bvh->Build(boxes, m_scene->GetObjectCount()))
+	{
+		m_scene->Close();
+		return false;
+	}
+
+	float fullLevel = 0.0f;
+	for (unsigned int i = 0; i < m_scene->GetObjectCount(); i++)
+	{
+		Vector3 extent = { boxes.extentX[i], boxes.extentY[i], boxes.extentZ[i] };
+		m_lod->SetObject(i, { boxes.centerX[i], boxes.centerY[i], boxes.centerZ[i] }, MathClass::Length(extent));
+		m_lod->SetLevels(i, &fullLevel, 1);
+		m_objectMeshes[i] = INVALID_SCENE_MESH;
+		m_objectMaterials[i] = 0;
+	}
+
 	return true;
 }
 
-bool GraphicsClass::Render()
+/*
+	Create the buffers of a cooked mesh on the backend and draw every object of the scene which references _id with it
+	Every level of detail of the mesh becomes a mesh of the draw batcher with the index range of the level, the objects get the errors of the levels
+	The material of an object comes from the scene, materials which do not fit into the sort key use material 0
+	Call it after LoadScene while loading, fails if the backend can not create the mesh or MAX_SCENE_MESHES are added already
+*/
+bool GraphicsClass::AddMesh(unsigned long long _id, const MeshAssetHeader& _mesh)
 {
+	PROFILE_SCOPE("GraphicsClass::AddMesh");
+
+	if (m_sceneMeshCount == MAX_SCENE_MESHES)
+	{
+		return false;
+	}
+
+	DrawMesh drawMesh;
+	if (!m_renderer->CreateMesh(_mesh, drawMesh))
+	{
+		return false;
+	}
+
+	//	The levels take consecutive meshes of the draw batcher, a mesh without levels draws all of its indices as level 0
+	unsigned int levelCount = _mesh.lodCount < MESH_MAX_LODS ? _mesh.lodCount : MESH_MAX_LODS;
+	SceneMesh& sceneMesh = m_sceneMeshes[m_sceneMeshCount];
+	sceneMesh.id = _id;
+	sceneMesh.drawMesh = INVALID_DRAW_MESH;
+	sceneMesh.levelCount = levelCount > 0 ? levelCount : 1;
+
+	for (unsigned int level = 0; level < sceneMesh.levelCount; level++)
+	{
+		if (levelCount > 0)
+		{
+			drawMesh.firstIndex = _mesh.lods[level].firstIndex;
+			drawMesh.indexCount = _mesh.lods[level].indexCount;
+		}
+
+		unsigned int drawMeshIndex = m_drawBatcher->AddMesh(drawMesh);
+		if (drawMeshIndex == INVALID_DRAW_MESH)
+		{
+			return false;
+		}
+
+		if (level == 0)
+		{
+			sceneMesh.drawMesh = drawMeshIndex;
+		}
+		sceneMesh.triangleCounts[level] = drawMesh.indexCount / 3;
+		sceneMesh.errors[level] = levelCount > 0 ? _mesh.lods[level].error : 0.0f;
+	}
+	unsigned int sceneMeshIndex = m_sceneMeshCount++;
+
+	const SceneMeshSection* meshes = m_scene->IsOpen() ? m_scene->GetMeshes() : nullptr;
+	if (!meshes)
+	{
+		return true;
+	}
+
+	//	The errors of the levels grow with the largest scale of the object
+	const SceneTransformSection* transforms = m_scene->GetTransforms();
+	const unsigned long long* meshIds = meshes->meshIds.Get();
+	const unsigned int* materials = meshes->materials.Get();
+	for (unsigned int i = 0; i < m_scene->GetObjectCount(); i++)
+	{
+		if (meshIds[i] == _id)
+		{
+			m_objectMeshes[i] = sceneMeshIndex;
+			m_objectMaterials[i] = materials[i] < MAX_DRAW_MATERIALS ? materials[i] : 0;
+
+			float scale = 1.0f;
+			if (transforms)
+			{
+				scale = std::max(std::fabs(transforms->scaleX.Get()[i]), std::max(std::fabs(transforms->scaleY.Get()[i]), std::fabs(transforms->scaleZ.Get()[i])));
+			}
+			if (levelCount > 0)
+			{
+				m_lod->SetMesh(i, _mesh, scale);
+			}
+		}
+	}
+
 	return true;
+}
+
+/*
+	Size everything which works on the objects of the scene for _count objects, it only grows
+	The culling stage, the bvh and the level of detail selection start over empty, the draw batcher keeps its meshes
+*/
+bool GraphicsClass::ReserveSceneObjects(unsigned int _count)
+{
+	if (_count <= m_sceneObjectCapacity)
+	{
+		return true;
+	}
+
+	m_sceneObjectCapacity = 0;
+
+	m_culling->Shutdown();
+	if (!m_culling->Initialize(_count, m_jobSystem))
+	{
+		return false;
+	}
+
+	m_bvh->Shutdown();
+	if (!m_bvh->Initialize(_count, m_jobSystem))
+	{
+		return false;
+	}
+
+	m_lod->Shutdown();
+	if (!m_lod->Initialize(_count, m_jobSystem))
+	{
+		return false;
+	}
+
+	if (!m_drawBatcher->Reserve(_count + MAX_DRAW_PACKETS))
+	{
+		return false;
+	}
+
+	delete[] m_bvhVisibleObjects;
+	delete[] m_objectMaterials;
+	delete[] m_objectMeshes;
+	m_objectMeshes = new unsigned int[_count];
+	m_objectMaterials = new unsigned int[_count];
+	m_bvhVisibleObjects = new unsigned int[_count];
+	m_visibleObjects = nullptr;
+	m_visibleCount = 0;
+	if (!m_objectMeshes || !m_objectMaterials || !m_bvhVisibleObjects)
+	{
+		return false;
+	}
+	m_sceneObjectCapacity = _count;
+
+	return true;
+}
+
+bool GraphicsClass::Render(const RenderSnapshotClass& _snapshot)
+{
+	PROFILE_SCOPE("GraphicsClass::Render");
+
+	//	The camera and the draws of the frame come from the snapshot, the draw batcher only ever changes on the thread which renders
+	m_viewMatrix = _snapshot.GetViewMatrix();
+	m_renderer->BeginFrame(_snapshot.GetInputTime());
+
+	Matrix4 cameraMatrix;
+	if (MathClass::Inverse(m_viewMatrix, cameraMatrix))
+	{
+		m_camera = { cameraMatrix.m[3][0], cameraMatrix.m[3][1], cameraMatrix.m[3][2] };
+		m_cameraForward = { cameraMatrix.m[2][0], cameraMatrix.m[2][1], cameraMatrix.m[2][2] };
+	}
+	m_sceneDrawCount.store(0);
+	m_sceneTriangleCount.store(0);
+
+	//	Visibility first, the recorded commands only cover what the camera sees
+	Frustum frustum = MathClass::FrustumFromMatrix(MathClass::Multiply(m_viewMatrix, m_projectionMatrix));
+	SubmitSnapshotDraws(_snapshot, frustum);
+	CullScene(frustum);
+
+	//	Levels of detail of the visible objects, from the distance to the camera
+	m_lod->Select(m_visibleObjects, m_visibleCount, m_camera, m_lodProjectionScale, SCREEN_NEAR);
+
+	//	Only the visible objects are drawn
+	SubmitSceneDraws();
+
+	//	The draws submitted for this frame are sorted and batched before the backend records them
+	m_drawBatcher->Prepare();
+
+	bool result = m_renderer->Render();
+	m_drawBatcher->Reset();
+	if (!result)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+/*
+	Find the objects of the scene inside the frustum with the culling stage or the bvh, whichever SetSceneCulling picked
+	Both are built from the same bounds in LoadScene, so they find the same objects, only in another order
+*/
+void GraphicsClass::CullScene(const Frustum& _frustum)
+{
+	PROFILE_SCOPE("GraphicsClass::CullScene");
+
+	if (m_sceneCulling == SCENE_CULLING_BVH)
+	{
+		m_visibleCount = std::min(m_bvh->QueryFrustum(_frustum, m_bvhVisibleObjects, m_sceneObjectCapacity), m_sceneObjectCapacity);
+		m_visibleObjects = m_bvhVisibleObjects;
+	}
+	else
+	{
+		m_visibleCount = m_culling->Cull(_frustum);
+		m_visibleObjects = m_culling->GetVisibleObjects();
+	}
+}
+
+/*
+	The draws of the simulation which are inside the frustum, each with the level of detail its distance allows
+	Only now they become packets, with the camera of this frame, draws of meshes which were never added are dropped
+*/
+void GraphicsClass::SubmitSnapshotDraws(const RenderSnapshotClass& _snapshot, const Frustum& _frustum)
+{
+	PROFILE_SCOPE("GraphicsClass::SubmitSnapshotDraws");
+
+	const SnapshotDraw* draws = _snapshot.GetDraws();
+	unsigned int drawCount = 0;
+	unsigned long long triangleCount = 0;
+
+	for (unsigned int i = 0; i < _snapshot.GetDrawCount(); i++)
+	{
+		const SnapshotDraw& draw = draws[i];
+		if (draw.mesh >= m_sceneMeshCount || !MathClass::Intersects(_frustum, draw.center, draw.radius))
+		{
+			continue;
+		}
+
+		const SceneMesh& sceneMesh = m_sceneMeshes[draw.mesh];
+		unsigned int level = LodClass::PickLevel(sceneMesh.errors, sceneMesh.levelCount, draw.center, draw.radius, m_camera, m_lodProjectionScale, SCREEN_NEAR);
+
+		Vector3 offset = { draw.center.x - m_camera.x, draw.center.y - m_camera.y, draw.center.z - m_camera.z };
+		float depth = MathClass::Dot(offset, m_cameraForward);
+
+		if (m_drawBatcher->Submit(draw.pass, draw.pipeline, draw.material, sceneMesh.drawMesh + level, depth, draw.instance))
+		{
+			drawCount++;
+			triangleCount += sceneMesh.triangleCounts[level];
+		}
+	}
+
+	m_sceneDrawCount.fetch_add(drawCount);
+	m_sceneTriangleCount.fetch_add(triangleCount);
+}
+
+/*
+	One draw per visible object which has a mesh, spread over the jobsystem
+*/
+void GraphicsClass::SubmitSceneDraws()
+{
+	PROFILE_SCOPE("GraphicsClass::SubmitSceneDraws");
+
+	unsigned int visibleCount = m_visibleCount;
+	if (visibleCount == 0 || m_sceneMeshCount == 0 || m_meshPipeline == INVALID_PIPELINE)
+	{
+		return;
+	}
+
+	bool queued = false;
+	if (m_jobSystem && visibleCount > SCENE_DRAWS_PER_JOB)
+	{
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(SubmitSceneJob, this, visibleCount, SCENE_DRAWS_PER_JOB, &counter);
+		if (queued)
+		{
+			m_jobSystem->WaitForCounter(&counter);
+		}
+	}
+
+	if (!queued)
+	{
+		SubmitSceneObjects(0, visibleCount);
+	}
+}
+
+/*
+	Submit the visible objects [_begin, _end) of CullScene, the instance of a draw is the index of its object
+	Every object draws the level of detail LodClass selected for it, the depth of the sort key is the distance along the view direction
+*/
+void GraphicsClass::SubmitSceneObjects(unsigned int _begin, unsigned int _end)
+{
+	const unsigned int* visibleObjects = m_visibleObjects;
+	const SceneBoundsSection* bounds = m_scene->GetBounds();
+	const float* centerX = bounds->centerX.Get();
+	const float* centerY = bounds->centerY.Get();
+	const float* centerZ = bounds->centerZ.Get();
+
+	unsigned int drawCount = 0;
+	unsigned long long triangleCount = 0;
+
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		unsigned int object = visibleObjects[i];
+		unsigned int mesh = m_objectMeshes[object];
+		if (mesh == INVALID_SCENE_MESH)
+		{
+			continue;
+		}
+
+		Vector3 offset = { centerX[object] - m_camera.x, centerY[object] - m_camera.y, centerZ[object] - m_camera.z };
+		float depth = MathClass::Dot(offset, m_cameraForward);
+
+		const SceneMesh& sceneMesh = m_sceneMeshes[mesh];
+		unsigned int level = std::min(m_lod->GetLevel(object), sceneMesh.levelCount - 1);
+		if (m_drawBatcher->Submit(DRAW_PASS_OPAQUE, m_meshPipeline, m_objectMaterials[object], sceneMesh.drawMesh + level, depth, object))
+		{
+			drawCount++;
+			triangleCount += sceneMesh.triangleCounts[level];
+		}
+	}
+
+	m_sceneDrawCount.fetch_add(drawCount);
+	m_sceneTriangleCount.fetch_add(triangleCount);
+}
+
+void GraphicsClass::SubmitSceneJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	static_cast<GraphicsClass*>(_data)->SubmitSceneObjects(_begin, _end);
+}
+
+/*
+	Handle of a pipeline of the backend for the draws of the render snapshots, request it while loading, not every frame
+	INVALID_PIPELINE if the backend does not record draws (software renderer) or its pipeline cache is full
+*/
+unsigned int GraphicsClass::RequestPipeline(const PipelineDesc& _desc)
+{
+	return m_renderer ? m_renderer->RequestPipeline(_desc) : INVALID_PIPELINE;
+}
+
+/*
+	Mesh handle for the draws of the render snapshots, INVALID_SCENE_MESH until AddMesh added the asset _id
+*/
+unsigned int GraphicsClass::GetMesh(unsigned long long _id) const
+{
+	for (unsigned int i = 0; i < m_sceneMeshCount; i++)
+	{
+		if (m_sceneMeshes[i].id == _id)
+		{
+			return i;
+		}
+	}
+
+	return INVALID_SCENE_MESH;
+}
+
+/*
+	Camera until the next frame is rendered, every render snapshot brings the camera of its frame
+*/
+void GraphicsClass::SetViewMatrix(const Matrix4& _viewMatrix)
+{
+	m_viewMatrix = _viewMatrix;
+}
+
+const Matrix4& GraphicsClass::GetViewMatrix() const
+{
+	return m_viewMatrix;
+}
+
+const Matrix4& GraphicsClass::GetProjectionMatrix() const
+{
+	return m_projectionMatrix;
+}
+
+/*
+	The objects the culling stage tests every frame with SCENE_CULLING_GRID, fill it with Build
+*/
+CullingClass* GraphicsClass::GetCulling()
+{
+	return m_culling;
+}
+
+/*
+	Hierarchy over the objects of the scene for ray, frustum and box queries, the primitives are the object indices
+	Render finds the visible objects with its frustum query with SCENE_CULLING_BVH
+	Moving objects are updated with UpdatePrimitive and Refit, between two frames
+*/
+BvhClass* GraphicsClass::GetBvh()
+{
+	return m_bvh;
+}
+
+/*
+	Level of detail of every scene object, selected every frame for the visible ones
+	Draws of an object use the level GetLevel returns for it
+*/
+LodClass* GraphicsClass::GetLod()
+{
+	return m_lod;
+}
+
+/*
+	The scene of LoadScene, used right inside of the mapped file
+*/
+SceneFileClass* GraphicsClass::GetScene()
+{
+	return m_scene;
+}
+
+/*
+	Add the meshes here while loading, the draws of a frame are submitted to its render snapshot
+*/
+DrawBatcherClass* GraphicsClass::GetDrawBatcher()
+{
+	return m_drawBatcher;
+}
+
+/*
+	How the backend presents and the input latency of its frames, nullptr if it does not present through a swap chain
+*/
+const PresentPolicyClass* GraphicsClass::GetPresentPolicy() const
+{
+	return m_renderer ? m_renderer->GetPresentPolicy() : nullptr;
+}
+
+/*
+	Pipeline the meshes of the scene are drawn with (Shaders/Mesh.hlsl)
+*/
+unsigned int GraphicsClass::GetMeshPipeline() const
+{
+	return m_meshPipeline;
+}
+
+/*
+	Objects a scene may have, Initialize was given this
+*/
+unsigned int GraphicsClass::GetMaxSceneObjects() const
+{
+	return m_maxSceneObjects;
+}
+
+/*
+	SCENE_CULLING_GRID or SCENE_CULLING_BVH, how Render finds the visible objects of the scene
+	Set it before the first frame, not while another thread renders
+*/
+void GraphicsClass::SetSceneCulling(unsigned int _sceneCulling)
+{
+	m_sceneCulling = _sceneCulling == SCENE_CULLING_GRID ? SCENE_CULLING_GRID : SCENE_CULLING_BVH;
+}
+
+unsigned int GraphicsClass::GetSceneCulling() const
+{
+	return m_sceneCulling;
+}
+
+/*
+	Objects of the scene which were inside the frustum of the last rendered frame
+*/
+const unsigned int* GraphicsClass::GetVisibleObjects() const
+{
+	return m_visibleObjects;
+}
+
+unsigned int GraphicsClass::GetVisibleCount() const
+{
+	return m_visibleCount;
+}
+
+/*
+	Draws and triangles of the visible objects of the scene and of the snapshot in the last rendered frame
+*/
+unsigned int GraphicsClass::GetSceneDrawCount() const
+{
+	return m_sceneDrawCount.load();
+}
+
+unsigned long long GraphicsClass::GetSceneTriangleCount() const
+{
+	return m_sceneTriangleCount.load();
+}
+
+const char* GraphicsClass::GetSceneCullingName(unsigned int _sceneCulling)
+{
+	switch (_sceneCulling)
+	{
+	case SCENE_CULLING_GRID:
+		return "grid";
+	case SCENE_CULLING_BVH:
+		return "bvh";
+	default:
+		return "unknown";
+	}
 }
\ No newline at end of file
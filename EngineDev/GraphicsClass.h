@@ -1,26 +1,124 @@
 #pragma once
 
 #pragma region includes
-#include <windows.h>
+#include <atomic>
+#include "RendererClass.h"
+#include "CullingClass.h"
+#include "BvhClass.h"
+#include "LodClass.h"
+#include "DrawBatcherClass.h"
+#include "RenderSnapshotClass.h"
+#include "SceneFileClass.h"
+#include "MathClass.h"
 #pragma endregion
 
 #pragma region global variables
 const bool FULL_SCREEN = false;
-const bool VSYNC_ENABLED = true;
+const unsigned int PRESENT_MODE = PRESENT_MODE_VSYNC;		// default of the present settings
+const unsigned int SWAP_CHAIN_BUFFERS = 3;					// default back buffers, MIN_SWAP_CHAIN_BUFFERS - MAX_SWAP_CHAIN_BUFFERS
+const unsigned int MAX_FRAME_LATENCY = 2;					// default presents which may wait to be shown, 1 has the lowest latency but the CPU and GPU stop overlapping
+const unsigned int FRAMES_IN_FLIGHT = 2;	// how many frames the CPU may record ahead of the GPU (1 - MAX_FRAMES_IN_FLIGHT)
 const float SCREEN_DEPTH = 1000.0f;
 const float SCREEN_NEAR = 0.1f;
+const float FIELD_OF_VIEW = MATH_PI / 4.0f;	// vertical, in radians
+const unsigned int MAX_SCENE_OBJECTS = 1048576;	// default of the objects a scene may have, SystemSettings::maxSceneObjects
+const unsigned int INITIAL_SCENE_OBJECTS = 1024;	// objects the scene stages are sized for until LoadScene grows them to the objects of the scene
+const unsigned int MAX_SCENE_MESHES = MAX_DRAW_MESHES / MESH_MAX_LODS;	// meshes the objects of a scene can use, one mesh of the draw batcher per level of detail
+const unsigned int INVALID_SCENE_MESH = 0xFFFFFFFF;
+const unsigned int SCENE_DRAWS_PER_JOB = 4096;		// visible objects turned into draws by one job
+const unsigned int MAX_DRAW_PACKETS = 131072;		// draws the render snapshot of a frame can submit, on top of one draw per scene object
+const unsigned int SCENE_CULLING_GRID = 0;			// the culling stage tests the cells of its grid, then the boxes in the cells which intersect the frustum
+const unsigned int SCENE_CULLING_BVH = 1;			// the frustum query of the bvh finds the visible objects
+const unsigned int SCENE_CULLING = SCENE_CULLING_BVH;	// default, SystemSettings::sceneCulling
 #pragma endregion 
 
+/*
+	A mesh the objects of the scene are drawn with, the scene references it by its asset id
+*/
+struct SceneMesh
+{
+	unsigned long long id;
+	unsigned int drawMesh;			// mesh of the draw batcher for level 0, level L is drawMesh + L
+	unsigned int levelCount;
+	unsigned int triangleCounts[MESH_MAX_LODS];
+	float errors[MESH_MAX_LODS];	// geometric errors of the levels at scale 1
+};
+
 class GraphicsClass
 {
 public:
 	GraphicsClass();
 	~GraphicsClass();
 
-	bool Initialize(int _screenHeight, int _screenWidth, HWND _windowHandle);
+	bool Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, bool _headless, bool _software, const PresentSettings& _presentSettings, unsigned int _maxSceneObjects, JobSystemClass* _jobSystem);
 	void Shutdown();
-	bool Frame();
+	bool WaitForFrameLatency();
+	bool Frame(const RenderSnapshotClass& _snapshot);
+	bool SaveScreenshot(const char* _path);
+	bool SaveCommandCapture(const char* _path);
+	bool LoadScene(const char* _path);
+	bool AddMesh(unsigned long long _id, const MeshAssetHeader& _mesh);
+	unsigned int RequestPipeline(const PipelineDesc& _desc);
+	unsigned int GetMesh(unsigned long long _id) const;
+
+	void SetViewMatrix(const Matrix4& _viewMatrix);
+	const Matrix4& GetViewMatrix() const;
+	const Matrix4& GetProjectionMatrix() const;
+	CullingClass* GetCulling();
+	BvhClass* GetBvh();
+	LodClass* GetLod();
+	SceneFileClass* GetScene();
+	DrawBatcherClass* GetDrawBatcher();
+	const PresentPolicyClass* GetPresentPolicy() const;
+	unsigned int GetMeshPipeline() const;
+	unsigned int GetMaxSceneObjects() const;
+	void SetSceneCulling(unsigned int _sceneCulling);
+	unsigned int GetSceneCulling() const;
+	const unsigned int* GetVisibleObjects() const;
+	unsigned int GetVisibleCount() const;
+	unsigned int GetSceneDrawCount() const;
+	unsigned long long GetSceneTriangleCount() const;
+
+	static const char* GetSceneCullingName(unsigned int _sceneCulling);
 
 private:
-	bool Render();
+	RendererClass* m_renderer;
+	JobSystemClass* m_jobSystem;
+	Matrix4 m_viewMatrix;
+	Matrix4 m_projectionMatrix;
+	CullingClass* m_culling;
+	BvhClass* m_bvh;
+	LodClass* m_lod;
+	float m_lodProjectionScale;
+	DrawBatcherClass* m_drawBatcher;
+	SceneFileClass* m_scene;
+	unsigned int m_meshPipeline;
+
+	//	Meshes and materials of the objects of the scene, INVALID_SCENE_MESH until AddMesh brought the mesh of the object
+	unsigned int m_maxSceneObjects;
+	unsigned int m_sceneObjectCapacity;		// objects the culling, bvh, level of detail selection, draw batcher and the arrays below are sized for
+	SceneMesh m_sceneMeshes[MAX_SCENE_MESHES];
+	unsigned int m_sceneMeshCount;
+	unsigned int* m_objectMeshes;
+	unsigned int* m_objectMaterials;
+
+	//	Objects which passed the culling of the frame, from the culling stage or the frustum query of the bvh (m_bvhVisibleObjects)
+	unsigned int m_sceneCulling;
+	unsigned int* m_bvhVisibleObjects;
+	const unsigned int* m_visibleObjects;
+	unsigned int m_visibleCount;
+
+	//	State of the draws of the visible objects and the snapshot, the scene draws are built on the jobsystem
+	Vector3 m_camera;
+	Vector3 m_cameraForward;
+	std::atomic<unsigned int> m_sceneDrawCount;
+	std::atomic<unsigned long long> m_sceneTriangleCount;
+
+	bool ReserveSceneObjects(unsigned int _count);
+	bool Render(const RenderSnapshotClass& _snapshot);
+	void CullScene(const Frustum& _frustum);
+	void SubmitSnapshotDraws(const RenderSnapshotClass& _snapshot, const Frustum& _frustum);
+	void SubmitSceneDraws();
+	void SubmitSceneObjects(unsigned int _begin, unsigned int _end);
+	static void SubmitSceneJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
 };
\ No newline at end of file
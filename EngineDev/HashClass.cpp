@@ -0,0 +1,57 @@
+#include "HashClass.h"
+#include <cstring>
+
+#pragma region Globals
+static const unsigned long long HASH_MULTIPLIER = 0xC6A4A7935BD1E995ULL;
+static const int HASH_SHIFT = 47;
+#pragma endregion
+
+/*
+	Mix every 8 byte block into the hash, then the remaining bytes
+	memcpy reads the blocks, the data does not have to be aligned
+	Finish with an avalanche so every input bit affects every output bit
+*/
+unsigned long long HashClass::Hash(const void* _data, size_t _size, unsigned long long _seed)
+{
+	const unsigned char* data = static_cast<const unsigned char*>(_data);
+	unsigned long long hash = _seed ^ (static_cast<unsigned long long>(_size) * HASH_MULTIPLIER);
+
+	size_t blockCount = _size / 8;
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		unsigned long long block;
+		memcpy(&block, data + i * 8, 8);
+
+		block *= HASH_MULTIPLIER;
+		block ^= block >> HASH_SHIFT;
+		block *= HASH_MULTIPLIER;
+
+		hash ^= block;
+		hash *= HASH_MULTIPLIER;
+	}
+
+	const unsigned char* tail = data + blockCount * 8;
+	size_t tailSize = _size & 7;
+	if (tailSize > 0)
+	{
+		for (size_t i = tailSize; i > 0; i--)
+		{
+			hash ^= static_cast<unsigned long long>(tail[i - 1]) << ((i - 1) * 8);
+		}
+		hash *= HASH_MULTIPLIER;
+	}
+
+	hash ^= hash >> HASH_SHIFT;
+	hash *= HASH_MULTIPLIER;
+	hash ^= hash >> HASH_SHIFT;
+
+	return hash;
+}
+
+/*
+	Fold another 64 bit value into a hash, the order of the values matters
+*/
+unsigned long long HashClass::Combine(unsigned long long _hash, unsigned long long _value)
+{
+	return Hash(&_value, sizeof(_value), _hash);
+}
\ No newline at end of file
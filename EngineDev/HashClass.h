@@ -0,0 +1,16 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+/*
+	64 bit non-cryptographic hashing (MurmurHash64A), used for cache keys and content hashes
+	Reads 8 bytes at a time, the results are the same on every little endian platform, so they may be stored on disk
+*/
+class HashClass
+{
+public:
+	static unsigned long long Hash(const void* _data, size_t _size, unsigned long long _seed = 0);
+	static unsigned long long Combine(unsigned long long _hash, unsigned long long _value);
+};
\ No newline at end of file
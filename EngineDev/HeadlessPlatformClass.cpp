@@ -0,0 +1,65 @@
+#include "HeadlessPlatformClass.h"
+
+/*
+	Constructor
+*/
+HeadlessPlatformClass::HeadlessPlatformClass()
+{
+	m_frameLimit = 0;
+	m_pumpedFrames = 0;
+}
+
+/*
+	Destructor
+*/
+HeadlessPlatformClass::~HeadlessPlatformClass()
+{
+
+}
+
+/*
+	Set the amount of frames after which PumpMessages reports a quit
+*/
+void HeadlessPlatformClass::SetFrameLimit(unsigned int _frameLimit)
+{
+	m_frameLimit = _frameLimit;
+}
+
+/*
+	There is no window, so just use the default windowed resolution for the offscreen targets
+*/
+bool HeadlessPlatformClass::Initialize(int& _screenHeight, int& _screenWidth, InputClass* _input)
+{
+	_screenHeight = 600;
+	_screenWidth = 800;
+
+	m_pumpedFrames = 0;
+
+	return true;
+}
+
+void HeadlessPlatformClass::Shutdown()
+{
+
+}
+
+/*
+	There are no messages to handle
+	Count the frames and quit as soon as we reached the frame limit
+*/
+bool HeadlessPlatformClass::PumpMessages()
+{
+	if (m_frameLimit != 0 && m_pumpedFrames >= m_frameLimit)
+	{
+		return false;
+	}
+
+	m_pumpedFrames++;
+
+	return true;
+}
+
+void* HeadlessPlatformClass::GetWindowHandle() const
+{
+	return nullptr;
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#pragma region includes
+#include "PlatformClass.h"
+#pragma endregion
+
+/*
+	Platform without a window and without an operating system message loop
+	Used to drive the engine on build machines and servers, e.g. to measure the frame time
+	Quits after the given amount of frames, 0 means run until the engine itself decides to quit
+*/
+class HeadlessPlatformClass : public PlatformClass
+{
+public:
+	HeadlessPlatformClass();
+	~HeadlessPlatformClass();
+
+	void SetFrameLimit(unsigned int _frameLimit);
+
+	bool Initialize(int& _screenHeight, int& _screenWidth, InputClass* _input) override;
+	void Shutdown() override;
+	bool PumpMessages() override;
+
+	void* GetWindowHandle() const override;
+
+private:
+	unsigned int m_frameLimit;
+	unsigned int m_pumpedFrames;
+};
\ No newline at end of file
@@ -1,11 +1,14 @@
 #include "InputClass.h"
+#include "ProfilerClass.h"
+#include "TimerClass.h"
 
 /*
 	Constructor
 */
 InputClass::InputClass()
 {
-
+	m_oldestEventTimestamp = 0;
+	m_droppedEvents.store(0);
 }
 
 /*
@@ -21,32 +24,140 @@ InputClass::~InputClass()
 */
 void InputClass::Initialize()
 {
-	for (int i = 0; i < 256; i++)
+	for (unsigned int i = 0; i < KEY_COUNT / 64; i++)
 	{
-		m_keys[i] = false;
+		m_keys[i] = 0;
+		m_pressedKeys[i] = 0;
+		m_releasedKeys[i] = 0;
 	}
+
+	m_oldestEventTimestamp = 0;
+	m_droppedEvents.store(0);
 }
 
 /*
-	Set the key at the given position to pressed
+	Queue that the key at the given position got pressed
 */
 void InputClass::KeyDown(unsigned int _input)
 {
-	m_keys[_input] = true;
+	PushEvent(_input, true);
 }
 
 /*
-	Set the key at the given position to released
+	Queue that the key at the given position got released
 */
 void InputClass::KeyUp(unsigned int _input)
 {
-	m_keys[_input] = false;
+	PushEvent(_input, false);
+}
+
+/*
+	Called once per frame by the game thread
+	Forget the pressed and released keys of the last frame
+	Apply every queued event in order to the keyboard state
+	A press only counts if the key was up before, so the key repeat of the operating system does not create new presses
+*/
+void InputClass::Update()
+{
+	PROFILE_SCOPE("InputClass::Update");
+
+	for (unsigned int i = 0; i < KEY_COUNT / 64; i++)
+	{
+		m_pressedKeys[i] = 0;
+		m_releasedKeys[i] = 0;
+	}
+
+	m_oldestEventTimestamp = 0;
+
+	InputEvent inputEvent;
+	while (m_events.Pop(inputEvent))
+	{
+		if (m_oldestEventTimestamp == 0)
+		{
+			m_oldestEventTimestamp = inputEvent.timestamp;
+		}
+
+		unsigned int word = inputEvent.key / 64;
+		unsigned long long bit = 1ull << (inputEvent.key % 64);
+
+		if (inputEvent.pressed)
+		{
+			if (!(m_keys[word] & bit))
+			{
+				m_pressedKeys[word] |= bit;
+			}
+			m_keys[word] |= bit;
+		}
+		else
+		{
+			if (m_keys[word] & bit)
+			{
+				m_releasedKeys[word] |= bit;
+			}
+			m_keys[word] &= ~bit;
+		}
+	}
 }
 
 /*
 	Get the current state of a Key
 */
-bool InputClass::IsKeyDown(unsigned int _input)
+bool InputClass::IsKeyDown(unsigned int _input) const
+{
+	return (m_keys[(_input % KEY_COUNT) / 64] & (1ull << (_input % 64))) != 0;
+}
+
+/*
+	Check if the key went down during the last frame, even if it is already released again
+*/
+bool InputClass::WasKeyPressed(unsigned int _input) const
 {
-	return m_keys[_input];
+	return (m_pressedKeys[(_input % KEY_COUNT) / 64] & (1ull << (_input % 64))) != 0;
+}
+
+/*
+	Check if the key went up during the last frame
+*/
+bool InputClass::WasKeyReleased(unsigned int _input) const
+{
+	return (m_releasedKeys[(_input % KEY_COUNT) / 64] & (1ull << (_input % 64))) != 0;
+}
+
+/*
+	Timestamp of the oldest event applied in the last Update, 0 if there was none
+	The difference to the current time is the input latency of the frame
+*/
+unsigned long long InputClass::GetOldestEventTimestamp() const
+{
+	return m_oldestEventTimestamp;
+}
+
+/*
+	Events which got lost because the queue was full
+*/
+unsigned long long InputClass::GetDroppedEventCount() const
+{
+	return m_droppedEvents.load();
+}
+
+/*
+	Stamp the event with the current time and queue it for the next Update
+	Keys outside of the table are ignored
+*/
+void InputClass::PushEvent(unsigned int _input, bool _pressed)
+{
+	if (_input >= KEY_COUNT)
+	{
+		return;
+	}
+
+	InputEvent inputEvent;
+	inputEvent.timestamp = TimerClass::GetMicroseconds();
+	inputEvent.key = _input;
+	inputEvent.pressed = _pressed;
+
+	if (!m_events.Push(inputEvent))
+	{
+		m_droppedEvents.fetch_add(1);
+	}
 }
\ No newline at end of file
@@ -1,5 +1,28 @@
 #pragma once
 
+#pragma region includes
+#include "SpscQueueClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int KEY_ESCAPE = 0x1B;	// same value as the virtual key code VK_ESCAPE of windows
+const unsigned int KEY_COUNT = 256;
+const unsigned int INPUT_EVENT_QUEUE_SIZE = 1024;	// events the platform may queue between two frames
+#pragma endregion
+
+struct InputEvent
+{
+	unsigned long long timestamp;	// microseconds of the monotonic clock of TimerClass
+	unsigned int key;
+	bool pressed;
+};
+
+/*
+	The platform (producer) pushes timestamped key events into a lock-free queue, from whatever thread pumps the messages
+	Once per frame the game thread (consumer) drains the queue in Update into a snapshot of the keyboard
+	Besides the current state the snapshot keeps which keys got pressed or released during the last frame,
+	so a press shorter than a frame is not lost
+*/
 class InputClass
 {
 public:
@@ -10,8 +33,25 @@ public:
 
 	void KeyDown(unsigned int _input);
 	void KeyUp(unsigned int _input);
-	bool IsKeyDown(unsigned int _input);
+
+	void Update();
+
+	bool IsKeyDown(unsigned int _input) const;
+	bool WasKeyPressed(unsigned int _input) const;
+	bool WasKeyReleased(unsigned int _input) const;
+
+	unsigned long long GetOldestEventTimestamp() const;
+	unsigned long long GetDroppedEventCount() const;
 
 private:
-	bool m_keys[256];
+	SpscQueueClass<InputEvent, INPUT_EVENT_QUEUE_SIZE> m_events;
+
+	unsigned long long m_keys[KEY_COUNT / 64];
+	unsigned long long m_pressedKeys[KEY_COUNT / 64];
+	unsigned long long m_releasedKeys[KEY_COUNT / 64];
+
+	unsigned long long m_oldestEventTimestamp;
+	std::atomic<unsigned long long> m_droppedEvents;
+
+	void PushEvent(unsigned int _input, bool _pressed);
 };
\ No newline at end of file
@@ -0,0 +1,501 @@
+#include "JobSystemClass.h"
+
+#pragma region Globals
+static thread_local unsigned int CurrentThreadIndex = INVALID_JOB_THREAD;
+static thread_local bool RunningBackgroundJob = false;
+#pragma endregion
+
+/*
+	Constructor
+*/
+JobSystemClass::JobSystemClass()
+{
+	m_threadCount = 0;
+	m_workerCount = 0;
+	m_attachedThreads.store(0);
+	m_queues = nullptr;
+	m_jobPools = nullptr;
+	m_jobsInUse = nullptr;
+	m_quit.store(false);
+	m_pendingJobs.store(0);
+	m_sleepingWorkers.store(0);
+	m_firstBackgroundJob = 0;
+	m_backgroundJobCount = 0;
+
+	for (unsigned int i = 0; i < MAX_JOB_THREADS; i++)
+	{
+		m_jobPoolIndices[i] = 0;
+	}
+}
+
+/*
+	Destructor
+*/
+JobSystemClass::~JobSystemClass()
+{
+
+}
+
+/*
+	Create the queues and job pools for the calling thread (index 0), every worker and the threads which may attach later on
+	0 workers means one worker per hardware thread besides the calling thread and the attachable threads
+	The calling thread becomes the main thread of the jobsystem, it has to call Shutdown as well
+*/
+bool JobSystemClass::Initialize(unsigned int _workerCount, unsigned int _attachableThreads)
+{
+	if (_attachableThreads > MAX_JOB_THREADS / 2)
+	{
+		return false;
+	}
+
+	if (_workerCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		_workerCount = hardwareThreads > _attachableThreads + 1 ? hardwareThreads - _attachableThreads - 1 : 1;
+	}
+
+	if (_workerCount + _attachableThreads + 1 > MAX_JOB_THREADS)
+	{
+		_workerCount = MAX_JOB_THREADS - _attachableThreads - 1;
+	}
+
+	m_workerCount = _workerCount;
+	m_threadCount = _workerCount + _attachableThreads + 1;
+	m_attachedThreads.store(0);
+
+	m_queues = new WorkStealingQueueClass[m_threadCount];
+	if (!m_queues)
+	{
+		return false;
+	}
+
+	m_jobPools = new Job[m_threadCount * JOB_POOL_SIZE];
+	if (!m_jobPools)
+	{
+		return false;
+	}
+
+	m_jobsInUse = new std::atomic<bool>[m_threadCount * JOB_POOL_SIZE];
+	if (!m_jobsInUse)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < m_threadCount * JOB_POOL_SIZE; i++)
+	{
+		m_jobsInUse[i].store(false);
+	}
+
+	m_quit.store(false);
+	m_pendingJobs.store(0);
+	m_sleepingWorkers.store(0);
+
+	CurrentThreadIndex = 0;
+
+	for (unsigned int i = 1; i <= m_workerCount; i++)
+	{
+		m_workers[i] = std::thread(&JobSystemClass::WorkerThread, this, i);
+	}
+
+	return true;
+}
+
+/*
+	Let the workers finish, wake up the sleeping ones and join them
+	Release the queues and the job pools
+*/
+void JobSystemClass::Shutdown()
+{
+	m_quit.store(true);
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_wakeCondition.notify_all();
+	}
+
+	for (unsigned int i = 1; i <= m_workerCount; i++)
+	{
+		if (m_workers[i].joinable())
+		{
+			m_workers[i].join();
+		}
+	}
+
+	if (m_jobsInUse)
+	{
+		delete[] m_jobsInUse;
+		m_jobsInUse = nullptr;
+	}
+
+	if (m_jobPools)
+	{
+		delete[] m_jobPools;
+		m_jobPools = nullptr;
+	}
+
+	if (m_queues)
+	{
+		delete[] m_queues;
+		m_queues = nullptr;
+	}
+
+	m_threadCount = 0;
+	m_workerCount = 0;
+	CurrentThreadIndex = INVALID_JOB_THREAD;
+}
+
+/*
+	Queue a single job on the queue of the calling thread
+	The counter is incremented before the job becomes visible, so waiting on it right after this call is safe
+	If every job of the thread is still pending, AllocateJob works on jobs until one is done, so Run never fails for a full pool
+	Fails only for threads the jobsystem does not know, nothing is queued then
+*/
+bool JobSystemClass::Run(JobFunction _function, void* _data, unsigned int _begin, unsigned int _end, JobCounter* _counter, JobCounter* _dependency)
+{
+	unsigned int threadIndex = CurrentThreadIndex;
+	if (threadIndex == INVALID_JOB_THREAD || threadIndex >= m_threadCount)
+	{
+		return false;
+	}
+
+	Job* job = AllocateJob(threadIndex);
+	job->function = _function;
+	job->data = _data;
+	job->begin = _begin;
+	job->end = _end;
+	job->counter = _counter;
+	job->dependency = _dependency;
+
+	if (_counter)
+	{
+		_counter->fetch_add(1);
+	}
+
+	//	Count the job before it becomes visible, a thief takes it off the count as soon as it stole it
+	m_pendingJobs.fetch_add(1);
+
+	//	The queue only holds jobs of our own pool, with a free slot there is always room in it
+	if (!m_queues[threadIndex].Push(job))
+	{
+		m_pendingJobs.fetch_sub(1);
+		Execute(job, false);
+		return true;
+	}
+
+	WakeWorker();
+
+	return true;
+}
+
+/*
+	Split [0, _count) into batches of _batchSize and queue a job for each batch
+	Does not block, wait on the counter for the result
+	Queues either every batch or, for threads the jobsystem does not know, none, so callers can run everything themselves when it fails
+*/
+bool JobSystemClass::ParallelFor(JobFunction _function, void* _data, unsigned int _count, unsigned int _batchSize, JobCounter* _counter, JobCounter* _dependency)
+{
+	if (_batchSize == 0)
+	{
+		_batchSize = 1;
+	}
+
+	for (unsigned int begin = 0; begin < _count; begin += _batchSize)
+	{
+		unsigned int end = _count - begin > _batchSize ? begin + _batchSize : _count;
+
+		if (!Run(_function, _data, begin, end, _counter, _dependency))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+	Queue a job which runs on a worker once the workers have nothing else to do
+	May be called from any thread, the job is copied into a ring guarded by a mutex
+	Fails if the ring is full or there are no workers, the caller decides whether to run the job itself
+*/
+bool JobSystemClass::RunBackground(JobFunction _function, void* _data, unsigned int _begin, unsigned int _end, JobCounter* _counter)
+{
+	if (m_workerCount == 0)
+	{
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_backgroundMutex);
+
+		if (m_backgroundJobCount == BACKGROUND_JOB_QUEUE_SIZE)
+		{
+			return false;
+		}
+
+		Job& job = m_backgroundJobs[(m_firstBackgroundJob + m_backgroundJobCount) % BACKGROUND_JOB_QUEUE_SIZE];
+		job.function = _function;
+		job.data = _data;
+		job.begin = _begin;
+		job.end = _end;
+		job.counter = _counter;
+		job.dependency = nullptr;
+
+		if (_counter)
+		{
+			_counter->fetch_add(1);
+		}
+
+		//	Counted while the lock is held, a worker can only take the job off the count after that
+		m_pendingJobs.fetch_add(1);
+		m_backgroundJobCount++;
+	}
+
+	WakeWorker();
+
+	return true;
+}
+
+/*
+	Wait with help: instead of blocking the thread, work on pending jobs until the counter reaches 0
+	Only yield if there is nothing left to steal, the remaining jobs are running on other threads
+*/
+void JobSystemClass::WaitForCounter(JobCounter* _counter)
+{
+	unsigned int threadIndex = CurrentThreadIndex;
+
+	while (_counter->load() != 0)
+	{
+		if (threadIndex == INVALID_JOB_THREAD || !ExecuteNextJob(threadIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*
+	Give the calling thread one of the queues reserved in Initialize, from then on it can queue jobs and help while it waits
+	Every reserved queue can be attached once, fails if all of them are taken
+*/
+bool JobSystemClass::AttachThread()
+{
+	unsigned int attachedThread = m_attachedThreads.fetch_add(1);
+	if (m_workerCount + 1 + attachedThread >= m_threadCount)
+	{
+		return false;
+	}
+
+	CurrentThreadIndex = m_workerCount + 1 + attachedThread;
+
+	return true;
+}
+
+/*
+	Call it before the attached thread ends, its queue has to be empty by then
+*/
+void JobSystemClass::DetachThread()
+{
+	CurrentThreadIndex = INVALID_JOB_THREAD;
+}
+
+/*
+	Amount of threads working on jobs, main thread and attachable threads included
+*/
+unsigned int JobSystemClass::GetThreadCount() const
+{
+	return m_threadCount;
+}
+
+/*
+	Index of the calling thread inside the jobsystem, INVALID_JOB_THREAD for threads the jobsystem does not know
+*/
+unsigned int JobSystemClass::GetThreadIndex()
+{
+	return CurrentThreadIndex;
+}
+
+/*
+	True while the calling thread runs a background job, e.g. to tell loading work apart from frame work
+*/
+bool JobSystemClass::IsRunningBackgroundJob()
+{
+	return RunningBackgroundJob;
+}
+
+/*
+	Loop of every worker thread
+	Work on jobs as long as there are some, spin a little before going to sleep so short gaps between jobs do not cost a wake up
+	Sleep until new jobs got queued or the jobsystem shuts down
+*/
+void JobSystemClass::WorkerThread(unsigned int _threadIndex)
+{
+	CurrentThreadIndex = _threadIndex;
+
+	unsigned int idleSpins = 0;
+
+	while (!m_quit.load())
+	{
+		if (ExecuteNextJob(_threadIndex))
+		{
+			idleSpins = 0;
+			continue;
+		}
+
+		if (idleSpins < 64)
+		{
+			idleSpins++;
+			std::this_thread::yield();
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_sleepingWorkers.fetch_add(1);
+		while (m_pendingJobs.load() == 0 && !m_quit.load())
+		{
+			m_wakeCondition.wait(lock);
+		}
+		m_sleepingWorkers.fetch_sub(1);
+
+		idleSpins = 0;
+	}
+}
+
+/*
+	Take a job from our own queue first, otherwise try to steal one from every other thread
+	Start stealing at the next thread so not every thief hammers the same queue
+*/
+bool JobSystemClass::ExecuteNextJob(unsigned int _threadIndex)
+{
+	Job* job = m_queues[_threadIndex].Pop();
+
+	for (unsigned int i = 1; !job && i < m_threadCount; i++)
+	{
+		job = m_queues[(_threadIndex + i) % m_threadCount].Steal();
+	}
+
+	if (!job)
+	{
+		//	The main thread and the attached threads leave the background jobs to the workers
+		if (_threadIndex == 0 || _threadIndex > m_workerCount)
+		{
+			return false;
+		}
+
+		return ExecuteBackgroundJob();
+	}
+
+	m_pendingJobs.fetch_sub(1);
+	Execute(job, false);
+
+	return true;
+}
+
+/*
+	Take the oldest background job out of the ring and run it
+*/
+bool JobSystemClass::ExecuteBackgroundJob()
+{
+	Job job;
+
+	{
+		std::lock_guard<std::mutex> lock(m_backgroundMutex);
+
+		if (m_backgroundJobCount == 0)
+		{
+			return false;
+		}
+
+		job = m_backgroundJobs[m_firstBackgroundJob];
+		m_firstBackgroundJob = (m_firstBackgroundJob + 1) % BACKGROUND_JOB_QUEUE_SIZE;
+		m_backgroundJobCount--;
+	}
+
+	m_pendingJobs.fetch_sub(1);
+	Execute(&job, true);
+
+	return true;
+}
+
+/*
+	If the job depends on other jobs, help working on them until they are done
+	Run the job and signal its counter
+	_background marks the thread only while the function of a background job runs, frame jobs it helps with while it waits run unmarked
+*/
+void JobSystemClass::Execute(Job* _job, bool _background)
+{
+	if (_job->dependency)
+	{
+		WaitForCounter(_job->dependency);
+	}
+
+	bool runningBackgroundJob = RunningBackgroundJob;
+	RunningBackgroundJob = _background;
+	_job->function(_job->data, _job->begin, _job->end, CurrentThreadIndex);
+	RunningBackgroundJob = runningBackgroundJob;
+
+	//	The slot is free as soon as it is released, read the counter before
+	JobCounter* counter = _job->counter;
+	ReleaseJob(_job);
+
+	if (counter)
+	{
+		counter->fetch_sub(1);
+	}
+}
+
+/*
+	Hand out the next free job of the ring of the given thread, a slot stays taken until its job ran
+	Jobs finish out of order (stealing), so taken slots are skipped, if all of them are taken work on pending jobs until one is released
+*/
+Job* JobSystemClass::AllocateJob(unsigned int _threadIndex)
+{
+	std::atomic<bool>* inUse = &m_jobsInUse[_threadIndex * JOB_POOL_SIZE];
+	unsigned int index = m_jobPoolIndices[_threadIndex];
+
+	for (;;)
+	{
+		for (unsigned int i = 0; i < JOB_POOL_SIZE; i++)
+		{
+			unsigned int slot = (index + i) % JOB_POOL_SIZE;
+			if (!inUse[slot].load(std::memory_order_acquire))
+			{
+				inUse[slot].store(true, std::memory_order_relaxed);
+				m_jobPoolIndices[_threadIndex] = (slot + 1) % JOB_POOL_SIZE;
+
+				return &m_jobPools[_threadIndex * JOB_POOL_SIZE + slot];
+			}
+		}
+
+		if (!ExecuteNextJob(_threadIndex))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/*
+	Give the slot of a pooled job back to the thread which allocated it, background jobs are copies and have no slot
+*/
+void JobSystemClass::ReleaseJob(Job* _job)
+{
+	if (_job < m_jobPools || _job >= m_jobPools + m_threadCount * JOB_POOL_SIZE)
+	{
+		return;
+	}
+
+	m_jobsInUse[_job - m_jobPools].store(false, std::memory_order_release);
+}
+
+/*
+	Wake up one sleeping worker for a new job
+	Only take the lock if a worker is actually sleeping
+*/
+void JobSystemClass::WakeWorker()
+{
+	if (m_sleepingWorkers.load() == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(m_sleepMutex);
+	m_wakeCondition.notify_one();
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "WorkStealingQueueClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_JOB_THREADS = 64;
+const unsigned int JOB_POOL_SIZE = WORK_STEALING_QUEUE_SIZE;	// jobs one thread may have pending at the same time, Run helps until a slot is free once they are all taken
+const unsigned int INVALID_JOB_THREAD = 0xFFFFFFFF;
+const unsigned int BACKGROUND_JOB_QUEUE_SIZE = 1024;		// background jobs which may be pending at the same time
+#pragma endregion
+
+/*
+	A job works on the range [_begin, _end) of whatever _data points to
+	_threadIndex is unique per thread of the jobsystem, use it to pick per-thread resources (0 is the main thread)
+*/
+typedef void (*JobFunction)(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+
+/*
+	Counts the jobs which are not finished yet, 0 means everything attached to it is done
+*/
+typedef std::atomic<unsigned int> JobCounter;
+
+struct Job
+{
+	JobFunction function;
+	void* data;
+	unsigned int begin;
+	unsigned int end;
+	JobCounter* counter;		// decremented after the job ran
+	JobCounter* dependency;		// the job only runs after this counter reached 0
+};
+
+/*
+	Engine wide work-stealing job scheduler
+	Every thread (main thread included) owns a lock-free queue, idle workers steal jobs from the others
+	Jobs and their data are never allocated on the heap, every thread keeps a ring of jobs it hands out
+	The main thread does not block while waiting for a counter, it works on pending jobs instead (WaitForCounter)
+	Threads the engine starts itself (e.g. the render thread) can attach to one of the queues reserved for them in Initialize, they queue and help like the main thread
+	Background jobs (e.g. shader compilation) only run on workers when they have nothing else to do, never on the main thread, so they cannot stall a frame
+*/
+class JobSystemClass
+{
+public:
+	JobSystemClass();
+	~JobSystemClass();
+
+	bool Initialize(unsigned int _workerCount, unsigned int _attachableThreads = 0);
+	void Shutdown();
+
+	bool Run(JobFunction _function, void* _data, unsigned int _begin, unsigned int _end, JobCounter* _counter, JobCounter* _dependency = nullptr);
+	bool ParallelFor(JobFunction _function, void* _data, unsigned int _count, unsigned int _batchSize, JobCounter* _counter, JobCounter* _dependency = nullptr);
+	bool RunBackground(JobFunction _function, void* _data, unsigned int _begin, unsigned int _end, JobCounter* _counter);
+	void WaitForCounter(JobCounter* _counter);
+
+	bool AttachThread();
+	void DetachThread();
+
+	unsigned int GetThreadCount() const;
+	static unsigned int GetThreadIndex();
+	static bool IsRunningBackgroundJob();
+
+private:
+	unsigned int m_threadCount;
+	unsigned int m_workerCount;
+	std::atomic<unsigned int> m_attachedThreads;
+	std::thread m_workers[MAX_JOB_THREADS];
+	WorkStealingQueueClass* m_queues;
+
+	Job* m_jobPools;
+	std::atomic<bool>* m_jobsInUse;		// set from AllocateJob until the job ran, per slot of the job pools
+	unsigned int m_jobPoolIndices[MAX_JOB_THREADS];
+
+	std::atomic<bool> m_quit;
+	std::atomic<unsigned int> m_pendingJobs;
+	std::atomic<unsigned int> m_sleepingWorkers;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_wakeCondition;
+
+	Job m_backgroundJobs[BACKGROUND_JOB_QUEUE_SIZE];
+	unsigned int m_firstBackgroundJob;
+	unsigned int m_backgroundJobCount;
+	std::mutex m_backgroundMutex;
+
+	void WorkerThread(unsigned int _threadIndex);
+	bool ExecuteNextJob(unsigned int _threadIndex);
+	bool ExecuteBackgroundJob();
+	void Execute(Job* _job, bool _background);
+	Job* AllocateJob(unsigned int _threadIndex);
+	void ReleaseJob(Job* _job);
+	void WakeWorker();
+};
\ No newline at end of file
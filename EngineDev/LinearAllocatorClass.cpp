@@ -0,0 +1,109 @@
+#include "LinearAllocatorClass.h"
+#include <cstdlib>
+
+/*
+	Constructor
+*/
+LinearAllocatorClass::LinearAllocatorClass()
+{
+	m_memory = nullptr;
+	m_capacity = 0;
+	m_offset.store(0);
+	m_peak = 0;
+}
+
+/*
+	Destructor
+*/
+LinearAllocatorClass::~LinearAllocatorClass()
+{
+
+}
+
+/*
+	Allocate the whole block up front, this is the only time the allocator touches the heap
+*/
+bool LinearAllocatorClass::Initialize(size_t _capacity)
+{
+	m_memory = static_cast<unsigned char*>(malloc(_capacity));
+	if (!m_memory)
+	{
+		return false;
+	}
+
+	m_capacity = _capacity;
+	m_offset.store(0);
+	m_peak = 0;
+
+	return true;
+}
+
+void LinearAllocatorClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_capacity = 0;
+	m_offset.store(0);
+}
+
+/*
+	Align the current offset and move it behind the allocation
+	If another thread moved the offset in the meantime, try again with the new offset
+	Return nullptr if the block is used up, the caller has to handle it like a failed new
+	_alignment has to be a power of two
+*/
+void* LinearAllocatorClass::Allocate(size_t _size, size_t _alignment)
+{
+	size_t base = reinterpret_cast<size_t>(m_memory);
+	size_t offset = m_offset.load(std::memory_order_relaxed);
+	size_t alignedOffset;
+
+	do
+	{
+		alignedOffset = ((base + offset + _alignment - 1) & ~(_alignment - 1)) - base;
+		if (alignedOffset + _size > m_capacity)
+		{
+			return nullptr;
+		}
+	} while (!m_offset.compare_exchange_weak(offset, alignedOffset + _size, std::memory_order_relaxed));
+
+	return m_memory + alignedOffset;
+}
+
+/*
+	Forget all allocations, remember how much was used at most so the capacity can be tuned
+*/
+void LinearAllocatorClass::Reset()
+{
+	size_t used = m_offset.load(std::memory_order_relaxed);
+	if (used > m_peak)
+	{
+		m_peak = used;
+	}
+
+	m_offset.store(0, std::memory_order_relaxed);
+}
+
+size_t LinearAllocatorClass::GetCapacity() const
+{
+	return m_capacity;
+}
+
+size_t LinearAllocatorClass::GetUsed() const
+{
+	return m_offset.load(std::memory_order_relaxed);
+}
+
+/*
+	Highest usage between two resets
+*/
+size_t LinearAllocatorClass::GetPeak() const
+{
+	size_t used = m_offset.load(std::memory_order_relaxed);
+
+	return used > m_peak ? used : m_peak;
+}
\ No newline at end of file
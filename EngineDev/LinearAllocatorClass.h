@@ -0,0 +1,40 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include <cstddef>
+#pragma endregion
+
+/*
+	Bump allocator over one block of memory which is allocated once in Initialize
+	Allocating only moves an offset (lock-free, so jobs may allocate at the same time), single allocations are never freed
+	Reset releases everything at once
+*/
+class LinearAllocatorClass
+{
+public:
+	LinearAllocatorClass();
+	~LinearAllocatorClass();
+
+	bool Initialize(size_t _capacity);
+	void Shutdown();
+
+	void* Allocate(size_t _size, size_t _alignment = 16);
+	void Reset();
+
+	template<typename T>
+	T* AllocateArray(size_t _count)
+	{
+		return static_cast<T*>(Allocate(sizeof(T) * _count, alignof(T) > 16 ? alignof(T) : 16));
+	}
+
+	size_t GetCapacity() const;
+	size_t GetUsed() const;
+	size_t GetPeak() const;
+
+private:
+	unsigned char* m_memory;
+	size_t m_capacity;
+	std::atomic<size_t> m_offset;
+	size_t m_peak;
+};
\ No newline at end of file
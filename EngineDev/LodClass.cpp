@@ -0,0 +1,302 @@
+#include "LodClass.h"
+#include "ProfilerClass.h"
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#pragma region Globals
+static const size_t LOD_ARRAY_ALIGNMENT = 64;
+#pragma endregion
+
+/*
+	Constructor
+*/
+LodClass::LodClass()
+{
+	m_jobSystem = nullptr;
+	m_memory = nullptr;
+	m_maxObjects = 0;
+	m_centerX = nullptr;
+	m_centerY = nullptr;
+	m_centerZ = nullptr;
+	m_radius = nullptr;
+	m_errors = nullptr;
+	m_levelCounts = nullptr;
+	m_levels = nullptr;
+	m_selectObjects = nullptr;
+	m_camera = { 0.0f, 0.0f, 0.0f };
+	m_errorPerDistance = 0.0f;
+	m_nearDistance = 0.0f;
+	m_changedCount.store(0);
+}
+
+/*
+	Destructor
+*/
+LodClass::~LodClass()
+{
+
+}
+
+/*
+	Allocate every array once in one block, each array starts on a cache line
+	Every object starts as a point at the origin with only the full level
+*/
+bool LodClass::Initialize(unsigned int _maxObjects, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	if (_maxObjects == 0)
+	{
+		return false;
+	}
+
+	m_maxObjects = _maxObjects;
+
+	size_t sizes[] = {
+		m_maxObjects * sizeof(float), m_maxObjects * sizeof(float), m_maxObjects * sizeof(float), m_maxObjects * sizeof(float),
+		static_cast<size_t>(m_maxObjects) * MESH_MAX_LODS * sizeof(float), m_maxObjects * sizeof(unsigned char), m_maxObjects * sizeof(unsigned char) };
+	const unsigned int arrayCount = sizeof(sizes) / sizeof(sizes[0]);
+
+	size_t totalSize = 0;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		totalSize += (sizes[i] + LOD_ARRAY_ALIGNMENT - 1) & ~(LOD_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_memory = static_cast<unsigned char*>(malloc(totalSize + LOD_ARRAY_ALIGNMENT));
+	if (!m_memory)
+	{
+		return false;
+	}
+	memset(m_memory, 0, totalSize + LOD_ARRAY_ALIGNMENT);
+
+	void* arrays[arrayCount];
+	size_t offset = (LOD_ARRAY_ALIGNMENT - reinterpret_cast<size_t>(m_memory) % LOD_ARRAY_ALIGNMENT) % LOD_ARRAY_ALIGNMENT;
+	for (unsigned int i = 0; i < arrayCount; i++)
+	{
+		arrays[i] = m_memory + offset;
+		offset += (sizes[i] + LOD_ARRAY_ALIGNMENT - 1) & ~(LOD_ARRAY_ALIGNMENT - 1);
+	}
+
+	m_centerX = static_cast<float*>(arrays[0]);
+	m_centerY = static_cast<float*>(arrays[1]);
+	m_centerZ = static_cast<float*>(arrays[2]);
+	m_radius = static_cast<float*>(arrays[3]);
+	m_errors = static_cast<float*>(arrays[4]);
+	m_levelCounts = static_cast<unsigned char*>(arrays[5]);
+	m_levels = static_cast<unsigned char*>(arrays[6]);
+
+	memset(m_levelCounts, 1, m_maxObjects);
+
+	return true;
+}
+
+void LodClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_maxObjects = 0;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Bounding sphere of an object in world space, call it again whenever the object moves
+*/
+void LodClass::SetObject(unsigned int _object, const Vector3& _center, float _radius)
+{
+	if (_object >= m_maxObjects)
+	{
+		return;
+	}
+
+	m_centerX[_object] = _center.x;
+	m_centerY[_object] = _center.y;
+	m_centerZ[_object] = _center.z;
+	m_radius[_object] = _radius;
+}
+
+/*
+	Errors of the levels of an object in world units, level 0 is the full mesh
+	A level may not be more exact than the one before it, the errors are made growing if they are not
+*/
+void LodClass::SetLevels(unsigned int _object, const float* _errors, unsigned int _levelCount)
+{
+	if (_object >= m_maxObjects || _levelCount == 0)
+	{
+		return;
+	}
+
+	_levelCount = _levelCount < MESH_MAX_LODS ? _levelCount : MESH_MAX_LODS;
+
+	float* errors = &m_errors[static_cast<size_t>(_object) * MESH_MAX_LODS];
+	for (unsigned int i = 0; i < _levelCount; i++)
+	{
+		errors[i] = i > 0 && _errors[i] < errors[i - 1] ? errors[i - 1] : _errors[i];
+	}
+
+	m_levelCounts[_object] = static_cast<unsigned char>(_levelCount);
+	m_levels[_object] = m_levels[_object] < _levelCount ? m_levels[_object] : static_cast<unsigned char>(_levelCount - 1);
+}
+
+/*
+	The levels of a cooked mesh, _scale is the largest scale of the object, the errors of the mesh are in its own units
+*/
+void LodClass::SetMesh(unsigned int _object, const MeshAssetHeader& _mesh, float _scale)
+{
+	float errors[MESH_MAX_LODS];
+	unsigned int levelCount = _mesh.lodCount < MESH_MAX_LODS ? _mesh.lodCount : MESH_MAX_LODS;
+
+	for (unsigned int i = 0; i < levelCount; i++)
+	{
+		errors[i] = _mesh.lods[i].error * _scale;
+	}
+
+	SetLevels(_object, errors, levelCount);
+}
+
+/*
+	Pick the levels of the listed objects for a camera at _camera
+	_projectionScale: GetProjectionScale of the camera, _nearDistance: closer spheres count as this far away (the near plane)
+	Returns how many objects changed their level
+*/
+unsigned int LodClass::Select(const unsigned int* _objects, unsigned int _count, const Vector3& _camera, float _projectionScale, float _nearDistance)
+{
+	PROFILE_SCOPE("LodClass::Select");
+
+	m_selectObjects = _objects;
+	m_camera = _camera;
+	m_errorPerDistance = _projectionScale > 0.0f ? LOD_PIXEL_ERROR / _projectionScale : 0.0f;
+	m_nearDistance = _nearDistance;
+	m_changedCount.store(0);
+
+	bool queued = false;
+	if (m_jobSystem && _count > LOD_OBJECTS_PER_JOB)
+	{
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(SelectJob, this, _count, LOD_OBJECTS_PER_JOB, &counter);
+		if (queued)
+		{
+			m_jobSystem->WaitForCounter(&counter);
+		}
+	}
+
+	if (!queued)
+	{
+		SelectObjects(0, _count);
+	}
+
+	return m_changedCount.load();
+}
+
+/*
+	Since the errors grow with the level, the finer levels are walked down until one fits and the coarser ones up while they fit
+*/
+void LodClass::SelectObjects(unsigned int _begin, unsigned int _end)
+{
+	unsigned int changedCount = 0;
+
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		unsigned int object = m_selectObjects[i];
+		if (object >= m_maxObjects)
+		{
+			continue;
+		}
+
+		float x = m_centerX[object] - m_camera.x;
+		float y = m_centerY[object] - m_camera.y;
+		float z = m_centerZ[object] - m_camera.z;
+		float distance = sqrtf(x * x + y * y + z * z) - m_radius[object];
+		distance = distance > m_nearDistance ? distance : m_nearDistance;
+
+		float allowed = distance * m_errorPerDistance;
+		const float* errors = &m_errors[static_cast<size_t>(object) * MESH_MAX_LODS];
+		unsigned int levelCount = m_levelCounts[object];
+		unsigned int level = m_levels[object];
+
+		if (errors[level] > allowed * (1.0f + LOD_HYSTERESIS))
+		{
+			while (level > 0 && errors[level] > allowed)
+			{
+				level--;
+			}
+		}
+		else
+		{
+			float coarserAllowed = allowed * (1.0f - LOD_HYSTERESIS);
+			while (level + 1 < levelCount && errors[level + 1] <= coarserAllowed)
+			{
+				level++;
+			}
+		}
+
+		if (level != m_levels[object])
+		{
+			m_levels[object] = static_cast<unsigned char>(level);
+			changedCount++;
+		}
+	}
+
+	m_changedCount.fetch_add(changedCount);
+}
+
+void LodClass::SelectJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	static_cast<LodClass*>(_data)->SelectObjects(_begin, _end);
+}
+
+/*
+	Level of detail to draw the object with, 0 is the full mesh
+*/
+unsigned int LodClass::GetLevel(unsigned int _object) const
+{
+	return _object < m_maxObjects ? m_levels[_object] : 0;
+}
+
+const unsigned char* LodClass::GetLevels() const
+{
+	return m_levels;
+}
+
+unsigned int LodClass::GetMaxObjects() const
+{
+	return m_maxObjects;
+}
+
+/*
+	Pixels one unit covers at a distance of one unit in front of the camera, from the vertical scale of the projection and the height of the screen
+*/
+float LodClass::GetProjectionScale(const Matrix4& _projectionMatrix, unsigned int _screenHeight)
+{
+	return _projectionMatrix.m[1][1] * static_cast<float>(_screenHeight) * 0.5f;
+}
+
+/*
+	Level of a sphere without a history (no hysteresis), e.g. for draws which are not objects of LodClass
+	The coarsest level whose error fits, same limit as Select
+*/
+unsigned int LodClass::PickLevel(const float* _errors, unsigned int _levelCount, const Vector3& _center, float _radius, const Vector3& _camera, float _projectionScale, float _nearDistance)
+{
+	if (_projectionScale <= 0.0f)
+	{
+		return 0;
+	}
+
+	Vector3 offset = { _center.x - _camera.x, _center.y - _camera.y, _center.z - _camera.z };
+	float distance = MathClass::Length(offset) - _radius;
+	distance = distance > _nearDistance ? distance : _nearDistance;
+
+	float allowed = distance * LOD_PIXEL_ERROR / _projectionScale;
+	unsigned int level = 0;
+	while (level + 1 < _levelCount && _errors[level + 1] <= allowed)
+	{
+		level++;
+	}
+
+	return level;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include "JobSystemClass.h"
+#include "MathClass.h"
+#include "MeshAssetClass.h"
+#pragma endregion
+
+#pragma region global variables
+const float LOD_PIXEL_ERROR = 1.0f;			// the coarsest level whose error covers at most this many pixels on screen is drawn
+const float LOD_HYSTERESIS = 0.25f;			// the current level stays until it is this much over the limit, a coarser one is only taken this much below it
+const unsigned int LOD_OBJECTS_PER_JOB = 2048;
+#pragma endregion
+
+/*
+	Picks a level of detail per object from the size its geometric error has on screen
+
+	Every object has a bounding sphere and the errors of its levels in world units (MeshLod::error times the scale of the object)
+	The error of a level projects to error * projectionScale / distance pixels, distance is from the camera to the sphere, at least the near plane
+	so the allowed error grows linearly with the distance: a level fits while its error is at most distance * LOD_PIXEL_ERROR / projectionScale
+	Hysteresis against popping: the current level is kept while it is within LOD_HYSTERESIS over that limit,
+	a finer level is taken once it is exceeded, a coarser one only once it fits LOD_HYSTERESIS below the limit
+
+	Select runs over a list of objects (e.g. the visible list of the culling), spread over the jobsystem
+	The levels of the other objects stay as they are, Select never allocates
+*/
+class LodClass
+{
+public:
+	LodClass();
+	~LodClass();
+
+	bool Initialize(unsigned int _maxObjects, JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	void SetObject(unsigned int _object, const Vector3& _center, float _radius);
+	void SetLevels(unsigned int _object, const float* _errors, unsigned int _levelCount);
+	void SetMesh(unsigned int _object, const MeshAssetHeader& _mesh, float _scale);
+
+	unsigned int Select(const unsigned int* _objects, unsigned int _count, const Vector3& _camera, float _projectionScale, float _nearDistance);
+
+	unsigned int GetLevel(unsigned int _object) const;
+	const unsigned char* GetLevels() const;
+	unsigned int GetMaxObjects() const;
+
+	static float GetProjectionScale(const Matrix4& _projectionMatrix, unsigned int _screenHeight);
+	static unsigned int PickLevel(const float* _errors, unsigned int _levelCount, const Vector3& _center, float _radius, const Vector3& _camera, float _projectionScale, float _nearDistance);
+
+private:
+	JobSystemClass* m_jobSystem;
+	unsigned char* m_memory;
+	unsigned int m_maxObjects;
+
+	//	Bounding spheres (SoA), errors of every level (MESH_MAX_LODS per object), levels and the current level
+	float* m_centerX;
+	float* m_centerY;
+	float* m_centerZ;
+	float* m_radius;
+	float* m_errors;
+	unsigned char* m_levelCounts;
+	unsigned char* m_levels;
+
+	//	State of the selection running on the jobsystem
+	const unsigned int* m_selectObjects;
+	Vector3 m_camera;
+	float m_errorPerDistance;
+	float m_nearDistance;
+	std::atomic<unsigned int> m_changedCount;
+
+	void SelectObjects(unsigned int _begin, unsigned int _end);
+	static void SelectJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+};
\ No newline at end of file
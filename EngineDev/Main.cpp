@@ -1,12 +1,252 @@
 #include "Systemclass.h"
+#include "ProfilerClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include "GpuTimerClass.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/*
+	Read the commandline arguments
+	-headless runs the engine without a window and without a GPU
+	-frames <count> quits a headless run after the given amount of frames
+	-fps <count> limits the frame rate, the engine sleeps between the frames
+	-trace <file> writes the profiler zones of the run to a chrome://tracing / Perfetto JSON file (profiling builds only)
+	-software renders on the CPU instead of the GPU
+	-screenshot <file> writes the last frame as PNG when the engine shuts down (software renderer only)
+	-assets <file> streams the assets from the given package
+	-capture <file> writes the commands of the last frames to the given file when the engine shuts down
+	-replay <file> replays a command capture on the null backend instead of running the engine
+	-compare <file> compares the replayed capture frame by frame with another capture
+	-present vsync|immediate|vrr sets the present mode, variable refresh needs tearing support and falls back to vsync without it
+	-buffers <count> sets the back buffers of the swap chain (2 - 4)
+	-latency <count> sets how many presents may wait to be shown before the next frame waits
+	-refresh <hz> headless only, presents to a simulated display with this refresh rate
+	-scene <file> maps the binary scene file, culls its objects every frame and draws the visible ones with the meshes of the asset package
+	-objects <count> sets how many objects a scene may have (default MAX_SCENE_OBJECTS)
+	-culling grid|bvh finds the visible objects of the scene with the grid of the culling stage or the bvh (default bvh)
+	-pipeline <depth> renders on a thread of its own while the simulation runs up to depth frames ahead (1 = double buffered), 0 = single threaded
+*/
+static void ParseArguments(int _argumentCount, char** _arguments, SystemSettings& _settings)
+{
+	for (int i = 1; i < _argumentCount; i++)
+	{
+		if (strcmp(_arguments[i], "-headless") == 0)
+		{
+			_settings.headless = true;
+		}
+		else if (strcmp(_arguments[i], "-frames") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.frameLimit = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-fps") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.targetFrameRate = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-trace") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.tracePath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-software") == 0)
+		{
+			_settings.softwareRenderer = true;
+		}
+		else if (strcmp(_arguments[i], "-screenshot") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.screenshotPath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-assets") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.assetPackagePath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-capture") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.capturePath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-replay") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.replayPath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-compare") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.comparePath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-present") == 0 && i + 1 < _argumentCount)
+		{
+			for (unsigned int mode = PRESENT_MODE_VSYNC; mode <= PRESENT_MODE_VARIABLE_REFRESH; mode++)
+			{
+				if (strcmp(_arguments[i + 1], PresentPolicyClass::GetModeName(mode)) == 0)
+				{
+					_settings.present.mode = mode;
+				}
+			}
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-buffers") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.present.bufferCount = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-latency") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.present.maxFrameLatency = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-refresh") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.present.simulatedRefreshRate = strtod(_arguments[i + 1], nullptr);
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-scene") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.scenePath = _arguments[i + 1];
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-objects") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.maxSceneObjects = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-culling") == 0 && i + 1 < _argumentCount)
+		{
+			for (unsigned int culling = SCENE_CULLING_GRID; culling <= SCENE_CULLING_BVH; culling++)
+			{
+				if (strcmp(_arguments[i + 1], GraphicsClass::GetSceneCullingName(culling)) == 0)
+				{
+					_settings.sceneCulling = culling;
+				}
+			}
+			i++;
+		}
+		else if (strcmp(_arguments[i], "-pipeline") == 0 && i + 1 < _argumentCount)
+		{
+			_settings.renderPipelineDepth = static_cast<unsigned int>(strtoul(_arguments[i + 1], nullptr, 10));
+			i++;
+		}
+	}
+}
+
+/*
+	Print the percentiles of the given frame statistics in milliseconds
+*/
+static void PrintFrameStatistics(const char* _name, const FrameStatisticsClass& _statistics)
+{
+	printf("%s (last %u frames): average %.4f ms, p50 %.4f ms, p95 %.4f ms, p99 %.4f ms\n", _name, _statistics.GetFrameCount(),
+		_statistics.GetAverage(), _statistics.GetPercentile(0.5), _statistics.GetPercentile(0.95), _statistics.GetPercentile(0.99));
+}
+
+/*
+	Print how much time the last frame spent in every profiler zone, indented by the nesting of the zone
+*/
+#ifdef ENGINE_PROFILING
+static void PrintProfilerZones()
+{
+	printf("profiler zones of the last frame:\n");
+
+	for (unsigned int i = 0; i < ProfilerClass::GetZoneCount(); i++)
+	{
+		const ProfilerZoneSummary& zone = ProfilerClass::GetZone(i);
+		printf("%*s%s: %.4f ms (%u calls)\n", 2 + zone.depth * 2, "", zone.name, zone.totalTime, zone.callCount);
+	}
+
+	if (ProfilerClass::GetUnprofiledThreadCount() > 0)
+	{
+		printf("  %u threads were not profiled, every one of the %u profiler slots was taken\n", ProfilerClass::GetUnprofiledThreadCount(), MAX_PROFILER_THREADS);
+	}
+}
+#endif
+
+/*
+	Replay every frame of a command capture into the simulated recorder of the null backend
+	Print how long the replay took and what the frame recorded, so a frame can be looked at without the machine it was captured on
+	With a second capture print for every frame whether it recorded the same commands
+*/
+static int ReplayCapture(const SystemSettings& _settings)
+{
+	CommandCaptureClass capture;
+	if (!capture.Load(_settings.replayPath))
+	{
+		printf("could not load the command capture %s\n", _settings.replayPath);
+		return 1;
+	}
+
+	CommandCaptureClass comparedCapture;
+	if (_settings.comparePath && !comparedCapture.Load(_settings.comparePath))
+	{
+		printf("could not load the command capture %s\n", _settings.comparePath);
+		return 1;
+	}
+
+	SimulatedTimestampQueriesClass timestampQueries;
+	SimulatedCommandRecorderClass commandRecorder;
+	if (!timestampQueries.Initialize(GPU_TIMER_QUERY_COUNT) || !commandRecorder.Initialize(&timestampQueries))
+	{
+		return 1;
+	}
+
+	int result = 0;
+	for (unsigned int i = 0; i < capture.GetFrameCount(); i++)
+	{
+		unsigned long long draws = commandRecorder.GetDrawCount();
+		unsigned long long barriers = commandRecorder.GetBarrierCount();
+		unsigned int commandCount = 0;
+
+		unsigned long long start = TimerClass::GetMicroseconds();
+		bool replayed = capture.Replay(i, &commandRecorder, commandCount);
+		double milliseconds = static_cast<double>(TimerClass::GetMicroseconds() - start) / 1000.0;
+
+		printf("frame %llu: %u commands, %zu bytes%s, %llu draws, %llu barriers, replay %.4f ms\n", capture.GetFrameNumber(i), commandCount, capture.GetFrameSize(i),
+			capture.IsFrameComplete(i) ? "" : " (incomplete)", commandRecorder.GetDrawCount() - draws, commandRecorder.GetBarrierCount() - barriers, milliseconds);
+
+		if (!replayed)
+		{
+			printf("  broken stream after %u commands\n", commandCount);
+			result = 1;
+		}
+
+		if (_settings.comparePath)
+		{
+			unsigned int difference = 0;
+			if (i >= comparedCapture.GetFrameCount())
+			{
+				printf("  missing in %s\n", _settings.comparePath);
+				result = 1;
+			}
+			else if (!CommandCaptureClass::CompareFrames(capture, i, comparedCapture, i, difference))
+			{
+				printf("  differs from frame %llu of %s at command %u\n", comparedCapture.GetFrameNumber(i), _settings.comparePath, difference);
+				result = 1;
+			}
+		}
+	}
+
+	commandRecorder.Shutdown();
+	timestampQueries.Shutdown();
+	capture.Shutdown();
+	comparedCapture.Shutdown();
+
+	return result;
+}
 
 /*
-	Mainfunction
 	Create a new instance of the systemclass
 	Initialize the instance and run the program
 	Should the program quit for any reason so shut it down and release the memory
+	After a headless run print how many frames we ran, how much time a frame took and how much memory the frames allocated
+	and how long the input of a frame took to reach the renderer and the (simulated) display
 */
-int WINAPI WinMain(HINSTANCE _instanceHandle, HINSTANCE _previous, PSTR _pScmdline, int _cmdShow)
+static int RunEngine(const SystemSettings& _settings)
 {
 	SystemClass *system = new SystemClass;
 	if (!system)
@@ -14,16 +254,125 @@ int WINAPI WinMain(HINSTANCE _instanceHandle, HINSTANCE _previous, PSTR _pScmdli
 		return 0;
 	}
 
-	bool intializedWindow = system->Initialize();
+	bool intializedWindow = system->Initialize(_settings);
 	if(intializedWindow)
 	{
 		system->Run();
 	}
 
+	if (_settings.headless)
+	{
+		printf("frames: %llu, average frame time: %.4f ms\n", system->GetFrameCount(), system->GetAverageFrameTime());
+		PrintFrameStatistics("frame time", system->GetFrameStatistics());
+		PrintFrameStatistics("cpu frame time", system->GetCpuFrameStatistics());
+		printf("heap allocations inside frames: %llu, frame memory peak: %zu bytes\n", system->GetFrameHeapAllocations(), system->GetFrameMemoryPeak());
+
+		const RenderThreadClass* renderThread = system->GetRenderThread();
+		if (renderThread)
+		{
+			if (renderThread->GetPipelineDepth() > 0)
+			{
+				printf("render thread, pipeline depth %u\n", renderThread->GetPipelineDepth());
+			}
+			else
+			{
+				printf("single threaded, simulation and rendering alternate\n");
+			}
+			PrintFrameStatistics("render time", renderThread->GetRenderStatistics());
+			PrintFrameStatistics("input to submit latency", renderThread->GetLatencyStatistics());
+		}
+
+		GraphicsClass* graphics = system->GetGraphics();
+		if (graphics && graphics->GetScene()->IsOpen())
+		{
+			printf("scene: %u objects, %s culling, last frame %u visible, %u draws, %llu triangles\n", graphics->GetScene()->GetObjectCount(),
+				GraphicsClass::GetSceneCullingName(graphics->GetSceneCulling()), graphics->GetVisibleCount(), graphics->GetSceneDrawCount(), graphics->GetSceneTriangleCount());
+		}
+
+		const PresentPolicyClass* presentPolicy = system->GetPresentPolicy();
+		if (presentPolicy && presentPolicy->GetLatencyStatistics().GetFrameCount() > 0)
+		{
+			printf("present mode: %s, %u buffers, frame latency %u, %llu presents, %llu shown, %llu dropped\n", PresentPolicyClass::GetModeName(presentPolicy->GetMode()),
+				presentPolicy->GetBufferCount(), presentPolicy->GetFrameLatency(), presentPolicy->GetPresentCount(), presentPolicy->GetShownCount(), presentPolicy->GetDroppedCount());
+			PrintFrameStatistics("input to present latency", presentPolicy->GetLatencyStatistics());
+		}
+#ifdef ENGINE_PROFILING
+		PrintProfilerZones();
+#endif
+	}
+
 	system->Shutdown();
 
 	delete system;
 	system = nullptr;
 
 	return 0;
-}
\ No newline at end of file
+}
+
+/*
+	Mainfunction
+	Windows starts the engine with a window, every other platform only runs headless
+*/
+#ifdef _WIN32
+int WINAPI WinMain(HINSTANCE _instanceHandle, HINSTANCE _previous, PSTR _pScmdline, int _cmdShow)
+{
+	SystemSettings settings;
+	settings.headless = false;
+	settings.frameLimit = 0;
+	settings.targetFrameRate = 0;
+	settings.tracePath = nullptr;
+	settings.softwareRenderer = false;
+	settings.screenshotPath = nullptr;
+	settings.assetPackagePath = nullptr;
+	settings.capturePath = nullptr;
+	settings.replayPath = nullptr;
+	settings.comparePath = nullptr;
+	settings.present.mode = PRESENT_MODE;
+	settings.present.bufferCount = SWAP_CHAIN_BUFFERS;
+	settings.present.maxFrameLatency = MAX_FRAME_LATENCY;
+	settings.present.simulatedRefreshRate = 0.0;
+	settings.scenePath = nullptr;
+	settings.renderPipelineDepth = 0;
+	settings.sceneCulling = SCENE_CULLING;
+	settings.maxSceneObjects = MAX_SCENE_OBJECTS;
+	ParseArguments(__argc, __argv, settings);
+
+	if (settings.replayPath)
+	{
+		return ReplayCapture(settings);
+	}
+
+	return RunEngine(settings);
+}
+#else
+int main(int _argumentCount, char** _arguments)
+{
+	SystemSettings settings;
+	settings.headless = true;
+	settings.frameLimit = 0;
+	settings.targetFrameRate = 0;
+	settings.tracePath = nullptr;
+	settings.softwareRenderer = false;
+	settings.screenshotPath = nullptr;
+	settings.assetPackagePath = nullptr;
+	settings.capturePath = nullptr;
+	settings.replayPath = nullptr;
+	settings.comparePath = nullptr;
+	settings.present.mode = PRESENT_MODE;
+	settings.present.bufferCount = SWAP_CHAIN_BUFFERS;
+	settings.present.maxFrameLatency = MAX_FRAME_LATENCY;
+	settings.present.simulatedRefreshRate = 0.0;
+	settings.scenePath = nullptr;
+	settings.renderPipelineDepth = 0;
+	settings.sceneCulling = SCENE_CULLING;
+	settings.maxSceneObjects = MAX_SCENE_OBJECTS;
+	ParseArguments(_argumentCount, _arguments, settings);
+
+	if (settings.replayPath)
+	{
+		return ReplayCapture(settings);
+	}
+
+	return RunEngine(settings);
+}
+#endif
\ No newline at end of file
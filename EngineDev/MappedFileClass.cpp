@@ -0,0 +1,179 @@
+#include "MappedFileClass.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+	Constructor
+*/
+MappedFileClass::MappedFileClass()
+{
+	m_data = nullptr;
+	m_size = 0;
+
+#ifdef _WIN32
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = nullptr;
+#else
+	m_file = -1;
+#endif
+}
+
+/*
+	Destructor
+*/
+MappedFileClass::~MappedFileClass()
+{
+
+}
+
+/*
+	Open the file, get its size and map all of it read-only
+	Empty files can not be mapped and fail like missing ones
+*/
+bool MappedFileClass::Open(const char* _path)
+{
+	Close();
+
+#ifdef _WIN32
+	m_file = CreateFileA(_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (!m_mapping)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+	m_file = open(_path, O_RDONLY);
+	if (m_file < 0)
+	{
+		return false;
+	}
+
+	struct stat fileStatus;
+	if (fstat(m_file, &fileStatus) != 0 || fileStatus.st_size == 0)
+	{
+		Close();
+		return false;
+	}
+
+	void* data = mmap(nullptr, static_cast<size_t>(fileStatus.st_size), PROT_READ, MAP_PRIVATE, m_file, 0);
+	if (data == MAP_FAILED)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = static_cast<const unsigned char*>(data);
+	m_size = static_cast<size_t>(fileStatus.st_size);
+#endif
+
+	return true;
+}
+
+/*
+	Unmap the view and close the file, the file may be replaced afterwards
+*/
+void MappedFileClass::Close()
+{
+#ifdef _WIN32
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+	}
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_data)
+	{
+		munmap(const_cast<unsigned char*>(m_data), m_size);
+	}
+	if (m_file >= 0)
+	{
+		close(m_file);
+		m_file = -1;
+	}
+#endif
+
+	m_data = nullptr;
+	m_size = 0;
+}
+
+bool MappedFileClass::IsOpen() const
+{
+	return m_data != nullptr;
+}
+
+const void* MappedFileClass::GetData() const
+{
+	return m_data;
+}
+
+size_t MappedFileClass::GetSize() const
+{
+	return m_size;
+}
+
+/*
+	Ask the operating system to start reading [_offset, _offset + _size) of the file in the background
+	Only a hint, returns right away, the range is still paged in on first access if the hint was ignored
+*/
+void MappedFileClass::Prefetch(size_t _offset, size_t _size) const
+{
+	if (!m_data || _offset >= m_size)
+	{
+		return;
+	}
+
+	if (_size > m_size - _offset)
+	{
+		_size = m_size - _offset;
+	}
+
+#ifdef _WIN32
+	WIN32_MEMORY_RANGE_ENTRY range;
+	range.VirtualAddress = const_cast<unsigned char*>(m_data + _offset);
+	range.NumberOfBytes = _size;
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+	//	madvise wants a page aligned address
+	size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t begin = _offset & ~(pageSize - 1);
+	madvise(const_cast<unsigned char*>(m_data + begin), _offset + _size - begin, MADV_WILLNEED);
+#endif
+}
\ No newline at end of file
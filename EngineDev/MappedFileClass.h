@@ -0,0 +1,37 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+/*
+	Read-only view of a whole file mapped into memory
+	The operating system pages the file in on first access, opening a big file costs nothing until it is read
+	The view stays valid until Close
+*/
+class MappedFileClass
+{
+public:
+	MappedFileClass();
+	~MappedFileClass();
+
+	bool Open(const char* _path);
+	void Close();
+
+	bool IsOpen() const;
+	const void* GetData() const;
+	size_t GetSize() const;
+
+	void Prefetch(size_t _offset, size_t _size) const;
+
+private:
+	const unsigned char* m_data;
+	size_t m_size;
+
+#ifdef _WIN32
+	void* m_file;
+	void* m_mapping;
+#else
+	int m_file;
+#endif
+};
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "MathBatchClass.h"
+
+/*
+	_out[i] = (_x[i], _y[i], _z[i], 1) * _matrix, the w of the result is dropped
+	Every matrix entry is splatted once, then every iteration transforms a full register of points
+*/
+void MathBatchClass::TransformPoints(const Matrix4& _matrix, const float* _x, const float* _y, const float* _z, float* _outX, float* _outY, float* _outZ, size_t _count)
+{
+	size_t i = 0;
+
+#if defined(ENGINE_SIMD_AVX2)
+	__m256 m00 = _mm256_set1_ps(_matrix.m[0][0]), m01 = _mm256_set1_ps(_matrix.m[0][1]), m02 = _mm256_set1_ps(_matrix.m[0][2]);
+	__m256 m10 = _mm256_set1_ps(_matrix.m[1][0]), m11 = _mm256_set1_ps(_matrix.m[1][1]), m12 = _mm256_set1_ps(_matrix.m[1][2]);
+	__m256 m20 = _mm256_set1_ps(_matrix.m[2][0]), m21 = _mm256_set1_ps(_matrix.m[2][1]), m22 = _mm256_set1_ps(_matrix.m[2][2]);
+	__m256 m30 = _mm256_set1_ps(_matrix.m[3][0]), m31 = _mm256_set1_ps(_matrix.m[3][1]), m32 = _mm256_set1_ps(_matrix.m[3][2]);
+
+	for (; i + 8 <= _count; i += 8)
+	{
+		__m256 x = _mm256_loadu_ps(_x + i);
+		__m256 y = _mm256_loadu_ps(_y + i);
+		__m256 z = _mm256_loadu_ps(_z + i);
+
+		_mm256_storeu_ps(_outX + i, _mm256_fmadd_ps(z, m20, _mm256_fmadd_ps(y, m10, _mm256_fmadd_ps(x, m00, m30))));
+		_mm256_storeu_ps(_outY + i, _mm256_fmadd_ps(z, m21, _mm256_fmadd_ps(y, m11, _mm256_fmadd_ps(x, m01, m31))));
+		_mm256_storeu_ps(_outZ + i, _mm256_fmadd_ps(z, m22, _mm256_fmadd_ps(y, m12, _mm256_fmadd_ps(x, m02, m32))));
+	}
+#elif !defined(ENGINE_SIMD_SCALAR)
+	SimdFloat4 m00 = SimdClass::Splat(_matrix.m[0][0]), m01 = SimdClass::Splat(_matrix.m[0][1]), m02 = SimdClass::Splat(_matrix.m[0][2]);
+	SimdFloat4 m10 = SimdClass::Splat(_matrix.m[1][0]), m11 = SimdClass::Splat(_matrix.m[1][1]), m12 = SimdClass::Splat(_matrix.m[1][2]);
+	SimdFloat4 m20 = SimdClass::Splat(_matrix.m[2][0]), m21 = SimdClass::Splat(_matrix.m[2][1]), m22 = SimdClass::Splat(_matrix.m[2][2]);
+	SimdFloat4 m30 = SimdClass::Splat(_matrix.m[3][0]), m31 = SimdClass::Splat(_matrix.m[3][1]), m32 = SimdClass::Splat(_matrix.m[3][2]);
+
+	for (; i + 4 <= _count; i += 4)
+	{
+		SimdFloat4 x = SimdClass::LoadUnaligned(_x + i);
+		SimdFloat4 y = SimdClass::LoadUnaligned(_y + i);
+		SimdFloat4 z = SimdClass::LoadUnaligned(_z + i);
+
+		SimdClass::StoreUnaligned(_outX + i, SimdClass::MultiplyAdd(z, m20, SimdClass::MultiplyAdd(y, m10, SimdClass::MultiplyAdd(x, m00, m30))));
+		SimdClass::StoreUnaligned(_outY + i, SimdClass::MultiplyAdd(z, m21, SimdClass::MultiplyAdd(y, m11, SimdClass::MultiplyAdd(x, m01, m31))));
+		SimdClass::StoreUnaligned(_outZ + i, SimdClass::MultiplyAdd(z, m22, SimdClass::MultiplyAdd(y, m12, SimdClass::MultiplyAdd(x, m02, m32))));
+	}
+#endif
+
+	TransformPointsScalar(_matrix, _x + i, _y + i, _z + i, _outX + i, _outY + i, _outZ + i, _count - i);
+}
+
+void MathBatchClass::TransformPointsScalar(const Matrix4& _matrix, const float* _x, const float* _y, const float* _z, float* _outX, float* _outY, float* _outZ, size_t _count)
+{
+	const float (*m)[4] = _matrix.m;
+
+	for (size_t i = 0; i < _count; i++)
+	{
+		float x = _x[i];
+		float y = _y[i];
+		float z = _z[i];
+
+		_outX[i] = x * m[0][0] + y * m[1][0] + z * m[2][0] + m[3][0];
+		_outY[i] = x * m[0][1] + y * m[1][1] + z * m[2][1] + m[3][1];
+		_outZ[i] = x * m[0][2] + y * m[1][2] + z * m[2][2] + m[3][2];
+	}
+}
+
+/*
+	_out[i] = _matrices[i] * _matrix, e.g. world matrices times the view projection
+	The rows of _matrix stay in registers for the whole batch
+	AVX2 computes two rows per register: the rows of _matrix are broadcast into both halves, the entries of the two input rows are splatted per half
+*/
+void MathBatchClass::MultiplyMatrices(const Matrix4* _matrices, const Matrix4& _matrix, Matrix4* _out, size_t _count)
+{
+#if defined(ENGINE_SIMD_AVX2)
+	__m256 row0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(_matrix.m[0]));
+	__m256 row1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(_matrix.m[1]));
+	__m256 row2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(_matrix.m[2]));
+	__m256 row3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(_matrix.m[3]));
+
+	for (size_t i = 0; i < _count; i++)
+	{
+		for (int j = 0; j < 4; j += 2)
+		{
+			__m256 a = _mm256_loadu_ps(_matrices[i].m[j]);
+			__m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), row0);
+			r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), row1, r);
+			r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), row2, r);
+			r = _mm256_fmadd_ps(_mm256_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), row3, r);
+			_mm256_storeu_ps(_out[i].m[j], r);
+		}
+	}
+#elif !defined(ENGINE_SIMD_SCALAR)
+	SimdFloat4 row0 = SimdClass::Load(_matrix.m[0]);
+	SimdFloat4 row1 = SimdClass::Load(_matrix.m[1]);
+	SimdFloat4 row2 = SimdClass::Load(_matrix.m[2]);
+	SimdFloat4 row3 = SimdClass::Load(_matrix.m[3]);
+
+	for (size_t i = 0; i < _count; i++)
+	{
+		for (int j = 0; j < 4; j++)
+		{
+			SimdFloat4 a = SimdClass::Load(_matrices[i].m[j]);
+			SimdFloat4 r = SimdClass::Multiply(SimdClass::SplatLane<0>(a), row0);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<1>(a), row1, r);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<2>(a), row2, r);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<3>(a), row3, r);
+			SimdClass::Store(_out[i].m[j], r);
+		}
+	}
+#else
+	MultiplyMatricesScalar(_matrices, _matrix, _out, _count);
+#endif
+}
+
+void MathBatchClass::MultiplyMatricesScalar(const Matrix4* _matrices, const Matrix4& _matrix, Matrix4* _out, size_t _count)
+{
+	const float (*b)[4] = _matrix.m;
+
+	for (size_t i = 0; i < _count; i++)
+	{
+		const float (*a)[4] = _matrices[i].m;
+		Matrix4 result;
+
+		for (int row = 0; row < 4; row++)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				result.m[row][column] = a[row][0] * b[0][column] + a[row][1] * b[1][column] + a[row][2] * b[2][column] + a[row][3] * b[3][column];
+			}
+		}
+
+		_out[i] = result;
+	}
+}
+
+/*
+	World matrices (scale, rotate, translate) of 4 objects at once
+	The rotation matrix is built with one component of every object per register, the 4 x 4 transposes turn the result into one matrix per object
+*/
+void MathBatchClass::ComposeTransforms(const TransformArrays& _transforms, Matrix4* _out, size_t _count)
+{
+	size_t i = 0;
+
+#if !defined(ENGINE_SIMD_SCALAR)
+	SimdFloat4 zero = SimdClass::Splat(0.0f);
+	SimdFloat4 one = SimdClass::Splat(1.0f);
+	SimdFloat4 two = SimdClass::Splat(2.0f);
+
+	for (; i + 4 <= _count; i += 4)
+	{
+		SimdFloat4 x = SimdClass::LoadUnaligned(_transforms.rotationX + i);
+		SimdFloat4 y = SimdClass::LoadUnaligned(_transforms.rotationY + i);
+		SimdFloat4 z = SimdClass::LoadUnaligned(_transforms.rotationZ + i);
+		SimdFloat4 w = SimdClass::LoadUnaligned(_transforms.rotationW + i);
+		SimdFloat4 scaleX = SimdClass::LoadUnaligned(_transforms.scaleX + i);
+		SimdFloat4 scaleY = SimdClass::LoadUnaligned(_transforms.scaleY + i);
+		SimdFloat4 scaleZ = SimdClass::LoadUnaligned(_transforms.scaleZ + i);
+
+		SimdFloat4 x2 = SimdClass::Multiply(x, two);
+		SimdFloat4 y2 = SimdClass::Multiply(y, two);
+		SimdFloat4 z2 = SimdClass::Multiply(z, two);
+		SimdFloat4 xx = SimdClass::Multiply(x, x2);
+		SimdFloat4 yy = SimdClass::Multiply(y, y2);
+		SimdFloat4 zz = SimdClass::Multiply(z, z2);
+		SimdFloat4 xy = SimdClass::Multiply(x, y2);
+		SimdFloat4 xz = SimdClass::Multiply(x, z2);
+		SimdFloat4 yz = SimdClass::Multiply(y, z2);
+		SimdFloat4 wx = SimdClass::Multiply(w, x2);
+		SimdFloat4 wy = SimdClass::Multiply(w, y2);
+		SimdFloat4 wz = SimdClass::Multiply(w, z2);
+
+		//	Row r, column c of all 4 matrices
+		SimdFloat4 m00 = SimdClass::Multiply(SimdClass::Subtract(one, SimdClass::Add(yy, zz)), scaleX);
+		SimdFloat4 m01 = SimdClass::Multiply(SimdClass::Add(xy, wz), scaleX);
+		SimdFloat4 m02 = SimdClass::Multiply(SimdClass::Subtract(xz, wy), scaleX);
+		SimdFloat4 m10 = SimdClass::Multiply(SimdClass::Subtract(xy, wz), scaleY);
+		SimdFloat4 m11 = SimdClass::Multiply(SimdClass::Subtract(one, SimdClass::Add(xx, zz)), scaleY);
+		SimdFloat4 m12 = SimdClass::Multiply(SimdClass::Add(yz, wx), scaleY);
+		SimdFloat4 m20 = SimdClass::Multiply(SimdClass::Add(xz, wy), scaleZ);
+		SimdFloat4 m21 = SimdClass::Multiply(SimdClass::Subtract(yz, wx), scaleZ);
+		SimdFloat4 m22 = SimdClass::Multiply(SimdClass::Subtract(one, SimdClass::Add(xx, yy)), scaleZ);
+		SimdFloat4 m30 = SimdClass::LoadUnaligned(_transforms.positionX + i);
+		SimdFloat4 m31 = SimdClass::LoadUnaligned(_transforms.positionY + i);
+		SimdFloat4 m32 = SimdClass::LoadUnaligned(_transforms.positionZ + i);
+		SimdFloat4 m03 = zero;
+		SimdFloat4 m13 = zero;
+		SimdFloat4 m23 = zero;
+		SimdFloat4 m33 = one;
+
+		//	Column c of the registers holds matrix c, after transposing register r holds row 0 - 3 of matrix r
+		SimdClass::Transpose(m00, m01, m02, m03);
+		SimdClass::Transpose(m10, m11, m12, m13);
+		SimdClass::Transpose(m20, m21, m22, m23);
+		SimdClass::Transpose(m30, m31, m32, m33);
+
+		SimdFloat4 rows[4][4] = {
+			{ m00, m10, m20, m30 },
+			{ m01, m11, m21, m31 },
+			{ m02, m12, m22, m32 },
+			{ m03, m13, m23, m33 } };
+
+		for (int j = 0; j < 4; j++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				SimdClass::Store(_out[i + j].m[row], rows[j][row]);
+			}
+		}
+	}
+#endif
+
+	TransformArrays remaining = {
+		_transforms.positionX + i, _transforms.positionY + i, _transforms.positionZ + i,
+		_transforms.rotationX + i, _transforms.rotationY + i, _transforms.rotationZ + i, _transforms.rotationW + i,
+		_transforms.scaleX + i, _transforms.scaleY + i, _transforms.scaleZ + i };
+	ComposeTransformsScalar(remaining, _out + i, _count - i);
+}
+
+void MathBatchClass::ComposeTransformsScalar(const TransformArrays& _transforms, Matrix4* _out, size_t _count)
+{
+	for (size_t i = 0; i < _count; i++)
+	{
+		Vector3 position = { _transforms.positionX[i], _transforms.positionY[i], _transforms.positionZ[i] };
+		Quaternion rotation = { _transforms.rotationX[i], _transforms.rotationY[i], _transforms.rotationZ[i], _transforms.rotationW[i] };
+		Vector3 scale = { _transforms.scaleX[i], _transforms.scaleY[i], _transforms.scaleZ[i] };
+		_out[i] = MathClass::Compose(position, rotation, scale);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MathClass.h"
+#pragma endregion
+
+/*
+	Positions, rotations and scales of many objects, one array per component (SoA)
+	The arrays do not have to be aligned
+*/
+struct TransformArrays
+{
+	const float* positionX;
+	const float* positionY;
+	const float* positionZ;
+	const float* rotationX;
+	const float* rotationY;
+	const float* rotationZ;
+	const float* rotationW;
+	const float* scaleX;
+	const float* scaleY;
+	const float* scaleZ;
+};
+
+/*
+	Kernels which transform thousands of points or matrices at once
+	The inputs are structures of arrays, so one register holds the same component of 4 (SSE, NEON) or 8 (AVX2) elements and no lane is wasted
+	Every kernel has a ...Scalar twin which computes the same with plain floats, as the reference to compare against
+	Counts which are no multiple of the width are finished with the scalar code
+*/
+class MathBatchClass
+{
+public:
+	static void TransformPoints(const Matrix4& _matrix, const float* _x, const float* _y, const float* _z, float* _outX, float* _outY, float* _outZ, size_t _count);
+	static void TransformPointsScalar(const Matrix4& _matrix, const float* _x, const float* _y, const float* _z, float* _outX, float* _outY, float* _outZ, size_t _count);
+
+	static void MultiplyMatrices(const Matrix4* _matrices, const Matrix4& _matrix, Matrix4* _out, size_t _count);
+	static void MultiplyMatricesScalar(const Matrix4* _matrices, const Matrix4& _matrix, Matrix4* _out, size_t _count);
+
+	static void ComposeTransforms(const TransformArrays& _transforms, Matrix4* _out, size_t _count);
+	static void ComposeTransformsScalar(const TransformArrays& _transforms, Matrix4* _out, size_t _count);
+};
\ No newline at end of file
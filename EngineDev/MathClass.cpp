@@ -0,0 +1,389 @@
+#include "MathClass.h"
+
+Matrix4 MathClass::Identity()
+{
+	Matrix4 result = { { { 1.0f, 0.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } } };
+	return result;
+}
+
+Matrix4 MathClass::Transpose(const Matrix4& _matrix)
+{
+	SimdFloat4 row0 = SimdClass::Load(_matrix.m[0]);
+	SimdFloat4 row1 = SimdClass::Load(_matrix.m[1]);
+	SimdFloat4 row2 = SimdClass::Load(_matrix.m[2]);
+	SimdFloat4 row3 = SimdClass::Load(_matrix.m[3]);
+	SimdClass::Transpose(row0, row1, row2, row3);
+
+	Matrix4 result;
+	SimdClass::Store(result.m[0], row0);
+	SimdClass::Store(result.m[1], row1);
+	SimdClass::Store(result.m[2], row2);
+	SimdClass::Store(result.m[3], row3);
+	return result;
+}
+
+/*
+	Inverse through the cofactors (Laplace expansion over 2x2 sub-determinants)
+	Return false and leave _inverse untouched if the matrix is singular
+	Not used per object per frame, so it stays scalar
+*/
+bool MathClass::Inverse(const Matrix4& _matrix, Matrix4& _inverse)
+{
+	const float (*m)[4] = _matrix.m;
+
+	float s0 = m[0][0] * m[1][1] - m[1][0] * m[0][1];
+	float s1 = m[0][0] * m[1][2] - m[1][0] * m[0][2];
+	float s2 = m[0][0] * m[1][3] - m[1][0] * m[0][3];
+	float s3 = m[0][1] * m[1][2] - m[1][1] * m[0][2];
+	float s4 = m[0][1] * m[1][3] - m[1][1] * m[0][3];
+	float s5 = m[0][2] * m[1][3] - m[1][2] * m[0][3];
+
+	float c5 = m[2][2] * m[3][3] - m[3][2] * m[2][3];
+	float c4 = m[2][1] * m[3][3] - m[3][1] * m[2][3];
+	float c3 = m[2][1] * m[3][2] - m[3][1] * m[2][2];
+	float c2 = m[2][0] * m[3][3] - m[3][0] * m[2][3];
+	float c1 = m[2][0] * m[3][2] - m[3][0] * m[2][2];
+	float c0 = m[2][0] * m[3][1] - m[3][0] * m[2][1];
+
+	float determinant = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if (fabsf(determinant) < 1e-12f)
+	{
+		return false;
+	}
+
+	float inverseDeterminant = 1.0f / determinant;
+	float (*r)[4] = _inverse.m;
+
+	r[0][0] = (m[1][1] * c5 - m[1][2] * c4 + m[1][3] * c3) * inverseDeterminant;
+	r[0][1] = (-m[0][1] * c5 + m[0][2] * c4 - m[0][3] * c3) * inverseDeterminant;
+	r[0][2] = (m[3][1] * s5 - m[3][2] * s4 + m[3][3] * s3) * inverseDeterminant;
+	r[0][3] = (-m[2][1] * s5 + m[2][2] * s4 - m[2][3] * s3) * inverseDeterminant;
+
+	r[1][0] = (-m[1][0] * c5 + m[1][2] * c2 - m[1][3] * c1) * inverseDeterminant;
+	r[1][1] = (m[0][0] * c5 - m[0][2] * c2 + m[0][3] * c1) * inverseDeterminant;
+	r[1][2] = (-m[3][0] * s5 + m[3][2] * s2 - m[3][3] * s1) * inverseDeterminant;
+	r[1][3] = (m[2][0] * s5 - m[2][2] * s2 + m[2][3] * s1) * inverseDeterminant;
+
+	r[2][0] = (m[1][0] * c4 - m[1][1] * c2 + m[1][3] * c0) * inverseDeterminant;
+	r[2][1] = (-m[0][0] * c4 + m[0][1] * c2 - m[0][3] * c0) * inverseDeterminant;
+	r[2][2] = (m[3][0] * s4 - m[3][1] * s2 + m[3][3] * s0) * inverseDeterminant;
+	r[2][3] = (-m[2][0] * s4 + m[2][1] * s2 - m[2][3] * s0) * inverseDeterminant;
+
+	r[3][0] = (-m[1][0] * c3 + m[1][1] * c1 - m[1][2] * c0) * inverseDeterminant;
+	r[3][1] = (m[0][0] * c3 - m[0][1] * c1 + m[0][2] * c0) * inverseDeterminant;
+	r[3][2] = (-m[3][0] * s3 + m[3][1] * s1 - m[3][2] * s0) * inverseDeterminant;
+	r[3][3] = (m[2][0] * s3 - m[2][1] * s1 + m[2][2] * s0) * inverseDeterminant;
+
+	return true;
+}
+
+Matrix4 MathClass::Translation(const Vector3& _translation)
+{
+	Matrix4 result = Identity();
+	result.m[3][0] = _translation.x;
+	result.m[3][1] = _translation.y;
+	result.m[3][2] = _translation.z;
+	return result;
+}
+
+Matrix4 MathClass::Scaling(const Vector3& _scale)
+{
+	Matrix4 result = Identity();
+	result.m[0][0] = _scale.x;
+	result.m[1][1] = _scale.y;
+	result.m[2][2] = _scale.z;
+	return result;
+}
+
+/*
+	The rows are the rotated x, y and z axis, _rotation has to be normalized
+*/
+Matrix4 MathClass::Rotation(const Quaternion& _rotation)
+{
+	float x = _rotation.x;
+	float y = _rotation.y;
+	float z = _rotation.z;
+	float w = _rotation.w;
+
+	Matrix4 result = { {
+		{ 1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f },
+		{ 2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f },
+		{ 2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f },
+		{ 0.0f, 0.0f, 0.0f, 1.0f } } };
+	return result;
+}
+
+/*
+	Scale, then rotate, then translate (world matrix of an object)
+	Same as Scaling * Rotation * Translation without the two multiplications
+*/
+Matrix4 MathClass::Compose(const Vector3& _translation, const Quaternion& _rotation, const Vector3& _scale)
+{
+	Matrix4 result = Rotation(_rotation);
+
+	for (int i = 0; i < 3; i++)
+	{
+		result.m[0][i] *= _scale.x;
+		result.m[1][i] *= _scale.y;
+		result.m[2][i] *= _scale.z;
+	}
+
+	result.m[3][0] = _translation.x;
+	result.m[3][1] = _translation.y;
+	result.m[3][2] = _translation.z;
+	return result;
+}
+
+/*
+	View matrix of a left-handed camera at _eye looking at _target
+	The columns are the camera axes, the last row moves the eye into the origin
+*/
+Matrix4 MathClass::LookAt(const Vector3& _eye, const Vector3& _target, const Vector3& _up)
+{
+	Vector3 axisZ = Normalize(Subtract(_target, _eye));
+	Vector3 axisX = Normalize(Cross(_up, axisZ));
+	Vector3 axisY = Cross(axisZ, axisX);
+
+	Matrix4 result = { {
+		{ axisX.x, axisY.x, axisZ.x, 0.0f },
+		{ axisX.y, axisY.y, axisZ.y, 0.0f },
+		{ axisX.z, axisY.z, axisZ.z, 0.0f },
+		{ -Dot(axisX, _eye), -Dot(axisY, _eye), -Dot(axisZ, _eye), 1.0f } } };
+	return result;
+}
+
+/*
+	Left-handed perspective projection, _fieldOfView is vertical in radians
+	Maps _near to depth 0 and _far to depth 1 like D3D expects, w of the result is the view space z
+*/
+Matrix4 MathClass::Perspective(float _fieldOfView, float _aspectRatio, float _near, float _far)
+{
+	float scaleY = 1.0f / tanf(_fieldOfView * 0.5f);
+	float scaleX = scaleY / _aspectRatio;
+	float range = _far / (_far - _near);
+
+	Matrix4 result = { {
+		{ scaleX, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, scaleY, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, range, 1.0f },
+		{ 0.0f, 0.0f, -range * _near, 0.0f } } };
+	return result;
+}
+
+/*
+	Left-handed orthographic projection centered on the view axis, depth 0 - 1 between _near and _far
+*/
+Matrix4 MathClass::Orthographic(float _width, float _height, float _near, float _far)
+{
+	float range = 1.0f / (_far - _near);
+
+	Matrix4 result = { {
+		{ 2.0f / _width, 0.0f, 0.0f, 0.0f },
+		{ 0.0f, 2.0f / _height, 0.0f, 0.0f },
+		{ 0.0f, 0.0f, range, 0.0f },
+		{ 0.0f, 0.0f, -range * _near, 1.0f } } };
+	return result;
+}
+
+Quaternion MathClass::QuaternionIdentity()
+{
+	Quaternion result = { 0.0f, 0.0f, 0.0f, 1.0f };
+	return result;
+}
+
+/*
+	Rotation around _axis by _angle radians, clockwise when looking along the axis (left-handed)
+	_axis has to be normalized
+*/
+Quaternion MathClass::QuaternionFromAxisAngle(const Vector3& _axis, float _angle)
+{
+	float halfSin = sinf(_angle * 0.5f);
+	Quaternion result = { _axis.x * halfSin, _axis.y * halfSin, _axis.z * halfSin, cosf(_angle * 0.5f) };
+	return result;
+}
+
+/*
+	Rotation _a followed by _b, the same order as Rotation(_a) * Rotation(_b)
+	(the Hamilton product _b * _a)
+*/
+Quaternion MathClass::Multiply(const Quaternion& _a, const Quaternion& _b)
+{
+	Quaternion result;
+	result.x = _b.w * _a.x + _b.x * _a.w + _b.y * _a.z - _b.z * _a.y;
+	result.y = _b.w * _a.y - _b.x * _a.z + _b.y * _a.w + _b.z * _a.x;
+	result.z = _b.w * _a.z + _b.x * _a.y - _b.y * _a.x + _b.z * _a.w;
+	result.w = _b.w * _a.w - _b.x * _a.x - _b.y * _a.y - _b.z * _a.z;
+	return result;
+}
+
+Quaternion MathClass::Normalize(const Quaternion& _rotation)
+{
+	float length = sqrtf(_rotation.x * _rotation.x + _rotation.y * _rotation.y + _rotation.z * _rotation.z + _rotation.w * _rotation.w);
+	if (length <= 0.0f)
+	{
+		return QuaternionIdentity();
+	}
+
+	float inverseLength = 1.0f / length;
+	Quaternion result = { _rotation.x * inverseLength, _rotation.y * inverseLength, _rotation.z * inverseLength, _rotation.w * inverseLength };
+	return result;
+}
+
+//	Inverse rotation of a unit quaternion
+Quaternion MathClass::Conjugate(const Quaternion& _rotation)
+{
+	Quaternion result = { -_rotation.x, -_rotation.y, -_rotation.z, _rotation.w };
+	return result;
+}
+
+/*
+	Spherical interpolation along the shorter arc
+	Nearly parallel rotations fall back to a normalized linear interpolation, the sine gets too small to divide by
+*/
+Quaternion MathClass::Slerp(const Quaternion& _a, const Quaternion& _b, float _t)
+{
+	Quaternion b = _b;
+	float cosAngle = _a.x * b.x + _a.y * b.y + _a.z * b.z + _a.w * b.w;
+	if (cosAngle < 0.0f)
+	{
+		b = { -b.x, -b.y, -b.z, -b.w };
+		cosAngle = -cosAngle;
+	}
+
+	float weightA = 1.0f - _t;
+	float weightB = _t;
+	if (cosAngle < 0.9995f)
+	{
+		float angle = acosf(cosAngle);
+		float inverseSin = 1.0f / sinf(angle);
+		weightA = sinf(weightA * angle) * inverseSin;
+		weightB = sinf(weightB * angle) * inverseSin;
+	}
+
+	Quaternion result = { _a.x * weightA + b.x * weightB, _a.y * weightA + b.y * weightB, _a.z * weightA + b.z * weightB, _a.w * weightA + b.w * weightB };
+	return Normalize(result);
+}
+
+/*
+	v' = v + w * t + q x t with t = 2 * (q x v), cheaper than building the matrix for a single vector
+*/
+Vector3 MathClass::Rotate(const Vector3& _vector, const Quaternion& _rotation)
+{
+	Vector3 axis = { _rotation.x, _rotation.y, _rotation.z };
+	Vector3 t = Scale(Cross(axis, _vector), 2.0f);
+	return Add(Add(_vector, Scale(t, _rotation.w)), Cross(axis, t));
+}
+
+/*
+	Bounding box of the transformed box (Arvo)
+	Start at the translation and add the smaller and the larger product of every matrix entry with the box extents per axis
+*/
+Aabb MathClass::Transform(const Aabb& _box, const Matrix4& _matrix)
+{
+	float minimum[3] = { _matrix.m[3][0], _matrix.m[3][1], _matrix.m[3][2] };
+	float maximum[3] = { _matrix.m[3][0], _matrix.m[3][1], _matrix.m[3][2] };
+	const float boxMinimum[3] = { _box.minimum.x, _box.minimum.y, _box.minimum.z };
+	const float boxMaximum[3] = { _box.maximum.x, _box.maximum.y, _box.maximum.z };
+
+	for (int row = 0; row < 3; row++)
+	{
+		for (int column = 0; column < 3; column++)
+		{
+			float a = _matrix.m[row][column] * boxMinimum[row];
+			float b = _matrix.m[row][column] * boxMaximum[row];
+			minimum[column] += a < b ? a : b;
+			maximum[column] += a < b ? b : a;
+		}
+	}
+
+	Aabb result = { { minimum[0], minimum[1], minimum[2] }, { maximum[0], maximum[1], maximum[2] } };
+	return result;
+}
+
+Aabb MathClass::Merge(const Aabb& _a, const Aabb& _b)
+{
+	Aabb result = {
+		{ fminf(_a.minimum.x, _b.minimum.x), fminf(_a.minimum.y, _b.minimum.y), fminf(_a.minimum.z, _b.minimum.z) },
+		{ fmaxf(_a.maximum.x, _b.maximum.x), fmaxf(_a.maximum.y, _b.maximum.y), fmaxf(_a.maximum.z, _b.maximum.z) } };
+	return result;
+}
+
+bool MathClass::Contains(const Aabb& _box, const Vector3& _point)
+{
+	return _point.x >= _box.minimum.x && _point.x <= _box.maximum.x
+		&& _point.y >= _box.minimum.y && _point.y <= _box.maximum.y
+		&& _point.z >= _box.minimum.z && _point.z <= _box.maximum.z;
+}
+
+/*
+	Extract the planes from the columns of the view projection matrix (Gribb / Hartmann)
+	A point is inside if -w <= x <= w, -w <= y <= w and 0 <= z <= w in clip space, every inequality is one plane
+	The planes are normalized so the sphere test can compare distances
+*/
+Frustum MathClass::FrustumFromMatrix(const Matrix4& _viewProjection)
+{
+	Vector4 columns[4];
+	for (int i = 0; i < 4; i++)
+	{
+		columns[i] = { _viewProjection.m[0][i], _viewProjection.m[1][i], _viewProjection.m[2][i], _viewProjection.m[3][i] };
+	}
+
+	Frustum result;
+	result.planes[0] = { columns[3].x + columns[0].x, columns[3].y + columns[0].y, columns[3].z + columns[0].z, columns[3].w + columns[0].w };
+	result.planes[1] = { columns[3].x - columns[0].x, columns[3].y - columns[0].y, columns[3].z - columns[0].z, columns[3].w - columns[0].w };
+	result.planes[2] = { columns[3].x + columns[1].x, columns[3].y + columns[1].y, columns[3].z + columns[1].z, columns[3].w + columns[1].w };
+	result.planes[3] = { columns[3].x - columns[1].x, columns[3].y - columns[1].y, columns[3].z - columns[1].z, columns[3].w - columns[1].w };
+	result.planes[4] = columns[2];
+	result.planes[5] = { columns[3].x - columns[2].x, columns[3].y - columns[2].y, columns[3].z - columns[2].z, columns[3].w - columns[2].w };
+
+	for (int i = 0; i < 6; i++)
+	{
+		Vector4& plane = result.planes[i];
+		float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+		if (length > 0.0f)
+		{
+			float inverseLength = 1.0f / length;
+			plane = { plane.x * inverseLength, plane.y * inverseLength, plane.z * inverseLength, plane.w * inverseLength };
+		}
+	}
+
+	return result;
+}
+
+/*
+	The box is outside if it lies completely behind one of the planes
+	Test the center against every plane, pushed towards the plane by the projected half extents
+	Conservative: boxes near a corner of the frustum can pass although they are outside
+*/
+bool MathClass::Intersects(const Frustum& _frustum, const Aabb& _box)
+{
+	Vector3 center = Scale(Add(_box.minimum, _box.maximum), 0.5f);
+	Vector3 extents = Scale(Subtract(_box.maximum, _box.minimum), 0.5f);
+
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = fabsf(plane.x) * extents.x + fabsf(plane.y) * extents.y + fabsf(plane.z) * extents.z;
+		if (distance + radius < 0.0f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool MathClass::Intersects(const Frustum& _frustum, const Vector3& _center, float _radius)
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		if (plane.x * _center.x + plane.y * _center.y + plane.z * _center.z + plane.w < -_radius)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,192 @@
+#pragma once
+
+#pragma region includes
+#include <cmath>
+#include "SimdClass.h"
+#pragma endregion
+
+#pragma region global variables
+const float MATH_PI = 3.14159265358979f;
+#pragma endregion
+
+struct Vector3
+{
+	float x;
+	float y;
+	float z;
+};
+
+struct alignas(16) Vector4
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+/*
+	Rotation as a unit quaternion, w is the real part
+*/
+struct alignas(16) Quaternion
+{
+	float x;
+	float y;
+	float z;
+	float w;
+};
+
+/*
+	Row-major, points are row vectors which are multiplied from the left (p * M), the translation is the last row
+	Same convention as DirectXMath, so a matrix can be handed to HLSL as it is (row_major) or transposed (column_major)
+	A * B applies A first, then B
+*/
+struct alignas(16) Matrix4
+{
+	float m[4][4];
+};
+
+struct Aabb
+{
+	Vector3 minimum;
+	Vector3 maximum;
+};
+
+/*
+	Left, right, bottom, top, near and far plane, (x, y, z) is the normal pointing inside, w the distance
+	A point p is inside of a plane if dot(normal, p) + w >= 0
+*/
+struct alignas(16) Frustum
+{
+	Vector4 planes[6];
+};
+
+/*
+	Vectors, matrices, quaternions, bounding boxes and frustums for a left-handed world and the D3D clip space (depth 0 - 1)
+	The matrix and vector 4 operations use SimdClass, so they run on SSE, AVX2 (fused multiply add), NEON or scalar
+	The small vector 3 helpers stay scalar, they are faster without shuffling the fourth lane around
+	Batches of transforms go through MathBatchClass
+*/
+class MathClass
+{
+public:
+	static Vector3 Add(const Vector3& _a, const Vector3& _b)
+	{
+		Vector3 result = { _a.x + _b.x, _a.y + _b.y, _a.z + _b.z };
+		return result;
+	}
+
+	static Vector3 Subtract(const Vector3& _a, const Vector3& _b)
+	{
+		Vector3 result = { _a.x - _b.x, _a.y - _b.y, _a.z - _b.z };
+		return result;
+	}
+
+	static Vector3 Scale(const Vector3& _a, float _scale)
+	{
+		Vector3 result = { _a.x * _scale, _a.y * _scale, _a.z * _scale };
+		return result;
+	}
+
+	static float Dot(const Vector3& _a, const Vector3& _b)
+	{
+		return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z;
+	}
+
+	static Vector3 Cross(const Vector3& _a, const Vector3& _b)
+	{
+		Vector3 result = { _a.y * _b.z - _a.z * _b.y, _a.z * _b.x - _a.x * _b.z, _a.x * _b.y - _a.y * _b.x };
+		return result;
+	}
+
+	static float Length(const Vector3& _a)
+	{
+		return sqrtf(Dot(_a, _a));
+	}
+
+	static Vector3 Normalize(const Vector3& _a)
+	{
+		float length = Length(_a);
+		return length > 0.0f ? Scale(_a, 1.0f / length) : _a;
+	}
+
+	/*
+		Every row of the result is a linear combination of the rows of _b, weighted by the row of _a
+	*/
+	static Matrix4 Multiply(const Matrix4& _a, const Matrix4& _b)
+	{
+		SimdFloat4 row0 = SimdClass::Load(_b.m[0]);
+		SimdFloat4 row1 = SimdClass::Load(_b.m[1]);
+		SimdFloat4 row2 = SimdClass::Load(_b.m[2]);
+		SimdFloat4 row3 = SimdClass::Load(_b.m[3]);
+
+		Matrix4 result;
+		for (int i = 0; i < 4; i++)
+		{
+			SimdFloat4 a = SimdClass::Load(_a.m[i]);
+			SimdFloat4 r = SimdClass::Multiply(SimdClass::SplatLane<0>(a), row0);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<1>(a), row1, r);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<2>(a), row2, r);
+			r = SimdClass::MultiplyAdd(SimdClass::SplatLane<3>(a), row3, r);
+			SimdClass::Store(result.m[i], r);
+		}
+
+		return result;
+	}
+
+	static Vector4 Transform(const Vector4& _vector, const Matrix4& _matrix)
+	{
+		SimdFloat4 r = SimdClass::Multiply(SimdClass::Splat(_vector.x), SimdClass::Load(_matrix.m[0]));
+		r = SimdClass::MultiplyAdd(SimdClass::Splat(_vector.y), SimdClass::Load(_matrix.m[1]), r);
+		r = SimdClass::MultiplyAdd(SimdClass::Splat(_vector.z), SimdClass::Load(_matrix.m[2]), r);
+		r = SimdClass::MultiplyAdd(SimdClass::Splat(_vector.w), SimdClass::Load(_matrix.m[3]), r);
+
+		Vector4 result;
+		SimdClass::Store(&result.x, r);
+		return result;
+	}
+
+	//	w = 1, the translation applies
+	static Vector3 TransformPoint(const Vector3& _point, const Matrix4& _matrix)
+	{
+		Vector4 point = { _point.x, _point.y, _point.z, 1.0f };
+		Vector4 result = Transform(point, _matrix);
+		Vector3 result3 = { result.x, result.y, result.z };
+		return result3;
+	}
+
+	//	w = 0, only rotation and scale apply
+	static Vector3 TransformVector(const Vector3& _vector, const Matrix4& _matrix)
+	{
+		Vector4 vector = { _vector.x, _vector.y, _vector.z, 0.0f };
+		Vector4 result = Transform(vector, _matrix);
+		Vector3 result3 = { result.x, result.y, result.z };
+		return result3;
+	}
+
+	static Matrix4 Identity();
+	static Matrix4 Transpose(const Matrix4& _matrix);
+	static bool Inverse(const Matrix4& _matrix, Matrix4& _inverse);
+	static Matrix4 Translation(const Vector3& _translation);
+	static Matrix4 Scaling(const Vector3& _scale);
+	static Matrix4 Rotation(const Quaternion& _rotation);
+	static Matrix4 Compose(const Vector3& _translation, const Quaternion& _rotation, const Vector3& _scale);
+	static Matrix4 LookAt(const Vector3& _eye, const Vector3& _target, const Vector3& _up);
+	static Matrix4 Perspective(float _fieldOfView, float _aspectRatio, float _near, float _far);
+	static Matrix4 Orthographic(float _width, float _height, float _near, float _far);
+
+	static Quaternion QuaternionIdentity();
+	static Quaternion QuaternionFromAxisAngle(const Vector3& _axis, float _angle);
+	static Quaternion Multiply(const Quaternion& _a, const Quaternion& _b);
+	static Quaternion Normalize(const Quaternion& _rotation);
+	static Quaternion Conjugate(const Quaternion& _rotation);
+	static Quaternion Slerp(const Quaternion& _a, const Quaternion& _b, float _t);
+	static Vector3 Rotate(const Vector3& _vector, const Quaternion& _rotation);
+
+	static Aabb Transform(const Aabb& _box, const Matrix4& _matrix);
+	static Aabb Merge(const Aabb& _a, const Aabb& _b);
+	static bool Contains(const Aabb& _box, const Vector3& _point);
+
+	static Frustum FrustumFromMatrix(const Matrix4& _viewProjection);
+	static bool Intersects(const Frustum& _frustum, const Aabb& _box);
+	static bool Intersects(const Frustum& _frustum, const Vector3& _center, float _radius);
+};
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include "MemoryTrackerClass.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+#pragma region Globals
+static std::atomic<unsigned long long> AllocationCount(0);
+static std::atomic<unsigned long long> ForegroundAllocationCount(0);
+static std::atomic<unsigned long long> FreeCount(0);
+static std::atomic<unsigned long long> AllocatedBytes(0);
+#pragma endregion
+
+unsigned long long MemoryTrackerClass::GetAllocationCount()
+{
+	return AllocationCount.load(std::memory_order_relaxed);
+}
+
+/*
+	Allocations which were not made by a background job of the jobsystem
+*/
+unsigned long long MemoryTrackerClass::GetForegroundAllocationCount()
+{
+	return ForegroundAllocationCount.load(std::memory_order_relaxed);
+}
+
+unsigned long long MemoryTrackerClass::GetFreeCount()
+{
+	return FreeCount.load(std::memory_order_relaxed);
+}
+
+/*
+	Bytes requested by all allocations since the start, freed memory is not subtracted
+*/
+unsigned long long MemoryTrackerClass::GetAllocatedBytes()
+{
+	return AllocatedBytes.load(std::memory_order_relaxed);
+}
+
+unsigned long long MemoryTrackerClass::GetLiveAllocationCount()
+{
+	return GetAllocationCount() - GetFreeCount();
+}
+
+/*
+	Count the allocation and forward it to malloc
+*/
+static void* TrackedAllocate(size_t _size)
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	AllocatedBytes.fetch_add(_size, std::memory_order_relaxed);
+	if (!JobSystemClass::IsRunningBackgroundJob())
+	{
+		ForegroundAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return malloc(_size == 0 ? 1 : _size);
+}
+
+static void TrackedFree(void* _memory)
+{
+	if (!_memory)
+	{
+		return;
+	}
+
+	FreeCount.fetch_add(1, std::memory_order_relaxed);
+
+	free(_memory);
+}
+
+#ifdef __cpp_aligned_new
+/*
+	Count the allocation of an over-aligned type, the memory has to be freed with TrackedAlignedFree
+*/
+static void* TrackedAlignedAllocate(size_t _size, std::align_val_t _alignment)
+{
+	AllocationCount.fetch_add(1, std::memory_order_relaxed);
+	AllocatedBytes.fetch_add(_size, std::memory_order_relaxed);
+	if (!JobSystemClass::IsRunningBackgroundJob())
+	{
+		ForegroundAllocationCount.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	size_t alignment = static_cast<size_t>(_alignment) < sizeof(void*) ? sizeof(void*) : static_cast<size_t>(_alignment);
+#ifdef _WIN32
+	return _aligned_malloc(_size == 0 ? 1 : _size, alignment);
+#else
+	void* memory = nullptr;
+	if (posix_memalign(&memory, alignment, _size == 0 ? 1 : _size) != 0)
+	{
+		return nullptr;
+	}
+
+	return memory;
+#endif
+}
+
+static void TrackedAlignedFree(void* _memory)
+{
+	if (!_memory)
+	{
+		return;
+	}
+
+	FreeCount.fetch_add(1, std::memory_order_relaxed);
+
+#ifdef _WIN32
+	_aligned_free(_memory);
+#else
+	free(_memory);
+#endif
+}
+#endif
+
+/*
+	Replacements of the global operator new and delete: the plain, nothrow and sized variants
+	and, where the compiler has aligned new (C++17), the std::align_val_t variants of all of them
+	Placement new does not allocate and is not replaced
+*/
+void* operator new(size_t _size)
+{
+	void* memory = TrackedAllocate(_size);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t _size)
+{
+	void* memory = TrackedAllocate(_size);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new(size_t _size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(_size);
+}
+
+void* operator new[](size_t _size, const std::nothrow_t&) noexcept
+{
+	return TrackedAllocate(_size);
+}
+
+void operator delete(void* _memory) noexcept
+{
+	TrackedFree(_memory);
+}
+
+void operator delete[](void* _memory) noexcept
+{
+	TrackedFree(_memory);
+}
+
+void operator delete(void* _memory, size_t) noexcept
+{
+	TrackedFree(_memory);
+}
+
+void operator delete[](void* _memory, size_t) noexcept
+{
+	TrackedFree(_memory);
+}
+
+void operator delete(void* _memory, const std::nothrow_t&) noexcept
+{
+	TrackedFree(_memory);
+}
+
+void operator delete[](void* _memory, const std::nothrow_t&) noexcept
+{
+	TrackedFree(_memory);
+}
+
+#ifdef __cpp_aligned_new
+void* operator new(size_t _size, std::align_val_t _alignment)
+{
+	void* memory = TrackedAlignedAllocate(_size, _alignment);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t _size, std::align_val_t _alignment)
+{
+	void* memory = TrackedAlignedAllocate(_size, _alignment);
+	if (!memory)
+	{
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new(size_t _size, std::align_val_t _alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAlignedAllocate(_size, _alignment);
+}
+
+void* operator new[](size_t _size, std::align_val_t _alignment, const std::nothrow_t&) noexcept
+{
+	return TrackedAlignedAllocate(_size, _alignment);
+}
+
+void operator delete(void* _memory, std::align_val_t) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+
+void operator delete[](void* _memory, std::align_val_t) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+
+void operator delete(void* _memory, size_t, std::align_val_t) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+
+void operator delete[](void* _memory, size_t, std::align_val_t) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+
+void operator delete(void* _memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+
+void operator delete[](void* _memory, std::align_val_t, const std::nothrow_t&) noexcept
+{
+	TrackedAlignedFree(_memory);
+}
+#endif
\ No newline at end of file
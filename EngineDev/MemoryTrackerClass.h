@@ -0,0 +1,21 @@
+#pragma once
+
+#pragma region includes
+#include "JobSystemClass.h"
+#pragma endregion
+
+/*
+	Counts every allocation which goes through the global operator new/delete of the engine
+	Used to check how many heap allocations happen inside a frame, the frame code is supposed to use the frame and pool allocators
+	Background jobs (pipeline compilation, asset loading) may allocate while a frame runs, GetForegroundAllocationCount leaves them out
+	Allocations of the operating system or the graphics driver (HeapAlloc, malloc) are not counted
+*/
+class MemoryTrackerClass
+{
+public:
+	static unsigned long long GetAllocationCount();
+	static unsigned long long GetForegroundAllocationCount();
+	static unsigned long long GetFreeCount();
+	static unsigned long long GetAllocatedBytes();
+	static unsigned long long GetLiveAllocationCount();
+};
\ No newline at end of file
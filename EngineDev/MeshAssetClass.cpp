@@ -0,0 +1,198 @@
+#include "MeshAssetClass.h"
+#include <cmath>
+#include <cstring>
+
+/*
+	Check type, version and that every array lies inside the asset
+	Returns nullptr for anything which is not a valid mesh
+*/
+const MeshAssetHeader* MeshAssetClass::Get(const AssetHeader* _asset)
+{
+	if (!_asset || _asset->type != ASSET_TYPE_MESH || _asset->version != MESH_ASSET_VERSION || _asset->size < sizeof(MeshAssetHeader))
+	{
+		return nullptr;
+	}
+
+	const MeshAssetHeader* mesh = reinterpret_cast<const MeshAssetHeader*>(_asset);
+	if ((mesh->indexSize != 2 && mesh->indexSize != 4) || mesh->indexCount % 3 != 0 || mesh->lodCount == 0 || mesh->lodCount > MESH_MAX_LODS)
+	{
+		return nullptr;
+	}
+
+	for (unsigned int i = 0; i < mesh->lodCount; i++)
+	{
+		const MeshLod& lod = mesh->lods[i];
+		if (lod.indexCount % 3 != 0 || lod.firstIndex > mesh->indexCount || lod.indexCount > mesh->indexCount - lod.firstIndex)
+		{
+			return nullptr;
+		}
+	}
+
+	unsigned long long offsets[] = { mesh->vertexOffset, mesh->indexOffset, mesh->meshletOffset, mesh->meshletVertexOffset, mesh->meshletTriangleOffset };
+	unsigned long long sizes[] = {
+		static_cast<unsigned long long>(mesh->vertexCount) * sizeof(MeshVertex),
+		static_cast<unsigned long long>(mesh->indexCount) * mesh->indexSize,
+		static_cast<unsigned long long>(mesh->meshletCount) * sizeof(Meshlet),
+		static_cast<unsigned long long>(mesh->meshletVertexCount) * sizeof(unsigned int),
+		static_cast<unsigned long long>(mesh->meshletTriangleCount) * 3 };
+
+	for (unsigned int i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++)
+	{
+		if (offsets[i] % MESH_ASSET_ARRAY_ALIGNMENT != 0 || offsets[i] < sizeof(MeshAssetHeader) || offsets[i] > _asset->size || sizes[i] > _asset->size - offsets[i])
+		{
+			return nullptr;
+		}
+	}
+
+	return mesh;
+}
+
+/*
+	The position is stored as fraction of the bounds
+*/
+Vector3 MeshAssetClass::DecodePosition(const MeshAssetHeader& _mesh, const MeshVertex& _vertex)
+{
+	Vector3 position;
+	float* components = &position.x;
+
+	for (int i = 0; i < 3; i++)
+	{
+		float fraction = static_cast<float>(_vertex.position[i]) / 65535.0f;
+		components[i] = _mesh.boundsMinimum[i] + fraction * (_mesh.boundsMaximum[i] - _mesh.boundsMinimum[i]);
+	}
+
+	return position;
+}
+
+/*
+	Octahedral decoding: the lower half of the octahedron is folded over the diagonals
+*/
+Vector3 MeshAssetClass::DecodeNormal(const MeshVertex& _vertex)
+{
+	float x = static_cast<float>(_vertex.normal[0]) / 32767.0f;
+	float y = static_cast<float>(_vertex.normal[1]) / 32767.0f;
+	float z = 1.0f - fabsf(x) - fabsf(y);
+
+	if (z < 0.0f)
+	{
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		float foldedY = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+		y = foldedY;
+	}
+
+	return MathClass::Normalize(Vector3{ x, y, z });
+}
+
+void MeshAssetClass::DecodeTexcoord(const MeshVertex& _vertex, float& _u, float& _v)
+{
+	_u = HalfToFloat(_vertex.texcoord[0]);
+	_v = HalfToFloat(_vertex.texcoord[1]);
+}
+
+unsigned int MeshAssetClass::GetIndex(const MeshAssetHeader& _mesh, unsigned int _index)
+{
+	if (_mesh.indexSize == 2)
+	{
+		return GetAssetArray<unsigned short>(&_mesh.header, _mesh.indexOffset)[_index];
+	}
+
+	return GetAssetArray<unsigned int>(&_mesh.header, _mesh.indexOffset)[_index];
+}
+
+/*
+	IEEE 754 half precision to single precision, denormals included
+*/
+float MeshAssetClass::HalfToFloat(unsigned short _half)
+{
+	unsigned int sign = static_cast<unsigned int>(_half & 0x8000) << 16;
+	unsigned int exponent = (_half >> 10) & 0x1F;
+	unsigned int mantissa = _half & 0x3FF;
+	unsigned int bits;
+
+	if (exponent == 0)
+	{
+		if (mantissa == 0)
+		{
+			bits = sign;
+		}
+		else
+		{
+			//	Denormal, shift the mantissa up until it is normalized
+			exponent = 127 - 15 + 1;
+			while ((mantissa & 0x400) == 0)
+			{
+				mantissa <<= 1;
+				exponent--;
+			}
+			bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+		}
+	}
+	else if (exponent == 31)
+	{
+		bits = sign | 0x7F800000 | (mantissa << 13);
+	}
+	else
+	{
+		bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+
+	float value;
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+/*
+	Single precision to half precision, rounded to nearest even, too big values become infinity
+*/
+unsigned short MeshAssetClass::FloatToHalf(float _value)
+{
+	unsigned int bits;
+	memcpy(&bits, &_value, sizeof(bits));
+
+	unsigned short sign = static_cast<unsigned short>((bits >> 16) & 0x8000);
+	int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127 + 15;
+	unsigned int mantissa = bits & 0x7FFFFF;
+
+	if (((bits >> 23) & 0xFF) == 0xFF)
+	{
+		return static_cast<unsigned short>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+	}
+
+	if (exponent >= 31)
+	{
+		return static_cast<unsigned short>(sign | 0x7C00);
+	}
+
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+		{
+			return sign;
+		}
+
+		//	Denormal, make the implicit bit explicit and shift it into place
+		mantissa |= 0x800000;
+		unsigned int shift = static_cast<unsigned int>(14 - exponent);
+		unsigned int halfMantissa = mantissa >> shift;
+		unsigned int remainder = mantissa & ((1u << shift) - 1);
+		unsigned int halfway = 1u << (shift - 1);
+		if (remainder > halfway || (remainder == halfway && (halfMantissa & 1)))
+		{
+			halfMantissa++;
+		}
+
+		return static_cast<unsigned short>(sign | halfMantissa);
+	}
+
+	unsigned int half = (static_cast<unsigned int>(exponent) << 10) | (mantissa >> 13);
+	unsigned int remainder = mantissa & 0x1FFF;
+	if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))
+	{
+		//	May carry into the exponent, which is still correct (up to infinity)
+		half++;
+	}
+
+	return static_cast<unsigned short>(sign | half);
+}
\ No newline at end of file
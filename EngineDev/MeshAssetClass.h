@@ -0,0 +1,100 @@
+#pragma once
+
+#pragma region includes
+#include "AssetPackageClass.h"
+#include "MathClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int ASSET_TYPE_MESH = 1;
+const unsigned int MESH_ASSET_VERSION = 2;
+const unsigned int MESHLET_MAX_VERTICES = 64;
+const unsigned int MESHLET_MAX_TRIANGLES = 124;
+const size_t MESH_ASSET_ARRAY_ALIGNMENT = 16;
+const unsigned int MESH_MAX_LODS = 8;
+#pragma endregion
+
+/*
+	16 bytes per vertex, copied into the vertex buffer as it is
+	position: R16G16B16A16_UNORM inside the bounds of the mesh, w is 0
+	normal: R16G16_SNORM, octahedral encoding of the unit normal
+	texcoord: R16G16_FLOAT
+*/
+struct MeshVertex
+{
+	unsigned short position[4];
+	short normal[2];
+	unsigned short texcoord[2];
+};
+
+/*
+	Up to MESHLET_MAX_VERTICES vertices and MESHLET_MAX_TRIANGLES triangles of the mesh
+	Its triangles index its vertices (3 bytes per triangle), its vertices index the vertices of the mesh
+	The bounding sphere is in the space of the mesh
+*/
+struct Meshlet
+{
+	unsigned int vertexOffset;		// into the meshlet vertices
+	unsigned int triangleOffset;	// into the meshlet triangles, in triangles
+	unsigned int vertexCount;
+	unsigned int triangleCount;
+	float center[3];
+	float radius;
+};
+
+/*
+	Triangles of one level of detail, a range of the index buffer
+	error: how far the simplified surface may be from the full one, in the units of the mesh (0 for the full mesh)
+*/
+struct MeshLod
+{
+	unsigned int firstIndex;
+	unsigned int indexCount;
+	float error;
+	unsigned int padding;
+};
+
+/*
+	A cooked mesh (AssetCooker), all arrays follow the header, each at an offset aligned to MESH_ASSET_ARRAY_ALIGNMENT
+	The indices are triangle lists ordered for the post-transform vertex cache, the vertices are ordered by their first use
+	The index buffer holds every level of detail one after the other, all of them use the same vertices
+	lods[0] is the full mesh, the errors grow from level to level, the meshlets only cover the full mesh
+*/
+struct MeshAssetHeader
+{
+	AssetHeader header;
+	float boundsMinimum[3];
+	float boundsMaximum[3];
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	unsigned int indexSize;					// 2 or 4 bytes
+	unsigned int meshletCount;
+	unsigned int meshletVertexCount;
+	unsigned int meshletTriangleCount;
+	unsigned int lodCount;
+	MeshLod lods[MESH_MAX_LODS];
+	unsigned long long vertexOffset;		// MeshVertex[vertexCount]
+	unsigned long long indexOffset;			// indexCount indices of indexSize bytes, all levels of detail
+	unsigned long long meshletOffset;		// Meshlet[meshletCount]
+	unsigned long long meshletVertexOffset;		// unsigned int[meshletVertexCount]
+	unsigned long long meshletTriangleOffset;	// unsigned char[meshletTriangleCount * 3]
+};
+
+/*
+	Reads cooked meshes in place
+	Get checks the header once, the arrays can be used without further checks afterwards
+	The decode functions turn the quantized attributes back into floats, the same way the shaders do
+*/
+class MeshAssetClass
+{
+public:
+	static const MeshAssetHeader* Get(const AssetHeader* _asset);
+
+	static Vector3 DecodePosition(const MeshAssetHeader& _mesh, const MeshVertex& _vertex);
+	static Vector3 DecodeNormal(const MeshVertex& _vertex);
+	static void DecodeTexcoord(const MeshVertex& _vertex, float& _u, float& _v);
+	static unsigned int GetIndex(const MeshAssetHeader& _mesh, unsigned int _index);
+
+	static float HalfToFloat(unsigned short _half);
+	static unsigned short FloatToHalf(float _value);
+};
\ No newline at end of file
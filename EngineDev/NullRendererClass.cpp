@@ -0,0 +1,358 @@
+#include "NullRendererClass.h"
+#include "ProfilerClass.h"
+#include "TimerClass.h"
+#include <chrono>
+#include <thread>
+
+#pragma region Globals
+static const float NULL_CLEAR_COLOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+#pragma endregion
+
+/*
+	Constructor
+*/
+NullRendererClass::NullRendererClass()
+{
+	m_screenHeight = 0;
+	m_screenWidth = 0;
+	m_renderedFrames = 0;
+	m_drawBatcher = nullptr;
+	m_simulatedGpuTime = 0;
+	m_lastReadyTime = 0;
+}
+
+/*
+	Destructor
+*/
+NullRendererClass::~NullRendererClass()
+{
+
+}
+
+/*
+	There is no device to create, just remember the size of the offscreen target
+	Setup the frames in flight with the simulated fence
+	Setup the GPU timer with the simulated timestamp queries
+	Setup the pipeline cache without a file, the simulated pipelines are not worth keeping
+	Setup the command capture with a single stream, the passes are recorded one after another
+	Setup the simulated display, it supports tearing so every present mode works
+*/
+bool NullRendererClass::Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem)
+{
+	PROFILE_SCOPE("NullRendererClass::Initialize");
+
+	m_screenHeight = _screenHeight;
+	m_screenWidth = _screenWidth;
+	m_renderedFrames = 0;
+
+	if (!m_frameRing.Initialize(&m_fence, _framesInFlight))
+	{
+		return false;
+	}
+
+	if (!m_timestampQueries.Initialize(GPU_TIMER_QUERY_COUNT))
+	{
+		return false;
+	}
+
+	if (!m_commandRecorder.Initialize(&m_timestampQueries))
+	{
+		return false;
+	}
+
+	if (!m_gpuTimer.Initialize(&m_timestampQueries))
+	{
+		return false;
+	}
+
+	if (!m_pipelineCache.Initialize(&m_pipelineCompiler, _jobSystem, nullptr))
+	{
+		return false;
+	}
+
+	if (!m_commandCapture.Initialize(COMMAND_CAPTURE_FRAMES, 1, COMMAND_CAPTURE_STREAM_SIZE))
+	{
+		return false;
+	}
+
+	if (!m_presentPolicy.Initialize(_presentSettings, true))
+	{
+		return false;
+	}
+
+	if (!m_display.Initialize(&m_presentPolicy, _presentSettings.simulatedRefreshRate))
+	{
+		return false;
+	}
+
+	m_lastReadyTime = 0;
+
+	return true;
+}
+
+void NullRendererClass::Shutdown()
+{
+	m_frameRing.WaitForIdle();
+	m_frameRing.Shutdown();
+
+	m_pipelineCache.Shutdown();
+
+	m_display.Shutdown();
+	m_presentPolicy.Shutdown();
+
+	m_commandCapture.Shutdown();
+	m_gpuTimer.Shutdown();
+	m_commandRecorder.Shutdown();
+	m_timestampQueries.Shutdown();
+}
+
+/*
+	Run through the same synchronization as D3DClass::Render, the commands go to the simulated recorder
+	Execute every compiled pass of the render graph, each one timed as a zone of the GPU timer
+	The commands are captured on their way to the simulated recorder
+	Present the frame to the simulated display once it is submitted
+*/
+bool NullRendererClass::Render()
+{
+	PROFILE_SCOPE("NullRendererClass::Render");
+
+	if (!m_frameRing.BeginFrame())
+	{
+		return false;
+	}
+
+	m_gpuTimer.BeginFrame(m_frameRing.GetFrameIndex());
+
+	if (!BuildRenderGraph())
+	{
+		return false;
+	}
+
+	m_commandCapture.BeginFrame();
+	CommandRecorderClass* commandRecorder = m_commandCapture.GetRecorder(0, &m_commandRecorder);
+
+	unsigned int passCount = m_renderGraph.GetCompiledPassCount();
+	for (unsigned int i = 0; i < passCount; i++)
+	{
+		m_gpuTimer.BeginZone(commandRecorder, i, m_renderGraph.GetCompiledPassName(i));
+		m_renderGraph.ExecutePass(i, commandRecorder);
+		m_gpuTimer.EndZone(commandRecorder, i);
+	}
+
+	m_gpuTimer.Resolve(commandRecorder, passCount);
+
+	m_commandCapture.EndFrame();
+
+	m_renderedFrames++;
+
+	if (!m_frameRing.EndFrame())
+	{
+		return false;
+	}
+
+	Present();
+
+	return true;
+}
+
+/*
+	Sleep until the simulated display has room for the next present, like on the frame latency waitable object of a swap chain
+*/
+bool NullRendererClass::WaitForFrameLatency()
+{
+	PROFILE_SCOPE("NullRendererClass::WaitForFrameLatency");
+
+	unsigned long long now = TimerClass::GetMicroseconds();
+	unsigned long long startTime;
+	{
+		std::lock_guard<std::mutex> lock(m_displayMutex);
+		startTime = m_display.GetFrameStartTime(now);
+	}
+
+	if (startTime > now)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(startTime - now));
+	}
+
+	return true;
+}
+
+/*
+	The input time of the next present
+*/
+void NullRendererClass::BeginFrame(unsigned long long _inputTime)
+{
+	std::lock_guard<std::mutex> lock(m_displayMutex);
+	m_presentPolicy.BeginFrame(_inputTime);
+}
+
+/*
+	The batches of this draw batcher are recorded every frame, nullptr records no draws
+*/
+void NullRendererClass::SetDrawBatcher(const DrawBatcherClass* _drawBatcher)
+{
+	m_drawBatcher = _drawBatcher;
+}
+
+/*
+	Created on a background job by the pipeline cache, draws with the handle are skipped until it is ready
+*/
+unsigned int NullRendererClass::RequestPipeline(const PipelineDesc& _desc)
+{
+	return m_pipelineCache.Request(_desc);
+}
+
+const CommandCaptureClass* NullRendererClass::GetCommandCapture() const
+{
+	return &m_commandCapture;
+}
+
+const PresentPolicyClass* NullRendererClass::GetPresentPolicy() const
+{
+	return &m_presentPolicy;
+}
+
+/*
+	Set how long the simulated GPU needs for every frame
+*/
+void NullRendererClass::SetSimulatedGpuTime(double _milliseconds)
+{
+	m_fence.SetLatency(_milliseconds);
+	m_simulatedGpuTime = static_cast<unsigned long long>(_milliseconds * 1000.0);
+}
+
+const FrameRingClass& NullRendererClass::GetFrameRing() const
+{
+	return m_frameRing;
+}
+
+/*
+	Timings of the simulated GPU, a few frames old
+*/
+const GpuTimerClass& NullRendererClass::GetGpuTimer() const
+{
+	return m_gpuTimer;
+}
+
+/*
+	The queries, e.g. to replace their clock by a fake clock
+*/
+SimulatedTimestampQueriesClass& NullRendererClass::GetTimestampQueries()
+{
+	return m_timestampQueries;
+}
+
+const RenderGraphClass& NullRendererClass::GetRenderGraph() const
+{
+	return m_renderGraph;
+}
+
+/*
+	The recorder, e.g. to see how many barriers the frames recorded
+*/
+const SimulatedCommandRecorderClass& NullRendererClass::GetCommandRecorder() const
+{
+	return m_commandRecorder;
+}
+
+PipelineCacheClass& NullRendererClass::GetPipelineCache()
+{
+	return m_pipelineCache;
+}
+
+SimulatedPipelineCompilerClass& NullRendererClass::GetPipelineCompiler()
+{
+	return m_pipelineCompiler;
+}
+
+/*
+	The simulated GPU works on the frames one after another, the display gets the frame once the GPU finished it
+	Sleep if the present blocks because the queue of the display is full, as it does on a swap chain
+*/
+void NullRendererClass::Present()
+{
+	unsigned long long now = TimerClass::GetMicroseconds();
+	unsigned long long readyTime = (m_lastReadyTime > now ? m_lastReadyTime : now) + m_simulatedGpuTime;
+	m_lastReadyTime = readyTime;
+
+	unsigned long long returnTime;
+	{
+		std::lock_guard<std::mutex> lock(m_displayMutex);
+		returnTime = m_display.Present(m_presentPolicy.Present(), now, readyTime);
+	}
+
+	if (returnTime > now)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(returnTime - now));
+	}
+}
+
+/*
+	Same passes as D3DClass::BuildRenderGraph, without a back buffer
+	The clear and the geometry pass record the same commands as in D3DClass, into the simulated recorder
+*/
+bool NullRendererClass::BuildRenderGraph()
+{
+	m_renderGraph.Reset();
+
+	unsigned int backBuffer = m_renderGraph.ImportResource("BackBuffer", nullptr, RESOURCE_STATE_PRESENT, RESOURCE_STATE_PRESENT);
+
+	unsigned int clearPass = m_renderGraph.AddPass("ClearPass", ClearPass, this);
+	if (!m_renderGraph.Write(clearPass, backBuffer, RESOURCE_STATE_RENDER_TARGET))
+	{
+		return false;
+	}
+
+	if (m_drawBatcher && m_drawBatcher->GetBatchCount() > 0)
+	{
+		unsigned int geometryPass = m_renderGraph.AddPass("GeometryPass", GeometryPass, this);
+		if (!m_renderGraph.Write(geometryPass, backBuffer, RESOURCE_STATE_RENDER_TARGET))
+		{
+			return false;
+		}
+	}
+
+	unsigned int presentPass = m_renderGraph.AddPass("PresentPass", nullptr, nullptr, true);
+	if (!m_renderGraph.Read(presentPass, backBuffer, RESOURCE_STATE_PRESENT))
+	{
+		return false;
+	}
+
+	return m_renderGraph.Compile();
+}
+
+/*
+	There is no back buffer, its view has neither a resource nor a descriptor
+*/
+RenderTargetView NullRendererClass::GetBackBufferView() const
+{
+	RenderTargetView view;
+	view.resource = nullptr;
+	view.descriptor = 0;
+
+	return view;
+}
+
+/*
+	Clear the back buffer, _data is the NullRendererClass
+*/
+void NullRendererClass::ClearPass(CommandRecorderClass* _recorder, void* _data)
+{
+	NullRendererClass* nullRenderer = static_cast<NullRendererClass*>(_data);
+	RenderTargetView backBuffer = nullRenderer->GetBackBufferView();
+
+	_recorder->SetRenderTarget(backBuffer, static_cast<unsigned int>(nullRenderer->m_screenWidth), static_cast<unsigned int>(nullRenderer->m_screenHeight));
+	_recorder->ClearRenderTarget(backBuffer, NULL_CLEAR_COLOR);
+}
+
+/*
+	Record the batches of the draw batcher into the back buffer, _data is the NullRendererClass
+*/
+void NullRendererClass::GeometryPass(CommandRecorderClass* _recorder, void* _data)
+{
+	NullRendererClass* nullRenderer = static_cast<NullRendererClass*>(_data);
+
+	_recorder->SetRenderTarget(nullRenderer->GetBackBufferView(), static_cast<unsigned int>(nullRenderer->m_screenWidth), static_cast<unsigned int>(nullRenderer->m_screenHeight));
+
+	nullRenderer->m_drawBatcher->Record(_recorder, nullRenderer->m_pipelineCache);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+
+#pragma region includes
+#include "RendererClass.h"
+#include "SimulatedFenceClass.h"
+#include "FrameRingClass.h"
+#include "SimulatedTimestampQueriesClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include "GpuTimerClass.h"
+#include "RenderGraphClass.h"
+#include "SimulatedPipelineCompilerClass.h"
+#include "PipelineCacheClass.h"
+#include "CommandCaptureClass.h"
+#include "PresentPolicyClass.h"
+#include "SimulatedDisplayClass.h"
+#include <mutex>
+#pragma endregion
+
+/*
+	Backend which does not talk to any graphics API
+	Runs the same frame cycle as D3DClass so the CPU side of the engine can be driven and measured headless
+	The GPU is simulated by a fence with a configurable latency per frame, so the frames in flight behave like on a real GPU
+	The GPU timer runs on simulated timestamp queries, so its results arrive as late as they would with a real GPU
+	The frame is described by the same render graph as in D3DClass, the simulated recorder counts its barriers
+	Pipelines are created by a simulated compiler and are not persisted, headless runs never write a cache file
+	The batches of the draw batcher are recorded in the geometry pass, the simulated recorder counts their state changes and draws
+	The commands of the last COMMAND_CAPTURE_FRAMES frames are captured, all passes into one stream
+	The frames are presented to a simulated display on the real clock, which paces the frames like a swap chain with its refresh rate
+	Without a refresh rate the frames are shown as soon as the simulated GPU finished them, so headless runs stay unthrottled
+*/
+class NullRendererClass : public RendererClass
+{
+public:
+	NullRendererClass();
+	~NullRendererClass();
+
+	bool Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem) override;
+	void Shutdown() override;
+
+	bool Render() override;
+	bool WaitForFrameLatency() override;
+	void BeginFrame(unsigned long long _inputTime) override;
+	void SetDrawBatcher(const DrawBatcherClass* _drawBatcher) override;
+	unsigned int RequestPipeline(const PipelineDesc& _desc) override;
+	const CommandCaptureClass* GetCommandCapture() const override;
+	const PresentPolicyClass* GetPresentPolicy() const override;
+
+	void SetSimulatedGpuTime(double _milliseconds);
+	const FrameRingClass& GetFrameRing() const;
+	const GpuTimerClass& GetGpuTimer() const;
+	SimulatedTimestampQueriesClass& GetTimestampQueries();
+	const RenderGraphClass& GetRenderGraph() const;
+	const SimulatedCommandRecorderClass& GetCommandRecorder() const;
+	PipelineCacheClass& GetPipelineCache();
+	SimulatedPipelineCompilerClass& GetPipelineCompiler();
+
+private:
+	int m_screenHeight;
+	int m_screenWidth;
+	unsigned long long m_renderedFrames;
+
+	SimulatedFenceClass m_fence;
+	FrameRingClass m_frameRing;
+
+	SimulatedTimestampQueriesClass m_timestampQueries;
+	SimulatedCommandRecorderClass m_commandRecorder;
+	GpuTimerClass m_gpuTimer;
+
+	RenderGraphClass m_renderGraph;
+
+	SimulatedPipelineCompilerClass m_pipelineCompiler;
+	PipelineCacheClass m_pipelineCache;
+
+	const DrawBatcherClass* m_drawBatcher;
+
+	CommandCaptureClass m_commandCapture;
+
+	PresentPolicyClass m_presentPolicy;
+	SimulatedDisplayClass m_display;
+	std::mutex m_displayMutex;					// WaitForFrameLatency may run on the simulation thread while the render thread presents
+	unsigned long long m_simulatedGpuTime;		// microseconds
+	unsigned long long m_lastReadyTime;			// when the simulated GPU finishes the last presented frame
+
+	void Present();
+	bool BuildRenderGraph();
+	RenderTargetView GetBackBufferView() const;
+	static void ClearPass(CommandRecorderClass* _recorder, void* _data);
+	static void GeometryPass(CommandRecorderClass* _recorder, void* _data);
+};
\ No newline at end of file
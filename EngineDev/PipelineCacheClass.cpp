@@ -0,0 +1,383 @@
+#include "PipelineCacheClass.h"
+#include "HashClass.h"
+#include "ProfilerClass.h"
+#include <algorithm>
+#include <thread>
+
+/*
+	Constructor
+*/
+PipelineCacheClass::PipelineCacheClass()
+{
+	m_compiler = nullptr;
+	m_jobSystem = nullptr;
+	m_path = nullptr;
+	m_compilerVersion = 0;
+	m_pipelines = nullptr;
+	m_pipelineCount = 0;
+	m_pendingPipelines.store(0);
+	m_requestCount.store(0);
+	m_compileCount.store(0);
+	m_diskHitCount.store(0);
+}
+
+/*
+	Destructor
+*/
+PipelineCacheClass::~PipelineCacheClass()
+{
+
+}
+
+/*
+	Allocate the pipelines once and clear the lookup table
+	Open the disk cache of the last run, without a path (or without a valid file) every pipeline is compiled
+	Without a jobsystem the pipelines are created right in Request
+*/
+bool PipelineCacheClass::Initialize(PipelineCompilerClass* _compiler, JobSystemClass* _jobSystem, const char* _path)
+{
+	PROFILE_SCOPE("PipelineCacheClass::Initialize");
+
+	if (!_compiler)
+	{
+		return false;
+	}
+
+	m_compiler = _compiler;
+	m_jobSystem = _jobSystem;
+	m_path = _path;
+	m_compilerVersion = m_compiler->GetCacheVersion();
+
+	m_pipelines = new CachedPipeline[MAX_PIPELINES];
+	if (!m_pipelines)
+	{
+		return false;
+	}
+
+	//	Handles may be checked without the lock, so every slot has a valid state before it is handed out
+	m_pipelineCount = 0;
+	for (unsigned int i = 0; i < MAX_PIPELINES; i++)
+	{
+		m_pipelines[i].pipeline = nullptr;
+		m_pipelines[i].blob = nullptr;
+		m_pipelines[i].state.store(PIPELINE_STATE_FAILED);
+	}
+
+	for (unsigned int i = 0; i < PIPELINE_TABLE_SIZE; i++)
+	{
+		m_table[i] = INVALID_PIPELINE;
+	}
+
+	if (m_path)
+	{
+		//	A missing or outdated file only means a cold start
+		m_diskCache.Open(m_path, m_compilerVersion);
+	}
+
+	return true;
+}
+
+/*
+	Wait for the pipelines which are still being created, save the new ones and release everything
+*/
+void PipelineCacheClass::Shutdown()
+{
+	if (!m_pipelines)
+	{
+		return;
+	}
+
+	WaitForAll();
+	Save();
+
+	for (unsigned int i = 0; i < m_pipelineCount; i++)
+	{
+		if (m_pipelines[i].pipeline)
+		{
+			m_compiler->ReleasePipeline(m_pipelines[i].pipeline);
+		}
+
+		delete[] m_pipelines[i].blob;
+	}
+
+	m_diskCache.Close();
+
+	delete[] m_pipelines;
+	m_pipelines = nullptr;
+	m_pipelineCount = 0;
+	m_compiler = nullptr;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Find the description in the table: probe from its hash, compare the whole description only if the hash matches
+	If it is new, add it and queue a background job to create it
+	Returns the handle of the pipeline or INVALID_PIPELINE if the cache is full
+*/
+unsigned int PipelineCacheClass::Request(const PipelineDesc& _desc)
+{
+	unsigned long long hash = Hash(_desc);
+	unsigned int pipeline = INVALID_PIPELINE;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_requestCount.fetch_add(1);
+
+		unsigned int slot = static_cast<unsigned int>(hash) & (PIPELINE_TABLE_SIZE - 1);
+		while (m_table[slot] != INVALID_PIPELINE)
+		{
+			const CachedPipeline& cachedPipeline = m_pipelines[m_table[slot]];
+			if (cachedPipeline.hash == hash && memcmp(&cachedPipeline.desc, &_desc, sizeof(PipelineDesc)) == 0)
+			{
+				return m_table[slot];
+			}
+
+			slot = (slot + 1) & (PIPELINE_TABLE_SIZE - 1);
+		}
+
+		if (m_pipelineCount == MAX_PIPELINES)
+		{
+			return INVALID_PIPELINE;
+		}
+
+		pipeline = m_pipelineCount++;
+		m_table[slot] = pipeline;
+
+		CachedPipeline& cachedPipeline = m_pipelines[pipeline];
+		cachedPipeline.desc = _desc;
+		cachedPipeline.hash = hash;
+		cachedPipeline.diskKey = 0;
+		cachedPipeline.pipeline = nullptr;
+		cachedPipeline.blob = nullptr;
+		cachedPipeline.blobSize = 0;
+		cachedPipeline.state.store(PIPELINE_STATE_COMPILING);
+	}
+
+	m_pendingPipelines.fetch_add(1);
+
+	if (!m_jobSystem || !m_jobSystem->RunBackground(CreatePipelineJob, this, pipeline, pipeline + 1, nullptr))
+	{
+		CreatePipeline(pipeline);
+	}
+
+	return pipeline;
+}
+
+/*
+	The pipeline of the graphics API, nullptr while it is being created or if it failed
+*/
+void* PipelineCacheClass::GetPipeline(unsigned int _pipeline) const
+{
+	if (_pipeline >= MAX_PIPELINES || m_pipelines[_pipeline].state.load(std::memory_order_acquire) != PIPELINE_STATE_READY)
+	{
+		return nullptr;
+	}
+
+	return m_pipelines[_pipeline].pipeline;
+}
+
+unsigned int PipelineCacheClass::GetState(unsigned int _pipeline) const
+{
+	if (_pipeline >= MAX_PIPELINES)
+	{
+		return PIPELINE_STATE_FAILED;
+	}
+
+	return m_pipelines[_pipeline].state.load(std::memory_order_acquire);
+}
+
+/*
+	Block until the pipeline is created, for loading screens and the startup, never during a frame
+*/
+void PipelineCacheClass::Wait(unsigned int _pipeline)
+{
+	if (_pipeline >= MAX_PIPELINES)
+	{
+		return;
+	}
+
+	while (m_pipelines[_pipeline].state.load(std::memory_order_acquire) == PIPELINE_STATE_COMPILING)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/*
+	Block until every requested pipeline is created
+*/
+void PipelineCacheClass::WaitForAll()
+{
+	while (m_pendingPipelines.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+}
+
+/*
+	Write the blobs compiled in this run and the entries of the old file into a new file, sorted by key
+	A compiled blob replaces an old one with the same key (the driver rejected the old one)
+	Nothing is written if nothing new was compiled
+	No pipeline may be requested while saving, the disk cache is reopened
+*/
+bool PipelineCacheClass::Save()
+{
+	PROFILE_SCOPE("PipelineCacheClass::Save");
+
+	if (!m_path || !m_pipelines)
+	{
+		return false;
+	}
+
+	WaitForAll();
+
+	unsigned int newBlobCount = 0;
+	for (unsigned int i = 0; i < m_pipelineCount; i++)
+	{
+		if (m_pipelines[i].blob)
+		{
+			newBlobCount++;
+		}
+	}
+
+	if (newBlobCount == 0)
+	{
+		return true;
+	}
+
+	unsigned int oldBlobCount = m_diskCache.GetEntryCount();
+	PipelineCacheBlob* blobs = new PipelineCacheBlob[newBlobCount + oldBlobCount];
+	if (!blobs)
+	{
+		return false;
+	}
+
+	unsigned int blobCount = 0;
+	for (unsigned int i = 0; i < m_pipelineCount; i++)
+	{
+		if (m_pipelines[i].blob)
+		{
+			blobs[blobCount].key = m_pipelines[i].diskKey;
+			blobs[blobCount].data = m_pipelines[i].blob;
+			blobs[blobCount].size = m_pipelines[i].blobSize;
+			blobCount++;
+		}
+	}
+
+	for (unsigned int i = 0; i < oldBlobCount; i++)
+	{
+		blobs[blobCount++] = m_diskCache.GetBlob(i);
+	}
+
+	//	The sort is stable, so of two blobs with the same key the new one comes first and the old one is dropped
+	std::stable_sort(blobs, blobs + blobCount, [](const PipelineCacheBlob& _a, const PipelineCacheBlob& _b) { return _a.key < _b.key; });
+
+	unsigned int uniqueCount = 0;
+	for (unsigned int i = 0; i < blobCount; i++)
+	{
+		if (uniqueCount == 0 || blobs[uniqueCount - 1].key != blobs[i].key)
+		{
+			blobs[uniqueCount++] = blobs[i];
+		}
+	}
+
+	bool saved = m_diskCache.Save(m_path, m_compilerVersion, blobs, uniqueCount);
+
+	delete[] blobs;
+
+	//	The blobs are on disk now, open the new file so the next save keeps them
+	if (saved)
+	{
+		for (unsigned int i = 0; i < m_pipelineCount; i++)
+		{
+			delete[] m_pipelines[i].blob;
+			m_pipelines[i].blob = nullptr;
+			m_pipelines[i].blobSize = 0;
+		}
+
+		m_diskCache.Open(m_path, m_compilerVersion);
+	}
+
+	return saved;
+}
+
+/*
+	Hash over every byte of the description
+*/
+unsigned long long PipelineCacheClass::Hash(const PipelineDesc& _desc)
+{
+	return HashClass::Hash(&_desc, sizeof(PipelineDesc));
+}
+
+unsigned int PipelineCacheClass::GetPipelineCount() const
+{
+	return m_pipelineCount;
+}
+
+/*
+	Every call of Request, including the ones which found an existing pipeline
+*/
+unsigned long long PipelineCacheClass::GetRequestCount() const
+{
+	return m_requestCount.load();
+}
+
+/*
+	Pipelines which had to be compiled, the others came from the disk cache
+*/
+unsigned int PipelineCacheClass::GetCompileCount() const
+{
+	return m_compileCount.load();
+}
+
+unsigned int PipelineCacheClass::GetDiskHitCount() const
+{
+	return m_diskHitCount.load();
+}
+
+void PipelineCacheClass::CreatePipelineJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	PipelineCacheClass* pipelineCache = static_cast<PipelineCacheClass*>(_data);
+
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		pipelineCache->CreatePipeline(i);
+	}
+}
+
+/*
+	Build the key on disk from the description and the shader sources and look for a blob of an earlier run
+	Let the compiler create the pipeline, it falls back to compiling if there is no blob or the blob is rejected
+	Publish the pipeline with its state, GetPipeline reads it without the lock
+*/
+void PipelineCacheClass::CreatePipeline(unsigned int _pipeline)
+{
+	PROFILE_SCOPE("PipelineCacheClass::CreatePipeline");
+
+	CachedPipeline& cachedPipeline = m_pipelines[_pipeline];
+
+	cachedPipeline.diskKey = HashClass::Combine(cachedPipeline.hash, m_compiler->GetSourceHash(cachedPipeline.desc));
+
+	const void* cachedBlob = nullptr;
+	size_t cachedBlobSize = 0;
+	if (!m_diskCache.Find(cachedPipeline.diskKey, cachedBlob, cachedBlobSize))
+	{
+		cachedBlob = nullptr;
+		cachedBlobSize = 0;
+	}
+
+	cachedPipeline.pipeline = m_compiler->CreatePipeline(cachedPipeline.desc, cachedBlob, cachedBlobSize, cachedPipeline.blob, cachedPipeline.blobSize);
+
+	if (cachedPipeline.blob)
+	{
+		m_compileCount.fetch_add(1);
+	}
+	else if (cachedPipeline.pipeline)
+	{
+		m_diskHitCount.fetch_add(1);
+	}
+
+	cachedPipeline.state.store(cachedPipeline.pipeline ? PIPELINE_STATE_READY : PIPELINE_STATE_FAILED, std::memory_order_release);
+
+	m_pendingPipelines.fetch_sub(1);
+}
\ No newline at end of file
@@ -0,0 +1,85 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include <mutex>
+#include "PipelineCompilerClass.h"
+#include "PipelineDiskCacheClass.h"
+#include "JobSystemClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_PIPELINES = 1024;
+const unsigned int PIPELINE_TABLE_SIZE = MAX_PIPELINES * 2;		// open addressing, a power of two which stays at most half full
+const unsigned int INVALID_PIPELINE = 0xFFFFFFFF;
+
+const unsigned int PIPELINE_STATE_COMPILING = 0;
+const unsigned int PIPELINE_STATE_READY = 1;
+const unsigned int PIPELINE_STATE_FAILED = 2;
+
+const char* const PIPELINE_CACHE_PATH = "PipelineCache.bin";
+#pragma endregion
+
+/*
+	Creates every pipeline once, no matter how often it is requested
+	Request hashes the whole description and looks it up, a new description gets a handle right away and is created on a background job
+	The frame never waits: GetPipeline returns nullptr until the pipeline is ready, the caller skips its draws meanwhile
+	Pipelines are looked up on disk first (by the hash of the description and the shader sources), only misses are compiled
+	Shutdown writes the blobs of the newly compiled pipelines together with the old ones back to disk
+*/
+class PipelineCacheClass
+{
+public:
+	PipelineCacheClass();
+	~PipelineCacheClass();
+
+	bool Initialize(PipelineCompilerClass* _compiler, JobSystemClass* _jobSystem, const char* _path);
+	void Shutdown();
+
+	unsigned int Request(const PipelineDesc& _desc);
+	void* GetPipeline(unsigned int _pipeline) const;
+	unsigned int GetState(unsigned int _pipeline) const;
+
+	void Wait(unsigned int _pipeline);
+	void WaitForAll();
+	bool Save();
+
+	static unsigned long long Hash(const PipelineDesc& _desc);
+
+	unsigned int GetPipelineCount() const;
+	unsigned long long GetRequestCount() const;
+	unsigned int GetCompileCount() const;
+	unsigned int GetDiskHitCount() const;
+
+private:
+	struct CachedPipeline
+	{
+		PipelineDesc desc;
+		unsigned long long hash;
+		unsigned long long diskKey;
+		void* pipeline;
+		unsigned char* blob;		// only for pipelines compiled in this run, written on Save
+		size_t blobSize;
+		std::atomic<unsigned int> state;
+	};
+
+	PipelineCompilerClass* m_compiler;
+	JobSystemClass* m_jobSystem;
+	const char* m_path;
+	unsigned long long m_compilerVersion;
+
+	PipelineDiskCacheClass m_diskCache;
+
+	CachedPipeline* m_pipelines;
+	unsigned int m_pipelineCount;
+	unsigned int m_table[PIPELINE_TABLE_SIZE];
+	std::mutex m_mutex;
+
+	JobCounter m_pendingPipelines;
+	std::atomic<unsigned long long> m_requestCount;
+	std::atomic<unsigned int> m_compileCount;
+	std::atomic<unsigned int> m_diskHitCount;
+
+	static void CreatePipelineJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	void CreatePipeline(unsigned int _pipeline);
+};
\ No newline at end of file
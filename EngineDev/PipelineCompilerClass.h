@@ -0,0 +1,101 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include <cstring>
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_SHADER_PATH = 128;
+const unsigned int MAX_SHADER_ENTRY_POINT = 32;
+const unsigned int MAX_VERTEX_SEMANTIC = 16;
+const unsigned int MAX_PIPELINE_VERTEX_ELEMENTS = 8;
+const unsigned int MAX_PIPELINE_RENDER_TARGETS = 8;
+
+//	Portable pipeline states, the backends map them to their graphics API
+const unsigned int PIPELINE_TOPOLOGY_TRIANGLE = 0;
+const unsigned int PIPELINE_TOPOLOGY_LINE = 1;
+const unsigned int PIPELINE_TOPOLOGY_POINT = 2;
+
+const unsigned int PIPELINE_FILL_SOLID = 0;
+const unsigned int PIPELINE_FILL_WIREFRAME = 1;
+
+const unsigned int PIPELINE_CULL_BACK = 0;
+const unsigned int PIPELINE_CULL_FRONT = 1;
+const unsigned int PIPELINE_CULL_NONE = 2;
+
+const unsigned int PIPELINE_BLEND_OPAQUE = 0;
+const unsigned int PIPELINE_BLEND_ALPHA = 1;
+const unsigned int PIPELINE_BLEND_ADDITIVE = 2;
+
+const unsigned int PIPELINE_DEPTH_NONE = 0;
+const unsigned int PIPELINE_DEPTH_READ_WRITE = 1;	// less, writes depth
+const unsigned int PIPELINE_DEPTH_READ = 2;			// less equal, depth is read-only
+#pragma endregion
+
+struct PipelineVertexElement
+{
+	char semantic[MAX_VERTEX_SEMANTIC];
+	unsigned int semanticIndex;
+	unsigned int format;		// DXGI_FORMAT value
+	unsigned int inputSlot;
+	unsigned int offset;
+};
+
+/*
+	Everything which makes up a graphics pipeline
+	Hashed and compared bytewise, so every unused byte stays 0 (the constructor clears everything)
+	Only unsigned ints and char arrays, so there is no padding with garbage in it
+	Formats are DXGI_FORMAT values, the simulated backend only treats them as numbers
+*/
+struct PipelineDesc
+{
+	char vertexShader[MAX_SHADER_PATH];
+	char vertexEntryPoint[MAX_SHADER_ENTRY_POINT];
+	char pixelShader[MAX_SHADER_PATH];
+	char pixelEntryPoint[MAX_SHADER_ENTRY_POINT];
+
+	PipelineVertexElement vertexElements[MAX_PIPELINE_VERTEX_ELEMENTS];
+	unsigned int vertexElementCount;
+	unsigned int topology;
+
+	unsigned int renderTargetFormats[MAX_PIPELINE_RENDER_TARGETS];
+	unsigned int renderTargetCount;
+	unsigned int depthFormat;
+	unsigned int sampleCount;
+
+	unsigned int fillMode;
+	unsigned int cullMode;
+	unsigned int blendMode;
+	unsigned int depthMode;
+
+	PipelineDesc()
+	{
+		memset(this, 0, sizeof(PipelineDesc));
+		sampleCount = 1;
+	}
+};
+
+/*
+	Base class for the backend which turns a PipelineDesc into a pipeline of the graphics API
+	Called from background jobs, several pipelines may be created at the same time
+	D3DPipelineCompilerClass compiles HLSL and creates PSOs, SimulatedPipelineCompilerClass spends a configurable time instead
+*/
+class PipelineCompilerClass
+{
+public:
+	virtual ~PipelineCompilerClass() {}
+
+	//	Identifies the driver and the compiler, blobs of another version are never handed to CreatePipeline
+	virtual unsigned long long GetCacheVersion() = 0;
+
+	//	Hash of the shader sources, part of the key on disk so edited shaders are compiled again
+	virtual unsigned long long GetSourceHash(const PipelineDesc& _desc) = 0;
+
+	//	Create the pipeline from the blob of an earlier run if there is one (_cachedBlob may be nullptr)
+	//	If the pipeline had to be compiled, _blob gets a new[] allocated blob for the disk cache which the caller delete[]s
+	//	Returns nullptr if the pipeline could not be created at all
+	virtual void* CreatePipeline(const PipelineDesc& _desc, const void* _cachedBlob, size_t _cachedBlobSize, unsigned char*& _blob, size_t& _blobSize) = 0;
+
+	virtual void ReleasePipeline(void* _pipeline) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,231 @@
+#include "PipelineDiskCacheClass.h"
+#include "HashClass.h"
+#include <cstdio>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned char PADDING[PIPELINE_CACHE_BLOB_ALIGNMENT] = {};
+#pragma endregion
+
+/*
+	Constructor
+*/
+PipelineDiskCacheClass::PipelineDiskCacheClass()
+{
+	m_entries = nullptr;
+	m_entryCount = 0;
+}
+
+/*
+	Destructor
+*/
+PipelineDiskCacheClass::~PipelineDiskCacheClass()
+{
+
+}
+
+/*
+	Map the file and check the header: magic, format and compiler version, size
+	Check the entry table against its hash, every entry has to lie inside the file
+	Nothing is read beyond the header and the table, the blobs are paged in when they are used
+*/
+bool PipelineDiskCacheClass::Open(const char* _path, unsigned long long _compilerVersion)
+{
+	Close();
+
+	if (!m_file.Open(_path))
+	{
+		return false;
+	}
+
+	const unsigned char* data = static_cast<const unsigned char*>(m_file.GetData());
+	size_t fileSize = m_file.GetSize();
+
+	if (fileSize < sizeof(PipelineCacheFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const PipelineCacheFileHeader* header = reinterpret_cast<const PipelineCacheFileHeader*>(data);
+	if (header->magic != PIPELINE_CACHE_MAGIC || header->formatVersion != PIPELINE_CACHE_FORMAT_VERSION ||
+		header->compilerVersion != _compilerVersion || header->fileSize != fileSize)
+	{
+		Close();
+		return false;
+	}
+
+	size_t tableSize = static_cast<size_t>(header->entryCount) * sizeof(PipelineCacheFileEntry);
+	if (header->entryCount > 0xFFFFFFFF || tableSize > fileSize - sizeof(PipelineCacheFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const PipelineCacheFileEntry* entries = reinterpret_cast<const PipelineCacheFileEntry*>(data + sizeof(PipelineCacheFileHeader));
+	if (HashClass::Hash(entries, tableSize) != header->entryHash)
+	{
+		Close();
+		return false;
+	}
+
+	for (unsigned long long i = 0; i < header->entryCount; i++)
+	{
+		if (entries[i].offset > fileSize || entries[i].size > fileSize - entries[i].offset || (i > 0 && entries[i - 1].key >= entries[i].key))
+		{
+			Close();
+			return false;
+		}
+	}
+
+	m_entries = entries;
+	m_entryCount = static_cast<unsigned int>(header->entryCount);
+
+	return true;
+}
+
+void PipelineDiskCacheClass::Close()
+{
+	m_file.Close();
+	m_entries = nullptr;
+	m_entryCount = 0;
+}
+
+/*
+	Binary search for the key, the blob is only returned if its hash matches
+*/
+bool PipelineDiskCacheClass::Find(unsigned long long _key, const void*& _blob, size_t& _blobSize) const
+{
+	unsigned int begin = 0;
+	unsigned int end = m_entryCount;
+
+	while (begin < end)
+	{
+		unsigned int middle = begin + (end - begin) / 2;
+
+		if (m_entries[middle].key < _key)
+		{
+			begin = middle + 1;
+		}
+		else
+		{
+			end = middle;
+		}
+	}
+
+	if (begin == m_entryCount || m_entries[begin].key != _key)
+	{
+		return false;
+	}
+
+	const PipelineCacheFileEntry& entry = m_entries[begin];
+	const unsigned char* blob = static_cast<const unsigned char*>(m_file.GetData()) + entry.offset;
+
+	if (HashClass::Hash(blob, static_cast<size_t>(entry.size)) != entry.blobHash)
+	{
+		return false;
+	}
+
+	_blob = blob;
+	_blobSize = static_cast<size_t>(entry.size);
+
+	return true;
+}
+
+unsigned int PipelineDiskCacheClass::GetEntryCount() const
+{
+	return m_entryCount;
+}
+
+/*
+	The blob of an entry as it is in the file, to carry it over into the next file
+*/
+PipelineCacheBlob PipelineDiskCacheClass::GetBlob(unsigned int _entry) const
+{
+	PipelineCacheBlob blob;
+	blob.key = m_entries[_entry].key;
+	blob.data = static_cast<const unsigned char*>(m_file.GetData()) + m_entries[_entry].offset;
+	blob.size = static_cast<size_t>(m_entries[_entry].size);
+
+	return blob;
+}
+
+/*
+	Write the blobs (sorted by key, no key twice) into a temporary file next to _path
+	The blobs may point into the mapped file, so it is only closed after the new file is complete
+	Then replace the old file, a crash while writing leaves the old file intact
+*/
+bool PipelineDiskCacheClass::Save(const char* _path, unsigned long long _compilerVersion, const PipelineCacheBlob* _blobs, unsigned int _blobCount)
+{
+	char temporaryPath[512];
+	if (snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", _path) >= static_cast<int>(sizeof(temporaryPath)))
+	{
+		return false;
+	}
+
+	FILE* file = fopen(temporaryPath, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	PipelineCacheFileEntry* entries = new PipelineCacheFileEntry[_blobCount > 0 ? _blobCount : 1];
+	if (!entries)
+	{
+		fclose(file);
+		return false;
+	}
+
+	//	Lay out the blobs behind the table
+	unsigned long long offset = sizeof(PipelineCacheFileHeader) + static_cast<unsigned long long>(_blobCount) * sizeof(PipelineCacheFileEntry);
+	for (unsigned int i = 0; i < _blobCount; i++)
+	{
+		offset = (offset + PIPELINE_CACHE_BLOB_ALIGNMENT - 1) & ~static_cast<unsigned long long>(PIPELINE_CACHE_BLOB_ALIGNMENT - 1);
+
+		entries[i].key = _blobs[i].key;
+		entries[i].offset = offset;
+		entries[i].size = _blobs[i].size;
+		entries[i].blobHash = HashClass::Hash(_blobs[i].data, _blobs[i].size);
+
+		offset += _blobs[i].size;
+	}
+
+	PipelineCacheFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = PIPELINE_CACHE_MAGIC;
+	header.formatVersion = PIPELINE_CACHE_FORMAT_VERSION;
+	header.compilerVersion = _compilerVersion;
+	header.entryCount = _blobCount;
+	header.fileSize = offset;
+	header.entryHash = HashClass::Hash(entries, static_cast<size_t>(_blobCount) * sizeof(PipelineCacheFileEntry));
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1;
+	written = written && (_blobCount == 0 || fwrite(entries, sizeof(PipelineCacheFileEntry), _blobCount, file) == _blobCount);
+
+	unsigned long long position = sizeof(PipelineCacheFileHeader) + static_cast<unsigned long long>(_blobCount) * sizeof(PipelineCacheFileEntry);
+	for (unsigned int i = 0; written && i < _blobCount; i++)
+	{
+		size_t padding = static_cast<size_t>(entries[i].offset - position);
+		written = (padding == 0 || fwrite(PADDING, 1, padding, file) == padding) && fwrite(_blobs[i].data, 1, _blobs[i].size, file) == _blobs[i].size;
+		position = entries[i].offset + entries[i].size;
+	}
+
+	delete[] entries;
+
+	if (fclose(file) != 0 || !written)
+	{
+		remove(temporaryPath);
+		return false;
+	}
+
+	Close();
+
+	//	rename does not replace existing files on every platform
+	remove(_path);
+	if (rename(temporaryPath, _path) != 0)
+	{
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MappedFileClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int PIPELINE_CACHE_MAGIC = 0x43505345;		// "ESPC"
+const unsigned int PIPELINE_CACHE_FORMAT_VERSION = 1;		// bump whenever the file layout or PipelineDesc changes
+const size_t PIPELINE_CACHE_BLOB_ALIGNMENT = 16;
+#pragma endregion
+
+struct PipelineCacheFileHeader
+{
+	unsigned int magic;
+	unsigned int formatVersion;
+	unsigned long long compilerVersion;		// PipelineCompilerClass::GetCacheVersion of the run which wrote the file
+	unsigned long long entryCount;
+	unsigned long long fileSize;
+	unsigned long long entryHash;			// hash over the entry table
+};
+
+struct PipelineCacheFileEntry
+{
+	unsigned long long key;
+	unsigned long long offset;		// from the start of the file, aligned to PIPELINE_CACHE_BLOB_ALIGNMENT
+	unsigned long long size;
+	unsigned long long blobHash;
+};
+
+/*
+	A blob to be written, data may point into the currently mapped file
+*/
+struct PipelineCacheBlob
+{
+	unsigned long long key;
+	const void* data;
+	size_t size;
+};
+
+/*
+	Pipeline blobs of earlier runs in a versioned file: header, entry table sorted by key, aligned blobs
+	The file is memory-mapped, looking up a blob is a binary search and the blob is used in place
+	A file of another format or compiler version, or with a broken entry table, is ignored as a whole
+	A blob whose hash does not match is ignored on its own
+	All values are stored little endian
+*/
+class PipelineDiskCacheClass
+{
+public:
+	PipelineDiskCacheClass();
+	~PipelineDiskCacheClass();
+
+	bool Open(const char* _path, unsigned long long _compilerVersion);
+	void Close();
+
+	bool Find(unsigned long long _key, const void*& _blob, size_t& _blobSize) const;
+
+	unsigned int GetEntryCount() const;
+	PipelineCacheBlob GetBlob(unsigned int _entry) const;
+
+	bool Save(const char* _path, unsigned long long _compilerVersion, const PipelineCacheBlob* _blobs, unsigned int _blobCount);
+
+private:
+	MappedFileClass m_file;
+	const PipelineCacheFileEntry* m_entries;
+	unsigned int m_entryCount;
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+
+#pragma region includes
+#include "InputClass.h"
+#pragma endregion
+
+/*
+	Base class for the operating system layer
+	A platform creates the surface we render to (if any), pumps the messages of the operating system and passes the input to the inputclass
+	The window handle is passed around as an opaque pointer so the systemclass and the graphicsclass do not depend on windows.h
+*/
+class PlatformClass
+{
+public:
+	virtual ~PlatformClass() {}
+
+	virtual bool Initialize(int& _screenHeight, int& _screenWidth, InputClass* _input) = 0;
+	virtual void Shutdown() = 0;
+	virtual bool PumpMessages() = 0;
+
+	virtual void* GetWindowHandle() const = 0;
+};
\ No newline at end of file
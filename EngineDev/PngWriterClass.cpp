@@ -0,0 +1,202 @@
+#include "PngWriterClass.h"
+#include <cstdio>
+
+#pragma region Globals
+static const size_t MAX_STORED_BLOCK_SIZE = 65535;		// a stored deflate block holds at most this many bytes
+static const unsigned int ADLER_MODULO = 65521;
+#pragma endregion
+
+/*
+	A chunk which is written piece by piece, the CRC covers the type and the data
+*/
+struct PngChunk
+{
+	FILE* file;
+	unsigned int crc;
+	unsigned int adlerA;	// zlib checksum of the uncompressed data, only used by the image data chunk
+	unsigned int adlerB;
+};
+
+static unsigned int CrcTable[256];
+static bool CrcTableReady = false;
+
+static void BuildCrcTable()
+{
+	for (unsigned int i = 0; i < 256; i++)
+	{
+		unsigned int crc = i;
+		for (int bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 1) ? 0xEDB88320u ^ (crc >> 1) : crc >> 1;
+		}
+		CrcTable[i] = crc;
+	}
+
+	CrcTableReady = true;
+}
+
+static void WriteBytes(PngChunk& _chunk, const unsigned char* _data, size_t _size)
+{
+	for (size_t i = 0; i < _size; i++)
+	{
+		_chunk.crc = CrcTable[(_chunk.crc ^ _data[i]) & 0xFF] ^ (_chunk.crc >> 8);
+	}
+
+	fwrite(_data, 1, _size, _chunk.file);
+}
+
+static void WriteBigEndian(unsigned char* _destination, unsigned int _value)
+{
+	_destination[0] = static_cast<unsigned char>(_value >> 24);
+	_destination[1] = static_cast<unsigned char>(_value >> 16);
+	_destination[2] = static_cast<unsigned char>(_value >> 8);
+	_destination[3] = static_cast<unsigned char>(_value);
+}
+
+static void BeginChunk(PngChunk& _chunk, const char* _type, unsigned int _size)
+{
+	unsigned char size[4];
+	WriteBigEndian(size, _size);
+	fwrite(size, 1, 4, _chunk.file);
+
+	_chunk.crc = 0xFFFFFFFF;
+	WriteBytes(_chunk, reinterpret_cast<const unsigned char*>(_type), 4);
+}
+
+static void EndChunk(PngChunk& _chunk)
+{
+	unsigned char crc[4];
+	WriteBigEndian(crc, _chunk.crc ^ 0xFFFFFFFF);
+	fwrite(crc, 1, 4, _chunk.file);
+}
+
+/*
+	Uncompressed data of the image, updates the zlib checksum as well
+*/
+static void WriteImageBytes(PngChunk& _chunk, const unsigned char* _data, size_t _size)
+{
+	for (size_t i = 0; i < _size; i++)
+	{
+		_chunk.adlerA = (_chunk.adlerA + _data[i]) % ADLER_MODULO;
+		_chunk.adlerB = (_chunk.adlerB + _chunk.adlerA) % ADLER_MODULO;
+	}
+
+	WriteBytes(_chunk, _data, _size);
+}
+
+/*
+	Write the signature, the header, one image data chunk and the end chunk
+	Every row starts with filter type 0 (none), the rows are cut into stored deflate blocks of at most 65535 bytes
+	The sizes are known up front, so the image is streamed to the file without a copy
+	_stride is the distance between two rows in bytes, the pixels are R, G, B, A
+*/
+bool PngWriterClass::Write(const char* _path, unsigned int _width, unsigned int _height, const unsigned char* _pixels, size_t _stride)
+{
+	if (_width == 0 || _height == 0 || !_pixels)
+	{
+		return false;
+	}
+
+	size_t rowSize = static_cast<size_t>(_width) * 4 + 1;
+	size_t rawSize = rowSize * _height;
+	size_t blockCount = (rawSize + MAX_STORED_BLOCK_SIZE - 1) / MAX_STORED_BLOCK_SIZE;
+	size_t dataSize = 2 + blockCount * 5 + rawSize + 4;
+	if (dataSize > 0x7FFFFFFF)
+	{
+		return false;
+	}
+
+	if (!CrcTableReady)
+	{
+		BuildCrcTable();
+	}
+
+	FILE* file = fopen(_path, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	PngChunk chunk;
+	chunk.file = file;
+	chunk.adlerA = 1;
+	chunk.adlerB = 0;
+
+	static const unsigned char signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+	fwrite(signature, 1, sizeof(signature), file);
+
+	//	8 bit, color type 6 (RGBA), deflate, adaptive filtering, no interlacing
+	unsigned char header[13];
+	WriteBigEndian(header, _width);
+	WriteBigEndian(header + 4, _height);
+	header[8] = 8;
+	header[9] = 6;
+	header[10] = 0;
+	header[11] = 0;
+	header[12] = 0;
+	BeginChunk(chunk, "IHDR", sizeof(header));
+	WriteBytes(chunk, header, sizeof(header));
+	EndChunk(chunk);
+
+	BeginChunk(chunk, "IDAT", static_cast<unsigned int>(dataSize));
+
+	static const unsigned char zlibHeader[2] = { 0x78, 0x01 };
+	WriteBytes(chunk, zlibHeader, sizeof(zlibHeader));
+
+	//	Walk the rows and cut them into blocks, a block may end in the middle of a row
+	size_t remaining = rawSize;
+	size_t blockRemaining = 0;
+	for (unsigned int y = 0; y < _height; y++)
+	{
+		static const unsigned char filter = 0;
+		const unsigned char* row = _pixels + _stride * y;
+
+		for (size_t x = 0; x < rowSize;)
+		{
+			if (blockRemaining == 0)
+			{
+				blockRemaining = remaining < MAX_STORED_BLOCK_SIZE ? remaining : MAX_STORED_BLOCK_SIZE;
+				unsigned char blockHeader[5];
+				blockHeader[0] = remaining == blockRemaining ? 1 : 0;
+				blockHeader[1] = static_cast<unsigned char>(blockRemaining);
+				blockHeader[2] = static_cast<unsigned char>(blockRemaining >> 8);
+				blockHeader[3] = static_cast<unsigned char>(~blockRemaining);
+				blockHeader[4] = static_cast<unsigned char>(~blockRemaining >> 8);
+				WriteBytes(chunk, blockHeader, sizeof(blockHeader));
+			}
+
+			size_t count;
+			if (x == 0)
+			{
+				WriteImageBytes(chunk, &filter, 1);
+				count = 1;
+			}
+			else
+			{
+				count = rowSize - x;
+				if (count > blockRemaining)
+				{
+					count = blockRemaining;
+				}
+				WriteImageBytes(chunk, row + x - 1, count);
+			}
+
+			x += count;
+			blockRemaining -= count;
+			remaining -= count;
+		}
+	}
+
+	unsigned char adler[4];
+	WriteBigEndian(adler, (chunk.adlerB << 16) | chunk.adlerA);
+	WriteBytes(chunk, adler, sizeof(adler));
+	EndChunk(chunk);
+
+	BeginChunk(chunk, "IEND", 0);
+	EndChunk(chunk);
+
+	bool written = ferror(file) == 0;
+	fclose(file);
+
+	return written;
+}
\ No newline at end of file
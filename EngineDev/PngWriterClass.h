@@ -0,0 +1,17 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+/*
+	Writes 8 bit RGBA images as PNG files without an external library
+	The image data is stored uncompressed (deflate blocks of type 0), the files are bigger than needed but every viewer opens them
+	Meant for screenshots and reference images of tests, not for assets
+*/
+class PngWriterClass
+{
+public:
+	static bool Write(const char* _path, unsigned int _width, unsigned int _height, const unsigned char* _pixels, size_t _stride);
+
+};
\ No newline at end of file
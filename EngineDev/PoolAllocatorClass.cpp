@@ -0,0 +1,137 @@
+#include "PoolAllocatorClass.h"
+#include <cstdlib>
+
+/*
+	Constructor
+*/
+PoolAllocatorClass::PoolAllocatorClass()
+{
+	m_memory = nullptr;
+	m_blocks = nullptr;
+	m_blockSize = 0;
+	m_blockCount = 0;
+	m_freeCount = 0;
+	m_freeList = nullptr;
+}
+
+/*
+	Destructor
+*/
+PoolAllocatorClass::~PoolAllocatorClass()
+{
+
+}
+
+/*
+	Round the block size up, so every block can hold a free list entry and stays aligned
+	Allocate all blocks at once (plus room to align the first one) and link them into the free list
+	_alignment has to be a power of two
+*/
+bool PoolAllocatorClass::Initialize(size_t _blockSize, unsigned int _blockCount, size_t _alignment)
+{
+	if (_alignment < sizeof(FreeBlock))
+	{
+		_alignment = sizeof(FreeBlock);
+	}
+
+	m_blockSize = (_blockSize + _alignment - 1) & ~(_alignment - 1);
+	if (m_blockSize < sizeof(FreeBlock))
+	{
+		m_blockSize = sizeof(FreeBlock);
+	}
+
+	m_memory = static_cast<unsigned char*>(malloc(m_blockSize * _blockCount + _alignment));
+	if (!m_memory)
+	{
+		return false;
+	}
+
+	size_t base = reinterpret_cast<size_t>(m_memory);
+	m_blocks = m_memory + (((base + _alignment - 1) & ~(_alignment - 1)) - base);
+
+	m_blockCount = _blockCount;
+	m_freeCount = _blockCount;
+	m_freeList = nullptr;
+
+	//	Link the blocks backwards, so the first allocation returns the first block
+	for (unsigned int i = _blockCount; i > 0; i--)
+	{
+		FreeBlock* block = reinterpret_cast<FreeBlock*>(m_blocks + (i - 1) * m_blockSize);
+		block->next = m_freeList;
+		m_freeList = block;
+	}
+
+	return true;
+}
+
+void PoolAllocatorClass::Shutdown()
+{
+	if (m_memory)
+	{
+		free(m_memory);
+		m_memory = nullptr;
+	}
+
+	m_blocks = nullptr;
+	m_blockCount = 0;
+	m_freeCount = 0;
+	m_freeList = nullptr;
+}
+
+/*
+	Take the first block of the free list, nullptr if every block is in use
+*/
+void* PoolAllocatorClass::Allocate()
+{
+	if (!m_freeList)
+	{
+		return nullptr;
+	}
+
+	FreeBlock* block = m_freeList;
+	m_freeList = block->next;
+	m_freeCount--;
+
+	return block;
+}
+
+/*
+	Put the block back to the front of the free list
+*/
+void PoolAllocatorClass::Free(void* _block)
+{
+	if (!_block)
+	{
+		return;
+	}
+
+	FreeBlock* block = static_cast<FreeBlock*>(_block);
+	block->next = m_freeList;
+	m_freeList = block;
+	m_freeCount++;
+}
+
+/*
+	Check if the block was handed out by this pool
+*/
+bool PoolAllocatorClass::Owns(const void* _block) const
+{
+	const unsigned char* block = static_cast<const unsigned char*>(_block);
+
+	return block >= m_blocks && block < m_blocks + m_blockSize * m_blockCount;
+}
+
+size_t PoolAllocatorClass::GetBlockSize() const
+{
+	return m_blockSize;
+}
+
+unsigned int PoolAllocatorClass::GetBlockCount() const
+{
+	return m_blockCount;
+}
+
+unsigned int PoolAllocatorClass::GetFreeCount() const
+{
+	return m_freeCount;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#pragma endregion
+
+/*
+	Allocator for many objects of the same size
+	All blocks are allocated once in Initialize, free blocks are linked through their own memory (intrusive free list)
+	Allocate and Free are O(1) and never touch the heap, not thread-safe
+*/
+class PoolAllocatorClass
+{
+public:
+	PoolAllocatorClass();
+	~PoolAllocatorClass();
+
+	bool Initialize(size_t _blockSize, unsigned int _blockCount, size_t _alignment = 16);
+	void Shutdown();
+
+	void* Allocate();
+	void Free(void* _block);
+
+	bool Owns(const void* _block) const;
+
+	size_t GetBlockSize() const;
+	unsigned int GetBlockCount() const;
+	unsigned int GetFreeCount() const;
+
+private:
+	struct FreeBlock
+	{
+		FreeBlock* next;
+	};
+
+	unsigned char* m_memory;
+	unsigned char* m_blocks;
+	size_t m_blockSize;
+	unsigned int m_blockCount;
+	unsigned int m_freeCount;
+	FreeBlock* m_freeList;
+};
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "PresentPolicyClass.h"
+
+/*
+	Constructor
+*/
+PresentPolicyClass::PresentPolicyClass()
+{
+	m_mode = PRESENT_MODE_VSYNC;
+	m_bufferCount = MIN_SWAP_CHAIN_BUFFERS;
+	m_frameLatency = 1;
+	m_allowTearing = false;
+	m_nextInputTime = 0;
+	m_presentCount = 0;
+	m_firstPending = 0;
+	m_shownCount = 0;
+	m_droppedCount = 0;
+}
+
+/*
+	Destructor
+*/
+PresentPolicyClass::~PresentPolicyClass()
+{
+
+}
+
+/*
+	Check the settings and resolve them against what the platform supports
+	Variable refresh without tearing support falls back to vsync, immediate presents without tearing are still not synchronized with the refresh
+	The frame latency is clamped to 1 - bufferCount - 1
+*/
+bool PresentPolicyClass::Initialize(const PresentSettings& _settings, bool _tearingSupported)
+{
+	if (_settings.mode > PRESENT_MODE_VARIABLE_REFRESH || _settings.bufferCount < MIN_SWAP_CHAIN_BUFFERS || _settings.bufferCount > MAX_SWAP_CHAIN_BUFFERS || _settings.maxFrameLatency == 0)
+	{
+		return false;
+	}
+
+	m_mode = _settings.mode;
+	if (m_mode == PRESENT_MODE_VARIABLE_REFRESH && !_tearingSupported)
+	{
+		m_mode = PRESENT_MODE_VSYNC;
+	}
+
+	m_bufferCount = _settings.bufferCount;
+	m_frameLatency = _settings.maxFrameLatency < m_bufferCount - 1 ? _settings.maxFrameLatency : m_bufferCount - 1;
+	m_allowTearing = _tearingSupported && m_mode != PRESENT_MODE_VSYNC;
+
+	m_nextInputTime = 0;
+	m_presentCount = 0;
+	m_firstPending = 0;
+	m_shownCount = 0;
+	m_droppedCount = 0;
+	m_latencyStatistics.Reset();
+
+	return true;
+}
+
+void PresentPolicyClass::Shutdown()
+{
+	m_latencyStatistics.Reset();
+}
+
+unsigned int PresentPolicyClass::GetMode() const
+{
+	return m_mode;
+}
+
+unsigned int PresentPolicyClass::GetBufferCount() const
+{
+	return m_bufferCount;
+}
+
+/*
+	Presents which may be queued before the CPU has to wait for the display
+*/
+unsigned int PresentPolicyClass::GetFrameLatency() const
+{
+	return m_frameLatency;
+}
+
+/*
+	Refreshes a present waits for, only vsync waits
+*/
+unsigned int PresentPolicyClass::GetSyncInterval() const
+{
+	return m_mode == PRESENT_MODE_VSYNC ? 1 : 0;
+}
+
+/*
+	Whether the presents may tear, needed for immediate presents which really do not wait and for variable refresh
+*/
+bool PresentPolicyClass::AllowTearing() const
+{
+	return m_allowTearing;
+}
+
+/*
+	The input of the frame which is presented next was sampled at this time
+*/
+void PresentPolicyClass::BeginFrame(unsigned long long _inputMicroseconds)
+{
+	m_nextInputTime = _inputMicroseconds;
+}
+
+/*
+	Remember the input time of the frame for the present, returns the id of the present, they count up from 0
+*/
+unsigned long long PresentPolicyClass::Present()
+{
+	unsigned long long presentId = m_presentCount;
+	m_inputTimes[presentId % PRESENT_HISTORY_SIZE] = m_nextInputTime;
+	m_presentCount++;
+
+	return presentId;
+}
+
+/*
+	The present is on screen since the given time, add its input latency to the statistics
+	Presents before it which were never reported are skipped, e.g. the swap chain only reports the last one
+	Presents which are reported twice or are too old to still have their input time are ignored
+*/
+void PresentPolicyClass::FrameShown(unsigned long long _presentId, unsigned long long _shownMicroseconds)
+{
+	if (_presentId < m_firstPending || _presentId >= m_presentCount)
+	{
+		return;
+	}
+
+	m_firstPending = _presentId + 1;
+	if (_presentId + PRESENT_HISTORY_SIZE < m_presentCount)
+	{
+		return;
+	}
+
+	unsigned long long inputTime = m_inputTimes[_presentId % PRESENT_HISTORY_SIZE];
+	unsigned long long latency = _shownMicroseconds > inputTime ? _shownMicroseconds - inputTime : 0;
+
+	m_latencyStatistics.AddFrameTime(static_cast<double>(latency) / 1000.0);
+	m_shownCount++;
+}
+
+/*
+	The present was replaced by a newer one before it reached the screen
+*/
+void PresentPolicyClass::FrameDropped(unsigned long long _presentId)
+{
+	if (_presentId < m_firstPending || _presentId >= m_presentCount)
+	{
+		return;
+	}
+
+	m_firstPending = _presentId + 1;
+	m_droppedCount++;
+}
+
+unsigned long long PresentPolicyClass::GetPresentCount() const
+{
+	return m_presentCount;
+}
+
+unsigned long long PresentPolicyClass::GetShownCount() const
+{
+	return m_shownCount;
+}
+
+unsigned long long PresentPolicyClass::GetDroppedCount() const
+{
+	return m_droppedCount;
+}
+
+/*
+	Milliseconds from sampling the input to showing the frame, over the last shown presents
+*/
+const FrameStatisticsClass& PresentPolicyClass::GetLatencyStatistics() const
+{
+	return m_latencyStatistics;
+}
+
+/*
+	Name of the present mode as the commandline spells it
+*/
+const char* PresentPolicyClass::GetModeName(unsigned int _mode)
+{
+	switch (_mode)
+	{
+	case PRESENT_MODE_VSYNC:
+		return "vsync";
+	case PRESENT_MODE_IMMEDIATE:
+		return "immediate";
+	case PRESENT_MODE_VARIABLE_REFRESH:
+		return "vrr";
+	default:
+		return "unknown";
+	}
+}
\ No newline at end of file
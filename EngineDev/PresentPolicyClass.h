@@ -0,0 +1,75 @@
+#pragma once
+
+#pragma region includes
+#include "FrameStatisticsClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int PRESENT_MODE_VSYNC = 0;				// every frame is shown for at least one refresh, the image never tears
+const unsigned int PRESENT_MODE_IMMEDIATE = 1;			// presents do not wait for the refresh, the image tears if the platform allows it
+const unsigned int PRESENT_MODE_VARIABLE_REFRESH = 2;	// the display refreshes when a frame arrives (G-Sync / FreeSync), needs tearing support
+const unsigned int MIN_SWAP_CHAIN_BUFFERS = 2;
+const unsigned int MAX_SWAP_CHAIN_BUFFERS = 4;
+const unsigned int PRESENT_HISTORY_SIZE = 64;			// presents whose input time is kept until they are shown
+#pragma endregion
+
+/*
+	How the frames are presented, read from the commandline in the main function
+*/
+struct PresentSettings
+{
+	unsigned int mode;					// PRESENT_MODE_*
+	unsigned int bufferCount;			// back buffers of the swap chain, MIN_SWAP_CHAIN_BUFFERS - MAX_SWAP_CHAIN_BUFFERS
+	unsigned int maxFrameLatency;		// presents which may wait to be shown, the CPU waits before it starts a frame beyond that
+	double simulatedRefreshRate;		// null backend only, refresh rate of the simulated display in Hz, 0 = frames are shown when they are presented
+};
+
+/*
+	Decides how the frames are presented and measures the latency from sampling the input to showing the frame, independent of the graphics API
+	Variable refresh needs tearing support, without it the frames are presented with vsync
+	One back buffer is always on screen, so at most bufferCount - 1 presents can wait to be shown, the frame latency is limited to that
+	BeginFrame remembers when the input of the next present was sampled, FrameShown measures its latency once the backend knows the present is on screen
+	D3DClass learns that from the frame statistics of the swap chain, SimulatedDisplayClass from its simulated refreshes
+*/
+class PresentPolicyClass
+{
+public:
+	PresentPolicyClass();
+	~PresentPolicyClass();
+
+	bool Initialize(const PresentSettings& _settings, bool _tearingSupported);
+	void Shutdown();
+
+	unsigned int GetMode() const;
+	unsigned int GetBufferCount() const;
+	unsigned int GetFrameLatency() const;
+	unsigned int GetSyncInterval() const;
+	bool AllowTearing() const;
+
+	void BeginFrame(unsigned long long _inputMicroseconds);
+	unsigned long long Present();
+	void FrameShown(unsigned long long _presentId, unsigned long long _shownMicroseconds);
+	void FrameDropped(unsigned long long _presentId);
+
+	unsigned long long GetPresentCount() const;
+	unsigned long long GetShownCount() const;
+	unsigned long long GetDroppedCount() const;
+	const FrameStatisticsClass& GetLatencyStatistics() const;
+
+	static const char* GetModeName(unsigned int _mode);
+
+private:
+	unsigned int m_mode;
+	unsigned int m_bufferCount;
+	unsigned int m_frameLatency;
+	bool m_allowTearing;
+
+	unsigned long long m_inputTimes[PRESENT_HISTORY_SIZE];
+	unsigned long long m_nextInputTime;		// input time of the next present
+	unsigned long long m_presentCount;
+	unsigned long long m_firstPending;		// oldest present which was neither shown nor dropped
+	unsigned long long m_shownCount;
+	unsigned long long m_droppedCount;
+
+	FrameStatisticsClass m_latencyStatistics;	// input to shown in milliseconds
+};
\ No newline at end of file
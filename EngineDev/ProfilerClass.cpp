@@ -0,0 +1,355 @@
+#include "ProfilerClass.h"
+
+#ifdef ENGINE_PROFILING
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+struct ProfilerThreadBuffer
+{
+	ProfilerEvent events[PROFILER_EVENTS_PER_THREAD];
+	std::atomic<unsigned long long> writeIndex;		// only written by the thread owning the buffer
+	unsigned long long readIndex;					// only touched by EndFrame
+};
+
+/*
+	The buffer a thread writes its zones to
+	The slot is given back when the thread exits, so threads which come and go do not use up the buffers
+	Zones the thread did not get collected yet stay in the buffer, the next owner continues behind them
+*/
+struct ProfilerThreadSlot
+{
+	unsigned int index;
+
+	ProfilerThreadSlot();
+	~ProfilerThreadSlot();
+};
+
+#pragma region Globals
+static const unsigned int INVALID_PROFILER_THREAD = 0xFFFFFFFF;
+
+static ProfilerThreadBuffer ThreadBuffers[MAX_PROFILER_THREADS];
+static const char* TrackNames[MAX_PROFILER_THREADS];		// nullptr for the buffers of CPU threads
+static std::atomic<bool> SlotsInUse[MAX_PROFILER_THREADS];
+static std::atomic<unsigned int> RegisteredThreads(0);		// every slot below it was in use at some point, EndFrame collects them
+static std::atomic<unsigned int> UnprofiledThreads(0);
+static thread_local ProfilerThreadSlot ThreadSlot;
+static thread_local unsigned int ThreadDepth = 0;
+
+static ProfilerZoneSummary FrameSummary[MAX_PROFILER_ZONES];
+static unsigned int FrameZoneCount = 0;
+
+static FILE* CaptureFile = nullptr;
+static unsigned long long CaptureStart = 0;
+static bool CaptureFirstEvent = true;
+#pragma endregion
+
+ProfilerThreadSlot::ProfilerThreadSlot()
+{
+	index = INVALID_PROFILER_THREAD;
+}
+
+/*
+	Release the slot when the thread exits, the zones it wrote are published before the slot is free
+*/
+ProfilerThreadSlot::~ProfilerThreadSlot()
+{
+	if (index < MAX_PROFILER_THREADS)
+	{
+		SlotsInUse[index].store(false, std::memory_order_release);
+	}
+}
+
+/*
+	Nanoseconds of the monotonic clock
+*/
+unsigned long long ProfilerClass::GetTicks()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*
+	Open the JSON file and write the start of the event array
+	Every zone which ends from now on gets written to the file in EndFrame
+*/
+bool ProfilerClass::BeginCapture(const char* _path)
+{
+	if (CaptureFile)
+	{
+		return false;
+	}
+
+	CaptureFile = fopen(_path, "w");
+	if (!CaptureFile)
+	{
+		return false;
+	}
+
+	fprintf(CaptureFile, "{\"traceEvents\":[\n");
+	CaptureStart = GetTicks();
+	CaptureFirstEvent = true;
+
+	return true;
+}
+
+/*
+	Collect the remaining zones, close the event array and the file
+*/
+void ProfilerClass::EndCapture()
+{
+	if (!CaptureFile)
+	{
+		return;
+	}
+
+	EndFrame();
+
+	//	Name the tracks, the CPU threads are only shown by their index
+	unsigned int threadCount = RegisteredThreads.load();
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		if (TrackNames[i])
+		{
+			fprintf(CaptureFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"%s\"}}", CaptureFirstEvent ? "" : ",\n", i, TrackNames[i]);
+			CaptureFirstEvent = false;
+		}
+	}
+
+	fprintf(CaptureFile, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(CaptureFile);
+	CaptureFile = nullptr;
+}
+
+/*
+	Called once per frame on the main thread
+	Collect the zones every thread finished since the last frame into the summary of this frame
+	Sort the summary by the first start of every zone (insertion sort, the table is small and mostly sorted)
+*/
+void ProfilerClass::EndFrame()
+{
+	FrameZoneCount = 0;
+
+	unsigned int threadCount = RegisteredThreads.load();
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		CollectThread(i, CaptureFile);
+	}
+
+	for (unsigned int i = 1; i < FrameZoneCount; i++)
+	{
+		ProfilerZoneSummary zone = FrameSummary[i];
+
+		unsigned int j = i;
+		for (; j > 0 && FrameSummary[j - 1].firstStart > zone.firstStart; j--)
+		{
+			FrameSummary[j] = FrameSummary[j - 1];
+		}
+
+		FrameSummary[j] = zone;
+	}
+}
+
+/*
+	Amount of different zones in the summary of the last frame
+*/
+unsigned int ProfilerClass::GetZoneCount()
+{
+	return FrameZoneCount;
+}
+
+const ProfilerZoneSummary& ProfilerClass::GetZone(unsigned int _index)
+{
+	return FrameSummary[_index];
+}
+
+/*
+	Threads which profiled zones while every slot was taken, their zones are not recorded
+*/
+unsigned int ProfilerClass::GetUnprofiledThreadCount()
+{
+	return UnprofiledThreads.load();
+}
+
+/*
+	Called when a zone starts
+	Give the thread a buffer the first time it profiles something
+	A thread which finds every slot taken is counted once and not recorded (MAX_PROFILER_THREADS marks it)
+	Return the nesting depth of the new zone
+*/
+unsigned int ProfilerClass::BeginZone()
+{
+	if (ThreadSlot.index == INVALID_PROFILER_THREAD)
+	{
+		ThreadSlot.index = AcquireSlot();
+		if (ThreadSlot.index == MAX_PROFILER_THREADS)
+		{
+			UnprofiledThreads.fetch_add(1);
+		}
+	}
+
+	return ThreadDepth++;
+}
+
+/*
+	Called when a zone ends
+	Append the zone to the buffer of the calling thread
+*/
+void ProfilerClass::EndZone(const char* _name, unsigned long long _start, unsigned int _depth)
+{
+	unsigned long long end = GetTicks();
+
+	ThreadDepth--;
+
+	WriteEvent(ThreadSlot.index, _name, _start, end, _depth);
+}
+
+/*
+	Create a track for timings which are not measured on a CPU thread, e.g. the passes of the GPU
+	A track takes one of the buffers of the threads for good, fail with MAX_PROFILER_THREADS if there is none left
+*/
+unsigned int ProfilerClass::CreateTrack(const char* _name)
+{
+	unsigned int track = AcquireSlot();
+	if (track == MAX_PROFILER_THREADS)
+	{
+		return MAX_PROFILER_THREADS;
+	}
+
+	TrackNames[track] = _name;
+
+	return track;
+}
+
+/*
+	Add a zone which was measured elsewhere to a track, _start and _end are ticks of GetTicks
+	Only one thread at a time may add zones to the same track
+*/
+void ProfilerClass::AddZone(unsigned int _track, const char* _name, unsigned long long _start, unsigned long long _end, unsigned int _depth)
+{
+	WriteEvent(_track, _name, _start, _end, _depth);
+}
+
+/*
+	Take the first free slot and make sure EndFrame collects it, MAX_PROFILER_THREADS if every slot is in use
+	The acquire pairs with the release of the last owner, so the write index continues where it stopped
+*/
+unsigned int ProfilerClass::AcquireSlot()
+{
+	for (unsigned int i = 0; i < MAX_PROFILER_THREADS; i++)
+	{
+		if (!SlotsInUse[i].load(std::memory_order_relaxed) && !SlotsInUse[i].exchange(true, std::memory_order_acquire))
+		{
+			unsigned int registered = RegisteredThreads.load();
+			while (registered < i + 1 && !RegisteredThreads.compare_exchange_weak(registered, i + 1))
+			{
+			}
+
+			return i;
+		}
+	}
+
+	return MAX_PROFILER_THREADS;
+}
+
+/*
+	Append the zone to the buffer and publish it by moving the write index
+	If EndFrame did not collect the buffer in time, the oldest zones are overwritten
+*/
+void ProfilerClass::WriteEvent(unsigned int _thread, const char* _name, unsigned long long _start, unsigned long long _end, unsigned int _depth)
+{
+	if (_thread >= MAX_PROFILER_THREADS)
+	{
+		return;
+	}
+
+	ProfilerThreadBuffer& buffer = ThreadBuffers[_thread];
+	unsigned long long writeIndex = buffer.writeIndex.load(std::memory_order_relaxed);
+
+	ProfilerEvent& profilerEvent = buffer.events[writeIndex % PROFILER_EVENTS_PER_THREAD];
+	profilerEvent.name = _name;
+	profilerEvent.start = _start;
+	profilerEvent.end = _end;
+	profilerEvent.depth = _depth;
+
+	buffer.writeIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+/*
+	Read every zone the thread published since the last collection
+	Add it to the summary and write it to the capture as a complete event ("X") in microseconds
+*/
+void ProfilerClass::CollectThread(unsigned int _thread, FILE* _capture)
+{
+	ProfilerThreadBuffer& buffer = ThreadBuffers[_thread];
+
+	unsigned long long writeIndex = buffer.writeIndex.load(std::memory_order_acquire);
+	unsigned long long readIndex = buffer.readIndex;
+
+	if (writeIndex - readIndex > PROFILER_EVENTS_PER_THREAD)
+	{
+		readIndex = writeIndex - PROFILER_EVENTS_PER_THREAD;
+	}
+
+	for (; readIndex < writeIndex; readIndex++)
+	{
+		const ProfilerEvent& profilerEvent = buffer.events[readIndex % PROFILER_EVENTS_PER_THREAD];
+
+		AddToSummary(profilerEvent);
+
+		if (_capture && profilerEvent.start >= CaptureStart)
+		{
+			fprintf(_capture, "%s{\"name\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":0,\"tid\":%u}",
+				CaptureFirstEvent ? "" : ",\n", profilerEvent.name,
+				static_cast<double>(profilerEvent.start - CaptureStart) * 0.001,
+				static_cast<double>(profilerEvent.end - profilerEvent.start) * 0.001, _thread);
+			CaptureFirstEvent = false;
+		}
+	}
+
+	buffer.readIndex = writeIndex;
+}
+
+/*
+	Zones are identified by their name
+	The names are string literals, so compare the pointers first and only compare the strings if they differ
+*/
+void ProfilerClass::AddToSummary(const ProfilerEvent& _event)
+{
+	ProfilerZoneSummary* zone = nullptr;
+
+	for (unsigned int i = 0; i < FrameZoneCount; i++)
+	{
+		if (FrameSummary[i].name == _event.name || strcmp(FrameSummary[i].name, _event.name) == 0)
+		{
+			zone = &FrameSummary[i];
+			break;
+		}
+	}
+
+	if (!zone)
+	{
+		if (FrameZoneCount == MAX_PROFILER_ZONES)
+		{
+			return;
+		}
+
+		zone = &FrameSummary[FrameZoneCount];
+		zone->name = _event.name;
+		zone->firstStart = _event.start;
+		zone->totalTime = 0.0;
+		zone->callCount = 0;
+		zone->depth = _event.depth;
+		FrameZoneCount++;
+	}
+
+	if (_event.start < zone->firstStart)
+	{
+		zone->firstStart = _event.start;
+	}
+
+	zone->totalTime += static_cast<double>(_event.end - _event.start) * 0.000001;
+	zone->callCount++;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#pragma region pre-processing directives
+//	The profiler is compiled into debug builds, define ENGINE_PROFILING to profile a release build
+//	Without ENGINE_PROFILING every PROFILE_ macro expands to nothing and the profiler does not exist at all
+#if defined(_DEBUG) && !defined(ENGINE_PROFILING)
+#define ENGINE_PROFILING
+#endif
+#pragma endregion
+
+#ifdef ENGINE_PROFILING
+
+#pragma region includes
+#include <cstdio>
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_PROFILER_THREADS = 32;
+const unsigned int PROFILER_EVENTS_PER_THREAD = 8192;	// has to hold at least one frame of events of a thread
+const unsigned int MAX_PROFILER_ZONES = 128;			// different zones in the summary of a frame
+#pragma endregion
+
+struct ProfilerEvent
+{
+	const char* name;
+	unsigned long long start;	// ticks (nanoseconds)
+	unsigned long long end;
+	unsigned int depth;
+};
+
+struct ProfilerZoneSummary
+{
+	const char* name;
+	unsigned long long firstStart;	// ticks of the first call in the frame, the summary is sorted by it so parents come before their children
+	double totalTime;			// milliseconds spent in the zone during the frame, over all threads
+	unsigned int callCount;
+	unsigned int depth;
+};
+
+/*
+	Hierarchical CPU profiler
+	Zones are marked with PROFILE_SCOPE, the zone ends with the scope and zones nest per thread
+	Every thread writes its finished zones into its own ring buffer, only the writing thread moves the write index (lock-free)
+	EndFrame (main thread) collects the zones of all threads since the last frame into a per-frame summary
+	While a capture is running the zones are also written to a chrome://tracing / Perfetto JSON file
+	Timings which are not measured by a CPU thread (e.g. the GPU) are added to their own named track with AddZone
+*/
+class ProfilerClass
+{
+public:
+	static unsigned long long GetTicks();
+
+	static bool BeginCapture(const char* _path);
+	static void EndCapture();
+	static void EndFrame();
+
+	static unsigned int GetZoneCount();
+	static const ProfilerZoneSummary& GetZone(unsigned int _index);
+	static unsigned int GetUnprofiledThreadCount();
+
+	static unsigned int BeginZone();
+	static void EndZone(const char* _name, unsigned long long _start, unsigned int _depth);
+
+	static unsigned int CreateTrack(const char* _name);
+	static void AddZone(unsigned int _track, const char* _name, unsigned long long _start, unsigned long long _end, unsigned int _depth);
+
+private:
+	static unsigned int AcquireSlot();
+	static void WriteEvent(unsigned int _thread, const char* _name, unsigned long long _start, unsigned long long _end, unsigned int _depth);
+	static void CollectThread(unsigned int _thread, FILE* _capture);
+	static void AddToSummary(const ProfilerEvent& _event);
+};
+
+/*
+	Marks a zone from its construction until the end of its scope
+*/
+class ProfilerScopeClass
+{
+public:
+	explicit ProfilerScopeClass(const char* _name)
+	{
+		m_name = _name;
+		m_depth = ProfilerClass::BeginZone();
+		m_start = ProfilerClass::GetTicks();
+	}
+
+	~ProfilerScopeClass()
+	{
+		ProfilerClass::EndZone(m_name, m_start, m_depth);
+	}
+
+private:
+	const char* m_name;
+	unsigned long long m_start;
+	unsigned int m_depth;
+};
+
+#define PROFILE_CONCATENATE_INNER(_a, _b) _a##_b
+#define PROFILE_CONCATENATE(_a, _b) PROFILE_CONCATENATE_INNER(_a, _b)
+#define PROFILE_SCOPE(_name) ProfilerScopeClass PROFILE_CONCATENATE(profilerScope, __LINE__)(_name)
+#define PROFILE_END_FRAME() ProfilerClass::EndFrame()
+
+#else
+
+#define PROFILE_SCOPE(_name)
+#define PROFILE_END_FRAME()
+
+#endif
\ No newline at end of file
@@ -0,0 +1,687 @@
+#include "RenderGraphClass.h"
+
+/*
+	Constructor
+*/
+RenderGraphClass::RenderGraphClass()
+{
+	Reset();
+}
+
+/*
+	Destructor
+*/
+RenderGraphClass::~RenderGraphClass()
+{
+
+}
+
+/*
+	Forget the passes and resources of the last frame
+*/
+void RenderGraphClass::Reset()
+{
+	m_passCount = 0;
+	m_resourceCount = 0;
+	m_compiledPassCount = 0;
+	m_barrierCount = 0;
+	m_barrierBatchCount = 0;
+	m_finalBarrierBegin = 0;
+	m_finalBarrierCount = 0;
+	m_transientMemorySize = 0;
+	m_transientMemorySizeWithoutAliasing = 0;
+}
+
+/*
+	Add a resource which lives outside of the graph, e.g. the back buffer of the swapchain
+	The graph expects it in _initialState and leaves it in _finalState after the last pass
+	Returns INVALID_RENDER_GRAPH_HANDLE if the graph is full
+*/
+unsigned int RenderGraphClass::ImportResource(const char* _name, void* _handle, unsigned int _initialState, unsigned int _finalState)
+{
+	if (m_resourceCount == MAX_RENDER_GRAPH_RESOURCES)
+	{
+		return INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	RenderResource& resource = m_resources[m_resourceCount];
+	resource.name = _name;
+	resource.handle = _handle;
+	resource.imported = true;
+	resource.initialState = _initialState;
+	resource.finalState = _finalState;
+	resource.size = 0;
+	resource.alignment = 1;
+	resource.offset = 0;
+
+	return m_resourceCount++;
+}
+
+/*
+	Add a resource which only lives during the frame, its content is undefined before the first pass writes it
+	The backend places it at GetResourceOffset in a heap of GetTransientMemorySize bytes
+	_alignment has to be a power of two
+*/
+unsigned int RenderGraphClass::CreateTransientResource(const char* _name, size_t _size, size_t _alignment)
+{
+	if (m_resourceCount == MAX_RENDER_GRAPH_RESOURCES || _size == 0 || _alignment == 0 || (_alignment & (_alignment - 1)) != 0)
+	{
+		return INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	RenderResource& resource = m_resources[m_resourceCount];
+	resource.name = _name;
+	resource.handle = nullptr;
+	resource.imported = false;
+	resource.initialState = RESOURCE_STATE_COMMON;
+	resource.finalState = RESOURCE_STATE_COMMON;
+	resource.size = _size;
+	resource.alignment = _alignment;
+	resource.offset = 0;
+
+	return m_resourceCount++;
+}
+
+/*
+	Set the backend handle of a transient resource, the barriers pick up the handles in Compile
+*/
+void RenderGraphClass::SetResourceHandle(unsigned int _resource, void* _handle)
+{
+	if (_resource < m_resourceCount)
+	{
+		m_resources[_resource].handle = _handle;
+	}
+}
+
+/*
+	Add a pass, passes are executed in the order they were added
+	A pass which writes no imported resource and whose results nobody reads is culled, unless _neverCull is set
+*/
+unsigned int RenderGraphClass::AddPass(const char* _name, RenderPassFunction _function, void* _data, bool _neverCull)
+{
+	if (m_passCount == MAX_RENDER_GRAPH_PASSES)
+	{
+		return INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	RenderPass& pass = m_passes[m_passCount];
+	pass.name = _name;
+	pass.function = _function;
+	pass.data = _data;
+	pass.neverCull = _neverCull;
+	pass.alive = false;
+	pass.accessCount = 0;
+	pass.barrierBegin = 0;
+	pass.barrierCount = 0;
+
+	return m_passCount++;
+}
+
+/*
+	The pass reads the resource in the given read state
+*/
+bool RenderGraphClass::Read(unsigned int _pass, unsigned int _resource, unsigned int _state)
+{
+	if ((_state & RESOURCE_STATE_WRITE_MASK) != 0)
+	{
+		return false;
+	}
+
+	return AddAccess(_pass, _resource, _state, false);
+}
+
+/*
+	The pass writes the resource in the given write state
+*/
+bool RenderGraphClass::Write(unsigned int _pass, unsigned int _resource, unsigned int _state)
+{
+	if ((_state & RESOURCE_STATE_WRITE_MASK) == 0 || (_state & ~RESOURCE_STATE_WRITE_MASK) != 0)
+	{
+		return false;
+	}
+
+	return AddAccess(_pass, _resource, _state, true);
+}
+
+/*
+	A pass accesses every resource at most once, two reads of the same resource are merged into one read of both states
+	Anything else would need a barrier in the middle of the pass, so it fails
+*/
+bool RenderGraphClass::AddAccess(unsigned int _pass, unsigned int _resource, unsigned int _state, bool _write)
+{
+	if (_pass >= m_passCount || _resource >= m_resourceCount)
+	{
+		return false;
+	}
+
+	RenderPass& pass = m_passes[_pass];
+
+	for (unsigned int i = 0; i < pass.accessCount; i++)
+	{
+		ResourceAccess& access = pass.accesses[i];
+		if (access.resource != _resource)
+		{
+			continue;
+		}
+
+		if (access.state == _state && access.write == _write)
+		{
+			return true;
+		}
+
+		bool combinable = !access.write && !_write && access.state != RESOURCE_STATE_PRESENT && _state != RESOURCE_STATE_PRESENT && access.state != RESOURCE_STATE_COMMON && _state != RESOURCE_STATE_COMMON;
+		if (!combinable)
+		{
+			return false;
+		}
+
+		access.state |= _state;
+		return true;
+	}
+
+	if (pass.accessCount == MAX_RENDER_PASS_ACCESSES)
+	{
+		return false;
+	}
+
+	ResourceAccess& access = pass.accesses[pass.accessCount];
+	access.resource = _resource;
+	access.state = _state;
+	access.write = _write;
+	access.writer = INVALID_RENDER_GRAPH_HANDLE;
+	pass.accessCount++;
+
+	return true;
+}
+
+/*
+	Cull the passes nobody needs, keep the order of the others
+	Figure out when every resource is used and place the transient resources in memory
+	Build the barrier batch of every pass and the final transitions of the imported resources
+	Fails if a transient resource is read before any pass wrote it
+*/
+bool RenderGraphClass::Compile()
+{
+	m_compiledPassCount = 0;
+	m_barrierCount = 0;
+	m_barrierBatchCount = 0;
+	m_finalBarrierBegin = 0;
+	m_finalBarrierCount = 0;
+
+	CullPasses();
+
+	for (unsigned int i = 0; i < m_passCount; i++)
+	{
+		if (m_passes[i].alive)
+		{
+			m_compiledPasses[m_compiledPassCount] = i;
+			m_compiledPassCount++;
+		}
+	}
+
+	if (!ComputeLifetimes())
+	{
+		return false;
+	}
+
+	PlaceTransientResources();
+
+	return BuildBarriers();
+}
+
+/*
+	Record the barrier batch of the pass and the pass itself
+	The last pass also records the transitions of the imported resources into their final state
+	Only reads the compiled graph, so different passes can be executed on different threads at the same time
+*/
+void RenderGraphClass::ExecutePass(unsigned int _compiledPass, CommandRecorderClass* _recorder) const
+{
+	const RenderPass& pass = m_passes[m_compiledPasses[_compiledPass]];
+
+	if (pass.barrierCount > 0)
+	{
+		_recorder->ResourceBarriers(&m_barriers[pass.barrierBegin], pass.barrierCount);
+	}
+
+	if (pass.function)
+	{
+		pass.function(_recorder, pass.data);
+	}
+
+	if (_compiledPass == m_compiledPassCount - 1 && m_finalBarrierCount > 0)
+	{
+		_recorder->ResourceBarriers(&m_barriers[m_finalBarrierBegin], m_finalBarrierCount);
+	}
+}
+
+unsigned int RenderGraphClass::GetCompiledPassCount() const
+{
+	return m_compiledPassCount;
+}
+
+const char* RenderGraphClass::GetCompiledPassName(unsigned int _compiledPass) const
+{
+	return m_passes[m_compiledPasses[_compiledPass]].name;
+}
+
+unsigned int RenderGraphClass::GetCulledPassCount() const
+{
+	return m_passCount - m_compiledPassCount;
+}
+
+/*
+	Barriers of all batches, transitions and aliasing barriers
+*/
+unsigned int RenderGraphClass::GetBarrierCount() const
+{
+	return m_barrierCount;
+}
+
+/*
+	Batches which contain at least one barrier, every batch is a single ResourceBarrier call
+*/
+unsigned int RenderGraphClass::GetBarrierBatchCount() const
+{
+	return m_barrierBatchCount;
+}
+
+/*
+	Offset of a transient resource in the heap of the transient resources, 0 for imported ones
+*/
+size_t RenderGraphClass::GetResourceOffset(unsigned int _resource) const
+{
+	return m_resources[_resource].offset;
+}
+
+/*
+	Bytes the heap of the transient resources needs
+*/
+size_t RenderGraphClass::GetTransientMemorySize() const
+{
+	return m_transientMemorySize;
+}
+
+/*
+	Bytes the transient resources would need if every resource had its own memory
+*/
+size_t RenderGraphClass::GetTransientMemorySizeWithoutAliasing() const
+{
+	return m_transientMemorySizeWithoutAliasing;
+}
+
+/*
+	Passes which write an imported resource or must never be culled are needed
+	Walk forward once to remember for every read which pass wrote the resource last before it
+	Then walk backwards, so everything a needed pass reads marks that writer as needed as well
+*/
+void RenderGraphClass::CullPasses()
+{
+	unsigned int lastWriters[MAX_RENDER_GRAPH_RESOURCES];
+	for (unsigned int i = 0; i < m_resourceCount; i++)
+	{
+		lastWriters[i] = INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	for (unsigned int i = 0; i < m_passCount; i++)
+	{
+		RenderPass& pass = m_passes[i];
+		pass.alive = pass.neverCull;
+
+		//	Reads first, a pass which reads and writes the same resource reads what an earlier pass wrote
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			if (!pass.accesses[j].write)
+			{
+				pass.accesses[j].writer = lastWriters[pass.accesses[j].resource];
+			}
+		}
+
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			if (pass.accesses[j].write)
+			{
+				lastWriters[pass.accesses[j].resource] = i;
+				pass.alive = pass.alive || m_resources[pass.accesses[j].resource].imported;
+			}
+		}
+	}
+
+	for (unsigned int i = m_passCount; i > 0; i--)
+	{
+		const RenderPass& pass = m_passes[i - 1];
+		if (!pass.alive)
+		{
+			continue;
+		}
+
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			if (!pass.accesses[j].write && pass.accesses[j].writer != INVALID_RENDER_GRAPH_HANDLE)
+			{
+				m_passes[pass.accesses[j].writer].alive = true;
+			}
+		}
+	}
+}
+
+/*
+	First and last compiled pass which uses every resource
+	List the transient resources by the compiled pass they are used last in, in the order they were created
+*/
+bool RenderGraphClass::ComputeLifetimes()
+{
+	for (unsigned int i = 0; i < m_resourceCount; i++)
+	{
+		m_resources[i].firstUse = INVALID_RENDER_GRAPH_HANDLE;
+		m_resources[i].lastUse = INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	for (unsigned int i = 0; i < m_compiledPassCount; i++)
+	{
+		const RenderPass& pass = m_passes[m_compiledPasses[i]];
+
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			RenderResource& resource = m_resources[pass.accesses[j].resource];
+
+			if (resource.firstUse == INVALID_RENDER_GRAPH_HANDLE)
+			{
+				//	Nothing defined the content of a transient resource yet
+				if (!resource.imported && !pass.accesses[j].write)
+				{
+					return false;
+				}
+
+				resource.firstUse = i;
+			}
+
+			resource.lastUse = i;
+		}
+	}
+
+	for (unsigned int i = 0; i < m_compiledPassCount; i++)
+	{
+		m_endingResources[i] = INVALID_RENDER_GRAPH_HANDLE;
+	}
+
+	for (unsigned int i = m_resourceCount; i > 0; i--)
+	{
+		RenderResource& resource = m_resources[i - 1];
+		if (!resource.imported && resource.lastUse != INVALID_RENDER_GRAPH_HANDLE)
+		{
+			resource.nextEnding = m_endingResources[resource.lastUse];
+			m_endingResources[resource.lastUse] = i - 1;
+		}
+	}
+
+	return true;
+}
+
+/*
+	Place the used transient resources, the biggest first
+	Every resource goes to the lowest offset which does not collide with a resource that is alive at the same time
+*/
+void RenderGraphClass::PlaceTransientResources()
+{
+	unsigned int order[MAX_RENDER_GRAPH_RESOURCES];
+	unsigned int orderCount = 0;
+
+	m_transientMemorySize = 0;
+	m_transientMemorySizeWithoutAliasing = 0;
+
+	for (unsigned int i = 0; i < m_resourceCount; i++)
+	{
+		RenderResource& resource = m_resources[i];
+		if (resource.imported || resource.firstUse == INVALID_RENDER_GRAPH_HANDLE)
+		{
+			continue;
+		}
+
+		m_transientMemorySizeWithoutAliasing = (m_transientMemorySizeWithoutAliasing + resource.alignment - 1) & ~(resource.alignment - 1);
+		m_transientMemorySizeWithoutAliasing += resource.size;
+
+		//	Insertion sort by size, biggest first
+		unsigned int j = orderCount;
+		for (; j > 0 && m_resources[order[j - 1]].size < resource.size; j--)
+		{
+			order[j] = order[j - 1];
+		}
+
+		order[j] = i;
+		orderCount++;
+	}
+
+	for (unsigned int i = 0; i < orderCount; i++)
+	{
+		RenderResource& resource = m_resources[order[i]];
+		size_t offset = 0;
+
+		//	Only the placed resources which are alive at the same time can collide, gather them once instead of on every retry
+		unsigned int alive[MAX_RENDER_GRAPH_RESOURCES];
+		unsigned int aliveCount = 0;
+		for (unsigned int j = 0; j < i; j++)
+		{
+			const RenderResource& placed = m_resources[order[j]];
+			if (placed.firstUse <= resource.lastUse && resource.firstUse <= placed.lastUse)
+			{
+				alive[aliveCount] = order[j];
+				aliveCount++;
+			}
+		}
+
+		//	Move behind every placed resource we collide with, until we fit
+		bool collides = true;
+		while (collides)
+		{
+			collides = false;
+			offset = (offset + resource.alignment - 1) & ~(resource.alignment - 1);
+
+			for (unsigned int j = 0; j < aliveCount; j++)
+			{
+				const RenderResource& placed = m_resources[alive[j]];
+
+				if (placed.offset < offset + resource.size && offset < placed.offset + placed.size)
+				{
+					offset = placed.offset + placed.size;
+					collides = true;
+					break;
+				}
+			}
+		}
+
+		resource.offset = offset;
+
+		if (offset + resource.size > m_transientMemorySize)
+		{
+			m_transientMemorySize = offset + resource.size;
+		}
+	}
+}
+
+/*
+	Go through the compiled passes and track the state of every resource
+	Imported resources start in their initial state, transient resources are created in the state of their first access
+	A transient resource which takes over memory of another one gets an aliasing barrier before its first use
+	A write needs the exact write state, a read needs a read state which contains the requested one
+	Reads get a transition to the combined state of all reads until the next write, so the following reads need no barrier
+*/
+bool RenderGraphClass::BuildBarriers()
+{
+	for (unsigned int i = 0; i < m_resourceCount; i++)
+	{
+		m_resources[i].state = m_resources[i].initialState;
+	}
+
+	for (unsigned int i = 0; i < m_compiledPassCount; i++)
+	{
+		RenderPass& pass = m_passes[m_compiledPasses[i]];
+		pass.barrierBegin = m_barrierCount;
+
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			const ResourceAccess& access = pass.accesses[j];
+			RenderResource& resource = m_resources[access.resource];
+
+			if (!resource.imported && resource.firstUse == i)
+			{
+				unsigned int aliasedResource = FindAliasedResource(access.resource);
+				if (aliasedResource != INVALID_RENDER_GRAPH_HANDLE)
+				{
+					if (!AddBarrier(resource.handle, m_resources[aliasedResource].handle, RESOURCE_STATE_COMMON, RESOURCE_STATE_COMMON, true))
+					{
+						return false;
+					}
+				}
+
+				resource.state = access.state;
+				continue;
+			}
+
+			if (access.write)
+			{
+				if (resource.state != access.state)
+				{
+					if (!AddBarrier(resource.handle, nullptr, resource.state, access.state, false))
+					{
+						return false;
+					}
+
+					resource.state = access.state;
+				}
+
+				continue;
+			}
+
+			bool readable = false;
+			if (access.state == RESOURCE_STATE_COMMON || access.state == RESOURCE_STATE_PRESENT)
+			{
+				readable = resource.state == access.state;
+			}
+			else
+			{
+				readable = (resource.state & RESOURCE_STATE_WRITE_MASK) == 0 && (resource.state & RESOURCE_STATE_PRESENT) == 0 && (resource.state & access.state) == access.state;
+			}
+
+			if (!readable)
+			{
+				unsigned int readState = GetMergedReadState(i, access.resource);
+				if (!AddBarrier(resource.handle, nullptr, resource.state, readState, false))
+				{
+					return false;
+				}
+
+				resource.state = readState;
+			}
+		}
+
+		pass.barrierCount = m_barrierCount - pass.barrierBegin;
+		if (pass.barrierCount > 0)
+		{
+			m_barrierBatchCount++;
+		}
+	}
+
+	m_finalBarrierBegin = m_barrierCount;
+
+	for (unsigned int i = 0; i < m_resourceCount; i++)
+	{
+		RenderResource& resource = m_resources[i];
+		if (resource.imported && resource.state != resource.finalState)
+		{
+			if (!AddBarrier(resource.handle, nullptr, resource.state, resource.finalState, false))
+			{
+				return false;
+			}
+
+			resource.state = resource.finalState;
+		}
+	}
+
+	m_finalBarrierCount = m_barrierCount - m_finalBarrierBegin;
+	if (m_finalBarrierCount > 0)
+	{
+		m_barrierBatchCount++;
+	}
+
+	return true;
+}
+
+/*
+	Combined state of the reads of the resource from the compiled pass on, until a pass writes it
+	Common and present can not be combined, they end the combined state
+	No pass after the last use of the resource can access it, so the search ends there
+*/
+unsigned int RenderGraphClass::GetMergedReadState(unsigned int _compiledPass, unsigned int _resource) const
+{
+	unsigned int state = RESOURCE_STATE_COMMON;
+
+	for (unsigned int i = _compiledPass; i <= m_resources[_resource].lastUse; i++)
+	{
+		const RenderPass& pass = m_passes[m_compiledPasses[i]];
+
+		for (unsigned int j = 0; j < pass.accessCount; j++)
+		{
+			const ResourceAccess& access = pass.accesses[j];
+			if (access.resource != _resource)
+			{
+				continue;
+			}
+
+			if (access.write)
+			{
+				return state;
+			}
+
+			if (access.state == RESOURCE_STATE_COMMON || access.state == RESOURCE_STATE_PRESENT)
+			{
+				return state == RESOURCE_STATE_COMMON ? access.state : state;
+			}
+
+			state |= access.state;
+		}
+	}
+
+	return state;
+}
+
+/*
+	The transient resource which used the memory of the given one last, before the given one is used for the first time
+	Walk back from the first use over the resources ending in every pass, the first one which overlaps in memory is it
+	The resource it took the memory from usually ended right before, so this rarely looks at more than a few passes
+*/
+unsigned int RenderGraphClass::FindAliasedResource(unsigned int _resource) const
+{
+	const RenderResource& resource = m_resources[_resource];
+
+	for (unsigned int i = resource.firstUse; i > 0; i--)
+	{
+		for (unsigned int other = m_endingResources[i - 1]; other != INVALID_RENDER_GRAPH_HANDLE; other = m_resources[other].nextEnding)
+		{
+			const RenderResource& otherResource = m_resources[other];
+			if (otherResource.offset < resource.offset + resource.size && resource.offset < otherResource.offset + otherResource.size)
+			{
+				return other;
+			}
+		}
+	}
+
+	return INVALID_RENDER_GRAPH_HANDLE;
+}
+
+bool RenderGraphClass::AddBarrier(void* _resource, void* _aliasedResource, unsigned int _stateBefore, unsigned int _stateAfter, bool _aliasing)
+{
+	if (m_barrierCount == MAX_RENDER_GRAPH_BARRIERS)
+	{
+		return false;
+	}
+
+	ResourceBarrier& barrier = m_barriers[m_barrierCount];
+	barrier.resource = _resource;
+	barrier.aliasedResource = _aliasedResource;
+	barrier.stateBefore = _stateBefore;
+	barrier.stateAfter = _stateAfter;
+	barrier.aliasing = _aliasing;
+	m_barrierCount++;
+
+	return true;
+}
\ No newline at end of file
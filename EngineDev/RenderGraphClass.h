@@ -0,0 +1,126 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "CommandRecorderClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_RENDER_GRAPH_PASSES = 64;
+const unsigned int MAX_RENDER_GRAPH_RESOURCES = 64;
+const unsigned int MAX_RENDER_PASS_ACCESSES = 8;		// reads and writes of a single pass
+const unsigned int MAX_RENDER_GRAPH_BARRIERS = MAX_RENDER_GRAPH_PASSES * MAX_RENDER_PASS_ACCESSES + MAX_RENDER_GRAPH_RESOURCES;
+const unsigned int INVALID_RENDER_GRAPH_HANDLE = 0xFFFFFFFF;
+#pragma endregion
+
+/*
+	Records the commands of a pass, _data is the pointer given to AddPass
+*/
+typedef void (*RenderPassFunction)(CommandRecorderClass* _recorder, void* _data);
+
+/*
+	Describes the passes of a frame and the resources they read and write, without knowing the graphics backend
+	Rebuilt every frame: Reset, import the resources from outside (e.g. the back buffer), create the transient ones, add the passes
+
+	Compile turns the description into what the backend executes:
+	Passes which contribute neither to an imported resource nor are marked as never culled are dropped
+	The remaining passes keep the order they were added in, every pass gets one batch with all the barriers it needs
+	Consecutive reads in different states are merged into a single transition to the combined state
+	Transient resources whose lifetimes do not overlap share memory (aliasing), every resource gets an offset into one heap
+	Imported resources are transitioned to their final state after the last pass
+
+	Does not allocate, everything lives in fixed arrays
+*/
+class RenderGraphClass
+{
+public:
+	RenderGraphClass();
+	~RenderGraphClass();
+
+	void Reset();
+
+	unsigned int ImportResource(const char* _name, void* _handle, unsigned int _initialState, unsigned int _finalState);
+	unsigned int CreateTransientResource(const char* _name, size_t _size, size_t _alignment);
+	void SetResourceHandle(unsigned int _resource, void* _handle);
+
+	unsigned int AddPass(const char* _name, RenderPassFunction _function, void* _data, bool _neverCull = false);
+	bool Read(unsigned int _pass, unsigned int _resource, unsigned int _state);
+	bool Write(unsigned int _pass, unsigned int _resource, unsigned int _state);
+
+	bool Compile();
+	void ExecutePass(unsigned int _compiledPass, CommandRecorderClass* _recorder) const;
+
+	unsigned int GetCompiledPassCount() const;
+	const char* GetCompiledPassName(unsigned int _compiledPass) const;
+	unsigned int GetCulledPassCount() const;
+	unsigned int GetBarrierCount() const;
+	unsigned int GetBarrierBatchCount() const;
+
+	size_t GetResourceOffset(unsigned int _resource) const;
+	size_t GetTransientMemorySize() const;
+	size_t GetTransientMemorySizeWithoutAliasing() const;
+
+private:
+	struct ResourceAccess
+	{
+		unsigned int resource;
+		unsigned int state;
+		bool write;
+		unsigned int writer;		// reads only: the pass which wrote the resource last before this one, set by CullPasses
+	};
+
+	struct RenderPass
+	{
+		const char* name;
+		RenderPassFunction function;
+		void* data;
+		bool neverCull;
+		bool alive;
+		ResourceAccess accesses[MAX_RENDER_PASS_ACCESSES];
+		unsigned int accessCount;
+		unsigned int barrierBegin;
+		unsigned int barrierCount;
+	};
+
+	struct RenderResource
+	{
+		const char* name;
+		void* handle;
+		bool imported;
+		unsigned int initialState;
+		unsigned int finalState;
+		size_t size;
+		size_t alignment;
+		size_t offset;				// transient only, offset into the heap all transient resources share
+		unsigned int firstUse;		// compiled pass, INVALID_RENDER_GRAPH_HANDLE if no pass uses it
+		unsigned int lastUse;
+		unsigned int nextEnding;	// transient only, next resource whose last use is the same compiled pass
+		unsigned int state;			// while compiling: the state after the passes compiled so far
+	};
+
+	RenderPass m_passes[MAX_RENDER_GRAPH_PASSES];
+	unsigned int m_passCount;
+	RenderResource m_resources[MAX_RENDER_GRAPH_RESOURCES];
+	unsigned int m_resourceCount;
+
+	unsigned int m_compiledPasses[MAX_RENDER_GRAPH_PASSES];
+	unsigned int m_compiledPassCount;
+	unsigned int m_endingResources[MAX_RENDER_GRAPH_PASSES];		// per compiled pass the first transient resource used last in it
+	ResourceBarrier m_barriers[MAX_RENDER_GRAPH_BARRIERS];
+	unsigned int m_barrierCount;
+	unsigned int m_barrierBatchCount;
+	unsigned int m_finalBarrierBegin;
+	unsigned int m_finalBarrierCount;
+
+	size_t m_transientMemorySize;
+	size_t m_transientMemorySizeWithoutAliasing;
+
+	bool AddAccess(unsigned int _pass, unsigned int _resource, unsigned int _state, bool _write);
+	void CullPasses();
+	bool ComputeLifetimes();
+	void PlaceTransientResources();
+	bool BuildBarriers();
+	unsigned int GetMergedReadState(unsigned int _compiledPass, unsigned int _resource) const;
+	unsigned int FindAliasedResource(unsigned int _resource) const;
+	bool AddBarrier(void* _resource, void* _aliasedResource, unsigned int _stateBefore, unsigned int _stateAfter, bool _aliasing);
+};
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include "RenderSnapshotClass.h"
+
+/*
+	Constructor
+*/
+RenderSnapshotClass::RenderSnapshotClass()
+{
+	m_frameNumber = 0;
+	m_inputTime = 0;
+	m_viewMatrix = MathClass::Identity();
+	m_draws = nullptr;
+	m_maxDraws = 0;
+	m_submittedDraws.store(0);
+}
+
+/*
+	Destructor
+*/
+RenderSnapshotClass::~RenderSnapshotClass()
+{
+
+}
+
+/*
+	Allocate room for the draws of one frame
+*/
+bool RenderSnapshotClass::Initialize(unsigned int _maxDraws)
+{
+	if (_maxDraws == 0)
+	{
+		return false;
+	}
+
+	m_draws = new SnapshotDraw[_maxDraws];
+	if (!m_draws)
+	{
+		return false;
+	}
+
+	m_maxDraws = _maxDraws;
+	m_submittedDraws.store(0);
+
+	return true;
+}
+
+void RenderSnapshotClass::Shutdown()
+{
+	if (m_draws)
+	{
+		delete[] m_draws;
+		m_draws = nullptr;
+	}
+
+	m_maxDraws = 0;
+	m_submittedDraws.store(0);
+}
+
+/*
+	Start writing the snapshot of a frame, the draws of the frame it held before are dropped
+	The camera starts where the last frame left it
+*/
+void RenderSnapshotClass::Reset(unsigned long long _frameNumber, unsigned long long _inputTime, const Matrix4& _viewMatrix)
+{
+	m_frameNumber = _frameNumber;
+	m_inputTime = _inputTime;
+	m_viewMatrix = _viewMatrix;
+	m_submittedDraws.store(0, std::memory_order_release);
+}
+
+void RenderSnapshotClass::SetViewMatrix(const Matrix4& _viewMatrix)
+{
+	m_viewMatrix = _viewMatrix;
+}
+
+/*
+	Add a draw of one instance to the frame, _center and _radius bound it in world space
+	Fails if a handle does not fit into its part of the sort key or the snapshot is full
+	Whether the mesh exists is only known to the graphicsclass, draws of unknown meshes are dropped when they are rendered
+*/
+bool RenderSnapshotClass::SubmitDraw(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, const Vector3& _center, float _radius, unsigned int _instance)
+{
+	if (_pass >= MAX_DRAW_PASSES || _pipeline >= MAX_DRAW_PIPELINES || _material >= MAX_DRAW_MATERIALS)
+	{
+		return false;
+	}
+
+	unsigned int index = m_submittedDraws.fetch_add(1, std::memory_order_relaxed);
+	if (index >= m_maxDraws)
+	{
+		return false;
+	}
+
+	SnapshotDraw& draw = m_draws[index];
+	draw.center = _center;
+	draw.radius = _radius;
+	draw.pass = _pass;
+	draw.pipeline = _pipeline;
+	draw.material = _material;
+	draw.mesh = _mesh;
+	draw.instance = _instance;
+
+	return true;
+}
+
+unsigned long long RenderSnapshotClass::GetFrameNumber() const
+{
+	return m_frameNumber;
+}
+
+/*
+	When the input of the frame was sampled, in microseconds of TimerClass
+*/
+unsigned long long RenderSnapshotClass::GetInputTime() const
+{
+	return m_inputTime;
+}
+
+const Matrix4& RenderSnapshotClass::GetViewMatrix() const
+{
+	return m_viewMatrix;
+}
+
+const SnapshotDraw* RenderSnapshotClass::GetDraws() const
+{
+	return m_draws;
+}
+
+unsigned int RenderSnapshotClass::GetDrawCount() const
+{
+	unsigned int submittedDraws = m_submittedDraws.load(std::memory_order_acquire);
+
+	return submittedDraws < m_maxDraws ? submittedDraws : m_maxDraws;
+}
+
+/*
+	Draws which did not fit into the snapshot
+*/
+unsigned int RenderSnapshotClass::GetDroppedDrawCount() const
+{
+	unsigned int submittedDraws = m_submittedDraws.load(std::memory_order_relaxed);
+
+	return submittedDraws > m_maxDraws ? submittedDraws - m_maxDraws : 0;
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#include "DrawBatcherClass.h"
+#include "MathClass.h"
+#pragma endregion
+
+//	A draw as the simulation submits it, the renderer culls it and picks its level of detail before it becomes a packet of the draw batcher
+struct SnapshotDraw
+{
+	Vector3 center;				// world space bounding sphere
+	float radius;
+	unsigned int pass;
+	unsigned int pipeline;
+	unsigned int material;
+	unsigned int mesh;			// mesh of GraphicsClass::AddMesh (GraphicsClass::GetMesh)
+	unsigned int instance;
+};
+
+/*
+	Everything the graphicsclass needs to render one frame, written by the simulation and read by the renderer
+	The simulation fills it once its steps of the frame are done (camera and draws), after that it is not changed until it was rendered
+	So the renderer can work on it on its own thread while the simulation already runs the next frame, see RenderThreadClass
+	The draws keep their bounding spheres, the renderer culls them against the camera of the snapshot and picks their levels of detail,
+	only then they are packed into the sort keys of the draw batcher, with the distance to the camera as depth
+	SubmitDraw can be called from any thread (lock-free), e.g. from the systems of the world
+	Allocates everything in Initialize
+*/
+class RenderSnapshotClass
+{
+public:
+	RenderSnapshotClass();
+	~RenderSnapshotClass();
+
+	bool Initialize(unsigned int _maxDraws);
+	void Shutdown();
+
+	void Reset(unsigned long long _frameNumber, unsigned long long _inputTime, const Matrix4& _viewMatrix);
+	void SetViewMatrix(const Matrix4& _viewMatrix);
+	bool SubmitDraw(unsigned int _pass, unsigned int _pipeline, unsigned int _material, unsigned int _mesh, const Vector3& _center, float _radius, unsigned int _instance);
+
+	unsigned long long GetFrameNumber() const;
+	unsigned long long GetInputTime() const;
+	const Matrix4& GetViewMatrix() const;
+	const SnapshotDraw* GetDraws() const;
+	unsigned int GetDrawCount() const;
+	unsigned int GetDroppedDrawCount() const;
+
+private:
+	unsigned long long m_frameNumber;
+	unsigned long long m_inputTime;		// microseconds of TimerClass, when the input of the frame was sampled
+	Matrix4 m_viewMatrix;
+
+	SnapshotDraw* m_draws;
+	unsigned int m_maxDraws;
+	std::atomic<unsigned int> m_submittedDraws;
+};
\ No newline at end of file
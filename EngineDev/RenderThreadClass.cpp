@@ -0,0 +1,241 @@
+#include "RenderThreadClass.h"
+#include "ProfilerClass.h"
+#include "TimerClass.h"
+
+/*
+	Constructor
+*/
+RenderThreadClass::RenderThreadClass()
+{
+	m_graphics = nullptr;
+	m_jobSystem = nullptr;
+	m_pipelineDepth = 0;
+	m_snapshotCount = 0;
+	m_submittedCount = 0;
+	m_renderedCount = 0;
+	m_quit = false;
+	m_failed = false;
+}
+
+/*
+	Destructor
+*/
+RenderThreadClass::~RenderThreadClass()
+{
+
+}
+
+/*
+	Create a snapshot for every frame which may be in the pipeline, each with room for _maxDraws draws
+	Start the render thread unless the pipeline depth is 0, the jobsystem needs a queue reserved for it (see JobSystemClass::Initialize)
+*/
+bool RenderThreadClass::Initialize(GraphicsClass* _graphics, JobSystemClass* _jobSystem, unsigned int _pipelineDepth, unsigned int _maxDraws)
+{
+	if (!_graphics || _pipelineDepth > MAX_RENDER_PIPELINE_DEPTH)
+	{
+		return false;
+	}
+
+	m_graphics = _graphics;
+	m_jobSystem = _jobSystem;
+	m_pipelineDepth = _pipelineDepth;
+	m_submittedCount = 0;
+	m_renderedCount = 0;
+	m_quit = false;
+	m_failed = false;
+
+	m_snapshotCount = _pipelineDepth + 1;
+	for (unsigned int i = 0; i < m_snapshotCount; i++)
+	{
+		if (!m_snapshots[i].Initialize(_maxDraws))
+		{
+			return false;
+		}
+	}
+
+	if (m_pipelineDepth > 0)
+	{
+		m_thread = std::thread(&RenderThreadClass::RenderThread, this);
+	}
+
+	return true;
+}
+
+/*
+	Let the render thread finish the submitted snapshots and join it
+*/
+void RenderThreadClass::Shutdown()
+{
+	if (m_thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_all();
+
+		m_thread.join();
+	}
+
+	for (unsigned int i = 0; i < m_snapshotCount; i++)
+	{
+		m_snapshots[i].Shutdown();
+	}
+
+	m_snapshotCount = 0;
+	m_graphics = nullptr;
+}
+
+/*
+	Simulation only
+	The snapshot to write the next frame into, waits while the simulation is pipeline depth frames ahead of the renderer
+	Returns nullptr once rendering a frame failed
+*/
+RenderSnapshotClass* RenderThreadClass::Acquire()
+{
+	PROFILE_SCOPE("RenderThreadClass::Acquire");
+
+	if (m_pipelineDepth == 0)
+	{
+		return m_failed ? nullptr : &m_snapshots[0];
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_submittedCount - m_renderedCount > m_pipelineDepth && !m_failed)
+	{
+		m_condition.wait(lock);
+	}
+
+	if (m_failed)
+	{
+		return nullptr;
+	}
+
+	return &m_snapshots[m_submittedCount % m_snapshotCount];
+}
+
+/*
+	Simulation only
+	Hand the acquired snapshot to the renderer, without a render thread it is rendered right away
+	Returns false once rendering a frame failed
+*/
+bool RenderThreadClass::Submit()
+{
+	if (m_pipelineDepth == 0)
+	{
+		m_submittedCount++;
+		if (!RenderSnapshot(m_snapshots[0]))
+		{
+			m_failed = true;
+		}
+		m_renderedCount++;
+
+		return !m_failed;
+	}
+
+	bool failed;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_submittedCount++;
+		failed = m_failed;
+	}
+	m_condition.notify_all();
+
+	return !failed;
+}
+
+/*
+	Wait until the renderer is done with every submitted snapshot, e.g. before reading its statistics
+*/
+void RenderThreadClass::WaitForIdle()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_renderedCount < m_submittedCount)
+	{
+		m_condition.wait(lock);
+	}
+}
+
+unsigned int RenderThreadClass::GetPipelineDepth() const
+{
+	return m_pipelineDepth;
+}
+
+/*
+	Milliseconds from sampling the input of a frame until the renderer submitted it, only read it while the renderer is idle
+*/
+const FrameStatisticsClass& RenderThreadClass::GetLatencyStatistics() const
+{
+	return m_latencyStatistics;
+}
+
+/*
+	Milliseconds the renderer spent on a frame, only read it while the renderer is idle
+*/
+const FrameStatisticsClass& RenderThreadClass::GetRenderStatistics() const
+{
+	return m_renderStatistics;
+}
+
+/*
+	Render one snapshot and measure it
+*/
+bool RenderThreadClass::RenderSnapshot(const RenderSnapshotClass& _snapshot)
+{
+	unsigned long long renderStart = TimerClass::GetMicroseconds();
+
+	bool result = m_graphics->Frame(_snapshot);
+
+	unsigned long long renderEnd = TimerClass::GetMicroseconds();
+	m_renderStatistics.AddFrameTime(static_cast<double>(renderEnd - renderStart) * 0.001);
+	m_latencyStatistics.AddFrameTime(static_cast<double>(renderEnd - _snapshot.GetInputTime()) * 0.001);
+
+	return result;
+}
+
+/*
+	Loop of the render thread
+	Render the submitted snapshots in order, wake the simulation whenever a snapshot is free again
+	Sleep while there is nothing to render, quit once Shutdown asked for it and every submitted snapshot is rendered
+*/
+void RenderThreadClass::RenderThread()
+{
+	bool attached = m_jobSystem && m_jobSystem->AttachThread();
+
+	while (true)
+	{
+		const RenderSnapshotClass* snapshot = nullptr;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			while (m_renderedCount == m_submittedCount && !m_quit)
+			{
+				m_condition.wait(lock);
+			}
+
+			if (m_renderedCount == m_submittedCount)
+			{
+				break;
+			}
+
+			snapshot = &m_snapshots[m_renderedCount % m_snapshotCount];
+		}
+
+		bool result = RenderSnapshot(*snapshot);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!result)
+			{
+				m_failed = true;
+			}
+			m_renderedCount++;
+		}
+		m_condition.notify_all();
+	}
+
+	if (attached)
+	{
+		m_jobSystem->DetachThread();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#pragma region includes
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "GraphicsClass.h"
+#include "RenderSnapshotClass.h"
+#include "FrameStatisticsClass.h"
+#include "JobSystemClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_RENDER_PIPELINE_DEPTH = 3;		// frames the simulation may run ahead of the renderer
+#pragma endregion
+
+/*
+	Hands the snapshots of the simulation to the graphicsclass, with or without a thread of its own
+	Pipeline depth 0: Submit renders the snapshot right away on the calling thread, simulation and rendering alternate
+	Pipeline depth n: a render thread renders the snapshots in order while the simulation already writes the next ones
+	   depth + 1 snapshots are kept, the simulation may run up to depth frames ahead before Acquire waits for the renderer (1 = double buffered)
+	A snapshot is never written while it is rendered: the simulation only writes the one Acquire hands out, the renderer only reads submitted ones
+	The render thread attaches to the jobsystem, so culling, sorting and recording still spread over the workers
+	Measures how long a frame takes from sampling its input until the renderer submitted it, the latency of the pipelining shows up there
+	Nothing is allocated after Initialize
+*/
+class RenderThreadClass
+{
+public:
+	RenderThreadClass();
+	~RenderThreadClass();
+
+	bool Initialize(GraphicsClass* _graphics, JobSystemClass* _jobSystem, unsigned int _pipelineDepth, unsigned int _maxDraws);
+	void Shutdown();
+
+	RenderSnapshotClass* Acquire();
+	bool Submit();
+	void WaitForIdle();
+
+	unsigned int GetPipelineDepth() const;
+	const FrameStatisticsClass& GetLatencyStatistics() const;
+	const FrameStatisticsClass& GetRenderStatistics() const;
+
+private:
+	GraphicsClass* m_graphics;
+	JobSystemClass* m_jobSystem;
+	unsigned int m_pipelineDepth;
+
+	RenderSnapshotClass m_snapshots[MAX_RENDER_PIPELINE_DEPTH + 1];
+	unsigned int m_snapshotCount;
+
+	std::thread m_thread;
+	std::mutex m_mutex;
+	std::condition_variable m_condition;
+	unsigned long long m_submittedCount;		// snapshots the simulation handed over
+	unsigned long long m_renderedCount;			// snapshots the renderer is done with
+	bool m_quit;
+	bool m_failed;
+
+	FrameStatisticsClass m_latencyStatistics;	// input sampled to frame submitted
+	FrameStatisticsClass m_renderStatistics;	// time spent in GraphicsClass::Frame
+
+	bool RenderSnapshot(const RenderSnapshotClass& _snapshot);
+	void RenderThread();
+};
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#pragma region includes
+#include "JobSystemClass.h"
+#include "DrawBatcherClass.h"
+#include "MeshAssetClass.h"
+#include "CommandCaptureClass.h"
+#include "PresentPolicyClass.h"
+#pragma endregion
+
+/*
+	Base class for the backends the graphicsclass renders with
+	D3DClass renders with DirectX 12 into a window, NullRendererClass runs without a window and without a GPU
+	SoftwareRendererClass renders on the CPU, with or without a window
+*/
+class RendererClass
+{
+public:
+	virtual ~RendererClass() {}
+
+	virtual bool Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem) = 0;
+	virtual void Shutdown() = 0;
+
+	virtual bool Render() = 0;
+
+	//	Wait until the next frame can be presented without blocking, called before the input of the frame is sampled
+	//	With a render thread it is called on the simulation thread while the render thread renders
+	virtual bool WaitForFrameLatency() { return true; }
+
+	//	The input of the frame which is rendered next was sampled at this time (microseconds of TimerClass)
+	virtual void BeginFrame(unsigned long long _inputTime) {}
+
+	//	The draws of every frame, backends which record commands record its batches in their geometry pass
+	virtual void SetDrawBatcher(const DrawBatcherClass* _drawBatcher) {}
+
+	//	Handle of the pipeline in the pipeline cache of the backend (PipelineCacheClass::Request), the draws of the batcher take it
+	//	Backends which do not record draws have no pipelines, they return INVALID_PIPELINE
+	virtual unsigned int RequestPipeline(const PipelineDesc& _desc) { return INVALID_PIPELINE; }
+
+	//	Vertex and index buffer of a cooked mesh, _drawMesh covers its whole index buffer, the caller narrows it to a level of detail
+	//	Backends without GPU buffers only fill in the sizes and ranges, the addresses stay 0
+	virtual bool CreateMesh(const MeshAssetHeader& _mesh, DrawMesh& _drawMesh) { FillDrawMesh(_mesh, 0, 0, _drawMesh); return true; }
+
+	static void FillDrawMesh(const MeshAssetHeader& _mesh, unsigned long long _vertexBufferAddress, unsigned long long _indexBufferAddress, DrawMesh& _drawMesh)
+	{
+		_drawMesh.vertexBufferAddress = _vertexBufferAddress;
+		_drawMesh.vertexBufferSize = _mesh.vertexCount * static_cast<unsigned int>(sizeof(MeshVertex));
+		_drawMesh.vertexStride = sizeof(MeshVertex);
+		_drawMesh.indexBufferAddress = _indexBufferAddress;
+		_drawMesh.indexBufferSize = _mesh.indexCount * _mesh.indexSize;
+		_drawMesh.indices32Bit = _mesh.indexSize == 4;
+		_drawMesh.indexCount = _mesh.indexCount;
+		_drawMesh.firstIndex = 0;
+		_drawMesh.baseVertex = 0;
+	}
+
+	//	Write the last presented frame to an image file, only backends with a CPU readable framebuffer can
+	virtual bool SaveScreenshot(const char* _path) { return false; }
+
+	//	The commands of the last frames, only backends which record commands capture them
+	virtual const CommandCaptureClass* GetCommandCapture() const { return nullptr; }
+
+	//	How the frames are presented and how long their input took to reach the screen, only backends with a swap chain (real or simulated) have one
+	virtual const PresentPolicyClass* GetPresentPolicy() const { return nullptr; }
+};
\ No newline at end of file
@@ -0,0 +1,358 @@
+#include "SceneFileClass.h"
+#include "HashClass.h"
+#include <cstdio>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned char SECTION_UNLOADED = 0;
+static const unsigned char SECTION_LOADED = 1;
+static const unsigned char SECTION_BROKEN = 2;
+
+//	Every section struct is an array of relative pointers, these are the sizes of the elements they point to
+static const unsigned int SECTION_ARRAY_COUNTS[SCENE_SECTION_COUNT] = { 10, 6, 2 };
+static const size_t SECTION_ELEMENT_SIZES[SCENE_SECTION_COUNT][SCENE_MAX_SECTION_ARRAYS] =
+{
+	{ 4, 4, 4, 4, 4, 4, 4, 4, 4, 4 },
+	{ 4, 4, 4, 4, 4, 4 },
+	{ 8, 4 }
+};
+
+static_assert(sizeof(SceneTransformSection) == 10 * sizeof(long long), "the transform section may only hold relative pointers");
+static_assert(sizeof(SceneBoundsSection) == 6 * sizeof(long long), "the bounds section may only hold relative pointers");
+static_assert(sizeof(SceneMeshSection) == 2 * sizeof(long long), "the mesh section may only hold relative pointers");
+#pragma endregion
+
+/*
+	_size rounded up to the next multiple of SCENE_SECTION_ALIGNMENT
+*/
+static unsigned long long AlignSection(unsigned long long _size)
+{
+	return (_size + SCENE_SECTION_ALIGNMENT - 1) & ~static_cast<unsigned long long>(SCENE_SECTION_ALIGNMENT - 1);
+}
+
+/*
+	Bytes of a section of the given type: the relative pointers, then every array padded to a cache line
+*/
+static unsigned long long GetSectionSize(unsigned int _type, unsigned int _objectCount)
+{
+	unsigned long long size = AlignSection(SECTION_ARRAY_COUNTS[_type] * sizeof(long long));
+
+	for (unsigned int i = 0; i < SECTION_ARRAY_COUNTS[_type]; i++)
+	{
+		size += AlignSection(static_cast<unsigned long long>(_objectCount) * SECTION_ELEMENT_SIZES[_type][i]);
+	}
+
+	return size;
+}
+
+/*
+	Constructor
+*/
+SceneFileClass::SceneFileClass()
+{
+	m_objectCount = 0;
+
+	for (unsigned int i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		m_sections[i] = nullptr;
+		m_sectionStates[i] = SECTION_UNLOADED;
+	}
+}
+
+/*
+	Destructor
+*/
+SceneFileClass::~SceneFileClass()
+{
+
+}
+
+/*
+	Map the file and check the header: magic, format version, size
+	Check the index table against its hash, every section has to lie aligned inside the file
+	Remember the sections of the known types and versions, nothing behind the index table is read
+*/
+bool SceneFileClass::Open(const char* _path)
+{
+	Close();
+
+	if (!m_file.Open(_path))
+	{
+		return false;
+	}
+
+	const unsigned char* data = static_cast<const unsigned char*>(m_file.GetData());
+	size_t fileSize = m_file.GetSize();
+
+	if (fileSize < sizeof(SceneFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(data);
+	if (header->magic != SCENE_FILE_MAGIC || header->formatVersion != SCENE_FILE_FORMAT_VERSION || header->fileSize != fileSize)
+	{
+		Close();
+		return false;
+	}
+
+	size_t indexSize = static_cast<size_t>(header->sectionCount) * sizeof(SceneSectionEntry);
+	if (indexSize > fileSize - sizeof(SceneFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	const SceneSectionEntry* sections = reinterpret_cast<const SceneSectionEntry*>(data + sizeof(SceneFileHeader));
+	if (HashClass::Hash(sections, indexSize) != header->indexHash)
+	{
+		Close();
+		return false;
+	}
+
+	for (unsigned int i = 0; i < header->sectionCount; i++)
+	{
+		const SceneSectionEntry& section = sections[i];
+		if (section.offset > fileSize || section.size > fileSize - section.offset || section.offset % SCENE_SECTION_ALIGNMENT != 0)
+		{
+			Close();
+			return false;
+		}
+
+		//	Sections of newer types or versions are left to the versions which know them
+		if (section.type < SCENE_SECTION_COUNT && section.version == SCENE_SECTION_VERSION && !m_sections[section.type])
+		{
+			m_sections[section.type] = &section;
+		}
+	}
+
+	m_objectCount = header->objectCount;
+
+	return true;
+}
+
+void SceneFileClass::Close()
+{
+	m_file.Close();
+	m_objectCount = 0;
+
+	for (unsigned int i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		m_sections[i] = nullptr;
+		m_sectionStates[i] = SECTION_UNLOADED;
+	}
+}
+
+bool SceneFileClass::IsOpen() const
+{
+	return m_file.IsOpen();
+}
+
+unsigned int SceneFileClass::GetObjectCount() const
+{
+	return m_objectCount;
+}
+
+/*
+	Whether the section was touched and passed its check
+*/
+bool SceneFileClass::IsSectionLoaded(unsigned int _type) const
+{
+	return _type < SCENE_SECTION_COUNT && m_sectionStates[_type] == SECTION_LOADED;
+}
+
+/*
+	Position, rotation and scale of every object, nullptr if the file has no valid transform section
+*/
+const SceneTransformSection* SceneFileClass::GetTransforms()
+{
+	return static_cast<const SceneTransformSection*>(LoadSection(SCENE_SECTION_TRANSFORMS));
+}
+
+/*
+	World space bounds of every object, nullptr if the file has no valid bounds section
+*/
+const SceneBoundsSection* SceneFileClass::GetBounds()
+{
+	return static_cast<const SceneBoundsSection*>(LoadSection(SCENE_SECTION_BOUNDS));
+}
+
+/*
+	Mesh and material of every object, nullptr if the file has no valid mesh section
+*/
+const SceneMeshSection* SceneFileClass::GetMeshes()
+{
+	return static_cast<const SceneMeshSection*>(LoadSection(SCENE_SECTION_MESHES));
+}
+
+/*
+	The section in place, checked on its first touch
+	Ask the operating system to page the section in at once, instead of one fault per page while it is hashed
+	Check its hash and that every relative pointer points to an aligned array of m_objectCount elements inside of the section
+*/
+const void* SceneFileClass::LoadSection(unsigned int _type)
+{
+	const SceneSectionEntry* section = m_sections[_type];
+	if (!section || m_sectionStates[_type] == SECTION_BROKEN)
+	{
+		return nullptr;
+	}
+
+	const unsigned char* data = static_cast<const unsigned char*>(m_file.GetData()) + section->offset;
+	if (m_sectionStates[_type] == SECTION_LOADED)
+	{
+		return data;
+	}
+
+	m_file.Prefetch(static_cast<size_t>(section->offset), static_cast<size_t>(section->size));
+
+	bool valid = section->size >= SECTION_ARRAY_COUNTS[_type] * sizeof(long long) && HashClass::Hash(data, static_cast<size_t>(section->size)) == section->hash;
+
+	for (unsigned int i = 0; valid && i < SECTION_ARRAY_COUNTS[_type]; i++)
+	{
+		long long offset;
+		memcpy(&offset, data + i * sizeof(long long), sizeof(offset));
+
+		long long arrayBegin = static_cast<long long>(i * sizeof(long long)) + offset;
+		unsigned long long arraySize = static_cast<unsigned long long>(m_objectCount) * SECTION_ELEMENT_SIZES[_type][i];
+
+		valid = offset != 0 && arrayBegin >= 0 && arrayBegin % SCENE_SECTION_ALIGNMENT == 0 &&
+			static_cast<unsigned long long>(arrayBegin) <= section->size && arraySize <= section->size - static_cast<unsigned long long>(arrayBegin);
+	}
+
+	m_sectionStates[_type] = valid ? SECTION_LOADED : SECTION_BROKEN;
+
+	return valid ? data : nullptr;
+}
+
+/*
+	Write the objects into a temporary file next to _path, then replace _path with it
+	The whole file is laid out in memory first: header, index table, then the sections in the order of their types
+	Every section starts with its relative pointers, the arrays follow in the order of the pointers
+*/
+bool SceneFileClass::Write(const char* _path, const SceneObject* _objects, unsigned int _objectCount)
+{
+	char temporaryPath[512];
+	if (snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", _path) >= static_cast<int>(sizeof(temporaryPath)))
+	{
+		return false;
+	}
+
+	SceneSectionEntry sections[SCENE_SECTION_COUNT];
+	unsigned long long offset = AlignSection(sizeof(SceneFileHeader) + sizeof(sections));
+	for (unsigned int i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		sections[i].type = i;
+		sections[i].version = SCENE_SECTION_VERSION;
+		sections[i].offset = offset;
+		sections[i].size = GetSectionSize(i, _objectCount);
+		sections[i].hash = 0;
+
+		offset += sections[i].size;
+	}
+
+	unsigned long long fileSize = offset;
+	if (fileSize != static_cast<size_t>(fileSize))
+	{
+		return false;
+	}
+
+	unsigned char* file = new unsigned char[static_cast<size_t>(fileSize)];
+	if (!file)
+	{
+		return false;
+	}
+
+	memset(file, 0, static_cast<size_t>(fileSize));
+
+	//	Point the relative pointers of every section to its arrays
+	unsigned char* arrays[SCENE_SECTION_COUNT][SCENE_MAX_SECTION_ARRAYS];
+	for (unsigned int i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		unsigned char* section = file + sections[i].offset;
+		unsigned long long arrayOffset = AlignSection(SECTION_ARRAY_COUNTS[i] * sizeof(long long));
+
+		for (unsigned int j = 0; j < SECTION_ARRAY_COUNTS[i]; j++)
+		{
+			long long relativeOffset = static_cast<long long>(arrayOffset) - static_cast<long long>(j * sizeof(long long));
+			memcpy(section + j * sizeof(long long), &relativeOffset, sizeof(relativeOffset));
+
+			arrays[i][j] = section + arrayOffset;
+			arrayOffset += AlignSection(static_cast<unsigned long long>(_objectCount) * SECTION_ELEMENT_SIZES[i][j]);
+		}
+	}
+
+	float* transforms[SCENE_MAX_SECTION_ARRAYS];
+	float* bounds[SCENE_MAX_SECTION_ARRAYS];
+	for (unsigned int i = 0; i < SCENE_MAX_SECTION_ARRAYS; i++)
+	{
+		transforms[i] = i < SECTION_ARRAY_COUNTS[SCENE_SECTION_TRANSFORMS] ? reinterpret_cast<float*>(arrays[SCENE_SECTION_TRANSFORMS][i]) : nullptr;
+		bounds[i] = i < SECTION_ARRAY_COUNTS[SCENE_SECTION_BOUNDS] ? reinterpret_cast<float*>(arrays[SCENE_SECTION_BOUNDS][i]) : nullptr;
+	}
+	unsigned long long* meshIds = reinterpret_cast<unsigned long long*>(arrays[SCENE_SECTION_MESHES][0]);
+	unsigned int* materials = reinterpret_cast<unsigned int*>(arrays[SCENE_SECTION_MESHES][1]);
+
+	for (unsigned int i = 0; i < _objectCount; i++)
+	{
+		const SceneObject& object = _objects[i];
+
+		transforms[0][i] = object.position.x;
+		transforms[1][i] = object.position.y;
+		transforms[2][i] = object.position.z;
+		transforms[3][i] = object.rotation.x;
+		transforms[4][i] = object.rotation.y;
+		transforms[5][i] = object.rotation.z;
+		transforms[6][i] = object.rotation.w;
+		transforms[7][i] = object.scale.x;
+		transforms[8][i] = object.scale.y;
+		transforms[9][i] = object.scale.z;
+
+		bounds[0][i] = object.boundsCenter.x;
+		bounds[1][i] = object.boundsCenter.y;
+		bounds[2][i] = object.boundsCenter.z;
+		bounds[3][i] = object.boundsExtent.x;
+		bounds[4][i] = object.boundsExtent.y;
+		bounds[5][i] = object.boundsExtent.z;
+
+		meshIds[i] = object.meshId;
+		materials[i] = object.material;
+	}
+
+	for (unsigned int i = 0; i < SCENE_SECTION_COUNT; i++)
+	{
+		sections[i].hash = HashClass::Hash(file + sections[i].offset, static_cast<size_t>(sections[i].size));
+	}
+
+	SceneFileHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SCENE_FILE_MAGIC;
+	header.formatVersion = SCENE_FILE_FORMAT_VERSION;
+	header.objectCount = _objectCount;
+	header.sectionCount = SCENE_SECTION_COUNT;
+	header.fileSize = fileSize;
+	header.indexHash = HashClass::Hash(sections, sizeof(sections));
+
+	memcpy(file, &header, sizeof(header));
+	memcpy(file + sizeof(header), sections, sizeof(sections));
+
+	FILE* output = fopen(temporaryPath, "wb");
+	bool written = output && fwrite(file, 1, static_cast<size_t>(fileSize), output) == fileSize;
+
+	delete[] file;
+
+	if (!output || fclose(output) != 0 || !written)
+	{
+		remove(temporaryPath);
+		return false;
+	}
+
+	//	rename does not replace existing files on every platform
+	remove(_path);
+	if (rename(temporaryPath, _path) != 0)
+	{
+		return false;
+	}
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "MappedFileClass.h"
+#include "MathClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int SCENE_FILE_MAGIC = 0x4E454353;			// "SCEN"
+const unsigned int SCENE_FILE_FORMAT_VERSION = 1;			// bump whenever the header or the index table changes
+const size_t SCENE_SECTION_ALIGNMENT = 64;					// every section and every array inside of it starts on a cache line
+
+const unsigned int SCENE_SECTION_TRANSFORMS = 0;
+const unsigned int SCENE_SECTION_BOUNDS = 1;
+const unsigned int SCENE_SECTION_MESHES = 2;
+const unsigned int SCENE_SECTION_COUNT = 3;
+const unsigned int SCENE_SECTION_VERSION = 1;				// bump whenever the layout of a section changes
+const unsigned int SCENE_MAX_SECTION_ARRAYS = 10;
+#pragma endregion
+
+/*
+	Pointer stored as the distance in bytes from itself to its target, 0 = no target
+	Stays valid wherever the file is mapped, so nothing has to be fixed up after loading
+*/
+template<typename _Type>
+struct RelativePointer
+{
+	long long offset;
+
+	const _Type* Get() const
+	{
+		return offset != 0 ? reinterpret_cast<const _Type*>(reinterpret_cast<const unsigned char*>(this) + offset) : nullptr;
+	}
+};
+
+struct SceneFileHeader
+{
+	unsigned int magic;
+	unsigned int formatVersion;
+	unsigned int objectCount;		// every array of every section holds this many elements
+	unsigned int sectionCount;		// entries of the index table behind the header
+	unsigned long long fileSize;
+	unsigned long long indexHash;	// hash over the index table
+};
+
+struct SceneSectionEntry
+{
+	unsigned int type;
+	unsigned int version;
+	unsigned long long offset;		// from the start of the file, aligned to SCENE_SECTION_ALIGNMENT
+	unsigned long long size;
+	unsigned long long hash;		// HashClass::Hash of the whole section
+};
+
+/*
+	The sections only hold relative pointers to their arrays, one array per component (SoA)
+	Every array is padded with zeros to a multiple of SCENE_SECTION_ALIGNMENT bytes, so SIMD loops may read whole cache lines
+*/
+struct SceneTransformSection
+{
+	RelativePointer<float> positionX;
+	RelativePointer<float> positionY;
+	RelativePointer<float> positionZ;
+	RelativePointer<float> rotationX;
+	RelativePointer<float> rotationY;
+	RelativePointer<float> rotationZ;
+	RelativePointer<float> rotationW;
+	RelativePointer<float> scaleX;
+	RelativePointer<float> scaleY;
+	RelativePointer<float> scaleZ;
+};
+
+//	World space axis aligned bounding boxes as center and half extents, the layout CullingClass::Build takes
+struct SceneBoundsSection
+{
+	RelativePointer<float> centerX;
+	RelativePointer<float> centerY;
+	RelativePointer<float> centerZ;
+	RelativePointer<float> extentX;
+	RelativePointer<float> extentY;
+	RelativePointer<float> extentZ;
+};
+
+struct SceneMeshSection
+{
+	RelativePointer<unsigned long long> meshIds;		// AssetPackageClass::GetAssetId of the mesh
+	RelativePointer<unsigned int> materials;
+};
+
+/*
+	An object of the scene to be written
+*/
+struct SceneObject
+{
+	Vector3 position;
+	Quaternion rotation;
+	Vector3 scale;
+	Vector3 boundsCenter;
+	Vector3 boundsExtent;
+	unsigned long long meshId;
+	unsigned int material;
+};
+
+/*
+	Versioned binary scene: header, index table, aligned sections (transforms, bounds, mesh references)
+	The file is memory-mapped and used in place, there is no parsing and no pointer to rebuild, the arrays are found through relative pointers
+	Open only checks the header and the index table, a section is paged in and checked on first touch (the Get functions)
+	A section which fails its check stays unavailable, a section type this version does not know is ignored
+	Not thread safe, load the sections once on one thread, afterwards the arrays may be read from everywhere
+*/
+class SceneFileClass
+{
+public:
+	SceneFileClass();
+	~SceneFileClass();
+
+	bool Open(const char* _path);
+	void Close();
+
+	bool IsOpen() const;
+	unsigned int GetObjectCount() const;
+	bool IsSectionLoaded(unsigned int _type) const;
+
+	const SceneTransformSection* GetTransforms();
+	const SceneBoundsSection* GetBounds();
+	const SceneMeshSection* GetMeshes();
+
+	static bool Write(const char* _path, const SceneObject* _objects, unsigned int _objectCount);
+
+private:
+	MappedFileClass m_file;
+	unsigned int m_objectCount;
+	const SceneSectionEntry* m_sections[SCENE_SECTION_COUNT];		// nullptr if the file does not have the section
+	unsigned char m_sectionStates[SCENE_SECTION_COUNT];
+
+	const void* LoadSection(unsigned int _type);
+};
\ No newline at end of file
@@ -0,0 +1,51 @@
+/*
+	Pipeline of the meshes of the scene (GraphicsClass::GetMeshPipeline), vertices as cooked by the AssetCooker (MeshVertex)
+	The draw constants in b0 are the material and the first instance of the draw (D3DCommandRecorderClass)
+	The transforms of the instances are not bound yet, the mesh is drawn inside of its bounds mapped to the screen
+*/
+cbuffer DrawConstants : register(b0)
+{
+	uint material;
+	uint firstInstance;
+};
+
+struct VertexInput
+{
+	float4 position : POSITION;		// R16G16B16A16_UNORM inside of the bounds of the mesh
+	float2 normal : NORMAL;			// R16G16_SNORM, octahedral
+	float2 texcoord : TEXCOORD;
+};
+
+struct PixelInput
+{
+	float4 position : SV_POSITION;
+	float3 normal : NORMAL;
+	float2 texcoord : TEXCOORD;
+};
+
+float3 DecodeOctahedral(float2 _encoded)
+{
+	float3 normal = float3(_encoded.x, _encoded.y, 1.0f - abs(_encoded.x) - abs(_encoded.y));
+	float fold = saturate(-normal.z);
+	normal.xy += normal.xy >= 0.0f ? -fold : fold;
+
+	return normalize(normal);
+}
+
+PixelInput VertexMain(VertexInput _input)
+{
+	PixelInput output;
+	output.position = float4(_input.position.xy * 2.0f - 1.0f, _input.position.z, 1.0f);
+	output.normal = DecodeOctahedral(_input.normal);
+	output.texcoord = _input.texcoord;
+
+	return output;
+}
+
+float4 PixelMain(PixelInput _input) : SV_TARGET
+{
+	float3 albedo = float3((material * 97u) % 255u, (material * 57u) % 255u, (material * 31u) % 255u) / 255.0f * 0.5f + 0.5f;
+	float light = saturate(dot(_input.normal, normalize(float3(0.3f, 0.8f, -0.5f)))) * 0.8f + 0.2f;
+
+	return float4(albedo * light, 1.0f);
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#pragma region pre-processing directives
+//	The instruction set is picked when compiling: AVX2 (x64 with /arch:AVX2 or -mavx2 -mfma), SSE (every x64 CPU), NEON (ARM64), otherwise scalar
+//	Define ENGINE_SIMD_SCALAR to compile the scalar fallback on every platform, e.g. to compare results
+#if !defined(ENGINE_SIMD_SCALAR)
+#if defined(__AVX2__)
+#define ENGINE_SIMD_AVX2
+#define ENGINE_SIMD_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ENGINE_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define ENGINE_SIMD_NEON
+#else
+#define ENGINE_SIMD_SCALAR
+#endif
+#endif
+#pragma endregion
+
+#pragma region includes
+#if defined(ENGINE_SIMD_AVX2)
+#include <immintrin.h>
+#elif defined(ENGINE_SIMD_SSE)
+#include <emmintrin.h>
+#elif defined(ENGINE_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+#pragma endregion
+
+#pragma region global variables
+#if defined(ENGINE_SIMD_AVX2)
+const char* const SIMD_INSTRUCTION_SET = "AVX2";
+#elif defined(ENGINE_SIMD_SSE)
+const char* const SIMD_INSTRUCTION_SET = "SSE";
+#elif defined(ENGINE_SIMD_NEON)
+const char* const SIMD_INSTRUCTION_SET = "NEON";
+#else
+const char* const SIMD_INSTRUCTION_SET = "scalar";
+#endif
+#pragma endregion
+
+/*
+	Four floats in one register of the instruction set, four plain floats for the scalar fallback
+*/
+#if defined(ENGINE_SIMD_SSE)
+typedef __m128 SimdFloat4;
+#elif defined(ENGINE_SIMD_NEON)
+typedef float32x4_t SimdFloat4;
+#else
+struct SimdFloat4
+{
+	float lanes[4];
+};
+#endif
+
+/*
+	The few 4-wide operations the math library is built on, so MathClass does not need a code path per instruction set
+	Load and Store expect 16 byte aligned memory, LoadUnaligned and StoreUnaligned take any address
+	MultiplyAdd is fused on AVX2 and NEON (one rounding), a multiply and an add on SSE and scalar
+*/
+class SimdClass
+{
+public:
+	static SimdFloat4 Load(const float* _values)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_load_ps(_values);
+#elif defined(ENGINE_SIMD_NEON)
+		return vld1q_f32(_values);
+#else
+		SimdFloat4 result = { { _values[0], _values[1], _values[2], _values[3] } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 LoadUnaligned(const float* _values)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_loadu_ps(_values);
+#else
+		return Load(_values);
+#endif
+	}
+
+	static void StoreUnaligned(float* _values, SimdFloat4 _a)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		_mm_storeu_ps(_values, _a);
+#else
+		Store(_values, _a);
+#endif
+	}
+
+	static void Store(float* _values, SimdFloat4 _a)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		_mm_store_ps(_values, _a);
+#elif defined(ENGINE_SIMD_NEON)
+		vst1q_f32(_values, _a);
+#else
+		_values[0] = _a.lanes[0];
+		_values[1] = _a.lanes[1];
+		_values[2] = _a.lanes[2];
+		_values[3] = _a.lanes[3];
+#endif
+	}
+
+	static SimdFloat4 Set(float _x, float _y, float _z, float _w)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_set_ps(_w, _z, _y, _x);
+#elif defined(ENGINE_SIMD_NEON)
+		float values[4] = { _x, _y, _z, _w };
+		return vld1q_f32(values);
+#else
+		SimdFloat4 result = { { _x, _y, _z, _w } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 Splat(float _value)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_set1_ps(_value);
+#elif defined(ENGINE_SIMD_NEON)
+		return vdupq_n_f32(_value);
+#else
+		SimdFloat4 result = { { _value, _value, _value, _value } };
+		return result;
+#endif
+	}
+
+	//	Copy one lane (0 - 3) into all four lanes
+	template<int _Lane>
+	static SimdFloat4 SplatLane(SimdFloat4 _a)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_shuffle_ps(_a, _a, _MM_SHUFFLE(_Lane, _Lane, _Lane, _Lane));
+#elif defined(ENGINE_SIMD_NEON)
+		return vdupq_laneq_f32(_a, _Lane);
+#else
+		return Splat(_a.lanes[_Lane]);
+#endif
+	}
+
+	static SimdFloat4 Add(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_add_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vaddq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] + _b.lanes[0], _a.lanes[1] + _b.lanes[1], _a.lanes[2] + _b.lanes[2], _a.lanes[3] + _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 Subtract(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_sub_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vsubq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] - _b.lanes[0], _a.lanes[1] - _b.lanes[1], _a.lanes[2] - _b.lanes[2], _a.lanes[3] - _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 Multiply(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_mul_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vmulq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] * _b.lanes[0], _a.lanes[1] * _b.lanes[1], _a.lanes[2] * _b.lanes[2], _a.lanes[3] * _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 Divide(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_div_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vdivq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] / _b.lanes[0], _a.lanes[1] / _b.lanes[1], _a.lanes[2] / _b.lanes[2], _a.lanes[3] / _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	//	_a * _b + _c
+	static SimdFloat4 MultiplyAdd(SimdFloat4 _a, SimdFloat4 _b, SimdFloat4 _c)
+	{
+#if defined(ENGINE_SIMD_AVX2)
+		return _mm_fmadd_ps(_a, _b, _c);
+#elif defined(ENGINE_SIMD_SSE)
+		return _mm_add_ps(_mm_mul_ps(_a, _b), _c);
+#elif defined(ENGINE_SIMD_NEON)
+		return vfmaq_f32(_c, _a, _b);
+#else
+		return Add(Multiply(_a, _b), _c);
+#endif
+	}
+
+	static SimdFloat4 Min(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_min_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vminq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] < _b.lanes[0] ? _a.lanes[0] : _b.lanes[0], _a.lanes[1] < _b.lanes[1] ? _a.lanes[1] : _b.lanes[1],
+			_a.lanes[2] < _b.lanes[2] ? _a.lanes[2] : _b.lanes[2], _a.lanes[3] < _b.lanes[3] ? _a.lanes[3] : _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	static SimdFloat4 Max(SimdFloat4 _a, SimdFloat4 _b)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_max_ps(_a, _b);
+#elif defined(ENGINE_SIMD_NEON)
+		return vmaxq_f32(_a, _b);
+#else
+		SimdFloat4 result = { { _a.lanes[0] > _b.lanes[0] ? _a.lanes[0] : _b.lanes[0], _a.lanes[1] > _b.lanes[1] ? _a.lanes[1] : _b.lanes[1],
+			_a.lanes[2] > _b.lanes[2] ? _a.lanes[2] : _b.lanes[2], _a.lanes[3] > _b.lanes[3] ? _a.lanes[3] : _b.lanes[3] } };
+		return result;
+#endif
+	}
+
+	//	Hint that the cache line at _address is needed soon, does nothing on the scalar fallback
+	static void Prefetch(const void* _address)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		_mm_prefetch(static_cast<const char*>(_address), _MM_HINT_T0);
+#elif defined(ENGINE_SIMD_NEON) && (defined(__GNUC__) || defined(__clang__))
+		__builtin_prefetch(_address);
+#else
+		(void)_address;
+#endif
+	}
+
+	//	Bit i is set if lane i is less than 0
+	static int NegativeMask(SimdFloat4 _a)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		return _mm_movemask_ps(_mm_cmplt_ps(_a, _mm_setzero_ps()));
+#elif defined(ENGINE_SIMD_NEON)
+		static const uint32_t bits[4] = { 1, 2, 4, 8 };
+		uint32x4_t negative = vcltq_f32(_a, vdupq_n_f32(0.0f));
+		return static_cast<int>(vaddvq_u32(vandq_u32(negative, vld1q_u32(bits))));
+#else
+		return (_a.lanes[0] < 0.0f ? 1 : 0) | (_a.lanes[1] < 0.0f ? 2 : 0) | (_a.lanes[2] < 0.0f ? 4 : 0) | (_a.lanes[3] < 0.0f ? 8 : 0);
+#endif
+	}
+
+	//	Transpose four rows in place
+	static void Transpose(SimdFloat4& _row0, SimdFloat4& _row1, SimdFloat4& _row2, SimdFloat4& _row3)
+	{
+#if defined(ENGINE_SIMD_SSE)
+		_MM_TRANSPOSE4_PS(_row0, _row1, _row2, _row3);
+#elif defined(ENGINE_SIMD_NEON)
+		float32x4x2_t row01 = vtrnq_f32(_row0, _row1);
+		float32x4x2_t row23 = vtrnq_f32(_row2, _row3);
+		_row0 = vcombine_f32(vget_low_f32(row01.val[0]), vget_low_f32(row23.val[0]));
+		_row1 = vcombine_f32(vget_low_f32(row01.val[1]), vget_low_f32(row23.val[1]));
+		_row2 = vcombine_f32(vget_high_f32(row01.val[0]), vget_high_f32(row23.val[0]));
+		_row3 = vcombine_f32(vget_high_f32(row01.val[1]), vget_high_f32(row23.val[1]));
+#else
+		SimdFloat4 rows[4] = { _row0, _row1, _row2, _row3 };
+		_row0 = Set(rows[0].lanes[0], rows[1].lanes[0], rows[2].lanes[0], rows[3].lanes[0]);
+		_row1 = Set(rows[0].lanes[1], rows[1].lanes[1], rows[2].lanes[1], rows[3].lanes[1]);
+		_row2 = Set(rows[0].lanes[2], rows[1].lanes[2], rows[2].lanes[2], rows[3].lanes[2]);
+		_row3 = Set(rows[0].lanes[3], rows[1].lanes[3], rows[2].lanes[3], rows[3].lanes[3]);
+#endif
+	}
+};
\ No newline at end of file
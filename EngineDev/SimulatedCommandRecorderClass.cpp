@@ -0,0 +1,138 @@
+#include "SimulatedCommandRecorderClass.h"
+
+/*
+	Constructor
+*/
+SimulatedCommandRecorderClass::SimulatedCommandRecorderClass()
+{
+	m_timestampQueries = nullptr;
+	m_barrierCount = 0;
+	m_barrierBatchCount = 0;
+	m_renderTargetCount = 0;
+	m_clearCount = 0;
+	m_stateChangeCount = 0;
+	m_drawCount = 0;
+	m_instanceCount = 0;
+}
+
+/*
+	Destructor
+*/
+SimulatedCommandRecorderClass::~SimulatedCommandRecorderClass()
+{
+
+}
+
+/*
+	The queries are not owned by the recorder
+*/
+bool SimulatedCommandRecorderClass::Initialize(SimulatedTimestampQueriesClass* _timestampQueries)
+{
+	if (!_timestampQueries)
+	{
+		return false;
+	}
+
+	m_timestampQueries = _timestampQueries;
+
+	return true;
+}
+
+void SimulatedCommandRecorderClass::Shutdown()
+{
+	m_timestampQueries = nullptr;
+}
+
+/*
+	Barriers and ResourceBarriers calls recorded so far
+*/
+unsigned long long SimulatedCommandRecorderClass::GetBarrierCount() const
+{
+	return m_barrierCount;
+}
+
+unsigned long long SimulatedCommandRecorderClass::GetBarrierBatchCount() const
+{
+	return m_barrierBatchCount;
+}
+
+/*
+	Render targets bound and cleared so far
+*/
+unsigned long long SimulatedCommandRecorderClass::GetRenderTargetCount() const
+{
+	return m_renderTargetCount;
+}
+
+unsigned long long SimulatedCommandRecorderClass::GetClearCount() const
+{
+	return m_clearCount;
+}
+
+/*
+	Pipeline, material and mesh changes recorded so far
+*/
+unsigned long long SimulatedCommandRecorderClass::GetStateChangeCount() const
+{
+	return m_stateChangeCount;
+}
+
+/*
+	Draw calls and the instances they drew
+*/
+unsigned long long SimulatedCommandRecorderClass::GetDrawCount() const
+{
+	return m_drawCount;
+}
+
+unsigned long long SimulatedCommandRecorderClass::GetInstanceCount() const
+{
+	return m_instanceCount;
+}
+
+void SimulatedCommandRecorderClass::ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount)
+{
+	m_barrierCount += _barrierCount;
+	m_barrierBatchCount++;
+}
+
+void SimulatedCommandRecorderClass::SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height)
+{
+	m_renderTargetCount++;
+}
+
+void SimulatedCommandRecorderClass::ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color)
+{
+	m_clearCount++;
+}
+
+void SimulatedCommandRecorderClass::SetPipeline(void* _pipeline)
+{
+	m_stateChangeCount++;
+}
+
+void SimulatedCommandRecorderClass::SetMaterial(unsigned int _material)
+{
+	m_stateChangeCount++;
+}
+
+void SimulatedCommandRecorderClass::SetMesh(const DrawMesh& _mesh)
+{
+	m_stateChangeCount++;
+}
+
+void SimulatedCommandRecorderClass::DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance)
+{
+	m_drawCount++;
+	m_instanceCount += _instanceCount;
+}
+
+void SimulatedCommandRecorderClass::WriteTimestamp(unsigned int _queryIndex)
+{
+	m_timestampQueries->WriteTimestamp(_queryIndex);
+}
+
+void SimulatedCommandRecorderClass::ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount)
+{
+	m_timestampQueries->ResolveTimestamps(_firstQuery, _queryCount);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#pragma region includes
+#include "CommandRecorderClass.h"
+#include "SimulatedTimestampQueriesClass.h"
+#pragma endregion
+
+/*
+	Recorder without a GPU, every command is executed the moment it is recorded
+	Barriers, render targets, clears, state changes and draws have nothing to do without a GPU, they are only counted
+*/
+class SimulatedCommandRecorderClass : public CommandRecorderClass
+{
+public:
+	SimulatedCommandRecorderClass();
+	~SimulatedCommandRecorderClass();
+
+	bool Initialize(SimulatedTimestampQueriesClass* _timestampQueries);
+	void Shutdown();
+
+	unsigned long long GetBarrierCount() const;
+	unsigned long long GetBarrierBatchCount() const;
+	unsigned long long GetRenderTargetCount() const;
+	unsigned long long GetClearCount() const;
+	unsigned long long GetStateChangeCount() const;
+	unsigned long long GetDrawCount() const;
+	unsigned long long GetInstanceCount() const;
+
+	void ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount) override;
+
+	void SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height) override;
+	void ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color) override;
+
+	void SetPipeline(void* _pipeline) override;
+	void SetMaterial(unsigned int _material) override;
+	void SetMesh(const DrawMesh& _mesh) override;
+	void DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance) override;
+
+	void WriteTimestamp(unsigned int _queryIndex) override;
+	void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount) override;
+
+private:
+	SimulatedTimestampQueriesClass* m_timestampQueries;
+	unsigned long long m_barrierCount;
+	unsigned long long m_barrierBatchCount;
+	unsigned long long m_renderTargetCount;
+	unsigned long long m_clearCount;
+	unsigned long long m_stateChangeCount;
+	unsigned long long m_drawCount;
+	unsigned long long m_instanceCount;
+};
\ No newline at end of file
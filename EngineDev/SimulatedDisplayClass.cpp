@@ -0,0 +1,199 @@
+#include "SimulatedDisplayClass.h"
+#include <cmath>
+
+/*
+	Constructor
+*/
+SimulatedDisplayClass::SimulatedDisplayClass()
+{
+	m_presentPolicy = nullptr;
+	m_refreshRate = 0.0;
+	m_firstPresent = 0;
+	m_presentCount = 0;
+	m_lastLeaveTime = 0;
+	m_presented = false;
+}
+
+/*
+	Destructor
+*/
+SimulatedDisplayClass::~SimulatedDisplayClass()
+{
+
+}
+
+/*
+	The display shows the presents of this policy, which also receives when they were shown
+	_refreshRate in Hz, 0 = no refreshes, the presents are shown as soon as they are ready
+*/
+bool SimulatedDisplayClass::Initialize(PresentPolicyClass* _presentPolicy, double _refreshRate)
+{
+	if (!_presentPolicy || _refreshRate < 0.0)
+	{
+		return false;
+	}
+
+	m_presentPolicy = _presentPolicy;
+	m_refreshRate = _refreshRate;
+	m_firstPresent = 0;
+	m_presentCount = 0;
+	m_lastLeaveTime = 0;
+	m_presented = false;
+
+	return true;
+}
+
+void SimulatedDisplayClass::Shutdown()
+{
+	m_presentPolicy = nullptr;
+	m_presentCount = 0;
+}
+
+/*
+	When the next frame may start, so that its present does not block: as soon as the queue has room for it
+*/
+unsigned long long SimulatedDisplayClass::GetFrameStartTime(unsigned long long _now)
+{
+	Update(_now);
+
+	unsigned int frameLatency = m_presentPolicy->GetFrameLatency();
+	if (m_presentCount < frameLatency)
+	{
+		return _now;
+	}
+
+	return GetQueuedPresent(m_presentCount - frameLatency).leaveTime;
+}
+
+/*
+	Queue the present which the GPU finishes at _readyTime, returns when the call to present returns
+	With a full queue that is when the oldest present left it, the caller is supposed to wait until then
+*/
+unsigned long long SimulatedDisplayClass::Present(unsigned long long _presentId, unsigned long long _now, unsigned long long _readyTime)
+{
+	unsigned long long returnTime = GetFrameStartTime(_now);
+	Update(returnTime);
+
+	unsigned int mode = m_presentPolicy->GetMode();
+	unsigned long long leaveTime = _readyTime;
+
+	if (m_refreshRate <= 0.0 || (mode == PRESENT_MODE_IMMEDIATE && m_presentPolicy->AllowTearing()))
+	{
+		//	In order, the GPU finishes the frames one after another
+		if (m_presented && leaveTime < m_lastLeaveTime)
+		{
+			leaveTime = m_lastLeaveTime;
+		}
+	}
+	else if (mode == PRESENT_MODE_VARIABLE_REFRESH)
+	{
+		//	The display can not refresh faster than its refresh rate
+		unsigned long long earliest = m_lastLeaveTime + static_cast<unsigned long long>(1000000.0 / m_refreshRate);
+		if (m_presented && leaveTime < earliest)
+		{
+			leaveTime = earliest;
+		}
+	}
+	else if (mode == PRESENT_MODE_VSYNC)
+	{
+		//	One present per refresh
+		leaveTime = GetNextRefresh(_readyTime);
+		if (m_presented && leaveTime <= m_lastLeaveTime)
+		{
+			leaveTime = GetNextRefresh(m_lastLeaveTime + 1);
+		}
+	}
+	else
+	{
+		//	The newest present ready at a refresh is shown, an older one waiting for the same refresh is dropped the moment this one is ready
+		leaveTime = GetNextRefresh(_readyTime);
+		if (m_presentCount > 0)
+		{
+			QueuedPresent& previous = GetQueuedPresent(m_presentCount - 1);
+			if (!previous.dropped && previous.leaveTime == leaveTime)
+			{
+				previous.dropped = true;
+				previous.leaveTime = _readyTime;
+			}
+		}
+	}
+
+	QueuedPresent& queuedPresent = GetQueuedPresent(m_presentCount);
+	queuedPresent.presentId = _presentId;
+	queuedPresent.leaveTime = leaveTime;
+	queuedPresent.dropped = false;
+	m_presentCount++;
+
+	m_lastLeaveTime = leaveTime;
+	m_presented = true;
+
+	return returnTime;
+}
+
+/*
+	Retire every present which left the queue until _now and tell the policy whether it was shown or dropped
+*/
+void SimulatedDisplayClass::Update(unsigned long long _now)
+{
+	while (m_presentCount > 0 && m_queue[m_firstPresent].leaveTime <= _now)
+	{
+		const QueuedPresent& queuedPresent = m_queue[m_firstPresent];
+		if (queuedPresent.dropped)
+		{
+			m_presentPolicy->FrameDropped(queuedPresent.presentId);
+		}
+		else
+		{
+			m_presentPolicy->FrameShown(queuedPresent.presentId, queuedPresent.leaveTime);
+		}
+
+		m_firstPresent = (m_firstPresent + 1) % MAX_SWAP_CHAIN_BUFFERS;
+		m_presentCount--;
+	}
+}
+
+double SimulatedDisplayClass::GetRefreshRate() const
+{
+	return m_refreshRate;
+}
+
+unsigned int SimulatedDisplayClass::GetQueuedPresentCount() const
+{
+	return m_presentCount;
+}
+
+/*
+	Time of the refresh with the given number, computed from the number so the refreshes do not drift
+*/
+unsigned long long SimulatedDisplayClass::GetRefreshTime(unsigned long long _refresh) const
+{
+	return static_cast<unsigned long long>(static_cast<double>(_refresh) * 1000000.0 / m_refreshRate);
+}
+
+/*
+	First refresh at or after _time
+*/
+unsigned long long SimulatedDisplayClass::GetNextRefresh(unsigned long long _time) const
+{
+	unsigned long long refresh = static_cast<unsigned long long>(ceil(static_cast<double>(_time) * m_refreshRate / 1000000.0));
+
+	//	Correct the rounding of the division
+	if (refresh > 0 && GetRefreshTime(refresh - 1) >= _time)
+	{
+		refresh--;
+	}
+	if (GetRefreshTime(refresh) < _time)
+	{
+		refresh++;
+	}
+
+	return GetRefreshTime(refresh);
+}
+
+/*
+	_index counts from the oldest queued present
+*/
+SimulatedDisplayClass::QueuedPresent& SimulatedDisplayClass::GetQueuedPresent(unsigned int _index)
+{
+	return m_queue[(m_firstPresent + _index) % MAX_SWAP_CHAIN_BUFFERS];
+}
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#pragma region includes
+#include "PresentPolicyClass.h"
+#pragma endregion
+
+/*
+	Display and present queue of a swap chain without a GPU, on a timeline in microseconds
+	The display refreshes every 1 / refreshRate seconds from time 0 on, a present waits in the queue until it is shown:
+	   vsync: every refresh shows the next ready present, one after another
+	   immediate with tearing: a present is shown as soon as it is ready
+	   immediate without tearing: a refresh shows the newest ready present, an older one which was not shown yet is dropped
+	   variable refresh: a present is shown as soon as it is ready, but not sooner than one refresh after the last one
+	Without a refresh rate every present is shown as soon as it is ready
+	The queue holds at most GetFrameLatency presents of the policy, a present leaves it when it is shown or dropped
+	GetFrameStartTime is when the frame latency waitable object of a swap chain would be signaled, Present blocks like a swap chain until there is room
+	The times are passed in, so the display runs on the real clock (NullRendererClass) as well as on a simulated one
+*/
+class SimulatedDisplayClass
+{
+public:
+	SimulatedDisplayClass();
+	~SimulatedDisplayClass();
+
+	bool Initialize(PresentPolicyClass* _presentPolicy, double _refreshRate);
+	void Shutdown();
+
+	unsigned long long GetFrameStartTime(unsigned long long _now);
+	unsigned long long Present(unsigned long long _presentId, unsigned long long _now, unsigned long long _readyTime);
+	void Update(unsigned long long _now);
+
+	double GetRefreshRate() const;
+	unsigned int GetQueuedPresentCount() const;
+
+private:
+	struct QueuedPresent
+	{
+		unsigned long long presentId;
+		unsigned long long leaveTime;	// shown or dropped at this time
+		bool dropped;
+	};
+
+	PresentPolicyClass* m_presentPolicy;
+	double m_refreshRate;
+
+	QueuedPresent m_queue[MAX_SWAP_CHAIN_BUFFERS];
+	unsigned int m_firstPresent;
+	unsigned int m_presentCount;
+	unsigned long long m_lastLeaveTime;		// of the newest present which is shown
+	bool m_presented;
+
+	unsigned long long GetRefreshTime(unsigned long long _refresh) const;
+	unsigned long long GetNextRefresh(unsigned long long _time) const;
+	QueuedPresent& GetQueuedPresent(unsigned int _index);
+};
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "SimulatedFenceClass.h"
+#include <thread>
+
+/*
+	Constructor
+*/
+SimulatedFenceClass::SimulatedFenceClass()
+{
+	m_firstSubmission = 0;
+	m_submissionCount = 0;
+	m_latency = std::chrono::steady_clock::duration::zero();
+	m_lastCompletionTime = std::chrono::steady_clock::now();
+	m_completedValue = 0;
+}
+
+/*
+	Destructor
+*/
+SimulatedFenceClass::~SimulatedFenceClass()
+{
+
+}
+
+/*
+	Set how long the simulated GPU works on every submission
+*/
+void SimulatedFenceClass::SetLatency(double _milliseconds)
+{
+	m_latency = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(_milliseconds));
+}
+
+/*
+	Queue a submission which completes with the given value
+	The simulated GPU starts to work on it as soon as it is done with the previous submission
+*/
+bool SimulatedFenceClass::Signal(unsigned long long _value)
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	RetireSubmissions(now);
+
+	if (m_submissionCount == SIMULATED_FENCE_CAPACITY)
+	{
+		return false;
+	}
+
+	std::chrono::steady_clock::time_point startTime = m_lastCompletionTime > now ? m_lastCompletionTime : now;
+	m_lastCompletionTime = startTime + m_latency;
+
+	Submission& submission = m_submissions[(m_firstSubmission + m_submissionCount) % SIMULATED_FENCE_CAPACITY];
+	submission.value = _value;
+	submission.completionTime = m_lastCompletionTime;
+	m_submissionCount++;
+
+	return true;
+}
+
+unsigned long long SimulatedFenceClass::GetCompletedValue()
+{
+	RetireSubmissions(std::chrono::steady_clock::now());
+
+	return m_completedValue;
+}
+
+/*
+	Block until the simulated GPU reached the given value
+	Sleep until the submission which signals the value is done
+	Fail if the value never got signaled, we would wait forever otherwise
+*/
+bool SimulatedFenceClass::WaitForValue(unsigned long long _value)
+{
+	if (GetCompletedValue() >= _value)
+	{
+		return true;
+	}
+
+	for (unsigned int i = 0; i < m_submissionCount; i++)
+	{
+		const Submission& submission = m_submissions[(m_firstSubmission + i) % SIMULATED_FENCE_CAPACITY];
+		if (submission.value >= _value)
+		{
+			std::this_thread::sleep_until(submission.completionTime);
+			RetireSubmissions(submission.completionTime);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Remove all submissions which are done at the given time and remember the highest completed value
+*/
+void SimulatedFenceClass::RetireSubmissions(std::chrono::steady_clock::time_point _now)
+{
+	while (m_submissionCount > 0)
+	{
+		const Submission& submission = m_submissions[m_firstSubmission];
+		if (submission.completionTime > _now)
+		{
+			break;
+		}
+
+		m_completedValue = submission.value;
+		m_firstSubmission = (m_firstSubmission + 1) % SIMULATED_FENCE_CAPACITY;
+		m_submissionCount--;
+	}
+}
\ No newline at end of file
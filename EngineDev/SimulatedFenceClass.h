@@ -0,0 +1,45 @@
+#pragma once
+
+#pragma region includes
+#include "FenceClass.h"
+#include <chrono>
+#pragma endregion
+
+#pragma region global variables
+const unsigned int SIMULATED_FENCE_CAPACITY = 8;	// how many signals may be pending on the simulated GPU
+#pragma endregion
+
+/*
+	Fence without a GPU
+	Every signal is treated like a submission which the simulated GPU works on for the given latency
+	Submissions are worked on one after another, like a single hardware queue would do
+*/
+class SimulatedFenceClass : public FenceClass
+{
+public:
+	SimulatedFenceClass();
+	~SimulatedFenceClass();
+
+	void SetLatency(double _milliseconds);
+
+	bool Signal(unsigned long long _value) override;
+	unsigned long long GetCompletedValue() override;
+	bool WaitForValue(unsigned long long _value) override;
+
+private:
+	struct Submission
+	{
+		unsigned long long value;
+		std::chrono::steady_clock::time_point completionTime;
+	};
+
+	Submission m_submissions[SIMULATED_FENCE_CAPACITY];
+	unsigned int m_firstSubmission;
+	unsigned int m_submissionCount;
+
+	std::chrono::steady_clock::duration m_latency;
+	std::chrono::steady_clock::time_point m_lastCompletionTime;
+	unsigned long long m_completedValue;
+
+	void RetireSubmissions(std::chrono::steady_clock::time_point _now);
+};
\ No newline at end of file
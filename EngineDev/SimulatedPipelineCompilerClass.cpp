@@ -0,0 +1,110 @@
+#include "SimulatedPipelineCompilerClass.h"
+#include "HashClass.h"
+
+/*
+	Constructor
+*/
+SimulatedPipelineCompilerClass::SimulatedPipelineCompilerClass()
+{
+	SetCompileTime(SIMULATED_PIPELINE_COMPILE_TIME);
+	SetLoadTime(SIMULATED_PIPELINE_LOAD_TIME);
+	m_cacheVersion = SIMULATED_PIPELINE_CACHE_VERSION;
+}
+
+/*
+	Destructor
+*/
+SimulatedPipelineCompilerClass::~SimulatedPipelineCompilerClass()
+{
+
+}
+
+void SimulatedPipelineCompilerClass::SetCompileTime(double _milliseconds)
+{
+	m_compileTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(_milliseconds));
+}
+
+void SimulatedPipelineCompilerClass::SetLoadTime(double _milliseconds)
+{
+	m_loadTime = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::milli>(_milliseconds));
+}
+
+/*
+	A different version behaves like a driver update, every blob on disk becomes invalid
+*/
+void SimulatedPipelineCompilerClass::SetCacheVersion(unsigned long long _version)
+{
+	m_cacheVersion = _version;
+}
+
+unsigned long long SimulatedPipelineCompilerClass::GetCacheVersion()
+{
+	return m_cacheVersion;
+}
+
+/*
+	There are no shader files, the description is all there is
+*/
+unsigned long long SimulatedPipelineCompilerClass::GetSourceHash(const PipelineDesc& _desc)
+{
+	return 0;
+}
+
+/*
+	Accept the cached blob if it was made for this description, it starts with the hash of the description
+	Otherwise compile: spend the compile time and write a blob of the hash followed by bytes derived from it
+*/
+void* SimulatedPipelineCompilerClass::CreatePipeline(const PipelineDesc& _desc, const void* _cachedBlob, size_t _cachedBlobSize, unsigned char*& _blob, size_t& _blobSize)
+{
+	unsigned long long hash = HashClass::Hash(&_desc, sizeof(PipelineDesc));
+
+	_blob = nullptr;
+	_blobSize = 0;
+
+	if (_cachedBlob && _cachedBlobSize == SIMULATED_PIPELINE_BLOB_SIZE && memcmp(_cachedBlob, &hash, sizeof(hash)) == 0)
+	{
+		Work(m_loadTime);
+
+		return new unsigned long long(hash);
+	}
+
+	Work(m_compileTime);
+
+	_blob = new unsigned char[SIMULATED_PIPELINE_BLOB_SIZE];
+	if (!_blob)
+	{
+		return nullptr;
+	}
+
+	memcpy(_blob, &hash, sizeof(hash));
+
+	unsigned long long value = hash | 1;
+	for (size_t i = sizeof(hash); i < SIMULATED_PIPELINE_BLOB_SIZE; i++)
+	{
+		value ^= value << 13;
+		value ^= value >> 7;
+		value ^= value << 17;
+		_blob[i] = static_cast<unsigned char>(value);
+	}
+
+	_blobSize = SIMULATED_PIPELINE_BLOB_SIZE;
+
+	return new unsigned long long(hash);
+}
+
+void SimulatedPipelineCompilerClass::ReleasePipeline(void* _pipeline)
+{
+	delete static_cast<unsigned long long*>(_pipeline);
+}
+
+/*
+	Keep the thread busy like a compiler would, sleeping would let another job use the core
+*/
+void SimulatedPipelineCompilerClass::Work(std::chrono::steady_clock::duration _duration)
+{
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + _duration;
+
+	while (std::chrono::steady_clock::now() < end)
+	{
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#pragma region includes
+#include "PipelineCompilerClass.h"
+#include <chrono>
+#pragma endregion
+
+#pragma region global variables
+const double SIMULATED_PIPELINE_COMPILE_TIME = 20.0;		// milliseconds, roughly a PSO with a cold driver cache
+const double SIMULATED_PIPELINE_LOAD_TIME = 0.2;			// milliseconds to create a pipeline from its blob
+const size_t SIMULATED_PIPELINE_BLOB_SIZE = 16 * 1024;
+const unsigned long long SIMULATED_PIPELINE_CACHE_VERSION = 1;
+#pragma endregion
+
+/*
+	Pipeline compiler without a graphics API
+	Compiling keeps the thread busy for the compile time and produces a blob derived from the description
+	Creating from a valid blob only takes the load time, a blob of another description is rejected like a driver would
+	The pipelines are opaque handles which only exist to be released again
+*/
+class SimulatedPipelineCompilerClass : public PipelineCompilerClass
+{
+public:
+	SimulatedPipelineCompilerClass();
+	~SimulatedPipelineCompilerClass();
+
+	void SetCompileTime(double _milliseconds);
+	void SetLoadTime(double _milliseconds);
+	void SetCacheVersion(unsigned long long _version);
+
+	unsigned long long GetCacheVersion() override;
+	unsigned long long GetSourceHash(const PipelineDesc& _desc) override;
+	void* CreatePipeline(const PipelineDesc& _desc, const void* _cachedBlob, size_t _cachedBlobSize, unsigned char*& _blob, size_t& _blobSize) override;
+	void ReleasePipeline(void* _pipeline) override;
+
+private:
+	std::chrono::steady_clock::duration m_compileTime;
+	std::chrono::steady_clock::duration m_loadTime;
+	unsigned long long m_cacheVersion;
+
+	static void Work(std::chrono::steady_clock::duration _duration);
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "SimulatedTimestampQueriesClass.h"
+#include "TimerClass.h"
+
+/*
+	Constructor
+*/
+SimulatedTimestampQueriesClass::SimulatedTimestampQueriesClass()
+{
+	m_queries = nullptr;
+	m_resolvedQueries = nullptr;
+	m_queryCount = 0;
+	m_clock = TimerClass::GetMicroseconds;
+}
+
+/*
+	Destructor
+*/
+SimulatedTimestampQueriesClass::~SimulatedTimestampQueriesClass()
+{
+
+}
+
+/*
+	Create the queries and the memory they get resolved to
+*/
+bool SimulatedTimestampQueriesClass::Initialize(unsigned int _queryCount)
+{
+	m_queries = new unsigned long long[_queryCount];
+	if (!m_queries)
+	{
+		return false;
+	}
+
+	m_resolvedQueries = new unsigned long long[_queryCount];
+	if (!m_resolvedQueries)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < _queryCount; i++)
+	{
+		m_queries[i] = 0;
+		m_resolvedQueries[i] = 0;
+	}
+
+	m_queryCount = _queryCount;
+
+	return true;
+}
+
+void SimulatedTimestampQueriesClass::Shutdown()
+{
+	if (m_resolvedQueries)
+	{
+		delete[] m_resolvedQueries;
+		m_resolvedQueries = nullptr;
+	}
+	if (m_queries)
+	{
+		delete[] m_queries;
+		m_queries = nullptr;
+	}
+
+	m_queryCount = 0;
+}
+
+/*
+	Replace the clock, e.g. by a fake clock which advances by a known amount with every call
+	The clock has to tick in microseconds
+*/
+void SimulatedTimestampQueriesClass::SetClock(TimestampClock _clock)
+{
+	m_clock = _clock;
+}
+
+void SimulatedTimestampQueriesClass::WriteTimestamp(unsigned int _queryIndex)
+{
+	if (_queryIndex < m_queryCount)
+	{
+		m_queries[_queryIndex] = m_clock();
+	}
+}
+
+void SimulatedTimestampQueriesClass::ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount)
+{
+	for (unsigned int i = _firstQuery; i < _firstQuery + _queryCount && i < m_queryCount; i++)
+	{
+		m_resolvedQueries[i] = m_queries[i];
+	}
+}
+
+unsigned int SimulatedTimestampQueriesClass::GetQueryCount() const
+{
+	return m_queryCount;
+}
+
+/*
+	Ticks per second of the clock
+*/
+unsigned long long SimulatedTimestampQueriesClass::GetFrequency() const
+{
+	return 1000000;
+}
+
+/*
+	Copy resolved queries
+*/
+bool SimulatedTimestampQueriesClass::ReadTimestamps(unsigned int _firstQuery, unsigned int _queryCount, unsigned long long* _timestamps)
+{
+	if (_firstQuery + _queryCount > m_queryCount)
+	{
+		return false;
+	}
+
+	for (unsigned int i = 0; i < _queryCount; i++)
+	{
+		_timestamps[i] = m_resolvedQueries[_firstQuery + i];
+	}
+
+	return true;
+}
+
+/*
+	Read the simulated GPU clock and the CPU clock at the same time
+*/
+bool SimulatedTimestampQueriesClass::Calibrate(unsigned long long& _gpuTimestamp, unsigned long long& _cpuMicroseconds)
+{
+	_gpuTimestamp = m_clock();
+	_cpuMicroseconds = TimerClass::GetMicroseconds();
+
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#pragma region includes
+#include "TimestampQueriesClass.h"
+#pragma endregion
+
+typedef unsigned long long (*TimestampClock)();
+
+/*
+	Timestamp queries without a GPU
+	Writing a query reads the clock right away, resolving copies the queries like the GPU would copy them into the readback buffer
+	The clock ticks in microseconds, it is TimerClass::GetMicroseconds unless a fake clock is set
+*/
+class SimulatedTimestampQueriesClass : public TimestampQueriesClass
+{
+public:
+	SimulatedTimestampQueriesClass();
+	~SimulatedTimestampQueriesClass();
+
+	bool Initialize(unsigned int _queryCount);
+	void Shutdown();
+
+	void SetClock(TimestampClock _clock);
+
+	void WriteTimestamp(unsigned int _queryIndex);
+	void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount);
+
+	unsigned int GetQueryCount() const override;
+	unsigned long long GetFrequency() const override;
+
+	bool ReadTimestamps(unsigned int _firstQuery, unsigned int _queryCount, unsigned long long* _timestamps) override;
+	bool Calibrate(unsigned long long& _gpuTimestamp, unsigned long long& _cpuMicroseconds) override;
+
+private:
+	unsigned long long* m_queries;
+	unsigned long long* m_resolvedQueries;
+	unsigned int m_queryCount;
+
+	TimestampClock m_clock;
+};
\ No newline at end of file
@@ -0,0 +1,741 @@
+#include "SoftwareRasterizerClass.h"
+#include "PngWriterClass.h"
+#include "ProfilerClass.h"
+#include <cstdlib>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int INVALID_BIN_BLOCK = 0xFFFFFFFF;
+static const unsigned int MAX_CLIP_VERTICES = 9;		// a triangle clipped by the near plane and the 4 guard band planes
+static const unsigned int CLIP_PLANE_COUNT = 5;
+static const size_t SOFTWARE_BUFFER_ALIGNMENT = 16;
+static const unsigned int SOFTWARE_PREFETCH_DISTANCE = 8;		// triangles of a bin fetched ahead while rasterizing
+#pragma endregion
+
+/*
+	Distance of a clip space position to a clip plane, negative means outside
+	0: near (z >= 0), 1 - 4: guard band (-g * w <= x, y <= g * w), 5: far (z <= w, only used to reject whole triangles)
+*/
+static float ClipDistance(unsigned int _plane, const Vector4& _position)
+{
+	switch (_plane)
+	{
+	case 0:
+		return _position.z;
+	case 1:
+		return SOFTWARE_GUARD_BAND * _position.w + _position.x;
+	case 2:
+		return SOFTWARE_GUARD_BAND * _position.w - _position.x;
+	case 3:
+		return SOFTWARE_GUARD_BAND * _position.w + _position.y;
+	case 4:
+		return SOFTWARE_GUARD_BAND * _position.w - _position.y;
+	default:
+		return _position.w - _position.z;
+	}
+}
+
+/*
+	Edge function A * x + B * y + C of the edge from a to b, positive on the right side (inside of a clockwise triangle, y pointing down)
+	Always computed from the smaller endpoint to the larger one and negated if needed,
+	so the two triangles sharing an edge get exactly negated functions and every pixel on it belongs to exactly one of them
+*/
+static void SetupEdge(float _ax, float _ay, float _bx, float _by, float& _edgeA, float& _edgeB, float& _edgeC)
+{
+	bool swap = _ax > _bx || (_ax == _bx && _ay > _by);
+	if (swap)
+	{
+		float x = _ax;
+		float y = _ay;
+		_ax = _bx;
+		_ay = _by;
+		_bx = x;
+		_by = y;
+	}
+
+	_edgeA = _ay - _by;
+	_edgeB = _bx - _ax;
+	_edgeC = -(_edgeA * _ax + _edgeB * _ay);
+
+	if (swap)
+	{
+		_edgeA = -_edgeA;
+		_edgeB = -_edgeB;
+		_edgeC = -_edgeC;
+	}
+}
+
+static unsigned int PackColor(float _red, float _green, float _blue, float _alpha)
+{
+	float channels[4] = { _red, _green, _blue, _alpha };
+	unsigned int color = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		float value = channels[i] * 255.0f + 0.5f;
+		value = value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value);
+		color |= static_cast<unsigned int>(value) << (i * 8);
+	}
+
+	return color;
+}
+
+/*
+	Constructor
+*/
+SoftwareRasterizerClass::SoftwareRasterizerClass()
+{
+	m_jobSystem = nullptr;
+	m_width = 0;
+	m_height = 0;
+	m_stride = 0;
+	m_tilesX = 0;
+	m_tilesY = 0;
+	m_bufferMemory = nullptr;
+	m_colorBuffer = nullptr;
+	m_depthBuffer = nullptr;
+	m_triangles = nullptr;
+	m_maxTriangles = 0;
+	m_triangleCount = 0;
+	m_binBlocks = nullptr;
+	m_maxBinBlocks = 0;
+	m_binBlockCount = 0;
+	m_binHeads = nullptr;
+	m_binTails = nullptr;
+	m_clearPending = false;
+	m_clearColor = 0;
+	m_clearDepth = 1.0f;
+	m_rasterizedTriangles = 0;
+}
+
+/*
+	Destructor
+*/
+SoftwareRasterizerClass::~SoftwareRasterizerClass()
+{
+
+}
+
+/*
+	Allocate the buffers padded to whole tiles, the triangle storage and the bins
+	A triangle covers one or a few tiles, the bins get two entries per triangle plus a partly filled block per tile
+*/
+bool SoftwareRasterizerClass::Initialize(unsigned int _width, unsigned int _height, unsigned int _maxTriangles, JobSystemClass* _jobSystem)
+{
+	m_jobSystem = _jobSystem;
+
+	if (_width == 0 || _height == 0 || _maxTriangles == 0)
+	{
+		return false;
+	}
+
+	m_width = _width;
+	m_height = _height;
+	m_tilesX = (_width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	m_tilesY = (_height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+	m_stride = m_tilesX * SOFTWARE_TILE_SIZE;
+
+	size_t pixelCount = static_cast<size_t>(m_stride) * m_tilesY * SOFTWARE_TILE_SIZE;
+	m_bufferMemory = static_cast<unsigned char*>(malloc(pixelCount * (sizeof(unsigned int) + sizeof(float)) + SOFTWARE_BUFFER_ALIGNMENT));
+	if (!m_bufferMemory)
+	{
+		return false;
+	}
+
+	size_t base = reinterpret_cast<size_t>(m_bufferMemory);
+	m_colorBuffer = reinterpret_cast<unsigned int*>(m_bufferMemory + (((base + SOFTWARE_BUFFER_ALIGNMENT - 1) & ~(SOFTWARE_BUFFER_ALIGNMENT - 1)) - base));
+	m_depthBuffer = reinterpret_cast<float*>(m_colorBuffer + pixelCount);
+	memset(m_colorBuffer, 0, pixelCount * sizeof(unsigned int));
+	for (size_t i = 0; i < pixelCount; i++)
+	{
+		m_depthBuffer[i] = 1.0f;
+	}
+
+	m_maxTriangles = _maxTriangles;
+	m_triangles = new TriangleSetup[m_maxTriangles];
+	if (!m_triangles)
+	{
+		return false;
+	}
+
+	unsigned int tileCount = m_tilesX * m_tilesY;
+	m_maxBinBlocks = m_maxTriangles * 2 / SOFTWARE_BIN_BLOCK_SIZE + tileCount * 2;
+	m_binBlocks = new BinBlock[m_maxBinBlocks];
+	m_binHeads = new unsigned int[tileCount];
+	m_binTails = new unsigned int[tileCount];
+	if (!m_binBlocks || !m_binHeads || !m_binTails)
+	{
+		return false;
+	}
+
+	ResetBins();
+	m_clearPending = false;
+	m_rasterizedTriangles = 0;
+
+	return true;
+}
+
+void SoftwareRasterizerClass::Shutdown()
+{
+	if (m_binTails)
+	{
+		delete[] m_binTails;
+		m_binTails = nullptr;
+	}
+
+	if (m_binHeads)
+	{
+		delete[] m_binHeads;
+		m_binHeads = nullptr;
+	}
+
+	if (m_binBlocks)
+	{
+		delete[] m_binBlocks;
+		m_binBlocks = nullptr;
+	}
+
+	if (m_triangles)
+	{
+		delete[] m_triangles;
+		m_triangles = nullptr;
+	}
+
+	if (m_bufferMemory)
+	{
+		free(m_bufferMemory);
+		m_bufferMemory = nullptr;
+		m_colorBuffer = nullptr;
+		m_depthBuffer = nullptr;
+	}
+
+	m_width = 0;
+	m_height = 0;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Clear color (RGBA, 0 - 1) and depth before the next triangles
+	The clear happens per tile when the tiles are rasterized, triangles drawn before it are dropped
+*/
+void SoftwareRasterizerClass::Clear(const float* _color, float _depth)
+{
+	ResetBins();
+	m_clearPending = true;
+	m_clearColor = PackColor(_color[0], _color[1], _color[2], _color[3]);
+	m_clearDepth = _depth;
+}
+
+/*
+	Front end: transform the vertices of every triangle with _transform into clip space, clip, set up and bin the resulting triangles
+	Without indices the vertices are taken in order, _indexCount is the amount of vertices then
+	_cullMode is one of PIPELINE_CULL_*, front faces are clockwise on the screen like in D3D
+	Returns false (and stops) at the first index outside of the vertices
+*/
+bool SoftwareRasterizerClass::DrawTriangles(const SoftwareVertex* _vertices, unsigned int _vertexCount, const unsigned int* _indices, unsigned int _indexCount, const Matrix4& _transform, unsigned int _cullMode)
+{
+	PROFILE_SCOPE("SoftwareRasterizerClass::DrawTriangles");
+
+	for (unsigned int i = 0; i + 2 < _indexCount; i += 3)
+	{
+		ClipVertex triangle[3];
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			unsigned int index = _indices ? _indices[i + j] : i + j;
+			if (index >= _vertexCount)
+			{
+				return false;
+			}
+
+			const SoftwareVertex& vertex = _vertices[index];
+			Vector4 position = { vertex.x, vertex.y, vertex.z, 1.0f };
+			triangle[j].position = MathClass::Transform(position, _transform);
+			for (int channel = 0; channel < 4; channel++)
+			{
+				triangle[j].color[channel] = static_cast<float>((vertex.color >> (channel * 8)) & 0xFF) * (1.0f / 255.0f);
+			}
+		}
+
+		ClipVertex polygon[MAX_CLIP_VERTICES];
+		unsigned int vertexCount = ClipTriangle(triangle, polygon);
+		for (unsigned int j = 1; j + 1 < vertexCount; j++)
+		{
+			SetupTriangle(polygon[0], polygon[j], polygon[j + 1], _cullMode);
+		}
+	}
+
+	return true;
+}
+
+/*
+	Back end: rasterize everything drawn since the last clear into the buffers
+*/
+void SoftwareRasterizerClass::Present()
+{
+	PROFILE_SCOPE("SoftwareRasterizerClass::Present");
+
+	Flush();
+}
+
+/*
+	Write the visible part of the color buffer as PNG
+*/
+bool SoftwareRasterizerClass::SavePng(const char* _path) const
+{
+	return PngWriterClass::Write(_path, m_width, m_height, reinterpret_cast<const unsigned char*>(m_colorBuffer), static_cast<size_t>(m_stride) * sizeof(unsigned int));
+}
+
+unsigned int SoftwareRasterizerClass::GetWidth() const
+{
+	return m_width;
+}
+
+unsigned int SoftwareRasterizerClass::GetHeight() const
+{
+	return m_height;
+}
+
+/*
+	Pixels between the starts of two rows of the buffers
+*/
+unsigned int SoftwareRasterizerClass::GetStride() const
+{
+	return m_stride;
+}
+
+const unsigned int* SoftwareRasterizerClass::GetColorBuffer() const
+{
+	return m_colorBuffer;
+}
+
+const float* SoftwareRasterizerClass::GetDepthBuffer() const
+{
+	return m_depthBuffer;
+}
+
+/*
+	Triangles which went through the back end since Initialize (after clipping and culling)
+*/
+unsigned long long SoftwareRasterizerClass::GetRasterizedTriangleCount() const
+{
+	return m_rasterizedTriangles;
+}
+
+/*
+	Reject the triangle if all vertices are outside of the same plane, keep it as it is if none is outside
+	Otherwise clip the polygon against every plane it crosses (Sutherland-Hodgman)
+	Returns the amount of vertices of the convex polygon in _polygon
+*/
+unsigned int SoftwareRasterizerClass::ClipTriangle(const ClipVertex* _triangle, ClipVertex* _polygon) const
+{
+	unsigned int crossedPlanes = 0;
+	for (unsigned int plane = 0; plane <= CLIP_PLANE_COUNT; plane++)
+	{
+		unsigned int outside = 0;
+		for (unsigned int i = 0; i < 3; i++)
+		{
+			outside += ClipDistance(plane, _triangle[i].position) < 0.0f ? 1 : 0;
+		}
+
+		if (outside == 3)
+		{
+			return 0;
+		}
+
+		if (outside > 0 && plane < CLIP_PLANE_COUNT)
+		{
+			crossedPlanes |= 1 << plane;
+		}
+	}
+
+	_polygon[0] = _triangle[0];
+	_polygon[1] = _triangle[1];
+	_polygon[2] = _triangle[2];
+	unsigned int vertexCount = 3;
+
+	for (unsigned int plane = 0; plane < CLIP_PLANE_COUNT && vertexCount > 0; plane++)
+	{
+		if ((crossedPlanes & (1 << plane)) == 0)
+		{
+			continue;
+		}
+
+		ClipVertex input[MAX_CLIP_VERTICES];
+		memcpy(input, _polygon, vertexCount * sizeof(ClipVertex));
+		unsigned int inputCount = vertexCount;
+		vertexCount = 0;
+
+		for (unsigned int i = 0; i < inputCount; i++)
+		{
+			const ClipVertex& a = input[i];
+			const ClipVertex& b = input[(i + 1) % inputCount];
+			float distanceA = ClipDistance(plane, a.position);
+			float distanceB = ClipDistance(plane, b.position);
+
+			if (distanceA >= 0.0f)
+			{
+				_polygon[vertexCount++] = a;
+			}
+
+			if ((distanceA >= 0.0f) != (distanceB >= 0.0f))
+			{
+				float t = distanceA / (distanceA - distanceB);
+				ClipVertex& vertex = _polygon[vertexCount++];
+				vertex.position.x = a.position.x + (b.position.x - a.position.x) * t;
+				vertex.position.y = a.position.y + (b.position.y - a.position.y) * t;
+				vertex.position.z = a.position.z + (b.position.z - a.position.z) * t;
+				vertex.position.w = a.position.w + (b.position.w - a.position.w) * t;
+				for (int channel = 0; channel < 4; channel++)
+				{
+					vertex.color[channel] = a.color[channel] + (b.color[channel] - a.color[channel]) * t;
+				}
+			}
+		}
+	}
+
+	return vertexCount;
+}
+
+/*
+	Project the vertices onto the screen and snap them to the subpixel grid
+	Cull by the sign of the area, turn the remaining triangles clockwise, set up the edges and the attribute planes
+	Flush first if the storage can not hold the triangle and its bins
+*/
+void SoftwareRasterizerClass::SetupTriangle(const ClipVertex& _v0, const ClipVertex& _v1, const ClipVertex& _v2, unsigned int _cullMode)
+{
+	const ClipVertex* vertices[3] = { &_v0, &_v1, &_v2 };
+	const float subpixels = static_cast<float>(1 << SOFTWARE_SUBPIXEL_BITS);
+
+	float x[3];
+	float y[3];
+	float inverseW[3];
+	for (int i = 0; i < 3; i++)
+	{
+		const Vector4& position = vertices[i]->position;
+		inverseW[i] = 1.0f / position.w;
+		x[i] = floorf((position.x * inverseW[i] * 0.5f + 0.5f) * static_cast<float>(m_width) * subpixels + 0.5f) / subpixels;
+		y[i] = floorf((0.5f - position.y * inverseW[i] * 0.5f) * static_cast<float>(m_height) * subpixels + 0.5f) / subpixels;
+	}
+
+	float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+	if (area == 0.0f || (_cullMode == PIPELINE_CULL_BACK && area < 0.0f) || (_cullMode == PIPELINE_CULL_FRONT && area > 0.0f))
+	{
+		return;
+	}
+
+	int order[3] = { 0, 1, 2 };
+	if (area < 0.0f)
+	{
+		order[1] = 2;
+		order[2] = 1;
+		area = -area;
+	}
+
+	TriangleSetup triangle;
+
+	float minimumX = fminf(x[0], fminf(x[1], x[2]));
+	float minimumY = fminf(y[0], fminf(y[1], y[2]));
+	float maximumX = fmaxf(x[0], fmaxf(x[1], x[2]));
+	float maximumY = fmaxf(y[0], fmaxf(y[1], y[2]));
+	triangle.minX = minimumX < 0.0f ? 0 : static_cast<int>(minimumX);
+	triangle.minY = minimumY < 0.0f ? 0 : static_cast<int>(minimumY);
+	triangle.maxX = maximumX >= static_cast<float>(m_width) ? static_cast<int>(m_width) - 1 : static_cast<int>(maximumX);
+	triangle.maxY = maximumY >= static_cast<float>(m_height) ? static_cast<int>(m_height) - 1 : static_cast<int>(maximumY);
+	if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY)
+	{
+		return;
+	}
+
+	//	Edge i lies opposite of vertex i, its function divided by the area is the weight of vertex i
+	triangle.topLeftEdges = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		int a = order[(i + 1) % 3];
+		int b = order[(i + 2) % 3];
+		SetupEdge(x[a], y[a], x[b], y[b], triangle.edgeA[i], triangle.edgeB[i], triangle.edgeC[i]);
+
+		//	Left edges go up, top edges go right
+		if (triangle.edgeA[i] > 0.0f || (triangle.edgeA[i] == 0.0f && triangle.edgeB[i] > 0.0f))
+		{
+			triangle.topLeftEdges |= 1 << i;
+		}
+	}
+
+	int first = order[0];
+	triangle.originX = x[first];
+	triangle.originY = y[first];
+
+	float inverseArea = 1.0f / area;
+	for (int i = 0; i < 6; i++)
+	{
+		float values[3];
+		for (int j = 0; j < 3; j++)
+		{
+			const ClipVertex& vertex = *vertices[order[j]];
+			float w = inverseW[order[j]];
+			values[j] = i == 0 ? vertex.position.z * w : (i == 1 ? w : vertex.color[i - 2] * w);
+		}
+
+		triangle.planes[i][0] = values[0];
+		triangle.planes[i][1] = ((values[1] - values[0]) * triangle.edgeA[1] + (values[2] - values[0]) * triangle.edgeA[2]) * inverseArea;
+		triangle.planes[i][2] = ((values[1] - values[0]) * triangle.edgeB[1] + (values[2] - values[0]) * triangle.edgeB[2]) * inverseArea;
+	}
+
+	unsigned int tileCount = (static_cast<unsigned int>(triangle.maxX) / SOFTWARE_TILE_SIZE - static_cast<unsigned int>(triangle.minX) / SOFTWARE_TILE_SIZE + 1)
+		* (static_cast<unsigned int>(triangle.maxY) / SOFTWARE_TILE_SIZE - static_cast<unsigned int>(triangle.minY) / SOFTWARE_TILE_SIZE + 1);
+	if (m_triangleCount == m_maxTriangles || m_binBlockCount + tileCount > m_maxBinBlocks)
+	{
+		Flush();
+	}
+
+	m_triangles[m_triangleCount] = triangle;
+	BinTriangle(m_triangleCount);
+	m_triangleCount++;
+}
+
+/*
+	Append the triangle to the bin of every tile its bounds touch
+*/
+void SoftwareRasterizerClass::BinTriangle(unsigned int _triangle)
+{
+	const TriangleSetup& triangle = m_triangles[_triangle];
+
+	for (unsigned int tileY = triangle.minY / SOFTWARE_TILE_SIZE; tileY <= static_cast<unsigned int>(triangle.maxY) / SOFTWARE_TILE_SIZE; tileY++)
+	{
+		for (unsigned int tileX = triangle.minX / SOFTWARE_TILE_SIZE; tileX <= static_cast<unsigned int>(triangle.maxX) / SOFTWARE_TILE_SIZE; tileX++)
+		{
+			unsigned int tile = tileY * m_tilesX + tileX;
+			unsigned int block = m_binTails[tile];
+
+			if (block == INVALID_BIN_BLOCK || m_binBlocks[block].count == SOFTWARE_BIN_BLOCK_SIZE)
+			{
+				unsigned int newBlock = m_binBlockCount++;
+				m_binBlocks[newBlock].count = 0;
+				m_binBlocks[newBlock].next = INVALID_BIN_BLOCK;
+
+				if (block == INVALID_BIN_BLOCK)
+				{
+					m_binHeads[tile] = newBlock;
+				}
+				else
+				{
+					m_binBlocks[block].next = newBlock;
+				}
+
+				m_binTails[tile] = newBlock;
+				block = newBlock;
+			}
+
+			BinBlock& binBlock = m_binBlocks[block];
+			binBlock.triangles[binBlock.count++] = _triangle;
+		}
+	}
+}
+
+/*
+	Rasterize every tile (in parallel if there is a jobsystem), then start over with empty bins
+	Few tiles per job, the tiles with many triangles would otherwise hold up a whole batch
+*/
+void SoftwareRasterizerClass::Flush()
+{
+	if (!m_clearPending && m_triangleCount == 0)
+	{
+		return;
+	}
+
+	unsigned int tileCount = m_tilesX * m_tilesY;
+
+	bool queued = false;
+	if (m_jobSystem)
+	{
+		unsigned int jobCount = m_jobSystem->GetThreadCount() * 4;
+		unsigned int batchSize = tileCount / jobCount;
+		if (batchSize < 1)
+		{
+			batchSize = 1;
+		}
+
+		JobCounter counter(0);
+		queued = m_jobSystem->ParallelFor(RasterizeJob, this, tileCount, batchSize, &counter);
+		if (queued)
+		{
+			m_jobSystem->WaitForCounter(&counter);
+		}
+	}
+
+	if (!queued)
+	{
+		RasterizeJob(this, 0, tileCount, 0);
+	}
+
+	m_rasterizedTriangles += m_triangleCount;
+	m_clearPending = false;
+	ResetBins();
+}
+
+void SoftwareRasterizerClass::ResetBins()
+{
+	unsigned int tileCount = m_tilesX * m_tilesY;
+	for (unsigned int i = 0; i < tileCount; i++)
+	{
+		m_binHeads[i] = INVALID_BIN_BLOCK;
+		m_binTails[i] = INVALID_BIN_BLOCK;
+	}
+
+	m_binBlockCount = 0;
+	m_triangleCount = 0;
+}
+
+void SoftwareRasterizerClass::RasterizeJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	SoftwareRasterizerClass* rasterizer = static_cast<SoftwareRasterizerClass*>(_data);
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		rasterizer->RasterizeTile(i);
+	}
+}
+
+/*
+	Clear the tile if a clear is pending, then draw the triangles of its bin in the order they were drawn
+*/
+void SoftwareRasterizerClass::RasterizeTile(unsigned int _tile)
+{
+	int tileX = static_cast<int>((_tile % m_tilesX) * SOFTWARE_TILE_SIZE);
+	int tileY = static_cast<int>((_tile / m_tilesX) * SOFTWARE_TILE_SIZE);
+
+	if (m_clearPending)
+	{
+		for (unsigned int y = 0; y < SOFTWARE_TILE_SIZE; y++)
+		{
+			size_t row = static_cast<size_t>(tileY + y) * m_stride + tileX;
+			for (unsigned int x = 0; x < SOFTWARE_TILE_SIZE; x++)
+			{
+				m_colorBuffer[row + x] = m_clearColor;
+				m_depthBuffer[row + x] = m_clearDepth;
+			}
+		}
+	}
+
+	//	The triangles of a bin are spread over the whole triangle storage, fetch a few ahead
+	for (unsigned int block = m_binHeads[_tile]; block != INVALID_BIN_BLOCK; block = m_binBlocks[block].next)
+	{
+		const BinBlock& binBlock = m_binBlocks[block];
+		for (unsigned int i = 0; i < binBlock.count; i++)
+		{
+			if (i + SOFTWARE_PREFETCH_DISTANCE < binBlock.count)
+			{
+				const unsigned char* next = reinterpret_cast<const unsigned char*>(&m_triangles[binBlock.triangles[i + SOFTWARE_PREFETCH_DISTANCE]]);
+				for (size_t offset = 0; offset < sizeof(TriangleSetup); offset += 64)
+				{
+					SimdClass::Prefetch(next + offset);
+				}
+			}
+
+			RasterizeTriangle(m_triangles[binBlock.triangles[i]], tileX, tileY);
+		}
+	}
+}
+
+/*
+	Walk the bounds of the triangle inside of the tile in steps of 4 pixels
+	A pixel is covered if its center is inside of all three edges, exactly on an edge only counts for top and left edges
+	Covered pixels which pass the depth test get their depth and their perspective correct color written
+*/
+void SoftwareRasterizerClass::RasterizeTriangle(const TriangleSetup& _triangle, int _tileX, int _tileY)
+{
+	int minX = _triangle.minX > _tileX ? _triangle.minX : _tileX;
+	int minY = _triangle.minY > _tileY ? _triangle.minY : _tileY;
+	int maxX = _triangle.maxX < _tileX + static_cast<int>(SOFTWARE_TILE_SIZE) - 1 ? _triangle.maxX : _tileX + static_cast<int>(SOFTWARE_TILE_SIZE) - 1;
+	int maxY = _triangle.maxY < _tileY + static_cast<int>(SOFTWARE_TILE_SIZE) - 1 ? _triangle.maxY : _tileY + static_cast<int>(SOFTWARE_TILE_SIZE) - 1;
+	if (minX > maxX || minY > maxY)
+	{
+		return;
+	}
+
+	minX &= ~3;
+
+	const SimdFloat4 zero = SimdClass::Splat(0.0f);
+	const SimdFloat4 one = SimdClass::Splat(1.0f);
+	const SimdFloat4 half = SimdClass::Splat(0.5f);
+	const SimdFloat4 colorScale = SimdClass::Splat(255.0f);
+	const SimdFloat4 colorMaximum = SimdClass::Splat(255.0f);
+	const SimdFloat4 pixelCenters = SimdClass::Set(0.5f, 1.5f, 2.5f, 3.5f);
+	const SimdFloat4 edgeA0 = SimdClass::Splat(_triangle.edgeA[0]);
+	const SimdFloat4 edgeA1 = SimdClass::Splat(_triangle.edgeA[1]);
+	const SimdFloat4 edgeA2 = SimdClass::Splat(_triangle.edgeA[2]);
+	const SimdFloat4 originX = SimdClass::Splat(_triangle.originX);
+	const bool topLeft0 = (_triangle.topLeftEdges & 1) != 0;
+	const bool topLeft1 = (_triangle.topLeftEdges & 2) != 0;
+	const bool topLeft2 = (_triangle.topLeftEdges & 4) != 0;
+
+	SimdFloat4 planeStepX[6];
+	for (int i = 0; i < 6; i++)
+	{
+		planeStepX[i] = SimdClass::Splat(_triangle.planes[i][1]);
+	}
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		float centerY = static_cast<float>(y) + 0.5f;
+		SimdFloat4 row0 = SimdClass::Splat(_triangle.edgeB[0] * centerY + _triangle.edgeC[0]);
+		SimdFloat4 row1 = SimdClass::Splat(_triangle.edgeB[1] * centerY + _triangle.edgeC[1]);
+		SimdFloat4 row2 = SimdClass::Splat(_triangle.edgeB[2] * centerY + _triangle.edgeC[2]);
+
+		float deltaY = centerY - _triangle.originY;
+		SimdFloat4 planeRows[6];
+		for (int i = 0; i < 6; i++)
+		{
+			planeRows[i] = SimdClass::Splat(_triangle.planes[i][0] + _triangle.planes[i][2] * deltaY);
+		}
+
+		size_t rowStart = static_cast<size_t>(y) * m_stride;
+		unsigned int* colorRow = m_colorBuffer + rowStart;
+		float* depthRow = m_depthBuffer + rowStart;
+
+		for (int x = minX; x <= maxX; x += 4)
+		{
+			SimdFloat4 centerX = SimdClass::Add(SimdClass::Splat(static_cast<float>(x)), pixelCenters);
+			SimdFloat4 edge0 = SimdClass::MultiplyAdd(edgeA0, centerX, row0);
+			SimdFloat4 edge1 = SimdClass::MultiplyAdd(edgeA1, centerX, row1);
+			SimdFloat4 edge2 = SimdClass::MultiplyAdd(edgeA2, centerX, row2);
+
+			//	Inside: >= 0 on top-left edges, > 0 (the negation is < 0) on the others
+			int covered = (topLeft0 ? ~SimdClass::NegativeMask(edge0) : SimdClass::NegativeMask(SimdClass::Subtract(zero, edge0)))
+				& (topLeft1 ? ~SimdClass::NegativeMask(edge1) : SimdClass::NegativeMask(SimdClass::Subtract(zero, edge1)))
+				& (topLeft2 ? ~SimdClass::NegativeMask(edge2) : SimdClass::NegativeMask(SimdClass::Subtract(zero, edge2)))
+				& 0xF;
+			if (covered == 0)
+			{
+				continue;
+			}
+
+			SimdFloat4 deltaX = SimdClass::Subtract(centerX, originX);
+			SimdFloat4 depth = SimdClass::MultiplyAdd(planeStepX[0], deltaX, planeRows[0]);
+			covered &= SimdClass::NegativeMask(SimdClass::Subtract(depth, SimdClass::Load(depthRow + x)));
+			if (covered == 0)
+			{
+				continue;
+			}
+
+			//	Colors to 0 - 255 (rounded), only the conversion to bytes is left for the lanes
+			SimdFloat4 w = SimdClass::Multiply(SimdClass::Divide(one, SimdClass::MultiplyAdd(planeStepX[1], deltaX, planeRows[1])), colorScale);
+			alignas(16) float depths[4];
+			alignas(16) float colors[4][4];
+			SimdClass::Store(depths, depth);
+			for (int channel = 0; channel < 4; channel++)
+			{
+				SimdFloat4 color = SimdClass::MultiplyAdd(SimdClass::MultiplyAdd(planeStepX[2 + channel], deltaX, planeRows[2 + channel]), w, half);
+				SimdClass::Store(colors[channel], SimdClass::Min(SimdClass::Max(color, zero), colorMaximum));
+			}
+
+			//	Select instead of branching, which lanes are covered is not predictable
+			for (int lane = 0; lane < 4; lane++)
+			{
+				bool write = (covered & (1 << lane)) != 0;
+				unsigned int color = static_cast<unsigned int>(colors[0][lane]) | (static_cast<unsigned int>(colors[1][lane]) << 8)
+					| (static_cast<unsigned int>(colors[2][lane]) << 16) | (static_cast<unsigned int>(colors[3][lane]) << 24);
+				depthRow[x + lane] = write ? depths[lane] : depthRow[x + lane];
+				colorRow[x + lane] = write ? color : colorRow[x + lane];
+			}
+		}
+	}
+}
\ No newline at end of file
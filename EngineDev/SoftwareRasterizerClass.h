@@ -0,0 +1,126 @@
+#pragma once
+
+#pragma region includes
+#include "JobSystemClass.h"
+#include "MathClass.h"
+#include "PipelineCompilerClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int SOFTWARE_TILE_SIZE = 64;				// pixels, a multiple of the 4 pixels rasterized at once
+const unsigned int SOFTWARE_BIN_BLOCK_SIZE = 254;		// triangles per block of a tile bin
+const unsigned int SOFTWARE_SUBPIXEL_BITS = 8;			// vertices are snapped to 1/256 pixel like on a GPU
+const float SOFTWARE_GUARD_BAND = 4.0f;					// triangles are only clipped where they reach this far outside of the screen (in NDC)
+#pragma endregion
+
+/*
+	Vertex of the software rasterizer, the color is R8G8B8A8 (red in the lowest byte)
+*/
+struct SoftwareVertex
+{
+	float x;
+	float y;
+	float z;
+	unsigned int color;
+};
+
+/*
+	Triangle rasterizer on the CPU with a color (R8G8B8A8) and a depth (float) buffer, the reference for the GPU backends
+
+	Works like a tiled GPU: DrawTriangles transforms, clips (near plane and guard band), culls and sets up the triangles
+	and sorts them into bins of SOFTWARE_TILE_SIZE pixel tiles (front end, calling thread)
+	Present rasterizes the tiles in parallel on the jobsystem (back end), every tile draws its triangles in submission order,
+	so the image does not depend on the amount of threads
+	Half-space rasterization: three edge functions per triangle, 4 pixels of a row per SIMD step, top-left fill rule, depth test less
+	Every edge is set up from its endpoints in a fixed order, so two triangles sharing an edge get exactly opposite edge functions (no gaps, no double pixels)
+	Colors are interpolated perspective correct
+
+	If the triangle or bin storage runs full the pending triangles are rasterized early, a frame can draw any amount of triangles
+	Nothing is allocated after Initialize
+*/
+class SoftwareRasterizerClass
+{
+public:
+	SoftwareRasterizerClass();
+	~SoftwareRasterizerClass();
+
+	bool Initialize(unsigned int _width, unsigned int _height, unsigned int _maxTriangles, JobSystemClass* _jobSystem);
+	void Shutdown();
+
+	void Clear(const float* _color, float _depth);
+	bool DrawTriangles(const SoftwareVertex* _vertices, unsigned int _vertexCount, const unsigned int* _indices, unsigned int _indexCount, const Matrix4& _transform, unsigned int _cullMode);
+	void Present();
+
+	bool SavePng(const char* _path) const;
+
+	unsigned int GetWidth() const;
+	unsigned int GetHeight() const;
+	unsigned int GetStride() const;
+	const unsigned int* GetColorBuffer() const;
+	const float* GetDepthBuffer() const;
+	unsigned long long GetRasterizedTriangleCount() const;
+
+private:
+	struct ClipVertex
+	{
+		Vector4 position;
+		float color[4];
+	};
+
+	//	Every attribute is a plane over the screen: value at the first vertex, change per pixel in x and in y
+	struct TriangleSetup
+	{
+		float edgeA[3];
+		float edgeB[3];
+		float edgeC[3];
+		unsigned int topLeftEdges;		// bit i: edge i owns the pixels exactly on it
+		float originX;
+		float originY;
+		float planes[6][3];				// depth, 1 / w, color / w (RGBA)
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	struct BinBlock
+	{
+		unsigned int triangles[SOFTWARE_BIN_BLOCK_SIZE];
+		unsigned int count;
+		unsigned int next;
+	};
+
+	JobSystemClass* m_jobSystem;
+	unsigned int m_width;
+	unsigned int m_height;
+	unsigned int m_stride;				// pixels per row, the buffers are padded to whole tiles
+	unsigned int m_tilesX;
+	unsigned int m_tilesY;
+	unsigned char* m_bufferMemory;
+	unsigned int* m_colorBuffer;
+	float* m_depthBuffer;
+
+	TriangleSetup* m_triangles;
+	unsigned int m_maxTriangles;
+	unsigned int m_triangleCount;
+	BinBlock* m_binBlocks;
+	unsigned int m_maxBinBlocks;
+	unsigned int m_binBlockCount;
+	unsigned int* m_binHeads;
+	unsigned int* m_binTails;
+
+	bool m_clearPending;
+	unsigned int m_clearColor;
+	float m_clearDepth;
+	unsigned long long m_rasterizedTriangles;
+
+	unsigned int ClipTriangle(const ClipVertex* _triangle, ClipVertex* _polygon) const;
+	void SetupTriangle(const ClipVertex& _v0, const ClipVertex& _v1, const ClipVertex& _v2, unsigned int _cullMode);
+	void BinTriangle(unsigned int _triangle);
+	void Flush();
+	void ResetBins();
+
+	static void RasterizeJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+	void RasterizeTile(unsigned int _tile);
+	void RasterizeTriangle(const TriangleSetup& _triangle, int _tileX, int _tileY);
+};
\ No newline at end of file
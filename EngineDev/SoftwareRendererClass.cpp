@@ -0,0 +1,161 @@
+#include "SoftwareRendererClass.h"
+#include "ProfilerClass.h"
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#pragma region Globals
+static const float SOFTWARE_CLEAR_COLOR[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+#pragma endregion
+
+/*
+	Constructor
+*/
+SoftwareRendererClass::SoftwareRendererClass()
+{
+	m_windowHandle = nullptr;
+	m_presentBuffer = nullptr;
+	m_renderedFrames = 0;
+}
+
+/*
+	Destructor
+*/
+SoftwareRendererClass::~SoftwareRendererClass()
+{
+
+}
+
+/*
+	Create the framebuffer in the size of the screen and clear it for the first frame
+	There is no swap chain, vsync, fullscreen and the frames in flight do not apply
+*/
+bool SoftwareRendererClass::Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem)
+{
+	PROFILE_SCOPE("SoftwareRendererClass::Initialize");
+
+	if (_screenHeight <= 0 || _screenWidth <= 0)
+	{
+		return false;
+	}
+
+	if (!m_rasterizer.Initialize(static_cast<unsigned int>(_screenWidth), static_cast<unsigned int>(_screenHeight), SOFTWARE_MAX_TRIANGLES, _jobSystem))
+	{
+		return false;
+	}
+
+#ifdef _WIN32
+	m_windowHandle = _windowHandle;
+	if (m_windowHandle)
+	{
+		m_presentBuffer = new unsigned int[static_cast<size_t>(_screenWidth) * _screenHeight];
+		if (!m_presentBuffer)
+		{
+			return false;
+		}
+	}
+#endif
+
+	m_renderedFrames = 0;
+	m_rasterizer.Clear(SOFTWARE_CLEAR_COLOR, 1.0f);
+
+	return true;
+}
+
+void SoftwareRendererClass::Shutdown()
+{
+	if (m_presentBuffer)
+	{
+		delete[] m_presentBuffer;
+		m_presentBuffer = nullptr;
+	}
+
+	m_rasterizer.Shutdown();
+	m_windowHandle = nullptr;
+}
+
+/*
+	Rasterize what was drawn since the last frame, show it in the window if there is one
+	Clear for the next frame, the clear only happens when the next frame is rasterized so the presented frame stays readable
+*/
+bool SoftwareRendererClass::Render()
+{
+	PROFILE_SCOPE("SoftwareRendererClass::Render");
+
+	m_rasterizer.Present();
+
+	if (m_windowHandle)
+	{
+		PresentToWindow();
+	}
+
+	m_renderedFrames++;
+
+	m_rasterizer.Clear(SOFTWARE_CLEAR_COLOR, 1.0f);
+
+	return true;
+}
+
+/*
+	Write the last presented frame as PNG
+*/
+bool SoftwareRendererClass::SaveScreenshot(const char* _path)
+{
+	return m_rasterizer.SavePng(_path);
+}
+
+/*
+	The rasterizer to draw into, draws before Render end up in the next presented frame
+*/
+SoftwareRasterizerClass& SoftwareRendererClass::GetRasterizer()
+{
+	return m_rasterizer;
+}
+
+unsigned long long SoftwareRendererClass::GetRenderedFrameCount() const
+{
+	return m_renderedFrames;
+}
+
+/*
+	Swap red and blue into the BGRA order of a GDI bitmap and stretch it over the client area
+*/
+void SoftwareRendererClass::PresentToWindow()
+{
+#ifdef _WIN32
+	PROFILE_SCOPE("SoftwareRendererClass::PresentToWindow");
+
+	unsigned int width = m_rasterizer.GetWidth();
+	unsigned int height = m_rasterizer.GetHeight();
+	const unsigned int* colors = m_rasterizer.GetColorBuffer();
+
+	for (unsigned int y = 0; y < height; y++)
+	{
+		const unsigned int* source = colors + static_cast<size_t>(y) * m_rasterizer.GetStride();
+		unsigned int* destination = m_presentBuffer + static_cast<size_t>(y) * width;
+		for (unsigned int x = 0; x < width; x++)
+		{
+			unsigned int color = source[x];
+			destination[x] = (color & 0xFF00FF00) | ((color & 0xFF) << 16) | ((color >> 16) & 0xFF);
+		}
+	}
+
+	//	Negative height: the rows are stored top down
+	BITMAPINFO bitmapInfo = {};
+	bitmapInfo.bmiHeader.biSize = sizeof(BITMAPINFOHEADER);
+	bitmapInfo.bmiHeader.biWidth = static_cast<LONG>(width);
+	bitmapInfo.bmiHeader.biHeight = -static_cast<LONG>(height);
+	bitmapInfo.bmiHeader.biPlanes = 1;
+	bitmapInfo.bmiHeader.biBitCount = 32;
+	bitmapInfo.bmiHeader.biCompression = BI_RGB;
+
+	HWND windowHandle = static_cast<HWND>(m_windowHandle);
+	RECT clientRect;
+	GetClientRect(windowHandle, &clientRect);
+
+	HDC deviceContext = GetDC(windowHandle);
+	StretchDIBits(deviceContext, 0, 0, clientRect.right - clientRect.left, clientRect.bottom - clientRect.top,
+		0, 0, static_cast<int>(width), static_cast<int>(height), m_presentBuffer, &bitmapInfo, DIB_RGB_COLORS, SRCCOPY);
+	ReleaseDC(windowHandle, deviceContext);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#pragma region includes
+#include "RendererClass.h"
+#include "SoftwareRasterizerClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int SOFTWARE_MAX_TRIANGLES = 65536;		// triangles binned before the rasterizer flushes early
+#pragma endregion
+
+/*
+	Backend which renders on the CPU with SoftwareRasterizerClass, for machines without a DirectX 12.1 GPU (CI, servers)
+	Clears to the same color as D3DClass, draws go to the rasterizer, Render presents the frame
+	With a window (windows only) the frame is copied into it with GDI, otherwise it stays in the CPU framebuffer
+	The last presented frame can be written as PNG, e.g. for image tests
+*/
+class SoftwareRendererClass : public RendererClass
+{
+public:
+	SoftwareRendererClass();
+	~SoftwareRendererClass();
+
+	bool Initialize(int _screenHeight, int _screenWidth, void* _windowHandle, const PresentSettings& _presentSettings, bool _fullscreen, unsigned int _framesInFlight, JobSystemClass* _jobSystem) override;
+	void Shutdown() override;
+
+	bool Render() override;
+	bool SaveScreenshot(const char* _path) override;
+
+	SoftwareRasterizerClass& GetRasterizer();
+	unsigned long long GetRenderedFrameCount() const;
+
+private:
+	void* m_windowHandle;
+	unsigned int* m_presentBuffer;		// windows only, the frame in the BGRA order GDI expects
+	unsigned long long m_renderedFrames;
+
+	SoftwareRasterizerClass m_rasterizer;
+
+	void PresentToWindow();
+};
\ No newline at end of file
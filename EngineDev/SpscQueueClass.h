@@ -0,0 +1,73 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#pragma endregion
+
+/*
+	Lock-free ring buffer for exactly one producer thread and one consumer thread
+	The producer only writes the tail and the consumer only writes the head, so no locks or compare-exchange are needed
+	_Capacity has to be a power of two, one slot stays empty to tell a full ring from an empty one
+*/
+template<typename T, unsigned int _Capacity>
+class SpscQueueClass
+{
+public:
+	SpscQueueClass()
+	{
+		m_head.store(0);
+		m_tail.store(0);
+	}
+
+	/*
+		Producer only
+		Fails if the consumer did not keep up and the ring is full
+	*/
+	bool Push(const T& _item)
+	{
+		unsigned int tail = m_tail.load(std::memory_order_relaxed);
+		unsigned int nextTail = (tail + 1) & (_Capacity - 1);
+
+		if (nextTail == m_head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		m_items[tail] = _item;
+		m_tail.store(nextTail, std::memory_order_release);
+
+		return true;
+	}
+
+	/*
+		Consumer only
+		Fails if there is nothing to take
+	*/
+	bool Pop(T& _item)
+	{
+		unsigned int head = m_head.load(std::memory_order_relaxed);
+
+		if (head == m_tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		_item = m_items[head];
+		m_head.store((head + 1) & (_Capacity - 1), std::memory_order_release);
+
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	static_assert((_Capacity & (_Capacity - 1)) == 0, "SpscQueueClass capacity has to be a power of two");
+
+	T m_items[_Capacity];
+	std::atomic<unsigned int> m_head;
+	char m_padding[64];				// producer and consumer write head and tail concurrently, keep them on different cache lines
+	std::atomic<unsigned int> m_tail;
+};
\ No newline at end of file
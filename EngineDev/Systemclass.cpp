@@ -1,29 +1,111 @@
 #include "Systemclass.h"
-#include <minwinbase.h>
+#include "ProfilerClass.h"
+#include "HeadlessPlatformClass.h"
+#include "MemoryTrackerClass.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifdef _WIN32
+#include "WindowsPlatformClass.h"
+#endif
 
 /*
 	Constructor
 */
 SystemClass::SystemClass()
 {
+	m_platform = nullptr;
 	m_graphics = nullptr;
 	m_input = nullptr;
+	m_jobSystem = nullptr;
+	m_frameAllocator = nullptr;
+	m_timer = nullptr;
+	m_world = nullptr;
+	m_assetLoader = nullptr;
+	m_renderThread = nullptr;
+	m_renderExtract = nullptr;
+	m_renderExtractData = nullptr;
+	m_viewMatrix = MathClass::Identity();
+	m_frameCount = 0;
+	m_totalFrameTime = 0.0;
+	m_frameHeapAllocations = 0;
+	m_screenshotPath = nullptr;
+	m_capturePath = nullptr;
 }
 
 SystemClass::~SystemClass()
 {
-	
+
 }
 
 /*
-	Initialize the windows window and the graphicsclass which will handle all graphical stuff
+	Initialize the jobsystem which every other system uses to work parallel
+	Initialize the frameallocator for the transient data of every frame
+	Initialize the asset loader and map the package, the assets themselves are streamed in later on background jobs
+	Initialize the platform (window or headless) and the graphicsclass which will handle all graphical stuff, then map the scene into it
+	   and load the meshes of the scene from the package
+	Initialize the renderthread which hands the snapshots of the frames to the graphicsclass, with a thread of its own if a pipeline depth is set
+	   its thread attaches to the jobsystem, so the jobsystem reserves a queue for it
+	Initialize the world which holds the entities the simulation works on
+	In headless mode there is no window and no GPU, the engine runs for the given amount of frames (0 = until escape/quit)
+	Initialize the timer last, so the first frame does not include the initialization time
+	Start the profiler capture first, so the trace also shows the initialization
 */
-bool SystemClass::Initialize()
+bool SystemClass::Initialize(const SystemSettings& _settings)
 {
 	int screenHeight = 0;
 	int screenWidth = 0;
 
-	InitializeWindow(screenHeight, screenWidth);
+#ifdef ENGINE_PROFILING
+	if (_settings.tracePath)
+	{
+		ProfilerClass::BeginCapture(_settings.tracePath);
+	}
+#endif
+
+	PROFILE_SCOPE("SystemClass::Initialize");
+
+	m_jobSystem = new JobSystemClass();
+	if (!m_jobSystem)
+	{
+		return false;
+	}
+
+	bool initializedJobSystem = m_jobSystem->Initialize(0, _settings.renderPipelineDepth > 0 ? 1 : 0);
+	if (!initializedJobSystem)
+	{
+		return false;
+	}
+
+	m_frameAllocator = new FrameAllocatorClass();
+	if (!m_frameAllocator)
+	{
+		return false;
+	}
+
+	bool initializedFrameAllocator = m_frameAllocator->Initialize(FRAME_MEMORY_SIZE, FRAMES_IN_FLIGHT);
+	if (!initializedFrameAllocator)
+	{
+		return false;
+	}
+
+	m_assetLoader = new AssetLoaderClass();
+	if (!m_assetLoader)
+	{
+		return false;
+	}
+
+	bool initializedAssetLoader = m_assetLoader->Initialize(m_jobSystem);
+	if (!initializedAssetLoader)
+	{
+		return false;
+	}
+
+	if (_settings.assetPackagePath && !m_assetLoader->OpenPackage(_settings.assetPackagePath))
+	{
+		printf("could not open the asset package %s\n", _settings.assetPackagePath);
+		return false;
+	}
 
 	m_input = new InputClass();
 	if (!m_input)
@@ -33,258 +115,486 @@ bool SystemClass::Initialize()
 
 	m_input->Initialize();
 
+	if (!InitializePlatform(_settings))
+	{
+		return false;
+	}
+
+	bool initializedPlatform = m_platform->Initialize(screenHeight, screenWidth, m_input);
+	if (!initializedPlatform)
+	{
+		return false;
+	}
+
 	m_graphics = new GraphicsClass();
 	if (!m_graphics)
 	{
 		return false;
 	}
 
-	bool initializedGraphics = m_graphics->Initialize(screenHeight, screenWidth, m_windowHandle);
+	bool initializedGraphics = m_graphics->Initialize(screenHeight, screenWidth, m_platform->GetWindowHandle(), _settings.headless, _settings.softwareRenderer, _settings.present, _settings.maxSceneObjects, m_jobSystem);
 	if (!initializedGraphics)
 	{
 		return false;
 	}
+	m_graphics->SetSceneCulling(_settings.sceneCulling);
 
-	return true;
-}
+	if (_settings.scenePath && !m_graphics->LoadScene(_settings.scenePath))
+	{
+		printf("could not load the scene %s (at most %u objects)\n", _settings.scenePath, _settings.maxSceneObjects);
+		return false;
+	}
 
-/*
-	Initialize the window, which will display everything
+	if (_settings.scenePath && _settings.assetPackagePath && !LoadSceneMeshes())
+	{
+		return false;
+	}
+
+	m_viewMatrix = m_graphics->GetViewMatrix();
+
+	m_renderThread = new RenderThreadClass();
+	if (!m_renderThread)
+	{
+		return false;
+	}
+
+	bool initializedRenderThread = m_renderThread->Initialize(m_graphics, m_jobSystem, _settings.renderPipelineDepth, MAX_DRAW_PACKETS);
+	if (!initializedRenderThread)
+	{
+		return false;
+	}
 
-	Declare some variables we are going to need later on
+	m_world = new WorldClass();
+	if (!m_world)
+	{
+		return false;
+	}
 
-	Get the instance of this application so we can use it later on
-	Give the application a name
+	bool initializedWorld = m_world->Initialize(WORLD_MAX_ENTITIES, WORLD_MAX_CHUNKS, m_jobSystem, m_frameAllocator);
+	if (!initializedWorld)
+	{
+		return false;
+	}
 
-	Fill the windowClass like we want it to use and register it so we can use it
+	m_timer = new TimerClass();
+	if (!m_timer)
+	{
+		return false;
+	}
 
-	If we want to activate fullscreenmode
-	Get the screenHeight and screenWidth so we can use the fullscreen mode
-	Initialize the DEVMODE object with the size we will need
-	Fill the object with its needed values
+	bool initializedTimer = m_timer->Initialize();
+	if (!initializedTimer)
+	{
+		return false;
+	}
+
+	m_timer->SetFixedTimestep(SIMULATION_TIMESTEP);
+	m_timer->SetTargetFrameRate(_settings.targetFrameRate);
 
-	If we want to use windowed mode
-	Set window height and width
-	Set the x and y position of the window
+	m_screenshotPath = _settings.screenshotPath;
+	m_capturePath = _settings.capturePath;
 
-	Create a new window with the size we defined/calculated and pass the instanceHandle
-	Afterwards show the window, set it to the foreground and set the focus on this window
-	We do not want to show a cursor so hide it
+	return true;
+}
+
+/*
+	Create the platform we are running on
+	Headless is available everywhere, a window is only available on windows for now
 */
-void SystemClass::InitializeWindow(int _screenHeight, int _screenWidth)
+bool SystemClass::InitializePlatform(const SystemSettings& _settings)
 {
-	WNDCLASSEX windowClass;
-	DEVMODE devModeScreenSettings;
-	int xPosition;
-	int yPosition;
+#ifdef _WIN32
+	if (!_settings.headless)
+	{
+		m_platform = new WindowsPlatformClass();
+		if (!m_platform)
+		{
+			return false;
+		}
 
-	ApplicationHandle = this;						// External pointer to this object
+		return true;
+	}
+#endif
 
-	m_instanceHandle = GetModuleHandle(nullptr);	// Get the instance of this application
+	HeadlessPlatformClass* headlessPlatform = new HeadlessPlatformClass();
+	if (!headlessPlatform)
+	{
+		return false;
+	}
 
-	m_applicationName = L"EngineDev";				// Give the application a name
+	headlessPlatform->SetFrameLimit(_settings.frameLimit);
+	m_platform = headlessPlatform;
 
-	windowClass.style = CS_HREDRAW | CS_VREDRAW | CS_OWNDC;				// allow redraw of the window
-	windowClass.lpfnWndProc = WndProc;									// function to handle the windows messages
-	windowClass.cbClsExtra = 0;											
-	windowClass.cbWndExtra = 0;
-	windowClass.hInstance = m_instanceHandle;							// pass the handle of this instance to the window
-	windowClass.hIcon = LoadIcon(nullptr, IDI_WINLOGO);					// set the icon of the application IDI = IDICON_...
-	windowClass.hIconSm = windowClass.hIcon;
-	windowClass.hCursor = LoadCursor(nullptr, IDC_ARROW);				// set the cursor for the application IDC = IDCURSOR_...
-	windowClass.hbrBackground = static_cast<HBRUSH>(GetStockObject(BLACK_BRUSH));	// set a black background
-	windowClass.lpszMenuName = nullptr;
-	windowClass.lpszClassName = m_applicationName;						// set the applicationname
-	windowClass.cbSize = sizeof(WNDCLASSEX);							// the whole size if this object shall be the size of it's class
+	return true;
+}
 
-	RegisterClassEx(&windowClass);
+/*
+	Load every mesh the objects of the scene reference and hand it to the graphicsclass, objects whose mesh is missing are not drawn
+	The meshes are only needed until the backend created their buffers, they are released right after
+*/
+bool SystemClass::LoadSceneMeshes()
+{
+	PROFILE_SCOPE("SystemClass::LoadSceneMeshes");
 
+	SceneFileClass* scene = m_graphics->GetScene();
+	const SceneMeshSection* meshes = scene->GetMeshes();
+	if (!meshes || scene->GetObjectCount() == 0)
+	{
+		return true;
+	}
 
-	if (FULL_SCREEN)
+	unsigned int objectCount = scene->GetObjectCount();
+	unsigned long long* meshIds = new unsigned long long[objectCount];
+	unsigned int* requests = new unsigned int[MAX_SCENE_MESHES];
+	if (!meshIds || !requests)
 	{
-		_screenHeight = GetSystemMetrics(SM_CYSCREEN);
-		_screenWidth = GetSystemMetrics(SM_CXSCREEN);
-		
-		memset(&devModeScreenSettings, 0, sizeof(devModeScreenSettings));				// Allocate the memory we need
-		devModeScreenSettings.dmSize = sizeof(devModeScreenSettings);					// set its size
-		devModeScreenSettings.dmPelsHeight = static_cast<unsigned long>(_screenHeight);				// set the height of the window
-		devModeScreenSettings.dmPelsWidth = static_cast<unsigned long>(_screenWidth);					// set the width of the window
-		devModeScreenSettings.dmBitsPerPel = 32;										// Bits per Pixel, this is the color resolution
-		devModeScreenSettings.dmFields = DM_BITSPERPEL | DM_PELSWIDTH | DM_PELSHEIGHT;	// Sets the bit inside the struct of the fields we have initialized
+		delete[] meshIds;
+		delete[] requests;
+		return false;
+	}
 
-		ChangeDisplaySettings(&devModeScreenSettings, CDS_FULLSCREEN);					// Set the window to fullscreen and pass the devmode
+	memcpy(meshIds, meshes->meshIds.Get(), objectCount * sizeof(unsigned long long));
+	std::sort(meshIds, meshIds + objectCount);
+	unsigned int meshCount = static_cast<unsigned int>(std::unique(meshIds, meshIds + objectCount) - meshIds);
 
-		xPosition = 0;
-		yPosition = 0;
-	}
-	else
+	if (meshCount > MAX_SCENE_MESHES)
 	{
-		_screenHeight = 600;
-		_screenWidth = 800;
+		printf("the scene uses %u meshes, only the first %u are loaded\n", meshCount, MAX_SCENE_MESHES);
+		meshCount = MAX_SCENE_MESHES;
+	}
 
-		xPosition = (GetSystemMetrics(SM_CXSCREEN) - _screenWidth) / 2;
-		yPosition = (GetSystemMetrics(SM_CYSCREEN) - _screenHeight) / 2;
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		requests[i] = m_assetLoader->Load(meshIds[i], ASSET_PRIORITY_HIGH, nullptr, nullptr);
 	}
-	
 
-	m_windowHandle = CreateWindowEx(WS_EX_APPWINDOW, m_applicationName, m_applicationName, 
-		WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_POPUP, 
-		xPosition, yPosition, _screenWidth, _screenHeight,
-		nullptr, nullptr, m_instanceHandle, nullptr);
+	m_assetLoader->WaitForAll();
+
+	for (unsigned int i = 0; i < meshCount; i++)
+	{
+		const AssetHeader* asset = requests[i] != INVALID_ASSET_REQUEST ? m_assetLoader->GetAsset(requests[i]) : nullptr;
+		const MeshAssetHeader* mesh = asset ? MeshAssetClass::Get(asset) : nullptr;
+
+		if (!mesh || !m_graphics->AddMesh(meshIds[i], *mesh))
+		{
+			printf("could not load the mesh %016llx of the scene\n", meshIds[i]);
+		}
+
+		if (requests[i] != INVALID_ASSET_REQUEST)
+		{
+			m_assetLoader->Release(requests[i]);
+		}
+	}
 
-	ShowWindow(m_windowHandle, SW_SHOW);
-	SetForegroundWindow(m_windowHandle);
-	SetFocus(m_windowHandle);
+	delete[] meshIds;
+	delete[] requests;
 
-	ShowCursor(false);
+	return true;
 }
 
 /*
 	Loop the program until we decide to quit it
 	If we leave this loop the programm will be shutdown inside the main function
 
-	Check for every input we get (messages in windows) and handle them inside of WndProc
+	Let the platform handle every message of the operating system before each frame
+	Wait until the backend can present another frame before the frame starts, so its input is sampled as late as possible
+	Measure the time since the last frame and the CPU time every frame takes
+	Sleep at the end of the frame if a frame rate limit is set
+	Collect the profiler zones of the frame once Frame returned, so the zone of Frame itself belongs to the frame
+	With a render thread the frame only covers the simulation, wait for the renderer once the loop is left
 */
 void SystemClass::Run()
 {
-	MSG message;
-
-	ZeroMemory(&message, sizeof(MSG));
-
-	while (true)
+	while (m_platform->PumpMessages())
 	{
-		if (PeekMessage(&message, nullptr, 0, 0, PM_REMOVE))
+		if (!m_graphics->WaitForFrameLatency())
 		{
-			TranslateMessage(&message);
-			DispatchMessage(&message);
+			break;
 		}
 
-		if (message.message == WM_QUIT)
+		m_timer->Frame();
+		if (m_frameCount > 0)
 		{
-			break;
+			m_frameStatistics.AddFrameTime(m_timer->GetDeltaTime() * 1000.0);
 		}
-		else
+
+		unsigned long long frameStart = TimerClass::GetMicroseconds();
+
+		bool result = Frame();
+		if (!result)
 		{
-			bool result = Frame();
-			if (!result)
-			{
-				break;
-			}
+			break;
 		}
+
+		double frameTime = static_cast<double>(TimerClass::GetMicroseconds() - frameStart) * 0.001;
+		m_cpuFrameStatistics.AddFrameTime(frameTime);
+		m_totalFrameTime += frameTime;
+		m_frameCount++;
+
+		PROFILE_END_FRAME();
+
+		m_timer->WaitForTargetFrameRate();
 	}
+
+	m_renderThread->WaitForIdle();
 }
 
 /*
-	Call the method Frame from the graphicsClass
+	Take the snapshot of the input events which arrived since the last frame
+	Advance the simulation in fixed steps until it caught up with the time of this frame
+	Write the camera and the draws of the frame into a render snapshot and hand it to the renderthread
+	   without a render thread it is rendered right away, otherwise the next frame starts while it is rendered
+	Release the transient memory of the oldest frame at the end of every frame
+	Count the heap allocations the frame made, frame code is supposed to use the frameallocator instead (background jobs running meanwhile are left out)
 	If it succeded return true;
 */
 bool SystemClass::Frame()
 {
-	if (m_input->IsKeyDown(VK_ESCAPE))
+	PROFILE_SCOPE("SystemClass::Frame");
+
+	unsigned long long allocationsBeforeFrame = MemoryTrackerClass::GetForegroundAllocationCount();
+
+	m_input->Update();
+	unsigned long long inputTime = TimerClass::GetMicroseconds();
+
+	if (m_input->IsKeyDown(KEY_ESCAPE) || m_input->WasKeyPressed(KEY_ESCAPE))
 	{
 		return false;
 	}
 
-	bool result = m_graphics->Frame();
+	while (m_timer->StepSimulation())
+	{
+		if (!Simulate(m_timer->GetFixedTimestep()))
+		{
+			return false;
+		}
+	}
+
+	RenderSnapshotClass* snapshot = m_renderThread->Acquire();
+	if (!snapshot)
+	{
+		return false;
+	}
+
+	snapshot->Reset(m_frameCount, inputTime, m_viewMatrix);
+	if (m_renderExtract)
+	{
+		m_renderExtract(*m_world, *snapshot, *m_frameAllocator, m_renderExtractData);
+	}
+	m_viewMatrix = snapshot->GetViewMatrix();
+
+	bool result = m_renderThread->Submit();
 	if (!result)
 	{
 		return false;
 	}
 
+	m_frameAllocator->EndFrame();
+
+	m_frameHeapAllocations += MemoryTrackerClass::GetForegroundAllocationCount() - allocationsBeforeFrame;
+
 	return true;
 }
 
 /*
-	If the graphicsobject is initialized call the shutdown method on it
-	Release its memory
-	Call ShutdownWindow which will close the window etc.
+	Advance the game state by one fixed timestep
+	Every system of the world runs once per step
 */
-void SystemClass::Shutdown()
+bool SystemClass::Simulate(double _timestep)
 {
-	if (m_graphics)
-	{
-		m_graphics->Shutdown();
-		delete m_graphics;
-		m_graphics = nullptr;
-	}
+	PROFILE_SCOPE("SystemClass::Simulate");
 
-	if (m_input)
+	return m_world->Update(_timestep);
+}
+
+unsigned long long SystemClass::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+/*
+	Average CPU time of a frame in milliseconds
+*/
+double SystemClass::GetAverageFrameTime() const
+{
+	if (m_frameCount == 0)
 	{
-		delete m_input;
-		m_input = nullptr;
+		return 0.0;
 	}
 
-	ShutdownWindow();
+	return m_totalFrameTime / static_cast<double>(m_frameCount);
 }
 
 /*
-	Activate and show the cursor again
-	Coming back from fullscreen set the display settings to default
-	Remove the window and set its pointer to null
-	Remove the application instance and set its pointer to null
-	Release the pointer to this class
+	Heap allocations made inside of all frames so far
 */
-void SystemClass::ShutdownWindow()
+unsigned long long SystemClass::GetFrameHeapAllocations() const
 {
-	ShowCursor(true);
+	return m_frameHeapAllocations;
+}
 
-	if(FULL_SCREEN)
+/*
+	Most bytes a single frame took from the frameallocator
+*/
+size_t SystemClass::GetFrameMemoryPeak() const
+{
+	if (!m_frameAllocator)
 	{
-		ChangeDisplaySettings(nullptr, 0);
+		return 0;
 	}
 
-	DestroyWindow(m_windowHandle);
-	m_windowHandle = nullptr;
+	return m_frameAllocator->GetPeak();
+}
 
-	UnregisterClass(m_applicationName, m_instanceHandle);
-	m_instanceHandle = nullptr;
+/*
+	Rolling statistics of the time between two frames
+*/
+const FrameStatisticsClass& SystemClass::GetFrameStatistics() const
+{
+	return m_frameStatistics;
+}
 
-	ApplicationHandle = nullptr;
+/*
+	Rolling statistics of the CPU time spent inside of Frame
+*/
+const FrameStatisticsClass& SystemClass::GetCpuFrameStatistics() const
+{
+	return m_cpuFrameStatistics;
 }
 
 /*
-	Handle all incoming messages from the method WndProc which are not handled yet
-	Pass the pressed or released key to the inputobject and set its value so we know which key is pressed/released
-	Pass the other messages to the standard windows handler for messages
+	Input to present latency of the frames, nullptr if the backend does not present through a swap chain
 */
-LRESULT CALLBACK SystemClass::MessageHandler(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam)
+const PresentPolicyClass* SystemClass::GetPresentPolicy() const
 {
-	switch (_message)
-	{
-		case WM_KEYDOWN:
-			m_input->KeyDown(static_cast<unsigned int>(_wParam));
-			return 0;
+	return m_graphics ? m_graphics->GetPresentPolicy() : nullptr;
+}
 
-		case WM_KEYUP:
-			m_input->KeyUp(static_cast<unsigned int>(_wParam));
-			return 0;
+/*
+	Pipeline depth and the input to submit latency and render time of the frames
+*/
+const RenderThreadClass* SystemClass::GetRenderThread() const
+{
+	return m_renderThread;
+}
 
-		default:
-			return DefWindowProc(_windowHandle, _message, _wParam, _lParam);
-	}
+/*
+	The entities and systems the simulation works on
+*/
+WorldClass* SystemClass::GetWorld() const
+{
+	return m_world;
+}
+
+/*
+	Streams the assets of the package, loads run on background jobs
+*/
+AssetLoaderClass* SystemClass::GetAssetLoader() const
+{
+	return m_assetLoader;
 }
 
 /*
-	Handle all incoming messages from the method "Run"
-	If the message equals to WM_DESTROY or WM_CLOSE quit the program and close the window
-	Every other language pass it to the MessageHandler of systemclass
+	Meshes, culling objects and camera, the draws of the frames go through the render extract
+*/
+GraphicsClass* SystemClass::GetGraphics() const
+{
+	return m_graphics;
+}
+
+/*
+	Called every frame once the simulation steps are done, fills the render snapshot of the frame from the world
+	Set it before Run
+*/
+void SystemClass::SetRenderExtract(RenderExtractFunction _renderExtract, void* _data)
+{
+	m_renderExtract = _renderExtract;
+	m_renderExtractData = _data;
+}
 
-	Windows sends its messages to this function because of the line in the initialization
-	windowClass.lpfnWndProc = WndProc;
+/*
+	Shutdown the renderthread first, it renders what is left and stops using the graphicsclass
+	If the graphicsobject is initialized call the shutdown method on it
+	Release its memory
+	Shutdown the platform which will close the window etc.
+	Shutdown the asset loader before the jobsystem, it waits for the loads which are still running
+	Finish the profiler capture last, after every system is gone
 */
-LRESULT CALLBACK WndProc(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam)
+void SystemClass::Shutdown()
 {
-	switch (_message)
+	if (m_renderThread)
+	{
+		m_renderThread->Shutdown();
+		delete m_renderThread;
+		m_renderThread = nullptr;
+	}
+
+	if (m_timer)
+	{
+		m_timer->Shutdown();
+		delete m_timer;
+		m_timer = nullptr;
+	}
+
+	if (m_world)
+	{
+		m_world->Shutdown();
+		delete m_world;
+		m_world = nullptr;
+	}
+
+	if (m_graphics)
+	{
+		if (m_screenshotPath && !m_graphics->SaveScreenshot(m_screenshotPath))
+		{
+			printf("could not write the screenshot %s\n", m_screenshotPath);
+		}
+
+		if (m_capturePath && !m_graphics->SaveCommandCapture(m_capturePath))
+		{
+			printf("could not write the command capture %s\n", m_capturePath);
+		}
+
+		m_graphics->Shutdown();
+		delete m_graphics;
+		m_graphics = nullptr;
+	}
+
+	if (m_platform)
 	{
-		case WM_DESTROY:
-			PostQuitMessage(0);
-			return 0;
+		m_platform->Shutdown();
+		delete m_platform;
+		m_platform = nullptr;
+	}
+
+	if (m_input)
+	{
+		delete m_input;
+		m_input = nullptr;
+	}
 
-		case WM_CLOSE:
-			PostQuitMessage(0);
-			return 0;
+	if (m_assetLoader)
+	{
+		m_assetLoader->Shutdown();
+		delete m_assetLoader;
+		m_assetLoader = nullptr;
+	}
 
-		default:
-			return ApplicationHandle->MessageHandler(_windowHandle, _message, _wParam, _lParam);
+	if (m_frameAllocator)
+	{
+		m_frameAllocator->Shutdown();
+		delete m_frameAllocator;
+		m_frameAllocator = nullptr;
 	}
+
+	if (m_jobSystem)
+	{
+		m_jobSystem->Shutdown();
+		delete m_jobSystem;
+		m_jobSystem = nullptr;
+	}
+
+#ifdef ENGINE_PROFILING
+	ProfilerClass::EndCapture();
+#endif
 }
\ No newline at end of file
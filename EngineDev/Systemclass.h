@@ -1,44 +1,101 @@
 #pragma once
 
-#pragma region pre-processing directives
-#define WIN32_LEAN_AND_MEAN		// Exclude some APIs we do not need to speed up the build process
-#pragma endregion 
-
 #pragma region includes
-#include <windows.h>			// Create a window and use further win32 functions
+#include "PlatformClass.h"
 #include "GraphicsClass.h"
 #include "InputClass.h"
+#include "JobSystemClass.h"
+#include "FrameAllocatorClass.h"
+#include "TimerClass.h"
+#include "FrameStatisticsClass.h"
+#include "WorldClass.h"
+#include "AssetLoaderClass.h"
+#include "RenderThreadClass.h"
+#pragma endregion
+
+#pragma region global variables
+const double SIMULATION_TIMESTEP = 1.0 / 60.0;	// seconds the simulation advances with every step
+const unsigned int WORLD_MAX_ENTITIES = 65536;
+const unsigned int WORLD_MAX_CHUNKS = 1024;		// chunks of ECS_CHUNK_SIZE bytes the entities of the world may use
 #pragma endregion
 
+//	Writes what the world looks like after the simulation steps of a frame into its render snapshot, runs on the simulation thread
+//	Scratch memory of the extract comes from _frameAllocator, it is released a few frames later
+typedef void (*RenderExtractFunction)(const WorldClass& _world, RenderSnapshotClass& _snapshot, FrameAllocatorClass& _frameAllocator, void* _data);
+
+/*
+	Options of the engine, read from the commandline in the main function
+*/
+struct SystemSettings
+{
+	bool headless;						// run without a window and without a GPU
+	unsigned int frameLimit;			// headless only, quit after this many frames, 0 = run until quit
+	unsigned int targetFrameRate;		// sleep between frames to hold this frame rate, 0 = no limit
+	const char* tracePath;				// profiling builds only, write the profiler zones of the whole run to this JSON file, nullptr = no capture
+	bool softwareRenderer;				// render on the CPU (SoftwareRendererClass), with or without a window
+	const char* screenshotPath;			// write the last frame to this PNG file on shutdown (software renderer only), nullptr = no screenshot
+	const char* assetPackagePath;		// package the assets are streamed from, nullptr = no package
+	const char* capturePath;			// write the commands of the last COMMAND_CAPTURE_FRAMES frames to this file on shutdown, nullptr = no file
+	const char* replayPath;				// replay this command capture on the null backend instead of running the engine, nullptr = run the engine
+	const char* comparePath;			// replay only, compare every frame with the same frame of this capture, nullptr = no comparison
+	PresentSettings present;			// present mode, back buffers and frame latency of the swap chain
+	const char* scenePath;				// binary scene file (SceneFileClass) whose objects the graphicsclass culls, nullptr = no scene
+	unsigned int renderPipelineDepth;	// frames the simulation may run ahead of a render thread (1 = double buffered), 0 = simulation and rendering alternate on the main thread
+	unsigned int sceneCulling;			// SCENE_CULLING_GRID or SCENE_CULLING_BVH, how the graphicsclass finds the visible objects of the scene
+	unsigned int maxSceneObjects;		// objects the scene may have, a larger scene is rejected, the scene stages are only allocated for the objects of the loaded scene
+};
+
 class SystemClass
 {
 public:
 	SystemClass();
 	~SystemClass();
 
-	bool Initialize();
+	bool Initialize(const SystemSettings& _settings);
 	void Shutdown();
 	void Run();
 
-	LRESULT CALLBACK MessageHandler(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam);
+	unsigned long long GetFrameCount() const;
+	double GetAverageFrameTime() const;
+	unsigned long long GetFrameHeapAllocations() const;
+	size_t GetFrameMemoryPeak() const;
 
-private:
-	LPCWSTR m_applicationName;
-	HINSTANCE m_instanceHandle;	// Handles our instance of the application
-	HWND m_windowHandle;		// Handles the window of our application
+	const FrameStatisticsClass& GetFrameStatistics() const;
+	const FrameStatisticsClass& GetCpuFrameStatistics() const;
+	const PresentPolicyClass* GetPresentPolicy() const;
+	const RenderThreadClass* GetRenderThread() const;
 
+	WorldClass* GetWorld() const;
+	AssetLoaderClass* GetAssetLoader() const;
+	GraphicsClass* GetGraphics() const;
+	void SetRenderExtract(RenderExtractFunction _renderExtract, void* _data);
+
+private:
+	PlatformClass* m_platform;
 	GraphicsClass* m_graphics;
 	InputClass* m_input;
+	JobSystemClass* m_jobSystem;
+	FrameAllocatorClass* m_frameAllocator;
+	TimerClass* m_timer;
+	WorldClass* m_world;
+	AssetLoaderClass* m_assetLoader;
+	RenderThreadClass* m_renderThread;
 
-	bool Frame();
-	void InitializeWindow(int _screenHeight, int _screenWidth);
-	void ShutdownWindow();
-};
+	RenderExtractFunction m_renderExtract;
+	void* m_renderExtractData;
+	Matrix4 m_viewMatrix;		// camera of the last snapshot, the next one starts from it
 
-#pragma region Function prototypes
-static LRESULT CALLBACK WndProc(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam);
-#pragma endregion
+	FrameStatisticsClass m_frameStatistics;		// time between two frames
+	FrameStatisticsClass m_cpuFrameStatistics;	// time spent inside of Frame
+
+	unsigned long long m_frameCount;
+	double m_totalFrameTime;	// CPU time spent in Frame in milliseconds
+	unsigned long long m_frameHeapAllocations;	// global heap allocations made inside of Frame, supposed to stay 0
+	const char* m_screenshotPath;
+	const char* m_capturePath;
 
-#pragma region Globals
-static SystemClass* ApplicationHandle = nullptr;
-#pragma endregion
\ No newline at end of file
+	bool Frame();
+	bool Simulate(double _timestep);
+	bool InitializePlatform(const SystemSettings& _settings);
+	bool LoadSceneMeshes();
+};
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "TextureAssetClass.h"
+
+/*
+	Check type, version, format and that every mip lies inside the data with the expected footprint
+	Returns nullptr for anything which is not a valid texture
+*/
+const TextureAssetHeader* TextureAssetClass::Get(const AssetHeader* _asset)
+{
+	if (!_asset || _asset->type != ASSET_TYPE_TEXTURE || _asset->version != TEXTURE_ASSET_VERSION || _asset->size < sizeof(TextureAssetHeader))
+	{
+		return nullptr;
+	}
+
+	const TextureAssetHeader* texture = reinterpret_cast<const TextureAssetHeader*>(_asset);
+	unsigned int blockSize = GetBlockSize(texture->format);
+	if (blockSize == 0 || texture->mipCount == 0 || texture->mipCount > MAX_TEXTURE_MIPS || texture->width == 0 || texture->height == 0)
+	{
+		return nullptr;
+	}
+
+	if (texture->dataOffset < sizeof(TextureAssetHeader) || texture->dataOffset % ASSET_ALIGNMENT != 0 ||
+		texture->dataOffset > _asset->size || texture->dataSize > _asset->size - texture->dataOffset)
+	{
+		return nullptr;
+	}
+
+	for (unsigned int i = 0; i < texture->mipCount; i++)
+	{
+		const TextureMip& mip = texture->mips[i];
+		unsigned int expectedWidth = texture->width >> i > 0 ? texture->width >> i : 1;
+		unsigned int expectedHeight = texture->height >> i > 0 ? texture->height >> i : 1;
+		unsigned long long rowSize = static_cast<unsigned long long>((mip.width + 3) / 4) * blockSize;
+		unsigned long long mipSize = static_cast<unsigned long long>(mip.rowPitch) * mip.rowCount;
+
+		if (mip.width != expectedWidth || mip.height != expectedHeight || mip.rowCount != (mip.height + 3) / 4 ||
+			mip.rowPitch < rowSize || mip.rowPitch % TEXTURE_ROW_PITCH_ALIGNMENT != 0 || mip.offset % TEXTURE_MIP_ALIGNMENT != 0 ||
+			mip.offset > texture->dataSize || mipSize > texture->dataSize - mip.offset)
+		{
+			return nullptr;
+		}
+	}
+
+	return texture;
+}
+
+/*
+	Bytes per 4x4 block, 0 for formats a texture asset cannot have
+*/
+unsigned int TextureAssetClass::GetBlockSize(unsigned int _format)
+{
+	switch (_format)
+	{
+	case TEXTURE_FORMAT_BC1_UNORM:
+	case TEXTURE_FORMAT_BC1_UNORM_SRGB:
+		return 8;
+	case TEXTURE_FORMAT_BC3_UNORM:
+	case TEXTURE_FORMAT_BC3_UNORM_SRGB:
+		return 16;
+	default:
+		return 0;
+	}
+}
+
+bool TextureAssetClass::IsSrgb(unsigned int _format)
+{
+	return _format == TEXTURE_FORMAT_BC1_UNORM_SRGB || _format == TEXTURE_FORMAT_BC3_UNORM_SRGB;
+}
+
+const unsigned char* TextureAssetClass::GetMipData(const TextureAssetHeader& _texture, unsigned int _mip)
+{
+	return GetAssetArray<unsigned char>(&_texture.header, _texture.dataOffset + _texture.mips[_mip].offset);
+}
\ No newline at end of file
@@ -0,0 +1,63 @@
+#pragma once
+
+#pragma region includes
+#include "AssetPackageClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int ASSET_TYPE_TEXTURE = 2;
+const unsigned int TEXTURE_ASSET_VERSION = 1;
+const unsigned int MAX_TEXTURE_MIPS = 16;
+const unsigned int TEXTURE_ROW_PITCH_ALIGNMENT = 256;		// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT
+const unsigned int TEXTURE_MIP_ALIGNMENT = 512;				// D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+
+//	DXGI_FORMAT values, so the format can be handed to the device as it is
+const unsigned int TEXTURE_FORMAT_BC1_UNORM = 71;
+const unsigned int TEXTURE_FORMAT_BC1_UNORM_SRGB = 72;
+const unsigned int TEXTURE_FORMAT_BC3_UNORM = 77;
+const unsigned int TEXTURE_FORMAT_BC3_UNORM_SRGB = 78;
+#pragma endregion
+
+/*
+	One mip level, offset is from the start of the texture data
+	rowCount rows of 4x4 blocks, each row rowPitch bytes apart
+*/
+struct TextureMip
+{
+	unsigned long long offset;
+	unsigned int width;
+	unsigned int height;
+	unsigned int rowPitch;
+	unsigned int rowCount;
+};
+
+/*
+	A cooked texture (AssetCooker)
+	The data is laid out like the placed footprints of a D3D12 upload buffer: rows aligned to TEXTURE_ROW_PITCH_ALIGNMENT, mips to TEXTURE_MIP_ALIGNMENT
+	So copying [dataOffset, dataOffset + dataSize) to a TEXTURE_MIP_ALIGNMENT aligned place in an upload buffer is all the preparation a texture needs
+*/
+struct TextureAssetHeader
+{
+	AssetHeader header;
+	unsigned int width;
+	unsigned int height;
+	unsigned int format;
+	unsigned int mipCount;
+	unsigned long long dataOffset;		// from the start of the asset
+	unsigned long long dataSize;
+	TextureMip mips[MAX_TEXTURE_MIPS];
+};
+
+/*
+	Reads cooked textures in place
+	Get checks the header once, the mips can be used without further checks afterwards
+*/
+class TextureAssetClass
+{
+public:
+	static const TextureAssetHeader* Get(const AssetHeader* _asset);
+
+	static unsigned int GetBlockSize(unsigned int _format);
+	static bool IsSrgb(unsigned int _format);
+	static const unsigned char* GetMipData(const TextureAssetHeader& _texture, unsigned int _mip);
+};
\ No newline at end of file
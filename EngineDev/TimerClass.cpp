@@ -0,0 +1,176 @@
+#include "TimerClass.h"
+#include <chrono>
+#include <thread>
+#ifdef _WIN32
+#include <windows.h>
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")			// timeBeginPeriod, lets the scheduler wake sleeping threads with millisecond precision
+#endif
+
+/*
+	Constructor
+*/
+TimerClass::TimerClass()
+{
+	m_startTime = 0;
+	m_lastFrameTime = 0;
+	m_deltaTime = 0.0;
+	m_fixedTimestep = 1.0 / 60.0;
+	m_accumulator = 0.0;
+	m_targetFrameTime = 0;
+	m_nextFrameTime = 0;
+}
+
+/*
+	Destructor
+*/
+TimerClass::~TimerClass()
+{
+
+}
+
+/*
+	Start measuring at the current time
+	On windows a sleep lasts at least one scheduler tick (15.6 ms by default), so raise the timer resolution to 1 ms
+*/
+bool TimerClass::Initialize()
+{
+#ifdef _WIN32
+	timeBeginPeriod(1);
+#endif
+
+	m_startTime = GetMicroseconds();
+	m_lastFrameTime = m_startTime;
+	m_deltaTime = 0.0;
+	m_accumulator = 0.0;
+	m_nextFrameTime = 0;
+
+	return true;
+}
+
+/*
+	Restore the timer resolution of windows
+*/
+void TimerClass::Shutdown()
+{
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+/*
+	Microseconds of the monotonic clock, never jumps back like the wall clock can
+*/
+unsigned long long TimerClass::GetMicroseconds()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*
+	Seconds of the monotonic clock
+*/
+double TimerClass::GetTime()
+{
+	return static_cast<double>(GetMicroseconds()) * 0.000001;
+}
+
+/*
+	Called once at the start of every frame
+	Measure how long the last frame took and add it to the time the simulation has to catch up with
+*/
+void TimerClass::Frame()
+{
+	unsigned long long now = GetMicroseconds();
+
+	m_deltaTime = static_cast<double>(now - m_lastFrameTime) * 0.000001;
+	m_lastFrameTime = now;
+
+	m_accumulator += m_deltaTime < MAX_SIMULATION_DELTA ? m_deltaTime : MAX_SIMULATION_DELTA;
+}
+
+/*
+	Seconds between the start of the last and the current frame
+*/
+double TimerClass::GetDeltaTime() const
+{
+	return m_deltaTime;
+}
+
+/*
+	Seconds since Initialize
+*/
+double TimerClass::GetTotalTime() const
+{
+	return static_cast<double>(m_lastFrameTime - m_startTime) * 0.000001;
+}
+
+void TimerClass::SetFixedTimestep(double _seconds)
+{
+	m_fixedTimestep = _seconds;
+}
+
+double TimerClass::GetFixedTimestep() const
+{
+	return m_fixedTimestep;
+}
+
+/*
+	Call in a loop every frame, returns true as long as the simulation has to advance by one more fixed step
+*/
+bool TimerClass::StepSimulation()
+{
+	if (m_accumulator < m_fixedTimestep)
+	{
+		return false;
+	}
+
+	m_accumulator -= m_fixedTimestep;
+
+	return true;
+}
+
+/*
+	How far (0..1) the current frame is between the last simulation step and the next one
+	Render the state interpolated by this value, so the motion stays smooth even if the frame rate and the timestep differ
+*/
+double TimerClass::GetInterpolation() const
+{
+	return m_accumulator / m_fixedTimestep;
+}
+
+/*
+	0 turns the frame rate limit off
+*/
+void TimerClass::SetTargetFrameRate(unsigned int _framesPerSecond)
+{
+	m_targetFrameTime = _framesPerSecond == 0 ? 0 : 1000000ull / _framesPerSecond;
+	m_nextFrameTime = 0;
+}
+
+/*
+	Called at the end of every frame
+	Sleep until the next frame is due, so an idle engine does not burn a whole core
+	If we fell behind by more than a frame, do not try to catch up with a burst of frames, start over from now
+*/
+void TimerClass::WaitForTargetFrameRate()
+{
+	if (m_targetFrameTime == 0)
+	{
+		return;
+	}
+
+	unsigned long long now = GetMicroseconds();
+
+	if (m_nextFrameTime == 0 || now > m_nextFrameTime + m_targetFrameTime)
+	{
+		m_nextFrameTime = now + m_targetFrameTime;
+		return;
+	}
+
+	if (now < m_nextFrameTime)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(m_nextFrameTime - now));
+	}
+
+	m_nextFrameTime += m_targetFrameTime;
+}
\ No newline at end of file
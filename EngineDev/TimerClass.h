@@ -0,0 +1,50 @@
+#pragma once
+
+#pragma region global variables
+const double MAX_SIMULATION_DELTA = 0.25;	// seconds, longer frames (breakpoints, loading) are clamped so the simulation does not spiral
+#pragma endregion
+
+/*
+	Monotonic high resolution clock of the engine
+	Measures the time between frames, runs the simulation with a fixed timestep and limits the frame rate if wanted
+
+	Fixed timestep: every frame adds its duration to an accumulator, StepSimulation consumes it in fixed steps
+	The time which is left in the accumulator is used to interpolate between the last two simulation states
+
+	Frame rate limit: WaitForTargetFrameRate sleeps until the next frame is due instead of spinning
+*/
+class TimerClass
+{
+public:
+	TimerClass();
+	~TimerClass();
+
+	bool Initialize();
+	void Shutdown();
+
+	static unsigned long long GetMicroseconds();
+	static double GetTime();
+
+	void Frame();
+	double GetDeltaTime() const;
+	double GetTotalTime() const;
+
+	void SetFixedTimestep(double _seconds);
+	double GetFixedTimestep() const;
+	bool StepSimulation();
+	double GetInterpolation() const;
+
+	void SetTargetFrameRate(unsigned int _framesPerSecond);
+	void WaitForTargetFrameRate();
+
+private:
+	unsigned long long m_startTime;
+	unsigned long long m_lastFrameTime;
+	double m_deltaTime;
+
+	double m_fixedTimestep;
+	double m_accumulator;
+
+	unsigned long long m_targetFrameTime;
+	unsigned long long m_nextFrameTime;
+};
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+/*
+	Base class for the timestamp queries of a GPU queue
+	Commands write the GPU clock into a query, resolving copies the queries into memory the CPU can read
+	Resolved queries may only be read after the GPU finished the commandlist which resolved them
+	D3DTimestampQueriesClass wraps a query heap and a readback buffer, SimulatedTimestampQueriesClass reads a clock of the CPU
+*/
+class TimestampQueriesClass
+{
+public:
+	virtual ~TimestampQueriesClass() {}
+
+	virtual unsigned int GetQueryCount() const = 0;
+	virtual unsigned long long GetFrequency() const = 0;
+
+	virtual bool ReadTimestamps(unsigned int _firstQuery, unsigned int _queryCount, unsigned long long* _timestamps) = 0;
+	virtual bool Calibrate(unsigned long long& _gpuTimestamp, unsigned long long& _cpuMicroseconds) = 0;
+};
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "UploadRingClass.h"
+
+/*
+	Constructor
+*/
+UploadRingClass::UploadRingClass()
+{
+	m_memory = nullptr;
+	m_size = 0;
+	m_fence = nullptr;
+	m_head = 0;
+	m_tail = 0;
+	m_submittedHead = 0;
+	m_firstSubmission = 0;
+	m_submissionCount = 0;
+	m_waitCount = 0;
+}
+
+/*
+	Destructor
+*/
+UploadRingClass::~UploadRingClass()
+{
+
+}
+
+/*
+	The memory and the fence are not owned by the ring
+*/
+bool UploadRingClass::Initialize(void* _memory, size_t _size, FenceClass* _fence)
+{
+	if (!_memory || _size == 0 || !_fence)
+	{
+		return false;
+	}
+
+	m_memory = static_cast<unsigned char*>(_memory);
+	m_size = _size;
+	m_fence = _fence;
+	m_head = 0;
+	m_tail = 0;
+	m_submittedHead = 0;
+	m_firstSubmission = 0;
+	m_submissionCount = 0;
+	m_waitCount = 0;
+
+	return true;
+}
+
+void UploadRingClass::Shutdown()
+{
+	m_memory = nullptr;
+	m_size = 0;
+	m_fence = nullptr;
+}
+
+/*
+	Take _size bytes aligned to _alignment (a power of two) from the ring
+	If they do not fit in front of the end of the memory, skip the rest and start at the beginning
+	Reclaim the submissions the GPU finished, if that is not enough wait for the oldest one
+	Fails if the allocation is bigger than the ring or the memory which is not submitted yet fills the ring
+*/
+bool UploadRingClass::Allocate(size_t _size, size_t _alignment, size_t& _offset, void*& _cpuAddress)
+{
+	if (_size == 0 || _size > m_size || _alignment == 0 || (_alignment & (_alignment - 1)) != 0)
+	{
+		return false;
+	}
+
+	RetireSubmissions();
+
+	while (true)
+	{
+		size_t position = static_cast<size_t>(m_head % m_size);
+		size_t alignedPosition = (position + _alignment - 1) & ~(_alignment - 1);
+		size_t padding = alignedPosition - position;
+
+		if (alignedPosition + _size > m_size)
+		{
+			//	Skip to the beginning, which is aligned for every alignment
+			padding = m_size - position;
+			alignedPosition = 0;
+		}
+
+		if (m_head + padding + _size - m_tail <= m_size)
+		{
+			m_head += padding + _size;
+
+			_offset = alignedPosition;
+			_cpuAddress = m_memory + alignedPosition;
+
+			return true;
+		}
+
+		if (!WaitForOldestSubmission())
+		{
+			return false;
+		}
+	}
+}
+
+/*
+	Everything allocated since the last submit is free again once the fence reached _fenceValue
+	If too many submissions are pending, wait for the oldest one first
+*/
+void UploadRingClass::Submit(unsigned long long _fenceValue)
+{
+	if (m_head == m_submittedHead)
+	{
+		return;
+	}
+
+	RetireSubmissions();
+
+	if (m_submissionCount == UPLOAD_RING_SUBMISSIONS)
+	{
+		WaitForOldestSubmission();
+	}
+
+	Submission& submission = m_submissions[(m_firstSubmission + m_submissionCount) % UPLOAD_RING_SUBMISSIONS];
+	submission.fenceValue = _fenceValue;
+	submission.end = m_head;
+	m_submissionCount++;
+
+	m_submittedHead = m_head;
+}
+
+size_t UploadRingClass::GetSize() const
+{
+	return m_size;
+}
+
+/*
+	Bytes which are allocated and not reclaimed yet, including the bytes skipped at the end of the ring
+*/
+size_t UploadRingClass::GetUsed() const
+{
+	return static_cast<size_t>(m_head - m_tail);
+}
+
+/*
+	Bytes which are allocated but not submitted yet
+*/
+size_t UploadRingClass::GetPendingSize() const
+{
+	return static_cast<size_t>(m_head - m_submittedHead);
+}
+
+/*
+	How often an allocation had to wait for the GPU
+*/
+unsigned long long UploadRingClass::GetWaitCount() const
+{
+	return m_waitCount;
+}
+
+/*
+	Free the memory of every submission the GPU finished, oldest first
+*/
+void UploadRingClass::RetireSubmissions()
+{
+	if (m_submissionCount == 0)
+	{
+		return;
+	}
+
+	unsigned long long completedValue = m_fence->GetCompletedValue();
+
+	while (m_submissionCount > 0)
+	{
+		const Submission& submission = m_submissions[m_firstSubmission];
+		if (submission.fenceValue > completedValue)
+		{
+			break;
+		}
+
+		m_tail = submission.end;
+		m_firstSubmission = (m_firstSubmission + 1) % UPLOAD_RING_SUBMISSIONS;
+		m_submissionCount--;
+	}
+}
+
+/*
+	Block until the GPU finished the oldest submission and reclaim its memory
+	Fails if nothing is submitted, then only a submit can free memory
+*/
+bool UploadRingClass::WaitForOldestSubmission()
+{
+	if (m_submissionCount == 0)
+	{
+		return false;
+	}
+
+	m_waitCount++;
+
+	if (!m_fence->WaitForValue(m_submissions[m_firstSubmission].fenceValue))
+	{
+		return false;
+	}
+
+	RetireSubmissions();
+
+	return true;
+}
\ No newline at end of file
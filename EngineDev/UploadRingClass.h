@@ -0,0 +1,56 @@
+#pragma once
+
+#pragma region includes
+#include <cstddef>
+#include "FenceClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int UPLOAD_RING_SUBMISSIONS = 16;	// submissions whose memory may be pending on the GPU
+#pragma endregion
+
+/*
+	Sub-allocates staging memory for uploads from one big block, e.g. a persistently mapped upload buffer
+	Allocations are linear, everything allocated between two submits belongs to one submission
+	The memory of a submission is reused as soon as the fence passed the value the submission signals
+	Knows nothing about the graphics API, the memory and the fence come from outside
+*/
+class UploadRingClass
+{
+public:
+	UploadRingClass();
+	~UploadRingClass();
+
+	bool Initialize(void* _memory, size_t _size, FenceClass* _fence);
+	void Shutdown();
+
+	bool Allocate(size_t _size, size_t _alignment, size_t& _offset, void*& _cpuAddress);
+	void Submit(unsigned long long _fenceValue);
+
+	size_t GetSize() const;
+	size_t GetUsed() const;
+	size_t GetPendingSize() const;
+	unsigned long long GetWaitCount() const;
+
+private:
+	struct Submission
+	{
+		unsigned long long fenceValue;
+		unsigned long long end;		// ring position after the last allocation of the submission
+	};
+
+	unsigned char* m_memory;
+	size_t m_size;
+	FenceClass* m_fence;
+
+	unsigned long long m_head;		// positions only grow, the offset in the memory is position % size
+	unsigned long long m_tail;
+	unsigned long long m_submittedHead;
+	Submission m_submissions[UPLOAD_RING_SUBMISSIONS];
+	unsigned int m_firstSubmission;
+	unsigned int m_submissionCount;
+	unsigned long long m_waitCount;
+
+	void RetireSubmissions();
+	bool WaitForOldestSubmission();
+};
\ No newline at end of file
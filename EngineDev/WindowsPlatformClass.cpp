@@ -0,0 +1,229 @@
+#ifdef _WIN32
+
+#include "WindowsPlatformClass.h"
+#include "GraphicsClass.h"
+#include <minwinbase.h>
+
+/*
+	Constructor
+*/
+WindowsPlatformClass::WindowsPlatformClass()
+{
+	m_applicationName = nullptr;
+	m_instanceHandle = nullptr;
+	m_windowHandle = nullptr;
+	m_input = nullptr;
+}
+
+/*
+	Destructor
+*/
+WindowsPlatformClass::~WindowsPlatformClass()
+{
+
+}
+
+/*
+	Initialize the window, which will display everything
+
+	Declare some variables we are going to need later on
+
+	Get the instance of this application so we can use it later on
+	Give the application a name
+
+	Fill the windowClass like we want it to use and register it so we can use it
+
+	If we want to activate fullscreenmode
+	Get the screenHeight and screenWidth so we can use the fullscreen mode
+	Initialize the DEVMODE object with the size we will need
+	Fill the object with its needed values
+
+	If we want to use windowed mode
+	Set window height and width
+	Set the x and y position of the window
+
+	Create a new window with the size we defined/calculated and pass the instanceHandle
+	Afterwards show the window, set it to the foreground and set the focus on this window
+	We do not want to show a cursor so hide it
+*/
+bool WindowsPlatformClass::Initialize(int& _screenHeight, int& _screenWidth, InputClass* _input)
+{
+	WNDCLASSEX windowClass;
+	DEVMODE devModeScreenSettings;
+	int xPosition;
+	int yPosition;
+
+	ApplicationHandle = this;						// External pointer to this object
+
+	m_input = _input;
+
+	m_instanceHandle = GetModuleHandle(nullptr);	// Get the instance of this application
+
+	m_applicationName = L"EngineDev";				// Give the application a name
+
+	windowClass.style = CS_HREDRAW | CS_VREDRAW | CS_OWNDC;				// allow redraw of the window
+	windowClass.lpfnWndProc = WndProc;									// function to handle the windows messages
+	windowClass.cbClsExtra = 0;
+	windowClass.cbWndExtra = 0;
+	windowClass.hInstance = m_instanceHandle;							// pass the handle of this instance to the window
+	windowClass.hIcon = LoadIcon(nullptr, IDI_WINLOGO);					// set the icon of the application IDI = IDICON_...
+	windowClass.hIconSm = windowClass.hIcon;
+	windowClass.hCursor = LoadCursor(nullptr, IDC_ARROW);				// set the cursor for the application IDC = IDCURSOR_...
+	windowClass.hbrBackground = static_cast<HBRUSH>(GetStockObject(BLACK_BRUSH));	// set a black background
+	windowClass.lpszMenuName = nullptr;
+	windowClass.lpszClassName = m_applicationName;						// set the applicationname
+	windowClass.cbSize = sizeof(WNDCLASSEX);							// the whole size if this object shall be the size of it's class
+
+	RegisterClassEx(&windowClass);
+
+
+	if (FULL_SCREEN)
+	{
+		_screenHeight = GetSystemMetrics(SM_CYSCREEN);
+		_screenWidth = GetSystemMetrics(SM_CXSCREEN);
+
+		memset(&devModeScreenSettings, 0, sizeof(devModeScreenSettings));				// Allocate the memory we need
+		devModeScreenSettings.dmSize = sizeof(devModeScreenSettings);					// set its size
+		devModeScreenSettings.dmPelsHeight = static_cast<unsigned long>(_screenHeight);				// set the height of the window
+		devModeScreenSettings.dmPelsWidth = static_cast<unsigned long>(_screenWidth);					// set the width of the window
+		devModeScreenSettings.dmBitsPerPel = 32;										// Bits per Pixel, this is the color resolution
+		devModeScreenSettings.dmFields = DM_BITSPERPEL | DM_PELSWIDTH | DM_PELSHEIGHT;	// Sets the bit inside the struct of the fields we have initialized
+
+		ChangeDisplaySettings(&devModeScreenSettings, CDS_FULLSCREEN);					// Set the window to fullscreen and pass the devmode
+
+		xPosition = 0;
+		yPosition = 0;
+	}
+	else
+	{
+		_screenHeight = 600;
+		_screenWidth = 800;
+
+		xPosition = (GetSystemMetrics(SM_CXSCREEN) - _screenWidth) / 2;
+		yPosition = (GetSystemMetrics(SM_CYSCREEN) - _screenHeight) / 2;
+	}
+
+
+	m_windowHandle = CreateWindowEx(WS_EX_APPWINDOW, m_applicationName, m_applicationName,
+		WS_CLIPSIBLINGS | WS_CLIPCHILDREN | WS_POPUP,
+		xPosition, yPosition, _screenWidth, _screenHeight,
+		nullptr, nullptr, m_instanceHandle, nullptr);
+	if (!m_windowHandle)
+	{
+		return false;
+	}
+
+	ShowWindow(m_windowHandle, SW_SHOW);
+	SetForegroundWindow(m_windowHandle);
+	SetFocus(m_windowHandle);
+
+	ShowCursor(false);
+
+	return true;
+}
+
+/*
+	Activate and show the cursor again
+	Coming back from fullscreen set the display settings to default
+	Remove the window and set its pointer to null
+	Remove the application instance and set its pointer to null
+	Release the pointer to this class
+*/
+void WindowsPlatformClass::Shutdown()
+{
+	ShowCursor(true);
+
+	if(FULL_SCREEN)
+	{
+		ChangeDisplaySettings(nullptr, 0);
+	}
+
+	DestroyWindow(m_windowHandle);
+	m_windowHandle = nullptr;
+
+	UnregisterClass(m_applicationName, m_instanceHandle);
+	m_instanceHandle = nullptr;
+
+	m_input = nullptr;
+
+	ApplicationHandle = nullptr;
+}
+
+/*
+	Check for every input we get (messages in windows) and handle them inside of WndProc
+	Work through all pending messages so the message queue does not lag behind the frames
+	Return false as soon as windows wants us to quit
+*/
+bool WindowsPlatformClass::PumpMessages()
+{
+	MSG message;
+
+	ZeroMemory(&message, sizeof(MSG));
+
+	while (PeekMessage(&message, nullptr, 0, 0, PM_REMOVE))
+	{
+		if (message.message == WM_QUIT)
+		{
+			return false;
+		}
+
+		TranslateMessage(&message);
+		DispatchMessage(&message);
+	}
+
+	return true;
+}
+
+void* WindowsPlatformClass::GetWindowHandle() const
+{
+	return m_windowHandle;
+}
+
+/*
+	Handle all incoming messages from the method WndProc which are not handled yet
+	Pass the pressed or released key to the inputobject and set its value so we know which key is pressed/released
+	Pass the other messages to the standard windows handler for messages
+*/
+LRESULT CALLBACK WindowsPlatformClass::MessageHandler(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam)
+{
+	switch (_message)
+	{
+		case WM_KEYDOWN:
+			m_input->KeyDown(static_cast<unsigned int>(_wParam));
+			return 0;
+
+		case WM_KEYUP:
+			m_input->KeyUp(static_cast<unsigned int>(_wParam));
+			return 0;
+
+		default:
+			return DefWindowProc(_windowHandle, _message, _wParam, _lParam);
+	}
+}
+
+/*
+	Handle all incoming messages from the method "PumpMessages"
+	If the message equals to WM_DESTROY or WM_CLOSE quit the program and close the window
+	Every other language pass it to the MessageHandler of the platformclass
+
+	Windows sends its messages to this function because of the line in the initialization
+	windowClass.lpfnWndProc = WndProc;
+*/
+LRESULT CALLBACK WndProc(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam)
+{
+	switch (_message)
+	{
+		case WM_DESTROY:
+			PostQuitMessage(0);
+			return 0;
+
+		case WM_CLOSE:
+			PostQuitMessage(0);
+			return 0;
+
+		default:
+			return ApplicationHandle->MessageHandler(_windowHandle, _message, _wParam, _lParam);
+	}
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#ifdef _WIN32
+
+#pragma region pre-processing directives
+#define WIN32_LEAN_AND_MEAN		// Exclude some APIs we do not need to speed up the build process
+#pragma endregion 
+
+#pragma region includes
+#include <windows.h>			// Create a window and use further win32 functions
+#include "PlatformClass.h"
+#pragma endregion
+
+/*
+	Win32 platform, creates the window we render to and pumps its messages
+*/
+class WindowsPlatformClass : public PlatformClass
+{
+public:
+	WindowsPlatformClass();
+	~WindowsPlatformClass();
+
+	bool Initialize(int& _screenHeight, int& _screenWidth, InputClass* _input) override;
+	void Shutdown() override;
+	bool PumpMessages() override;
+
+	void* GetWindowHandle() const override;
+
+	LRESULT CALLBACK MessageHandler(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam);
+
+private:
+	LPCWSTR m_applicationName;
+	HINSTANCE m_instanceHandle;	// Handles our instance of the application
+	HWND m_windowHandle;		// Handles the window of our application
+
+	InputClass* m_input;
+};
+
+#pragma region Function prototypes
+static LRESULT CALLBACK WndProc(HWND _windowHandle, UINT _message, WPARAM _wParam, LPARAM _lParam);
+#pragma endregion
+
+#pragma region Globals
+static WindowsPlatformClass* ApplicationHandle = nullptr;
+#pragma endregion
+
+#endif
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "WorkStealingQueueClass.h"
+
+/*
+	Constructor
+*/
+WorkStealingQueueClass::WorkStealingQueueClass()
+{
+	m_top.store(0);
+	m_bottom.store(0);
+
+	for (unsigned int i = 0; i < WORK_STEALING_QUEUE_SIZE; i++)
+	{
+		m_jobs[i].store(nullptr, std::memory_order_relaxed);
+	}
+}
+
+/*
+	Destructor
+*/
+WorkStealingQueueClass::~WorkStealingQueueClass()
+{
+
+}
+
+/*
+	Only called by the owning thread
+	Store the job at the bottom and publish it to the thieves by moving the bottom
+	Fails if the queue is full
+*/
+bool WorkStealingQueueClass::Push(Job* _job)
+{
+	long long bottom = m_bottom.load(std::memory_order_relaxed);
+	long long top = m_top.load(std::memory_order_acquire);
+
+	if (bottom - top >= static_cast<long long>(WORK_STEALING_QUEUE_SIZE))
+	{
+		return false;
+	}
+
+	m_jobs[bottom & (WORK_STEALING_QUEUE_SIZE - 1)].store(_job, std::memory_order_relaxed);
+	m_bottom.store(bottom + 1, std::memory_order_release);
+
+	return true;
+}
+
+/*
+	Only called by the owning thread
+	Reserve the bottom job first, then check if a thief took it in the meantime
+	If it was the last job, thieves and owner race for it over the top index
+*/
+Job* WorkStealingQueueClass::Pop()
+{
+	long long bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(bottom, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long top = m_top.load(std::memory_order_relaxed);
+
+	if (top > bottom)
+	{
+		//	The queue was empty, restore the bottom
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job* job = m_jobs[bottom & (WORK_STEALING_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+	if (top == bottom)
+	{
+		//	Last job in the queue, a thief might try to take it at the same time
+		if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+
+		m_bottom.store(bottom + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+/*
+	Called by every other thread
+	Take the oldest job at the top, fail if the owner or another thief was faster
+*/
+Job* WorkStealingQueueClass::Steal()
+{
+	long long top = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	long long bottom = m_bottom.load(std::memory_order_acquire);
+
+	if (top >= bottom)
+	{
+		return nullptr;
+	}
+
+	Job* job = m_jobs[top & (WORK_STEALING_QUEUE_SIZE - 1)].load(std::memory_order_relaxed);
+
+	if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
+
+bool WorkStealingQueueClass::IsEmpty() const
+{
+	return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed);
+}
\ No newline at end of file
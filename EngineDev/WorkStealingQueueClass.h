@@ -0,0 +1,35 @@
+#pragma once
+
+#pragma region includes
+#include <atomic>
+#pragma endregion
+
+#pragma region global variables
+const unsigned int WORK_STEALING_QUEUE_SIZE = 4096;	// has to be a power of two
+#pragma endregion
+
+struct Job;
+
+/*
+	Lock-free double ended queue of jobs (Chase-Lev)
+	Only the owning thread pushes and pops at the bottom, every other thread steals from the top
+	The owner works on its newest jobs (warm caches), thieves take the oldest ones (usually the biggest chunks of work)
+*/
+class WorkStealingQueueClass
+{
+public:
+	WorkStealingQueueClass();
+	~WorkStealingQueueClass();
+
+	bool Push(Job* _job);
+	Job* Pop();
+	Job* Steal();
+
+	bool IsEmpty() const;
+
+private:
+	std::atomic<long long> m_top;
+	char m_padding[64];				// keep top and bottom on different cache lines, thieves and owner write them concurrently
+	std::atomic<long long> m_bottom;
+	std::atomic<Job*> m_jobs[WORK_STEALING_QUEUE_SIZE];
+};
\ No newline at end of file
@@ -0,0 +1,583 @@
+#include "WorldClass.h"
+#include "ProfilerClass.h"
+#include <cstring>
+
+/*
+	Constructor
+*/
+WorldClass::WorldClass()
+{
+	m_jobSystem = nullptr;
+	m_frameAllocator = nullptr;
+	m_componentTypeCount = 0;
+	m_archetypeCount = 0;
+	m_entities = nullptr;
+	m_maxEntities = 0;
+	m_entityCount = 0;
+	m_entityHighWater = 0;
+	m_firstFreeEntity = 0;
+	m_systemCount = 0;
+	m_stageCount = 0;
+}
+
+/*
+	Destructor
+*/
+WorldClass::~WorldClass()
+{
+
+}
+
+/*
+	Allocate the entity records and the pool of chunks once, the world never grows beyond them
+	Create the archetype without components, new entities without components live there
+	Update takes the job records of its stages from _frameAllocator, without one the systems run on the calling thread
+*/
+bool WorldClass::Initialize(unsigned int _maxEntities, unsigned int _maxChunks, JobSystemClass* _jobSystem, FrameAllocatorClass* _frameAllocator)
+{
+	m_jobSystem = _jobSystem;
+	m_frameAllocator = _frameAllocator;
+
+	if (_maxEntities == 0 || _maxEntities >= 0xFFFFFFFF)
+	{
+		return false;
+	}
+
+	if (!m_chunkPool.Initialize(ECS_CHUNK_SIZE, _maxChunks, ECS_CHUNK_ALIGNMENT))
+	{
+		return false;
+	}
+
+	m_entities = new EntityRecord[_maxEntities];
+	if (!m_entities)
+	{
+		return false;
+	}
+
+	m_maxEntities = _maxEntities;
+	m_entityCount = 0;
+	m_entityHighWater = 0;
+	m_firstFreeEntity = 0xFFFFFFFF;
+
+	m_componentTypeCount = 0;
+	m_archetypeCount = 0;
+	m_systemCount = 0;
+
+	if (FindArchetype(0) == INVALID_ARCHETYPE)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void WorldClass::Shutdown()
+{
+	for (unsigned int i = 0; i < m_archetypeCount; i++)
+	{
+		m_archetypes[i].Shutdown();
+	}
+	m_archetypeCount = 0;
+
+	if (m_entities)
+	{
+		delete[] m_entities;
+		m_entities = nullptr;
+	}
+
+	m_chunkPool.Shutdown();
+
+	m_maxEntities = 0;
+	m_entityCount = 0;
+	m_systemCount = 0;
+	m_jobSystem = nullptr;
+}
+
+/*
+	Returns the id of the new component type, INVALID_COMPONENT_TYPE if there are too many or the alignment is bigger than a cache line
+*/
+unsigned int WorldClass::RegisterComponent(const char* _name, size_t _size, size_t _alignment)
+{
+	if (m_componentTypeCount == MAX_COMPONENT_TYPES || _alignment > ECS_CHUNK_ALIGNMENT)
+	{
+		return INVALID_COMPONENT_TYPE;
+	}
+
+	ComponentType& componentType = m_componentTypes[m_componentTypeCount];
+	componentType.name = _name;
+	componentType.size = _size;
+	componentType.alignment = _alignment;
+
+	return m_componentTypeCount++;
+}
+
+/*
+	Take a free index (the most recently freed one first) or a new one
+	Add a row to the archetype of the components, the components are cleared to 0
+*/
+Entity WorldClass::CreateEntity(ComponentMask _components)
+{
+	unsigned int archetype = FindArchetype(_components);
+	if (archetype == INVALID_ARCHETYPE)
+	{
+		return INVALID_ENTITY;
+	}
+
+	unsigned int index;
+	if (m_firstFreeEntity != 0xFFFFFFFF)
+	{
+		index = m_firstFreeEntity;
+		m_firstFreeEntity = m_entities[index].nextFree;
+	}
+	else if (m_entityHighWater < m_maxEntities)
+	{
+		index = m_entityHighWater++;
+		m_entities[index].generation = 0;
+	}
+	else
+	{
+		return INVALID_ENTITY;
+	}
+
+	EntityRecord& record = m_entities[index];
+	Entity entity = (static_cast<unsigned long long>(record.generation) << 32) | index;
+
+	unsigned int row;
+	if (!m_archetypes[archetype].AddRow(entity, row))
+	{
+		record.nextFree = m_firstFreeEntity;
+		m_firstFreeEntity = index;
+		return INVALID_ENTITY;
+	}
+
+	for (unsigned int i = 0; i < m_componentTypeCount; i++)
+	{
+		if (_components & (1ULL << i))
+		{
+			memset(m_archetypes[archetype].GetComponent(i, row), 0, m_componentTypes[i].size);
+		}
+	}
+
+	record.archetype = archetype;
+	record.row = row;
+	m_entityCount++;
+
+	return entity;
+}
+
+/*
+	Remove the row from its archetype and fix the record of the entity which moved into it
+	Bump the generation, so the old id is not alive anymore, and put the index on the free list
+*/
+bool WorldClass::DestroyEntity(Entity _entity)
+{
+	if (!IsAlive(_entity))
+	{
+		return false;
+	}
+
+	unsigned int index = static_cast<unsigned int>(_entity);
+	EntityRecord& record = m_entities[index];
+
+	Entity movedEntity = m_archetypes[record.archetype].RemoveRow(record.row);
+	if (movedEntity != _entity)
+	{
+		m_entities[static_cast<unsigned int>(movedEntity)].row = record.row;
+	}
+
+	record.generation++;
+	record.archetype = INVALID_ARCHETYPE;
+	record.nextFree = m_firstFreeEntity;
+	m_firstFreeEntity = index;
+	m_entityCount--;
+
+	return true;
+}
+
+bool WorldClass::IsAlive(Entity _entity) const
+{
+	return GetRecord(_entity) != nullptr;
+}
+
+/*
+	Move the entity to the archetype with the component, the new component is cleared to 0
+*/
+bool WorldClass::AddComponent(Entity _entity, unsigned int _component)
+{
+	const EntityRecord* record = GetRecord(_entity);
+	if (!record || _component >= m_componentTypeCount)
+	{
+		return false;
+	}
+
+	unsigned int archetype = record->archetype;
+	if (m_archetypes[archetype].GetMask() & (1ULL << _component))
+	{
+		return true;
+	}
+
+	if (m_addEdges[archetype][_component] == INVALID_ARCHETYPE)
+	{
+		unsigned int target = FindArchetype(m_archetypes[archetype].GetMask() | (1ULL << _component));
+		if (target == INVALID_ARCHETYPE)
+		{
+			return false;
+		}
+
+		m_addEdges[archetype][_component] = static_cast<unsigned short>(target);
+		m_removeEdges[target][_component] = static_cast<unsigned short>(archetype);
+	}
+
+	if (!MoveEntity(_entity, m_addEdges[archetype][_component]))
+	{
+		return false;
+	}
+
+	memset(m_archetypes[record->archetype].GetComponent(_component, record->row), 0, m_componentTypes[_component].size);
+
+	return true;
+}
+
+/*
+	Move the entity to the archetype without the component
+*/
+bool WorldClass::RemoveComponent(Entity _entity, unsigned int _component)
+{
+	const EntityRecord* record = GetRecord(_entity);
+	if (!record || _component >= m_componentTypeCount)
+	{
+		return false;
+	}
+
+	unsigned int archetype = record->archetype;
+	if (!(m_archetypes[archetype].GetMask() & (1ULL << _component)))
+	{
+		return true;
+	}
+
+	if (m_removeEdges[archetype][_component] == INVALID_ARCHETYPE)
+	{
+		unsigned int target = FindArchetype(m_archetypes[archetype].GetMask() & ~(1ULL << _component));
+		if (target == INVALID_ARCHETYPE)
+		{
+			return false;
+		}
+
+		m_removeEdges[archetype][_component] = static_cast<unsigned short>(target);
+		m_addEdges[target][_component] = static_cast<unsigned short>(archetype);
+	}
+
+	return MoveEntity(_entity, m_removeEdges[archetype][_component]);
+}
+
+bool WorldClass::HasComponent(Entity _entity, unsigned int _component) const
+{
+	const EntityRecord* record = GetRecord(_entity);
+	if (!record || _component >= MAX_COMPONENT_TYPES)
+	{
+		return false;
+	}
+
+	return (m_archetypes[record->archetype].GetMask() & (1ULL << _component)) != 0;
+}
+
+/*
+	Address of the component of the entity, nullptr if the entity is dead or does not have it
+	Only valid until the next structural change
+*/
+void* WorldClass::GetComponent(Entity _entity, unsigned int _component) const
+{
+	const EntityRecord* record = GetRecord(_entity);
+	if (!record || _component >= MAX_COMPONENT_TYPES)
+	{
+		return nullptr;
+	}
+
+	return m_archetypes[record->archetype].GetComponent(_component, record->row);
+}
+
+/*
+	Register a system which runs on every chunk matching the query during Update
+	The system reads the components of the query and writes _writes, systems which write the same data never run at the same time
+*/
+unsigned int WorldClass::AddSystem(const char* _name, const EntityQuery& _query, ComponentMask _writes, EntitySystemFunction _function, void* _data)
+{
+	if (m_systemCount == MAX_ENTITY_SYSTEMS || !_function)
+	{
+		return MAX_ENTITY_SYSTEMS;
+	}
+
+	EntitySystem& system = m_systems[m_systemCount];
+	system.name = _name;
+	system.query = _query;
+	system.reads = _query.all | _writes;
+	system.writes = _writes;
+	system.function = _function;
+	system.data = _data;
+
+	return m_systemCount++;
+}
+
+/*
+	Call the function for every chunk which matches the query, on the calling thread
+*/
+void WorldClass::ForEach(const EntityQuery& _query, EntitySystemFunction _function, double _timestep, void* _data) const
+{
+	for (unsigned int i = 0; i < m_archetypeCount; i++)
+	{
+		const ArchetypeClass& archetype = m_archetypes[i];
+		if (!Matches(_query, archetype.GetMask()))
+		{
+			continue;
+		}
+
+		for (unsigned int j = 0; j < archetype.GetChunkCount(); j++)
+		{
+			EntityChunk chunk;
+			chunk.archetype = &archetype;
+			chunk.data = archetype.GetChunk(j);
+			chunk.count = archetype.GetChunkEntityCount(j);
+
+			_function(chunk, _timestep, _data);
+		}
+	}
+}
+
+/*
+	Run every system once
+	Grow a stage as long as the next system does not conflict with the systems already in it, then run the stage:
+	queue batches of at least ENTITY_CHUNKS_PER_JOB chunks of every matching archetype of every system of the stage as one job and wait for all of them
+	The jobs read their (system, archetype) pair from a record in the frameallocator, one per pair of the stage, which stays valid until the frame ended
+	Without a jobsystem, or if the frameallocator is full, the work runs on the calling thread
+*/
+bool WorldClass::Update(double _timestep)
+{
+	PROFILE_SCOPE("WorldClass::Update");
+
+	m_stageCount = 0;
+
+	unsigned int firstSystem = 0;
+	while (firstSystem < m_systemCount)
+	{
+		ComponentMask stageReads = 0;
+		ComponentMask stageWrites = 0;
+
+		unsigned int endSystem = firstSystem;
+		for (; endSystem < m_systemCount; endSystem++)
+		{
+			const EntitySystem& system = m_systems[endSystem];
+			if ((system.writes & (stageReads | stageWrites)) != 0 || (system.reads & stageWrites) != 0)
+			{
+				break;
+			}
+
+			stageReads |= system.reads;
+			stageWrites |= system.writes;
+		}
+
+		JobCounter stageCounter(0);
+		unsigned int jobCount = 0;
+		EntitySystemJob* jobs = nullptr;
+		if (m_jobSystem && m_frameAllocator)
+		{
+			jobs = m_frameAllocator->AllocateArray<EntitySystemJob>(static_cast<size_t>(endSystem - firstSystem) * m_archetypeCount);
+		}
+
+		for (unsigned int i = firstSystem; i < endSystem; i++)
+		{
+			for (unsigned int j = 0; j < m_archetypeCount; j++)
+			{
+				const ArchetypeClass& archetype = m_archetypes[j];
+				if (archetype.GetEntityCount() == 0 || !Matches(m_systems[i].query, archetype.GetMask()))
+				{
+					continue;
+				}
+
+				bool queued = false;
+				if (jobs)
+				{
+					EntitySystemJob& job = jobs[jobCount];
+					job.world = this;
+					job.system = i;
+					job.archetype = j;
+					job.timestep = _timestep;
+
+					//	Big archetypes get bigger batches, so a single archetype never floods the queue of the calling thread
+					unsigned int jobsPerArchetype = m_jobSystem->GetThreadCount() * 4;
+					unsigned int batchSize = (archetype.GetChunkCount() + jobsPerArchetype - 1) / jobsPerArchetype;
+					if (batchSize < ENTITY_CHUNKS_PER_JOB)
+					{
+						batchSize = ENTITY_CHUNKS_PER_JOB;
+					}
+
+					queued = m_jobSystem->ParallelFor(SystemJob, &job, archetype.GetChunkCount(), batchSize, &stageCounter);
+					if (queued)
+					{
+						jobCount++;
+					}
+				}
+
+				if (!queued)
+				{
+					RunSystem(i, j, 0, archetype.GetChunkCount(), _timestep);
+				}
+			}
+		}
+
+		if (m_jobSystem)
+		{
+			m_jobSystem->WaitForCounter(&stageCounter);
+		}
+
+		m_stageCount++;
+		firstSystem = endSystem;
+	}
+
+	return true;
+}
+
+unsigned int WorldClass::GetEntityCount() const
+{
+	return m_entityCount;
+}
+
+unsigned int WorldClass::GetArchetypeCount() const
+{
+	return m_archetypeCount;
+}
+
+unsigned int WorldClass::GetUsedChunkCount() const
+{
+	return m_chunkPool.GetBlockCount() - m_chunkPool.GetFreeCount();
+}
+
+/*
+	Stages the last Update ran the systems in
+*/
+unsigned int WorldClass::GetStageCount() const
+{
+	return m_stageCount;
+}
+
+/*
+	Look for the archetype with exactly these components, create it if there is none yet
+	Linear search, this is only needed the first time a component set shows up, afterwards the edges are used
+*/
+unsigned int WorldClass::FindArchetype(ComponentMask _components)
+{
+	for (unsigned int i = 0; i < m_archetypeCount; i++)
+	{
+		if (m_archetypes[i].GetMask() == _components)
+		{
+			return i;
+		}
+	}
+
+	//	Every component has to be registered
+	if (m_archetypeCount == MAX_ARCHETYPES || (m_componentTypeCount < MAX_COMPONENT_TYPES && (_components >> m_componentTypeCount) != 0))
+	{
+		return INVALID_ARCHETYPE;
+	}
+
+	if (!m_archetypes[m_archetypeCount].Initialize(_components, m_componentTypes, &m_chunkPool))
+	{
+		return INVALID_ARCHETYPE;
+	}
+
+	for (unsigned int i = 0; i < MAX_COMPONENT_TYPES; i++)
+	{
+		m_addEdges[m_archetypeCount][i] = INVALID_ARCHETYPE;
+		m_removeEdges[m_archetypeCount][i] = INVALID_ARCHETYPE;
+	}
+
+	return m_archetypeCount++;
+}
+
+/*
+	Add a row to the new archetype, copy the components both archetypes have
+	Remove the old row and fix the record of the entity which moved into it
+*/
+bool WorldClass::MoveEntity(Entity _entity, unsigned int _archetype)
+{
+	EntityRecord& record = m_entities[static_cast<unsigned int>(_entity)];
+
+	ArchetypeClass& source = m_archetypes[record.archetype];
+	ArchetypeClass& destination = m_archetypes[_archetype];
+
+	unsigned int row;
+	if (!destination.AddRow(_entity, row))
+	{
+		return false;
+	}
+
+	ComponentMask shared = source.GetMask() & destination.GetMask();
+	for (unsigned int i = 0; shared != 0; i++, shared >>= 1)
+	{
+		if (shared & 1)
+		{
+			memcpy(destination.GetComponent(i, row), source.GetComponent(i, record.row), m_componentTypes[i].size);
+		}
+	}
+
+	Entity movedEntity = source.RemoveRow(record.row);
+	if (movedEntity != _entity)
+	{
+		m_entities[static_cast<unsigned int>(movedEntity)].row = record.row;
+	}
+
+	record.archetype = _archetype;
+	record.row = row;
+
+	return true;
+}
+
+/*
+	The record of a living entity, nullptr if the index is unknown or the generation does not match anymore
+*/
+const WorldClass::EntityRecord* WorldClass::GetRecord(Entity _entity) const
+{
+	unsigned int index = static_cast<unsigned int>(_entity);
+	if (index >= m_entityHighWater)
+	{
+		return nullptr;
+	}
+
+	const EntityRecord& record = m_entities[index];
+	if (record.generation != static_cast<unsigned int>(_entity >> 32) || record.archetype == INVALID_ARCHETYPE)
+	{
+		return nullptr;
+	}
+
+	return &record;
+}
+
+void WorldClass::RunSystem(unsigned int _system, unsigned int _archetype, unsigned int _firstChunk, unsigned int _endChunk, double _timestep) const
+{
+	const EntitySystem& system = m_systems[_system];
+	const ArchetypeClass& archetype = m_archetypes[_archetype];
+
+	for (unsigned int i = _firstChunk; i < _endChunk; i++)
+	{
+		EntityChunk chunk;
+		chunk.archetype = &archetype;
+		chunk.data = archetype.GetChunk(i);
+		chunk.count = archetype.GetChunkEntityCount(i);
+
+		system.function(chunk, _timestep, system.data);
+	}
+}
+
+bool WorldClass::Matches(const EntityQuery& _query, ComponentMask _components)
+{
+	return (_components & _query.all) == _query.all && (_components & _query.none) == 0;
+}
+
+/*
+	Runs a system on the chunks [_begin, _end) of one archetype
+*/
+void WorldClass::SystemJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	const EntitySystemJob* job = static_cast<const EntitySystemJob*>(_data);
+
+	job->world->RunSystem(job->system, job->archetype, _begin, _end, job->timestep);
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#pragma region includes
+#include "ArchetypeClass.h"
+#include "PoolAllocatorClass.h"
+#include "JobSystemClass.h"
+#include "FrameAllocatorClass.h"
+#pragma endregion
+
+#pragma region global variables
+const unsigned int MAX_ARCHETYPES = 256;
+const unsigned int MAX_ENTITY_SYSTEMS = 64;
+const unsigned int ENTITY_CHUNKS_PER_JOB = 4;
+const unsigned int INVALID_ARCHETYPE = 0xFFFF;
+const unsigned int INVALID_COMPONENT_TYPE = 0xFFFFFFFF;
+const Entity INVALID_ENTITY = ~0ULL;
+#pragma endregion
+
+/*
+	Matches every archetype which has all components of all and none of none
+*/
+struct EntityQuery
+{
+	ComponentMask all;
+	ComponentMask none;
+};
+
+/*
+	The entities of one chunk a system works on, every component is one contiguous array
+*/
+struct EntityChunk
+{
+	const ArchetypeClass* archetype;
+	unsigned char* data;
+	unsigned int count;
+
+	const Entity* GetEntities() const
+	{
+		return reinterpret_cast<const Entity*>(data);
+	}
+
+	template<typename T>
+	T* GetComponents(unsigned int _component) const
+	{
+		size_t offset = archetype->GetComponentOffset(_component);
+		return offset == INVALID_COMPONENT_OFFSET ? nullptr : reinterpret_cast<T*>(data + offset);
+	}
+};
+
+/*
+	Works on the entities of one chunk, _data is the pointer given to AddSystem
+*/
+typedef void (*EntitySystemFunction)(const EntityChunk& _chunk, double _timestep, void* _data);
+
+/*
+	Archetype based entity component system
+	Entities are ids, their components live in the chunks of the archetype of their component set (see ArchetypeClass)
+	Adding or removing a component moves the entity to another archetype, the transitions are cached per archetype and component
+	An entity id holds a generation, ids of destroyed entities are detected even after their index got reused
+
+	Systems run in the order they were added, Update groups consecutive systems which do not write what another one reads or writes into stages
+	All systems of a stage run at the same time, every system spreads its chunks over the jobsystem
+	Structural changes (create, destroy, add, remove) are only allowed outside of Update and only from one thread
+	Update does not allocate from the heap, the job records of a stage come from the frameallocator
+*/
+class WorldClass
+{
+public:
+	WorldClass();
+	~WorldClass();
+
+	bool Initialize(unsigned int _maxEntities, unsigned int _maxChunks, JobSystemClass* _jobSystem, FrameAllocatorClass* _frameAllocator);
+	void Shutdown();
+
+	unsigned int RegisterComponent(const char* _name, size_t _size, size_t _alignment);
+
+	template<typename T>
+	unsigned int RegisterComponent(const char* _name)
+	{
+		return RegisterComponent(_name, sizeof(T), alignof(T));
+	}
+
+	Entity CreateEntity(ComponentMask _components);
+	bool DestroyEntity(Entity _entity);
+	bool IsAlive(Entity _entity) const;
+
+	bool AddComponent(Entity _entity, unsigned int _component);
+	bool RemoveComponent(Entity _entity, unsigned int _component);
+	bool HasComponent(Entity _entity, unsigned int _component) const;
+	void* GetComponent(Entity _entity, unsigned int _component) const;
+
+	template<typename T>
+	T* GetComponent(Entity _entity, unsigned int _component) const
+	{
+		return static_cast<T*>(GetComponent(_entity, _component));
+	}
+
+	unsigned int AddSystem(const char* _name, const EntityQuery& _query, ComponentMask _writes, EntitySystemFunction _function, void* _data);
+	void ForEach(const EntityQuery& _query, EntitySystemFunction _function, double _timestep, void* _data) const;
+	bool Update(double _timestep);
+
+	unsigned int GetEntityCount() const;
+	unsigned int GetArchetypeCount() const;
+	unsigned int GetUsedChunkCount() const;
+	unsigned int GetStageCount() const;
+
+private:
+	struct EntityRecord
+	{
+		unsigned int generation;
+		unsigned int archetype;
+		unsigned int row;
+		unsigned int nextFree;
+	};
+
+	struct EntitySystem
+	{
+		const char* name;
+		EntityQuery query;
+		ComponentMask reads;
+		ComponentMask writes;
+		EntitySystemFunction function;
+		void* data;
+	};
+
+	struct EntitySystemJob
+	{
+		const WorldClass* world;
+		unsigned int system;
+		unsigned int archetype;
+		double timestep;
+	};
+
+	JobSystemClass* m_jobSystem;
+	FrameAllocatorClass* m_frameAllocator;
+	PoolAllocatorClass m_chunkPool;
+
+	ComponentType m_componentTypes[MAX_COMPONENT_TYPES];
+	unsigned int m_componentTypeCount;
+
+	ArchetypeClass m_archetypes[MAX_ARCHETYPES];
+	unsigned int m_archetypeCount;
+	unsigned short m_addEdges[MAX_ARCHETYPES][MAX_COMPONENT_TYPES];		// archetype after adding the component, INVALID_ARCHETYPE if not known yet
+	unsigned short m_removeEdges[MAX_ARCHETYPES][MAX_COMPONENT_TYPES];
+
+	EntityRecord* m_entities;
+	unsigned int m_maxEntities;
+	unsigned int m_entityCount;
+	unsigned int m_entityHighWater;		// indices below have been handed out at least once
+	unsigned int m_firstFreeEntity;
+
+	EntitySystem m_systems[MAX_ENTITY_SYSTEMS];
+	unsigned int m_systemCount;
+	unsigned int m_stageCount;
+
+	unsigned int FindArchetype(ComponentMask _components);
+	bool MoveEntity(Entity _entity, unsigned int _archetype);
+	const EntityRecord* GetRecord(Entity _entity) const;
+	void RunSystem(unsigned int _system, unsigned int _archetype, unsigned int _firstChunk, unsigned int _endChunk, double _timestep) const;
+	static bool Matches(const EntityQuery& _query, ComponentMask _components);
+	static void SystemJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex);
+};
\ No newline at end of file
@@ -0,0 +1,350 @@
+#include "TestClass.h"
+#include "AssetLoaderClass.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#pragma region Globals
+static const char* const PACKAGE_PATH = "AssetLoaderBench.pak";
+static const char* const BROKEN_PACKAGE_PATH = "AssetLoaderBenchBroken.pak";
+static const unsigned int ASSET_COUNT = 96;
+static const size_t MIN_ASSET_SIZE = 16 * 1024;
+static const size_t MAX_ASSET_SIZE = 640 * 1024;
+static const unsigned int WORKER_COUNT = 3;
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run writes the same assets
+*/
+static unsigned int NextRandom(unsigned int& _state)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _state >> 8;
+}
+
+struct TestAsset
+{
+	unsigned long long id;
+	unsigned char* data;
+	size_t size;
+	char path[64];
+};
+
+/*
+	Raw assets of random sizes and content, written once into a package and once as a file per asset
+*/
+static TestAsset* CreateAssets(size_t& _totalSize)
+{
+	TestAsset* assets = new TestAsset[ASSET_COUNT];
+	unsigned int random = 1;
+	_totalSize = 0;
+
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		TestAsset& asset = assets[i];
+		char name[32];
+		snprintf(name, sizeof(name), "raw/asset%u.bin", i);
+		snprintf(asset.path, sizeof(asset.path), "AssetLoaderBench%u.bin", i);
+		asset.id = AssetPackageClass::GetAssetId(name);
+		asset.size = MIN_ASSET_SIZE + NextRandom(random) % (MAX_ASSET_SIZE - MIN_ASSET_SIZE);
+		asset.data = new unsigned char[asset.size];
+		for (size_t j = 0; j < asset.size; j++)
+		{
+			asset.data[j] = static_cast<unsigned char>(NextRandom(random));
+		}
+
+		AssetHeader* header = reinterpret_cast<AssetHeader*>(asset.data);
+		header->type = ASSET_TYPE_RAW;
+		header->version = 1;
+		header->size = asset.size;
+		_totalSize += asset.size;
+	}
+
+	//	The package wants its assets sorted by id
+	std::sort(assets, assets + ASSET_COUNT, [](const TestAsset& _a, const TestAsset& _b) { return _a.id < _b.id; });
+
+	return assets;
+}
+
+static bool WriteFiles(const TestAsset* _assets)
+{
+	AssetPackageInput inputs[ASSET_COUNT];
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		inputs[i] = { _assets[i].id, _assets[i].data, _assets[i].size };
+
+		FILE* file = fopen(_assets[i].path, "wb");
+		if (!file)
+		{
+			return false;
+		}
+		bool written = fwrite(_assets[i].data, 1, _assets[i].size, file) == _assets[i].size;
+		fclose(file);
+		if (!written)
+		{
+			return false;
+		}
+	}
+
+	return AssetPackageClass::Write(PACKAGE_PATH, inputs, ASSET_COUNT);
+}
+
+/*
+	Drop the file from the page cache, so the next read comes from the disk
+	A process can not do that on Windows, there both runs are warm
+*/
+static void DropFromCache(const char* _path)
+{
+#ifndef _WIN32
+	int file = open(_path, O_RDONLY);
+	if (file >= 0)
+	{
+		fdatasync(file);
+		posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+		close(file);
+	}
+#else
+	(void)_path;
+#endif
+}
+
+static void DropAllFromCache(const TestAsset* _assets)
+{
+	DropFromCache(PACKAGE_PATH);
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		DropFromCache(_assets[i].path);
+	}
+}
+
+/*
+	The baseline: open every file, read it into a buffer and hash it, one after the other on the calling thread
+*/
+static double ReadFiles(const TestAsset* _assets)
+{
+	unsigned char* buffer = new unsigned char[MAX_ASSET_SIZE];
+	unsigned int wrong = 0;
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		FILE* file = fopen(_assets[i].path, "rb");
+		if (!file)
+		{
+			wrong++;
+			continue;
+		}
+
+		size_t size = fread(buffer, 1, MAX_ASSET_SIZE, file);
+		fclose(file);
+		wrong += size != _assets[i].size || AssetPackageClass::HashAsset(buffer, size) != AssetPackageClass::HashAsset(_assets[i].data, _assets[i].size) ? 1 : 0;
+	}
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(wrong == 0);
+	delete[] buffer;
+
+	return milliseconds;
+}
+
+struct LoadResults
+{
+	std::atomic<unsigned int> loaded;
+	std::atomic<unsigned int> failed;
+	std::atomic<unsigned int> order;
+	unsigned int finishedAt[ASSET_COUNT + 1];		// position of every request in the order the callbacks came in
+};
+
+static void CountLoad(unsigned int _request, unsigned int _state, const AssetHeader* _asset, void* _userData)
+{
+	LoadResults* results = static_cast<LoadResults*>(_userData);
+	(_state == ASSET_STATE_LOADED && _asset ? results->loaded : results->failed).fetch_add(1);
+	if (_request <= ASSET_COUNT)
+	{
+		results->finishedAt[_request] = results->order.fetch_add(1);
+	}
+}
+
+static void ResetResults(LoadResults& _results)
+{
+	_results.loaded.store(0);
+	_results.failed.store(0);
+	_results.order.store(0);
+	memset(_results.finishedAt, 0, sizeof(_results.finishedAt));
+}
+
+/*
+	Every asset through the loader, the content has to be exactly what was written
+	_longestLoadCall is the longest time the calling thread spent in Load
+*/
+static double LoadPackage(JobSystemClass* _jobSystem, const TestAsset* _assets, LoadResults& _results, double& _longestLoadCall)
+{
+	AssetLoaderClass* loader = new AssetLoaderClass();
+	TEST_CHECK(loader->Initialize(_jobSystem));
+	ResetResults(_results);
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(loader->OpenPackage(PACKAGE_PATH));
+
+	unsigned int requests[ASSET_COUNT];
+	_longestLoadCall = 0.0;
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		unsigned long long callStart = TimerClass::GetMicroseconds();
+		requests[i] = loader->Load(_assets[i].id, ASSET_PRIORITY_NORMAL, CountLoad, &_results);
+		double callTime = TestClass::GetMilliseconds(callStart);
+		_longestLoadCall = callTime > _longestLoadCall ? callTime : _longestLoadCall;
+	}
+	loader->WaitForAll();
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		const AssetHeader* asset = loader->GetAsset(requests[i]);
+		wrong += loader->GetState(requests[i]) != ASSET_STATE_LOADED || !asset || memcmp(asset, _assets[i].data, _assets[i].size) != 0 ? 1 : 0;
+		TEST_CHECK(loader->Release(requests[i]));
+	}
+	TEST_CHECK(wrong == 0);
+	TEST_CHECK(_results.loaded.load() == ASSET_COUNT && _results.failed.load() == 0);
+
+	loader->Shutdown();
+	delete loader;
+
+	return milliseconds;
+}
+
+/*
+	A high priority request queued behind all the others is loaded next, not last
+	Cancelled requests never call back
+*/
+static void TestPriorityAndCancel(JobSystemClass* _jobSystem, const TestAsset* _assets, LoadResults& _results)
+{
+	AssetLoaderClass* loader = new AssetLoaderClass();
+	TEST_CHECK(loader->Initialize(_jobSystem));
+	TEST_CHECK(loader->OpenPackage(PACKAGE_PATH));
+	ResetResults(_results);
+
+	unsigned int requests[ASSET_COUNT];
+	for (unsigned int i = 0; i < ASSET_COUNT - 1; i++)
+	{
+		requests[i] = loader->Load(_assets[i].id, ASSET_PRIORITY_LOW, CountLoad, &_results);
+	}
+	unsigned int urgent = loader->Load(_assets[ASSET_COUNT - 1].id, ASSET_PRIORITY_HIGH, CountLoad, &_results);
+
+	unsigned int cancelled = 0;
+	for (unsigned int i = ASSET_COUNT / 2; i < ASSET_COUNT - 1; i++)
+	{
+		cancelled += loader->Cancel(requests[i]) ? 1 : 0;
+	}
+	loader->WaitForAll();
+
+	printf("priority: the high priority request finished as number %u of %u, %u of %u requests cancelled\n", _results.finishedAt[urgent] + 1,
+		_results.order.load(), cancelled, ASSET_COUNT - 1 - ASSET_COUNT / 2);
+
+	TEST_CHECK(urgent <= ASSET_COUNT && loader->GetState(urgent) == ASSET_STATE_LOADED);
+	TEST_CHECK(_results.finishedAt[urgent] < ASSET_COUNT / 4);
+	TEST_CHECK(cancelled > 0);
+	TEST_CHECK(_results.loaded.load() + cancelled == ASSET_COUNT && _results.failed.load() == 0);
+
+	for (unsigned int i = 0; i < ASSET_COUNT - 1; i++)
+	{
+		TEST_CHECK(loader->Release(requests[i]));
+	}
+	TEST_CHECK(loader->Release(urgent));
+
+	loader->Shutdown();
+	delete loader;
+}
+
+/*
+	A package with a flipped byte in one asset still opens, but that asset fails its hash check and the others load
+*/
+static void TestBrokenAsset(JobSystemClass* _jobSystem, const TestAsset* _assets, LoadResults& _results)
+{
+	AssetPackageInput inputs[ASSET_COUNT];
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		inputs[i] = { _assets[i].id, _assets[i].data, _assets[i].size };
+	}
+	TEST_CHECK(AssetPackageClass::Write(BROKEN_PACKAGE_PATH, inputs, ASSET_COUNT));
+
+	AssetPackageClass package;
+	TEST_CHECK(package.Open(BROKEN_PACKAGE_PATH));
+	unsigned long long offset = package.Find(_assets[0].id)->offset + _assets[0].size / 2;
+	package.Close();
+
+	FILE* file = fopen(BROKEN_PACKAGE_PATH, "r+b");
+	TEST_CHECK(file != nullptr);
+	if (file)
+	{
+		fseek(file, static_cast<long>(offset), SEEK_SET);
+		int value = fgetc(file);
+		fseek(file, static_cast<long>(offset), SEEK_SET);
+		fputc(value ^ 0xFF, file);
+		fclose(file);
+	}
+
+	AssetLoaderClass* loader = new AssetLoaderClass();
+	TEST_CHECK(loader->Initialize(_jobSystem));
+	TEST_CHECK(loader->OpenPackage(BROKEN_PACKAGE_PATH));
+	ResetResults(_results);
+
+	unsigned int broken = loader->Load(_assets[0].id, ASSET_PRIORITY_NORMAL, CountLoad, &_results);
+	unsigned int intact = loader->Load(_assets[1].id, ASSET_PRIORITY_NORMAL, CountLoad, &_results);
+	loader->WaitForAll();
+
+	TEST_CHECK(loader->GetState(broken) == ASSET_STATE_FAILED && loader->GetAsset(broken) == nullptr);
+	TEST_CHECK(loader->GetState(intact) == ASSET_STATE_LOADED);
+	TEST_CHECK(_results.loaded.load() == 1 && _results.failed.load() == 1);
+	loader->Release(broken);
+	loader->Release(intact);
+
+	loader->Shutdown();
+	delete loader;
+	remove(BROKEN_PACKAGE_PATH);
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	size_t totalSize = 0;
+	TestAsset* assets = CreateAssets(totalSize);
+	TEST_CHECK(WriteFiles(assets));
+
+	LoadResults* results = new LoadResults();
+	double megabytes = totalSize / (1024.0 * 1024.0);
+
+	DropAllFromCache(assets);
+	double coldRead = ReadFiles(assets);
+	DropAllFromCache(assets);
+	double longestLoadCall[2];
+	double coldLoad = LoadPackage(&jobSystem, assets, *results, longestLoadCall[0]);
+	double warmRead = ReadFiles(assets);
+	double warmLoad = LoadPackage(&jobSystem, assets, *results, longestLoadCall[1]);
+
+	printf("cold: fread %.1f ms (%.0f MB/s), loader %.1f ms (%.0f MB/s)\n", coldRead, megabytes / (coldRead * 0.001), coldLoad, megabytes / (coldLoad * 0.001));
+	printf("warm: fread %.1f ms (%.0f MB/s), loader %.1f ms (%.0f MB/s)\n", warmRead, megabytes / (warmRead * 0.001), warmLoad, megabytes / (warmLoad * 0.001));
+	printf("%u assets, %.1f MB, the longest Load call took %.3f ms cold and %.3f ms warm\n", ASSET_COUNT, megabytes, longestLoadCall[0], longestLoadCall[1]);
+
+	TestPriorityAndCancel(&jobSystem, assets, *results);
+	TestBrokenAsset(&jobSystem, assets, *results);
+
+	remove(PACKAGE_PATH);
+	for (unsigned int i = 0; i < ASSET_COUNT; i++)
+	{
+		remove(assets[i].path);
+		delete[] assets[i].data;
+	}
+	delete[] assets;
+	delete results;
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,392 @@
+#include "TestClass.h"
+#include "BvhClass.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int PRIMITIVE_COUNT = 1000000;
+static const float WORLD_SIZE = 4000.0f;
+static const float BORDER_TOLERANCE = 1e-3f;		// boxes closer to a frustum plane may go either way, the SIMD code rounds differently
+static const float DISTANCE_TOLERANCE = 1e-4f;		// relative, between the hit distances of the tree and the brute force
+static const unsigned int BOX_QUERIES = 1000;
+static const unsigned int CHECKED_BOX_QUERIES = 20;	// checked against brute force, which tests every box
+static const unsigned int CHECKED_RAYS = 50;
+static const unsigned int TIMED_RAYS = 100000;
+static const unsigned int MOVED_PRIMITIVES = 100000;
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run builds the same scene
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+struct Scene
+{
+	float* components;
+	BoundingBoxArrays boxes;
+};
+
+/*
+	Boxes of 0.5 - 5 units scattered over a flat world with a little height, like the props of an open world level
+*/
+static void CreateScene(Scene& _scene)
+{
+	_scene.components = new float[PRIMITIVE_COUNT * 6];
+	float* centerX = _scene.components;
+	float* centerY = centerX + PRIMITIVE_COUNT;
+	float* centerZ = centerY + PRIMITIVE_COUNT;
+	float* extentX = centerZ + PRIMITIVE_COUNT;
+	float* extentY = extentX + PRIMITIVE_COUNT;
+	float* extentZ = extentY + PRIMITIVE_COUNT;
+
+	unsigned int random = 4242;
+	for (unsigned int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		centerX[i] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		centerY[i] = NextRandom(random, 0.0f, 50.0f);
+		centerZ[i] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		extentX[i] = NextRandom(random, 0.5f, 5.0f);
+		extentY[i] = NextRandom(random, 0.5f, 5.0f);
+		extentZ[i] = NextRandom(random, 0.5f, 5.0f);
+	}
+
+	_scene.boxes = { centerX, centerY, centerZ, extentX, extentY, extentZ };
+}
+
+/*
+	The box of a primitive the way the tree stores it
+*/
+static Aabb GetBox(const Scene& _scene, unsigned int _primitive)
+{
+	const BoundingBoxArrays& boxes = _scene.boxes;
+	return { { boxes.centerX[_primitive] - boxes.extentX[_primitive], boxes.centerY[_primitive] - boxes.extentY[_primitive], boxes.centerZ[_primitive] - boxes.extentZ[_primitive] },
+		{ boxes.centerX[_primitive] + boxes.extentX[_primitive], boxes.centerY[_primitive] + boxes.extentY[_primitive], boxes.centerZ[_primitive] + boxes.extentZ[_primitive] } };
+}
+
+/*
+	Lowest distance of the box to one of the planes, negative if it is outside
+*/
+static float GetFrustumDistance(const Frustum& _frustum, const Aabb& _box)
+{
+	float lowest = FLT_MAX;
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float x = plane.x >= 0.0f ? _box.maximum.x : _box.minimum.x;
+		float y = plane.y >= 0.0f ? _box.maximum.y : _box.minimum.y;
+		float z = plane.z >= 0.0f ? _box.maximum.z : _box.minimum.z;
+		lowest = fminf(lowest, plane.x * x + plane.y * y + plane.z * z + plane.w);
+	}
+
+	return lowest;
+}
+
+static bool Overlaps(const Aabb& _a, const Aabb& _b)
+{
+	return _a.minimum.x <= _b.maximum.x && _a.maximum.x >= _b.minimum.x && _a.minimum.y <= _b.maximum.y && _a.maximum.y >= _b.minimum.y &&
+		_a.minimum.z <= _b.maximum.z && _a.maximum.z >= _b.minimum.z;
+}
+
+/*
+	Marks the primitives a query returned, a primitive returned twice or out of range counts as a mismatch
+*/
+static unsigned int MarkFound(const unsigned int* _primitives, unsigned int _count, unsigned char* _found)
+{
+	memset(_found, 0, PRIMITIVE_COUNT);
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		if (_primitives[i] >= PRIMITIVE_COUNT || _found[_primitives[i]])
+		{
+			mismatches++;
+			continue;
+		}
+		_found[_primitives[i]] = 1;
+	}
+
+	return mismatches;
+}
+
+/*
+	The tree against every box: primitives it returned which do not overlap and overlapping ones it missed
+*/
+static unsigned int CheckBoxQuery(const BvhClass& _bvh, const Scene& _scene, const Aabb& _query, unsigned int* _primitives, unsigned char* _found)
+{
+	unsigned int count = _bvh.QueryBox(_query, _primitives, PRIMITIVE_COUNT);
+	unsigned int mismatches = MarkFound(_primitives, count, _found);
+	for (unsigned int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		mismatches += (_found[i] != 0) != Overlaps(GetBox(_scene, i), _query) ? 1 : 0;
+	}
+
+	return mismatches;
+}
+
+/*
+	The tree against every box, boxes on the border of the frustum within BORDER_TOLERANCE are not counted as wrong
+*/
+static unsigned int CheckFrustumQuery(const BvhClass& _bvh, const Scene& _scene, const Frustum& _frustum, unsigned int* _primitives, unsigned char* _found,
+	unsigned int& _count)
+{
+	_count = _bvh.QueryFrustum(_frustum, _primitives, PRIMITIVE_COUNT);
+	unsigned int mismatches = MarkFound(_primitives, _count, _found);
+	for (unsigned int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		float distance = GetFrustumDistance(_frustum, GetBox(_scene, i));
+		mismatches += (_found[i] != 0) != (distance >= 0.0f) && fabsf(distance) > BORDER_TOLERANCE ? 1 : 0;
+	}
+
+	return mismatches;
+}
+
+/*
+	Nearest box along the ray by testing every one, with the slab test the tree uses
+*/
+static bool RaycastBruteForce(const Scene& _scene, const Vector3& _origin, const Vector3& _direction, float _maxDistance, BvhRayHit& _hit)
+{
+	Vector3 inverse = { 1.0f / _direction.x, 1.0f / _direction.y, 1.0f / _direction.z };
+	float nearest = _maxDistance;
+	unsigned int nearestPrimitive = INVALID_BVH_NODE;
+	for (unsigned int i = 0; i < PRIMITIVE_COUNT; i++)
+	{
+		Aabb box = GetBox(_scene, i);
+		float nearX = (box.minimum.x - _origin.x) * inverse.x;
+		float farX = (box.maximum.x - _origin.x) * inverse.x;
+		float nearY = (box.minimum.y - _origin.y) * inverse.y;
+		float farY = (box.maximum.y - _origin.y) * inverse.y;
+		float nearZ = (box.minimum.z - _origin.z) * inverse.z;
+		float farZ = (box.maximum.z - _origin.z) * inverse.z;
+
+		float entry = fmaxf(fmaxf(fminf(nearX, farX), fminf(nearY, farY)), fmaxf(fminf(nearZ, farZ), 0.0f));
+		float exit = fminf(fminf(fmaxf(nearX, farX), fmaxf(nearY, farY)), fmaxf(nearZ, farZ));
+		if (entry <= exit && entry < nearest)
+		{
+			nearest = entry;
+			nearestPrimitive = i;
+		}
+	}
+
+	_hit.primitive = nearestPrimitive;
+	_hit.distance = nearest;
+
+	return nearestPrimitive != INVALID_BVH_NODE;
+}
+
+/*
+	Rays from above the world down onto it, the direction is the segment to the target, so a distance of 1 is the target
+*/
+static void GetRay(unsigned int& _random, Vector3& _origin, Vector3& _direction)
+{
+	_origin = { NextRandom(_random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f), 100.0f, NextRandom(_random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f) };
+	_direction = { NextRandom(_random, -200.0f, 200.0f), NextRandom(_random, -100.0f, -60.0f), NextRandom(_random, -200.0f, 200.0f) };
+}
+
+/*
+	Hits of the tree and of the brute force which do not agree, the same distance counts as a match if two boxes are hit at the same point
+*/
+static unsigned int CheckRays(const BvhClass& _bvh, const Scene& _scene, unsigned int& _hits)
+{
+	unsigned int random = 99;
+	unsigned int mismatches = 0;
+	_hits = 0;
+	for (unsigned int i = 0; i < CHECKED_RAYS; i++)
+	{
+		Vector3 origin;
+		Vector3 direction;
+		GetRay(random, origin, direction);
+
+		BvhRayHit hit = {};
+		BvhRayHit expected = {};
+		bool found = _bvh.Raycast(origin, direction, 2.0f, hit);
+		bool expectedFound = RaycastBruteForce(_scene, origin, direction, 2.0f, expected);
+		_hits += expectedFound ? 1 : 0;
+
+		if (found != expectedFound)
+		{
+			mismatches++;
+		}
+		else if (found && hit.primitive != expected.primitive && fabsf(hit.distance - expected.distance) > DISTANCE_TOLERANCE * expected.distance)
+		{
+			mismatches++;
+		}
+	}
+
+	return mismatches;
+}
+
+static Frustum GetFrustum(const Vector3& _eye, const Vector3& _target, float _farPlane)
+{
+	Matrix4 view = MathClass::LookAt(_eye, _target, Vector3{ 0.0f, 1.0f, 0.0f });
+	Matrix4 projection = MathClass::Perspective(1.0f, 16.0f / 9.0f, 0.1f, _farPlane);
+
+	return MathClass::FrustumFromMatrix(MathClass::Multiply(view, projection));
+}
+
+/*
+	Box and frustum queries of the tree against brute force, returns the mismatches and adds up the times
+*/
+static unsigned int CheckQueries(const BvhClass& _bvh, const Scene& _scene, unsigned int* _primitives, unsigned char* _found, double& _boxTime, double& _frustumTime,
+	double& _bruteForceFrustumTime)
+{
+	unsigned int mismatches = 0;
+	unsigned int random = 7;
+	for (unsigned int i = 0; i < BOX_QUERIES; i++)
+	{
+		Vector3 center = { NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f), NextRandom(random, 0.0f, 50.0f), NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f) };
+		float size = NextRandom(random, 1.0f, 50.0f);
+		Aabb query = { { center.x - size, center.y - size, center.z - size }, { center.x + size, center.y + size, center.z + size } };
+
+		unsigned long long start = TimerClass::GetMicroseconds();
+		_bvh.QueryBox(query, _primitives, PRIMITIVE_COUNT);
+		_boxTime += TestClass::GetMilliseconds(start);
+
+		if (i < CHECKED_BOX_QUERIES)
+		{
+			mismatches += CheckBoxQuery(_bvh, _scene, query, _primitives, _found);
+		}
+	}
+
+	//	From the ground into the world, from the corner over all of it, and from outside looking away
+	Frustum frustums[3] = {
+		GetFrustum(Vector3{ 0.0f, 2.0f, 0.0f }, Vector3{ 100.0f, 2.0f, 100.0f }, 1000.0f),
+		GetFrustum(Vector3{ -WORLD_SIZE * 0.5f, 100.0f, -WORLD_SIZE * 0.5f }, Vector3{ 0.0f, 0.0f, 0.0f }, WORLD_SIZE * 2.0f),
+		GetFrustum(Vector3{ WORLD_SIZE, 10.0f, 0.0f }, Vector3{ WORLD_SIZE * 2.0f, 10.0f, 0.0f }, 1000.0f)
+	};
+	for (unsigned int i = 0; i < 3; i++)
+	{
+		unsigned long long start = TimerClass::GetMicroseconds();
+		_bvh.QueryFrustum(frustums[i], _primitives, PRIMITIVE_COUNT);
+		_frustumTime += TestClass::GetMilliseconds(start);
+
+		start = TimerClass::GetMicroseconds();
+		unsigned int visible = 0;
+		for (unsigned int j = 0; j < PRIMITIVE_COUNT; j++)
+		{
+			visible += MathClass::Intersects(frustums[i], GetBox(_scene, j)) ? 1 : 0;
+		}
+		_bruteForceFrustumTime += TestClass::GetMilliseconds(start);
+
+		unsigned int count = 0;
+		mismatches += CheckFrustumQuery(_bvh, _scene, frustums[i], _primitives, _found, count);
+		mismatches += i == 2 && count != 0 ? 1 : 0;
+		mismatches += i != 2 && visible == 0 ? 1 : 0;
+	}
+
+	return mismatches;
+}
+
+/*
+	Bounds of every box, the root of the tree has to be exactly that
+*/
+static bool CheckBounds(const BvhClass& _bvh, const Scene& _scene)
+{
+	Aabb bounds = GetBox(_scene, 0);
+	for (unsigned int i = 1; i < PRIMITIVE_COUNT; i++)
+	{
+		Aabb box = GetBox(_scene, i);
+		bounds.minimum = { fminf(bounds.minimum.x, box.minimum.x), fminf(bounds.minimum.y, box.minimum.y), fminf(bounds.minimum.z, box.minimum.z) };
+		bounds.maximum = { fmaxf(bounds.maximum.x, box.maximum.x), fmaxf(bounds.maximum.y, box.maximum.y), fmaxf(bounds.maximum.z, box.maximum.z) };
+	}
+
+	Aabb root = _bvh.GetBounds();
+	return memcmp(&root, &bounds, sizeof(Aabb)) == 0;
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	Scene scene;
+	CreateScene(scene);
+
+	BvhClass* bvh = new BvhClass();
+	TEST_CHECK(bvh->Initialize(PRIMITIVE_COUNT, &jobSystem));
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(bvh->Build(scene.boxes, PRIMITIVE_COUNT));
+	double buildTime = TestClass::GetMilliseconds(start);
+	printf("build: %u primitives into %u nodes in %.1f ms\n", PRIMITIVE_COUNT, bvh->GetNodeCount(), buildTime);
+
+	TEST_CHECK(bvh->GetPrimitiveCount() == PRIMITIVE_COUNT);
+	TEST_CHECK(CheckBounds(*bvh, scene));
+
+	unsigned int* primitives = new unsigned int[PRIMITIVE_COUNT];
+	unsigned char* found = new unsigned char[PRIMITIVE_COUNT];
+
+	double boxTime = 0.0;
+	double frustumTime = 0.0;
+	double bruteForceFrustumTime = 0.0;
+	unsigned int mismatches = CheckQueries(*bvh, scene, primitives, found, boxTime, frustumTime, bruteForceFrustumTime);
+	unsigned int hits = 0;
+	unsigned int rayMismatches = CheckRays(*bvh, scene, hits);
+	printf("queries: %u box and 3 frustum queries with %u mismatches, %u of %u rays hit with %u mismatches\n", CHECKED_BOX_QUERIES, mismatches, hits, CHECKED_RAYS,
+		rayMismatches);
+	TEST_CHECK(mismatches == 0);
+	TEST_CHECK(rayMismatches == 0);
+	TEST_CHECK(hits > 0);
+
+	//	Ray throughput
+	unsigned int random = 1;
+	unsigned int timedHits = 0;
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < TIMED_RAYS; i++)
+	{
+		Vector3 origin;
+		Vector3 direction;
+		GetRay(random, origin, direction);
+
+		BvhRayHit hit;
+		timedHits += bvh->Raycast(origin, direction, 2.0f, hit) ? 1 : 0;
+	}
+	double rayTime = TestClass::GetMilliseconds(start);
+
+	//	Moved primitives only change their boxes, the tree is refit instead of rebuilt
+	float* centerX = scene.components;
+	float* centerZ = centerX + 2 * PRIMITIVE_COUNT;
+	random = 31;
+	for (unsigned int i = 0; i < MOVED_PRIMITIVES; i++)
+	{
+		unsigned int primitive = static_cast<unsigned int>(NextRandom(random, 0.0f, static_cast<float>(PRIMITIVE_COUNT - 1)));
+		centerX[primitive] += NextRandom(random, -20.0f, 20.0f);
+		centerZ[primitive] += NextRandom(random, -20.0f, 20.0f);
+		bvh->UpdatePrimitive(primitive, Vector3{ centerX[primitive], scene.boxes.centerY[primitive], centerZ[primitive] },
+			Vector3{ scene.boxes.extentX[primitive], scene.boxes.extentY[primitive], scene.boxes.extentZ[primitive] });
+	}
+
+	start = TimerClass::GetMicroseconds();
+	bvh->Refit();
+	double refitTime = TestClass::GetMilliseconds(start);
+
+	double refitBoxTime = 0.0;
+	double refitFrustumTime = 0.0;
+	double refitBruteForceTime = 0.0;
+	mismatches = CheckQueries(*bvh, scene, primitives, found, refitBoxTime, refitFrustumTime, refitBruteForceTime);
+	rayMismatches = CheckRays(*bvh, scene, hits);
+	printf("refit: %u moved primitives in %.2f ms, %u mismatches and %u ray mismatches after it\n", MOVED_PRIMITIVES, refitTime, mismatches, rayMismatches);
+	TEST_CHECK(mismatches == 0);
+	TEST_CHECK(rayMismatches == 0);
+	TEST_CHECK(CheckBounds(*bvh, scene));
+
+	printf("rays: %u in %.1f ms, %.2f M rays/s, %u hit\n", TIMED_RAYS, rayTime, TIMED_RAYS / (rayTime * 1000.0), timedHits);
+	printf("box query: %.3f ms, frustum query: %.2f ms against %.2f ms brute force (%.1fx)\n", boxTime / BOX_QUERIES, frustumTime / 3.0,
+		bruteForceFrustumTime / 3.0, bruteForceFrustumTime / frustumTime);
+
+	TEST_CHECK(refitTime < buildTime);
+	TEST_CHECK(frustumTime < bruteForceFrustumTime);
+
+	delete[] found;
+	delete[] primitives;
+	bvh->Shutdown();
+	delete bvh;
+	delete[] scene.components;
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,460 @@
+#include "TestClass.h"
+#include "CommandCaptureClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include <cstdio>
+#include <cstring>
+
+#pragma region Globals
+static const char* const CAPTURE_PATH = "CommandCaptureTest.bin";
+static const char* const BROKEN_CAPTURE_PATH = "CommandCaptureTestBroken.bin";
+static const unsigned int RING_FRAMES = 4;
+static const unsigned int RECORDED_FRAMES = 6;		// more than the ring holds, the first two are overwritten
+static const unsigned int STREAM_COUNT = 2;
+static const unsigned int DRAWS_PER_FRAME = 40;
+static const unsigned int MAX_LOG_VALUES = 8192;
+static const unsigned int MAX_LOG_HANDLES = 64;
+static const unsigned int BENCH_DRAWS = 20000;
+#pragma endregion
+
+static int Resources[8];
+static int OtherResources[8];		// the resources of a second run live at other addresses
+static int Pipelines[4];
+static int OtherPipelines[4];
+
+/*
+	Writes every command it gets into a flat list of values, handles are numbered in the order they first appear like the capture does
+	Barriers are logged one by one, so it does not matter how they were split into batches
+	Two logs are equal exactly when the same commands were recorded
+*/
+class LogRecorder : public CommandRecorderClass
+{
+public:
+	LogRecorder()
+	{
+		m_valueCount = 0;
+		m_handleCount = 0;
+		m_callCount = 0;
+		m_overflowed = false;
+	}
+
+	void ResourceBarriers(const ResourceBarrier* _barriers, unsigned int _barrierCount) override
+	{
+		m_callCount++;
+		for (unsigned int i = 0; i < _barrierCount; i++)
+		{
+			Log(1);
+			LogHandle(_barriers[i].resource);
+			LogHandle(_barriers[i].aliasedResource);
+			Log(_barriers[i].stateBefore);
+			Log(_barriers[i].stateAfter);
+			Log(_barriers[i].aliasing ? 1 : 0);
+		}
+	}
+
+	void SetRenderTarget(const RenderTargetView& _renderTarget, unsigned int _width, unsigned int _height) override
+	{
+		m_callCount++;
+		Log(2);
+		LogHandle(_renderTarget.resource);
+		Log(_width);
+		Log(_height);
+	}
+
+	void ClearRenderTarget(const RenderTargetView& _renderTarget, const float* _color) override
+	{
+		m_callCount++;
+		Log(3);
+		LogHandle(_renderTarget.resource);
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			unsigned int bits;
+			memcpy(&bits, &_color[i], sizeof(bits));
+			Log(bits);
+		}
+	}
+
+	void SetPipeline(void* _pipeline) override
+	{
+		m_callCount++;
+		Log(4);
+		LogHandle(_pipeline);
+	}
+
+	void SetMaterial(unsigned int _material) override
+	{
+		m_callCount++;
+		Log(5);
+		Log(_material);
+	}
+
+	void SetMesh(const DrawMesh& _mesh) override
+	{
+		m_callCount++;
+		Log(6);
+		Log(_mesh.vertexBufferAddress);
+		Log(_mesh.vertexBufferSize);
+		Log(_mesh.vertexStride);
+		Log(_mesh.indexBufferAddress);
+		Log(_mesh.indexBufferSize);
+		Log(_mesh.indices32Bit ? 1 : 0);
+		Log(_mesh.indexCount);
+		Log(_mesh.firstIndex);
+		Log(static_cast<unsigned int>(_mesh.baseVertex));
+	}
+
+	void DrawIndexedInstanced(unsigned int _indexCount, unsigned int _instanceCount, unsigned int _firstIndex, int _baseVertex, unsigned int _firstInstance) override
+	{
+		m_callCount++;
+		Log(7);
+		Log(_indexCount);
+		Log(_instanceCount);
+		Log(_firstIndex);
+		Log(static_cast<unsigned int>(_baseVertex));
+		Log(_firstInstance);
+	}
+
+	void WriteTimestamp(unsigned int _queryIndex) override
+	{
+		m_callCount++;
+		Log(8);
+		Log(_queryIndex);
+	}
+
+	void ResolveTimestamps(unsigned int _firstQuery, unsigned int _queryCount) override
+	{
+		m_callCount++;
+		Log(9);
+		Log(_firstQuery);
+		Log(_queryCount);
+	}
+
+	bool Equals(const LogRecorder& _other) const
+	{
+		return !m_overflowed && !_other.m_overflowed && m_valueCount == _other.m_valueCount &&
+			memcmp(m_values, _other.m_values, m_valueCount * sizeof(unsigned long long)) == 0;
+	}
+
+	unsigned int GetCallCount() const
+	{
+		return m_callCount;
+	}
+
+private:
+	unsigned long long m_values[MAX_LOG_VALUES];
+	unsigned int m_valueCount;
+	const void* m_handles[MAX_LOG_HANDLES];
+	unsigned int m_handleCount;
+	unsigned int m_callCount;
+	bool m_overflowed;
+
+	void Log(unsigned long long _value)
+	{
+		if (m_valueCount == MAX_LOG_VALUES)
+		{
+			m_overflowed = true;
+			return;
+		}
+
+		m_values[m_valueCount++] = _value;
+	}
+
+	void LogHandle(const void* _handle)
+	{
+		if (!_handle)
+		{
+			Log(0);
+			return;
+		}
+
+		for (unsigned int i = 0; i < m_handleCount; i++)
+		{
+			if (m_handles[i] == _handle)
+			{
+				Log(i + 1);
+				return;
+			}
+		}
+
+		if (m_handleCount == MAX_LOG_HANDLES)
+		{
+			m_overflowed = true;
+			return;
+		}
+
+		m_handles[m_handleCount++] = _handle;
+		Log(m_handleCount);
+	}
+};
+
+/*
+	A frame of a small renderer: stream 0 transitions and clears the targets, stream 1 draws into them
+	Frame _frame of a run with _resources and _pipelines, _changedDraw (if below DRAWS_PER_FRAME) draws one instance more
+	Returns the amount of commands in the stream, barrier calls of more than COMMAND_CAPTURE_BARRIER_BATCH_SIZE count once per batch
+*/
+static unsigned int RecordFrame(CommandCaptureClass& _capture, CommandRecorderClass* _target, unsigned int _frame, int* _resources, int* _pipelines,
+	unsigned int _changedDraw)
+{
+	unsigned int commands = 0;
+
+	CommandRecorderClass* recorder = _capture.GetRecorder(0, _target);
+	ResourceBarrier barriers[20];
+	for (unsigned int i = 0; i < 20; i++)
+	{
+		barriers[i] = { &_resources[i % 8], nullptr, RESOURCE_STATE_SHADER_RESOURCE, RESOURCE_STATE_RENDER_TARGET, false };
+	}
+
+	//	Aliasing barriers have no states
+	for (unsigned int i = 0; i < 20; i += 5)
+	{
+		barriers[i] = { &_resources[i % 8], &_resources[(i + 1) % 8], RESOURCE_STATE_COMMON, RESOURCE_STATE_COMMON, true };
+	}
+	recorder->ResourceBarriers(barriers, 20);
+	commands += 2;
+
+	RenderTargetView target = { &_resources[_frame % 8], 0x1000 + _frame };
+	float color[4] = { 0.1f * _frame, 0.25f, -0.5f, 1.0f };
+	recorder->WriteTimestamp(0);
+	recorder->SetRenderTarget(target, 1280, 720);
+	recorder->ClearRenderTarget(target, color);
+	commands += 3;
+
+	recorder = _capture.GetRecorder(1, _target);
+	for (unsigned int i = 0; i < DRAWS_PER_FRAME; i++)
+	{
+		if (i % 10 == 0)
+		{
+			recorder->SetPipeline(&_pipelines[(i / 10 + _frame) % 4]);
+			commands++;
+		}
+		if (i % 4 == 0)
+		{
+			recorder->SetMaterial(i * 7 + _frame);
+			DrawMesh mesh = {};
+			mesh.vertexBufferAddress = 0x10000000ULL + i * 4096;
+			mesh.vertexBufferSize = 4096;
+			mesh.vertexStride = 32;
+			mesh.indexBufferAddress = 0x20000000ULL + i * 1024;
+			mesh.indexBufferSize = 1024;
+			mesh.indices32Bit = i % 8 == 0;
+			mesh.indexCount = 36 + i;
+			mesh.firstIndex = i;
+			mesh.baseVertex = -static_cast<int>(i);
+			recorder->SetMesh(mesh);
+			commands += 2;
+		}
+		recorder->DrawIndexedInstanced(36 + i, 1 + i % 3 + (i == _changedDraw ? 1 : 0), i, -static_cast<int>(i), i * 16);
+		commands++;
+	}
+	recorder->WriteTimestamp(1);
+	recorder->ResolveTimestamps(0, 2);
+	commands += 2;
+
+	return commands;
+}
+
+/*
+	The frames which are still in the ring replay exactly the commands which were recorded
+*/
+static void TestRoundTrip(CommandCaptureClass& _capture, LogRecorder* _liveLogs, unsigned int* _commandCounts)
+{
+	TEST_CHECK(_capture.Initialize(RING_FRAMES, STREAM_COUNT, COMMAND_CAPTURE_STREAM_SIZE));
+
+	for (unsigned int i = 0; i < RECORDED_FRAMES; i++)
+	{
+		_capture.BeginFrame();
+		_commandCounts[i] = RecordFrame(_capture, &_liveLogs[i], i, Resources, Pipelines, DRAWS_PER_FRAME);
+		_capture.EndFrame();
+	}
+
+	TEST_CHECK(_capture.GetFrameCount() == RING_FRAMES);
+
+	unsigned int wrong = 0;
+	LogRecorder* replayLog = new LogRecorder();
+	for (unsigned int i = 0; i < RING_FRAMES; i++)
+	{
+		unsigned int recorded = RECORDED_FRAMES - RING_FRAMES + i;
+		*replayLog = LogRecorder();
+		unsigned int commandCount = 0;
+
+		wrong += _capture.GetFrameNumber(i) != recorded || !_capture.IsFrameComplete(i) ? 1 : 0;
+		wrong += !_capture.Replay(i, replayLog, commandCount) || commandCount != _commandCounts[recorded] ? 1 : 0;
+		wrong += replayLog->GetCallCount() != commandCount || !replayLog->Equals(_liveLogs[recorded]) ? 1 : 0;
+	}
+	delete replayLog;
+
+	printf("round trip: %u frames recorded into a ring of %u, %u commands and %zu bytes in the newest frame\n", RECORDED_FRAMES, RING_FRAMES,
+		_commandCounts[RECORDED_FRAMES - 1], _capture.GetFrameSize(RING_FRAMES - 1));
+	TEST_CHECK(wrong == 0);
+}
+
+/*
+	A saved capture loads back with the same frames, truncated or foreign files are rejected
+*/
+static void TestSaveLoad(const CommandCaptureClass& _capture, const LogRecorder* _liveLogs)
+{
+	TEST_CHECK(_capture.Save(CAPTURE_PATH));
+
+	CommandCaptureClass* loaded = new CommandCaptureClass();
+	TEST_CHECK(loaded->Load(CAPTURE_PATH));
+	TEST_CHECK(loaded->GetFrameCount() == RING_FRAMES);
+
+	unsigned int wrong = 0;
+	LogRecorder* replayLog = new LogRecorder();
+	for (unsigned int i = 0; i < RING_FRAMES; i++)
+	{
+		unsigned int difference = 0;
+		unsigned int commandCount = 0;
+		*replayLog = LogRecorder();
+
+		wrong += loaded->GetFrameNumber(i) != _capture.GetFrameNumber(i) || !CommandCaptureClass::CompareFrames(_capture, i, *loaded, i, difference) ? 1 : 0;
+		wrong += !loaded->Replay(i, replayLog, commandCount) || !replayLog->Equals(_liveLogs[RECORDED_FRAMES - RING_FRAMES + i]) ? 1 : 0;
+	}
+	TEST_CHECK(wrong == 0);
+	delete replayLog;
+
+	//	Cut the file in the middle of the last frame, and break the magic
+	FILE* file = fopen(CAPTURE_PATH, "rb");
+	unsigned char* data = new unsigned char[COMMAND_CAPTURE_STREAM_SIZE];
+	size_t size = file ? fread(data, 1, COMMAND_CAPTURE_STREAM_SIZE, file) : 0;
+	if (file)
+	{
+		fclose(file);
+	}
+	TEST_CHECK(size > sizeof(CommandCaptureFileHeader) && size < COMMAND_CAPTURE_STREAM_SIZE);
+
+	file = fopen(BROKEN_CAPTURE_PATH, "wb");
+	if (file)
+	{
+		fwrite(data, 1, size - 16, file);
+		fclose(file);
+	}
+	TEST_CHECK(!loaded->Load(BROKEN_CAPTURE_PATH));
+
+	data[0] ^= 0xFF;
+	file = fopen(BROKEN_CAPTURE_PATH, "wb");
+	if (file)
+	{
+		fwrite(data, 1, size, file);
+		fclose(file);
+	}
+	TEST_CHECK(!loaded->Load(BROKEN_CAPTURE_PATH));
+
+	delete[] data;
+	loaded->Shutdown();
+	delete loaded;
+	remove(BROKEN_CAPTURE_PATH);
+	remove(CAPTURE_PATH);
+}
+
+/*
+	A second run with its resources at other addresses captures the same frames, except for the one draw which changed
+	The comparison points at that draw
+*/
+static void TestCompare(const CommandCaptureClass& _capture)
+{
+	CommandCaptureClass* second = new CommandCaptureClass();
+	TEST_CHECK(second->Initialize(RING_FRAMES, STREAM_COUNT, COMMAND_CAPTURE_STREAM_SIZE));
+
+	const unsigned int changedFrame = RECORDED_FRAMES - 1;
+	const unsigned int changedDraw = 13;
+	for (unsigned int i = 0; i < RECORDED_FRAMES; i++)
+	{
+		second->BeginFrame();
+		RecordFrame(*second, nullptr, i, OtherResources, OtherPipelines, i == changedFrame ? changedDraw : DRAWS_PER_FRAME);
+		second->EndFrame();
+	}
+
+	unsigned int equalFrames = 0;
+	unsigned int difference = 0;
+	for (unsigned int i = 0; i + 1 < RING_FRAMES; i++)
+	{
+		equalFrames += CommandCaptureClass::CompareFrames(_capture, i, *second, i, difference) ? 1 : 0;
+	}
+
+	//	Stream 0 has 5 commands (the 20 barriers are two), stream 1 sets pipeline, material and mesh before the draws
+	unsigned int expectedDifference = 5 + 1 + 2 * (changedDraw / 4 + 1) + changedDraw / 10 + changedDraw;
+	bool equal = CommandCaptureClass::CompareFrames(_capture, RING_FRAMES - 1, *second, RING_FRAMES - 1, difference);
+	printf("compare: %u of %u frames equal, the changed frame differs at command %u\n", equalFrames, RING_FRAMES - 1, difference);
+
+	TEST_CHECK(equalFrames == RING_FRAMES - 1);
+	TEST_CHECK(!equal && difference == expectedDifference);
+
+	second->Shutdown();
+	delete second;
+}
+
+/*
+	A stream which runs full is cut off at the last whole command and its frame is marked incomplete, the commands before still replay
+*/
+static void TestOverflow()
+{
+	CommandCaptureClass* capture = new CommandCaptureClass();
+	TEST_CHECK(capture->Initialize(1, STREAM_COUNT, 256));
+
+	capture->BeginFrame();
+	unsigned int recorded = RecordFrame(*capture, nullptr, 0, Resources, Pipelines, DRAWS_PER_FRAME);
+	capture->EndFrame();
+
+	unsigned int commandCount = 0;
+	SimulatedCommandRecorderClass recorder;
+	TEST_CHECK(!capture->IsFrameComplete(0));
+	TEST_CHECK(capture->Replay(0, &recorder, commandCount));
+	TEST_CHECK(commandCount > 0 && commandCount < recorded);
+
+	capture->Shutdown();
+	delete capture;
+}
+
+/*
+	What capturing costs per command, draws with a state change every few draws
+*/
+static void MeasureCapture()
+{
+	CommandCaptureClass* capture = new CommandCaptureClass();
+	TEST_CHECK(capture->Initialize(2, 1, 1024 * 1024));
+	SimulatedCommandRecorderClass target;
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	capture->BeginFrame();
+	CommandRecorderClass* recorder = capture->GetRecorder(0, &target);
+	unsigned int commands = 0;
+	for (unsigned int i = 0; i < BENCH_DRAWS; i++)
+	{
+		if (i % 8 == 0)
+		{
+			recorder->SetMaterial(i / 8);
+			commands++;
+		}
+		recorder->DrawIndexedInstanced(36, 1, 0, 0, i);
+		commands++;
+	}
+	capture->EndFrame();
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	printf("capture: %u commands in %.2f ms, %.1f ns and %.1f bytes per command\n", commands, milliseconds, milliseconds * 1000000.0 / commands,
+		static_cast<double>(capture->GetFrameSize(0)) / commands);
+	TEST_CHECK(capture->IsFrameComplete(0));
+	TEST_CHECK(target.GetDrawCount() == BENCH_DRAWS);
+
+	capture->Shutdown();
+	delete capture;
+}
+
+int main()
+{
+	CommandCaptureClass* capture = new CommandCaptureClass();
+	LogRecorder* liveLogs = new LogRecorder[RECORDED_FRAMES];
+	unsigned int commandCounts[RECORDED_FRAMES];
+
+	TestRoundTrip(*capture, liveLogs, commandCounts);
+	TestSaveLoad(*capture, liveLogs);
+	TestCompare(*capture);
+	TestOverflow();
+	MeasureCapture();
+
+	delete[] liveLogs;
+	capture->Shutdown();
+	delete capture;
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,206 @@
+#include "TestClass.h"
+#include "CullingClass.h"
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int OBJECT_COUNT = 1000000;
+static const float WORLD_SIZE = 4000.0f;
+static const float BORDER_TOLERANCE = 1e-3f;		// boxes closer to a plane may go either way, the SIMD code rounds differently
+static const unsigned int MOVED_OBJECTS = 10000;
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run builds the same scene
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+struct Scene
+{
+	float* components;
+	BoundingBoxArrays boxes;
+};
+
+/*
+	Boxes of 0.5 - 5 units scattered over a flat world with a little height, like the props of an open world level
+*/
+static void CreateScene(Scene& _scene)
+{
+	_scene.components = new float[OBJECT_COUNT * 6];
+	float* centerX = _scene.components;
+	float* centerY = centerX + OBJECT_COUNT;
+	float* centerZ = centerY + OBJECT_COUNT;
+	float* extentX = centerZ + OBJECT_COUNT;
+	float* extentY = extentX + OBJECT_COUNT;
+	float* extentZ = extentY + OBJECT_COUNT;
+
+	unsigned int random = 777;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		centerX[i] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		centerY[i] = NextRandom(random, 0.0f, 50.0f);
+		centerZ[i] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		extentX[i] = NextRandom(random, 0.5f, 5.0f);
+		extentY[i] = NextRandom(random, 0.5f, 5.0f);
+		extentZ[i] = NextRandom(random, 0.5f, 5.0f);
+	}
+
+	_scene.boxes = { centerX, centerY, centerZ, extentX, extentY, extentZ };
+}
+
+/*
+	Lowest distance of the box to one of the planes, negative if it is outside
+*/
+static float GetBoxDistance(const Frustum& _frustum, const Scene& _scene, unsigned int _object)
+{
+	const BoundingBoxArrays& boxes = _scene.boxes;
+	float lowest = FLT_MAX;
+	for (int i = 0; i < 6; i++)
+	{
+		const Vector4& plane = _frustum.planes[i];
+		float distance = plane.x * boxes.centerX[_object] + plane.y * boxes.centerY[_object] + plane.z * boxes.centerZ[_object] + plane.w;
+		float radius = fabsf(plane.x) * boxes.extentX[_object] + fabsf(plane.y) * boxes.extentY[_object] + fabsf(plane.z) * boxes.extentZ[_object];
+		lowest = fminf(lowest, distance + radius);
+	}
+
+	return lowest;
+}
+
+/*
+	Every box against every plane, the reference the grid has to match
+*/
+static unsigned int CullBruteForce(const Frustum& _frustum, const Scene& _scene, unsigned char* _visible)
+{
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		_visible[i] = GetBoxDistance(_frustum, _scene, i) >= 0.0f ? 1 : 0;
+		count += _visible[i];
+	}
+
+	return count;
+}
+
+/*
+	The objects the grid found against the brute force result, every object may be in the list only once
+	Objects on the border of the frustum within BORDER_TOLERANCE are not counted as wrong
+*/
+static unsigned int CountMismatches(const CullingClass& _culling, const Frustum& _frustum, const Scene& _scene, const unsigned char* _expected, unsigned char* _found)
+{
+	memset(_found, 0, OBJECT_COUNT);
+	unsigned int mismatches = 0;
+	for (unsigned int i = 0; i < _culling.GetVisibleCount(); i++)
+	{
+		unsigned int object = _culling.GetVisibleObjects()[i];
+		if (object >= OBJECT_COUNT || _found[object])
+		{
+			mismatches++;
+			continue;
+		}
+		_found[object] = 1;
+	}
+
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		if (_found[i] != _expected[i] && fabsf(GetBoxDistance(_frustum, _scene, i)) > BORDER_TOLERANCE)
+		{
+			mismatches++;
+		}
+	}
+
+	return mismatches;
+}
+
+static Frustum GetFrustum(const Vector3& _eye, const Vector3& _target, float _farPlane)
+{
+	Matrix4 view = MathClass::LookAt(_eye, _target, Vector3{ 0.0f, 1.0f, 0.0f });
+	Matrix4 projection = MathClass::Perspective(1.0f, 16.0f / 9.0f, 0.1f, _farPlane);
+
+	return MathClass::FrustumFromMatrix(MathClass::Multiply(view, projection));
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	Scene scene;
+	CreateScene(scene);
+
+	CullingClass* culling = new CullingClass();
+	TEST_CHECK(culling->Initialize(OBJECT_COUNT, &jobSystem));
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(culling->Build(scene.boxes, OBJECT_COUNT));
+	printf("build: %u objects into %u cells in %.1f ms\n", OBJECT_COUNT, culling->GetCellCount(), TestClass::GetMilliseconds(start));
+
+	unsigned char* expected = new unsigned char[OBJECT_COUNT];
+	unsigned char* found = new unsigned char[OBJECT_COUNT];
+
+	//	From the ground into the world, from the corner over all of it, from high above looking down, and from outside looking away
+	const char* names[4] = { "ground", "corner", "above", "away" };
+	Frustum frustums[4] = {
+		GetFrustum(Vector3{ 0.0f, 2.0f, 0.0f }, Vector3{ 100.0f, 2.0f, 100.0f }, 1000.0f),
+		GetFrustum(Vector3{ -WORLD_SIZE * 0.5f, 100.0f, -WORLD_SIZE * 0.5f }, Vector3{ 0.0f, 0.0f, 0.0f }, WORLD_SIZE * 2.0f),
+		GetFrustum(Vector3{ 0.0f, 500.0f, 0.0f }, Vector3{ 1.0f, 0.0f, 0.0f }, 1000.0f),
+		GetFrustum(Vector3{ WORLD_SIZE, 10.0f, 0.0f }, Vector3{ WORLD_SIZE * 2.0f, 10.0f, 0.0f }, 1000.0f)
+	};
+
+	double gridTotal = 0.0;
+	double bruteForceTotal = 0.0;
+	for (unsigned int i = 0; i < 4; i++)
+	{
+		start = TimerClass::GetMicroseconds();
+		unsigned int visible = culling->Cull(frustums[i]);
+		double gridTime = TestClass::GetMilliseconds(start);
+
+		start = TimerClass::GetMicroseconds();
+		unsigned int expectedCount = CullBruteForce(frustums[i], scene, expected);
+		double bruteForceTime = TestClass::GetMilliseconds(start);
+
+		unsigned int mismatches = CountMismatches(*culling, frustums[i], scene, expected, found);
+		printf("%s: %u visible (brute force %u), %u cells inside, %u intersecting, grid %.2f ms, brute force %.2f ms, %u mismatches\n", names[i], visible,
+			expectedCount, culling->GetInsideCellCount(), culling->GetIntersectingCellCount(), gridTime, bruteForceTime, mismatches);
+
+		TEST_CHECK(mismatches == 0);
+		gridTotal += gridTime;
+		bruteForceTotal += bruteForceTime;
+	}
+
+	//	Nothing of the world is behind the last camera
+	TEST_CHECK(culling->GetVisibleCount() == 0);
+
+	//	Moved objects are found at their new place without a rebuild
+	unsigned int random = 31;
+	float* centerX = scene.components;
+	for (unsigned int i = 0; i < MOVED_OBJECTS; i++)
+	{
+		unsigned int object = static_cast<unsigned int>(NextRandom(random, 0.0f, static_cast<float>(OBJECT_COUNT - 1)));
+		centerX[object] = -centerX[object];
+		culling->UpdateObject(object, Vector3{ centerX[object], scene.boxes.centerY[object], scene.boxes.centerZ[object] },
+			Vector3{ scene.boxes.extentX[object], scene.boxes.extentY[object], scene.boxes.extentZ[object] });
+	}
+	culling->Cull(frustums[0]);
+	CullBruteForce(frustums[0], scene, expected);
+	unsigned int mismatches = CountMismatches(*culling, frustums[0], scene, expected, found);
+	printf("after moving %u objects: %u visible, %u mismatches\n", MOVED_OBJECTS, culling->GetVisibleCount(), mismatches);
+	TEST_CHECK(mismatches == 0);
+
+	printf("grid / brute force: %.2fx\n", bruteForceTotal / gridTotal);
+	TEST_CHECK(gridTotal < bruteForceTotal);
+
+	delete[] found;
+	delete[] expected;
+	culling->Shutdown();
+	delete culling;
+	delete[] scene.components;
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "TestClass.h"
+#include "DescriptorAllocatorClass.h"
+#include "SimulatedFenceClass.h"
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int PERSISTENT_DESCRIPTORS = 4096;
+static const unsigned int TRANSIENT_DESCRIPTORS = 1024;
+static const unsigned int MAX_LIVE_ALLOCATIONS = 1024;
+static const unsigned int MAX_ALLOCATION_SIZE = 8;
+static const unsigned int CHURN_STEPS = 200000;
+static const unsigned int TRANSIENT_FRAMES = 64;
+static const unsigned int TRANSIENT_DESCRIPTORS_PER_FRAME = 300;
+#pragma endregion
+
+struct Allocation
+{
+	unsigned int index;
+	unsigned int count;
+};
+
+/*
+	Small deterministic generator, so every run churns the same way
+*/
+static unsigned int NextRandom(unsigned int& _state)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _state >> 8;
+}
+
+/*
+	Allocate and free ranges of 1 - MAX_ALLOCATION_SIZE descriptors in random order, like materials and textures streaming in and out
+	No descriptor may be handed out twice, the free ranges have to merge back into one once everything is freed
+	Fragmentation: how much of the free space is not part of the largest free range
+*/
+static void TestPersistentChurn()
+{
+	DescriptorAllocatorClass allocator;
+	TEST_CHECK(allocator.Initialize(PERSISTENT_DESCRIPTORS, 0, nullptr));
+
+	Allocation* allocations = new Allocation[MAX_LIVE_ALLOCATIONS];
+	unsigned char* owned = new unsigned char[PERSISTENT_DESCRIPTORS];
+	memset(owned, 0, PERSISTENT_DESCRIPTORS);
+	unsigned int liveCount = 0;
+	unsigned int failedAllocations = 0;
+	unsigned int doubleAllocations = 0;
+	unsigned int mostFreeRanges = 0;
+	double worstFragmentation = 0.0;
+	unsigned int random = 12345;
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+
+	for (unsigned int step = 0; step < CHURN_STEPS; step++)
+	{
+		//	Frees become more likely the more is allocated, the heap settles around half of MAX_LIVE_ALLOCATIONS allocations
+		bool allocate = liveCount == 0 || NextRandom(random) % MAX_LIVE_ALLOCATIONS >= liveCount;
+		if (allocate)
+		{
+			unsigned int count = 1 + NextRandom(random) % MAX_ALLOCATION_SIZE;
+			unsigned int index = allocator.Allocate(count);
+			if (index == INVALID_DESCRIPTOR)
+			{
+				failedAllocations++;
+				continue;
+			}
+
+			for (unsigned int i = index; i < index + count; i++)
+			{
+				doubleAllocations += owned[i];
+				owned[i] = 1;
+			}
+
+			allocations[liveCount].index = index;
+			allocations[liveCount].count = count;
+			liveCount++;
+		}
+		else
+		{
+			unsigned int slot = NextRandom(random) % liveCount;
+			Allocation allocation = allocations[slot];
+			allocations[slot] = allocations[--liveCount];
+
+			memset(owned + allocation.index, 0, allocation.count);
+			allocator.Free(allocation.index, allocation.count);
+		}
+
+		mostFreeRanges = allocator.GetFreeRangeCount() > mostFreeRanges ? allocator.GetFreeRangeCount() : mostFreeRanges;
+		if (allocator.GetFreeCount() > 0)
+		{
+			double fragmentation = 1.0 - static_cast<double>(allocator.GetLargestFreeRange()) / allocator.GetFreeCount();
+			worstFragmentation = fragmentation > worstFragmentation ? fragmentation : worstFragmentation;
+		}
+	}
+
+	double milliseconds = TestClass::GetMilliseconds(start);
+	double fragmentation = 1.0 - static_cast<double>(allocator.GetLargestFreeRange()) / allocator.GetFreeCount();
+
+	printf("persistent churn: %u steps in %.1f ms (%.0f ns per step), %u live allocations, %u free ranges (at most %u), fragmentation %.1f%% (worst %.1f%%)\n",
+		CHURN_STEPS, milliseconds, milliseconds * 1000000.0 / CHURN_STEPS, liveCount, allocator.GetFreeRangeCount(), mostFreeRanges,
+		fragmentation * 100.0, worstFragmentation * 100.0);
+
+	TEST_CHECK(doubleAllocations == 0);
+	TEST_CHECK(failedAllocations == 0);
+
+	while (liveCount > 0)
+	{
+		liveCount--;
+		allocator.Free(allocations[liveCount].index, allocations[liveCount].count);
+	}
+
+	TEST_CHECK(allocator.GetFreeCount() == PERSISTENT_DESCRIPTORS);
+	TEST_CHECK(allocator.GetFreeRangeCount() == 1);
+	TEST_CHECK(allocator.GetLargestFreeRange() == PERSISTENT_DESCRIPTORS);
+
+	delete[] owned;
+	delete[] allocations;
+	allocator.Shutdown();
+}
+
+/*
+	Every frame takes TRANSIENT_DESCRIPTORS_PER_FRAME descriptors from the ring, the simulated GPU finishes a frame 1 ms after it was submitted
+	The ring holds about three frames, so the CPU has to wait for the GPU now and then but never gets a descriptor which is still in use
+*/
+static void TestTransientRing()
+{
+	SimulatedFenceClass fence;
+	fence.SetLatency(1.0);
+
+	DescriptorAllocatorClass allocator;
+	TEST_CHECK(allocator.Initialize(16, TRANSIENT_DESCRIPTORS, &fence));
+
+	unsigned int outOfRange = 0;
+	unsigned int failed = 0;
+	for (unsigned int frame = 1; frame <= TRANSIENT_FRAMES; frame++)
+	{
+		for (unsigned int i = 0; i < TRANSIENT_DESCRIPTORS_PER_FRAME / 4; i++)
+		{
+			unsigned int index = allocator.AllocateTransient(4);
+			failed += index == INVALID_DESCRIPTOR ? 1 : 0;
+			outOfRange += index != INVALID_DESCRIPTOR && (index < 16 || index + 4 > 16 + TRANSIENT_DESCRIPTORS) ? 1 : 0;
+		}
+
+		TEST_CHECK(allocator.GetTransientUsed() <= TRANSIENT_DESCRIPTORS);
+		allocator.EndFrame(frame);
+		TEST_CHECK(fence.Signal(frame));
+	}
+
+	printf("transient ring: %u frames of %u descriptors, %llu waits for the GPU\n", TRANSIENT_FRAMES, TRANSIENT_DESCRIPTORS_PER_FRAME, allocator.GetTransientWaitCount());
+
+	TEST_CHECK(failed == 0);
+	TEST_CHECK(outOfRange == 0);
+	TEST_CHECK(allocator.GetTransientWaitCount() > 0);
+
+	//	Once the GPU is idle the whole ring is free again, any request up to half of it fits wherever the ring stands
+	TEST_CHECK(fence.WaitForValue(TRANSIENT_FRAMES));
+	TEST_CHECK(allocator.AllocateTransient(TRANSIENT_DESCRIPTORS / 2) != INVALID_DESCRIPTOR);
+
+	allocator.Shutdown();
+}
+
+int main()
+{
+	TestPersistentChurn();
+	TestTransientRing();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "TestClass.h"
+#include "DrawBatcherClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include "SimulatedPipelineCompilerClass.h"
+#include <algorithm>
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int PACKET_COUNT = 200000;
+static const unsigned int PIPELINE_COUNT = 32;
+static const unsigned int MATERIAL_COUNT = 256;
+static const unsigned int MESH_COUNT = 64;
+static const unsigned int TRANSLUCENT_SHARE = 10;		// every tenth draw is translucent
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run submits the same draws
+*/
+static unsigned int NextRandom(unsigned int& _state)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _state >> 8;
+}
+
+static PipelineDesc GetPipelineDesc(unsigned int _index)
+{
+	PipelineDesc desc;
+	strncpy(desc.vertexShader, "Shaders/Mesh.hlsl", MAX_SHADER_PATH - 1);
+	strncpy(desc.vertexEntryPoint, "VertexMain", MAX_SHADER_ENTRY_POINT - 1);
+	strncpy(desc.pixelShader, "Shaders/Mesh.hlsl", MAX_SHADER_PATH - 1);
+	strncpy(desc.pixelEntryPoint, "PixelMain", MAX_SHADER_ENTRY_POINT - 1);
+	desc.topology = PIPELINE_TOPOLOGY_TRIANGLE;
+	desc.renderTargetCount = 1;
+	desc.renderTargetFormats[0] = 28 + _index % 4;
+	desc.cullMode = (_index / 4) % 3;
+	desc.blendMode = (_index / 12) % 2;
+	desc.depthMode = (_index / 24) % 2;
+
+	return desc;
+}
+
+struct Draw
+{
+	unsigned int pass;
+	unsigned int pipeline;
+	unsigned int material;
+	unsigned int mesh;
+	float depth;
+};
+
+/*
+	The sort key keeps the upper 16 bits of the depth, draws closer than that may come in any order
+*/
+static unsigned int QuantizeDepth(float _depth)
+{
+	unsigned int bits;
+	memcpy(&bits, &_depth, sizeof(bits));
+
+	return bits >> 16;
+}
+
+/*
+	State changes of recording the draws the way they were submitted, one draw each
+*/
+static unsigned int CountUnsortedStateChanges(const Draw* _draws)
+{
+	unsigned int changes = 3;
+	for (unsigned int i = 1; i < PACKET_COUNT; i++)
+	{
+		changes += _draws[i].pipeline != _draws[i - 1].pipeline ? 1 : 0;
+		changes += _draws[i].material != _draws[i - 1].material ? 1 : 0;
+		changes += _draws[i].mesh != _draws[i - 1].mesh ? 1 : 0;
+	}
+
+	return changes;
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	SimulatedPipelineCompilerClass compiler;
+	compiler.SetCompileTime(0.0);
+	PipelineCacheClass* pipelineCache = new PipelineCacheClass();
+	TEST_CHECK(pipelineCache->Initialize(&compiler, &jobSystem, nullptr));
+	unsigned int pipelines[PIPELINE_COUNT];
+	for (unsigned int i = 0; i < PIPELINE_COUNT; i++)
+	{
+		pipelines[i] = pipelineCache->Request(GetPipelineDesc(i));
+	}
+	pipelineCache->WaitForAll();
+
+	DrawBatcherClass* batcher = new DrawBatcherClass();
+	TEST_CHECK(batcher->Initialize(PACKET_COUNT, &jobSystem));
+	for (unsigned int i = 0; i < MESH_COUNT; i++)
+	{
+		DrawMesh mesh = {};
+		mesh.indexCount = 36 * (i + 1);
+		TEST_CHECK(batcher->AddMesh(mesh) == i);
+	}
+
+	//	Objects are submitted in scene order, which has nothing to do with their state
+	Draw* draws = new Draw[PACKET_COUNT];
+	DrawPacket* reference = new DrawPacket[PACKET_COUNT];
+	unsigned int random = 42;
+	for (unsigned int i = 0; i < PACKET_COUNT; i++)
+	{
+		Draw& draw = draws[i];
+		draw.pass = NextRandom(random) % TRANSLUCENT_SHARE == 0 ? DRAW_PASS_TRANSLUCENT : DRAW_PASS_OPAQUE;
+		draw.pipeline = pipelines[NextRandom(random) % PIPELINE_COUNT];
+		draw.material = NextRandom(random) % MATERIAL_COUNT;
+		draw.mesh = NextRandom(random) % MESH_COUNT;
+		draw.depth = static_cast<float>(NextRandom(random) % 100000) * 0.01f;
+
+		TEST_CHECK(batcher->Submit(draw.pass, draw.pipeline, draw.material, draw.mesh, draw.depth, i));
+		reference[i].key = DrawBatcherClass::MakeSortKey(draw.pass, draw.pipeline, draw.material, draw.mesh, draw.depth);
+		reference[i].instance = i;
+	}
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	batcher->Prepare();
+	double prepareTime = TestClass::GetMilliseconds(start);
+
+	//	The radix sort is stable, it has to give exactly what a stable comparison sort gives
+	start = TimerClass::GetMicroseconds();
+	std::stable_sort(reference, reference + PACKET_COUNT, [](const DrawPacket& _a, const DrawPacket& _b) { return _a.key < _b.key; });
+	double stableSortTime = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(batcher->GetPacketCount() == PACKET_COUNT);
+	unsigned int misplaced = 0;
+	for (unsigned int i = 0; i < PACKET_COUNT; i++)
+	{
+		misplaced += batcher->GetPackets()[i].key != reference[i].key || batcher->GetPackets()[i].instance != reference[i].instance ? 1 : 0;
+	}
+	TEST_CHECK(misplaced == 0);
+
+	//	The batches cover the sorted packets without gaps, every batch has one state, translucent draws go back to front
+	unsigned int nextInstance = 0;
+	unsigned int wrongBatches = 0;
+	unsigned int translucentDepth = 0xFFFFFFFF;
+	unsigned int translucentOrder = 0;
+	for (unsigned int i = 0; i < batcher->GetBatchCount(); i++)
+	{
+		const DrawBatch& batch = batcher->GetBatches()[i];
+		wrongBatches += batch.firstInstance != nextInstance || batch.instanceCount == 0 ? 1 : 0;
+		for (unsigned int j = 0; j < batch.instanceCount; j++)
+		{
+			const Draw& draw = draws[batcher->GetInstances()[batch.firstInstance + j]];
+			wrongBatches += draw.pass != batch.pass || draw.pipeline != batch.pipeline || draw.material != batch.material || draw.mesh != batch.mesh ? 1 : 0;
+			if (draw.pass == DRAW_PASS_TRANSLUCENT)
+			{
+				translucentOrder += QuantizeDepth(draw.depth) > translucentDepth ? 1 : 0;
+				translucentDepth = QuantizeDepth(draw.depth);
+			}
+		}
+		nextInstance += batch.instanceCount;
+	}
+	TEST_CHECK(nextInstance == PACKET_COUNT);
+	TEST_CHECK(wrongBatches == 0);
+	TEST_CHECK(translucentOrder == 0);
+
+	//	The recorder sees one draw per batch and exactly the state changes the batcher counted
+	SimulatedCommandRecorderClass recorder;
+	batcher->Record(&recorder, *pipelineCache);
+	unsigned int unsortedChanges = CountUnsortedStateChanges(draws);
+
+	printf("sort: %u packets, radix sort over %u digits %.2f ms, std::stable_sort %.2f ms\n", PACKET_COUNT, batcher->GetSortedDigitCount(), prepareTime,
+		stableSortTime);
+	printf("record: %u draws in %u batches, %u state changes sorted, %u in submission order (%.1fx fewer)\n", PACKET_COUNT, batcher->GetBatchCount(),
+		batcher->GetStateChangeCount(), unsortedChanges, static_cast<double>(unsortedChanges) / batcher->GetStateChangeCount());
+
+	TEST_CHECK(recorder.GetDrawCount() == batcher->GetBatchCount());
+	TEST_CHECK(recorder.GetInstanceCount() == PACKET_COUNT);
+	TEST_CHECK(recorder.GetStateChangeCount() == batcher->GetStateChangeCount());
+	TEST_CHECK(batcher->GetStateChangeCount() * 2 < unsortedChanges);
+
+	//	Reset starts an empty frame
+	batcher->Reset();
+	batcher->Prepare();
+	TEST_CHECK(batcher->GetPacketCount() == 0 && batcher->GetBatchCount() == 0);
+
+	delete[] reference;
+	delete[] draws;
+	batcher->Shutdown();
+	delete batcher;
+	pipelineCache->Shutdown();
+	delete pipelineCache;
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
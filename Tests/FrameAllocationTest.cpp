@@ -0,0 +1,207 @@
+#include "TestClass.h"
+#include "Systemclass.h"
+#include "MemoryTrackerClass.h"
+#include <thread>
+
+#pragma region Globals
+static const unsigned int FRAME_COUNT = 60;
+static const unsigned int TARGET_FRAME_RATE = 240;		// fast enough to be quick, slow enough that the simulation steps every few frames
+static const unsigned int ENTITY_COUNT = 20000;
+static const unsigned int EXTRACT_DRAWS = 256;
+static const unsigned int HELPED_FRAME_JOBS = 64;
+#pragma endregion
+
+struct Position
+{
+	float x;
+	float y;
+	float z;
+};
+
+static int* volatile AllocationSink = nullptr;		// keeps the compiler from leaving out the allocations of the jobs
+
+struct TestState
+{
+	unsigned int position;
+	unsigned long long extracts;
+};
+
+static void MoveSystem(const EntityChunk& _chunk, double _timestep, void* _data)
+{
+	Position* positions = _chunk.GetComponents<Position>(static_cast<TestState*>(_data)->position);
+	for (unsigned int i = 0; i < _chunk.count; i++)
+	{
+		positions[i].z += static_cast<float>(_timestep);
+	}
+}
+
+/*
+	Builds its draw list in frame memory before it goes into the snapshot, like a real extract sorting or filtering its draws would
+*/
+static void Extract(const WorldClass& _world, RenderSnapshotClass& _snapshot, FrameAllocatorClass& _frameAllocator, void* _data)
+{
+	TestState* state = static_cast<TestState*>(_data);
+	state->extracts++;
+
+	SnapshotDraw* draws = _frameAllocator.AllocateArray<SnapshotDraw>(EXTRACT_DRAWS);
+	if (!draws)
+	{
+		return;
+	}
+
+	for (unsigned int i = 0; i < EXTRACT_DRAWS; i++)
+	{
+		draws[i].center = { static_cast<float>(i), 0.0f, 0.0f };
+		draws[i].radius = 1.0f;
+	}
+
+	for (unsigned int i = 0; i < EXTRACT_DRAWS; i++)
+	{
+		_snapshot.SubmitDraw(DRAW_PASS_OPAQUE, 0, 0, 0, draws[i].center, draws[i].radius, i);
+	}
+}
+
+/*
+	A headless engine with a world system and a render extract runs FRAME_COUNT frames
+	No frame may allocate from the heap, the scratch memory of the frames (job records of the world, the draw list of the extract) has to come from the frameallocator
+*/
+static void TestFrames(unsigned int _pipelineDepth)
+{
+	SystemSettings settings;
+	settings.headless = true;
+	settings.frameLimit = FRAME_COUNT;
+	settings.targetFrameRate = TARGET_FRAME_RATE;
+	settings.tracePath = nullptr;
+	settings.softwareRenderer = false;
+	settings.screenshotPath = nullptr;
+	settings.assetPackagePath = nullptr;
+	settings.capturePath = nullptr;
+	settings.replayPath = nullptr;
+	settings.comparePath = nullptr;
+	settings.present.mode = PRESENT_MODE;
+	settings.present.bufferCount = SWAP_CHAIN_BUFFERS;
+	settings.present.maxFrameLatency = MAX_FRAME_LATENCY;
+	settings.present.simulatedRefreshRate = 0.0;
+	settings.scenePath = nullptr;
+	settings.renderPipelineDepth = _pipelineDepth;
+	settings.maxSceneObjects = 1024;
+
+	SystemClass* system = new SystemClass;
+	if (!TEST_CHECK(system->Initialize(settings)))
+	{
+		delete system;
+		return;
+	}
+
+	TestState state;
+	WorldClass* world = system->GetWorld();
+	state.position = world->RegisterComponent<Position>("Position");
+	state.extracts = 0;
+
+	Entity firstEntity = INVALID_ENTITY;
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		Entity entity = world->CreateEntity(1ULL << state.position);
+		world->GetComponent<Position>(entity, state.position)->z = 0.0f;
+		firstEntity = i == 0 ? entity : firstEntity;
+	}
+
+	EntityQuery query = { 1ULL << state.position, 0 };
+	world->AddSystem("Move", query, 1ULL << state.position, MoveSystem, &state);
+	system->SetRenderExtract(Extract, &state);
+
+	system->Run();
+
+	printf("pipeline depth %u: %llu frames, %llu heap allocations inside frames, frame memory peak %zu bytes\n", _pipelineDepth,
+		system->GetFrameCount(), system->GetFrameHeapAllocations(), system->GetFrameMemoryPeak());
+
+	TEST_CHECK(system->GetFrameCount() == FRAME_COUNT);
+	TEST_CHECK(state.extracts == FRAME_COUNT);
+	TEST_CHECK(world->GetComponent<Position>(firstEntity, state.position)->z > 0.0f);
+	TEST_CHECK(system->GetFrameHeapAllocations() == 0);
+	TEST_CHECK(system->GetFrameMemoryPeak() >= EXTRACT_DRAWS * sizeof(SnapshotDraw));
+
+	system->Shutdown();
+	delete system;
+}
+
+struct LoadingState
+{
+	JobSystemClass* jobSystem;
+	std::atomic<unsigned int> markedFrameJobs;
+	bool markedAfterWait;
+};
+
+/*
+	Frame work with one heap allocation per job
+*/
+static void AllocatingFrameJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	LoadingState* state = static_cast<LoadingState*>(_data);
+	state->markedFrameJobs.fetch_add(JobSystemClass::IsRunningBackgroundJob() ? 1 : 0);
+
+	AllocationSink = new int(static_cast<int>(_begin));
+	delete AllocationSink;
+}
+
+/*
+	A background job which allocates once and then waits for frame jobs, it works on them itself while it waits
+*/
+static void LoadingJob(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	LoadingState* state = static_cast<LoadingState*>(_data);
+
+	AllocationSink = new int(0);
+	delete AllocationSink;
+
+	JobCounter counter(0);
+	state->jobSystem->ParallelFor(AllocatingFrameJob, state, HELPED_FRAME_JOBS, 1, &counter);
+	state->jobSystem->WaitForCounter(&counter);
+	state->markedAfterWait = JobSystemClass::IsRunningBackgroundJob();
+}
+
+/*
+	Only the allocations of the background job itself are left out of the foreground count, not the frame jobs it runs while it waits
+	The calling thread does not help, so the worker runs every frame job inside the background job
+*/
+static void TestBackgroundJobs()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(1));
+
+	LoadingState state;
+	state.jobSystem = &jobSystem;
+	state.markedFrameJobs.store(0);
+	state.markedAfterWait = false;
+
+	unsigned long long allocations = MemoryTrackerClass::GetAllocationCount();
+	unsigned long long foregroundAllocations = MemoryTrackerClass::GetForegroundAllocationCount();
+
+	JobCounter counter(0);
+	TEST_CHECK(jobSystem.RunBackground(LoadingJob, &state, 0, 1, &counter));
+	while (counter.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+
+	allocations = MemoryTrackerClass::GetAllocationCount() - allocations;
+	foregroundAllocations = MemoryTrackerClass::GetForegroundAllocationCount() - foregroundAllocations;
+	printf("background job helping with %u frame jobs: %llu allocations, %llu of them counted as frame work\n", HELPED_FRAME_JOBS, allocations,
+		foregroundAllocations);
+
+	TEST_CHECK(allocations == HELPED_FRAME_JOBS + 1);
+	TEST_CHECK(foregroundAllocations == HELPED_FRAME_JOBS);
+	TEST_CHECK(state.markedFrameJobs.load() == 0);
+	TEST_CHECK(state.markedAfterWait);
+
+	jobSystem.Shutdown();
+}
+
+int main()
+{
+	TestBackgroundJobs();
+	TestFrames(0);
+	TestFrames(2);
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
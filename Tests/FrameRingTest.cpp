@@ -0,0 +1,73 @@
+#include "TestClass.h"
+#include "FrameRingClass.h"
+#include "SimulatedFenceClass.h"
+
+#pragma region Globals
+static const unsigned int FRAME_COUNT = 40;
+static const double GPU_FRAME_TIME = 2.0;		// milliseconds the simulated GPU works on every frame, the CPU submits much faster
+#pragma endregion
+
+/*
+	The CPU submits frames faster than the simulated GPU finishes them
+	It may never be more than _framesInFlight frames ahead, BeginFrame has to wait for the oldest frame instead
+	Since the GPU is the bottleneck the whole run takes about FRAME_COUNT GPU frames, no matter how many frames are in flight
+*/
+static void TestRunAhead(unsigned int _framesInFlight)
+{
+	SimulatedFenceClass fence;
+	fence.SetLatency(GPU_FRAME_TIME);
+
+	FrameRingClass frameRing;
+	TEST_CHECK(frameRing.Initialize(&fence, _framesInFlight));
+
+	unsigned long long mostAheadAtBegin = 0;
+	unsigned long long mostAheadAtEnd = 0;
+	unsigned long long start = TimerClass::GetMicroseconds();
+
+	for (unsigned int i = 0; i < FRAME_COUNT; i++)
+	{
+		TEST_CHECK(frameRing.BeginFrame());
+		TEST_CHECK(frameRing.GetFrameIndex() == i % _framesInFlight);
+
+		unsigned long long ahead = frameRing.GetFramesAhead();
+		mostAheadAtBegin = ahead > mostAheadAtBegin ? ahead : mostAheadAtBegin;
+
+		TEST_CHECK(frameRing.EndFrame());
+
+		ahead = frameRing.GetFramesAhead();
+		mostAheadAtEnd = ahead > mostAheadAtEnd ? ahead : mostAheadAtEnd;
+	}
+
+	TEST_CHECK(frameRing.WaitForIdle());
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	printf("%u frames in flight: at most %llu frames ahead, %llu waits, %.1f ms for %u frames\n", _framesInFlight, mostAheadAtEnd,
+		frameRing.GetWaitCount(), milliseconds, FRAME_COUNT);
+
+	//	The slot of a frame is only reused once the GPU finished it, so there is always room for the new frame
+	TEST_CHECK(mostAheadAtBegin < _framesInFlight);
+	TEST_CHECK(mostAheadAtEnd <= _framesInFlight);
+	TEST_CHECK(mostAheadAtEnd == _framesInFlight);
+	TEST_CHECK(frameRing.GetWaitCount() > 0);
+	TEST_CHECK(frameRing.GetFramesAhead() == 0);
+	TEST_CHECK(milliseconds >= FRAME_COUNT * GPU_FRAME_TIME * 0.9);
+
+	frameRing.Shutdown();
+}
+
+int main()
+{
+	for (unsigned int framesInFlight = 1; framesInFlight <= MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+	{
+		TestRunAhead(framesInFlight);
+	}
+
+	//	Out of range counts are clamped to 1 - MAX_FRAMES_IN_FLIGHT
+	FrameRingClass frameRing;
+	SimulatedFenceClass fence;
+	TEST_CHECK(frameRing.Initialize(&fence, 0) && frameRing.GetFramesInFlight() == 1);
+	TEST_CHECK(frameRing.Initialize(&fence, MAX_FRAMES_IN_FLIGHT + 1) && frameRing.GetFramesInFlight() == MAX_FRAMES_IN_FLIGHT);
+	TEST_CHECK(!frameRing.Initialize(nullptr, 2));
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "TestClass.h"
+#include "FrameRingClass.h"
+#include "GpuTimerClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include "SimulatedFenceClass.h"
+
+#pragma region Globals
+static const unsigned int FRAME_COUNT = 30;
+static const unsigned int MAX_ZONES_PER_FRAME = 4;
+static const double GPU_FRAME_TIME = 2.0;		// milliseconds the simulated GPU works on every frame
+static const double MAX_READ_TIME = 1.0;		// milliseconds BeginFrame of the timer may take, far less than waiting for a GPU frame
+static const char* const ZONE_NAMES[MAX_ZONES_PER_FRAME] = { "Shadow", "Opaque", "Transparent", "Post" };
+
+static unsigned long long FakeTime = 0;
+#pragma endregion
+
+/*
+	The simulated GPU reads this clock, so every zone takes exactly as long as the test says
+*/
+static unsigned long long FakeClock()
+{
+	return FakeTime;
+}
+
+/*
+	Zones and their length in microseconds differ from frame to frame, so a result can only match the frame it belongs to
+*/
+static unsigned int GetZoneCount(unsigned long long _frame)
+{
+	return 1 + static_cast<unsigned int>(_frame % MAX_ZONES_PER_FRAME);
+}
+
+static unsigned long long GetZoneDuration(unsigned long long _frame, unsigned int _zone)
+{
+	return _frame * 100 + _zone * 10 + 5;
+}
+
+/*
+	Record FRAME_COUNT frames through the frame ring like NullRendererClass does
+	The results of a frame are read when its frame in flight comes around again, so frame N reports frame N - _framesInFlight
+	Reading them never waits, the frame ring already waited for the GPU before the timer reads
+*/
+static void TestLatency(unsigned int _framesInFlight)
+{
+	SimulatedFenceClass fence;
+	fence.SetLatency(GPU_FRAME_TIME);
+
+	FrameRingClass frameRing;
+	TEST_CHECK(frameRing.Initialize(&fence, _framesInFlight));
+
+	SimulatedTimestampQueriesClass timestampQueries;
+	TEST_CHECK(timestampQueries.Initialize(GPU_TIMER_QUERY_COUNT));
+	timestampQueries.SetClock(FakeClock);
+
+	SimulatedCommandRecorderClass recorder;
+	TEST_CHECK(recorder.Initialize(&timestampQueries));
+
+	GpuTimerClass gpuTimer;
+	TEST_CHECK(gpuTimer.Initialize(&timestampQueries));
+
+	double slowestRead = 0.0;
+	unsigned int reportedFrames = 0;
+
+	for (unsigned long long frame = 1; frame <= FRAME_COUNT; frame++)
+	{
+		TEST_CHECK(frameRing.BeginFrame());
+
+		unsigned long long start = TimerClass::GetMicroseconds();
+		gpuTimer.BeginFrame(frameRing.GetFrameIndex());
+		double milliseconds = TestClass::GetMilliseconds(start);
+		slowestRead = milliseconds > slowestRead ? milliseconds : slowestRead;
+
+		TEST_CHECK(gpuTimer.GetFrameNumber() == frame);
+
+		if (frame <= _framesInFlight)
+		{
+			TEST_CHECK(gpuTimer.GetResolvedFrame() == 0);
+			TEST_CHECK(gpuTimer.GetZoneCount() == 0);
+		}
+		else
+		{
+			unsigned long long resolvedFrame = frame - _framesInFlight;
+			TEST_CHECK(gpuTimer.GetResolvedFrame() == resolvedFrame);
+			TEST_CHECK(gpuTimer.GetZoneCount() == GetZoneCount(resolvedFrame));
+
+			for (unsigned int i = 0; i < gpuTimer.GetZoneCount(); i++)
+			{
+				double expected = static_cast<double>(GetZoneDuration(resolvedFrame, i)) * 0.001;
+				TEST_CHECK(gpuTimer.GetZoneName(i) == ZONE_NAMES[i]);
+				TEST_CHECK(gpuTimer.GetZoneTime(i) > expected - 0.0001 && gpuTimer.GetZoneTime(i) < expected + 0.0001);
+			}
+
+			reportedFrames++;
+		}
+
+		for (unsigned int i = 0; i < GetZoneCount(frame); i++)
+		{
+			gpuTimer.BeginZone(&recorder, i, ZONE_NAMES[i]);
+			FakeTime += GetZoneDuration(frame, i);
+			gpuTimer.EndZone(&recorder, i);
+			FakeTime += 1;
+		}
+		gpuTimer.Resolve(&recorder, GetZoneCount(frame));
+
+		TEST_CHECK(frameRing.EndFrame());
+	}
+
+	TEST_CHECK(frameRing.WaitForIdle());
+	TEST_CHECK(reportedFrames == FRAME_COUNT - _framesInFlight);
+	TEST_CHECK(slowestRead < MAX_READ_TIME);
+
+	printf("%u frames in flight: %u frames reported, %llu waits of the frame ring, slowest read %.4f ms\n", _framesInFlight, reportedFrames,
+		frameRing.GetWaitCount(), slowestRead);
+
+	gpuTimer.Shutdown();
+	recorder.Shutdown();
+	timestampQueries.Shutdown();
+	frameRing.Shutdown();
+}
+
+/*
+	A clock reset between the begin and the end of a zone (e.g. power management) reports 0 instead of a huge time
+*/
+static void TestClockReset()
+{
+	SimulatedTimestampQueriesClass timestampQueries;
+	TEST_CHECK(timestampQueries.Initialize(GPU_TIMER_QUERY_COUNT));
+	timestampQueries.SetClock(FakeClock);
+
+	SimulatedCommandRecorderClass recorder;
+	TEST_CHECK(recorder.Initialize(&timestampQueries));
+
+	GpuTimerClass gpuTimer;
+	TEST_CHECK(gpuTimer.Initialize(&timestampQueries));
+
+	FakeTime = 1000;
+	gpuTimer.BeginFrame(0);
+	gpuTimer.BeginZone(&recorder, 0, ZONE_NAMES[0]);
+	FakeTime = 10;
+	gpuTimer.EndZone(&recorder, 0);
+	gpuTimer.Resolve(&recorder, 1);
+
+	gpuTimer.BeginFrame(0);
+	TEST_CHECK(gpuTimer.GetResolvedFrame() == 1);
+	TEST_CHECK(gpuTimer.GetZoneCount() == 1);
+	TEST_CHECK(gpuTimer.GetZoneTime(0) == 0.0);
+
+	//	Too few queries for every frame in flight
+	SimulatedTimestampQueriesClass smallQueries;
+	TEST_CHECK(smallQueries.Initialize(GPU_TIMER_QUERY_COUNT - 1));
+	GpuTimerClass smallTimer;
+	TEST_CHECK(!smallTimer.Initialize(&smallQueries));
+	smallQueries.Shutdown();
+
+	gpuTimer.Shutdown();
+	recorder.Shutdown();
+	timestampQueries.Shutdown();
+}
+
+int main()
+{
+	for (unsigned int framesInFlight = 1; framesInFlight <= MAX_FRAMES_IN_FLIGHT; framesInFlight++)
+	{
+		TestLatency(framesInFlight);
+	}
+
+	TestClockReset();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#include "TestClass.h"
+#include "InputClass.h"
+
+#pragma region Globals
+static const unsigned int KEY_A = 0x41;
+static const unsigned int KEY_SPACE = 0x20;
+static const unsigned int OVERFLOW_EVENTS = 16;
+#pragma endregion
+
+/*
+	A tap shorter than a frame still reports the press and the release, the key is up again at the end of the frame
+*/
+static void TestTapWithinFrame()
+{
+	InputClass input;
+	input.Initialize();
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	input.KeyDown(KEY_A);
+	input.KeyUp(KEY_A);
+	input.Update();
+
+	TEST_CHECK(input.WasKeyPressed(KEY_A));
+	TEST_CHECK(input.WasKeyReleased(KEY_A));
+	TEST_CHECK(!input.IsKeyDown(KEY_A));
+	TEST_CHECK(!input.WasKeyPressed(KEY_SPACE));
+
+	TEST_CHECK(input.GetOldestEventTimestamp() >= start);
+	TEST_CHECK(input.GetOldestEventTimestamp() <= TimerClass::GetMicroseconds());
+	TEST_CHECK(input.GetDroppedEventCount() == 0);
+
+	//	The next frame without events forgets the tap and the timestamp
+	input.Update();
+	TEST_CHECK(!input.WasKeyPressed(KEY_A));
+	TEST_CHECK(!input.WasKeyReleased(KEY_A));
+	TEST_CHECK(input.GetOldestEventTimestamp() == 0);
+}
+
+/*
+	The key repeat of the operating system sends more key downs while the key is held, none of them is a new press
+*/
+static void TestKeyRepeat()
+{
+	InputClass input;
+	input.Initialize();
+
+	input.KeyDown(KEY_SPACE);
+	input.Update();
+	TEST_CHECK(input.WasKeyPressed(KEY_SPACE));
+	TEST_CHECK(input.IsKeyDown(KEY_SPACE));
+
+	input.KeyDown(KEY_SPACE);
+	input.KeyDown(KEY_SPACE);
+	input.Update();
+	TEST_CHECK(!input.WasKeyPressed(KEY_SPACE));
+	TEST_CHECK(input.IsKeyDown(KEY_SPACE));
+
+	input.KeyUp(KEY_SPACE);
+	input.Update();
+	TEST_CHECK(input.WasKeyReleased(KEY_SPACE));
+	TEST_CHECK(!input.IsKeyDown(KEY_SPACE));
+
+	//	A release of a key which is already up is no release either
+	input.KeyUp(KEY_SPACE);
+	input.Update();
+	TEST_CHECK(!input.WasKeyReleased(KEY_SPACE));
+
+	//	Keys outside of the table are ignored and not counted as dropped
+	input.KeyDown(KEY_COUNT);
+	input.Update();
+	TEST_CHECK(input.GetOldestEventTimestamp() == 0);
+	TEST_CHECK(input.GetDroppedEventCount() == 0);
+}
+
+/*
+	More events than the queue holds between two frames, the ones which do not fit are counted
+	One slot of the queue stays empty, so it holds INPUT_EVENT_QUEUE_SIZE - 1 events
+*/
+static void TestOverflow()
+{
+	InputClass input;
+	input.Initialize();
+
+	for (unsigned int i = 0; i < INPUT_EVENT_QUEUE_SIZE + OVERFLOW_EVENTS; i++)
+	{
+		if (i % 2 == 0)
+		{
+			input.KeyDown(KEY_A);
+		}
+		else
+		{
+			input.KeyUp(KEY_A);
+		}
+	}
+	TEST_CHECK(input.GetDroppedEventCount() == OVERFLOW_EVENTS + 1);
+
+	//	The events which made it into the queue alternate from a press to a press, so the key stays down
+	input.Update();
+	TEST_CHECK(input.WasKeyPressed(KEY_A));
+	TEST_CHECK(input.WasKeyReleased(KEY_A));
+	TEST_CHECK(input.IsKeyDown(KEY_A));
+	TEST_CHECK(input.GetOldestEventTimestamp() != 0);
+
+	//	The queue is empty again and takes new events
+	input.KeyUp(KEY_A);
+	input.Update();
+	TEST_CHECK(input.WasKeyReleased(KEY_A));
+	TEST_CHECK(!input.IsKeyDown(KEY_A));
+	TEST_CHECK(input.GetDroppedEventCount() == OVERFLOW_EVENTS + 1);
+}
+
+int main()
+{
+	TestTapWithinFrame();
+	TestKeyRepeat();
+	TestOverflow();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
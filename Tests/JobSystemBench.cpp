@@ -0,0 +1,158 @@
+#include "TestClass.h"
+#include "JobSystemClass.h"
+#include "SimulatedCommandRecorderClass.h"
+#include <atomic>
+
+#pragma region Globals
+static const unsigned int PASS_COUNT = 256;
+static const unsigned int DRAWS_PER_PASS = 2000;
+static const unsigned int PASS_BATCH_SIZE = 4;
+static const unsigned int RUN_COUNT = 5;
+static const unsigned int SMALL_JOB_COUNT = JOB_POOL_SIZE * 3;		// more batches than a thread has job slots, Run has to help until slots are free
+#pragma endregion
+
+/*
+	Every pass records its draws into the recorder of the thread running it, like D3DClass records every pass into its own command list
+	_runs counts how often every pass ran
+*/
+struct RecordState
+{
+	SimulatedCommandRecorderClass recorders[MAX_JOB_THREADS];
+	std::atomic<unsigned int>* runs;
+};
+
+static void RecordPasses(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	RecordState* state = static_cast<RecordState*>(_data);
+	SimulatedCommandRecorderClass& recorder = state->recorders[_threadIndex];
+
+	DrawMesh mesh = {};
+	for (unsigned int pass = _begin; pass < _end; pass++)
+	{
+		state->runs[pass].fetch_add(1);
+
+		for (unsigned int i = 0; i < DRAWS_PER_PASS; i++)
+		{
+			recorder.SetMaterial(i % 16);
+			mesh.indexCount = 36 + i % 7;
+			recorder.SetMesh(mesh);
+			recorder.DrawIndexedInstanced(mesh.indexCount, 1, 0, 0, 0);
+		}
+	}
+}
+
+static void CountRun(void* _data, unsigned int _begin, unsigned int _end, unsigned int _threadIndex)
+{
+	std::atomic<unsigned int>* runs = static_cast<std::atomic<unsigned int>*>(_data);
+	for (unsigned int i = _begin; i < _end; i++)
+	{
+		runs[i].fetch_add(1);
+	}
+}
+
+/*
+	Items which did not run exactly once, the counts are reset for the next run
+*/
+static unsigned int CountWrongRuns(std::atomic<unsigned int>* _runs, unsigned int _count)
+{
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		wrong += _runs[i].load() != 1 ? 1 : 0;
+		_runs[i].store(0);
+	}
+
+	return wrong;
+}
+
+static unsigned long long CountDraws(const RecordState& _state)
+{
+	unsigned long long draws = 0;
+	for (unsigned int i = 0; i < MAX_JOB_THREADS; i++)
+	{
+		draws += _state.recorders[i].GetDrawCount();
+	}
+
+	return draws;
+}
+
+/*
+	Best of RUN_COUNT recordings of every pass, on the calling thread alone when _jobSystem is nullptr
+*/
+static double MeasureRecording(JobSystemClass* _jobSystem, RecordState& _state)
+{
+	double best = 0.0;
+	for (unsigned int run = 0; run < RUN_COUNT; run++)
+	{
+		unsigned long long draws = CountDraws(_state);
+		unsigned long long start = TimerClass::GetMicroseconds();
+
+		if (_jobSystem)
+		{
+			JobCounter counter(0);
+			TEST_CHECK(_jobSystem->ParallelFor(RecordPasses, &_state, PASS_COUNT, PASS_BATCH_SIZE, &counter));
+			_jobSystem->WaitForCounter(&counter);
+		}
+		else
+		{
+			RecordPasses(&_state, 0, PASS_COUNT, 0);
+		}
+
+		double milliseconds = TestClass::GetMilliseconds(start);
+		best = run == 0 || milliseconds < best ? milliseconds : best;
+
+		TEST_CHECK(CountWrongRuns(_state.runs, PASS_COUNT) == 0);
+		TEST_CHECK(CountDraws(_state) - draws == static_cast<unsigned long long>(PASS_COUNT) * DRAWS_PER_PASS);
+	}
+
+	return best;
+}
+
+int main()
+{
+	SimulatedTimestampQueriesClass timestampQueries;
+	TEST_CHECK(timestampQueries.Initialize(2));
+
+	RecordState* state = new RecordState();
+	state->runs = new std::atomic<unsigned int>[SMALL_JOB_COUNT];
+	for (unsigned int i = 0; i < SMALL_JOB_COUNT; i++)
+	{
+		state->runs[i].store(0);
+	}
+	for (unsigned int i = 0; i < MAX_JOB_THREADS; i++)
+	{
+		TEST_CHECK(state->recorders[i].Initialize(&timestampQueries));
+	}
+
+	double serial = MeasureRecording(nullptr, *state);
+	printf("%u passes of %u draws: %.2f ms on the calling thread\n", PASS_COUNT, DRAWS_PER_PASS, serial);
+
+	unsigned int hardwareThreads = std::thread::hardware_concurrency();
+	hardwareThreads = hardwareThreads > 0 ? hardwareThreads : 1;
+	for (unsigned int workers = 1; workers <= hardwareThreads; workers++)
+	{
+		JobSystemClass jobSystem;
+		TEST_CHECK(jobSystem.Initialize(workers));
+
+		double milliseconds = MeasureRecording(&jobSystem, *state);
+		printf("%2u workers: %.2f ms, %.2fx the calling thread\n", workers, milliseconds, serial / milliseconds);
+
+		//	Single item batches, three times as many as the calling thread has job slots
+		JobCounter counter(0);
+		TEST_CHECK(jobSystem.ParallelFor(CountRun, state->runs, SMALL_JOB_COUNT, 1, &counter));
+		jobSystem.WaitForCounter(&counter);
+		TEST_CHECK(CountWrongRuns(state->runs, SMALL_JOB_COUNT) == 0);
+
+		jobSystem.Shutdown();
+	}
+
+	for (unsigned int i = 0; i < MAX_JOB_THREADS; i++)
+	{
+		state->recorders[i].Shutdown();
+	}
+	delete[] state->runs;
+	delete state;
+	timestampQueries.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "TestClass.h"
+#include "LodClass.h"
+#include "GraphicsClass.h"
+#include "MeshCookerClass.h"
+#include <cmath>
+
+#pragma region Globals
+static const unsigned int SPHERE_SEGMENTS = 256;
+static const unsigned int SPHERE_RINGS = 128;
+static const unsigned int OBJECT_COUNT = 1000000;
+static const float WORLD_SIZE = 4000.0f;
+static const unsigned int SCREEN_WIDTH = 800;		// the window of the headless platform
+static const unsigned int SCREEN_HEIGHT = 600;
+static const unsigned int JITTER_FRAMES = 100;
+static const float JITTER = 0.1f;
+static const float DISTANCE_TOLERANCE = 1e-4f;		// relative, the test computes the allowed error again and may round differently
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run builds the same scene
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+/*
+	Unit sphere with a seam at the first segment, the rings next to the poles are triangle fans
+*/
+static void CreateSphere(SourceMesh& _mesh)
+{
+	unsigned int columns = SPHERE_SEGMENTS + 1;
+	_mesh.vertexCount = (SPHERE_RINGS + 1) * columns;
+	_mesh.positions = new float[_mesh.vertexCount * 3];
+	_mesh.normals = new float[_mesh.vertexCount * 3];
+	_mesh.texcoords = new float[_mesh.vertexCount * 2];
+	_mesh.indices = new unsigned int[SPHERE_RINGS * SPHERE_SEGMENTS * 6];
+	_mesh.indexCount = 0;
+
+	for (unsigned int ring = 0; ring <= SPHERE_RINGS; ring++)
+	{
+		float theta = MATH_PI * static_cast<float>(ring) / static_cast<float>(SPHERE_RINGS);
+		for (unsigned int segment = 0; segment <= SPHERE_SEGMENTS; segment++)
+		{
+			float phi = 2.0f * MATH_PI * static_cast<float>(segment) / static_cast<float>(SPHERE_SEGMENTS);
+			unsigned int vertex = ring * columns + segment;
+			float* position = &_mesh.positions[vertex * 3];
+			position[0] = sinf(theta) * cosf(phi);
+			position[1] = cosf(theta);
+			position[2] = sinf(theta) * sinf(phi);
+			_mesh.normals[vertex * 3] = position[0];
+			_mesh.normals[vertex * 3 + 1] = position[1];
+			_mesh.normals[vertex * 3 + 2] = position[2];
+			_mesh.texcoords[vertex * 2] = static_cast<float>(segment) / static_cast<float>(SPHERE_SEGMENTS);
+			_mesh.texcoords[vertex * 2 + 1] = static_cast<float>(ring) / static_cast<float>(SPHERE_RINGS);
+		}
+	}
+
+	for (unsigned int ring = 0; ring < SPHERE_RINGS; ring++)
+	{
+		for (unsigned int segment = 0; segment < SPHERE_SEGMENTS; segment++)
+		{
+			unsigned int a = ring * columns + segment;
+			unsigned int b = a + columns;
+			if (ring > 0)
+			{
+				_mesh.indices[_mesh.indexCount++] = a;
+				_mesh.indices[_mesh.indexCount++] = a + 1;
+				_mesh.indices[_mesh.indexCount++] = b;
+			}
+			if (ring + 1 < SPHERE_RINGS)
+			{
+				_mesh.indices[_mesh.indexCount++] = a + 1;
+				_mesh.indices[_mesh.indexCount++] = b + 1;
+				_mesh.indices[_mesh.indexCount++] = b;
+			}
+		}
+	}
+}
+
+/*
+	How far the triangles of a level get from the unit sphere, the largest distance of a triangle center to the surface
+*/
+static float GetDeviation(const MeshAssetHeader& _mesh, const MeshLod& _lod)
+{
+	const MeshVertex* vertices = reinterpret_cast<const MeshVertex*>(reinterpret_cast<const unsigned char*>(&_mesh) + _mesh.vertexOffset);
+	float deviation = 0.0f;
+	for (unsigned int i = _lod.firstIndex; i < _lod.firstIndex + _lod.indexCount; i += 3)
+	{
+		Vector3 a = MeshAssetClass::DecodePosition(_mesh, vertices[MeshAssetClass::GetIndex(_mesh, i)]);
+		Vector3 b = MeshAssetClass::DecodePosition(_mesh, vertices[MeshAssetClass::GetIndex(_mesh, i + 1)]);
+		Vector3 c = MeshAssetClass::DecodePosition(_mesh, vertices[MeshAssetClass::GetIndex(_mesh, i + 2)]);
+		Vector3 center = { (a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f };
+		deviation = fmaxf(deviation, fabsf(1.0f - MathClass::Length(center)));
+	}
+
+	return deviation;
+}
+
+/*
+	Every level has fewer triangles and a larger error than the one before, the full mesh has no error
+	The error is the quadric error of the collapses, an average distance over the planes of the surface, single triangles may get further away than that
+	They have to stay within twice the error of the sphere, plus what the full mesh already deviates
+*/
+static void TestChain(const MeshAssetHeader& _mesh)
+{
+	TEST_CHECK(_mesh.lodCount > 1 && _mesh.lodCount <= MESH_MAX_LODS);
+	TEST_CHECK(_mesh.lods[0].error == 0.0f);
+
+	float fullDeviation = GetDeviation(_mesh, _mesh.lods[0]);
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < _mesh.lodCount; i++)
+	{
+		const MeshLod& lod = _mesh.lods[i];
+		float deviation = GetDeviation(_mesh, lod);
+		printf("level %u: %6u triangles, error %.5f, deviation %.5f\n", i, lod.indexCount / 3, lod.error, deviation);
+
+		if (i > 0)
+		{
+			const MeshLod& finer = _mesh.lods[i - 1];
+			wrong += lod.indexCount > finer.indexCount * MESH_LOD_MIN_REDUCTION || lod.error < finer.error ? 1 : 0;
+			wrong += deviation > 2.0f * lod.error + fullDeviation ? 1 : 0;
+		}
+	}
+	TEST_CHECK(wrong == 0);
+}
+
+/*
+	After Select every level is within the hysteresis of the limit: its error at most LOD_HYSTERESIS over the allowed error,
+	the next coarser one more than LOD_HYSTERESIS below it (else Select would have taken it)
+	_errors are the errors of the mesh, _scales scale them per object
+*/
+static unsigned int CountWrongLevels(const LodClass& _lod, const float* _centers, const float* _radius, const float* _errors, unsigned int _levelCount,
+	const float* _scales, const Vector3& _camera, float _projectionScale)
+{
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		Vector3 offset = { _centers[i * 3] - _camera.x, _centers[i * 3 + 1] - _camera.y, _centers[i * 3 + 2] - _camera.z };
+		float distance = fmaxf(MathClass::Length(offset) - _radius[i], SCREEN_NEAR);
+		float allowed = distance * LOD_PIXEL_ERROR / _projectionScale;
+
+		unsigned int level = _lod.GetLevel(i);
+		float error = _errors[level] * _scales[i];
+		wrong += level >= _levelCount || error > allowed * (1.0f + LOD_HYSTERESIS) * (1.0f + DISTANCE_TOLERANCE) ? 1 : 0;
+		wrong += level + 1 < _levelCount && _errors[level + 1] * _scales[i] <= allowed * (1.0f - LOD_HYSTERESIS) * (1.0f - DISTANCE_TOLERANCE) ? 1 : 0;
+	}
+
+	return wrong;
+}
+
+/*
+	Triangles drawn with the selected levels
+*/
+static unsigned long long CountTriangles(const LodClass& _lod, const MeshAssetHeader& _mesh)
+{
+	unsigned long long triangles = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		triangles += _mesh.lods[_lod.GetLevel(i)].indexCount / 3;
+	}
+
+	return triangles;
+}
+
+int main()
+{
+	SourceMesh source = {};
+	CreateSphere(source);
+
+	unsigned char* asset = nullptr;
+	size_t assetSize = 0;
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(MeshCookerClass::Cook(source, asset, assetSize));
+	printf("cook: %u triangles in %.1f ms\n", source.indexCount / 3, TestClass::GetMilliseconds(start));
+	MeshCookerClass::Release(source);
+
+	const MeshAssetHeader* mesh = asset ? MeshAssetClass::Get(reinterpret_cast<const AssetHeader*>(asset)) : nullptr;
+	TEST_CHECK(mesh != nullptr);
+	if (!mesh)
+	{
+		delete[] asset;
+		return TestClass::GetResult();
+	}
+	TestChain(*mesh);
+
+	float errors[MESH_MAX_LODS];
+	for (unsigned int i = 0; i < mesh->lodCount; i++)
+	{
+		errors[i] = mesh->lods[i].error;
+	}
+
+	//	Spheres of 0.5 - 5 units scattered over the world, the camera stands in the middle of it, the radius of an object is its scale
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+	LodClass* lod = new LodClass();
+	TEST_CHECK(lod->Initialize(OBJECT_COUNT, &jobSystem));
+
+	float* centers = new float[OBJECT_COUNT * 3];
+	float* scales = new float[OBJECT_COUNT];
+	unsigned int* objects = new unsigned int[OBJECT_COUNT];
+	unsigned int random = 2024;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		centers[i * 3] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		centers[i * 3 + 1] = NextRandom(random, 0.0f, 50.0f);
+		centers[i * 3 + 2] = NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f);
+		scales[i] = NextRandom(random, 0.5f, 5.0f);
+		objects[i] = i;
+
+		lod->SetObject(i, Vector3{ centers[i * 3], centers[i * 3 + 1], centers[i * 3 + 2] }, scales[i]);
+		lod->SetMesh(i, *mesh, scales[i]);
+	}
+
+	//	The projection GraphicsClass builds for the window
+	Matrix4 projection = MathClass::Perspective(FIELD_OF_VIEW, static_cast<float>(SCREEN_WIDTH) / static_cast<float>(SCREEN_HEIGHT), SCREEN_NEAR, SCREEN_DEPTH);
+	float projectionScale = LodClass::GetProjectionScale(projection, SCREEN_HEIGHT);
+
+	Vector3 camera = { 0.0f, 2.0f, 0.0f };
+	start = TimerClass::GetMicroseconds();
+	unsigned int changed = lod->Select(objects, OBJECT_COUNT, camera, projectionScale, SCREEN_NEAR);
+	double firstTime = TestClass::GetMilliseconds(start);
+	TEST_CHECK(CountWrongLevels(*lod, centers, scales, errors, mesh->lodCount, scales, camera, projectionScale) == 0);
+
+	unsigned long long fullTriangles = static_cast<unsigned long long>(mesh->lods[0].indexCount / 3) * OBJECT_COUNT;
+	unsigned long long triangles = CountTriangles(*lod, *mesh);
+	unsigned long long pickedTriangles = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		Vector3 center = { centers[i * 3], centers[i * 3 + 1], centers[i * 3 + 2] };
+		float objectErrors[MESH_MAX_LODS];
+		for (unsigned int j = 0; j < mesh->lodCount; j++)
+		{
+			objectErrors[j] = errors[j] * scales[i];
+		}
+		pickedTriangles += mesh->lods[LodClass::PickLevel(objectErrors, mesh->lodCount, center, scales[i], camera, projectionScale, SCREEN_NEAR)].indexCount / 3;
+	}
+	printf("budget: %u objects, %llu triangles selected (%.2f%% of %llu at full detail, %llu without hysteresis), %u changed their level\n", OBJECT_COUNT, triangles,
+		100.0 * static_cast<double>(triangles) / static_cast<double>(fullTriangles), fullTriangles, pickedTriangles, changed);
+	TEST_CHECK(triangles * 20 < fullTriangles);
+
+	//	Moving far across the world changes most levels, the selection throughput
+	camera = { WORLD_SIZE * 0.25f, 2.0f, WORLD_SIZE * 0.25f };
+	start = TimerClass::GetMicroseconds();
+	changed = lod->Select(objects, OBJECT_COUNT, camera, projectionScale, SCREEN_NEAR);
+	double selectTime = TestClass::GetMilliseconds(start);
+	printf("select: %.2f ms for the first frame, %.2f ms after moving (%u changed), %.1f M objects/s\n", firstTime, selectTime, changed,
+		OBJECT_COUNT / (selectTime * 1000.0));
+	TEST_CHECK(CountWrongLevels(*lod, centers, scales, errors, mesh->lodCount, scales, camera, projectionScale) == 0);
+
+	//	A camera shaking in place barely changes levels with hysteresis, without it every object near a limit flips
+	unsigned char* previous = new unsigned char[OBJECT_COUNT];
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		previous[i] = static_cast<unsigned char>(lod->GetLevel(i));
+	}
+	unsigned long long hysteresisChanges = 0;
+	unsigned long long pickChanges = 0;
+	Vector3 center = camera;
+	random = 5;
+	for (unsigned int frame = 0; frame < JITTER_FRAMES; frame++)
+	{
+		camera = { center.x + NextRandom(random, -JITTER, JITTER), center.y, center.z + NextRandom(random, -JITTER, JITTER) };
+		hysteresisChanges += lod->Select(objects, OBJECT_COUNT, camera, projectionScale, SCREEN_NEAR);
+
+		for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+		{
+			Vector3 objectCenter = { centers[i * 3], centers[i * 3 + 1], centers[i * 3 + 2] };
+			float objectErrors[MESH_MAX_LODS];
+			for (unsigned int j = 0; j < mesh->lodCount; j++)
+			{
+				objectErrors[j] = errors[j] * scales[i];
+			}
+			unsigned char level = static_cast<unsigned char>(LodClass::PickLevel(objectErrors, mesh->lodCount, objectCenter, scales[i], camera, projectionScale, SCREEN_NEAR));
+			pickChanges += frame > 0 && level != previous[i] ? 1 : 0;
+			previous[i] = level;
+		}
+	}
+	printf("jitter: %.1f level changes per frame with hysteresis, %.1f without\n", static_cast<double>(hysteresisChanges) / JITTER_FRAMES,
+		static_cast<double>(pickChanges) / (JITTER_FRAMES - 1));
+	TEST_CHECK(hysteresisChanges * 4 < pickChanges);
+
+	delete[] previous;
+	delete[] objects;
+	delete[] scales;
+	delete[] centers;
+	lod->Shutdown();
+	delete lod;
+	jobSystem.Shutdown();
+	delete[] asset;
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
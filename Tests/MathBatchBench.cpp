@@ -0,0 +1,229 @@
+#include "TestClass.h"
+#include "MathBatchClass.h"
+#include <cmath>
+
+#pragma region Globals
+static const float POINT_RANGE = 1000.0f;
+static const size_t POINT_COUNT = 100003;		// no multiple of 4 or 8, the last points go through the scalar tail
+static const size_t MATRIX_COUNT = 10007;
+static const unsigned int REPEAT_COUNT = 20;
+static const float TOLERANCE = 1e-5f;		// relative, fused multiply add rounds once where the scalar code rounds twice
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run transforms the same values
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+/*
+	Largest difference relative to the magnitude of the reference
+	References below _magnitude, the size of the inputs, are compared relative to _magnitude, they come from terms cancelling each other out
+*/
+static float GetError(const float* _values, const float* _reference, size_t _count, float _magnitude)
+{
+	float worst = 0.0f;
+	for (size_t i = 0; i < _count; i++)
+	{
+		float error = fabsf(_values[i] - _reference[i]) / fmaxf(fabsf(_reference[i]), _magnitude);
+		worst = error > worst ? error : worst;
+	}
+
+	return worst;
+}
+
+static Matrix4 GetMatrix(unsigned int& _state)
+{
+	Vector3 axis = MathClass::Normalize(Vector3{ NextRandom(_state, -1.0f, 1.0f), NextRandom(_state, -1.0f, 1.0f), NextRandom(_state, -1.0f, 1.0f) });
+	Quaternion rotation = MathClass::QuaternionFromAxisAngle(axis, NextRandom(_state, -3.0f, 3.0f));
+	Vector3 translation = { NextRandom(_state, -100.0f, 100.0f), NextRandom(_state, -100.0f, 100.0f), NextRandom(_state, -100.0f, 100.0f) };
+	Vector3 scale = { NextRandom(_state, 0.1f, 4.0f), NextRandom(_state, 0.1f, 4.0f), NextRandom(_state, 0.1f, 4.0f) };
+
+	return MathClass::Compose(translation, rotation, scale);
+}
+
+static void PrintTimes(const char* _name, size_t _count, double _simd, double _scalar, float _error)
+{
+	printf("%s: %zu in %.3f ms (%s), %.3f ms (scalar), %.2fx, largest relative error %g\n", _name, _count, _simd, SIMD_INSTRUCTION_SET, _scalar,
+		_scalar / _simd, _error);
+}
+
+/*
+	Points through one matrix: the kernel, its scalar twin and MathClass::TransformPoint have to agree
+*/
+static void TestTransformPoints()
+{
+	unsigned int random = 4711;
+	Matrix4 matrix = GetMatrix(random);
+
+	float* input = new float[POINT_COUNT * 3];
+	float* simd = new float[POINT_COUNT * 3];
+	float* scalar = new float[POINT_COUNT * 3];
+	for (size_t i = 0; i < POINT_COUNT * 3; i++)
+	{
+		input[i] = NextRandom(random, -POINT_RANGE, POINT_RANGE);
+	}
+	const float* x = input;
+	const float* y = input + POINT_COUNT;
+	const float* z = input + POINT_COUNT * 2;
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::TransformPoints(matrix, x, y, z, simd, simd + POINT_COUNT, simd + POINT_COUNT * 2, POINT_COUNT);
+	}
+	double simdTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::TransformPointsScalar(matrix, x, y, z, scalar, scalar + POINT_COUNT, scalar + POINT_COUNT * 2, POINT_COUNT);
+	}
+	double scalarTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	float error = GetError(simd, scalar, POINT_COUNT * 3, POINT_RANGE);
+	PrintTimes("transform points", POINT_COUNT, simdTime, scalarTime, error);
+	TEST_CHECK(error < TOLERANCE);
+
+	unsigned int wrong = 0;
+	for (size_t i = 0; i < POINT_COUNT; i += 101)
+	{
+		Vector3 point = MathClass::TransformPoint(Vector3{ x[i], y[i], z[i] }, matrix);
+		float expected[3] = { point.x, point.y, point.z };
+		float values[3] = { simd[i], simd[POINT_COUNT + i], simd[POINT_COUNT * 2 + i] };
+		wrong += GetError(values, expected, 3, POINT_RANGE) < TOLERANCE ? 0 : 1;
+	}
+	TEST_CHECK(wrong == 0);
+
+	delete[] scalar;
+	delete[] simd;
+	delete[] input;
+}
+
+/*
+	World matrices times a view projection, compared entry by entry with the scalar twin and MathClass::Multiply
+*/
+static void TestMultiplyMatrices()
+{
+	unsigned int random = 1234;
+	Matrix4 viewProjection = MathClass::Multiply(MathClass::LookAt(Vector3{ 0.0f, 10.0f, -50.0f }, Vector3{ 0.0f, 0.0f, 0.0f }, Vector3{ 0.0f, 1.0f, 0.0f }),
+		MathClass::Perspective(1.0f, 16.0f / 9.0f, 0.1f, 1000.0f));
+
+	Matrix4* input = new Matrix4[MATRIX_COUNT];
+	Matrix4* simd = new Matrix4[MATRIX_COUNT];
+	Matrix4* scalar = new Matrix4[MATRIX_COUNT];
+	for (size_t i = 0; i < MATRIX_COUNT; i++)
+	{
+		input[i] = GetMatrix(random);
+	}
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::MultiplyMatrices(input, viewProjection, simd, MATRIX_COUNT);
+	}
+	double simdTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::MultiplyMatricesScalar(input, viewProjection, scalar, MATRIX_COUNT);
+	}
+	double scalarTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	float error = GetError(&simd[0].m[0][0], &scalar[0].m[0][0], MATRIX_COUNT * 16, 1.0f);
+	PrintTimes("multiply matrices", MATRIX_COUNT, simdTime, scalarTime, error);
+	TEST_CHECK(error < TOLERANCE);
+
+	unsigned int wrong = 0;
+	for (size_t i = 0; i < MATRIX_COUNT; i += 13)
+	{
+		Matrix4 expected = MathClass::Multiply(input[i], viewProjection);
+		wrong += GetError(&simd[i].m[0][0], &expected.m[0][0], 16, 1.0f) < TOLERANCE ? 0 : 1;
+	}
+	TEST_CHECK(wrong == 0);
+
+	delete[] scalar;
+	delete[] simd;
+	delete[] input;
+}
+
+/*
+	Translation, rotation and scale arrays into world matrices, compared with the scalar twin and MathClass::Compose
+*/
+static void TestComposeTransforms()
+{
+	unsigned int random = 99;
+	float* components = new float[MATRIX_COUNT * 10];
+	for (size_t i = 0; i < MATRIX_COUNT; i++)
+	{
+		Vector3 axis = MathClass::Normalize(Vector3{ NextRandom(random, -1.0f, 1.0f), NextRandom(random, -1.0f, 1.0f), NextRandom(random, -1.0f, 1.0f) });
+		Quaternion rotation = MathClass::QuaternionFromAxisAngle(axis, NextRandom(random, -3.0f, 3.0f));
+		components[i] = NextRandom(random, -100.0f, 100.0f);
+		components[MATRIX_COUNT + i] = NextRandom(random, -100.0f, 100.0f);
+		components[MATRIX_COUNT * 2 + i] = NextRandom(random, -100.0f, 100.0f);
+		components[MATRIX_COUNT * 3 + i] = rotation.x;
+		components[MATRIX_COUNT * 4 + i] = rotation.y;
+		components[MATRIX_COUNT * 5 + i] = rotation.z;
+		components[MATRIX_COUNT * 6 + i] = rotation.w;
+		components[MATRIX_COUNT * 7 + i] = NextRandom(random, 0.1f, 4.0f);
+		components[MATRIX_COUNT * 8 + i] = NextRandom(random, 0.1f, 4.0f);
+		components[MATRIX_COUNT * 9 + i] = NextRandom(random, 0.1f, 4.0f);
+	}
+
+	TransformArrays transforms;
+	const float** arrays[10] = { &transforms.positionX, &transforms.positionY, &transforms.positionZ, &transforms.rotationX, &transforms.rotationY,
+		&transforms.rotationZ, &transforms.rotationW, &transforms.scaleX, &transforms.scaleY, &transforms.scaleZ };
+	for (size_t i = 0; i < 10; i++)
+	{
+		*arrays[i] = components + MATRIX_COUNT * i;
+	}
+
+	Matrix4* simd = new Matrix4[MATRIX_COUNT];
+	Matrix4* scalar = new Matrix4[MATRIX_COUNT];
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::ComposeTransforms(transforms, simd, MATRIX_COUNT);
+	}
+	double simdTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < REPEAT_COUNT; i++)
+	{
+		MathBatchClass::ComposeTransformsScalar(transforms, scalar, MATRIX_COUNT);
+	}
+	double scalarTime = TestClass::GetMilliseconds(start) / REPEAT_COUNT;
+
+	float error = GetError(&simd[0].m[0][0], &scalar[0].m[0][0], MATRIX_COUNT * 16, 1.0f);
+	PrintTimes("compose transforms", MATRIX_COUNT, simdTime, scalarTime, error);
+	TEST_CHECK(error < TOLERANCE);
+
+	unsigned int wrong = 0;
+	for (size_t i = 0; i < MATRIX_COUNT; i += 13)
+	{
+		Vector3 translation = { transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i] };
+		Quaternion rotation = { transforms.rotationX[i], transforms.rotationY[i], transforms.rotationZ[i], transforms.rotationW[i] };
+		Vector3 scale = { transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i] };
+		Matrix4 expected = MathClass::Compose(translation, rotation, scale);
+		wrong += GetError(&simd[i].m[0][0], &expected.m[0][0], 16, 1.0f) < TOLERANCE ? 0 : 1;
+	}
+	TEST_CHECK(wrong == 0);
+
+	delete[] scalar;
+	delete[] simd;
+	delete[] components;
+}
+
+int main()
+{
+	TestTransformPoints();
+	TestMultiplyMatrices();
+	TestComposeTransforms();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#include "TestClass.h"
+#include "PipelineCacheClass.h"
+#include "SimulatedPipelineCompilerClass.h"
+#include <cstdio>
+#include <cstring>
+
+#pragma region Globals
+static const char* const CACHE_PATH = "PipelineCacheBench.bin";
+static const unsigned int PIPELINE_COUNT = 48;
+static const double COMPILE_TIME = 5.0;		// milliseconds per pipeline, shorter than SIMULATED_PIPELINE_COMPILE_TIME to keep the run short
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+/*
+	The pipelines of a small game: every combination of cull mode, blend mode, depth mode and a few render target formats
+*/
+static PipelineDesc GetPipelineDesc(unsigned int _index)
+{
+	PipelineDesc desc;
+	strncpy(desc.vertexShader, "Shaders/Mesh.hlsl", MAX_SHADER_PATH - 1);
+	strncpy(desc.vertexEntryPoint, "VertexMain", MAX_SHADER_ENTRY_POINT - 1);
+	strncpy(desc.pixelShader, "Shaders/Mesh.hlsl", MAX_SHADER_PATH - 1);
+	strncpy(desc.pixelEntryPoint, "PixelMain", MAX_SHADER_ENTRY_POINT - 1);
+	desc.topology = PIPELINE_TOPOLOGY_TRIANGLE;
+	desc.renderTargetCount = 1;
+	desc.renderTargetFormats[0] = 28 + _index % 4;
+	desc.cullMode = (_index / 4) % 3;
+	desc.blendMode = (_index / 12) % 2;
+	desc.depthMode = (_index / 24) % 2;
+
+	return desc;
+}
+
+struct LoadResult
+{
+	double milliseconds;
+	unsigned int compileCount;
+	unsigned int diskHitCount;
+	unsigned int readyCount;
+};
+
+/*
+	Request every pipeline like a level load would and wait until all of them are ready, Shutdown writes the disk cache
+*/
+static LoadResult LoadPipelines(JobSystemClass* _jobSystem, unsigned long long _compilerVersion)
+{
+	SimulatedPipelineCompilerClass compiler;
+	compiler.SetCompileTime(COMPILE_TIME);
+	compiler.SetCacheVersion(_compilerVersion);
+
+	PipelineCacheClass* cache = new PipelineCacheClass();
+	LoadResult result = {};
+	if (!TEST_CHECK(cache->Initialize(&compiler, _jobSystem, CACHE_PATH)))
+	{
+		delete cache;
+		return result;
+	}
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+
+	unsigned int handles[PIPELINE_COUNT];
+	for (unsigned int i = 0; i < PIPELINE_COUNT; i++)
+	{
+		handles[i] = cache->Request(GetPipelineDesc(i));
+	}
+	cache->WaitForAll();
+
+	result.milliseconds = TestClass::GetMilliseconds(start);
+	result.compileCount = cache->GetCompileCount();
+	result.diskHitCount = cache->GetDiskHitCount();
+	for (unsigned int i = 0; i < PIPELINE_COUNT; i++)
+	{
+		result.readyCount += cache->GetState(handles[i]) == PIPELINE_STATE_READY && cache->GetPipeline(handles[i]) ? 1 : 0;
+	}
+
+	//	Requesting a description again hands out the same pipeline without creating it again
+	TEST_CHECK(cache->Request(GetPipelineDesc(0)) == handles[0]);
+	TEST_CHECK(cache->GetPipelineCount() == PIPELINE_COUNT);
+	TEST_CHECK(cache->GetCompileCount() + cache->GetDiskHitCount() == PIPELINE_COUNT);
+
+	cache->Shutdown();
+	delete cache;
+
+	return result;
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	remove(CACHE_PATH);
+
+	LoadResult cold = LoadPipelines(&jobSystem, SIMULATED_PIPELINE_CACHE_VERSION);
+	LoadResult warm = LoadPipelines(&jobSystem, SIMULATED_PIPELINE_CACHE_VERSION);
+	LoadResult newDriver = LoadPipelines(&jobSystem, SIMULATED_PIPELINE_CACHE_VERSION + 1);
+
+	printf("cold: %u pipelines in %.1f ms, %u compiled, %u from disk\n", PIPELINE_COUNT, cold.milliseconds, cold.compileCount, cold.diskHitCount);
+	printf("warm: %u pipelines in %.1f ms, %u compiled, %u from disk (%.1fx faster)\n", PIPELINE_COUNT, warm.milliseconds, warm.compileCount, warm.diskHitCount,
+		cold.milliseconds / warm.milliseconds);
+	printf("new driver version: %u pipelines in %.1f ms, %u compiled, %u from disk\n", PIPELINE_COUNT, newDriver.milliseconds, newDriver.compileCount, newDriver.diskHitCount);
+
+	TEST_CHECK(cold.readyCount == PIPELINE_COUNT && warm.readyCount == PIPELINE_COUNT && newDriver.readyCount == PIPELINE_COUNT);
+	TEST_CHECK(cold.compileCount == PIPELINE_COUNT && cold.diskHitCount == 0);
+	TEST_CHECK(warm.compileCount == 0 && warm.diskHitCount == PIPELINE_COUNT);
+	TEST_CHECK(warm.milliseconds * 4.0 < cold.milliseconds);
+
+	//	Blobs of another driver version are not used, everything is compiled again
+	TEST_CHECK(newDriver.compileCount == PIPELINE_COUNT && newDriver.diskHitCount == 0);
+
+	remove(CACHE_PATH);
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
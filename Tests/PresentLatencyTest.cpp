@@ -0,0 +1,205 @@
+#include "TestClass.h"
+#include "SimulatedDisplayClass.h"
+
+#pragma region Globals
+static const double REFRESH_RATE = 60.0;
+static const unsigned long long REFRESH_TIME = 16667;		// microseconds, rounded up
+static const unsigned int FRAME_COUNT = 600;
+static const unsigned long long TIME_TOLERANCE = 2;		// microseconds the refreshes are rounded by
+#pragma endregion
+
+/*
+	CPU and GPU time of every frame in microseconds, the GPU starts a frame when the CPU submitted it and the previous one is done
+*/
+struct Workload
+{
+	const char* name;
+	unsigned long long cpuTime;
+	unsigned long long gpuTime;
+};
+
+struct RunResult
+{
+	double averageLatency;
+	double p99Latency;			// from the histogram of the statistics, ~4% resolution
+	unsigned long long endTime;
+	unsigned long long shown;
+	unsigned long long dropped;
+	unsigned int maxQueued;
+	bool accounted;
+};
+
+/*
+	Run FRAME_COUNT frames on a virtual clock like SystemClass::Run does
+	With _waitable the frame waits for room in the present queue before it samples the input, like the frame latency waitable object of a swap chain
+	Without it only Present blocks, so the input is sampled right after the previous present returned
+*/
+static RunResult Run(unsigned int _mode, unsigned int _bufferCount, unsigned int _frameLatency, bool _tearingSupported, const Workload& _workload, bool _waitable,
+	PresentPolicyClass& _policy)
+{
+	PresentSettings settings = { _mode, _bufferCount, _frameLatency, REFRESH_RATE };
+	TEST_CHECK(_policy.Initialize(settings, _tearingSupported));
+
+	SimulatedDisplayClass display;
+	TEST_CHECK(display.Initialize(&_policy, REFRESH_RATE));
+
+	RunResult result = {};
+	unsigned long long now = 0;
+	unsigned long long gpuDone = 0;
+	for (unsigned int i = 0; i < FRAME_COUNT; i++)
+	{
+		if (_waitable)
+		{
+			now = display.GetFrameStartTime(now);
+		}
+		_policy.BeginFrame(now);
+
+		now += _workload.cpuTime;
+		gpuDone = (gpuDone > now ? gpuDone : now) + _workload.gpuTime;
+
+		unsigned long long presentId = _policy.Present();
+		now = display.Present(presentId, now, gpuDone);
+
+		unsigned int queued = display.GetQueuedPresentCount();
+		result.maxQueued = queued > result.maxQueued ? queued : result.maxQueued;
+	}
+
+	//	Let every present leave the queue
+	display.Update(now + 1000000);
+
+	const FrameStatisticsClass& latency = _policy.GetLatencyStatistics();
+	result.averageLatency = latency.GetAverage();
+	result.p99Latency = latency.GetPercentile(0.99);
+	result.endTime = now;
+	result.shown = _policy.GetShownCount();
+	result.dropped = _policy.GetDroppedCount();
+	result.accounted = result.shown + result.dropped == _policy.GetPresentCount() && display.GetQueuedPresentCount() == 0;
+
+	display.Shutdown();
+	_policy.Shutdown();
+
+	return result;
+}
+
+/*
+	Every mode, buffer count and frame latency with a frame faster than a refresh and one slower
+	Every present is either shown or dropped, the queue never holds more than the frame latency, and no frame is shown before it is done
+	Only immediate presents without tearing drop frames, vsync and variable refresh show every one
+*/
+static void TestModes(const Workload* _workloads, unsigned int _workloadCount)
+{
+	PresentPolicyClass policy;
+	printf("%-10s %-9s %7s %7s %11s %11s %6s %7s\n", "workload", "mode", "buffers", "latency", "average ms", "p99 ms", "shown", "dropped");
+
+	for (unsigned int w = 0; w < _workloadCount; w++)
+	{
+		const Workload& workload = _workloads[w];
+		double minimumLatency = static_cast<double>(workload.cpuTime + workload.gpuTime) / 1000.0;
+
+		for (unsigned int mode = PRESENT_MODE_VSYNC; mode <= PRESENT_MODE_VARIABLE_REFRESH; mode++)
+		{
+			for (unsigned int buffers = MIN_SWAP_CHAIN_BUFFERS; buffers <= MAX_SWAP_CHAIN_BUFFERS; buffers++)
+			{
+				for (unsigned int frameLatency = 1; frameLatency < buffers; frameLatency++)
+				{
+					RunResult result = Run(mode, buffers, frameLatency, true, workload, true, policy);
+					printf("%-10s %-9s %7u %7u %11.2f %11.2f %6llu %7llu\n", workload.name, PresentPolicyClass::GetModeName(mode), buffers, frameLatency,
+						result.averageLatency, result.p99Latency, result.shown, result.dropped);
+
+					TEST_CHECK(result.accounted);
+					TEST_CHECK(result.maxQueued <= frameLatency);
+					TEST_CHECK(result.averageLatency >= minimumLatency);
+					TEST_CHECK(mode == PRESENT_MODE_IMMEDIATE || result.dropped == 0);
+				}
+			}
+		}
+	}
+}
+
+/*
+	With tearing immediate presents are shown the moment the GPU is done, at frame latency 1 the latency is the time of the frame
+	Without tearing they wait for the next refresh and newer presents replace older ones, at most one is shown per refresh
+*/
+static void TestImmediate(const Workload& _workload)
+{
+	PresentPolicyClass policy;
+	double frameTime = static_cast<double>(_workload.cpuTime + _workload.gpuTime) / 1000.0;
+
+	RunResult tearing = Run(PRESENT_MODE_IMMEDIATE, 3, 1, true, _workload, true, policy);
+	TEST_CHECK(tearing.dropped == 0);
+	TEST_CHECK(tearing.averageLatency * 1000.0 <= frameTime * 1000.0 + TIME_TOLERANCE);
+
+	RunResult noTearing = Run(PRESENT_MODE_IMMEDIATE, 3, 2, false, _workload, true, policy);
+	TEST_CHECK(noTearing.dropped > 0);
+	TEST_CHECK(noTearing.shown <= noTearing.endTime / REFRESH_TIME + 1);
+
+	printf("immediate: %.2f ms with tearing, %.2f ms without, %llu of %u dropped\n", tearing.averageLatency, noTearing.averageLatency, noTearing.dropped, FRAME_COUNT);
+}
+
+/*
+	Frames which take longer than a refresh miss every other refresh with vsync, variable refresh shows them when they are done
+	Faster frames are held back to the refresh rate
+*/
+static void TestVariableRefresh(const Workload& _fast, const Workload& _slow)
+{
+	PresentPolicyClass policy;
+
+	double slowFrameTime = static_cast<double>(_slow.cpuTime + _slow.gpuTime) / 1000.0;
+	RunResult vsync = Run(PRESENT_MODE_VSYNC, 3, 1, true, _slow, true, policy);
+	RunResult variableRefresh = Run(PRESENT_MODE_VARIABLE_REFRESH, 3, 1, true, _slow, true, policy);
+	printf("slow frames: vsync %.2f ms, variable refresh %.2f ms\n", vsync.averageLatency, variableRefresh.averageLatency);
+	TEST_CHECK(variableRefresh.averageLatency * 1000.0 <= slowFrameTime * 1000.0 + TIME_TOLERANCE);
+	TEST_CHECK(variableRefresh.averageLatency < vsync.averageLatency);
+
+	//	The display can not refresh faster than its refresh rate, so the presents run at that rate too and each one waits for the refresh
+	RunResult fast = Run(PRESENT_MODE_VARIABLE_REFRESH, 3, 1, true, _fast, true, policy);
+	TEST_CHECK((fast.shown - 1) * (REFRESH_TIME - 1) <= fast.endTime + REFRESH_TIME);
+	TEST_CHECK(fast.averageLatency * 1000.0 >= REFRESH_TIME - 100 && fast.averageLatency * 1000.0 <= REFRESH_TIME + TIME_TOLERANCE);
+
+	//	Without tearing support variable refresh is vsync
+	PresentSettings settings = { PRESENT_MODE_VARIABLE_REFRESH, 3, 2, REFRESH_RATE };
+	TEST_CHECK(policy.Initialize(settings, false));
+	TEST_CHECK(policy.GetMode() == PRESENT_MODE_VSYNC && !policy.AllowTearing() && policy.GetSyncInterval() == 1);
+	policy.Shutdown();
+}
+
+/*
+	With vsync every queued present adds a refresh of latency, waiting for room before sampling the input keeps it at the frame latency
+	Without the wait the CPU blocks in Present and samples the input one refresh earlier, with every buffer queued
+*/
+static void TestFrameLatency(const Workload& _fast)
+{
+	PresentPolicyClass policy;
+
+	double latency1 = Run(PRESENT_MODE_VSYNC, 3, 1, true, _fast, true, policy).averageLatency;
+	double latency2 = Run(PRESENT_MODE_VSYNC, 3, 2, true, _fast, true, policy).averageLatency;
+	double blocking = Run(PRESENT_MODE_VSYNC, 3, 2, true, _fast, false, policy).averageLatency;
+	printf("vsync with 3 buffers: %.2f ms at frame latency 1, %.2f ms at frame latency 2, %.2f ms when only Present blocks\n", latency1, latency2, blocking);
+
+	TEST_CHECK(latency1 * 1000.0 <= REFRESH_TIME + TIME_TOLERANCE);
+	TEST_CHECK(latency2 * 1000.0 <= 2 * REFRESH_TIME + TIME_TOLERANCE);
+	TEST_CHECK(latency1 < latency2 && latency2 < blocking);
+
+	//	The frame latency is limited by the buffers which are not on screen
+	PresentSettings settings = { PRESENT_MODE_VSYNC, 2, 3, REFRESH_RATE };
+	TEST_CHECK(policy.Initialize(settings, true));
+	TEST_CHECK(policy.GetFrameLatency() == 1);
+	settings.bufferCount = 5;
+	TEST_CHECK(!policy.Initialize(settings, true));
+	policy.Shutdown();
+}
+
+int main()
+{
+	Workload workloads[2] = {
+		{ "fast", 3000, 5000 },
+		{ "slow", 6000, 20000 }
+	};
+
+	TestModes(workloads, 2);
+	TestImmediate(workloads[0]);
+	TestVariableRefresh(workloads[0], workloads[1]);
+	TestFrameLatency(workloads[0]);
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
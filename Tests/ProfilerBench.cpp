@@ -0,0 +1,352 @@
+#include "TestClass.h"
+#include "ProfilerClass.h"
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#pragma region Globals
+static const unsigned int ZONE_COUNT = 1000000;
+static const unsigned int NESTED_CALLS = 100;
+static const unsigned int CAPTURE_THREADS = 4;
+static const unsigned int SHORT_LIVED_THREADS = MAX_PROFILER_THREADS * 3;
+static const char* CAPTURE_PATH = "ProfilerBench.json";
+
+static volatile unsigned int Sink = 0;
+#pragma endregion
+
+/*
+	Minimal recursive descent JSON parser, only checks the syntax and counts the objects with a "ph" member (the trace events)
+*/
+class JsonReader
+{
+public:
+	explicit JsonReader(const char* _text)
+	{
+		m_text = _text;
+		m_events = 0;
+	}
+
+	bool Parse()
+	{
+		SkipSpace();
+		if (!ParseValue())
+		{
+			return false;
+		}
+
+		SkipSpace();
+		return *m_text == '\0';
+	}
+
+	unsigned int GetEventCount() const
+	{
+		return m_events;
+	}
+
+private:
+	const char* m_text;
+	unsigned int m_events;
+
+	void SkipSpace()
+	{
+		while (*m_text == ' ' || *m_text == '\n' || *m_text == '\r' || *m_text == '\t')
+		{
+			m_text++;
+		}
+	}
+
+	bool ParseValue()
+	{
+		if (*m_text == '{')
+		{
+			return ParseObject();
+		}
+		if (*m_text == '[')
+		{
+			return ParseArray();
+		}
+		if (*m_text == '"')
+		{
+			return ParseString(nullptr);
+		}
+
+		return ParseNumber();
+	}
+
+	bool ParseObject()
+	{
+		m_text++;
+		SkipSpace();
+		if (*m_text == '}')
+		{
+			m_text++;
+			return true;
+		}
+
+		for (;;)
+		{
+			bool phase = false;
+			if (!ParseString(&phase))
+			{
+				return false;
+			}
+			m_events += phase ? 1 : 0;
+
+			SkipSpace();
+			if (*m_text++ != ':')
+			{
+				return false;
+			}
+
+			SkipSpace();
+			if (!ParseValue())
+			{
+				return false;
+			}
+
+			SkipSpace();
+			if (*m_text == '}')
+			{
+				m_text++;
+				return true;
+			}
+			if (*m_text++ != ',')
+			{
+				return false;
+			}
+			SkipSpace();
+		}
+	}
+
+	bool ParseArray()
+	{
+		m_text++;
+		SkipSpace();
+		if (*m_text == ']')
+		{
+			m_text++;
+			return true;
+		}
+
+		for (;;)
+		{
+			if (!ParseValue())
+			{
+				return false;
+			}
+
+			SkipSpace();
+			if (*m_text == ']')
+			{
+				m_text++;
+				return true;
+			}
+			if (*m_text++ != ',')
+			{
+				return false;
+			}
+			SkipSpace();
+		}
+	}
+
+	//	_phase is set if the string is the key "ph"
+	bool ParseString(bool* _phase)
+	{
+		if (*m_text != '"')
+		{
+			return false;
+		}
+
+		const char* start = ++m_text;
+		while (*m_text != '"')
+		{
+			if (*m_text == '\0' || *m_text == '\n' || *m_text == '\\')
+			{
+				return false;
+			}
+			m_text++;
+		}
+
+		if (_phase)
+		{
+			*_phase = m_text - start == 2 && strncmp(start, "ph", 2) == 0;
+		}
+
+		m_text++;
+		return true;
+	}
+
+	bool ParseNumber()
+	{
+		char* end = nullptr;
+		strtod(m_text, &end);
+		if (end == m_text)
+		{
+			return false;
+		}
+
+		m_text = end;
+		return true;
+	}
+};
+
+/*
+	Cost of an empty loop and of the same loop with a zone in every iteration, in nanoseconds per iteration
+	The zones of the loop do not fit in the buffer of the thread, the oldest ones are overwritten like in a frame nobody collects
+*/
+static void MeasureZoneCost()
+{
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ZONE_COUNT; i++)
+	{
+		Sink = Sink + i;
+	}
+	double emptyLoop = TestClass::GetMilliseconds(start);
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ZONE_COUNT; i++)
+	{
+		PROFILE_SCOPE("Zone");
+		Sink = Sink + i;
+	}
+	double zoneLoop = TestClass::GetMilliseconds(start);
+
+	ProfilerClass::EndFrame();
+	TEST_CHECK(ProfilerClass::GetZoneCount() == 1);
+	TEST_CHECK(ProfilerClass::GetZone(0).callCount == PROFILER_EVENTS_PER_THREAD);
+
+	printf("%u iterations: %.2f ms empty, %.2f ms with a zone, %.1f ns per zone\n", ZONE_COUNT, emptyLoop, zoneLoop, (zoneLoop - emptyLoop) * 1000000.0 / ZONE_COUNT);
+}
+
+static void Inner()
+{
+	PROFILE_SCOPE("Inner");
+	Sink = Sink + 1;
+}
+
+static void Middle()
+{
+	PROFILE_SCOPE("Middle");
+	Inner();
+	Inner();
+}
+
+static void Outer()
+{
+	PROFILE_SCOPE("Outer");
+	for (unsigned int i = 0; i < NESTED_CALLS; i++)
+	{
+		Middle();
+	}
+}
+
+/*
+	The summary of a frame lists the parents before their children, with their depth and calls
+*/
+static void TestNesting()
+{
+	Outer();
+	ProfilerClass::EndFrame();
+
+	TEST_CHECK(ProfilerClass::GetZoneCount() == 3);
+	if (ProfilerClass::GetZoneCount() != 3)
+	{
+		return;
+	}
+
+	const ProfilerZoneSummary& outer = ProfilerClass::GetZone(0);
+	const ProfilerZoneSummary& middle = ProfilerClass::GetZone(1);
+	const ProfilerZoneSummary& inner = ProfilerClass::GetZone(2);
+
+	TEST_CHECK(strcmp(outer.name, "Outer") == 0 && outer.depth == 0 && outer.callCount == 1);
+	TEST_CHECK(strcmp(middle.name, "Middle") == 0 && middle.depth == 1 && middle.callCount == NESTED_CALLS);
+	TEST_CHECK(strcmp(inner.name, "Inner") == 0 && inner.depth == 2 && inner.callCount == NESTED_CALLS * 2);
+	TEST_CHECK(outer.totalTime >= middle.totalTime && middle.totalTime >= inner.totalTime);
+
+	//	A frame without zones has an empty summary
+	ProfilerClass::EndFrame();
+	TEST_CHECK(ProfilerClass::GetZoneCount() == 0);
+}
+
+/*
+	A capture with zones of several threads and a named track has to be valid JSON with one event per zone and track name
+*/
+static void TestCapture()
+{
+	TEST_CHECK(ProfilerClass::BeginCapture(CAPTURE_PATH));
+	TEST_CHECK(!ProfilerClass::BeginCapture(CAPTURE_PATH));
+
+	unsigned int track = ProfilerClass::CreateTrack("GPU");
+	TEST_CHECK(track < MAX_PROFILER_THREADS);
+	unsigned long long now = ProfilerClass::GetTicks();
+	ProfilerClass::AddZone(track, "Pass", now, now + 1000, 0);
+
+	Outer();
+
+	std::thread threads[CAPTURE_THREADS];
+	for (unsigned int i = 0; i < CAPTURE_THREADS; i++)
+	{
+		threads[i] = std::thread(Middle);
+	}
+	for (unsigned int i = 0; i < CAPTURE_THREADS; i++)
+	{
+		threads[i].join();
+	}
+
+	ProfilerClass::EndCapture();
+
+	FILE* file = fopen(CAPTURE_PATH, "rb");
+	TEST_CHECK(file != nullptr);
+	if (!file)
+	{
+		return;
+	}
+
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char* text = new char[size + 1];
+	size_t read = fread(text, 1, size, file);
+	text[read] = '\0';
+	fclose(file);
+	remove(CAPTURE_PATH);
+
+	JsonReader reader(text);
+	TEST_CHECK(reader.Parse());
+
+	unsigned int zones = 1 + (1 + NESTED_CALLS * 3) + CAPTURE_THREADS * 3;
+	TEST_CHECK(reader.GetEventCount() == zones + 1);
+	TEST_CHECK(strstr(text, "\"thread_name\"") != nullptr);
+	printf("capture of %u zones: %ld bytes of valid JSON\n", zones, size);
+
+	delete[] text;
+}
+
+/*
+	Threads give their slot back when they exit
+	Many more short-lived threads than slots are all recorded, none of them is left without a slot
+*/
+static void TestShortLivedThreads()
+{
+	for (unsigned int i = 0; i < SHORT_LIVED_THREADS; i++)
+	{
+		std::thread thread(Inner);
+		thread.join();
+	}
+
+	ProfilerClass::EndFrame();
+	TEST_CHECK(ProfilerClass::GetZoneCount() == 1);
+	TEST_CHECK(ProfilerClass::GetZoneCount() == 1 && ProfilerClass::GetZone(0).callCount == SHORT_LIVED_THREADS);
+	TEST_CHECK(ProfilerClass::GetUnprofiledThreadCount() == 0);
+}
+
+int main()
+{
+	MeasureZoneCost();
+	TestNesting();
+	TestCapture();
+	TestShortLivedThreads();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
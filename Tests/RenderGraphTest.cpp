@@ -0,0 +1,211 @@
+#include "TestClass.h"
+#include "RenderGraphClass.h"
+#include "SimulatedCommandRecorderClass.h"
+
+#pragma region Globals
+static const size_t MEGABYTE = 1024 * 1024;
+static const size_t RESOURCE_ALIGNMENT = 64 * 1024;
+static const unsigned int CHAIN_PASSES = 16;
+static const unsigned int SCALING_CHAINS[] = { 8, 16, 32, MAX_RENDER_GRAPH_PASSES - 1 };		// the longest chain and its copy fill the graph
+static const unsigned int SCALING_CHAIN_COUNT = sizeof(SCALING_CHAINS) / sizeof(SCALING_CHAINS[0]);
+static const unsigned int COMPILE_RUNS = 2000;
+static const unsigned int COMPILE_BATCHES = 5;
+static const double MAX_PER_PASS_GROWTH = 3.0;		// compile time per pass of the longest chain against the shortest, linear growth stays near 1
+#pragma endregion
+
+static int BackBuffer;
+static int Resources[MAX_RENDER_GRAPH_RESOURCES];
+
+/*
+	Two transient resources which are alive in the same pass must not share memory
+*/
+static bool Overlaps(const RenderGraphClass& _graph, unsigned int _a, size_t _sizeA, unsigned int _b, size_t _sizeB)
+{
+	size_t offsetA = _graph.GetResourceOffset(_a);
+	size_t offsetB = _graph.GetResourceOffset(_b);
+
+	return offsetA < offsetB + _sizeB && offsetB < offsetA + _sizeA;
+}
+
+/*
+	Record the compiled graph and count the barriers the backend would see
+*/
+static unsigned long long CountRecordedBarriers(const RenderGraphClass& _graph)
+{
+	SimulatedCommandRecorderClass recorder;
+	for (unsigned int i = 0; i < _graph.GetCompiledPassCount(); i++)
+	{
+		_graph.ExecutePass(i, &recorder);
+	}
+
+	return recorder.GetBarrierCount();
+}
+
+/*
+	A deferred frame: gbuffer and depth, lighting into an HDR target, bloom, tonemapping into the back buffer, and a debug pass nobody reads
+	Barriers per pass: lighting turns the gbuffer and the depth into read states, bloom reads the HDR target and aliases the gbuffer memory,
+	tonemapping reads the bloom target and writes the back buffer, the back buffer goes back to present at the end
+	Consecutive reads of the HDR target (bloom, tonemapping) share one transition
+*/
+static void TestDeferredFrame()
+{
+	RenderGraphClass* graph = new RenderGraphClass();
+	graph->Reset();
+
+	unsigned int backBuffer = graph->ImportResource("BackBuffer", &BackBuffer, RESOURCE_STATE_PRESENT, RESOURCE_STATE_PRESENT);
+	unsigned int gbuffer = graph->CreateTransientResource("GBuffer", 8 * MEGABYTE, RESOURCE_ALIGNMENT);
+	unsigned int depth = graph->CreateTransientResource("Depth", 4 * MEGABYTE, RESOURCE_ALIGNMENT);
+	unsigned int hdr = graph->CreateTransientResource("Hdr", 8 * MEGABYTE, RESOURCE_ALIGNMENT);
+	unsigned int bloom = graph->CreateTransientResource("Bloom", 2 * MEGABYTE, RESOURCE_ALIGNMENT);
+	unsigned int debug = graph->CreateTransientResource("Debug", 1 * MEGABYTE, RESOURCE_ALIGNMENT);
+	for (unsigned int i = 1; i <= debug; i++)
+	{
+		graph->SetResourceHandle(i, &Resources[i]);
+	}
+
+	unsigned int geometryPass = graph->AddPass("Geometry", nullptr, nullptr);
+	TEST_CHECK(graph->Write(geometryPass, gbuffer, RESOURCE_STATE_RENDER_TARGET));
+	TEST_CHECK(graph->Write(geometryPass, depth, RESOURCE_STATE_DEPTH_WRITE));
+
+	unsigned int debugPass = graph->AddPass("Debug", nullptr, nullptr);
+	TEST_CHECK(graph->Read(debugPass, depth, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Write(debugPass, debug, RESOURCE_STATE_RENDER_TARGET));
+
+	unsigned int lightingPass = graph->AddPass("Lighting", nullptr, nullptr);
+	TEST_CHECK(graph->Read(lightingPass, gbuffer, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Read(lightingPass, depth, RESOURCE_STATE_DEPTH_READ | RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Write(lightingPass, hdr, RESOURCE_STATE_RENDER_TARGET));
+
+	unsigned int bloomPass = graph->AddPass("Bloom", nullptr, nullptr);
+	TEST_CHECK(graph->Read(bloomPass, hdr, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Write(bloomPass, bloom, RESOURCE_STATE_RENDER_TARGET));
+
+	unsigned int tonemapPass = graph->AddPass("Tonemap", nullptr, nullptr);
+	TEST_CHECK(graph->Read(tonemapPass, hdr, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Read(tonemapPass, bloom, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Write(tonemapPass, backBuffer, RESOURCE_STATE_RENDER_TARGET));
+
+	TEST_CHECK(graph->Compile());
+
+	printf("deferred frame: %u passes, %u culled, %u barriers in %u batches, transient memory %zu of %zu bytes\n", graph->GetCompiledPassCount(),
+		graph->GetCulledPassCount(), graph->GetBarrierCount(), graph->GetBarrierBatchCount(), graph->GetTransientMemorySize(), graph->GetTransientMemorySizeWithoutAliasing());
+
+	TEST_CHECK(graph->GetCompiledPassCount() == 4);
+	TEST_CHECK(graph->GetCulledPassCount() == 1);
+	TEST_CHECK(graph->GetBarrierCount() == 7);
+	TEST_CHECK(graph->GetBarrierBatchCount() == 4);
+	TEST_CHECK(CountRecordedBarriers(*graph) == graph->GetBarrierCount());
+
+	//	Geometry targets live in passes 0 - 1, the HDR target in 1 - 3, the bloom target in 2 - 3
+	TEST_CHECK(!Overlaps(*graph, gbuffer, 8 * MEGABYTE, depth, 4 * MEGABYTE));
+	TEST_CHECK(!Overlaps(*graph, gbuffer, 8 * MEGABYTE, hdr, 8 * MEGABYTE));
+	TEST_CHECK(!Overlaps(*graph, depth, 4 * MEGABYTE, hdr, 8 * MEGABYTE));
+	TEST_CHECK(!Overlaps(*graph, hdr, 8 * MEGABYTE, bloom, 2 * MEGABYTE));
+	TEST_CHECK(graph->GetTransientMemorySizeWithoutAliasing() == 22 * MEGABYTE);
+	TEST_CHECK(graph->GetTransientMemorySize() == 20 * MEGABYTE);
+
+	delete graph;
+}
+
+/*
+	A chain of post processing passes, each one reads the target of the pass before and writes a new one
+	A copy pass at the end reads the last target and writes the back buffer
+*/
+static void BuildChain(RenderGraphClass* _graph, unsigned int _passes)
+{
+	RenderGraphClass* graph = _graph;
+	graph->Reset();
+
+	unsigned int backBuffer = graph->ImportResource("BackBuffer", &BackBuffer, RESOURCE_STATE_PRESENT, RESOURCE_STATE_PRESENT);
+	unsigned int previous = INVALID_RENDER_GRAPH_HANDLE;
+	for (unsigned int i = 0; i < _passes; i++)
+	{
+		unsigned int target = graph->CreateTransientResource("Target", 4 * MEGABYTE, RESOURCE_ALIGNMENT);
+		graph->SetResourceHandle(target, &Resources[target]);
+
+		unsigned int pass = graph->AddPass("Post", nullptr, nullptr);
+		if (previous != INVALID_RENDER_GRAPH_HANDLE)
+		{
+			TEST_CHECK(graph->Read(pass, previous, RESOURCE_STATE_SHADER_RESOURCE));
+		}
+		TEST_CHECK(graph->Write(pass, target, RESOURCE_STATE_RENDER_TARGET));
+
+		previous = target;
+	}
+
+	unsigned int presentPass = graph->AddPass("Copy", nullptr, nullptr);
+	TEST_CHECK(graph->Read(presentPass, previous, RESOURCE_STATE_SHADER_RESOURCE));
+	TEST_CHECK(graph->Write(presentPass, backBuffer, RESOURCE_STATE_RENDER_TARGET));
+}
+
+/*
+	Only two targets of the chain are ever alive at the same time, so aliasing needs two targets worth of memory no matter how long the chain is
+*/
+static void TestPostProcessChain()
+{
+	RenderGraphClass* graph = new RenderGraphClass();
+	BuildChain(graph, CHAIN_PASSES);
+
+	TEST_CHECK(graph->Compile());
+
+	printf("post chain of %u passes: %u barriers in %u batches, transient memory %zu of %zu bytes\n", CHAIN_PASSES, graph->GetBarrierCount(),
+		graph->GetBarrierBatchCount(), graph->GetTransientMemorySize(), graph->GetTransientMemorySizeWithoutAliasing());
+
+	//	Every pass but the first transitions the previous target to a read state, from the third pass on a target reuses the memory of an older one,
+	//	the copy reads the last target and writes the back buffer, which goes back to present at the end
+	TEST_CHECK(graph->GetCompiledPassCount() == CHAIN_PASSES + 1);
+	TEST_CHECK(graph->GetBarrierCount() == (CHAIN_PASSES - 1) + (CHAIN_PASSES - 2) + 2 + 1);
+	TEST_CHECK(CountRecordedBarriers(*graph) == graph->GetBarrierCount());
+	TEST_CHECK(graph->GetTransientMemorySize() == 2 * 4 * MEGABYTE);
+	TEST_CHECK(graph->GetTransientMemorySizeWithoutAliasing() == CHAIN_PASSES * 4 * MEGABYTE);
+
+	delete graph;
+}
+
+/*
+	Compile runs every frame, its time has to grow linearly with the passes of the graph
+	Time the best of COMPILE_BATCHES batches of COMPILE_RUNS compiles of chains of growing length, the time per pass of the longest chain may only be a little above the shortest
+*/
+static void TestCompileScaling()
+{
+	RenderGraphClass* graph = new RenderGraphClass();
+	double perPass[SCALING_CHAIN_COUNT];
+
+	for (unsigned int i = 0; i < SCALING_CHAIN_COUNT; i++)
+	{
+		BuildChain(graph, SCALING_CHAINS[i]);
+
+		double milliseconds = 0.0;
+		for (unsigned int batch = 0; batch < COMPILE_BATCHES; batch++)
+		{
+			unsigned int compiled = 0;
+			unsigned long long start = TimerClass::GetMicroseconds();
+			for (unsigned int run = 0; run < COMPILE_RUNS; run++)
+			{
+				compiled += graph->Compile() ? 1 : 0;
+			}
+			double batchMilliseconds = TestClass::GetMilliseconds(start) / COMPILE_RUNS;
+
+			TEST_CHECK(compiled == COMPILE_RUNS);
+			milliseconds = batch == 0 || batchMilliseconds < milliseconds ? batchMilliseconds : milliseconds;
+		}
+
+		TEST_CHECK(graph->GetCompiledPassCount() == SCALING_CHAINS[i] + 1);
+		perPass[i] = milliseconds * 1000.0 / (SCALING_CHAINS[i] + 1);
+
+		printf("compile of a chain of %u passes: %.4f ms, %.3f us per pass\n", SCALING_CHAINS[i], milliseconds, perPass[i]);
+	}
+
+	TEST_CHECK(perPass[SCALING_CHAIN_COUNT - 1] < perPass[0] * MAX_PER_PASS_GROWTH);
+
+	delete graph;
+}
+
+int main()
+{
+	TestDeferredFrame();
+	TestPostProcessChain();
+	TestCompileScaling();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "TestClass.h"
+#include "SceneFileClass.h"
+#include "CookerClass.h"
+#include "HashClass.h"
+#include "JsonClass.h"
+#include "SceneCookerClass.h"
+#include <cstdio>
+#include <cstring>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#pragma region Globals
+static const unsigned int OBJECT_COUNT = 200000;
+static const unsigned int MESH_COUNT = 64;
+static const float WORLD_SIZE = 4000.0f;
+static const char* const JSON_PATH = "SceneLoadBench.json";
+static const char* const SCENE_PATH = "SceneLoadBench.scene";
+static const char* const COOKED_SCENE_PATH = "SceneLoadBenchCooked.scene";
+static const char* const BROKEN_SCENE_PATH = "SceneLoadBenchBroken.scene";
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run writes the same scene
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+/*
+	Bytes of the process in memory, heap as well as the mapped pages which were touched
+	Only Linux reports it here, elsewhere the benchmark prints 0
+*/
+static unsigned long long GetResidentBytes()
+{
+#ifdef _WIN32
+	return 0;
+#else
+	unsigned long long pages = 0;
+	unsigned long long residentPages = 0;
+	FILE* file = fopen("/proc/self/statm", "r");
+	if (file)
+	{
+		if (fscanf(file, "%llu %llu", &pages, &residentPages) != 2)
+		{
+			residentPages = 0;
+		}
+		fclose(file);
+	}
+
+	return residentPages * static_cast<unsigned long long>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+static double ToMegabytes(unsigned long long _bytes)
+{
+	return static_cast<double>(_bytes) / (1024.0 * 1024.0);
+}
+
+static void GetMeshName(unsigned int _mesh, char* _name, size_t _size)
+{
+	snprintf(_name, _size, "Meshes/Rock%u.obj", _mesh);
+}
+
+/*
+	Props scattered over an open world, every one with its own transform, bounds, mesh and material
+	_meshes keeps the mesh of every object, the objects only have the hash of its name
+*/
+static void CreateObjects(SceneObject* _objects, unsigned int* _meshes)
+{
+	unsigned int random = 1234;
+	char name[64];
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		SceneObject& object = _objects[i];
+		object.position = { NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f), NextRandom(random, 0.0f, 50.0f),
+			NextRandom(random, -WORLD_SIZE * 0.5f, WORLD_SIZE * 0.5f) };
+		object.rotation = MathClass::QuaternionFromAxisAngle(Vector3{ 0.0f, 1.0f, 0.0f }, NextRandom(random, 0.0f, 6.28f));
+		float scale = NextRandom(random, 0.5f, 2.0f);
+		object.scale = { scale, scale, scale };
+		object.boundsCenter = object.position;
+		object.boundsExtent = { scale * 2.0f, scale * 3.0f, scale * 2.0f };
+
+		_meshes[i] = static_cast<unsigned int>(NextRandom(random, 0.0f, static_cast<float>(MESH_COUNT)));
+		GetMeshName(_meshes[i], name, sizeof(name));
+		object.meshId = HashClass::Hash(name, strlen(name));
+		object.material = static_cast<unsigned int>(NextRandom(random, 0.0f, 256.0f));
+	}
+}
+
+/*
+	The same objects in the JSON format SceneCookerClass reads, the floats with enough digits to read back exactly
+*/
+static bool WriteJson(const SceneObject* _objects, const unsigned int* _meshes)
+{
+	FILE* file = fopen(JSON_PATH, "wb");
+	if (!file)
+	{
+		return false;
+	}
+
+	char name[64];
+	fprintf(file, "{\n\t\"objects\": [\n");
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		const SceneObject& object = _objects[i];
+		GetMeshName(_meshes[i], name, sizeof(name));
+
+		fprintf(file, "\t\t{ \"position\": [%.9g, %.9g, %.9g], \"rotation\": [%.9g, %.9g, %.9g, %.9g], \"scale\": [%.9g, %.9g, %.9g], ",
+			object.position.x, object.position.y, object.position.z, object.rotation.x, object.rotation.y, object.rotation.z, object.rotation.w,
+			object.scale.x, object.scale.y, object.scale.z);
+		fprintf(file, "\"boundsCenter\": [%.9g, %.9g, %.9g], \"boundsExtent\": [%.9g, %.9g, %.9g], \"mesh\": \"%s\", \"material\": %u }%s\n",
+			object.boundsCenter.x, object.boundsCenter.y, object.boundsCenter.z, object.boundsExtent.x, object.boundsExtent.y, object.boundsExtent.z,
+			name, object.material, i + 1 < OBJECT_COUNT ? "," : "");
+	}
+	fprintf(file, "\t]\n}\n");
+
+	return fclose(file) == 0;
+}
+
+/*
+	The arrays a loaded scene ends up in, the same SoA layout the binary file has
+*/
+struct SceneArrays
+{
+	float* floats;			// position xyz, rotation xyzw, scale xyz, bounds center xyz, bounds extent xyz
+	unsigned long long* meshIds;
+	unsigned int* materials;
+};
+
+static float* GetArray(const SceneArrays& _arrays, unsigned int _component)
+{
+	return _arrays.floats + static_cast<size_t>(_component) * OBJECT_COUNT;
+}
+
+/*
+	The numbers of the member go into the arrays from _component on, at element _index
+	Returns false unless the member is an array of exactly _count numbers
+*/
+static bool ReadFloats(const JsonClass& _json, const JsonValue* _object, const char* _key, unsigned int _count, const SceneArrays& _arrays, unsigned int _component,
+	unsigned int _index)
+{
+	const JsonValue* array = _json.Find(_object, _key);
+	if (!array || array->type != JSON_ARRAY || array->childCount != _count)
+	{
+		return false;
+	}
+
+	unsigned int count = 0;
+	for (const JsonValue* value = _json.GetElement(array, 0); value; value = _json.GetNext(value))
+	{
+		GetArray(_arrays, _component + count)[_index] = static_cast<float>(value->number);
+		count++;
+	}
+
+	return true;
+}
+
+/*
+	What loading the JSON scene costs: read the file, parse it and fill the arrays
+	_peakResident is how much the process grew while the text and the document were alive
+*/
+static bool LoadJson(SceneArrays& _arrays, unsigned long long& _peakResident)
+{
+	unsigned long long resident = GetResidentBytes();
+
+	size_t size = 0;
+	unsigned char* text = CookerClass::ReadFile(JSON_PATH, size);
+	JsonClass json;
+	if (!text || !json.Parse(reinterpret_cast<const char*>(text), size))
+	{
+		delete[] text;
+		return false;
+	}
+
+	_arrays.floats = new float[static_cast<size_t>(OBJECT_COUNT) * 16];
+	_arrays.meshIds = new unsigned long long[OBJECT_COUNT];
+	_arrays.materials = new unsigned int[OBJECT_COUNT];
+
+	const JsonValue* objects = json.Find(json.GetRoot(), "objects");
+	unsigned int objectCount = 0;
+	unsigned int wrong = 0;
+	for (const JsonValue* object = objects ? json.GetElement(objects, 0) : nullptr; object && objectCount < OBJECT_COUNT; object = json.GetNext(object))
+	{
+		wrong += !ReadFloats(json, object, "position", 3, _arrays, 0, objectCount) ? 1 : 0;
+		wrong += !ReadFloats(json, object, "rotation", 4, _arrays, 3, objectCount) ? 1 : 0;
+		wrong += !ReadFloats(json, object, "scale", 3, _arrays, 7, objectCount) ? 1 : 0;
+		wrong += !ReadFloats(json, object, "boundsCenter", 3, _arrays, 10, objectCount) ? 1 : 0;
+		wrong += !ReadFloats(json, object, "boundsExtent", 3, _arrays, 13, objectCount) ? 1 : 0;
+
+		const JsonValue* mesh = json.Find(object, "mesh");
+		_arrays.meshIds[objectCount] = mesh ? HashClass::Hash(mesh->string, mesh->stringLength) : 0;
+		_arrays.materials[objectCount] = static_cast<unsigned int>(json.GetNumber(object, "material", 0.0));
+		objectCount++;
+	}
+
+	unsigned long long peak = GetResidentBytes();
+	_peakResident = peak > resident ? peak - resident : 0;
+
+	json.Release();
+	delete[] text;
+
+	return wrong == 0 && objectCount == OBJECT_COUNT;
+}
+
+/*
+	The float of the object in the order of SceneArrays::floats
+*/
+static float GetComponent(const SceneObject& _object, unsigned int _component)
+{
+	if (_component < 3)
+	{
+		return (&_object.position.x)[_component];
+	}
+	if (_component < 7)
+	{
+		return (&_object.rotation.x)[_component - 3];
+	}
+	if (_component < 10)
+	{
+		return (&_object.scale.x)[_component - 7];
+	}
+	if (_component < 13)
+	{
+		return (&_object.boundsCenter.x)[_component - 10];
+	}
+
+	return (&_object.boundsExtent.x)[_component - 13];
+}
+
+/*
+	Loaded values which are not bit for bit the ones the objects were written with
+*/
+static unsigned int CountWrongFloat(const float* _values, unsigned int _component, const SceneObject* _objects)
+{
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		float expected = GetComponent(_objects[i], _component);
+		wrong += memcmp(&_values[i], &expected, sizeof(float)) != 0 ? 1 : 0;
+	}
+
+	return wrong;
+}
+
+static unsigned int CountWrongMeshes(const unsigned long long* _meshIds, const unsigned int* _materials, const SceneObject* _objects)
+{
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < OBJECT_COUNT; i++)
+	{
+		wrong += _meshIds[i] != _objects[i].meshId || _materials[i] != _objects[i].material ? 1 : 0;
+	}
+
+	return wrong;
+}
+
+/*
+	Every array of the mapped file against the objects it was written from
+*/
+static unsigned int CountWrongSections(SceneFileClass& _scene, const SceneObject* _objects)
+{
+	const SceneTransformSection* transforms = _scene.GetTransforms();
+	const SceneBoundsSection* bounds = _scene.GetBounds();
+	const SceneMeshSection* meshes = _scene.GetMeshes();
+	if (!transforms || !bounds || !meshes)
+	{
+		return OBJECT_COUNT;
+	}
+
+	const RelativePointer<float>* transformArrays = &transforms->positionX;
+	const RelativePointer<float>* boundsArrays = &bounds->centerX;
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < 10; i++)
+	{
+		wrong += CountWrongFloat(transformArrays[i].Get(), i, _objects);
+	}
+	for (unsigned int i = 0; i < 6; i++)
+	{
+		wrong += CountWrongFloat(boundsArrays[i].Get(), 10 + i, _objects);
+	}
+
+	return wrong + CountWrongMeshes(meshes->meshIds.Get(), meshes->materials.Get(), _objects);
+}
+
+/*
+	The cooker turns the JSON scene into exactly the file SceneFileClass::Write gives for the same objects
+*/
+static void TestCooker()
+{
+	unsigned int objectCount = 0;
+	TEST_CHECK(SceneCookerClass::Cook(JSON_PATH, COOKED_SCENE_PATH, objectCount));
+	TEST_CHECK(objectCount == OBJECT_COUNT);
+
+	size_t size = 0;
+	size_t cookedSize = 0;
+	unsigned char* data = CookerClass::ReadFile(SCENE_PATH, size);
+	unsigned char* cooked = CookerClass::ReadFile(COOKED_SCENE_PATH, cookedSize);
+	TEST_CHECK(data && cooked && size == cookedSize && memcmp(data, cooked, size) == 0);
+
+	delete[] cooked;
+	delete[] data;
+	remove(COOKED_SCENE_PATH);
+}
+
+/*
+	A byte flipped in the mesh section leaves the file usable, only that section fails its check on first touch
+	A file which is shorter than its header says does not open
+*/
+static void TestBrokenFile()
+{
+	size_t size = 0;
+	unsigned char* data = CookerClass::ReadFile(SCENE_PATH, size);
+	TEST_CHECK(data && size > sizeof(SceneFileHeader));
+	if (!data)
+	{
+		return;
+	}
+
+	const SceneFileHeader* header = reinterpret_cast<const SceneFileHeader*>(data);
+	const SceneSectionEntry* sections = reinterpret_cast<const SceneSectionEntry*>(data + sizeof(SceneFileHeader));
+	for (unsigned int i = 0; i < header->sectionCount; i++)
+	{
+		if (sections[i].type == SCENE_SECTION_MESHES)
+		{
+			data[sections[i].offset + sections[i].size / 2] ^= 0x01;
+		}
+	}
+
+	FILE* file = fopen(BROKEN_SCENE_PATH, "wb");
+	if (file)
+	{
+		fwrite(data, 1, size, file);
+		fclose(file);
+	}
+
+	SceneFileClass scene;
+	TEST_CHECK(scene.Open(BROKEN_SCENE_PATH));
+	TEST_CHECK(scene.GetBounds() && scene.GetTransforms());
+	TEST_CHECK(!scene.GetMeshes() && !scene.IsSectionLoaded(SCENE_SECTION_MESHES));
+	scene.Close();
+
+	file = fopen(BROKEN_SCENE_PATH, "wb");
+	if (file)
+	{
+		fwrite(data, 1, size - SCENE_SECTION_ALIGNMENT, file);
+		fclose(file);
+	}
+	TEST_CHECK(!scene.Open(BROKEN_SCENE_PATH));
+
+	delete[] data;
+	remove(BROKEN_SCENE_PATH);
+}
+
+int main()
+{
+	SceneObject* objects = new SceneObject[OBJECT_COUNT];
+	unsigned int* meshes = new unsigned int[OBJECT_COUNT];
+	CreateObjects(objects, meshes);
+	TEST_CHECK(WriteJson(objects, meshes));
+	delete[] meshes;
+	TEST_CHECK(SceneFileClass::Write(SCENE_PATH, objects, OBJECT_COUNT));
+
+	size_t jsonSize = 0;
+	size_t sceneSize = 0;
+	delete[] CookerClass::ReadFile(JSON_PATH, jsonSize);
+	delete[] CookerClass::ReadFile(SCENE_PATH, sceneSize);
+
+	//	Both files were just written, so both load from a warm page cache
+	SceneArrays arrays = {};
+	unsigned long long jsonResident = 0;
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(LoadJson(arrays, jsonResident));
+	double jsonTime = TestClass::GetMilliseconds(start);
+
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < 16; i++)
+	{
+		wrong += CountWrongFloat(GetArray(arrays, i), i, objects);
+	}
+	wrong += CountWrongMeshes(arrays.meshIds, arrays.materials, objects);
+	TEST_CHECK(wrong == 0);
+
+	delete[] arrays.materials;
+	delete[] arrays.meshIds;
+	delete[] arrays.floats;
+
+	//	Opening only reads the header and the index table, a section becomes resident when it is touched
+	SceneFileClass scene;
+	unsigned long long resident = GetResidentBytes();
+	start = TimerClass::GetMicroseconds();
+	TEST_CHECK(scene.Open(SCENE_PATH));
+	double openTime = TestClass::GetMilliseconds(start);
+	unsigned long long openResident = GetResidentBytes() - resident;
+
+	TEST_CHECK(scene.GetObjectCount() == OBJECT_COUNT);
+	TEST_CHECK(!scene.IsSectionLoaded(SCENE_SECTION_TRANSFORMS) && !scene.IsSectionLoaded(SCENE_SECTION_BOUNDS) && !scene.IsSectionLoaded(SCENE_SECTION_MESHES));
+
+	start = TimerClass::GetMicroseconds();
+	TEST_CHECK(scene.GetBounds() != nullptr);
+	double boundsTime = TestClass::GetMilliseconds(start);
+	unsigned long long boundsResident = GetResidentBytes() - resident;
+	TEST_CHECK(scene.IsSectionLoaded(SCENE_SECTION_BOUNDS) && !scene.IsSectionLoaded(SCENE_SECTION_TRANSFORMS) && !scene.IsSectionLoaded(SCENE_SECTION_MESHES));
+
+	start = TimerClass::GetMicroseconds();
+	TEST_CHECK(scene.GetTransforms() && scene.GetMeshes());
+	double sectionsTime = boundsTime + TestClass::GetMilliseconds(start);
+	unsigned long long sectionsResident = GetResidentBytes() - resident;
+
+	TEST_CHECK(CountWrongSections(scene, objects) == 0);
+	scene.Close();
+
+	printf("json: %u objects, %.1f MB, loaded in %.1f ms, +%.1f MB resident at peak\n", OBJECT_COUNT, ToMegabytes(jsonSize), jsonTime, ToMegabytes(jsonResident));
+	printf("binary: %.1f MB, open %.3f ms (+%.2f MB), bounds %.2f ms (+%.1f MB), all sections %.2f ms (+%.1f MB)\n", ToMegabytes(sceneSize), openTime,
+		ToMegabytes(openResident), boundsTime, ToMegabytes(boundsResident), sectionsTime, ToMegabytes(sectionsResident));
+	printf("json / binary: %.1fx the time\n", jsonTime / (openTime + sectionsTime));
+
+	TEST_CHECK(sceneSize < jsonSize);
+	TEST_CHECK(openTime + sectionsTime < jsonTime);
+
+	TestCooker();
+	TestBrokenFile();
+
+	remove(SCENE_PATH);
+	remove(JSON_PATH);
+	delete[] objects;
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
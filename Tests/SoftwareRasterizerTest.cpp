@@ -0,0 +1,328 @@
+#include "TestClass.h"
+#include "SoftwareRasterizerClass.h"
+#include <cstring>
+
+#pragma region Globals
+static const unsigned int WIDTH = 256;
+static const unsigned int HEIGHT = 256;
+static const unsigned int MAX_TRIANGLES = 65536;
+static const unsigned int GRID_SIZE = 16;		// cells per axis, two triangles per cell
+static const float GRID_EXTENT = 0.8f;			// the grid covers -0.8 .. 0.8 in NDC
+static const unsigned int BENCH_WIDTH = 1280;
+static const unsigned int BENCH_HEIGHT = 720;
+static const unsigned int BENCH_TRIANGLES = 200000;
+static const float CLEAR_COLOR[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+#pragma endregion
+
+/*
+	Small deterministic generator, so every run draws the same triangles
+*/
+static float NextRandom(unsigned int& _state, float _minimum, float _maximum)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _minimum + (_maximum - _minimum) * static_cast<float>(_state >> 8) / 16777216.0f;
+}
+
+/*
+	FNV-1a over the visible pixels, the padding of the rows is left out
+*/
+static unsigned long long HashImage(const SoftwareRasterizerClass& _rasterizer)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for (unsigned int y = 0; y < _rasterizer.GetHeight(); y++)
+	{
+		const unsigned char* row = reinterpret_cast<const unsigned char*>(_rasterizer.GetColorBuffer() + y * _rasterizer.GetStride());
+		for (unsigned int i = 0; i < _rasterizer.GetWidth() * 4; i++)
+		{
+			hash = (hash ^ row[i]) * 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
+
+/*
+	A grid of GRID_SIZE x GRID_SIZE cells in NDC, the inner vertices are moved randomly so the edges run in every direction
+	Every triangle gets its own color and depth
+*/
+struct Grid
+{
+	SoftwareVertex vertices[(GRID_SIZE + 1) * (GRID_SIZE + 1)];
+	unsigned int indices[GRID_SIZE * GRID_SIZE * 6];
+};
+
+static void CreateGrid(Grid& _grid)
+{
+	unsigned int random = 2024;
+	float cell = GRID_EXTENT * 2.0f / GRID_SIZE;
+	for (unsigned int y = 0; y <= GRID_SIZE; y++)
+	{
+		for (unsigned int x = 0; x <= GRID_SIZE; x++)
+		{
+			bool inner = x > 0 && x < GRID_SIZE && y > 0 && y < GRID_SIZE;
+			SoftwareVertex& vertex = _grid.vertices[y * (GRID_SIZE + 1) + x];
+			vertex.x = -GRID_EXTENT + x * cell + (inner ? NextRandom(random, -0.3f, 0.3f) * cell : 0.0f);
+			vertex.y = -GRID_EXTENT + y * cell + (inner ? NextRandom(random, -0.3f, 0.3f) * cell : 0.0f);
+			vertex.z = NextRandom(random, 0.1f, 0.9f);
+			vertex.color = static_cast<unsigned int>(NextRandom(random, 0.0f, 16777215.0f)) | 0xFF000000;
+		}
+	}
+
+	//	Clockwise on screen, the front face
+	unsigned int* index = _grid.indices;
+	for (unsigned int y = 0; y < GRID_SIZE; y++)
+	{
+		for (unsigned int x = 0; x < GRID_SIZE; x++)
+		{
+			unsigned int corner = y * (GRID_SIZE + 1) + x;
+			unsigned int quad[6] = { corner, corner + GRID_SIZE + 1, corner + 1, corner + 1, corner + GRID_SIZE + 1, corner + GRID_SIZE + 2 };
+			memcpy(index, quad, sizeof(quad));
+			index += 6;
+		}
+	}
+}
+
+static unsigned int CountCoveredPixels(const SoftwareRasterizerClass& _rasterizer)
+{
+	unsigned int count = 0;
+	for (unsigned int y = 0; y < HEIGHT; y++)
+	{
+		for (unsigned int x = 0; x < WIDTH; x++)
+		{
+			count += (_rasterizer.GetColorBuffer()[y * _rasterizer.GetStride() + x] & 0x00FFFFFF) != 0 ? 1 : 0;
+		}
+	}
+
+	return count;
+}
+
+/*
+	Draw every triangle of the grid alone and count how often each pixel is covered
+	Shared edges must neither leave gaps nor cover a pixel twice: every pixel whose center lies inside the grid is covered exactly once
+*/
+static void TestWatertight(SoftwareRasterizerClass& _rasterizer, const Grid& _grid, const Matrix4& _identity)
+{
+	unsigned char* coverage = new unsigned char[WIDTH * HEIGHT];
+	memset(coverage, 0, WIDTH * HEIGHT);
+
+	SoftwareVertex white[(GRID_SIZE + 1) * (GRID_SIZE + 1)];
+	memcpy(white, _grid.vertices, sizeof(white));
+	for (SoftwareVertex& vertex : white)
+	{
+		vertex.color = 0xFFFFFFFF;
+	}
+
+	for (unsigned int i = 0; i < GRID_SIZE * GRID_SIZE * 6; i += 3)
+	{
+		_rasterizer.Clear(CLEAR_COLOR, 1.0f);
+		TEST_CHECK(_rasterizer.DrawTriangles(white, (GRID_SIZE + 1) * (GRID_SIZE + 1), _grid.indices + i, 3, _identity, PIPELINE_CULL_BACK));
+		_rasterizer.Present();
+
+		for (unsigned int y = 0; y < HEIGHT; y++)
+		{
+			for (unsigned int x = 0; x < WIDTH; x++)
+			{
+				coverage[y * WIDTH + x] += (_rasterizer.GetColorBuffer()[y * _rasterizer.GetStride() + x] & 0xFF) != 0 ? 1 : 0;
+			}
+		}
+	}
+
+	//	The outer border lies at 25.6 and 230.4 pixels, the centers of the pixels 26 - 229 are inside
+	unsigned int first = static_cast<unsigned int>((0.5f - GRID_EXTENT * 0.5f) * WIDTH - 0.5f) + 1;
+	unsigned int last = static_cast<unsigned int>((0.5f + GRID_EXTENT * 0.5f) * WIDTH - 0.5f);
+	unsigned int gaps = 0;
+	unsigned int doubles = 0;
+	unsigned int outside = 0;
+	for (unsigned int y = 0; y < HEIGHT; y++)
+	{
+		for (unsigned int x = 0; x < WIDTH; x++)
+		{
+			bool inside = x >= first && x <= last && y >= first && y <= last;
+			gaps += inside && coverage[y * WIDTH + x] == 0 ? 1 : 0;
+			doubles += coverage[y * WIDTH + x] > 1 ? 1 : 0;
+			outside += !inside && coverage[y * WIDTH + x] > 0 ? 1 : 0;
+		}
+	}
+
+	printf("watertight: %u triangles, %u gaps, %u pixels covered twice, %u pixels outside\n", GRID_SIZE * GRID_SIZE * 2, gaps, doubles, outside);
+	TEST_CHECK(gaps == 0);
+	TEST_CHECK(doubles == 0);
+	TEST_CHECK(outside == 0);
+
+	delete[] coverage;
+}
+
+/*
+	The tiles are rasterized on the jobsystem, the image must not depend on the amount of workers
+	The triangles overlap at different depths, the depth test has to give the same image whatever order they are drawn in
+*/
+static unsigned long long RenderOverlapping(JobSystemClass* _jobSystem, bool _reversed)
+{
+	SoftwareRasterizerClass* rasterizer = new SoftwareRasterizerClass();
+	TEST_CHECK(rasterizer->Initialize(WIDTH, HEIGHT, MAX_TRIANGLES, _jobSystem));
+
+	const unsigned int triangleCount = 2000;
+	SoftwareVertex* vertices = new SoftwareVertex[triangleCount * 3];
+	unsigned int random = 55;
+	for (unsigned int i = 0; i < triangleCount; i++)
+	{
+		float centerX = NextRandom(random, -1.2f, 1.2f);
+		float centerY = NextRandom(random, -1.2f, 1.2f);
+		float depth = (i + 1.0f) / (triangleCount + 1.0f);
+		unsigned int color = static_cast<unsigned int>(NextRandom(random, 0.0f, 16777215.0f)) | 0xFF000000;
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			vertices[i * 3 + j] = { centerX + NextRandom(random, -0.2f, 0.2f), centerY + NextRandom(random, -0.2f, 0.2f), depth, color };
+		}
+	}
+
+	Matrix4 identity = MathClass::Identity();
+	rasterizer->Clear(CLEAR_COLOR, 1.0f);
+	for (unsigned int i = 0; i < triangleCount; i++)
+	{
+		unsigned int triangle = _reversed ? triangleCount - 1 - i : i;
+		TEST_CHECK(rasterizer->DrawTriangles(vertices + triangle * 3, 3, nullptr, 3, identity, PIPELINE_CULL_NONE));
+	}
+	rasterizer->Present();
+
+	unsigned long long hash = HashImage(*rasterizer);
+
+	delete[] vertices;
+	rasterizer->Shutdown();
+	delete rasterizer;
+
+	return hash;
+}
+
+/*
+	Back faces are dropped with PIPELINE_CULL_BACK, front faces with PIPELINE_CULL_FRONT, nothing with PIPELINE_CULL_NONE
+*/
+static void TestCulling(SoftwareRasterizerClass& _rasterizer, const Matrix4& _identity)
+{
+	SoftwareVertex front[3] = { { -0.5f, -0.5f, 0.5f, 0xFFFFFFFF }, { 0.0f, 0.5f, 0.5f, 0xFFFFFFFF }, { 0.5f, -0.5f, 0.5f, 0xFFFFFFFF } };
+	SoftwareVertex back[3] = { front[0], front[2], front[1] };
+
+	unsigned int covered[2][3];
+	const SoftwareVertex* triangles[2] = { front, back };
+	const unsigned int cullModes[3] = { PIPELINE_CULL_BACK, PIPELINE_CULL_FRONT, PIPELINE_CULL_NONE };
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		for (unsigned int j = 0; j < 3; j++)
+		{
+			_rasterizer.Clear(CLEAR_COLOR, 1.0f);
+			TEST_CHECK(_rasterizer.DrawTriangles(triangles[i], 3, nullptr, 3, _identity, cullModes[j]));
+			_rasterizer.Present();
+			covered[i][j] = CountCoveredPixels(_rasterizer);
+		}
+	}
+
+	TEST_CHECK(covered[0][0] > 0 && covered[0][1] == 0 && covered[0][2] == covered[0][0]);
+	TEST_CHECK(covered[1][0] == 0 && covered[1][1] == covered[0][0] && covered[1][2] == covered[0][0]);
+}
+
+/*
+	A floor reaching from in front of the camera to behind it is clipped at the near plane instead of being dropped or wrapping around
+*/
+static void TestNearClipping(SoftwareRasterizerClass& _rasterizer)
+{
+	Matrix4 view = MathClass::LookAt(Vector3{ 0.0f, 1.0f, 0.0f }, Vector3{ 0.0f, 1.0f, 1.0f }, Vector3{ 0.0f, 1.0f, 0.0f });
+	Matrix4 viewProjection = MathClass::Multiply(view, MathClass::Perspective(1.5f, 1.0f, 0.1f, 100.0f));
+	SoftwareVertex floor[4] = { { -10.0f, 0.0f, -10.0f, 0xFF00FF00 }, { -10.0f, 0.0f, 50.0f, 0xFF00FF00 }, { 10.0f, 0.0f, 50.0f, 0xFF00FF00 },
+		{ 10.0f, 0.0f, -10.0f, 0xFF00FF00 } };
+	unsigned int indices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	_rasterizer.Clear(CLEAR_COLOR, 1.0f);
+	TEST_CHECK(_rasterizer.DrawTriangles(floor, 4, indices, 6, viewProjection, PIPELINE_CULL_NONE));
+	_rasterizer.Present();
+
+	//	The floor fills the lower half of the screen up to the horizon, nothing above it
+	unsigned int covered = CountCoveredPixels(_rasterizer);
+	unsigned int above = 0;
+	float worstDepth = 0.0f;
+	for (unsigned int y = 0; y < HEIGHT; y++)
+	{
+		for (unsigned int x = 0; x < WIDTH; x++)
+		{
+			bool pixel = (_rasterizer.GetColorBuffer()[y * _rasterizer.GetStride() + x] & 0x00FFFFFF) != 0;
+			above += pixel && y < HEIGHT / 2 ? 1 : 0;
+			float depth = _rasterizer.GetDepthBuffer()[y * _rasterizer.GetStride() + x];
+			worstDepth = depth < 0.0f || depth > 1.0f ? depth : worstDepth;
+		}
+	}
+
+	printf("near clipping: %u pixels of the floor, %u above the horizon\n", covered, above);
+	TEST_CHECK(covered > WIDTH * HEIGHT / 2 - WIDTH * 8);
+	TEST_CHECK(above == 0);
+	TEST_CHECK(worstDepth == 0.0f);
+}
+
+/*
+	Many small triangles over a 720p screen, the throughput the software backend reaches with the jobsystem
+*/
+static void MeasureThroughput(JobSystemClass* _jobSystem)
+{
+	SoftwareRasterizerClass* rasterizer = new SoftwareRasterizerClass();
+	TEST_CHECK(rasterizer->Initialize(BENCH_WIDTH, BENCH_HEIGHT, MAX_TRIANGLES, _jobSystem));
+
+	SoftwareVertex* vertices = new SoftwareVertex[BENCH_TRIANGLES * 3];
+	unsigned int random = 8;
+	float size = 8.0f / BENCH_HEIGHT;		// about 26 pixels per triangle
+	for (unsigned int i = 0; i < BENCH_TRIANGLES; i++)
+	{
+		float x = NextRandom(random, -1.0f, 1.0f);
+		float y = NextRandom(random, -1.0f, 1.0f);
+		float z = NextRandom(random, 0.0f, 1.0f);
+		vertices[i * 3 + 0] = { x, y, z, 0xFF0000FF };
+		vertices[i * 3 + 1] = { x + size * 0.5f, y + size, z, 0xFF00FF00 };
+		vertices[i * 3 + 2] = { x + size, y, z, 0xFFFF0000 };
+	}
+
+	Matrix4 identity = MathClass::Identity();
+	unsigned long long start = TimerClass::GetMicroseconds();
+	rasterizer->Clear(CLEAR_COLOR, 1.0f);
+	TEST_CHECK(rasterizer->DrawTriangles(vertices, BENCH_TRIANGLES * 3, nullptr, BENCH_TRIANGLES * 3, identity, PIPELINE_CULL_NONE));
+	rasterizer->Present();
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	printf("throughput: %llu triangles of about 26 pixels in %.1f ms, %.2f million triangles per second\n", rasterizer->GetRasterizedTriangleCount(),
+		milliseconds, rasterizer->GetRasterizedTriangleCount() / (milliseconds * 1000.0));
+	TEST_CHECK(rasterizer->GetRasterizedTriangleCount() > BENCH_TRIANGLES * 9 / 10);
+
+	delete[] vertices;
+	rasterizer->Shutdown();
+	delete rasterizer;
+}
+
+int main()
+{
+	JobSystemClass oneWorker;
+	JobSystemClass threeWorkers;
+	TEST_CHECK(oneWorker.Initialize(1));
+	TEST_CHECK(threeWorkers.Initialize(3));
+
+	SoftwareRasterizerClass* rasterizer = new SoftwareRasterizerClass();
+	TEST_CHECK(rasterizer->Initialize(WIDTH, HEIGHT, MAX_TRIANGLES, &threeWorkers));
+	Matrix4 identity = MathClass::Identity();
+
+	Grid* grid = new Grid();
+	CreateGrid(*grid);
+	TestWatertight(*rasterizer, *grid, identity);
+	TestCulling(*rasterizer, identity);
+	TestNearClipping(*rasterizer);
+
+	unsigned long long hashes[4] = { RenderOverlapping(nullptr, false), RenderOverlapping(&oneWorker, false), RenderOverlapping(&threeWorkers, false),
+		RenderOverlapping(&threeWorkers, true) };
+	printf("image hashes: %016llx (calling thread), %016llx (1 worker), %016llx (3 workers), %016llx (reversed order)\n", hashes[0], hashes[1], hashes[2], hashes[3]);
+	TEST_CHECK(hashes[0] == hashes[1] && hashes[0] == hashes[2]);
+	TEST_CHECK(hashes[0] == hashes[3]);
+
+	MeasureThroughput(&threeWorkers);
+
+	delete grid;
+	rasterizer->Shutdown();
+	delete rasterizer;
+	threeWorkers.Shutdown();
+	oneWorker.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
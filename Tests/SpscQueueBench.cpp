@@ -0,0 +1,128 @@
+#include "TestClass.h"
+#include "SpscQueueClass.h"
+#include <mutex>
+#include <thread>
+
+#pragma region Globals
+static const unsigned int ITEM_COUNT = 2000000;
+static const unsigned int QUEUE_CAPACITY = 1024;
+#pragma endregion
+
+/*
+	The same ring as SpscQueueClass behind a mutex, the baseline the lock-free queue is measured against
+*/
+class LockedQueue
+{
+public:
+	LockedQueue()
+	{
+		m_head = 0;
+		m_tail = 0;
+	}
+
+	bool Push(unsigned int _item)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		unsigned int nextTail = (m_tail + 1) & (QUEUE_CAPACITY - 1);
+		if (nextTail == m_head)
+		{
+			return false;
+		}
+
+		m_items[m_tail] = _item;
+		m_tail = nextTail;
+
+		return true;
+	}
+
+	bool Pop(unsigned int& _item)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_head == m_tail)
+		{
+			return false;
+		}
+
+		_item = m_items[m_head];
+		m_head = (m_head + 1) & (QUEUE_CAPACITY - 1);
+
+		return true;
+	}
+
+private:
+	std::mutex m_mutex;
+	unsigned int m_items[QUEUE_CAPACITY];
+	unsigned int m_head;
+	unsigned int m_tail;
+};
+
+/*
+	One producer pushes 0 .. ITEM_COUNT - 1, the consumer has to see every item exactly once and in order
+	Both yield while the ring is full or empty, so the benchmark also works with a single core
+*/
+template<typename Queue>
+static double MeasureThroughput(const char* _name)
+{
+	Queue* queue = new Queue();
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+
+	std::thread producer([queue]()
+	{
+		for (unsigned int i = 0; i < ITEM_COUNT; i++)
+		{
+			while (!queue->Push(i))
+			{
+				std::this_thread::yield();
+			}
+		}
+	});
+
+	unsigned int expected = 0;
+	unsigned int outOfOrder = 0;
+	while (expected < ITEM_COUNT)
+	{
+		unsigned int item;
+		if (!queue->Pop(item))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		outOfOrder += item != expected ? 1 : 0;
+		expected++;
+	}
+
+	producer.join();
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	unsigned int item;
+	TEST_CHECK(outOfOrder == 0);
+	TEST_CHECK(!queue->Pop(item));
+
+	double itemsPerSecond = ITEM_COUNT / (milliseconds * 0.001);
+	printf("%s: %u items in %.1f ms, %.1f million items per second\n", _name, ITEM_COUNT, milliseconds, itemsPerSecond * 0.000001);
+
+	delete queue;
+
+	return itemsPerSecond;
+}
+
+int main()
+{
+	//	A full ring rejects the push, an empty one the pop
+	SpscQueueClass<unsigned int, 4>* small = new SpscQueueClass<unsigned int, 4>();
+	unsigned int item;
+	TEST_CHECK(!small->Pop(item));
+	TEST_CHECK(small->Push(1) && small->Push(2) && small->Push(3));
+	TEST_CHECK(!small->Push(4));
+	TEST_CHECK(small->Pop(item) && item == 1);
+	TEST_CHECK(small->Push(4));
+	delete small;
+
+	double lockFree = MeasureThroughput<SpscQueueClass<unsigned int, QUEUE_CAPACITY>>("SpscQueueClass");
+	double locked = MeasureThroughput<LockedQueue>("mutex queue");
+	printf("lock-free / mutex: %.2fx\n", lockFree / locked);
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
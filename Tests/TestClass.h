@@ -0,0 +1,52 @@
+#pragma once
+
+#pragma region includes
+#include <cstdio>
+#include "TimerClass.h"
+#pragma endregion
+
+/*
+	Minimal checks for the test and benchmark executables of the portable build
+	A failed check prints where it failed and marks the run as failed, the test keeps running so one run shows every failure
+	main returns TestClass::GetResult(), ctest treats everything but 0 as a failure
+*/
+class TestClass
+{
+public:
+	static bool Check(bool _condition, const char* _expression, const char* _file, int _line)
+	{
+		if (!_condition)
+		{
+			printf("FAILED %s:%d: %s\n", _file, _line, _expression);
+			Failures()++;
+		}
+
+		return _condition;
+	}
+
+	static int GetResult()
+	{
+		if (Failures() > 0)
+		{
+			printf("%u checks failed\n", Failures());
+			return 1;
+		}
+
+		return 0;
+	}
+
+	//	Milliseconds since _start, _start in microseconds of TimerClass
+	static double GetMilliseconds(unsigned long long _start)
+	{
+		return static_cast<double>(TimerClass::GetMicroseconds() - _start) * 0.001;
+	}
+
+private:
+	static unsigned int& Failures()
+	{
+		static unsigned int failures = 0;
+		return failures;
+	}
+};
+
+#define TEST_CHECK(_condition) TestClass::Check((_condition), #_condition, __FILE__, __LINE__)
\ No newline at end of file
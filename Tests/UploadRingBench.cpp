@@ -0,0 +1,236 @@
+#include "TestClass.h"
+#include "UploadRingClass.h"
+#include "SimulatedFenceClass.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#pragma region Globals
+static const size_t SMALL_RING_SIZE = 1024;
+static const double GPU_LATENCY = 20.0;			// milliseconds the simulated GPU needs for a submission in the blocking test
+static const size_t RING_SIZE = 4 * 1024 * 1024;
+static const size_t FRAME_UPLOAD_SIZE = 1536 * 1024;	// bytes uploaded per frame, the ring holds less than three frames
+static const size_t MIN_UPLOAD_SIZE = 64;
+static const size_t MAX_UPLOAD_SIZE = 64 * 1024;
+static const size_t UPLOAD_ALIGNMENT = 256;
+static const unsigned int FRAME_COUNT = 200;
+static const double GPU_FRAME_TIME = 1.0;		// milliseconds the simulated GPU needs for the uploads of a frame
+static const unsigned int MAX_ALLOCATIONS = 200000;
+#pragma endregion
+
+static unsigned char SmallRing[SMALL_RING_SIZE];
+
+/*
+	Small deterministic generator, so every run uploads the same sizes
+*/
+static unsigned int NextRandom(unsigned int& _state)
+{
+	_state = _state * 1664525u + 1013904223u;
+	return _state >> 8;
+}
+
+static unsigned long long GetNanoseconds()
+{
+	return static_cast<unsigned long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/*
+	Allocations are aligned, and one which does not fit in front of the end skips the rest and starts at the beginning
+	The skipped bytes count as used until the submission they belong to is reclaimed
+*/
+static void TestWrapAround()
+{
+	SimulatedFenceClass fence;
+	UploadRingClass ring;
+	TEST_CHECK(ring.Initialize(SmallRing, SMALL_RING_SIZE, &fence));
+
+	size_t offset = 0;
+	void* cpuAddress = nullptr;
+
+	TEST_CHECK(ring.Allocate(100, 1, offset, cpuAddress));
+	TEST_CHECK(offset == 0 && cpuAddress == SmallRing);
+
+	//	Every alignment is honored, the address matches the offset
+	const size_t alignments[] = { 4, 16, 64, 256 };
+	for (size_t alignment : alignments)
+	{
+		TEST_CHECK(ring.Allocate(10, alignment, offset, cpuAddress));
+		TEST_CHECK(offset % alignment == 0);
+		TEST_CHECK(cpuAddress == SmallRing + offset);
+	}
+	TEST_CHECK(offset == 256);
+	TEST_CHECK(ring.GetUsed() == 266);
+
+	ring.Submit(1);
+	TEST_CHECK(fence.Signal(1));
+	TEST_CHECK(ring.GetPendingSize() == 0);
+
+	//	266 + 512 fit in front of the end, the next 512 do not and start at the beginning behind 246 skipped bytes
+	TEST_CHECK(ring.Allocate(512, 256, offset, cpuAddress));
+	TEST_CHECK(offset == 512);
+	ring.Submit(2);
+	TEST_CHECK(fence.Signal(2));
+
+	TEST_CHECK(ring.Allocate(200, 256, offset, cpuAddress));
+	TEST_CHECK(offset == 0);
+	TEST_CHECK(ring.GetUsed() == 200);
+	TEST_CHECK(ring.GetPendingSize() == 200);
+	TEST_CHECK(ring.GetWaitCount() == 0);
+
+	ring.Shutdown();
+}
+
+/*
+	Without free memory an allocation waits for the oldest submission, the GPU has to finish it first
+*/
+static void TestBlocking()
+{
+	SimulatedFenceClass fence;
+	fence.SetLatency(GPU_LATENCY);
+
+	UploadRingClass ring;
+	TEST_CHECK(ring.Initialize(SmallRing, SMALL_RING_SIZE, &fence));
+
+	size_t offset = 0;
+	void* cpuAddress = nullptr;
+
+	TEST_CHECK(ring.Allocate(600, 1, offset, cpuAddress));
+	ring.Submit(1);
+	TEST_CHECK(fence.Signal(1));
+
+	TEST_CHECK(ring.Allocate(300, 1, offset, cpuAddress));
+	ring.Submit(2);
+	TEST_CHECK(fence.Signal(2));
+
+	//	Does not fit behind the second submission, the first one has to be done
+	unsigned long long start = TimerClass::GetMicroseconds();
+	TEST_CHECK(ring.Allocate(400, 1, offset, cpuAddress));
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(offset == 0);
+	TEST_CHECK(ring.GetWaitCount() == 1);
+	TEST_CHECK(fence.GetCompletedValue() >= 1);
+	TEST_CHECK(milliseconds > GPU_LATENCY * 0.5);
+
+	printf("allocation behind a pending submission waited %.2f ms for the GPU (%.0f ms per submission)\n", milliseconds, GPU_LATENCY);
+
+	ring.Shutdown();
+}
+
+/*
+	Memory which is not submitted can not be reclaimed, waiting would never end, so the allocation fails
+*/
+static void TestFailure()
+{
+	SimulatedFenceClass fence;
+	UploadRingClass ring;
+	TEST_CHECK(!ring.Initialize(nullptr, SMALL_RING_SIZE, &fence));
+	TEST_CHECK(!ring.Initialize(SmallRing, SMALL_RING_SIZE, nullptr));
+	TEST_CHECK(ring.Initialize(SmallRing, SMALL_RING_SIZE, &fence));
+
+	size_t offset = 0;
+	void* cpuAddress = nullptr;
+
+	TEST_CHECK(!ring.Allocate(SMALL_RING_SIZE + 1, 1, offset, cpuAddress));
+	TEST_CHECK(!ring.Allocate(0, 1, offset, cpuAddress));
+	TEST_CHECK(!ring.Allocate(16, 3, offset, cpuAddress));
+
+	TEST_CHECK(ring.Allocate(1000, 1, offset, cpuAddress));
+	TEST_CHECK(!ring.Allocate(100, 1, offset, cpuAddress));
+	TEST_CHECK(ring.GetWaitCount() == 0);
+	TEST_CHECK(ring.GetPendingSize() == 1000);
+
+	//	Once it is submitted, the same allocation waits and succeeds
+	ring.Submit(1);
+	TEST_CHECK(fence.Signal(1));
+	TEST_CHECK(ring.Allocate(100, 1, offset, cpuAddress));
+	TEST_CHECK(offset == 0);
+
+	ring.Shutdown();
+}
+
+/*
+	Upload FRAME_UPLOAD_SIZE bytes of random sized allocations per frame into a ring which holds less than three frames
+	The simulated GPU needs GPU_FRAME_TIME per frame, so the CPU runs ahead until the ring is full and then waits in Allocate
+	Print the throughput and the latency of the single allocations
+*/
+static void MeasureThroughput()
+{
+	unsigned char* memory = new unsigned char[RING_SIZE];
+	unsigned char* source = new unsigned char[MAX_UPLOAD_SIZE];
+	memset(source, 0x5A, MAX_UPLOAD_SIZE);
+
+	unsigned long long* latencies = new unsigned long long[MAX_ALLOCATIONS];
+	unsigned int allocationCount = 0;
+
+	SimulatedFenceClass fence;
+	fence.SetLatency(GPU_FRAME_TIME);
+
+	UploadRingClass ring;
+	TEST_CHECK(ring.Initialize(memory, RING_SIZE, &fence));
+
+	unsigned int random = 12345;
+	unsigned long long uploaded = 0;
+	unsigned int misaligned = 0;
+	unsigned int failed = 0;
+	unsigned long long start = TimerClass::GetMicroseconds();
+
+	for (unsigned int frame = 1; frame <= FRAME_COUNT; frame++)
+	{
+		size_t frameUploaded = 0;
+		while (frameUploaded < FRAME_UPLOAD_SIZE && allocationCount < MAX_ALLOCATIONS)
+		{
+			size_t size = MIN_UPLOAD_SIZE + NextRandom(random) % (MAX_UPLOAD_SIZE - MIN_UPLOAD_SIZE);
+
+			size_t offset = 0;
+			void* cpuAddress = nullptr;
+			unsigned long long allocationStart = GetNanoseconds();
+			bool allocated = ring.Allocate(size, UPLOAD_ALIGNMENT, offset, cpuAddress);
+			latencies[allocationCount] = GetNanoseconds() - allocationStart;
+			allocationCount++;
+
+			if (!allocated)
+			{
+				failed++;
+				break;
+			}
+
+			misaligned += offset % UPLOAD_ALIGNMENT != 0 || offset + size > RING_SIZE ? 1 : 0;
+			memcpy(cpuAddress, source, size);
+			frameUploaded += size;
+		}
+
+		ring.Submit(frame);
+		TEST_CHECK(fence.Signal(frame));
+		uploaded += frameUploaded;
+	}
+
+	double milliseconds = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(failed == 0);
+	TEST_CHECK(misaligned == 0);
+	TEST_CHECK(ring.GetUsed() <= RING_SIZE);
+	TEST_CHECK(ring.GetWaitCount() > 0);
+	TEST_CHECK(fence.WaitForValue(FRAME_COUNT));
+
+	std::sort(latencies, latencies + allocationCount);
+	printf("%u frames, %u allocations: %.1f MB/s with the GPU at %.1f ms per frame, %llu waits\n", FRAME_COUNT, allocationCount,
+		static_cast<double>(uploaded) / (1024.0 * 1024.0) / (milliseconds * 0.001), GPU_FRAME_TIME, ring.GetWaitCount());
+	printf("Allocate latency: median %llu ns, 99th percentile %llu ns, max %.3f ms\n", latencies[allocationCount / 2],
+		latencies[allocationCount * 99 / 100], static_cast<double>(latencies[allocationCount - 1]) * 0.000001);
+
+	ring.Shutdown();
+	delete[] latencies;
+	delete[] source;
+	delete[] memory;
+}
+
+int main()
+{
+	TestWrapAround();
+	TestBlocking();
+	TestFailure();
+	MeasureThroughput();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file
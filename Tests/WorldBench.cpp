@@ -0,0 +1,257 @@
+#include "TestClass.h"
+#include "WorldClass.h"
+#include "MemoryTrackerClass.h"
+#include <cmath>
+
+#pragma region Globals
+static const unsigned int ENTITY_COUNT = 1000000;
+static const unsigned int MAX_CHUNKS = 4096;
+static const unsigned int UPDATE_COUNT = 10;
+static const double TIMESTEP = 1.0 / 60.0;
+static const unsigned int WORKER_COUNT = 2;
+#pragma endregion
+
+struct Vector
+{
+	float x;
+	float y;
+	float z;
+};
+
+/*
+	The same data the way an object oriented engine would keep it: one object per entity with everything it has next to each other
+	The update touches 24 of its bytes, the rest is dragged through the cache with them
+*/
+struct GameObject
+{
+	Vector position;
+	Vector velocity;
+	float health;
+	unsigned int flags;
+	char name[32];
+	float transform[16];
+};
+
+struct Components
+{
+	unsigned int position;
+	unsigned int velocity;
+	unsigned int health;
+};
+
+static void MoveSystem(const EntityChunk& _chunk, double _timestep, void* _data)
+{
+	const Components* components = static_cast<const Components*>(_data);
+	Vector* positions = _chunk.GetComponents<Vector>(components->position);
+	const Vector* velocities = _chunk.GetComponents<Vector>(components->velocity);
+	float timestep = static_cast<float>(_timestep);
+
+	for (unsigned int i = 0; i < _chunk.count; i++)
+	{
+		positions[i].x += velocities[i].x * timestep;
+		positions[i].y += velocities[i].y * timestep;
+		positions[i].z += velocities[i].z * timestep;
+	}
+}
+
+static Vector GetVelocity(unsigned int _index)
+{
+	return { static_cast<float>(_index % 7), 1.0f, static_cast<float>(_index % 3) };
+}
+
+/*
+	UPDATE_COUNT updates of the move system over all entities, half of them have health as well so the query matches two archetypes
+	Returns milliseconds per update
+*/
+static double MeasureWorld(JobSystemClass* _jobSystem, const char* _name)
+{
+	FrameAllocatorClass frameAllocator;
+	TEST_CHECK(frameAllocator.Initialize(FRAME_MEMORY_SIZE, 2));
+
+	WorldClass* world = new WorldClass();
+	TEST_CHECK(world->Initialize(ENTITY_COUNT, MAX_CHUNKS, _jobSystem, &frameAllocator));
+
+	Components components;
+	components.position = world->RegisterComponent<Vector>("Position");
+	components.velocity = world->RegisterComponent<Vector>("Velocity");
+	components.health = world->RegisterComponent<float>("Health");
+
+	ComponentMask moving = (1ULL << components.position) | (1ULL << components.velocity);
+	Entity* entities = new Entity[ENTITY_COUNT];
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		entities[i] = world->CreateEntity(i % 2 == 0 ? moving : moving | (1ULL << components.health));
+		*world->GetComponent<Vector>(entities[i], components.position) = { 0.0f, 0.0f, 0.0f };
+		*world->GetComponent<Vector>(entities[i], components.velocity) = GetVelocity(i);
+	}
+	TEST_CHECK(world->GetEntityCount() == ENTITY_COUNT);
+
+	EntityQuery query = { moving, 0 };
+	world->AddSystem("Move", query, 1ULL << components.position, MoveSystem, &components);
+
+	unsigned long long allocations = MemoryTrackerClass::GetAllocationCount();
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < UPDATE_COUNT; i++)
+	{
+		TEST_CHECK(world->Update(TIMESTEP));
+		frameAllocator.EndFrame();
+	}
+	double milliseconds = TestClass::GetMilliseconds(start) / UPDATE_COUNT;
+
+	//	The jobs of the updates come from the frame allocator
+	TEST_CHECK(MemoryTrackerClass::GetAllocationCount() == allocations);
+
+	//	Every entity moved UPDATE_COUNT times by its velocity
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < ENTITY_COUNT; i += 997)
+	{
+		Vector position = *world->GetComponent<Vector>(entities[i], components.position);
+		float expected = GetVelocity(i).x * static_cast<float>(TIMESTEP) * UPDATE_COUNT;
+		wrong += fabsf(position.x - expected) > 0.001f || fabsf(position.y - static_cast<float>(TIMESTEP) * UPDATE_COUNT) > 0.001f ? 1 : 0;
+	}
+	TEST_CHECK(wrong == 0);
+
+	printf("%s: %u entities in %u chunks, %.2f ms per update (%.2f ns per entity)\n", _name, ENTITY_COUNT, world->GetUsedChunkCount(), milliseconds,
+		milliseconds * 1000000.0 / ENTITY_COUNT);
+
+	delete[] entities;
+	world->Shutdown();
+	delete world;
+	frameAllocator.Shutdown();
+
+	return milliseconds;
+}
+
+/*
+	Create ENTITY_COUNT entities, move every one to another archetype and back by adding and removing a component, then destroy them all
+	The components have to survive the moves, and the world has to be empty again afterwards, without a chunk in use
+*/
+static void MeasureStructuralChanges()
+{
+	FrameAllocatorClass frameAllocator;
+	TEST_CHECK(frameAllocator.Initialize(FRAME_MEMORY_SIZE, 2));
+
+	WorldClass* world = new WorldClass();
+	TEST_CHECK(world->Initialize(ENTITY_COUNT, MAX_CHUNKS, nullptr, &frameAllocator));
+
+	Components components;
+	components.position = world->RegisterComponent<Vector>("Position");
+	components.velocity = world->RegisterComponent<Vector>("Velocity");
+	components.health = world->RegisterComponent<float>("Health");
+
+	ComponentMask moving = (1ULL << components.position) | (1ULL << components.velocity);
+	Entity* entities = new Entity[ENTITY_COUNT];
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		entities[i] = world->CreateEntity(moving);
+	}
+	double createMilliseconds = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(world->GetEntityCount() == ENTITY_COUNT);
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		*world->GetComponent<Vector>(entities[i], components.velocity) = GetVelocity(i);
+	}
+
+	unsigned int failed = 0;
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		failed += world->AddComponent(entities[i], components.health) ? 0 : 1;
+	}
+	double addMilliseconds = TestClass::GetMilliseconds(start);
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		failed += world->RemoveComponent(entities[i], components.health) ? 0 : 1;
+	}
+	double removeMilliseconds = TestClass::GetMilliseconds(start);
+	TEST_CHECK(failed == 0);
+
+	unsigned int wrong = 0;
+	for (unsigned int i = 0; i < ENTITY_COUNT; i += 997)
+	{
+		Vector velocity = *world->GetComponent<Vector>(entities[i], components.velocity);
+		wrong += velocity.x != GetVelocity(i).x || velocity.z != GetVelocity(i).z || world->GetComponent<float>(entities[i], components.health) ? 1 : 0;
+	}
+	TEST_CHECK(wrong == 0);
+
+	start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		failed += world->DestroyEntity(entities[i]) ? 0 : 1;
+	}
+	double destroyMilliseconds = TestClass::GetMilliseconds(start);
+
+	TEST_CHECK(failed == 0);
+	TEST_CHECK(world->GetEntityCount() == 0);
+	TEST_CHECK(world->GetUsedChunkCount() == 0);
+	TEST_CHECK(!world->DestroyEntity(entities[0]));
+
+	printf("%u entities: create %.2f ms, add a component %.2f ms, remove it %.2f ms, destroy %.2f ms (%.1f / %.1f / %.1f / %.1f ns per entity)\n",
+		ENTITY_COUNT, createMilliseconds, addMilliseconds, removeMilliseconds, destroyMilliseconds, createMilliseconds * 1000000.0 / ENTITY_COUNT,
+		addMilliseconds * 1000000.0 / ENTITY_COUNT, removeMilliseconds * 1000000.0 / ENTITY_COUNT, destroyMilliseconds * 1000000.0 / ENTITY_COUNT);
+
+	delete[] entities;
+	world->Shutdown();
+	delete world;
+	frameAllocator.Shutdown();
+}
+
+/*
+	The same update over an array of GameObjects
+*/
+static double MeasureObjects()
+{
+	GameObject* objects = new GameObject[ENTITY_COUNT];
+	for (unsigned int i = 0; i < ENTITY_COUNT; i++)
+	{
+		objects[i].position = { 0.0f, 0.0f, 0.0f };
+		objects[i].velocity = GetVelocity(i);
+		objects[i].health = 100.0f;
+	}
+
+	unsigned long long start = TimerClass::GetMicroseconds();
+	for (unsigned int i = 0; i < UPDATE_COUNT; i++)
+	{
+		float timestep = static_cast<float>(TIMESTEP);
+		for (unsigned int j = 0; j < ENTITY_COUNT; j++)
+		{
+			objects[j].position.x += objects[j].velocity.x * timestep;
+			objects[j].position.y += objects[j].velocity.y * timestep;
+			objects[j].position.z += objects[j].velocity.z * timestep;
+		}
+	}
+	double milliseconds = TestClass::GetMilliseconds(start) / UPDATE_COUNT;
+
+	TEST_CHECK(fabsf(objects[ENTITY_COUNT - 1].position.y - static_cast<float>(TIMESTEP) * UPDATE_COUNT) < 0.001f);
+	printf("array of %zu byte objects: %u objects, %.2f ms per update (%.2f ns per object)\n", sizeof(GameObject), ENTITY_COUNT, milliseconds,
+		milliseconds * 1000000.0 / ENTITY_COUNT);
+
+	delete[] objects;
+
+	return milliseconds;
+}
+
+int main()
+{
+	JobSystemClass jobSystem;
+	TEST_CHECK(jobSystem.Initialize(WORKER_COUNT));
+
+	MeasureStructuralChanges();
+
+	double objects = MeasureObjects();
+	double serial = MeasureWorld(nullptr, "world, calling thread");
+	double parallel = MeasureWorld(&jobSystem, "world, jobsystem");
+	printf("objects / world: %.2fx on the calling thread, %.2fx with the jobsystem\n", objects / serial, objects / parallel);
+
+	//	The chunks only hold what the system reads and writes, the objects drag five times as many bytes through the cache
+	TEST_CHECK(serial < objects);
+
+	jobSystem.Shutdown();
+
+	return TestClass::GetResult();
+}
\ No newline at end of file